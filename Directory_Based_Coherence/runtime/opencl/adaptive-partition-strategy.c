@@ -0,0 +1,186 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "adaptive-partition-strategy.h"
+#include "misc.h"
+#include "partition-util.h"
+
+/* Throughput model of a kernel, kept for the lifetime of the process so that
+ * every ND-Range of the kernel starts from what was measured on the previous
+ * ones. The throughput of each device is a moving average of the work-items
+ * per nanosecond it achieved on its chunks, or 0 if it was never measured. */
+struct adaptive_model_t
+{
+	char *kernel_name;
+	int num_devices;
+	double *throughput;
+	struct adaptive_model_t *next;
+};
+
+static struct adaptive_model_t *adaptive_model_list;
+static pthread_mutex_t adaptive_model_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Weight of the last measurement in the moving average */
+static const double adaptive_strategy_alpha = 0.5;
+
+struct adaptive_device_info_t
+{
+	long long start;
+	unsigned int groups;
+};
+
+struct adaptive_strategy_t
+{
+	struct partition_info_t *info;
+	struct adaptive_device_info_t *device_info;
+	struct adaptive_model_t *model;
+	unsigned int group_size;
+	unsigned int groups_left;
+	struct cube_t *cube;
+};
+
+/* Return the model of a kernel, creating it if this is its first ND-Range.
+ * Kernels without a name get a model of their own, which is not kept. */
+static struct adaptive_model_t *adaptive_model_get(const char *kernel_name, int num_devices)
+{
+	struct adaptive_model_t *model;
+
+	pthread_mutex_lock(&adaptive_model_lock);
+	for (model = adaptive_model_list; model && kernel_name; model = model->next)
+		if (model->kernel_name && model->num_devices == num_devices &&
+				!strcmp(model->kernel_name, kernel_name))
+			break;
+	if (!model || !kernel_name)
+	{
+		model = (struct adaptive_model_t *)calloc(1, sizeof (struct adaptive_model_t));
+		model->kernel_name = kernel_name ? strdup(kernel_name) : NULL;
+		model->num_devices = num_devices;
+		model->throughput = (double *)calloc(num_devices, sizeof (double));
+		if (kernel_name)
+		{
+			model->next = adaptive_model_list;
+			adaptive_model_list = model;
+		}
+	}
+	pthread_mutex_unlock(&adaptive_model_lock);
+	return model;
+}
+
+void *adaptive_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size)
+{
+	int i;
+
+	struct adaptive_strategy_t *info = (struct adaptive_strategy_t *)calloc(1, sizeof (struct adaptive_strategy_t));
+	info->info = partition_info_create(num_devices, dims, groups);
+	info->device_info = (struct adaptive_device_info_t *)calloc(num_devices, sizeof (struct adaptive_device_info_t));
+	info->model = adaptive_model_get(kernel_name, num_devices);
+	info->group_size = MAX(group_size, 1);
+	info->cube = cube_init(dims, groups);
+
+	/* calculate the total number of groups */
+	info->groups_left = 1;
+	for (i = 0; i < (int)dims; i++)
+		info->groups_left *= groups[i];
+	return info;
+}
+
+int adaptive_strategy_get_partition(void *inst, int id, int desired_groups, unsigned int *group_offset, unsigned int *group_count)
+{
+	int i;
+	double own_speed;
+	double total_speed;
+	double measured;
+	double *speed;
+	unsigned int target_groups;
+	unsigned int row_size;
+	unsigned int *pos;
+	struct adaptive_strategy_t *info = (struct adaptive_strategy_t *)inst;
+	struct adaptive_device_info_t *dev = info->device_info + id;
+	long long now;
+	int found;
+
+	/* A device asks for more work when its last chunk is done, so fold the
+	 * time it took into the model before anything else. */
+	now = get_time();
+	pthread_mutex_lock(&adaptive_model_lock);
+	speed = info->model->throughput;
+	if (dev->groups && now > dev->start)
+	{
+		measured = (double)dev->groups * info->group_size / (now - dev->start);
+		speed[id] = speed[id] ? adaptive_strategy_alpha * measured +
+			(1 - adaptive_strategy_alpha) * speed[id] : measured;
+	}
+
+	/* calculate the total throughput. Devices that were never measured on
+	 * this kernel are assumed to be as fast as this one. */
+	own_speed = speed[id];
+	total_speed = 0;
+	for (i = 0; i < info->info->num_devices; i++)
+		total_speed += speed[i] ? speed[i] : own_speed;
+	pthread_mutex_unlock(&adaptive_model_lock);
+
+	dev->start = now;
+	dev->groups = 0;
+	if (!info->groups_left)
+		return 0;
+
+	/* Hand out half of this device's share of the remaining groups, so that
+	 * chunks shrink as the ND-Range drains and all devices finish together.
+	 * Without a measurement yet, only a probe chunk is handed out. Once the
+	 * share drops below the device's preferred chunk, the remaining groups
+	 * go out in chunks of that size to whichever device asks first, which
+	 * leaves the tail to the faster devices. */
+	desired_groups = MAX(desired_groups, 1);
+	if (own_speed)
+		target_groups = (unsigned int)(info->groups_left * own_speed / total_speed / 2);
+	else
+		target_groups = 0;
+	target_groups = MAX(target_groups, (unsigned int)desired_groups);
+	target_groups = closest_multiple_not_more(target_groups, desired_groups, info->groups_left);
+
+	/* for now, just assume row major order and only vary the highest dimension */
+
+	/* how big is a highest-dimension 'row' */
+	row_size = 1;
+	for (i = 0; i < (int)info->info->dims - 1; i++)
+	{
+		group_count[i] = info->info->groups[i];
+		row_size *= info->info->groups[i];
+	}
+	/* target groups should be a multiple of the row size */
+	target_groups = closest_multiple_not_more(target_groups, row_size, info->groups_left);
+	assert(target_groups % row_size == 0);
+	/* now we know the shape in every dimension */
+	group_count[info->info->dims - 1] = target_groups / row_size;
+	info->groups_left -= target_groups;
+	dev->groups = target_groups;
+
+	/* decide what point in the NDRange to prefer */
+	pos = (unsigned int *)calloc(info->info->dims, sizeof (unsigned int));
+
+	/* make even devices prefer the top, and odd devices prefer the bottom */
+	pos[info->info->dims - 1] = info->info->groups[info->info->dims - 1] * (id % 2);
+
+	found = cube_get_region(info->cube, group_offset, group_count, pos);
+	assert(found);
+	free(pos);
+
+	cube_remove_region(info->cube, group_offset, group_count);
+
+	return 1;
+}
+
+void adaptive_strategy_destroy(void *inst)
+{
+	struct adaptive_strategy_t *info = (struct adaptive_strategy_t *)inst;
+	partition_info_free(info->info);
+	cube_destroy(info->cube);
+	if (!info->model->kernel_name)
+	{
+		free(info->model->throughput);
+		free(info->model);
+	}
+	free(info->device_info);
+	free(info);
+}
@@ -0,0 +1,8 @@
+#ifndef __ADAPTIVE_PARTITION_STRATEGY_H__
+#define __ADAPTIVE_PARTITION_STRATEGY_H__
+
+void *adaptive_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size);
+int adaptive_strategy_get_partition(void *inst, int id, int desired_groups, unsigned int *group_offset, unsigned int *group_count);
+void adaptive_strategy_destroy(void *inst);
+
+#endif
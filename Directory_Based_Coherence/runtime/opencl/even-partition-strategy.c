@@ -21,7 +21,7 @@ struct even_strategy_info_t
 	unsigned int *previous_rows;
 };
 
-void *even_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups)
+void *even_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size)
 {
 	int i;
 	char *ratio_data;
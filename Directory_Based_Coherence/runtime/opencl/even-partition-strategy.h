@@ -1,7 +1,7 @@
 #ifndef __EVEN_STRATEGY_H__
 #define __EVEN_STRATEGY_H__
 
-void *even_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups);
+void *even_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size);
 int even_strategy_get_partition(void *inst, int id, int desired_groups, unsigned int *group_offset, unsigned int *group_count);
 void even_strategy_destroy(void *inst);
 
@@ -9,16 +9,18 @@
 /* include strategies here */
 #include "even-partition-strategy.h"
 #include "relative-runtime-partition-strategy.h"
+#include "adaptive-partition-strategy.h"
 
 /* forward declartion for default strategy. */
-void *default_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups);
+void *default_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size);
 int default_strategy_get_partition(void *inst, int id, int desired_groups, unsigned int *group_offset, unsigned int *group_count);
 void default_strategy_destroy(void *inst);
 
 static struct opencl_partition_strategy strats[] = {
 	{default_strategy_create, default_strategy_get_partition, default_strategy_destroy},
 	{even_strategy_create, even_strategy_get_partition, even_strategy_destroy},
-	{relative_runtime_strategy_create, relative_runtime_strategy_get_partition, relative_runtime_strategy_destroy}};
+	{relative_runtime_strategy_create, relative_runtime_strategy_get_partition, relative_runtime_strategy_destroy},
+	{adaptive_strategy_create, adaptive_strategy_get_partition, adaptive_strategy_destroy}};
 
 const struct opencl_partition_strategy *get_strategy()
 {
@@ -47,7 +49,7 @@ struct default_strategy_info_t
 	int done;
 };
 
-void *default_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups)
+void *default_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size)
 {
 	struct default_strategy_info_t *info = (struct default_strategy_info_t *)calloc(1, sizeof (struct default_strategy_info_t));
 	info->num_devices = num_devices;
@@ -5,7 +5,7 @@
 extern "C" {
 #endif
 
-typedef void *(*opencl_strategy_create_t)(int num_devices, unsigned int dims, const unsigned int *groups);
+typedef void *(*opencl_strategy_create_t)(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size);
 typedef int (*opencl_strategy_get_partition_t)(void *inst, int id, int desired_groups, unsigned int *group_offset, unsigned int *group_count);
 typedef void (*opencl_strategy_destroy_t)(void *inst);
 
@@ -19,7 +19,7 @@ struct relative_runtime_strategy_t
 	struct cube_t *cube;
 };
 
-void *relative_runtime_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups)
+void *relative_runtime_strategy_create(int num_devices, unsigned int dims, const unsigned int *groups, const char *kernel_name, unsigned int group_size)
 {
 	int i;
 
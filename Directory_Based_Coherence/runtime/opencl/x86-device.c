@@ -23,6 +23,7 @@
 #include "debug.h"
 #include "device.h"
 #include "mhandle.h"
+#include "misc.h"
 #include "string.h"
 #include "x86-device.h"
 #include "x86-kernel.h"
@@ -71,22 +72,68 @@ static struct opencl_x86_device_exec_t *opencl_x86_device_has_work(
 }
 
 
-/* Get the next work-group in an NDRange */
-static int opencl_x86_device_get_next_work_group(
-		struct opencl_x86_device_exec_t *exec)
+/* Claim 'count' work-groups from a queue, returning the first one. The result
+ * can be past the end of the queue if other cores emptied it meanwhile. */
+static int opencl_x86_device_queue_claim(
+		struct opencl_x86_device_queue_t *queue, int count)
 {
 #ifndef HAVE_SYNC_BUILTINS
-	int next;
-	pthread_mutex_lock(&exec->next_group_lock);
-	next = exec->next_group++;
-	pthread_mutex_unlock(&exec->next_group_lock);
-	return next;
+	int first;
+	pthread_mutex_lock(&queue->lock);
+	first = queue->next;
+	queue->next += count;
+	pthread_mutex_unlock(&queue->lock);
+	return first;
 #else
-	return __sync_fetch_and_add(&exec->next_group, 1);
+	return __sync_fetch_and_add(&queue->next, count);
 #endif
 }
 
 
+/* Get the next batch of work-groups in an NDRange for core 'id'. The first
+ * work-group is returned in 'first', and the number of work-groups as the
+ * return value, which is 0 when no work-group is left. Work-groups are taken
+ * from the core's own queue first. Once it runs out, half of the work-groups
+ * left in another core's queue are stolen. */
+static int opencl_x86_device_get_work_groups(
+		struct opencl_x86_device_exec_t *exec, int id, int *first)
+{
+	struct opencl_x86_device_queue_t *queue;
+	int remaining;
+	int count;
+	int i;
+
+	/* Own queue */
+	queue = exec->queues + id;
+	if (queue->next < queue->end)
+	{
+		count = exec->batch_size;
+		*first = opencl_x86_device_queue_claim(queue, count);
+		if (*first < queue->end)
+			return MIN(count, queue->end - *first);
+	}
+
+	/* Steal from the other queues. Counters only grow, so a queue found
+	 * empty stays empty, and a full pass without success means that all
+	 * work-groups have been claimed. */
+	for (i = 1; i < exec->num_queues; i++)
+	{
+		queue = exec->queues + (id + i) % exec->num_queues;
+		remaining = queue->end - queue->next;
+		if (remaining <= 0)
+			continue;
+
+		count = MAX(exec->batch_size, remaining / 2);
+		*first = opencl_x86_device_queue_claim(queue, count);
+		if (*first < queue->end)
+			return MIN(count, queue->end - *first);
+	}
+
+	/* No work-group left */
+	return 0;
+}
+
+
 /* Return the number of cores in the host CPU in order to decide the number of
  * threads to spawn running work-groups. */
 static int opencl_x86_device_get_num_cores(void)
@@ -381,25 +428,43 @@ void opencl_x86_device_core_treardown(struct opencl_x86_device_core_t *work_grou
 }
 
 
+/* Split the work-groups of an ND-Range evenly among the cores' queues. This
+ * must be done before the ND-Range is posted to the worker threads. */
+void opencl_x86_device_exec_seed(struct opencl_x86_device_exec_t *exec)
+{
+	struct opencl_x86_device_queue_t *queue;
+	int i;
+
+	for (i = 0; i < exec->num_queues; i++)
+	{
+		queue = exec->queues + i;
+		queue->next = (long long) exec->num_groups * i / exec->num_queues;
+		queue->end = (long long) exec->num_groups * (i + 1) / exec->num_queues;
+	}
+
+	/* Claim several work-groups at once, while leaving enough of them in
+	 * every queue for idle cores to balance the load at the end. */
+	exec->batch_size = exec->num_groups / (exec->num_queues * OPENCL_X86_DEVICE_MAX_BATCH);
+	exec->batch_size = MAX(exec->batch_size, 1);
+	exec->batch_size = MIN(exec->batch_size, OPENCL_X86_DEVICE_MAX_BATCH);
+}
+
+
 void opencl_x86_device_run_exec(
 	struct opencl_x86_device_core_t *core,
 	struct opencl_x86_device_exec_t *exec)
 {
+	int first;
+	int count;
+	int num;
+
 	/* Initialize kernel data */
 	opencl_x86_device_work_group_init(core, exec);
 
 	/* Launch work-groups */
-	for (;;)
-	{
-		/* Get next work-group */
-		int num = opencl_x86_device_get_next_work_group(exec);
-		if (num >= exec->num_groups)
-			break;
-
-		/* Launch it */
-		opencl_x86_device_work_group_launch(num, exec, core);
-
-	}
+	while ((count = opencl_x86_device_get_work_groups(exec, core->id, &first)))
+		for (num = first; num < first + count; num++)
+			opencl_x86_device_work_group_launch(num, exec, core);
 
 	/* Finalize kernel */
 	opencl_x86_device_work_group_done(core, exec->kernel);
@@ -407,13 +472,22 @@ void opencl_x86_device_run_exec(
 
 /* Each core on every device has a thread that runs this procedure
  * It polls for work-groups and launches them on its core */
-void *opencl_x86_device_core_func(struct opencl_x86_device_t *device)
+void *opencl_x86_device_core_func(struct opencl_x86_device_worker_t *worker)
 {
+	struct opencl_x86_device_t *device = worker->device;
 	struct opencl_x86_device_exec_t *exec;
 	struct opencl_x86_device_core_t core;
+	cpu_set_t cpu_set;
 	int count = 0;
 
+	/* Pin the thread to its core before allocating the work-item stacks,
+	 * so that they are placed in memory local to that core. */
+	CPU_ZERO(&cpu_set);
+	CPU_SET(worker->id, &cpu_set);
+	pthread_setaffinity_np(pthread_self(), sizeof cpu_set, &cpu_set);
+
 	opencl_x86_device_core_init(&core);
+	core.id = worker->id;
 
 	/* Get kernels until done */
 	for (;;)
@@ -624,25 +698,23 @@ struct opencl_x86_device_t *opencl_x86_device_create(
 			(opencl_arch_ndrange_run_partial_func_t)
 			opencl_x86_ndrange_run_partial;
 
-	/* Initialize threads */
+	/* Initialize threads. Each of them is pinned to one core, while the
+	 * last core is used by the command queue thread. */
 	device->threads = xcalloc(device->num_cores, sizeof(pthread_t));
+	device->workers = xcalloc(device->num_cores, sizeof(struct opencl_x86_device_worker_t));
 	for (i = 0; i < device->num_cores - 1; i++)
 	{
-		cpu_set_t cpu_set;
-
 		/* Create thread */
+		device->workers[i].device = device;
+		device->workers[i].id = i;
 		err = pthread_create(device->threads + i, NULL,
 				(opencl_callback_t) opencl_x86_device_core_func,
-				device);
+				device->workers + i);
 		if (err)
 			fatal("%s: could not create thread", __FUNCTION__);
-
-		/* Assign thread to CPU core */
-		CPU_ZERO(&cpu_set);
-		CPU_SET(i, &cpu_set);
-		pthread_setaffinity_np(device->threads[i], sizeof cpu_set, &cpu_set);
 	}
 	opencl_x86_device_core_init(&device->queue_core);
+	device->queue_core.id = device->num_cores - 1;
 
 	opencl_debug("[%s] opencl_x86_device_t device = %p", __FUNCTION__, 
 		device);
@@ -655,6 +727,7 @@ struct opencl_x86_device_t *opencl_x86_device_create(
 void opencl_x86_device_free(struct opencl_x86_device_t *device)
 {
 	free(device->threads);
+	free(device->workers);
 	free(device);
 }
 
@@ -38,6 +38,24 @@ struct opencl_x86_device_fiber_t
 };
 
 
+/* Maximum number of work-groups claimed at once from a core's queue */
+#define OPENCL_X86_DEVICE_MAX_BATCH  8
+
+/* Work-groups assigned to one core. The range [next, end) is seeded by
+ * splitting the ND-Range evenly among cores. The owner claims work-groups in
+ * batches from 'next', and idle cores steal from the same counter once their
+ * own range is exhausted. Each queue fills a cache line so that claims on
+ * different cores do not bounce the same line. */
+struct opencl_x86_device_queue_t
+{
+#ifndef HAVE_SYNC_BUILTINS
+	pthread_mutex_t lock;
+#endif
+	volatile int next;
+	int end;
+} __attribute__((aligned(64)));
+
+
 struct opencl_x86_device_exec_t
 {
 	struct opencl_x86_kernel_t *kernel;
@@ -47,10 +65,11 @@ struct opencl_x86_device_exec_t
 	unsigned int work_group_count[3];
 
 	int num_groups;
-#ifndef HAVE_SYNC_BUILTINS
-	pthread_mutex_t next_group_lock;
-#endif
-	volatile int next_group;
+	int batch_size;
+
+	/* One queue per core */
+	int num_queues;
+	struct opencl_x86_device_queue_t *queues;
 };
 
 
@@ -92,7 +111,7 @@ struct opencl_x86_device_core_t
 	struct opencl_x86_device_fiber_t work_fibers[X86_MAX_WORK_GROUP_SIZE];
 	struct opencl_x86_device_work_item_data_t *work_item_data[X86_MAX_WORK_GROUP_SIZE];
 
-
+	int id; /* index of the host core this thread is pinned to */
 };
 
 struct opencl_x86_device_sync_t
@@ -109,6 +128,13 @@ void opencl_x86_device_sync_destroy(struct opencl_x86_device_sync_t *sync);
 void opencl_x86_device_sync_wait(struct opencl_x86_device_sync_t *sync, int value);
 void opencl_x86_device_sync_post(struct opencl_x86_device_sync_t *sync);
 
+/* Argument of a worker thread */
+struct opencl_x86_device_worker_t
+{
+	struct opencl_x86_device_t *device;
+	int id;
+};
+
 struct opencl_x86_device_t
 {
 	enum opencl_runtime_type_t type;  /* First field */
@@ -123,6 +149,7 @@ struct opencl_x86_device_t
 	int set_queue_affinity;
 	int num_cores;
 	pthread_t *threads;
+	struct opencl_x86_device_worker_t *workers;
 
 	struct opencl_x86_device_exec_t *exec;
 	struct opencl_x86_device_core_t queue_core;
@@ -151,11 +178,12 @@ void opencl_x86_device_switch_fiber(
 void opencl_x86_device_exit_fiber(void);
 void opencl_x86_device_barrier(int data);
 
-void *opencl_x86_device_core_func(struct opencl_x86_device_t *device);
+void *opencl_x86_device_core_func(struct opencl_x86_device_worker_t *worker);
 
 void opencl_x86_work_item_entry_point(void);
 
 void opencl_x86_device_init_work_item(int i, struct opencl_x86_device_core_t *core);
+void opencl_x86_device_exec_seed(struct opencl_x86_device_exec_t *exec);
 void opencl_x86_device_run_exec(
 	struct opencl_x86_device_core_t *core,
 	struct opencl_x86_device_exec_t *exec);
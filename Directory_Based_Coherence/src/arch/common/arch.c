@@ -37,10 +37,11 @@
 
 struct str_map_t arch_sim_kind_map =
 {
-	2,
+	3,
 	{
 		{ "functional", arch_sim_kind_functional },
-		{ "detailed", arch_sim_kind_detailed }
+		{ "detailed", arch_sim_kind_detailed },
+		{ "interval", arch_sim_kind_interval }
 	}
 };
 
@@ -129,7 +130,7 @@ void arch_dump_summary(struct arch_t *arch, FILE *f)
 	emu->DumpSummary(emu, f);
 
 	/* Timing simulation statistics */
-	if (arch->sim_kind == arch_sim_kind_detailed)
+	if (arch->sim_kind != arch_sim_kind_functional)
 	{
 		/* Architecture-specific */
 		assert(timing->DumpSummary);
@@ -241,7 +242,7 @@ void arch_init(void)
 		arch = arch_list[i];
 
 		/* Timing simulation */
-		if (arch->sim_kind == arch_sim_kind_detailed)
+		if (arch->sim_kind != arch_sim_kind_functional)
 		{
 			/* Read configuration file */
 			if (arch->timing_read_config_func)
@@ -254,7 +255,7 @@ void arch_init(void)
 			arch->emu_init_func();
 
 		/* Initialize timing simulator */
-		if (arch->sim_kind == arch_sim_kind_detailed)
+		if (arch->sim_kind != arch_sim_kind_functional)
 		{
 			/* Register frequency domain */
 			if (arch->timing_init_func)
@@ -276,7 +277,7 @@ void arch_done(void)
 		arch = arch_list[i];
 
 		/* Free functional/timing simulator */
-		if (arch->sim_kind == arch_sim_kind_detailed)
+		if (arch->sim_kind != arch_sim_kind_functional)
 		{
 			if (arch->timing_done_func)
 				arch->timing_done_func();
@@ -340,7 +341,7 @@ int arch_get_sim_kind_detailed_count(void)
 
 	count = 0;
 	for (i = 0; i < arch_list_count; i++)
-		if (arch_list[i]->sim_kind == arch_sim_kind_detailed)
+		if (arch_list[i]->sim_kind != arch_sim_kind_functional)
 			count++;
 	return count;
 }
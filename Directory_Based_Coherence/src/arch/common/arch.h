@@ -39,7 +39,8 @@ enum arch_sim_kind_t
 {
 	arch_sim_kind_invalid = 0,
 	arch_sim_kind_functional,
-	arch_sim_kind_detailed
+	arch_sim_kind_detailed,
+	arch_sim_kind_interval
 };
 
 typedef void (*arch_callback_func_t)(struct arch_t *arch, void *user_data);
@@ -0,0 +1,820 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <lib/esim/esim.h>
+#include <lib/mhandle/mhandle.h>
+#include <lib/util/config.h>
+#include <lib/util/debug.h>
+#include <lib/util/linked-list.h>
+#include <lib/util/misc.h>
+#include <lib/util/string.h>
+#include <mem-system/mem-system.h>
+#include <mem-system/mmu.h>
+#include <mem-system/module.h>
+#include <mem-system/tlb.h>
+
+#include "arch.h"
+#include "interval.h"
+
+
+/* Extra entries in the load and store lists, so that the accesses of an
+ * instruction dispatched when the lists are almost full always fit. */
+#define INTERVAL_ACCESS_SLACK  64
+
+
+char *interval_stall_name[interval_stall_count] =
+{
+	"None",
+	"Context",
+	"Window",
+	"StoreBuffer",
+	"Memory",
+	"Fetch",
+	"Branch"
+};
+
+
+
+
+/*
+ * Private Functions
+ */
+
+/* Send an access to the data module. Return non-zero if the module took it. */
+static int interval_core_issue(struct interval_core_t *core,
+	struct interval_access_t *access)
+{
+	struct mod_t *mod = core->data_mod;
+
+	if (!mod_can_access(mod, access->phy_addr))
+		return 0;
+
+	/* Access */
+	access->issued = 1;
+	if (core->data_tlb)
+		tlb_access(core->data_tlb, mod, access->kind,
+			core->address_space_index, access->vtl_addr,
+			access->phy_addr, &access->witness, NULL, NULL, NULL);
+	else
+		mod_access(mod, access->kind, access->phy_addr,
+			&access->witness, NULL, NULL, NULL);
+
+	/* MMU statistics */
+	if (*mmu_report_file_name)
+		mmu_access_page(access->phy_addr, access->kind == mod_access_load ?
+			mmu_access_read : mmu_access_write);
+	return 1;
+}
+
+
+/* Issue the accesses of a list that are waiting for the data module, in
+ * program order. */
+static void interval_core_issue_pending(struct interval_core_t *core,
+	struct interval_access_t *list, int size, int head, int count)
+{
+	struct interval_access_t *access;
+	int i;
+
+	for (i = 0; i < count && core->pending_count; i++)
+	{
+		access = &list[(head + i) % size];
+		if (access->issued)
+			continue;
+		if (!interval_core_issue(core, access))
+			return;
+		core->pending_count--;
+	}
+}
+
+
+static struct interval_access_t *interval_core_add_access(
+	struct interval_core_t *core, struct interval_access_t *list, int size,
+	int head, int *count_ptr, enum mod_access_kind_t kind,
+	unsigned int vtl_addr, unsigned int phy_addr)
+{
+	struct interval_access_t *access;
+
+	if (*count_ptr == size)
+		panic("%s: %s: too many accesses in flight", __FUNCTION__, core->name);
+	access = &list[(head + *count_ptr) % size];
+	(*count_ptr)++;
+
+	/* Initialize */
+	access->seq = core->seq;
+	access->kind = kind;
+	access->issued = 0;
+	access->witness = -1;
+	access->vtl_addr = vtl_addr;
+	access->phy_addr = phy_addr;
+
+	/* Issue now unless older accesses are waiting */
+	if (core->pending_count || !interval_core_issue(core, access))
+		core->pending_count++;
+	return access;
+}
+
+
+
+
+/*
+ * Public Functions
+ */
+
+struct interval_core_t *interval_core_create(char *name, int dispatch_width,
+	int window_size, int store_buffer_size, int mispred_penalty,
+	int btb_size)
+{
+	struct interval_core_t *core;
+
+	/* Initialize */
+	core = xcalloc(1, sizeof(struct interval_core_t));
+	core->name = xstrdup(name);
+	core->dispatch_width = dispatch_width;
+	core->window_size = window_size;
+	core->store_buffer_size = store_buffer_size;
+	core->mispred_penalty = mispred_penalty;
+	core->fetch_block = -1;
+
+	/* Lists of accesses */
+	core->load_list_size = window_size + INTERVAL_ACCESS_SLACK;
+	core->load_list = xcalloc(core->load_list_size,
+		sizeof(struct interval_access_t));
+	core->store_list_size = store_buffer_size + INTERVAL_ACCESS_SLACK;
+	core->store_list = xcalloc(core->store_list_size,
+		sizeof(struct interval_access_t));
+
+	/* Branch target table */
+	assert(!(btb_size & (btb_size - 1)));
+	core->btb_size = btb_size;
+	if (btb_size)
+		core->btb = xcalloc(btb_size, sizeof(struct interval_btb_entry_t));
+
+	/* Return */
+	return core;
+}
+
+
+void interval_core_free(struct interval_core_t *core)
+{
+	free(core->name);
+	free(core->load_list);
+	free(core->store_list);
+	free(core->btb);
+	free(core);
+}
+
+
+void interval_core_dump_report(struct interval_core_t *core, FILE *f)
+{
+	int i;
+
+	fprintf(f, "; Interval core model\n");
+	fprintf(f, ";    Stall.<reason> - Cycles with no uop dispatched, by first blocking reason\n");
+	fprintf(f, "Interval.Cycles = %lld\n", core->cycles);
+	fprintf(f, "Interval.Instructions = %lld\n", core->dispatched_inst);
+	fprintf(f, "Interval.Uops = %lld\n", core->dispatched_uops);
+	fprintf(f, "Interval.IPC = %.4g\n", core->cycles ?
+		(double) core->dispatched_inst / core->cycles : 0.0);
+	fprintf(f, "Interval.Loads = %lld\n", core->loads);
+	fprintf(f, "Interval.Stores = %lld\n", core->stores);
+	fprintf(f, "Interval.Prefetches = %lld\n", core->prefetches);
+	fprintf(f, "Interval.Fetches = %lld\n", core->fetches);
+	fprintf(f, "Interval.Branches = %lld\n", core->branches);
+	fprintf(f, "Interval.Mispred = %lld\n", core->mispred_branches);
+	for (i = 1; i < interval_stall_count; i++)
+		fprintf(f, "Interval.Stall.%s = %lld\n", interval_stall_name[i],
+			core->stalls[i]);
+	fprintf(f, "\n");
+}
+
+
+void interval_core_reset_stats(struct interval_core_t *core)
+{
+	core->cycles = 0;
+	core->dispatched_inst = 0;
+	core->dispatched_uops = 0;
+	core->loads = 0;
+	core->stores = 0;
+	core->prefetches = 0;
+	core->branches = 0;
+	core->mispred_branches = 0;
+	core->fetches = 0;
+	memset(core->stalls, 0, sizeof core->stalls);
+}
+
+
+/* Start a new cycle. Completed accesses leave the window and the store
+ * buffer, and accesses waiting for the data module are retried. */
+void interval_core_cycle(struct interval_core_t *core, long long cycle)
+{
+	struct interval_access_t *access;
+
+	/* New cycle */
+	core->cycle = cycle;
+	core->cycle_uops = 0;
+	core->cycle_stalled = 0;
+	core->cycle_mispred = 0;
+	core->cycles++;
+
+	/* Retire completed loads from the head of the window */
+	while (core->load_count)
+	{
+		access = &core->load_list[core->load_head];
+		if (!access->issued || access->witness < 0)
+			break;
+		core->load_head = (core->load_head + 1) % core->load_list_size;
+		core->load_count--;
+	}
+
+	/* Free store buffer entries */
+	while (core->store_count)
+	{
+		access = &core->store_list[core->store_head];
+		if (!access->issued || access->witness < 0)
+			break;
+		core->store_head = (core->store_head + 1) % core->store_list_size;
+		core->store_count--;
+	}
+
+	/* Retry accesses waiting for the data module */
+	interval_core_issue_pending(core, core->load_list, core->load_list_size,
+		core->load_head, core->load_count);
+	interval_core_issue_pending(core, core->store_list, core->store_list_size,
+		core->store_head, core->store_count);
+}
+
+
+/* Record the reason why dispatch stopped in the current cycle. Only cycles
+ * in which no uop was dispatched count, and only with their first reason. */
+void interval_core_stall(struct interval_core_t *core, enum interval_stall_t stall)
+{
+	if (core->cycle_uops || core->cycle_stalled)
+		return;
+	core->stalls[stall]++;
+	core->cycle_stalled = 1;
+}
+
+
+/* Return non-zero if another instruction can be dispatched in the current
+ * cycle, regardless of the instruction fetch. */
+int interval_core_can_dispatch(struct interval_core_t *core)
+{
+	struct interval_access_t *load;
+
+	/* Dispatch width, or a mispredicted branch dispatched in this cycle */
+	if (core->cycle_uops >= core->dispatch_width || core->cycle_mispred)
+		return 0;
+
+	/* Accesses waiting for the data module */
+	if (core->pending_count)
+	{
+		interval_core_stall(core, interval_stall_mem);
+		return 0;
+	}
+
+	/* Store buffer */
+	if (core->store_count >= core->store_buffer_size)
+	{
+		interval_core_stall(core, interval_stall_store_buffer);
+		return 0;
+	}
+
+	/* Window full behind the oldest load */
+	load = &core->load_list[core->load_head];
+	if (core->load_count >= core->window_size || (core->load_count &&
+		core->seq - load->seq + 1 >= core->window_size))
+	{
+		interval_core_stall(core, interval_stall_window);
+		return 0;
+	}
+
+	/* Mispredicted branch. Wait for the loads it may depend on, and then
+	 * for the front-end to refill. */
+	if (core->branch_pending)
+	{
+		if (core->load_count && load->seq <= core->branch_seq)
+		{
+			interval_core_stall(core, interval_stall_branch);
+			return 0;
+		}
+		core->branch_pending = 0;
+		core->branch_ready = core->cycle + core->mispred_penalty;
+	}
+	if (core->cycle < core->branch_ready)
+	{
+		interval_core_stall(core, interval_stall_branch);
+		return 0;
+	}
+
+	/* Can dispatch */
+	return 1;
+}
+
+
+/* Fetch the instruction at the given address. The instruction module is
+ * accessed when the address falls in a new block. The function returns
+ * non-zero if the instruction is available for dispatch. */
+int interval_core_fetch(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr)
+{
+	struct mod_t *mod = core->inst_mod;
+	unsigned int block;
+
+	/* Access a new block */
+	block = phy_addr & ~(mod->block_size - 1);
+	if (block != core->fetch_block)
+	{
+		if (!mod_can_access(mod, phy_addr))
+		{
+			interval_core_stall(core, interval_stall_fetch);
+			return 0;
+		}
+
+		/* The witness counts the fetches in flight */
+		core->fetch_block = block;
+		core->fetch_cycle = core->cycle;
+		core->fetch_witness--;
+		core->fetches++;
+		if (core->inst_tlb)
+			tlb_access(core->inst_tlb, mod, mod_access_load,
+				core->address_space_index, vtl_addr, phy_addr,
+				&core->fetch_witness, NULL, NULL, NULL);
+		else
+			mod_access(mod, mod_access_load, phy_addr,
+				&core->fetch_witness, NULL, NULL, NULL);
+
+		/* MMU statistics */
+		if (*mmu_report_file_name)
+			mmu_access_page(phy_addr, mmu_access_execute);
+	}
+
+	/* Hits are hidden by the front-end */
+	if (core->fetch_witness < 0 && core->cycle - core->fetch_cycle > mod->latency)
+	{
+		interval_core_stall(core, interval_stall_fetch);
+		return 0;
+	}
+
+	/* Instruction available */
+	return 1;
+}
+
+
+/* Return non-zero if the core has no data access in flight, so that the
+ * context running on it can be replaced. */
+int interval_core_is_empty(struct interval_core_t *core)
+{
+	return !core->load_count && !core->store_count;
+}
+
+
+/* Dispatch an instruction made of 'num_uops' uops. Its data accesses and
+ * branch outcome are given next with the functions below. */
+void interval_core_dispatch(struct interval_core_t *core, int num_uops)
+{
+	assert(num_uops > 0);
+	core->seq += num_uops;
+	core->cycle_uops += num_uops;
+	core->dispatched_inst++;
+	core->dispatched_uops += num_uops;
+}
+
+
+void interval_core_load(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr)
+{
+	interval_core_add_access(core, core->load_list, core->load_list_size,
+		core->load_head, &core->load_count, mod_access_load,
+		vtl_addr, phy_addr);
+	core->loads++;
+}
+
+
+void interval_core_store(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr)
+{
+	interval_core_add_access(core, core->store_list, core->store_list_size,
+		core->store_head, &core->store_count, mod_access_store,
+		vtl_addr, phy_addr);
+	core->stores++;
+}
+
+
+/* Prefetches do not occupy the window, and are dropped if the data module
+ * cannot take them right away. */
+void interval_core_prefetch(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr)
+{
+	if (core->pending_count || !mod_can_access(core->data_mod, phy_addr))
+		return;
+	mod_access(core->data_mod, mod_access_prefetch, phy_addr,
+		NULL, NULL, NULL, NULL);
+	core->prefetches++;
+}
+
+
+void interval_core_branch(struct interval_core_t *core, int mispred)
+{
+	core->branches++;
+	if (!mispred)
+		return;
+	core->mispred_branches++;
+	core->cycle_mispred = 1;
+	core->branch_pending = 1;
+	core->branch_seq = core->seq;
+}
+
+
+/* Predict the instruction following the one at 'pc' with the branch target
+ * table, and update the table with the actual address 'next_pc'. An
+ * instruction found in the table or redirecting the fetch is reported as a
+ * branch with 'interval_core_branch'. The function returns non-zero on a
+ * misprediction. */
+int interval_core_predict(struct interval_core_t *core, unsigned int pc,
+	unsigned int next_pc, unsigned int fall_through_pc)
+{
+	struct interval_btb_entry_t *entry;
+	unsigned int pred_pc;
+	int taken;
+	int mispred;
+
+	/* Lookup */
+	assert(core->btb);
+	entry = &core->btb[(pc >> 1) & (core->btb_size - 1)];
+	taken = next_pc != fall_through_pc;
+	if (entry->pc != pc && !taken)
+		return 0;
+	pred_pc = entry->pc == pc && entry->counter >= 2 ?
+		entry->target : fall_through_pc;
+	mispred = pred_pc != next_pc;
+
+	/* Update */
+	if (entry->pc != pc)
+	{
+		entry->pc = pc;
+		entry->counter = 2;
+	}
+	else if (taken)
+		entry->counter = MIN(entry->counter + 1, 3);
+	else
+		entry->counter = MAX(entry->counter - 1, 0);
+	if (taken)
+		entry->target = next_pc;
+
+	/* Branch */
+	interval_core_branch(core, mispred);
+	return mispred;
+}
+
+
+
+
+/*
+ * Configuration of Interval Cores
+ */
+
+char *interval_config_help =
+	"The CPU configuration file of an architecture simulated with the interval\n"
+	"core model ('--arm-sim interval' or '--mips-sim interval') is a plain text INI\n"
+	"file, passed with option '--arm-config <file>' or '--mips-config <file>'. Each\n"
+	"core runs one context, dispatches a fixed number of instructions per cycle,\n"
+	"issues loads and stores to its entry to the memory hierarchy at dispatch,\n"
+	"and only stalls when the window fills up behind a load in flight, when the\n"
+	"store buffer is full, on instruction fetch misses, and on branch\n"
+	"mispredictions.\n"
+	"\n"
+	"Section '[ General ]':\n"
+	"\n"
+	"  Frequency = <freq> (Default = 1000 MHz)\n"
+	"      Frequency in MHz for the CPU. Value between 1 and 10K.\n"
+	"  Cores = <num_cores> (Default = 1)\n"
+	"      Number of cores.\n"
+	"\n"
+	"Section '[ Interval ]':\n"
+	"\n"
+	"  DispatchWidth = <num> (Default = 4)\n"
+	"      Maximum number of instructions dispatched per cycle.\n"
+	"  WindowSize = <num> (Default = 64)\n"
+	"      Number of instructions that can be dispatched behind the oldest load\n"
+	"      in flight, modeling the reorder buffer.\n"
+	"  StoreBufferSize = <num> (Default = 16)\n"
+	"      Number of stores in flight.\n"
+	"  MispredictPenalty = <cycles> (Default = 10)\n"
+	"      Number of cycles that dispatch stalls to refill the front-end after a\n"
+	"      mispredicted branch resolves.\n"
+	"  BranchTableSize = <num> (Default = 1024)\n"
+	"      Number of entries of the branch target table used to predict branches.\n"
+	"      Must be a power of 2.\n"
+	"\n"
+	"Each core needs an entry to the memory hierarchy, given in the memory\n"
+	"configuration file by a section '[ Entry <name> ]' with variables 'Arch',\n"
+	"'Core', and either 'Module' or 'DataModule' and 'InstModule', plus optional\n"
+	"'DataTLB' and 'InstTLB'.\n"
+	"\n";
+
+
+void interval_config_read(struct interval_config_t *cfg, char *file_name)
+{
+	struct config_t *config;
+	char *section;
+
+	/* Open file */
+	config = config_create(file_name);
+	if (*file_name)
+		config_load(config);
+
+	/* Section '[ General ]' */
+	section = "General";
+	cfg->frequency = config_read_int(config, section, "Frequency", 1000);
+	if (!IN_RANGE(cfg->frequency, 1, ESIM_MAX_FREQUENCY))
+		fatal("%s: invalid value for 'Frequency'", file_name);
+	cfg->num_cores = config_read_int(config, section, "Cores", 1);
+	if (cfg->num_cores < 1)
+		fatal("%s: invalid value for 'Cores'", file_name);
+
+	/* Section '[ Interval ]' */
+	section = "Interval";
+	cfg->dispatch_width = config_read_int(config, section, "DispatchWidth", 4);
+	cfg->window_size = config_read_int(config, section, "WindowSize", 64);
+	cfg->store_buffer_size = config_read_int(config, section, "StoreBufferSize", 16);
+	cfg->mispred_penalty = config_read_int(config, section, "MispredictPenalty", 10);
+	cfg->btb_size = config_read_int(config, section, "BranchTableSize", 1024);
+	if (cfg->dispatch_width < 1)
+		fatal("%s: invalid value for 'DispatchWidth'", file_name);
+	if (cfg->window_size < 1)
+		fatal("%s: invalid value for 'WindowSize'", file_name);
+	if (cfg->store_buffer_size < 1)
+		fatal("%s: invalid value for 'StoreBufferSize'", file_name);
+	if (cfg->mispred_penalty < 0)
+		fatal("%s: invalid value for 'MispredictPenalty'", file_name);
+	if (cfg->btb_size < 1 || (cfg->btb_size & (cfg->btb_size - 1)))
+		fatal("%s: 'BranchTableSize' must be a power of 2", file_name);
+
+	/* Close file */
+	config_check(config);
+	config_free(config);
+}
+
+
+void interval_config_dump(struct interval_config_t *cfg, FILE *f)
+{
+	fprintf(f, "[ Config.General ]\n");
+	fprintf(f, "Frequency = %d\n", cfg->frequency);
+	fprintf(f, "Cores = %d\n", cfg->num_cores);
+	fprintf(f, "\n");
+
+	fprintf(f, "[ Config.Interval ]\n");
+	fprintf(f, "DispatchWidth = %d\n", cfg->dispatch_width);
+	fprintf(f, "WindowSize = %d\n", cfg->window_size);
+	fprintf(f, "StoreBufferSize = %d\n", cfg->store_buffer_size);
+	fprintf(f, "MispredictPenalty = %d\n", cfg->mispred_penalty);
+	fprintf(f, "BranchTableSize = %d\n", cfg->btb_size);
+	fprintf(f, "\n");
+}
+
+
+/* Private L1 caches for each core, a shared L2 cache, and main memory. Module
+ * and network names start with the architecture prefix. */
+void interval_mem_config_default(struct arch_t *arch, struct config_t *config,
+	int num_cores)
+{
+	char section[MAX_STRING_SIZE];
+	char str[MAX_STRING_SIZE];
+	char *prefix;
+
+	int i;
+
+	/* Cache geometry for L1 */
+	prefix = arch->prefix;
+	snprintf(section, sizeof section, "CacheGeometry %s-geo-l1", prefix);
+	config_write_int(config, section, "Sets", 16);
+	config_write_int(config, section, "Assoc", 2);
+	config_write_int(config, section, "BlockSize", 64);
+	config_write_int(config, section, "Latency", 1);
+	config_write_string(config, section, "Policy", "LRU");
+
+	/* Cache geometry for L2 */
+	snprintf(section, sizeof section, "CacheGeometry %s-geo-l2", prefix);
+	config_write_int(config, section, "Sets", 64);
+	config_write_int(config, section, "Assoc", 4);
+	config_write_int(config, section, "BlockSize", 64);
+	config_write_int(config, section, "Latency", 10);
+	config_write_string(config, section, "Policy", "LRU");
+
+	/* L1 caches and entries */
+	for (i = 0; i < num_cores; i++)
+	{
+		/* L1 cache */
+		snprintf(section, sizeof section, "Module %s-l1-%d", prefix, i);
+		config_write_string(config, section, "Type", "Cache");
+		snprintf(str, sizeof str, "%s-geo-l1", prefix);
+		config_write_string(config, section, "Geometry", str);
+		snprintf(str, sizeof str, "%s-net-l1-l2", prefix);
+		config_write_string(config, section, "LowNetwork", str);
+		snprintf(str, sizeof str, "%s-l2", prefix);
+		config_write_string(config, section, "LowModules", str);
+
+		/* Entry */
+		snprintf(section, sizeof section, "Entry %s-core-%d", prefix, i);
+		config_write_string(config, section, "Arch", arch->name);
+		config_write_int(config, section, "Core", i);
+		snprintf(str, sizeof str, "%s-l1-%d", prefix, i);
+		config_write_string(config, section, "Module", str);
+	}
+
+	/* L2 cache */
+	snprintf(section, sizeof section, "Module %s-l2", prefix);
+	config_write_string(config, section, "Type", "Cache");
+	snprintf(str, sizeof str, "%s-geo-l2", prefix);
+	config_write_string(config, section, "Geometry", str);
+	snprintf(str, sizeof str, "%s-net-l1-l2", prefix);
+	config_write_string(config, section, "HighNetwork", str);
+	snprintf(str, sizeof str, "%s-net-l2-mm", prefix);
+	config_write_string(config, section, "LowNetwork", str);
+	snprintf(str, sizeof str, "%s-mm", prefix);
+	config_write_string(config, section, "LowModules", str);
+
+	/* Main memory */
+	snprintf(section, sizeof section, "Module %s-mm", prefix);
+	config_write_string(config, section, "Type", "MainMemory");
+	snprintf(str, sizeof str, "%s-net-l2-mm", prefix);
+	config_write_string(config, section, "HighNetwork", str);
+	config_write_int(config, section, "BlockSize", 64);
+	config_write_int(config, section, "Latency", 100);
+
+	/* Network connecting L1 caches and L2 */
+	snprintf(section, sizeof section, "Network %s-net-l1-l2", prefix);
+	config_write_int(config, section, "DefaultInputBufferSize", 144);
+	config_write_int(config, section, "DefaultOutputBufferSize", 144);
+	config_write_int(config, section, "DefaultBandwidth", 72);
+
+	/* Network connecting L2 cache and main memory */
+	snprintf(section, sizeof section, "Network %s-net-l2-mm", prefix);
+	config_write_int(config, section, "DefaultInputBufferSize", 528);
+	config_write_int(config, section, "DefaultOutputBufferSize", 528);
+	config_write_int(config, section, "DefaultBandwidth", 264);
+}
+
+
+void interval_mem_config_parse_entry(struct arch_t *arch,
+	struct config_t *config, char *section,
+	struct interval_core_t **cores, int num_cores)
+{
+	struct interval_core_t *core;
+
+	char *file_name;
+
+	int core_index;
+
+	int unified_present;
+	int data_inst_present;
+
+	char *data_module_name;
+	char *inst_module_name;
+
+	char *data_tlb_name;
+	char *inst_tlb_name;
+
+	/* Get configuration file name */
+	file_name = config_get_file_name(config);
+
+	/* Allow these sections in case we quit before reading them. */
+	config_var_allow(config, section, "DataModule");
+	config_var_allow(config, section, "InstModule");
+	config_var_allow(config, section, "Module");
+
+	/* Check right presence of sections */
+	unified_present = config_var_exists(config, section, "Module");
+	data_inst_present = config_var_exists(config, section, "DataModule") &&
+		config_var_exists(config, section, "InstModule");
+	if (!(unified_present ^ data_inst_present))
+		fatal("%s: section [%s]: invalid combination of modules.\n"
+			"\tAn %s entry to the memory hierarchy needs to specify either a unified\n"
+			"\tentry for data and instructions (variable 'Module'), or two separate\n"
+			"\tentries for data and instructions (variables 'DataModule' and 'InstModule'),\n"
+			"\tbut not both.\n",
+			file_name, section, arch->name);
+
+	/* Read core */
+	core_index = config_read_int(config, section, "Core", -1);
+	if (core_index < 0)
+		fatal("%s: section [%s]: invalid or missing value for 'Core'",
+			file_name, section);
+
+	/* Check bounds */
+	if (core_index >= num_cores)
+	{
+		warning("%s: section [%s] ignored, referring to %s Core %d.\n"
+			"\tThis section refers to a core that does not currently exist.\n"
+			"\tPlease review your %s configuration file if this behavior is not desired.\n",
+			file_name, section, arch->name, core_index, arch->name);
+		return;
+	}
+
+	/* Check that entry has not been assigned before */
+	core = cores[core_index];
+	if (core->data_mod || core->inst_mod)
+		fatal("%s: section [%s]: entry from %s Core %d already assigned.\n"
+			"\tA different [Entry <name>] section in the memory configuration file has already\n"
+			"\tassigned an entry for this particular core. Please review your\n"
+			"\tconfiguration file to avoid duplicates.\n",
+			file_name, section, arch->name, core_index);
+
+	/* Read modules */
+	if (data_inst_present)
+	{
+		data_module_name = config_read_string(config, section, "DataModule", NULL);
+		inst_module_name = config_read_string(config, section, "InstModule", NULL);
+		assert(data_module_name);
+		assert(inst_module_name);
+	}
+	else
+	{
+		data_module_name = inst_module_name =
+			config_read_string(config, section, "Module", NULL);
+		assert(data_module_name);
+	}
+
+	/* Assign modules */
+	core->data_mod = mem_system_get_mod(data_module_name);
+	if (!core->data_mod)
+		fatal("%s: section [%s]: '%s' is not a valid module name.\n"
+			"\tThe given module name must match a module declared in a section\n"
+			"\t[Module <name>] in the memory configuration file.\n",
+			file_name, section, data_module_name);
+	core->inst_mod = mem_system_get_mod(inst_module_name);
+	if (!core->inst_mod)
+		fatal("%s: section [%s]: '%s' is not a valid module name.\n"
+			"\tThe given module name must match a module declared in a section\n"
+			"\t[Module <name>] in the memory configuration file.\n",
+			file_name, section, inst_module_name);
+
+	/* Assign TLBs, optional */
+	data_tlb_name = config_read_string(config, section, "DataTLB", "");
+	inst_tlb_name = config_read_string(config, section, "InstTLB", "");
+	if (*data_tlb_name)
+	{
+		core->data_tlb = mem_system_get_tlb(data_tlb_name);
+		if (!core->data_tlb)
+			fatal("%s: section [%s]: '%s' is not a valid TLB name.\n"
+				"\tThe given TLB name must match a TLB declared in a section\n"
+				"\t[TLB <name>] in the memory configuration file.\n",
+				file_name, section, data_tlb_name);
+	}
+	if (*inst_tlb_name)
+	{
+		core->inst_tlb = mem_system_get_tlb(inst_tlb_name);
+		if (!core->inst_tlb)
+			fatal("%s: section [%s]: '%s' is not a valid TLB name.\n"
+				"\tThe given TLB name must match a TLB declared in a section\n"
+				"\t[TLB <name>] in the memory configuration file.\n",
+				file_name, section, inst_tlb_name);
+	}
+
+	/* Add modules to entry list */
+	linked_list_add(arch->mem_entry_mod_list, core->data_mod);
+	if (core->data_mod != core->inst_mod)
+		linked_list_add(arch->mem_entry_mod_list, core->inst_mod);
+
+	/* Debug */
+	mem_debug("\t%s Core %d\n", arch->name, core_index);
+	mem_debug("\t\tEntry for instructions -> %s\n", core->inst_mod->name);
+	mem_debug("\t\tEntry for data -> %s\n", core->data_mod->name);
+	mem_debug("\n");
+}
+
+
+void interval_mem_config_check(struct arch_t *arch, struct config_t *config,
+	struct interval_core_t **cores, int num_cores)
+{
+	char *file_name;
+	int i;
+
+	/* Check that all cores have an entry to the memory hierarchy */
+	file_name = config_get_file_name(config);
+	for (i = 0; i < num_cores; i++)
+		if (!cores[i]->data_mod || !cores[i]->inst_mod)
+			fatal("%s: %s Core %d lacks a data/instruction entry to memory.\n"
+				"\tPlease add a new [Entry <name>] section in your memory configuration\n"
+				"\tfile to associate this core with a memory module.\n",
+				file_name, arch->name, i);
+}
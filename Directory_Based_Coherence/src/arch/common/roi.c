@@ -0,0 +1,145 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <lib/esim/esim.h>
+#include <lib/util/debug.h>
+#include <mem-system/mem-system.h>
+
+#include "arch.h"
+#include "roi.h"
+#include "timing.h"
+
+
+/*
+ * Public Variables
+ */
+
+long long roi_start_cycle;
+long long roi_end_cycle;
+int roi_fast_forward;
+
+enum roi_state_t roi_state;
+long long roi_begin_cycle;
+
+
+
+
+/*
+ * Private Functions
+ */
+
+static void roi_reset_timing_stats(struct arch_t *arch, void *user_data)
+{
+	Timing *timing = arch->timing;
+
+	if (timing)
+		timing->ResetStats(timing);
+}
+
+
+/* Finish simulation, so that the final reports cover the ROI */
+static void roi_finish(void)
+{
+	if (roi_state == roi_state_inside)
+		roi_state = roi_state_after;
+	if (!esim_finish)
+		esim_finish = esim_finish_roi_end;
+}
+
+
+
+
+/*
+ * Public Functions
+ */
+
+void roi_begin(void)
+{
+	/* Only the first marker counts */
+	if (roi_state != roi_state_before)
+	{
+		warning("%s: region of interest already started, marker ignored",
+			__FUNCTION__);
+		return;
+	}
+
+	/* Reset statistics */
+	mem_system_reset_stats();
+	arch_for_each(roi_reset_timing_stats, NULL);
+	roi_state = roi_state_inside;
+	roi_begin_cycle = esim_cycle();
+}
+
+
+void roi_end(void)
+{
+	if (roi_state != roi_state_inside)
+	{
+		warning("%s: region of interest not started, marker ignored",
+			__FUNCTION__);
+		return;
+	}
+	roi_finish();
+}
+
+
+void roi_check(void)
+{
+	long long cycle;
+
+	cycle = esim_cycle();
+	if (roi_start_cycle && roi_state == roi_state_before
+			&& cycle >= roi_start_cycle)
+		roi_begin();
+
+	/* The end cycle applies even if the ROI never started */
+	if (roi_end_cycle && cycle >= roi_end_cycle)
+		roi_finish();
+}
+
+
+int roi_marker(int marker)
+{
+	switch (marker)
+	{
+
+	case roi_marker_begin:
+		roi_begin();
+		return 0;
+
+	case roi_marker_end:
+		roi_end();
+		return 0;
+
+	default:
+		warning("%s: invalid region of interest marker (%d)",
+			__FUNCTION__, marker);
+		return -1;
+	}
+}
+
+
+void roi_done(void)
+{
+	/* Warn if the reports cover the whole simulation */
+	if ((roi_start_cycle || roi_fast_forward) && roi_state == roi_state_before)
+		warning("region of interest never started, statistics cover the "
+			"complete simulation");
+}
+
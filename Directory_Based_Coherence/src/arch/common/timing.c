@@ -40,6 +40,7 @@ void TimingCreate(Timing *self)
 {
 	/* Virtual functions */
 	asObject(self)->Dump = TimingDump;
+	self->ResetStats = TimingResetStats;
 	self->Run = TimingRun;
 	self->MemConfigDefault = TimingMemConfigDefault;
 	self->MemConfigCheck = TimingMemConfigCheck;
@@ -88,6 +89,12 @@ void TimingDumpSummary(Timing *self, FILE *f)
 }
 
 
+void TimingResetStats(Timing *self)
+{
+	self->reset_cycle = self->cycle;
+}
+
+
 int TimingRun(Timing *self)
 {
 	panic("%s: abstract function not overridden",
@@ -38,6 +38,10 @@ CLASS_BEGIN(Timing, Object)
 	/* Current cycle */
 	long long cycle;
 
+	/* Cycle when statistics were last reset. Rates in reports are computed
+	 * over the cycles elapsed since. */
+	long long reset_cycle;
+
 	/* Frequency domain, as returned by 'esim_new_domain()'.
 	 * This variable is initialized by the child class. */
 	int frequency;
@@ -50,6 +54,10 @@ CLASS_BEGIN(Timing, Object)
 	/* Print statistics summary */
 	void (*DumpSummary)(Timing *self, FILE *f);
 
+	/* Reset statistics, e.g. at the start of the region of interest.
+	 * Children overriding it must call the parent function. */
+	void (*ResetStats)(Timing *self);
+
 	/* Virtual abstract function to run one step of the timing simulation
 	 * loop. The function returns TRUE if any valid simulation was
 	 * performed by the architecture. */
@@ -71,6 +79,7 @@ void TimingDestroy(Timing *self);
 
 void TimingDump(Object *self, FILE *f);
 void TimingDumpSummary(Timing *self, FILE *f);
+void TimingResetStats(Timing *self);
 
 int TimingRun(Timing *self);
 
@@ -18,6 +18,8 @@
  */
 
 
+#include <string.h>
+
 #include <arch/evergreen/emu/ndrange.h>
 #include <arch/evergreen/emu/wavefront.h>
 #include <arch/evergreen/emu/work-group.h>
@@ -56,6 +58,9 @@ struct evg_compute_unit_t *evg_compute_unit_create()
 	compute_unit->local_memory = mod_create(buf, mod_kind_local_memory,
 		evg_gpu_local_mem_num_ports, evg_gpu_local_mem_block_size, evg_gpu_local_mem_latency);
 
+	/* Global memory */
+	coalescer_init(&compute_unit->global_mem_coalescer, evg_gpu_global_mem_coalesce);
+
 	/* Initialize CF Engine */
 	compute_unit->cf_engine.complete_queue = linked_list_create();
 	compute_unit->cf_engine.fetch_buffer = xcalloc(evg_gpu_max_wavefronts_per_compute_unit, sizeof(void *));
@@ -143,6 +148,39 @@ void evg_compute_unit_free(struct evg_compute_unit_t *compute_unit)
 }
 
 
+/* Reset the statistics of a compute unit and of its local memory. Counters
+ * sampled by the spatial report are not affected. */
+void evg_compute_unit_reset_stats(struct evg_compute_unit_t *compute_unit)
+{
+	compute_unit->mapped_work_groups = 0;
+	compute_unit->cycle = 0;
+	compute_unit->inst_count = 0;
+
+	/* CF Engine */
+	compute_unit->cf_engine.inst_count = 0;
+	compute_unit->cf_engine.alu_clause_trigger_count = 0;
+	compute_unit->cf_engine.tex_clause_trigger_count = 0;
+	compute_unit->cf_engine.global_mem_write_count = 0;
+
+	/* ALU Engine */
+	compute_unit->alu_engine.wavefront_count = 0;
+	compute_unit->alu_engine.cycle = 0;
+	compute_unit->alu_engine.inst_count = 0;
+	compute_unit->alu_engine.inst_slot_count = 0;
+	compute_unit->alu_engine.local_mem_slot_count = 0;
+	memset(compute_unit->alu_engine.vliw_slots, 0,
+		sizeof compute_unit->alu_engine.vliw_slots);
+
+	/* TEX Engine */
+	compute_unit->tex_engine.wavefront_count = 0;
+	compute_unit->tex_engine.cycle = 0;
+	compute_unit->tex_engine.inst_count = 0;
+
+	coalescer_reset_stats(&compute_unit->global_mem_coalescer);
+	mod_reset_stats(compute_unit->local_memory);
+}
+
+
 void evg_compute_unit_map_work_group(struct evg_compute_unit_t *compute_unit, struct evg_work_group_t *work_group)
 {
 	struct evg_ndrange_t *ndrange = work_group->ndrange;
@@ -20,6 +20,8 @@
 #ifndef ARCH_EVERGREEN_COMPUTE_UNIT_H
 #define ARCH_EVERGREEN_COMPUTE_UNIT_H
 
+#include <mem-system/coalescer.h>
+
 #include "uop.h"
 
 
@@ -67,6 +69,9 @@ struct evg_compute_unit_t
 	struct mod_t *global_memory;
 	struct mod_t *local_memory;
 
+	/* Address coalescer for global memory accesses */
+	struct coalescer_t global_mem_coalescer;
+
 	/* List of currently mapped work-groups */
 	int work_group_count;
 	struct evg_work_group_t **work_groups;
@@ -175,6 +180,7 @@ struct evg_compute_unit_t
 
 struct evg_compute_unit_t *evg_compute_unit_create(void);
 void evg_compute_unit_free(struct evg_compute_unit_t *gpu_compute_unit);
+void evg_compute_unit_reset_stats(struct evg_compute_unit_t *compute_unit);
 void evg_compute_unit_map_work_group(struct evg_compute_unit_t *compute_unit, struct evg_work_group_t *work_group);
 void evg_compute_unit_unmap_work_group(struct evg_compute_unit_t *compute_unit, struct evg_work_group_t *work_group);
 void evg_compute_unit_run(struct evg_compute_unit_t *compute_unit);
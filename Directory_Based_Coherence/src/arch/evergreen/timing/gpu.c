@@ -87,6 +87,11 @@ char *evg_gpu_config_help =
 	"      Wavefront scheduling algorithm.\n"
 	"      'RoundRobin' selects wavefronts in a cyclic fashion.\n"
 	"      'Greedy' selects the most recently used wavefront.\n"
+	"  CoalesceGlobalMemory = {t|f} (Default = f)\n"
+	"      Merge the global memory addresses of all work-items of a wavefront\n"
+	"      that fall in the same block into a single access. Otherwise, each\n"
+	"      work-item accesses global memory separately. Coalescing is only\n"
+	"      supported for wavefronts of up to 64 work-items.\n"
 	"\n"
 	"Section '[ LocalMemory ]': defines the parameters of the local memory associated to\n"
 	"each compute unit.\n"
@@ -155,6 +160,7 @@ enum evg_gpu_register_alloc_granularity_t evg_gpu_register_alloc_granularity;
 
 int evg_gpu_max_work_groups_per_compute_unit = 8;
 int evg_gpu_max_wavefronts_per_compute_unit = 32;
+int evg_gpu_global_mem_coalesce = 0;
 
 /* Local memory parameters */
 int evg_gpu_local_mem_size = 32768;  /* 32 KB */
@@ -199,6 +205,7 @@ static void evg_config_dump(FILE *f)
 	fprintf(f, "MaxWorkGroupsPerComputeUnit = %d\n", evg_gpu_max_work_groups_per_compute_unit);
 	fprintf(f, "MaxWavefrontsPerComputeUnit = %d\n", evg_gpu_max_wavefronts_per_compute_unit);
 	fprintf(f, "SchedulingPolicy = %s\n", str_map_value(&evg_gpu_sched_policy_map, evg_gpu_sched_policy));
+	fprintf(f, "CoalesceGlobalMemory = %s\n", evg_gpu_global_mem_coalesce ? "True" : "False");
 	fprintf(f, "\n");
 
 	/* Local Memory */
@@ -321,6 +328,8 @@ void evg_gpu_read_config(void)
 	evg_gpu_max_wavefronts_per_compute_unit = config_read_int(gpu_config, section, "MaxWavefrontsPerComputeUnit",
 		evg_gpu_max_wavefronts_per_compute_unit);
 	gpu_sched_policy_str = config_read_string(gpu_config, section, "SchedulingPolicy", "RoundRobin");
+	evg_gpu_global_mem_coalesce = config_read_bool(gpu_config, section, "CoalesceGlobalMemory",
+		evg_gpu_global_mem_coalesce);
 	if (evg_gpu_num_compute_units < 1)
 		fatal("%s: invalid value for 'NumComputeUnits'.\n%s", evg_gpu_config_file_name, err_note);
 	if (evg_gpu_num_stream_cores < 1)
@@ -346,6 +355,9 @@ void evg_gpu_read_config(void)
 		fatal("%s: invalid value for 'MaxWorkGroupsPerComputeUnit'.\n%s", evg_gpu_config_file_name, err_note);
 	if (evg_gpu_max_wavefronts_per_compute_unit < 1)
 		fatal("%s: invalid value for 'MaxWavefrontsPerComputeUnit'.\n%s", evg_gpu_config_file_name, err_note);
+	if (evg_gpu_global_mem_coalesce && evg_emu_wavefront_size > COALESCER_MAX_LANES)
+		fatal("%s: 'CoalesceGlobalMemory' requires a 'WavefrontSize' of at most %d.\n%s",
+			evg_gpu_config_file_name, COALESCER_MAX_LANES, err_note);
 	
 	/* Local memory */
 	section = "LocalMemory";
@@ -534,8 +546,8 @@ void evg_gpu_dump_report(void)
 			/ compute_unit->alu_engine.cycle : 0.0;
 		tex_inst_per_cycle = compute_unit->tex_engine.cycle ? (double) compute_unit->tex_engine.inst_count
 			/ compute_unit->tex_engine.cycle : 0.0;
-		coalesced_reads = local_mod->reads - local_mod->effective_reads;
-		coalesced_writes = local_mod->writes - local_mod->effective_writes;
+		coalesced_reads = local_mod->stats.reads - local_mod->stats.effective_reads;
+		coalesced_writes = local_mod->stats.writes - local_mod->stats.effective_writes;
 		snprintf(vliw_occupancy, MAX_STRING_SIZE, "%lld %lld %lld %lld %lld",
 			compute_unit->alu_engine.vliw_slots[0],
 			compute_unit->alu_engine.vliw_slots[1],
@@ -573,13 +585,23 @@ void evg_gpu_dump_report(void)
 		fprintf(f, "TEXEngine.InstructionsPerCycle = %.4g\n", tex_inst_per_cycle);
 		fprintf(f, "\n");
 
-		fprintf(f, "LocalMemory.Accesses = %lld\n", local_mod->reads + local_mod->writes);
-		fprintf(f, "LocalMemory.Reads = %lld\n", local_mod->reads);
-		fprintf(f, "LocalMemory.EffectiveReads = %lld\n", local_mod->effective_reads);
+		fprintf(f, "LocalMemory.Accesses = %lld\n", local_mod->stats.reads + local_mod->stats.writes);
+		fprintf(f, "LocalMemory.Reads = %lld\n", local_mod->stats.reads);
+		fprintf(f, "LocalMemory.EffectiveReads = %lld\n", local_mod->stats.effective_reads);
 		fprintf(f, "LocalMemory.CoalescedReads = %lld\n", coalesced_reads);
-		fprintf(f, "LocalMemory.Writes = %lld\n", local_mod->writes);
-		fprintf(f, "LocalMemory.EffectiveWrites = %lld\n", local_mod->effective_writes);
+		fprintf(f, "LocalMemory.Writes = %lld\n", local_mod->stats.writes);
+		fprintf(f, "LocalMemory.EffectiveWrites = %lld\n", local_mod->stats.effective_writes);
 		fprintf(f, "LocalMemory.CoalescedWrites = %lld\n", coalesced_writes);
+
+		if (evg_gpu_global_mem_coalesce)
+		{
+			fprintf(f, "\n");
+			fprintf(f, "GlobalMemory.WorkItemAccesses = %lld\n", compute_unit->global_mem_coalescer.lane_accesses);
+			fprintf(f, "GlobalMemory.Accesses = %lld\n", compute_unit->global_mem_coalescer.request_count);
+			fprintf(f, "GlobalMemory.CoalescingEfficiency = %.4g\n", compute_unit->global_mem_coalescer.request_count ?
+				(double) compute_unit->global_mem_coalescer.lane_accesses /
+				compute_unit->global_mem_coalescer.request_count : 0.0);
+		}
 		fprintf(f, "\n\n");
 	}
 }
@@ -644,6 +666,7 @@ void EvgGpuCreate(EvgGpu *self)
 	/* Virtual functions */
 	asObject(self)->Dump = EvgGpuDump;
 	asTiming(self)->DumpSummary = EvgGpuDumpSummary;
+	asTiming(self)->ResetStats = EvgGpuResetStats;
 	asTiming(self)->Run = EvgGpuRun;
 	asTiming(self)->MemConfigCheck = EvgGpuMemConfigCheck;
 	asTiming(self)->MemConfigDefault = EvgGpuMemConfigDefault;
@@ -686,6 +709,21 @@ void EvgGpuDumpSummary(Timing *self, FILE *f)
 }
 
 
+/* Reset the statistics of the compute units. Counters of the device section
+ * are kept by the emulator, and are not reset. */
+void EvgGpuResetStats(Timing *self)
+{
+	EvgGpu *gpu = asEvgGpu(self);
+	int compute_unit_id;
+
+	EVG_GPU_FOREACH_COMPUTE_UNIT(compute_unit_id)
+		evg_compute_unit_reset_stats(gpu->compute_units[compute_unit_id]);
+
+	/* Call parent */
+	TimingResetStats(self);
+}
+
+
 int EvgGpuRun(Timing *self)
 {
 	EvgGpu *gpu = asEvgGpu(self);
@@ -188,6 +188,10 @@ char *frm_gpu_config_help =
 	"      Latency of register file writes in number of cycles.\n"
 	"  WriteBufferSize = <num> (Default = 1)\n"
 	"      Size of the buffer holding register write instructions.\n"
+	"  Coalesce = {t|f} (Default = f)\n"
+	"      Merge the addresses of all threads of a warp that fall in the\n"
+	"      same block of global memory into a single access. Otherwise,\n"
+	"      each thread accesses global memory separately.\n"
 	"\n"
 	"Section '[ SharedMem ]': defines the parameters of the shared memory\n"
 	"on each SM.\n"
@@ -369,6 +373,7 @@ int frm_gpu_vector_mem_read_buffer_size = 1;
 int frm_gpu_vector_mem_max_inflight_mem_accesses = 32;
 int frm_gpu_vector_mem_write_latency = 1;
 int frm_gpu_vector_mem_write_buffer_size = 1;
+int frm_gpu_vector_mem_coalesce = 0;
 
 /* Shared memory parameters */
 int frm_gpu_shared_mem_size = 49152;
@@ -480,6 +485,8 @@ void frm_config_dump(FILE *f)
 	fprintf(f, "WriteLatency = %d\n", frm_gpu_vector_mem_write_latency);
 	fprintf(f, "WriteBufferSize = %d\n",
 			frm_gpu_vector_mem_write_buffer_size);
+	fprintf(f, "Coalesce = %s\n", frm_gpu_vector_mem_coalesce ?
+			"True" : "False");
 	fprintf(f, "\n");
 
 	/* LDS */
@@ -877,6 +884,10 @@ void frm_gpu_read_config(void)
 		fatal("%s: invalid value for 'WriteBufferSize'.\n%s",
 				frm_gpu_config_file_name, err_note);
 
+	frm_gpu_vector_mem_coalesce = config_read_bool(
+			gpu_config, section, "Coalesce", 
+			frm_gpu_vector_mem_coalesce);
+
 	/* Shared Memory Unit */
 	section = "SharedMemUnit";
 
@@ -1015,8 +1026,8 @@ void frm_gpu_dump_report(void)
 		inst_per_cycle = sm->cycle ? 
 			(double)(sm->inst_count/sm->cycle) :
 			0.0;
-		coalesced_reads = lds_mod->reads - lds_mod->effective_reads;
-		coalesced_writes = lds_mod->writes - lds_mod->effective_writes;
+		coalesced_reads = lds_mod->stats.reads - lds_mod->stats.effective_reads;
+		coalesced_writes = lds_mod->stats.writes - lds_mod->stats.effective_writes;
 
 		fprintf(f, "[ SM%d ]\n\n", sm_id);
 
@@ -1030,13 +1041,26 @@ void frm_gpu_dump_report(void)
 		fprintf(f, "InstructionsPerCycle = %.4g\n", inst_per_cycle);
 		fprintf(f, "\n");
 
-		fprintf(f, "SharedMem.Accesses = %lld\n", lds_mod->reads + lds_mod->writes);
-		fprintf(f, "SharedMem.Reads = %lld\n", lds_mod->reads);
-		fprintf(f, "SharedMem.EffectiveReads = %lld\n", lds_mod->effective_reads);
+		fprintf(f, "SharedMem.Accesses = %lld\n", lds_mod->stats.reads + lds_mod->stats.writes);
+		fprintf(f, "SharedMem.Reads = %lld\n", lds_mod->stats.reads);
+		fprintf(f, "SharedMem.EffectiveReads = %lld\n", lds_mod->stats.effective_reads);
 		fprintf(f, "SharedMem.CoalescedReads = %lld\n", coalesced_reads);
-		fprintf(f, "SharedMem.Writes = %lld\n", lds_mod->writes);
-		fprintf(f, "SharedMem.EffectiveWrites = %lld\n", lds_mod->effective_writes);
+		fprintf(f, "SharedMem.Writes = %lld\n", lds_mod->stats.writes);
+		fprintf(f, "SharedMem.EffectiveWrites = %lld\n", lds_mod->stats.effective_writes);
 		fprintf(f, "SharedMem.CoalescedWrites = %lld\n", coalesced_writes);
+
+		if (frm_gpu_vector_mem_coalesce)
+		{
+			fprintf(f, "\n");
+			fprintf(f, "GlobalMem.ThreadAccesses = %lld\n",
+				sm->vector_mem_unit.coalescer.lane_accesses);
+			fprintf(f, "GlobalMem.Accesses = %lld\n",
+				sm->vector_mem_unit.coalescer.request_count);
+			fprintf(f, "GlobalMem.CoalescingEfficiency = %.4g\n",
+				sm->vector_mem_unit.coalescer.request_count ?
+				(double) sm->vector_mem_unit.coalescer.lane_accesses /
+				sm->vector_mem_unit.coalescer.request_count : 0.0);
+		}
 		fprintf(f, "\n\n");
 	}
 
@@ -1078,6 +1102,7 @@ void FrmGpuCreate(FrmGpu *self)
 	/* Virtual functions */
 	asObject(self)->Dump = FrmGpuDump;
 	asTiming(self)->DumpSummary = FrmGpuDumpSummary;
+	asTiming(self)->ResetStats = FrmGpuResetStats;
 	asTiming(self)->Run = FrmGpuRun;
 	asTiming(self)->MemConfigCheck = FrmGpuMemConfigCheck;
 	asTiming(self)->MemConfigDefault = FrmGpuMemConfigDefault;
@@ -1112,6 +1137,21 @@ void FrmGpuDumpSummary(Timing *self, FILE *f)
 }
 
 
+/* Reset the statistics of the SMs. Counters of the device section are kept
+ * by the emulator, and are not reset. */
+void FrmGpuResetStats(Timing *self)
+{
+	FrmGpu *gpu = asFrmGpu(self);
+	int sm_id;
+
+	FRM_GPU_FOREACH_SM(sm_id)
+		frm_sm_reset_stats(gpu->sms[sm_id]);
+
+	/* Call parent */
+	TimingResetStats(self);
+}
+
+
 int FrmGpuRun(Timing *self)
 {
 	FrmGpu *gpu = asFrmGpu(self);
@@ -76,6 +76,8 @@ struct frm_sm_t *frm_sm_create()
 	sm->vector_mem_unit.mem_buffer = list_create();
 	sm->vector_mem_unit.write_buffer = list_create();
 	sm->vector_mem_unit.sm = sm;
+	coalescer_init(&sm->vector_mem_unit.coalescer,
+		frm_gpu_vector_mem_coalesce);
 
 	sm->lds_unit.issue_buffer = list_create();
 	sm->lds_unit.decode_buffer = list_create();
@@ -214,6 +216,32 @@ void frm_sm_free(struct frm_sm_t *sm)
 }
 
 
+/* Reset the statistics of an SM and of its shared memory. Counters sampled
+ * by the spatial report are not affected. */
+void frm_sm_reset_stats(struct frm_sm_t *sm)
+{
+	int i;
+
+	sm->cycle = 0;
+	sm->mapped_thread_blocks = 0;
+	sm->inst_count = 0;
+	sm->branch_inst_count = 0;
+	sm->simd_inst_count = 0;
+	sm->vector_mem_inst_count = 0;
+	sm->lds_inst_count = 0;
+
+	/* Execution units */
+	sm->branch_unit.inst_count = 0;
+	sm->vector_mem_unit.inst_count = 0;
+	sm->lds_unit.inst_count = 0;
+	for (i = 0; i < sm->num_simd_units; i++)
+		sm->simd_units[i]->inst_count = 0;
+
+	coalescer_reset_stats(&sm->vector_mem_unit.coalescer);
+	mod_reset_stats(sm->lds_module);
+}
+
+
 void frm_sm_map_thread_block(struct frm_sm_t *sm, 
 		struct frm_thread_block_t *thread_block)
 {
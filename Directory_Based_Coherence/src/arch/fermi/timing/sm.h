@@ -102,6 +102,7 @@ struct frm_sm_t
 
 struct frm_sm_t *frm_sm_create(void);
 void frm_sm_free(struct frm_sm_t *gpu_sm);
+void frm_sm_reset_stats(struct frm_sm_t *sm);
 void frm_sm_map_thread_block(struct frm_sm_t *sm, 
 	struct frm_thread_block_t *thread_block);
 void frm_sm_unmap_thread_block(struct frm_sm_t *sm, 
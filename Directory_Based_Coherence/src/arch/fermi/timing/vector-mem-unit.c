@@ -167,11 +167,12 @@ void frm_vector_mem_mem(struct frm_vector_mem_unit_t *vector_mem)
 	struct frm_uop_t *uop;
 	struct frm_thread_uop_t *thread_uop;
 	struct frm_thread_t *thread;
+	struct coalescer_t *coalescer = &vector_mem->coalescer;
 	int thread_id;
 	int instructions_processed = 0;
 	int list_entries;
 	int i;
-	enum mod_access_kind_t access_kind;
+	enum mod_access_kind_t access_kind = mod_access_invalid;
 	int list_index = 0;
 
 	list_entries = list_count(vector_mem->read_buffer);
@@ -230,8 +231,11 @@ void frm_vector_mem_mem(struct frm_vector_mem_unit_t *vector_mem)
 		else 
 			fatal("%s: invalid access kind", __FUNCTION__);
 
-		/* Access global memory */
+		/* Access global memory. With coalescing, the threads
+		 * accessing the same block share a single access. */
 		assert(!uop->global_mem_witness);
+		coalescer_start(coalescer, vector_mem->sm->global_memory,
+			access_kind, &uop->global_mem_witness);
 		for (thread_id = uop->warp->threads[0]->id_in_warp; 
 				thread_id < uop->warp->thread_count; 
 				thread_id++)
@@ -239,13 +243,10 @@ void frm_vector_mem_mem(struct frm_vector_mem_unit_t *vector_mem)
 			thread = uop->warp->threads[thread_id];
 			thread_uop = 
 				&uop->thread_uop[thread->id_in_warp];
-
-			mod_access(vector_mem->sm->global_memory, 
-				access_kind, 
-				thread_uop->global_mem_access_addr,
-				&uop->global_mem_witness, NULL, NULL, NULL);
-			uop->global_mem_witness--;
+			coalescer_add(coalescer,
+				thread_uop->global_mem_access_addr);
 		}
+		coalescer_end(coalescer);
 
 		if(frm_spatial_report_active)
 		{
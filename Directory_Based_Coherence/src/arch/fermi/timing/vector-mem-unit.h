@@ -20,6 +20,9 @@
 #ifndef ARCH_FERMI_TIMING_VECTOR_MEM_H
 #define ARCH_FERMI_TIMING_VECTOR_MEM_H
 
+#include <mem-system/coalescer.h>
+
+
 struct frm_vector_mem_unit_t
 {
 	struct list_t *issue_buffer;  /* Issued instructions */
@@ -30,6 +33,9 @@ struct frm_vector_mem_unit_t
 
 	struct frm_sm_t *sm;
 
+	/* Address coalescer, also keeping coalescing statistics */
+	struct coalescer_t coalescer;
+
 	/* Statistics */
 	long long inst_count;
 
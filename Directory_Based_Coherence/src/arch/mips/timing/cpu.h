@@ -20,25 +20,48 @@
 #ifndef ARCH_MIPS_TIMING_CPU_H
 #define ARCH_MIPS_TIMING_CPU_H
 
+#include <stdio.h>
+
+#include <arch/common/interval.h>
 #include <arch/common/timing.h>
 
 
+/* Forward declarations */
+struct mips_ctx_t;
+
+
 /*
  * Class 'MIPSCpu'
  */
 
+/* The MIPS timing simulator is made of interval cores (see
+ * 'arch/common/interval.h'). Each core runs one of the running contexts. */
 CLASS_BEGIN(MIPSCpu, Timing)
 
+	/* Cores, and context mapped to each of them */
+	struct interval_core_t **cores;
+	struct mips_ctx_t **core_ctx;
+
+	/* Statistics */
+	long long num_committed_inst;
+	long long num_branches;
+	long long num_mispred_branches;
+
 CLASS_END(MIPSCpu)
 
 void MIPSCpuCreate(MIPSCpu *self);
 void MIPSCpuDestroy(MIPSCpu *self);
 
+int MIPSCpuRun(Timing *self);
+
 void MIPSCpuDump(Object *self, FILE *f);
 void MIPSCpuDumpSummary(Timing *self, FILE *f);
+void MIPSCpuResetStats(Timing *self);
 
-int MIPSCpuRun(Timing *self);
-
+void MIPSCpuMemConfigDefault(Timing *self, struct config_t *config);
+void MIPSCpuMemConfigCheck(Timing *self, struct config_t *config);
+void MIPSCpuMemConfigParseEntry(Timing *self, struct config_t *config,
+		char *section);
 
 
 
@@ -48,6 +71,10 @@ int MIPSCpuRun(Timing *self);
 
 extern MIPSCpu *mips_cpu;
 
+extern char *mips_cpu_config_file_name;
+extern char *mips_cpu_report_file_name;
+extern struct interval_config_t mips_cpu_config;
+
 void mips_cpu_read_config(void);
 
 void mips_cpu_init(void);
@@ -177,6 +177,7 @@ char *si_emu_report_file_name = "";
 FILE *si_emu_report_file = NULL;
 
 int si_emu_wavefront_size = 64;
+int si_emu_simd = 1;
 
 int si_emu_num_mapped_const_buffers = 2;  /* CB0, CB1 by default */
 
@@ -243,6 +243,7 @@ extern char *si_emu_report_file_name;
 extern FILE *si_emu_report_file;
 
 extern int si_emu_wavefront_size;
+extern int si_emu_simd;  /* Execute vector ALU instructions wavefront-wide */
 
 extern SIEmu *si_emu;
 
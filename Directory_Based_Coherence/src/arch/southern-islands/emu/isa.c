@@ -57,6 +57,9 @@ void si_isa_init()
 #include <arch/southern-islands/asm/asm.dat>
 #undef DEFINST
 
+	/* Lane-parallel implementations */
+	si_isa_simd_init();
+
 	/* Repository of deferred tasks */
 	si_isa_write_task_repos = repos_create(sizeof(struct si_isa_write_task_t),
 		"gpu_isa_write_task_repos");
@@ -66,6 +69,7 @@ void si_isa_done()
 {
 	/* Instruction execution table */
 	free(si_isa_inst_func);
+	si_isa_simd_done();
 
 	/* Repository of deferred tasks */
 	repos_free(si_isa_write_task_repos);
@@ -154,7 +158,7 @@ unsigned int si_isa_read_vreg(struct si_work_item_t *work_item, int vreg)
 	/* Statistics */
 	work_item->work_group->vreg_read_count++;
 
-	return work_item->vreg[vreg].as_uint;
+	return SI_WORK_ITEM_VREG(work_item, vreg).as_uint;
 }
 
 void si_isa_write_vreg(struct si_work_item_t *work_item, int vreg, 
@@ -162,7 +166,7 @@ void si_isa_write_vreg(struct si_work_item_t *work_item, int vreg,
 {
 	assert(vreg >= 0);
 	assert(vreg < 256);
-	work_item->vreg[vreg].as_uint = value;
+	SI_WORK_ITEM_VREG(work_item, vreg).as_uint = value;
 
 	/* Statistics */
 	work_item->work_group->vreg_write_count++;
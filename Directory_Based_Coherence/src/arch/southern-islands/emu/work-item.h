@@ -49,8 +49,11 @@ struct si_work_item_t
 	struct si_wavefront_t *wavefront;
 	struct si_work_group_t *work_group;
 
-	/* Work-item state */
-	union si_reg_t vreg[256];  /* Vector general purpose registers */
+	/* Work-item state. Vector registers are stored by the wavefront, with
+	 * all lanes of a register in consecutive positions. This points to the
+	 * lane of the work-item in register 0, use SI_WORK_ITEM_VREG to access
+	 * other registers. */
+	union si_reg_t *vreg;
 
 	/* Last global memory access */
 	unsigned int global_mem_access_addr;
@@ -63,6 +66,9 @@ struct si_work_item_t
 	int lds_access_type[SI_MAX_LDS_ACCESSES_PER_INST];  /* 0-none, 1-read, 2-write */
 };
 
+#define SI_WORK_ITEM_VREG(WORK_ITEM, VREG) \
+	((WORK_ITEM)->vreg[(VREG) * (WORK_ITEM)->wavefront->vreg_stride])
+
 #define SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(WAVEFRONT, WORK_ITEM_ID) \
 	for ((WORK_ITEM_ID) = 0; \
 		(WORK_ITEM_ID) < si_emu_wavefront_size; \
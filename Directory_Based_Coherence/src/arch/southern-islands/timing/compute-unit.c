@@ -86,6 +86,8 @@ struct si_compute_unit_t *si_compute_unit_create()
 	compute_unit->vector_mem_unit.mem_buffer = list_create();
 	compute_unit->vector_mem_unit.write_buffer = list_create();
 	compute_unit->vector_mem_unit.compute_unit = compute_unit;
+	coalescer_init(&compute_unit->vector_mem_unit.coalescer,
+		si_gpu_vector_mem_coalesce);
 
 	compute_unit->lds_unit.issue_buffer = list_create();
 	compute_unit->lds_unit.decode_buffer = list_create();
@@ -231,6 +233,39 @@ void si_compute_unit_free(struct si_compute_unit_t *compute_unit)
 	free(compute_unit);
 }
 
+
+/* Reset the statistics of a compute unit and of its local memory. Counters
+ * sampled by the spatial report are not affected. */
+void si_compute_unit_reset_stats(struct si_compute_unit_t *compute_unit)
+{
+	int i;
+
+	compute_unit->cycle = 0;
+	compute_unit->mapped_work_groups = 0;
+	compute_unit->inst_count = 0;
+	compute_unit->branch_inst_count = 0;
+	compute_unit->scalar_alu_inst_count = 0;
+	compute_unit->scalar_mem_inst_count = 0;
+	compute_unit->simd_inst_count = 0;
+	compute_unit->vector_mem_inst_count = 0;
+	compute_unit->lds_inst_count = 0;
+	compute_unit->sreg_read_count = 0;
+	compute_unit->sreg_write_count = 0;
+	compute_unit->vreg_read_count = 0;
+	compute_unit->vreg_write_count = 0;
+
+	/* Execution units */
+	compute_unit->scalar_unit.inst_count = 0;
+	compute_unit->branch_unit.inst_count = 0;
+	compute_unit->vector_mem_unit.inst_count = 0;
+	compute_unit->lds_unit.inst_count = 0;
+	for (i = 0; i < compute_unit->num_wavefront_pools; i++)
+		compute_unit->simd_units[i]->inst_count = 0;
+
+	coalescer_reset_stats(&compute_unit->vector_mem_unit.coalescer);
+	mod_reset_stats(compute_unit->lds_module);
+}
+
 void si_compute_unit_map_work_group(struct si_compute_unit_t *compute_unit,
 	struct si_work_group_t *work_group)
 {
@@ -101,6 +101,7 @@ struct si_compute_unit_t
 
 struct si_compute_unit_t *si_compute_unit_create(void);
 void si_compute_unit_free(struct si_compute_unit_t *gpu_compute_unit);
+void si_compute_unit_reset_stats(struct si_compute_unit_t *compute_unit);
 void si_compute_unit_map_work_group(struct si_compute_unit_t *compute_unit, 
 	struct si_work_group_t *work_group);
 void si_compute_unit_unmap_work_group(struct si_compute_unit_t *compute_unit, 
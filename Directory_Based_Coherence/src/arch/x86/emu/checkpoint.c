@@ -289,8 +289,8 @@ static void load_memory_data(struct mem_t *mem)
 
 static void save_memory_data(struct mem_t *mem)
 {
+	struct mem_page_t *page;
 	int old_mem_safe;
-	int i;
 
 	cfg_push("ranges");
 
@@ -298,13 +298,14 @@ static void save_memory_data(struct mem_t *mem)
 	old_mem_safe = mem->safe;
 	mem->safe = 0;
 
-	/* Iterate over memory pages */
-	for (i = 0; i < MEM_PAGE_COUNT; i++)
+	/* Iterate over memory pages in ascending address order */
+	page = mem_page_get(mem, 0);
+	if (!page)
+		page = mem_page_get_next(mem, 0);
+	while (page)
 	{
-		struct mem_page_t *page;
-
-		for (page = mem->pages[i]; page; page = page->next)
-			save_memory_page(page);
+		save_memory_page(page);
+		page = mem_page_get_next(mem, page->tag);
 	}
 
 	mem->safe = old_mem_safe;
@@ -0,0 +1,143 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <lib/mhandle/mhandle.h>
+#include <mem-system/memory.h>
+
+#include "decode-cache.h"
+
+
+static unsigned int x86_decode_cache_index(struct mem_t *mem, unsigned int eip)
+{
+	unsigned int hash;
+
+	hash = eip ^ (eip >> 10) ^ ((unsigned long) mem >> 6);
+	return hash % X86_DECODE_CACHE_SIZE;
+}
+
+
+struct x86_decode_cache_t *x86_decode_cache_create(void)
+{
+	struct x86_decode_cache_t *cache;
+
+	/* Initialize */
+	cache = xcalloc(1, sizeof(struct x86_decode_cache_t));
+
+	/* Return */
+	return cache;
+}
+
+
+void x86_decode_cache_free(struct x86_decode_cache_t *cache)
+{
+	int i;
+
+	for (i = 0; i < X86_DECODE_CACHE_SIZE; i++)
+		free(cache->block[i]);
+	free(cache);
+}
+
+
+struct x86_inst_t *x86_decode_cache_lookup(struct x86_decode_cache_t *cache,
+	struct mem_t *mem, unsigned int eip,
+	struct x86_decode_block_t **block_ptr, int *index_ptr)
+{
+	struct x86_decode_block_t *block;
+	struct mem_page_t *page;
+	int index;
+
+	/* Page versions are unique across pages, so a matching version also
+	 * guarantees that the block was decoded from this very page. */
+	page = mem_page_get(mem, eip);
+	if (!page)
+		goto miss;
+
+	/* Instruction following the last one fetched by the context */
+	block = *block_ptr;
+	index = *index_ptr + 1;
+	if (block && block->mem == mem && index < block->count &&
+		block->inst[index].eip == eip && block->version == page->version)
+		goto hit;
+
+	/* Block starting at 'eip' */
+	block = cache->block[x86_decode_cache_index(mem, eip)];
+	index = 0;
+	if (block && block->mem == mem && block->count &&
+		block->inst[0].eip == eip && block->version == page->version)
+		goto hit;
+
+miss:
+	cache->misses++;
+	return NULL;
+
+hit:
+	cache->hits++;
+	*block_ptr = block;
+	*index_ptr = index;
+	return &block->inst[index];
+}
+
+
+void x86_decode_cache_insert(struct x86_decode_cache_t *cache,
+	struct mem_t *mem, struct x86_inst_t *inst,
+	struct x86_decode_block_t **block_ptr, int *index_ptr)
+{
+	struct x86_decode_block_t *block;
+	struct x86_inst_t *last;
+	struct mem_page_t *page;
+	unsigned int slot;
+	int index;
+
+	/* Instruction must lie within one page */
+	page = mem_page_get(mem, inst->eip);
+	if (!page || (inst->eip & (MEM_PAGE_SIZE - 1)) + inst->size > MEM_PAGE_SIZE)
+	{
+		*block_ptr = NULL;
+		return;
+	}
+
+	/* Writes to the page from now on give it a new version */
+	page->code = 1;
+
+	/* Append to the block of the cursor if the instruction follows its
+	 * last one. Otherwise, start a new block, replacing the one present in
+	 * the table. */
+	block = *block_ptr;
+	index = *index_ptr + 1;
+	last = block ? &block->inst[index - 1] : NULL;
+	if (!block || block->mem != mem || index != block->count ||
+		index == X86_DECODE_BLOCK_SIZE || block->version != page->version ||
+		last->eip + last->size != inst->eip)
+	{
+		slot = x86_decode_cache_index(mem, inst->eip);
+		if (!cache->block[slot])
+			cache->block[slot] = xmalloc(sizeof(struct x86_decode_block_t));
+		block = cache->block[slot];
+		block->mem = mem;
+		block->version = page->version;
+		block->count = 0;
+		index = 0;
+	}
+
+	/* Add instruction */
+	block->inst[index] = *inst;
+	block->count++;
+	*block_ptr = block;
+	*index_ptr = index;
+}
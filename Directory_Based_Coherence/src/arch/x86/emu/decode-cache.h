@@ -0,0 +1,79 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_X86_EMU_DECODE_CACHE_H
+#define ARCH_X86_EMU_DECODE_CACHE_H
+
+#include <arch/x86/asm/inst.h>
+
+
+/* Number of blocks in the decode cache, and maximum number of instructions
+ * in each block. */
+#define X86_DECODE_CACHE_SIZE  1024
+#define X86_DECODE_BLOCK_SIZE  32
+
+struct mem_t;
+
+
+/* Block of decoded instructions. Instructions are consecutive in memory and
+ * lie within the same page, starting at the address of 'inst[0]'. The block
+ * grows as the instructions following its last one are executed. */
+struct x86_decode_block_t
+{
+	struct mem_t *mem;  /* Address space */
+	unsigned long long version;  /* Version of the page when decoded */
+	int count;  /* Number of instructions in the block */
+	struct x86_inst_t inst[X86_DECODE_BLOCK_SIZE];
+};
+
+
+/* Cache of decoded instructions shared by all contexts. Blocks are tagged with
+ * their address space and indexed by the address of their first instruction.
+ * A context fetching instructions keeps a cursor formed of its last block and
+ * the position of its last instruction in it, which allows sequential code to
+ * be fetched without looking up the table. */
+struct x86_decode_cache_t
+{
+	struct x86_decode_block_t *block[X86_DECODE_CACHE_SIZE];
+
+	/* Statistics */
+	long long hits;
+	long long misses;
+};
+
+
+struct x86_decode_cache_t *x86_decode_cache_create(void);
+void x86_decode_cache_free(struct x86_decode_cache_t *cache);
+
+/* Return the decoded instruction at address 'eip' of memory 'mem', or NULL if
+ * it is not in the cache. Arguments 'block_ptr' and 'index_ptr' contain the
+ * cursor of the fetching context, updated on a hit. */
+struct x86_inst_t *x86_decode_cache_lookup(struct x86_decode_cache_t *cache,
+	struct mem_t *mem, unsigned int eip,
+	struct x86_decode_block_t **block_ptr, int *index_ptr);
+
+/* Add instruction 'inst', just decoded from memory 'mem' after a miss in
+ * 'x86_decode_cache_lookup'. The cursor is updated to point to the new entry.
+ * Instructions crossing a page boundary are not cached. */
+void x86_decode_cache_insert(struct x86_decode_cache_t *cache,
+	struct mem_t *mem, struct x86_inst_t *inst,
+	struct x86_decode_block_t **block_ptr, int *index_ptr);
+
+
+#endif
@@ -28,6 +28,7 @@
 
 /* Forward declarations */
 struct config_t;
+struct x86_decode_cache_t;
 
 
 
@@ -57,6 +58,9 @@ CLASS_BEGIN(X86Emu, Emu)
 	 * executed to change the context's affinity. */
 	int schedule_signal;
 
+	/* Cache of decoded instructions */
+	struct x86_decode_cache_t *decode_cache;
+
 	/* List of contexts */
 	X86Context *context_list_head;
 	X86Context *context_list_tail;
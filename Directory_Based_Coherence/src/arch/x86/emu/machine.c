@@ -1673,7 +1673,7 @@ void x86_isa_prefetcht0_m8_impl(X86Context *ctx)
 	unsigned int eff_addr;
 
 	/* prefetching makes sense only in a detailed simulation */
-	if (arch_x86->sim_kind != arch_sim_kind_detailed)
+	if (arch_x86->sim_kind == arch_sim_kind_functional)
 		return;
 
 	if (!x86_emu_process_prefetch_hints)
@@ -82,6 +82,7 @@ void X86CpuDestroy(X86Cpu *self);
 
 void X86CpuDump(Object *self, FILE *f);
 void X86CpuDumpSummary(Timing *self, FILE *f);
+void X86CpuResetStats(Timing *self);
 void X86CpuDumpReport(X86Cpu *self, FILE *f);
 void X86CpuDumpUopReport(X86Cpu *self, FILE *f, long long *uop_stats,
 		char *prefix, int peak_ipc);
@@ -89,6 +90,7 @@ void X86CpuDumpUopReport(X86Cpu *self, FILE *f, long long *uop_stats,
 int X86CpuRun(Timing *self);
 void X86CpuRunStages(X86Cpu *self);
 void X86CpuFastForward(X86Cpu *self);
+void X86CpuFastForwardROI(X86Cpu *self);
 
 void X86CpuAddToTraceList(X86Cpu *self, struct x86_uop_t *uop);
 void X86CpuEmptyTraceList(X86Cpu *self);
@@ -166,6 +168,9 @@ extern enum x86_cpu_commit_kind_t
 } x86_cpu_commit_kind;
 extern int x86_cpu_commit_width;
 
+/* Interval core model */
+extern int x86_cpu_interval_mispred_penalty;
+
 
 /* Trace */
 #define x86_tracing() trace_status(x86_trace_category)
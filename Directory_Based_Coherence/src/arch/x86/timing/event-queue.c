@@ -18,7 +18,11 @@
  */
 
 
+#include <assert.h>
+
+#include <lib/mhandle/mhandle.h>
 #include <lib/util/linked-list.h>
+#include <lib/util/list.h>
 
 #include "core.h"
 #include "cpu.h"
@@ -32,66 +36,326 @@
  * Class 'X86Core'
  */
 
+/* Return non-zero if non-memory uop 'uop1' is written back before 'uop2' */
+static int X86CoreEventQueueBefore(struct x86_uop_t *uop1, struct x86_uop_t *uop2)
+{
+	return uop1->when != uop2->when ? uop1->when < uop2->when
+		: uop1->id < uop2->id;
+}
+
+
+/* Add a memory uop at the tail of the queue, chained to the last uop in the
+ * wheel, or to the head of the queue if the wheel is empty. */
+static void X86CoreChainToEventQueue(X86Core *self, struct x86_uop_t *uop)
+{
+	struct x86_event_queue_t *event_queue = self->event_queue;
+	struct x86_uop_t *last = event_queue->last;
+
+	assert(!uop->event_queue_next);
+	if (!last)
+	{
+		if (event_queue->chain_tail)
+			event_queue->chain_tail->event_queue_next = uop;
+		else
+			event_queue->chain_head = uop;
+		event_queue->chain_tail = uop;
+	}
+	else
+	{
+		if (last->event_queue_chain_tail)
+			last->event_queue_chain_tail->event_queue_next = uop;
+		else
+			last->event_queue_chain_head = uop;
+		last->event_queue_chain_tail = uop;
+	}
+}
+
+
+/* Add a non-memory uop to its bucket of the timing wheel, sorted by ID. The
+ * wheel must be large enough to hold its completion cycle. */
+static void X86CoreAddToEventQueueWheel(X86Core *self, struct x86_uop_t *uop)
+{
+	struct x86_event_queue_t *event_queue = self->event_queue;
+	struct x86_uop_t *prev;
+	struct x86_uop_t *item;
+
+	int bucket;
+
+	assert(!uop->event_queue_next);
+	assert(!uop->event_queue_chain_head);
+	bucket = uop->when & (event_queue->wheel_size - 1);
+
+	/* Uops are issued in increasing ID order, so the uop usually goes at
+	 * the tail of its bucket. */
+	prev = event_queue->wheel_tail[bucket];
+	if (prev && prev->id > uop->id)
+	{
+		prev = NULL;
+		item = event_queue->wheel_head[bucket];
+		while (item->id < uop->id)
+		{
+			prev = item;
+			item = item->event_queue_next;
+		}
+		uop->event_queue_next = item;
+	}
+	else
+	{
+		event_queue->wheel_tail[bucket] = uop;
+	}
+	if (prev)
+		prev->event_queue_next = uop;
+	else
+		event_queue->wheel_head[bucket] = uop;
+	event_queue->wheel_count++;
+
+	/* Update last uop */
+	if (!event_queue->last || X86CoreEventQueueBefore(event_queue->last, uop))
+		event_queue->last = uop;
+}
+
+
+/* Move memory uops completed by the memory system to the tail of the queue */
+static void X86CoreFlushEventQueue(X86Core *self)
+{
+	struct linked_list_t *mem_list = self->event_queue->mem_list;
+	struct x86_uop_t *uop;
+
+	while (linked_list_count(mem_list))
+	{
+		linked_list_head(mem_list);
+		uop = linked_list_get(mem_list);
+		assert(x86_uop_exists(uop));
+		assert(uop->in_event_queue);
+		linked_list_remove(mem_list);
+		X86CoreChainToEventQueue(self, uop);
+	}
+}
+
+
+/* Move all uops in the queue to its list 'uop_list', in the order in which
+ * they are written back, leaving the queue empty. The uops keep their
+ * 'in_event_queue' flag set. */
+static struct list_t *X86CoreEmptyEventQueue(X86Core *self)
+{
+	X86Cpu *cpu = self->cpu;
+
+	struct x86_event_queue_t *event_queue = self->event_queue;
+	struct list_t *uop_list = event_queue->uop_list;
+	struct x86_uop_t *uop;
+	struct x86_uop_t *mem_uop;
+	struct x86_uop_t *next;
+
+	long long cycle;
+	int bucket;
+	int i;
+
+	/* Memory uops ahead of the wheel */
+	X86CoreFlushEventQueue(self);
+	list_clear(uop_list);
+	for (mem_uop = event_queue->chain_head; mem_uop; mem_uop = next)
+	{
+		next = mem_uop->event_queue_next;
+		mem_uop->event_queue_next = NULL;
+		list_add(uop_list, mem_uop);
+	}
+	event_queue->chain_head = NULL;
+	event_queue->chain_tail = NULL;
+
+	/* Uops in the wheel complete between the current cycle and the
+	 * current cycle plus the wheel size. Each of them is followed by the
+	 * memory uops chained to it. */
+	cycle = asTiming(cpu)->cycle;
+	for (i = 0; i < event_queue->wheel_size; i++)
+	{
+		bucket = (cycle + i) & (event_queue->wheel_size - 1);
+		while ((uop = event_queue->wheel_head[bucket]))
+		{
+			assert(uop->when == cycle + i);
+			event_queue->wheel_head[bucket] = uop->event_queue_next;
+			uop->event_queue_next = NULL;
+			list_add(uop_list, uop);
+
+			for (mem_uop = uop->event_queue_chain_head; mem_uop; mem_uop = next)
+			{
+				next = mem_uop->event_queue_next;
+				mem_uop->event_queue_next = NULL;
+				list_add(uop_list, mem_uop);
+			}
+			uop->event_queue_chain_head = NULL;
+			uop->event_queue_chain_tail = NULL;
+		}
+		event_queue->wheel_tail[bucket] = NULL;
+	}
+	event_queue->wheel_count = 0;
+	event_queue->last = NULL;
+	return uop_list;
+}
+
+
+/* Add the uops in list 'uop_list' back to the empty queue. The list must
+ * be in writeback order. */
+static void X86CoreRefillEventQueue(X86Core *self, struct list_t *uop_list)
+{
+	struct x86_uop_t *uop;
+	int i;
+
+	LIST_FOR_EACH(uop_list, i)
+	{
+		uop = list_get(uop_list, i);
+		if (uop->flags & X86_UINST_MEM)
+			X86CoreChainToEventQueue(self, uop);
+		else
+			X86CoreAddToEventQueueWheel(self, uop);
+	}
+	list_clear(uop_list);
+}
+
+
 void X86CoreInitEventQueue(X86Core *self)
 {
-	self->event_queue = linked_list_create();
+	struct x86_event_queue_t *event_queue;
+
+	event_queue = xcalloc(1, sizeof(struct x86_event_queue_t));
+	event_queue->mem_list = linked_list_create();
+	event_queue->wheel_size = X86_EVENT_QUEUE_WHEEL_SIZE;
+	event_queue->wheel_head = xcalloc(event_queue->wheel_size, sizeof(void *));
+	event_queue->wheel_tail = xcalloc(event_queue->wheel_size, sizeof(void *));
+	event_queue->uop_list = list_create();
+	self->event_queue = event_queue;
 }
 
 
 void X86CoreFreeEventQueue(X86Core *self)
 {
+	struct x86_event_queue_t *event_queue = self->event_queue;
+	struct list_t *uop_list;
 	struct x86_uop_t *uop;
 
-	while (linked_list_count(self->event_queue))
+	int i;
+
+	uop_list = X86CoreEmptyEventQueue(self);
+	LIST_FOR_EACH(uop_list, i)
 	{
-		uop = X86CoreExtractFromEventQueue(self);
+		uop = list_get(uop_list, i);
+		uop->in_event_queue = 0;
 		x86_uop_free_if_not_queued(uop);
 	}
-	linked_list_free(self->event_queue);
+
+	linked_list_free(event_queue->mem_list);
+	list_free(event_queue->uop_list);
+	free(event_queue->wheel_head);
+	free(event_queue->wheel_tail);
+	free(event_queue);
 }
 
 
-static int eventq_compare(const void *item1, const void *item2)
+void X86CoreDumpEventQueue(X86Core *self, FILE *f)
 {
-	const struct x86_uop_t *uop1 = item1;
-	const struct x86_uop_t *uop2 = item2;
-	return uop1->when != uop2->when ? uop1->when - uop2->when
-		: uop1->id - uop2->id;
+	struct list_t *uop_list;
+	struct x86_uop_t *uop;
+
+	int i;
+
+	uop_list = X86CoreEmptyEventQueue(self);
+	LIST_FOR_EACH(uop_list, i)
+	{
+		uop = list_get(uop_list, i);
+		fprintf(f, "%3d. ", i);
+		x86_uinst_dump(uop->uinst, f);
+		fprintf(f, "\n");
+	}
+	X86CoreRefillEventQueue(self, uop_list);
 }
 
 
 void X86CoreInsertInEventQueue(X86Core *self, struct x86_uop_t *uop)
 {
-	struct linked_list_t *event_queue = self->event_queue;
-	struct x86_uop_t *item;
+	X86Cpu *cpu = self->cpu;
+
+	struct x86_event_queue_t *event_queue = self->event_queue;
+	struct list_t *uop_list;
 
 	assert(!uop->in_event_queue);
-	linked_list_head(event_queue);
-	for (;;)
+	assert(!(uop->flags & X86_UINST_MEM));
+	assert(uop->when > asTiming(cpu)->cycle);
+	X86CoreFlushEventQueue(self);
+
+	/* Grow the wheel if the uop completes beyond its last bucket */
+	if (uop->when - asTiming(cpu)->cycle >= event_queue->wheel_size)
 	{
-		item = linked_list_get(event_queue);
-		if (!item || eventq_compare(uop, item) < 0)
-			break;
-		linked_list_next(event_queue);
+		uop_list = X86CoreEmptyEventQueue(self);
+		while (uop->when - asTiming(cpu)->cycle >= event_queue->wheel_size)
+			event_queue->wheel_size *= 2;
+		event_queue->wheel_head = xrealloc(event_queue->wheel_head,
+			event_queue->wheel_size * sizeof(void *));
+		event_queue->wheel_tail = xrealloc(event_queue->wheel_tail,
+			event_queue->wheel_size * sizeof(void *));
+		memset(event_queue->wheel_head, 0, event_queue->wheel_size * sizeof(void *));
+		memset(event_queue->wheel_tail, 0, event_queue->wheel_size * sizeof(void *));
+		X86CoreRefillEventQueue(self, uop_list);
 	}
-	linked_list_insert(event_queue, uop);
+
+	X86CoreAddToEventQueueWheel(self, uop);
+	uop->in_event_queue = 1;
+}
+
+
+/* Insert a memory uop that completes without accessing the memory system. It
+ * is placed in the queue as if the memory system had just completed it. */
+void X86CoreCompleteInEventQueue(X86Core *self, struct x86_uop_t *uop)
+{
+	assert(!uop->in_event_queue);
+	assert(uop->flags & X86_UINST_MEM);
 	uop->in_event_queue = 1;
+	linked_list_add(self->event_queue->mem_list, uop);
 }
 
 
 struct x86_uop_t *X86CoreExtractFromEventQueue(X86Core *self)
 {
-	struct linked_list_t *event_queue = self->event_queue;
+	X86Cpu *cpu = self->cpu;
+
+	struct x86_event_queue_t *event_queue = self->event_queue;
 	struct x86_uop_t *uop;
 
-	if (!linked_list_count(event_queue))
+	int bucket;
+
+	/* Memory uops at the head of the queue are always complete */
+	X86CoreFlushEventQueue(self);
+	uop = event_queue->chain_head;
+	if (uop)
+	{
+		event_queue->chain_head = uop->event_queue_next;
+		if (!event_queue->chain_head)
+			event_queue->chain_tail = NULL;
+		uop->event_queue_next = NULL;
+		uop->in_event_queue = 0;
+		return uop;
+	}
+
+	/* Otherwise, the head of the queue is the first uop completing in the
+	 * current cycle, if any. */
+	bucket = asTiming(cpu)->cycle & (event_queue->wheel_size - 1);
+	uop = event_queue->wheel_head[bucket];
+	if (!uop)
+		return NULL;
+	assert(uop->when >= asTiming(cpu)->cycle);
+	if (uop->when != asTiming(cpu)->cycle)
 		return NULL;
 
-	linked_list_head(event_queue);
-	uop = linked_list_get(event_queue);
-	assert(x86_uop_exists(uop));
-	assert(uop->in_event_queue);
-	linked_list_remove(event_queue);
+	/* Extract it. Its chained memory uops become the head of the queue. */
+	event_queue->wheel_head[bucket] = uop->event_queue_next;
+	if (!event_queue->wheel_head[bucket])
+		event_queue->wheel_tail[bucket] = NULL;
+	event_queue->wheel_count--;
+	if (event_queue->last == uop)
+		event_queue->last = NULL;
+	event_queue->chain_head = uop->event_queue_chain_head;
+	event_queue->chain_tail = uop->event_queue_chain_tail;
+	uop->event_queue_next = NULL;
+	uop->event_queue_chain_head = NULL;
+	uop->event_queue_chain_tail = NULL;
 	uop->in_event_queue = 0;
 	return uop;
 }
@@ -108,18 +372,26 @@ int X86ThreadLongLatencyInEventQueue(X86Thread *self)
 	X86Cpu *cpu = self->cpu;
 	X86Core *core = self->core;
 
-	struct linked_list_t *event_queue = core->event_queue;
+	struct list_t *uop_list;
 	struct x86_uop_t *uop;
-	
-	LINKED_LIST_FOR_EACH(event_queue)
+
+	int long_latency = 0;
+	int i;
+
+	uop_list = X86CoreEmptyEventQueue(core);
+	LIST_FOR_EACH(uop_list, i)
 	{
-		uop = linked_list_get(event_queue);
+		uop = list_get(uop_list, i);
 		if (uop->thread != self)
 			continue;
 		if (asTiming(cpu)->cycle - uop->issue_when > 20)
-			return 1;
+		{
+			long_latency = 1;
+			break;
+		}
 	}
-	return 0;
+	X86CoreRefillEventQueue(core, uop_list);
+	return long_latency;
 }
 
 
@@ -128,18 +400,26 @@ int X86ThreadCacheMissInEventQueue(X86Thread *self)
 	X86Cpu *cpu = self->cpu;
 	X86Core *core = self->core;
 
-	struct linked_list_t *event_queue = core->event_queue;
+	struct list_t *uop_list;
 	struct x86_uop_t *uop;
 
-	LINKED_LIST_FOR_EACH(event_queue)
+	int cache_miss = 0;
+	int i;
+
+	uop_list = X86CoreEmptyEventQueue(core);
+	LIST_FOR_EACH(uop_list, i)
 	{
-		uop = linked_list_get(event_queue);
+		uop = list_get(uop_list, i);
 		if (uop->thread != self || uop->uinst->opcode != x86_uinst_load)
 			continue;
 		if (asTiming(cpu)->cycle - uop->issue_when > 5)
-			return 1;
+		{
+			cache_miss = 1;
+			break;
+		}
 	}
-	return 0;
+	X86CoreRefillEventQueue(core, uop_list);
+	return cache_miss;
 }
 
 
@@ -147,21 +427,32 @@ void X86ThreadRecoverEventQueue(X86Thread *self)
 {
 	X86Core *core = self->core;
 
-	struct linked_list_t *event_queue = core->event_queue;
+	struct list_t *uop_list;
 	struct x86_uop_t *uop;
 
-	linked_list_head(event_queue);
-	while (!linked_list_is_end(event_queue))
+	int i;
+
+	/* Rebuild the queue without the speculative uops of the thread */
+	uop_list = X86CoreEmptyEventQueue(core);
+	LIST_FOR_EACH(uop_list, i)
 	{
-		uop = linked_list_get(event_queue);
+		uop = list_get(uop_list, i);
 		if (uop->thread == self && uop->specmode)
-		{
-			linked_list_remove(event_queue);
-			uop->in_event_queue = 0;
-			x86_uop_free_if_not_queued(uop);
 			continue;
-		}
-		linked_list_next(event_queue);
+		if (uop->flags & X86_UINST_MEM)
+			X86CoreChainToEventQueue(core, uop);
+		else
+			X86CoreAddToEventQueueWheel(core, uop);
 	}
-}
 
+	/* Free them */
+	LIST_FOR_EACH(uop_list, i)
+	{
+		uop = list_get(uop_list, i);
+		if (uop->thread != self || !uop->specmode)
+			continue;
+		uop->in_event_queue = 0;
+		x86_uop_free_if_not_queued(uop);
+	}
+	list_clear(uop_list);
+}
@@ -18,7 +18,7 @@
  */
 
 
-#include <lib/util/linked-list.h>
+#include <lib/util/misc.h>
 
 #include "core.h"
 #include "cpu.h"
@@ -31,27 +31,31 @@ enum x86_iq_kind_t x86_iq_kind;
 int x86_iq_size;
 
 
-void X86ThreadInitIQ(X86Thread *self)
+void X86ThreadFreeIQ(X86Thread *self)
 {
-	self->iq = linked_list_create();
+	struct x86_uop_t *uop;
+
+	while (self->iq_list_head)
+	{
+		uop = self->iq_list_head;
+		DOUBLE_LINKED_LIST_REMOVE(self, iq, uop);
+		uop->in_iq = 0;
+		x86_uop_free_if_not_queued(uop);
+	}
 }
 
 
-void X86ThreadFreeIQ(X86Thread *self)
+void X86ThreadDumpIQ(X86Thread *self, FILE *f)
 {
-	struct linked_list_t *iq;
 	struct x86_uop_t *uop;
+	int i = 0;
 
-	iq = self->iq;
-	linked_list_head(iq);
-	while (linked_list_count(iq))
+	DOUBLE_LINKED_LIST_FOR_EACH(self, iq, uop)
 	{
-		uop = linked_list_get(iq);
-		uop->in_iq = 0;
-		linked_list_remove(iq);
-		x86_uop_free_if_not_queued(uop);
+		fprintf(f, "%3d. ", i++);
+		x86_uinst_dump(uop->uinst, f);
+		fprintf(f, "\n");
 	}
-	linked_list_free(iq);
 }
 
 
@@ -73,30 +77,32 @@ int X86ThreadCanInsertInIQ(X86Thread *self, struct x86_uop_t *uop)
 void X86ThreadInsertInIQ(X86Thread *self, struct x86_uop_t *uop)
 {
 	X86Core *core = self->core;
-	struct linked_list_t *iq = self->iq;
 
 	assert(!uop->in_iq);
-	linked_list_out(iq);
-	linked_list_insert(iq, uop);
+	DOUBLE_LINKED_LIST_INSERT_TAIL(self, iq, uop);
 	uop->in_iq = 1;
+	if (uop->ready)
+		self->iq_ready_count++;
 
 	core->iq_count++;
 	self->iq_count++;
 }
 
 
-/* Remove the uop in the current position of the linked list representing
- * the IQ of the specified thread. */
-void X86ThreadRemoveFromIQ(X86Thread *self)
+/* Remove a uop from the IQ of the specified thread */
+void X86ThreadRemoveFromIQ(X86Thread *self, struct x86_uop_t *uop)
 {
 	X86Core *core = self->core;
-	struct linked_list_t *iq = self->iq;
-	struct x86_uop_t *uop;
 
-	uop = linked_list_get(iq);
 	assert(x86_uop_exists(uop));
-	linked_list_remove(iq);
+	assert(uop->in_iq);
+	DOUBLE_LINKED_LIST_REMOVE(self, iq, uop);
 	uop->in_iq = 0;
+	if (uop->ready)
+	{
+		assert(self->iq_ready_count);
+		self->iq_ready_count--;
+	}
 
 	assert(core->iq_count && self->iq_count);
 	core->iq_count--;
@@ -107,19 +113,16 @@ void X86ThreadRemoveFromIQ(X86Thread *self)
 /* Remove all speculative uops from the current thread */
 void X86ThreadRecoverIQ(X86Thread *self)
 {
-	struct linked_list_t *iq = self->iq;
 	struct x86_uop_t *uop;
+	struct x86_uop_t *next;
 
-	linked_list_head(iq);
-	while (!linked_list_is_end(iq))
+	for (uop = self->iq_list_head; uop; uop = next)
 	{
-		uop = linked_list_get(iq);
-		if (uop->specmode) {
-			X86ThreadRemoveFromIQ(self);
+		next = uop->iq_list_next;
+		if (uop->specmode)
+		{
+			X86ThreadRemoveFromIQ(self, uop);
 			x86_uop_free_if_not_queued(uop);
-			continue;
 		}
-		linked_list_next(iq);
 	}
 }
-
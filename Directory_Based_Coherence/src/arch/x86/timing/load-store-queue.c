@@ -18,7 +18,8 @@
  */
 
 
-#include <lib/util/linked-list.h>
+#include <lib/mhandle/mhandle.h>
+#include <lib/util/misc.h>
 
 #include "core.h"
 #include "cpu.h"
@@ -31,6 +32,13 @@ char *x86_lsq_kind_map[] = { "Shared", "Private" };
 enum x86_lsq_kind_t x86_lsq_kind;
 int x86_lsq_size;
 
+int x86_lsq_forwarding;
+char *x86_lsq_spec_kind_map[] = { "Perfect", "Blind", "StoreSets" };
+enum x86_lsq_spec_kind_t x86_lsq_spec_kind;
+int x86_lsq_store_set_size;
+int x86_lsq_store_set_clear;
+int x86_lsq_replay_penalty;
+
 
 
 /*
@@ -39,54 +47,80 @@ int x86_lsq_size;
 
 void X86ThreadInitLSQ(X86Thread *self)
 {
-	self->lq = linked_list_create();
-	self->sq = linked_list_create();
-	self->preq = linked_list_create();
+	int i;
+
+	/* Store set table */
+	if (x86_lsq_spec_kind == x86_lsq_spec_kind_store_sets)
+	{
+		self->store_set_table = xcalloc(x86_lsq_store_set_size, sizeof(int));
+		for (i = 0; i < x86_lsq_store_set_size; i++)
+			self->store_set_table[i] = -1;
+		self->store_set_clear_when = x86_lsq_store_set_clear;
+	}
 }
 
 
 void X86ThreadFreeLSQ(X86Thread *self)
 {
-	struct linked_list_t *lq;
-	struct linked_list_t *sq;
-	struct linked_list_t *preq;
 	struct x86_uop_t *uop;
 
 	/* Load queue */
-	lq = self->lq;
-	linked_list_head(lq);
-	while (linked_list_count(lq))
+	while (self->lq_list_head)
 	{
-		uop = linked_list_get(lq);
+		uop = self->lq_list_head;
+		DOUBLE_LINKED_LIST_REMOVE(self, lq, uop);
 		uop->in_lq = 0;
-		linked_list_remove(lq);
 		x86_uop_free_if_not_queued(uop);
 	}
-	linked_list_free(lq);
 
 	/* Store queue */
-	sq = self->sq;
-	linked_list_head(sq);
-	while (linked_list_count(sq))
+	while (self->sq_list_head)
 	{
-		uop = linked_list_get(sq);
+		uop = self->sq_list_head;
+		DOUBLE_LINKED_LIST_REMOVE(self, sq, uop);
 		uop->in_sq = 0;
-		linked_list_remove(sq);
 		x86_uop_free_if_not_queued(uop);
 	}
-	linked_list_free(sq);
 
 	/* Prefetch queue */
-	preq = self->preq;
-	linked_list_head(preq);
-	while (linked_list_count(preq))
+	while (self->preq_list_head)
 	{
-		uop = linked_list_get(preq);
+		uop = self->preq_list_head;
+		DOUBLE_LINKED_LIST_REMOVE(self, preq, uop);
 		uop->in_preq = 0;
-		linked_list_remove(preq);
 		x86_uop_free_if_not_queued(uop);
 	}
-	linked_list_free(preq);
+
+	/* Store set table */
+	free(self->store_set_table);
+}
+
+
+void X86ThreadDumpLQ(X86Thread *self, FILE *f)
+{
+	struct x86_uop_t *uop;
+	int i = 0;
+
+	DOUBLE_LINKED_LIST_FOR_EACH(self, lq, uop)
+	{
+		fprintf(f, "%3d. ", i++);
+		x86_uinst_dump(uop->uinst, f);
+		fprintf(f, "\n");
+	}
+}
+
+
+void X86ThreadDumpSQ(X86Thread *self, FILE *f)
+{
+	struct x86_uop_t *uop;
+	int i = 0;
+
+	DOUBLE_LINKED_LIST_FOR_EACH(self, sq, uop)
+	{
+		fprintf(f, "%3d. ", i++);
+		x86_uinst_dump(uop->uinst, f);
+		fprintf(f, "\n");
+	}
 }
 
 
@@ -108,32 +142,46 @@ int X86ThreadCanInsertInLSQ(X86Thread *self, struct x86_uop_t *uop)
 void X86ThreadInsertInLSQ(X86Thread *self, struct x86_uop_t *uop)
 {
 	X86Core *core = self->core;
+	X86Cpu *cpu = self->cpu;
 
-	struct linked_list_t *lq = self->lq;
-	struct linked_list_t *sq = self->sq;
-	struct linked_list_t *preq = self->preq;
+	int i;
 
 	assert(!uop->in_lq && !uop->in_sq);
 	assert(uop->uinst->opcode == x86_uinst_load || uop->uinst->opcode == x86_uinst_store ||
 		uop->uinst->opcode == x86_uinst_prefetch);
 
+	/* Read store set. The table is periodically invalidated to get rid of
+	 * stale dependences. */
+	uop->store_set = -1;
+	if (x86_lsq_spec_kind == x86_lsq_spec_kind_store_sets)
+	{
+		if (x86_lsq_store_set_clear && asTiming(cpu)->cycle >= self->store_set_clear_when)
+		{
+			for (i = 0; i < x86_lsq_store_set_size; i++)
+				self->store_set_table[i] = -1;
+			self->store_set_clear_when = asTiming(cpu)->cycle + x86_lsq_store_set_clear;
+		}
+		uop->store_set = self->store_set_table[uop->eip & (x86_lsq_store_set_size - 1)];
+	}
+
 	if (uop->uinst->opcode == x86_uinst_load)
 	{
-		linked_list_out(lq);
-		linked_list_insert(lq, uop);
+		DOUBLE_LINKED_LIST_INSERT_TAIL(self, lq, uop);
 		uop->in_lq = 1;
+		if (uop->ready)
+			self->lq_ready_count++;
 	}
 	else if (uop->uinst->opcode == x86_uinst_store)
 	{
-		linked_list_out(sq);
-		linked_list_insert(sq, uop);
+		DOUBLE_LINKED_LIST_INSERT_TAIL(self, sq, uop);
 		uop->in_sq = 1;
 	}
 	else
 	{
-		linked_list_out(preq);
-		linked_list_insert(preq, uop);
+		DOUBLE_LINKED_LIST_INSERT_TAIL(self, preq, uop);
 		uop->in_preq = 1;
+		if (uop->ready)
+			self->preq_ready_count++;
 	}
 	core->lsq_count++;
 	self->lsq_count++;
@@ -144,53 +192,47 @@ void X86ThreadInsertInLSQ(X86Thread *self, struct x86_uop_t *uop)
  * given thread. */
 void X86ThreadRecoverLSQ(X86Thread *self)
 {
-	struct linked_list_t *lq = self->lq;
-	struct linked_list_t *sq = self->sq;
 	struct x86_uop_t *uop;
+	struct x86_uop_t *next;
 
 	/* Recover load queue */
-	linked_list_head(lq);
-	while (!linked_list_is_end(lq))
+	for (uop = self->lq_list_head; uop; uop = next)
 	{
-		uop = linked_list_get(lq);
+		next = uop->lq_list_next;
 		if (uop->specmode)
 		{
-			X86ThreadRemoveFromLQ(self);
+			X86ThreadRemoveFromLQ(self, uop);
 			x86_uop_free_if_not_queued(uop);
-			continue;
 		}
-		linked_list_next(lq);
 	}
 
 	/* Recover store queue */
-	linked_list_head(sq);
-	while (!linked_list_is_end(sq))
+	for (uop = self->sq_list_head; uop; uop = next)
 	{
-		uop = linked_list_get(sq);
+		next = uop->sq_list_next;
 		if (uop->specmode)
 		{
-			X86ThreadRemoveFromSQ(self);
+			X86ThreadRemoveFromSQ(self, uop);
 			x86_uop_free_if_not_queued(uop);
-			continue;
 		}
-		linked_list_next(sq);
 	}
 }
 
 
-/* Remove the uop in the current position of the linked list representing
- * the load queue of the specified thread. */
-void X86ThreadRemoveFromLQ(X86Thread *self)
+/* Remove a uop from the load queue of the specified thread */
+void X86ThreadRemoveFromLQ(X86Thread *self, struct x86_uop_t *uop)
 {
 	X86Core *core = self->core;
 
-	struct linked_list_t *lq = self->lq;
-	struct x86_uop_t *uop;
-
-	uop = linked_list_get(lq);
 	assert(x86_uop_exists(uop));
-	linked_list_remove(lq);
+	assert(uop->in_lq);
+	DOUBLE_LINKED_LIST_REMOVE(self, lq, uop);
 	uop->in_lq = 0;
+	if (uop->ready)
+	{
+		assert(self->lq_ready_count);
+		self->lq_ready_count--;
+	}
 
 	assert(core->lsq_count && self->lsq_count);
 	core->lsq_count--;
@@ -198,18 +240,14 @@ void X86ThreadRemoveFromLQ(X86Thread *self)
 }
 
 
-/* Remove an uop in the current position of the store queue */
-void X86ThreadRemoveFromSQ(X86Thread *self)
+/* Remove a uop from the store queue */
+void X86ThreadRemoveFromSQ(X86Thread *self, struct x86_uop_t *uop)
 {
 	X86Core *core = self->core;
 
-	struct linked_list_t *sq = self->sq;
-	struct x86_uop_t *uop;
-
-	uop = linked_list_get(sq);
 	assert(x86_uop_exists(uop));
 	assert(uop->in_sq);
-	linked_list_remove(sq);
+	DOUBLE_LINKED_LIST_REMOVE(self, sq, uop);
 	uop->in_sq = 0;
 
 	assert(core->lsq_count && self->lsq_count);
@@ -217,22 +255,148 @@ void X86ThreadRemoveFromSQ(X86Thread *self)
 	self->lsq_count--;
 }
 
-/* Remove an uop in the current position of the prefetch queue */
-void X86ThreadRemovePreQ(X86Thread *self)
+/* Remove a uop from the prefetch queue */
+void X86ThreadRemovePreQ(X86Thread *self, struct x86_uop_t *uop)
 {
 	X86Core *core = self->core;
-
-	struct linked_list_t *preq = self->preq;
-	struct x86_uop_t *uop;
  
-	uop = linked_list_get(preq);
 	assert(x86_uop_exists(uop));
 	assert(uop->in_preq);
-	linked_list_remove(preq);
+	DOUBLE_LINKED_LIST_REMOVE(self, preq, uop);
 	uop->in_preq = 0;
+	if (uop->ready)
+	{
+		assert(self->preq_ready_count);
+		self->preq_ready_count--;
+	}
  
 	assert(core->lsq_count && self->lsq_count);
 	core->lsq_count--;
 	self->lsq_count--;
 }
 
+
+/* Place a load and the store it conflicted with in the same store set. A new
+ * set is identified by the table index of the load, and two existing sets are
+ * merged into the one with the lowest ID. */
+static void X86ThreadUpdateStoreSets(X86Thread *self, struct x86_uop_t *load,
+	struct x86_uop_t *store)
+{
+	X86Core *core = self->core;
+
+	int load_index;
+	int store_index;
+	int load_set;
+	int store_set;
+	int set;
+
+	load_index = load->eip & (x86_lsq_store_set_size - 1);
+	store_index = store->eip & (x86_lsq_store_set_size - 1);
+	load_set = self->store_set_table[load_index];
+	store_set = self->store_set_table[store_index];
+
+	if (load_set < 0 && store_set < 0)
+		set = load_index;
+	else if (load_set < 0)
+		set = store_set;
+	else if (store_set < 0)
+		set = load_set;
+	else
+		set = MIN(load_set, store_set);
+
+	self->store_set_table[load_index] = set;
+	self->store_set_table[store_index] = set;
+	core->stats.lsq_store_set_updates++;
+}
+
+
+/* Decide whether a ready load can access the data cache, take its data from
+ * an older store in the store queue, or must wait. The addresses of all stores
+ * are known from functional simulation, so a load issued while an older store
+ * to the same bytes is still unresolved is detected as a violation right away.
+ * The load is then held until the store resolves, and replayed. */
+enum x86_lsq_load_action_t X86ThreadGetLoadAction(X86Thread *self,
+	struct x86_uop_t *load)
+{
+	X86Core *core = self->core;
+
+	struct x86_uop_t *store;
+	struct x86_uop_t *conflict;
+
+	unsigned int load_addr;
+	unsigned int store_addr;
+	int predicted;
+
+	/* Loads ignore older stores by default */
+	if (!x86_lsq_forwarding && x86_lsq_spec_kind == x86_lsq_spec_kind_perfect)
+		return x86_lsq_load_access;
+
+	/* Find the youngest older store writing any of the bytes read by the
+	 * load, and check whether any older store in the store set of the load
+	 * is unresolved. */
+	load_addr = load->phy_addr;
+	conflict = NULL;
+	predicted = 0;
+	for (store = self->sq_list_tail; store; store = store->sq_list_prev)
+	{
+		if (store->id > load->id)
+			continue;
+
+		store_addr = store->phy_addr;
+		if (!conflict && store_addr < load_addr + load->uinst->size &&
+				load_addr < store_addr + store->uinst->size)
+			conflict = store;
+
+		if (load->store_set >= 0 && store->store_set == load->store_set &&
+				!store->ready)
+			predicted = 1;
+	}
+
+	/* Store set predictor holds the load until the older stores in its set
+	 * resolve. */
+	if (predicted)
+	{
+		if (!load->lsq_predicted_wait)
+			core->stats.lsq_predicted_waits++;
+		load->lsq_predicted_wait = 1;
+		return x86_lsq_load_wait;
+	}
+
+	/* No dependence */
+	if (!conflict)
+		return x86_lsq_load_access;
+
+	/* Unresolved store. A perfect predictor waits for it, while a
+	 * speculative load violates the dependence. */
+	if (!conflict->ready)
+	{
+		if (x86_lsq_spec_kind == x86_lsq_spec_kind_perfect)
+		{
+			if (!load->lsq_predicted_wait)
+				core->stats.lsq_predicted_waits++;
+			load->lsq_predicted_wait = 1;
+		}
+		else if (!load->lsq_violation)
+		{
+			core->stats.lsq_violations++;
+			load->lsq_violation = 1;
+			if (x86_lsq_spec_kind == x86_lsq_spec_kind_store_sets)
+				X86ThreadUpdateStoreSets(self, load, conflict);
+		}
+		return x86_lsq_load_wait;
+	}
+
+	/* Forward if the store covers all bytes of the load. Otherwise, the load
+	 * waits for the store to write the data cache. */
+	store_addr = conflict->phy_addr;
+	if (x86_lsq_forwarding && store_addr <= load_addr &&
+			load_addr + load->uinst->size <= store_addr + conflict->uinst->size)
+	{
+		core->stats.lsq_forwarded_loads++;
+		return x86_lsq_load_forward;
+	}
+	if (!load->lsq_forward_stall)
+		core->stats.lsq_forward_stalls++;
+	load->lsq_forward_stall = 1;
+	return x86_lsq_load_wait;
+}
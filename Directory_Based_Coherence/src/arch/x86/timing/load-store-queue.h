@@ -20,6 +20,8 @@
 #ifndef X86_ARCH_TIMING_LOAD_STORE_QUEUE_H
 #define X86_ARCH_TIMING_LOAD_STORE_QUEUE_H
 
+#include <stdio.h>
+
 
 /*
  * Public
@@ -33,6 +35,26 @@ extern enum x86_lsq_kind_t
 } x86_lsq_kind;
 extern int x86_lsq_size;
 
+extern int x86_lsq_forwarding;
+extern char *x86_lsq_spec_kind_map[];
+extern enum x86_lsq_spec_kind_t
+{
+	x86_lsq_spec_kind_perfect = 0,
+	x86_lsq_spec_kind_blind,
+	x86_lsq_spec_kind_store_sets
+} x86_lsq_spec_kind;
+extern int x86_lsq_store_set_size;
+extern int x86_lsq_store_set_clear;
+extern int x86_lsq_replay_penalty;
+
+/* Action to take on a ready load, given the older stores in the store queue */
+enum x86_lsq_load_action_t
+{
+	x86_lsq_load_access = 0,  /* Access the data cache */
+	x86_lsq_load_forward,  /* Take the data from an older store */
+	x86_lsq_load_wait  /* Wait for an older store */
+};
+
 
 
 /*
@@ -41,13 +63,18 @@ extern int x86_lsq_size;
 
 void X86ThreadInitLSQ(X86Thread *self);
 void X86ThreadFreeLSQ(X86Thread *self);
+void X86ThreadDumpLQ(X86Thread *self, FILE *f);
+void X86ThreadDumpSQ(X86Thread *self, FILE *f);
 
 int X86ThreadCanInsertInLSQ(X86Thread *self, struct x86_uop_t *uop);
 void X86ThreadInsertInLSQ(X86Thread *self, struct x86_uop_t *uop);
 void X86ThreadRecoverLSQ(X86Thread *self);
 
-void X86ThreadRemoveFromLQ(X86Thread *self);
-void X86ThreadRemoveFromSQ(X86Thread *self);
-void X86ThreadRemovePreQ(X86Thread *self);
+enum x86_lsq_load_action_t X86ThreadGetLoadAction(X86Thread *self,
+	struct x86_uop_t *load);
+
+void X86ThreadRemoveFromLQ(X86Thread *self, struct x86_uop_t *uop);
+void X86ThreadRemoveFromSQ(X86Thread *self, struct x86_uop_t *uop);
+void X86ThreadRemovePreQ(X86Thread *self, struct x86_uop_t *uop);
 
 #endif
@@ -74,8 +74,8 @@ void X86ThreadRecover(X86Thread *self)
 		/* Statistics */
 		if (uop->trace_cache)
 			self->trace_cache->num_squashed_uinst++;
-		self->num_squashed_uinst++;
-		core->num_squashed_uinst++;
+		self->stats.num_squashed_uinst++;
+		core->stats.num_squashed_uinst++;
 		cpu->num_squashed_uinst++;
 		
 		/* Undo map */
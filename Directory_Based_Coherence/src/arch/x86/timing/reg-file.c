@@ -259,12 +259,116 @@ int X86ThreadRequestXMMReg(X86Thread *self)
 }
 
 
+/* Return the physical register read by input dependence 'dep' of a renamed
+ * uop, or NULL if the dependence is not an int/FP/XMM register. */
+static struct x86_phreg_t *X86ThreadGetInputPhreg(X86Thread *self,
+	struct x86_uop_t *uop, int dep)
+{
+	struct x86_reg_file_t *reg_file = self->reg_file;
+
+	int loreg;
+	int phreg;
+
+	loreg = uop->uinst->idep[dep];
+	phreg = uop->ph_idep[dep];
+	if (X86_DEP_IS_INT_REG(loreg))
+		return &reg_file->int_phreg[phreg];
+	if (X86_DEP_IS_FP_REG(loreg))
+		return &reg_file->fp_phreg[phreg];
+	if (X86_DEP_IS_XMM_REG(loreg))
+		return &reg_file->xmm_phreg[phreg];
+	return NULL;
+}
+
+
+/* Set the 'ready' flag of a uop, updating the count of ready uops of the
+ * queue it is in. */
+static void X86ThreadSetUopReady(X86Thread *self, struct x86_uop_t *uop)
+{
+	assert(!uop->ready);
+	assert(X86ThreadIsUopReady(self, uop));
+	uop->ready = 1;
+	if (uop->in_iq)
+		self->iq_ready_count++;
+	else if (uop->in_lq)
+		self->lq_ready_count++;
+	else if (uop->in_preq)
+		self->preq_ready_count++;
+}
+
+
+/* Decrease the wait count of all uops in the wakeup list of a physical
+ * register that was just written, and empty the list. */
+static void X86ThreadWakeupPhreg(X86Thread *self, struct x86_phreg_t *phreg)
+{
+	struct x86_uop_t *uop;
+	struct x86_uop_t *next;
+
+	int dep;
+	int next_dep;
+
+	uop = phreg->wakeup_head;
+	dep = phreg->wakeup_head_dep;
+	while (uop)
+	{
+		next = uop->wakeup_next[dep];
+		next_dep = uop->wakeup_next_dep[dep];
+		assert(uop->wait_count > 0);
+		uop->wait_count--;
+		if (!uop->wait_count)
+			X86ThreadSetUopReady(self, uop);
+		uop = next;
+		dep = next_dep;
+	}
+	phreg->wakeup_head = NULL;
+}
+
+
+/* Remove a squashed uop from the wakeup lists it is linked in. Uops are
+ * squashed from youngest to oldest, so the uop is normally at the head. */
+static void X86ThreadUnlinkUop(X86Thread *self, struct x86_uop_t *uop)
+{
+	struct x86_phreg_t *phreg;
+	struct x86_uop_t **uop_ptr;
+	struct x86_uop_t *next;
+
+	int *dep_ptr;
+	int dep;
+
+	for (dep = 0; dep < X86_UINST_MAX_IDEPS && uop->wait_count; dep++)
+	{
+		/* Dependences on registers already written were unlinked */
+		phreg = X86ThreadGetInputPhreg(self, uop, dep);
+		if (!phreg || !phreg->pending)
+			continue;
+
+		/* Find entry */
+		uop_ptr = &phreg->wakeup_head;
+		dep_ptr = &phreg->wakeup_head_dep;
+		while (*uop_ptr != uop || *dep_ptr != dep)
+		{
+			next = *uop_ptr;
+			assert(next);
+			uop_ptr = &next->wakeup_next[*dep_ptr];
+			dep_ptr = &next->wakeup_next_dep[*dep_ptr];
+		}
+
+		/* Remove it */
+		*uop_ptr = uop->wakeup_next[dep];
+		*dep_ptr = uop->wakeup_next_dep[dep];
+		uop->wait_count--;
+	}
+	assert(!uop->wait_count);
+}
+
+
 void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop)
 {
 	int dep;
 	int loreg, streg, phreg, ophreg;
 	int flag_phreg, flag_count;
 	struct x86_reg_file_t *reg_file = self->reg_file;
+	struct x86_phreg_t *phreg_ptr;
 
 	/* Checks */
 	assert(uop->thread == self);
@@ -289,7 +393,7 @@ void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop)
 		{
 			phreg = reg_file->int_rat[loreg - x86_dep_int_first];
 			uop->ph_idep[dep] = phreg;
-			self->rat_int_reads++;
+			self->stats.rat_int_reads++;
 		}
 		else if (X86_DEP_IS_FP_REG(loreg))
 		{
@@ -300,13 +404,13 @@ void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop)
 			/* Rename it. */
 			phreg = reg_file->fp_rat[streg - x86_dep_fp_first];
 			uop->ph_idep[dep] = phreg;
-			self->rat_fp_reads++;
+			self->stats.rat_fp_reads++;
 		}
 		else if (X86_DEP_IS_XMM_REG(loreg))
 		{
 			phreg = reg_file->xmm_rat[loreg - x86_dep_xmm_first];
 			uop->ph_idep[dep] = phreg;
-			self->rat_xmm_reads++;
+			self->stats.rat_xmm_reads++;
 		}
 		else
 		{
@@ -339,7 +443,7 @@ void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop)
 			uop->ph_odep[dep] = phreg;
 			uop->ph_oodep[dep] = ophreg;
 			reg_file->int_rat[loreg - x86_dep_int_first] = phreg;
-			self->rat_int_writes++;
+			self->stats.rat_int_writes++;
 		}
 		else if (X86_DEP_IS_FP_REG(loreg))
 		{
@@ -357,7 +461,7 @@ void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop)
 			uop->ph_odep[dep] = phreg;
 			uop->ph_oodep[dep] = ophreg;
 			reg_file->fp_rat[streg - x86_dep_fp_first] = phreg;
-			self->rat_fp_writes++;
+			self->stats.rat_fp_writes++;
 		}
 		else if (X86_DEP_IS_XMM_REG(loreg))
 		{
@@ -371,7 +475,7 @@ void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop)
 			uop->ph_odep[dep] = phreg;
 			uop->ph_oodep[dep] = ophreg;
 			reg_file->xmm_rat[loreg - x86_dep_xmm_first] = phreg;
-			self->rat_xmm_writes++;
+			self->stats.rat_xmm_writes++;
 		}
 		else
 		{
@@ -398,6 +502,21 @@ void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop)
 			reg_file->int_rat[loreg - x86_dep_int_first] = flag_phreg;
 		}
 	}
+
+	/* Link input dependences in the wakeup lists of pending registers */
+	uop->wait_count = 0;
+	for (dep = 0; dep < X86_UINST_MAX_IDEPS; dep++)
+	{
+		phreg_ptr = X86ThreadGetInputPhreg(self, uop, dep);
+		if (!phreg_ptr || !phreg_ptr->pending)
+			continue;
+		uop->wakeup_next[dep] = phreg_ptr->wakeup_head;
+		uop->wakeup_next_dep[dep] = phreg_ptr->wakeup_head_dep;
+		phreg_ptr->wakeup_head = uop;
+		phreg_ptr->wakeup_head_dep = dep;
+		uop->wait_count++;
+	}
+	uop->ready = !uop->wait_count;
 }
 
 
@@ -426,27 +545,10 @@ int X86ThreadIsUopReady(X86Thread *self, struct x86_uop_t *uop)
 }
 
 
-/* Update 'uop->ready' field of all instructions in a list as per the result
- * obtained by 'X86ThreadIsUopReady'. The 'uop->ready' field is redundant and should always
- * match the return value of 'X86ThreadIsUopReady' while an uop is in the ROB.
- * A debug message is dumped when the uop transitions to ready. */
-void X86ThreadIsUopListReady(X86Thread *self, struct linked_list_t *uop_list)
-{
-	struct x86_uop_t *uop;
-
-	LINKED_LIST_FOR_EACH(uop_list)
-	{
-		uop = linked_list_get(uop_list);
-		if (uop->ready || !X86ThreadIsUopReady(self, uop))
-			continue;
-		uop->ready = 1;
-	}
-}
-
-
 void X86ThreadWriteUop(X86Thread *self, struct x86_uop_t *uop)
 {
 	struct x86_reg_file_t *reg_file = self->reg_file;
+	struct x86_phreg_t *phreg_ptr;
 
 	int dep;
 	int loreg;
@@ -458,11 +560,17 @@ void X86ThreadWriteUop(X86Thread *self, struct x86_uop_t *uop)
 		loreg = uop->uinst->odep[dep];
 		phreg = uop->ph_odep[dep];
 		if (X86_DEP_IS_INT_REG(loreg))
-			reg_file->int_phreg[phreg].pending = 0;
+			phreg_ptr = &reg_file->int_phreg[phreg];
 		else if (X86_DEP_IS_FP_REG(loreg))
-			reg_file->fp_phreg[phreg].pending = 0;
+			phreg_ptr = &reg_file->fp_phreg[phreg];
 		else if (X86_DEP_IS_XMM_REG(loreg))
-			reg_file->xmm_phreg[phreg].pending = 0;
+			phreg_ptr = &reg_file->xmm_phreg[phreg];
+		else
+			continue;
+
+		/* Clear pending bit and wake up consumers */
+		phreg_ptr->pending = 0;
+		X86ThreadWakeupPhreg(self, phreg_ptr);
 	}
 }
 
@@ -478,10 +586,13 @@ void X86ThreadUndoUop(X86Thread *self, struct x86_uop_t *uop)
 	int phreg;
 	int ophreg;
 
-	/* Undo mappings in reverse order, in case an instruction has a
-	 * duplicated output dependence. */
+	/* Stop waiting for input registers */
 	assert(uop->thread == self);
 	assert(uop->specmode);
+	X86ThreadUnlinkUop(self, uop);
+
+	/* Undo mappings in reverse order, in case an instruction has a
+	 * duplicated output dependence. */
 	for (dep = X86_UINST_MAX_ODEPS - 1; dep >= 0; dep--)
 	{
 		loreg = uop->uinst->odep[dep];
@@ -80,7 +80,6 @@ int X86ThreadCanRenameUop(X86Thread *self, struct x86_uop_t *uop);
 void X86ThreadRenameUop(X86Thread *self, struct x86_uop_t *uop);
 
 int X86ThreadIsUopReady(X86Thread *self, struct x86_uop_t *uop);
-void X86ThreadIsUopListReady(X86Thread *self, struct linked_list_t *uop_list);
 
 void X86ThreadWriteUop(X86Thread *self, struct x86_uop_t *uop);
 void X86ThreadUndoUop(X86Thread *self, struct x86_uop_t *uop);
@@ -99,6 +98,12 @@ struct x86_phreg_t
 {
 	int pending;  /* not completed (bit) */
 	int busy;  /* number of mapped logical registers */
+
+	/* Uops waiting for the register to be written. The list continues
+	 * through fields 'wakeup_next' and 'wakeup_next_dep' of each uop, at
+	 * the index of the input dependence that reads the register. */
+	struct x86_uop_t *wakeup_head;
+	int wakeup_head_dep;
 };
 
 struct x86_reg_file_t
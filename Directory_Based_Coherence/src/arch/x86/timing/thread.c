@@ -17,6 +17,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <arch/common/interval.h>
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/list.h>
 #include <lib/util/string.h>
@@ -47,7 +48,6 @@ void X86ThreadCreate(X86Thread *self, X86Core *core)
 	/* Structures */
 	X86ThreadInitUopQueue(self);
 	X86ThreadInitLSQ(self);
-	X86ThreadInitIQ(self);
 	X86ThreadInitRegFile(self);
 	X86ThreadInitFetchQueue(self);
 	X86ThreadInitBranchPred(self);
@@ -65,6 +65,8 @@ void X86ThreadDestroy(X86Thread *self)
 	X86ThreadFreeFetchQueue(self);
 	X86ThreadFreeBranchPred(self);
 	X86ThreadFreeTraceCache(self);
+	if (self->interval)
+		interval_core_free(self->interval);
 
 	/* Finalize */
 	self->name = str_free(self->name);
@@ -80,5 +82,6 @@ void X86ThreadSetName(X86Thread *self, char *name)
 int X86ThreadIsPipelineEmpty(X86Thread *self)
 {
 	return !self->rob_count && !self->fetch_queue->count &&
-			!self->uop_queue->count;
+			!self->uop_queue->count && (!self->interval ||
+			interval_core_is_empty(self->interval));
 }
@@ -36,6 +36,7 @@ void X86ThreadInitTraceCache(X86Thread *self);
 void X86ThreadFreeTraceCache(X86Thread *self);
 
 void X86ThreadDumpTraceCacheReport(X86Thread *self, FILE *f);
+void X86ThreadResetTraceCacheStats(X86Thread *self);
 
 void X86ThreadRecordUopInTraceCache(X86Thread *self, struct x86_uop_t *uop);
 int X86ThreadLookupTraceCache(X86Thread *self, unsigned int eip, int pred,
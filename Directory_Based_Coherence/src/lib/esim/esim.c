@@ -65,7 +65,7 @@ volatile enum esim_finish_t esim_finish = esim_finish_none;
 
 struct str_map_t esim_finish_map =
 {
-	21, {
+	22, {
 		{ "ContextsFinished", esim_finish_ctx },
 
 		{ "x86LastInst", esim_finish_x86_last_inst },
@@ -91,6 +91,7 @@ struct str_map_t esim_finish_map =
 		{ "SouthernIslandsMaxCycles", esim_finish_si_max_cycles },
 		{ "SouthernIslandsMaxKernels", esim_finish_si_max_kernels },
 
+		{ "RoiEnd", esim_finish_roi_end },
 		{ "MaxTime", esim_finish_max_time },
 		{ "Signal", esim_finish_signal },
 		{ "Stall", esim_finish_stall }
@@ -62,6 +62,7 @@ extern volatile enum esim_finish_t
 	esim_finish_si_max_cycles,
 	esim_finish_si_max_kernels,
 
+	esim_finish_roi_end,  /* End of the region of interest reached */
 	esim_finish_max_time,  /* Maximum simulation time reached */
 	esim_finish_signal,  /* Signal received */
 	esim_finish_stall  /* Simulation stalled */
@@ -0,0 +1,148 @@
+/*
+ *  Libesim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_ESIM_TRACE_BINARY_H
+#define LIB_ESIM_TRACE_BINARY_H
+
+#include <stdio.h>
+
+
+/*
+ * Binary trace format
+ *
+ * The file starts with the 8-byte string TRACE_BINARY_MAGIC and a 32-bit
+ * version number, followed by a sequence of blocks, a footer, and a trailer:
+ *
+ *   Block    i64 cycle, u32 compressed_size, u32 size, zlib-compressed records
+ *   Footer   u32 num_strings, { u32 length, chars } * num_strings,
+ *            u32 num_blocks, { i64 cycle, i64 file_offset } * num_blocks
+ *   Trailer  i64 footer_offset, i64 num_cycles, TRACE_BINARY_INDEX_MAGIC
+ *
+ * The cycle of a block is the last cycle reached before its first record.
+ * A block is closed before a cycle record once it holds TRACE_BINARY_BLOCK_SIZE
+ * bytes, or anywhere once it reaches TRACE_BINARY_BLOCK_SIZE_MAX bytes, so
+ * that any cycle can be reached by decompressing the last block whose cycle
+ * is lower, as given by the footer index.
+ *
+ * Each record starts with a byte giving its kind, and integers are stored
+ * as unsigned LEB128 variable-length integers (varint):
+ *
+ *   TRACE_RECORD_CYCLE   varint cycle difference
+ *   TRACE_RECORD_STRING  varint length, chars. Defines the next string ID.
+ *   TRACE_RECORD_LINE    varint command, varint num_symbols,
+ *                        { varint name, byte kind, value } * num_symbols
+ *   TRACE_RECORD_TEXT    varint length, chars
+ *
+ * Text lines following the 'command name=value ...' syntax of the trace are
+ * stored as line records, and other lines as text records. Command names,
+ * symbol names, and string values such as module or network names are
+ * interned. A string record defines each of them the first time it is used,
+ * and the footer lists them all again, so that blocks can be decoded in any
+ * order. Values with a decimal suffix, such as access names "A-1234", are
+ * stored as an interned prefix and a number. Numbers are stored as the
+ * zigzag-encoded difference with the last number given to the same symbol
+ * name in the block, or with 0 for its first occurrence, since instruction
+ * and access identifiers mostly grow by small steps. Cycle records are stored
+ * in the same way as differences with the previous cycle record.
+ */
+
+#define TRACE_BINARY_MAGIC  "M2STRACE"
+#define TRACE_BINARY_INDEX_MAGIC  "M2SINDEX"
+#define TRACE_BINARY_VERSION  1
+
+#define TRACE_BINARY_BLOCK_SIZE  (1 << 18)
+#define TRACE_BINARY_BLOCK_SIZE_MAX  (1 << 20)
+
+/* Maximum number of symbols in a trace line */
+#define TRACE_RECORD_MAX_SYMBOLS  64
+
+enum trace_record_kind_t
+{
+	TRACE_RECORD_CYCLE = 0,
+	TRACE_RECORD_STRING,
+	TRACE_RECORD_LINE,
+	TRACE_RECORD_TEXT
+};
+
+enum trace_value_kind_t
+{
+	TRACE_VALUE_STRING = 0,  /* varint string ID */
+	TRACE_VALUE_DECIMAL,  /* varint difference */
+	TRACE_VALUE_HEX,  /* varint difference, printed with a '0x' prefix */
+	TRACE_VALUE_SUFFIX,  /* varint string ID of prefix, varint difference */
+
+	/* Flag set when the value was quoted in the text line */
+	TRACE_VALUE_QUOTED = 0x80
+};
+
+
+/* A trace line as returned by the reader. Cycle records are returned as
+ * command 'c' with symbol 'clk', as in text traces. Text records are returned
+ * in 'text' with a NULL command. Strings point to internal buffers, which are
+ * valid until the next read. */
+struct trace_record_t
+{
+	char *command;
+	char *text;
+
+	int num_symbols;
+	char *symbol_name[TRACE_RECORD_MAX_SYMBOLS];
+	char *symbol_value[TRACE_RECORD_MAX_SYMBOLS];
+	int symbol_quoted[TRACE_RECORD_MAX_SYMBOLS];
+
+	char buf[4096];
+};
+
+void trace_record_dump(struct trace_record_t *record, FILE *f);
+int trace_record_print(struct trace_record_t *record, char *buf, int size);
+
+
+/* Writer */
+
+struct trace_writer_t;
+
+struct trace_writer_t *trace_writer_create(char *file_name);
+void trace_writer_free(struct trace_writer_t *writer);
+
+void trace_writer_cycle(struct trace_writer_t *writer, long long cycle);
+void trace_writer_text(struct trace_writer_t *writer, char *text);
+
+
+/* Reader */
+
+struct trace_reader_t;
+
+struct trace_reader_t *trace_reader_create(char *file_name);
+void trace_reader_free(struct trace_reader_t *reader);
+
+long long trace_reader_get_num_cycles(struct trace_reader_t *reader);
+int trace_reader_get_num_blocks(struct trace_reader_t *reader);
+int trace_reader_get_num_strings(struct trace_reader_t *reader);
+
+long long trace_reader_tell(struct trace_reader_t *reader);
+void trace_reader_seek(struct trace_reader_t *reader, long long position);
+void trace_reader_seek_cycle(struct trace_reader_t *reader, long long cycle);
+int trace_reader_read(struct trace_reader_t *reader, struct trace_record_t *record);
+
+
+/* Headless tool converting and querying trace files */
+void trace_tool(char *file_name, char *output_file_name, char *cycles);
+
+
+#endif
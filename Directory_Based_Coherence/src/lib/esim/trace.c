@@ -24,11 +24,25 @@
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/debug.h>
 #include <lib/util/list.h>
+#include <lib/util/string.h>
 
 #include "esim.h"
+#include "trace.h"
+#include "trace-binary.h"
 
 
+struct str_map_t trace_format_map =
+{
+	2, {
+		{ "text", trace_format_text },
+		{ "binary", trace_format_binary }
+	}
+};
+
+/* Only one of them is open, depending on the trace format */
 static gzFile trace_file;
+static struct trace_writer_t *trace_writer;
+
 static struct list_t *trace_category_list;
 
 enum trace_status_t
@@ -44,7 +58,7 @@ struct trace_category_t
 };
 
 
-void trace_init(char *file_name)
+void trace_init(char *file_name, enum trace_format_t format)
 {
 	struct trace_category_t *c;
 
@@ -53,9 +67,16 @@ void trace_init(char *file_name)
 		return;
 
 	/* Open destination file */
-	trace_file = gzopen(file_name, "wt");
-	if (!trace_file)
-		fatal("%s: cannot open trace file", file_name);
+	if (format == trace_format_binary)
+	{
+		trace_writer = trace_writer_create(file_name);
+	}
+	else
+	{
+		trace_file = gzopen(file_name, "wt");
+		if (!trace_file)
+			fatal("%s: cannot open trace file", file_name);
+	}
 
 	/* Initialize list of categories */
 	trace_category_list = list_create();
@@ -69,11 +90,14 @@ void trace_init(char *file_name)
 void trace_done(void)
 {
 	/* Nothing if trace is inactive */
-	if (!trace_file)
+	if (!trace_file && !trace_writer)
 		return;
 
 	/* Close trace file */
-	gzclose(trace_file);
+	if (trace_writer)
+		trace_writer_free(trace_writer);
+	else
+		gzclose(trace_file);
 
 	/* Free categories */
 	while (trace_category_list->count)
@@ -88,7 +112,7 @@ int trace_new_category(void)
 	struct trace_category_t *c;
 
 	/* If trace system not initialized, return invalid cateogry */
-	if (!trace_file)
+	if (!trace_file && !trace_writer)
 		return 0;
 
 	/* Initialize */
@@ -147,12 +171,18 @@ void __trace(int category, int print_cycle, char *fmt, ...)
 		cycle = esim_cycle();
 		if (cycle > trace_last_cycle)
 		{
-			gzprintf(trace_file, "c clk=%lld\n", cycle);
+			if (trace_writer)
+				trace_writer_cycle(trace_writer, cycle);
+			else
+				gzprintf(trace_file, "c clk=%lld\n", cycle);
 			trace_last_cycle = cycle;
 		}
 	}
 
 	/* Dump message */
-	gzwrite(trace_file, buf, len);
+	if (trace_writer)
+		trace_writer_text(trace_writer, buf);
+	else
+		gzwrite(trace_file, buf, len);
 }
 
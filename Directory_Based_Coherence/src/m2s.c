@@ -24,6 +24,8 @@
 #include <arch/arm/emu/syscall.h>
 #include <arch/arm/timing/cpu.h>
 #include <arch/common/arch.h>
+#include <arch/common/interval.h>
+#include <arch/common/roi.h>
 #include <arch/common/runtime.h>
 #include <arch/evergreen/emu/emu.h>
 #include <arch/evergreen/emu/isa.h>
@@ -59,6 +61,7 @@
 #include <driver/opengl/opengl.h>
 #include <lib/esim/esim.h>
 #include <lib/esim/trace.h>
+#include <lib/esim/trace-binary.h>
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/debug.h>
 #include <lib/util/file.h>
@@ -77,6 +80,10 @@ static char *visual_file_name = "";
 static char *ctx_config_file_name = "";
 static char *elf_debug_file_name = "";
 static char *trace_file_name = "";
+static enum trace_format_t trace_format = trace_format_text;
+static char *trace_tool_file_name = "";
+static char *trace_tool_output_file_name = "";
+static char *trace_tool_cycles = "";
 static char *glu_debug_file_name = "";
 static char *glut_debug_file_name = "";
 static char *glew_debug_file_name = "";
@@ -181,6 +188,24 @@ static char *m2s_help =
 		"      Maximum simulation time in seconds. The simulator will stop once this time\n"
 		"      is exceeded. A value of 0 (default) means no time limit.\n"
 		"\n"
+		"  --roi-end <cycle>\n"
+		"      Global simulation cycle where the region of interest (ROI) ends. The\n"
+		"      simulation finishes at this point, so that the final reports cover the\n"
+		"      ROI only. A guest x86 program can also mark the end of the ROI with\n"
+		"      system call 332 and value 2 in register 'ebx'.\n"
+		"\n"
+		"  --roi-fast-forward\n"
+		"      Run the x86 CPU in functional mode until the guest program marks the\n"
+		"      start of the ROI. By default, the code before the ROI is simulated in\n"
+		"      detail, which warms up caches and predictors. This option is not\n"
+		"      compatible with '--roi-start'.\n"
+		"\n"
+		"  --roi-start <cycle>\n"
+		"      Global simulation cycle where the region of interest starts. Statistics\n"
+		"      of the memory system and of the timing simulators are reset at this\n"
+		"      point. A guest x86 program can also mark the start of the ROI with\n"
+		"      system call 332 and value 1 in register 'ebx'.\n"
+		"\n"
 		"  --trace <file>.gz\n"
 		"      Generate a trace file with debug information on the configuration of the\n"
 		"      modeled CPUs, GPUs, and memory system, as well as their dynamic\n"
@@ -188,6 +213,27 @@ static char *m2s_help =
 		"      should watch the size of the generated trace as simulation runs, since\n"
 		"      the trace file can quickly become extremely large.\n"
 		"\n"
+		"  --trace-format {text|binary}\n"
+		"      Format of the file generated with '--trace'. A binary trace stores\n"
+		"      command and module names once, numbers as variable-length integers, and\n"
+		"      compresses them in blocks, with an index of the cycle where each block\n"
+		"      starts. It is smaller and faster to generate than a text trace, and the\n"
+		"      visualization tool can open it without uncompressing it first.\n"
+		"\n"
+		"  --trace-tool <file>\n"
+		"      Print a summary of a text or binary trace file generated with '--trace'.\n"
+		"      Use options '--trace-tool-output' and '--trace-tool-cycles' to convert\n"
+		"      the trace or to print part of it.\n"
+		"\n"
+		"  --trace-tool-output <file>\n"
+		"      Convert the trace given in '--trace-tool' into this file. A text trace is\n"
+		"      converted to binary, and a binary trace to text.\n"
+		"\n"
+		"  --trace-tool-cycles <first>:<last>\n"
+		"      Limit the output of '--trace-tool' to the given range of cycles, printed\n"
+		"      as text if no output file is given. The index of binary traces is used\n"
+		"      to start reading close to the first cycle.\n"
+		"\n"
 		"  --visual <file>.gz\n"
 		"      Run the Multi2Sim Visualization Tool. This option consumes a file\n"
 		"      generated with the '--trace' option in a previous simulation. This option\n"
@@ -280,9 +326,16 @@ static char *m2s_help =
 		"      Useful options to use together with this are '--x86-max-inst' and\n"
 		"      '--x86-last-inst' to force the simulation to stop and create a checkpoint.\n"
 		"\n"
-		"  --x86-sim {functional|detailed}\n"
+		"  --x86-sim {functional|detailed|interval}\n"
 		"      Choose a functional simulation (emulation) of an x86 program, versus\n"
 		"      a detailed (architectural) simulation. Simulation is functional by\n" 	"      default.\n"
+		"      An interval simulation replaces the out-of-order pipeline by a fast\n"
+		"      core model that dispatches instructions in order and only stalls on\n"
+		"      a full window behind long-latency loads, a full store buffer, busy\n"
+		"      cache ports, instruction fetch misses, and branch mispredictions.\n"
+		"      It drives the same memory hierarchy as a detailed simulation, and\n"
+		"      accepts options '--x86-config', '--x86-report', and\n"
+		"      '--x86-max-cycles'.\n"
 		"\n"
 		"\n"
 		"================================================================================\n"
@@ -404,6 +457,11 @@ static char *m2s_help =
 		"      Maximum number of Southern Islands kernels (0 for no maximum). After the\n"
 		"      last kernel finishes execution, the simulator will stop.\n"
 		"\n"
+		"  --si-no-simd\n"
+		"      Execute vector ALU instructions one work-item at a time, instead of\n"
+		"      for all work-items of a wavefront at once using host SIMD instructions.\n"
+		"      Results are the same, this option is only useful for comparison.\n"
+		"\n"
 		"  --si-report <file>\n"
 		"      File to dump a report of the GPU pipeline, such as active execution\n"
 		"      engines, compute units occupancy, stream cores utilization, etc. Use\n"
@@ -435,6 +493,24 @@ static char *m2s_help =
 		"      Debug information for dynamic execution of Arm instructions. Updates on\n"
 		"      the processor state can be analyzed using this information.\n"
 		"\n"
+		"  --arm-config <file>\n"
+		"      Configuration file for the ARM interval core model, used with option\n"
+		"      '--arm-sim interval'. Type 'm2s --arm-help' for details on the file\n"
+		"      format.\n"
+		"\n"
+		"  --arm-help\n"
+		"      Display a help message describing the format of the ARM CPU\n"
+		"      configuration file, passed with option '--arm-config <file>'.\n"
+		"\n"
+		"  --arm-report <file>\n"
+		"      File to dump a report of the ARM interval cores, with statistics\n"
+		"      such as dispatched instructions and stall cycles by cause. Only valid\n"
+		"      with option '--arm-sim interval'.\n"
+		"\n"
+		"  --arm-sim {functional|interval}\n"
+		"      Functional simulation (default), or timing simulation with the interval\n"
+		"      core model driving the memory hierarchy.\n"
+		"\n"
 		"\n"
 		"================================================================================\n"
 		"MIPS Options\n"
@@ -453,6 +529,24 @@ static char *m2s_help =
 		"      Debug information for dynamic execution of Mips instructions. Updates on\n"
 		"      the processor state can be analyzed using this information.\n"
 		"\n"
+		"  --mips-config <file>\n"
+		"      Configuration file for the MIPS interval core model, used with option\n"
+		"      '--mips-sim interval'. Type 'm2s --mips-help' for details on the file\n"
+		"      format.\n"
+		"\n"
+		"  --mips-help\n"
+		"      Display a help message describing the format of the MIPS CPU\n"
+		"      configuration file, passed with option '--mips-config <file>'.\n"
+		"\n"
+		"  --mips-report <file>\n"
+		"      File to dump a report of the MIPS interval cores, with statistics\n"
+		"      such as dispatched instructions and stall cycles by cause. Only valid\n"
+		"      with option '--mips-sim interval'.\n"
+		"\n"
+		"  --mips-sim {functional|interval}\n"
+		"      Functional simulation (default), or timing simulation with the interval\n"
+		"      core model driving the memory hierarchy.\n"
+		"\n"
 		"\n"
 		"================================================================================\n"
 		"NVIDIA Fermi GPU Options\n"
@@ -500,6 +594,13 @@ static char *m2s_help =
 		"      Dump debug information about memory accesses, cache memories, main memory,\n"
 		"      and directories.\n"
 		"\n"
+		"  --mem-debug-filter <list>\n"
+		"      Limit the memory debug information and the memory system lines of the\n"
+		"      trace ('--trace') to accesses at some modules and addresses. The list\n"
+		"      contains comma-separated entries with format '<module>[:<addr>[-<addr>]]',\n"
+		"      where the module can be '*' to match any module. A single address selects\n"
+		"      the block containing it, e.g., 'mod-l2:0x1f40'.\n"
+		"\n"
 		"  --mem-help\n"
 		"      Print help message describing the format of the memory configuration file,\n"
 		"      passed to the simulator with option '--mem-config <file>'.\n"
@@ -631,6 +732,33 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 			continue;
 		}
 
+		/* Region of interest */
+		if (!strcmp(argv[argi], "--roi-end"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			roi_end_cycle = str_to_llint(argv[argi + 1], &err);
+			if (err)
+				fatal("option %s, value '%s': %s", argv[argi],
+						argv[argi + 1], str_error(err));
+			argi++;
+			continue;
+		}
+		if (!strcmp(argv[argi], "--roi-fast-forward"))
+		{
+			roi_fast_forward = 1;
+			continue;
+		}
+		if (!strcmp(argv[argi], "--roi-start"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			roi_start_cycle = str_to_llint(argv[argi + 1], &err);
+			if (err)
+				fatal("option %s, value '%s': %s", argv[argi],
+						argv[argi + 1], str_error(err));
+			argi++;
+			continue;
+		}
+
 		/* Simulation trace */
 		if (!strcmp(argv[argi], "--trace"))
 		{
@@ -639,6 +767,39 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 			continue;
 		}
 
+		/* Trace format */
+		if (!strcmp(argv[argi], "--trace-format"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			trace_format = str_map_string_err_msg(&trace_format_map,
+					argv[++argi], "invalid value for --trace-format.");
+			continue;
+		}
+
+		/* Trace tool */
+		if (!strcmp(argv[argi], "--trace-tool"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			trace_tool_file_name = argv[++argi];
+			continue;
+		}
+
+		/* Trace tool output file */
+		if (!strcmp(argv[argi], "--trace-tool-output"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			trace_tool_output_file_name = argv[++argi];
+			continue;
+		}
+
+		/* Trace tool cycle range */
+		if (!strcmp(argv[argi], "--trace-tool-cycles"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			trace_tool_cycles = argv[++argi];
+			continue;
+		}
+
 		/* Visualization tool */
 		if (!strcmp(argv[argi], "--visual"))
 		{
@@ -1092,6 +1253,13 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 			continue;
 		}
 
+		/* Southern Islands per-work-item execution */
+		if (!strcmp(argv[argi], "--si-no-simd"))
+		{
+			si_emu_simd = 0;
+			continue;
+		}
+
 		/* Southern Islands GPU timing report */
 		if (!strcmp(argv[argi], "--si-report"))
 		{
@@ -1222,6 +1390,41 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 			continue;
 		}
 
+		/* ARM CPU configuration file */
+		if (!strcmp(argv[argi], "--arm-config"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			arm_cpu_config_file_name = argv[++argi];
+			continue;
+		}
+
+		/* Help for ARM CPU configuration file */
+		if (!strcmp(argv[argi], "--arm-help"))
+		{
+			fprintf(stderr, "%s", interval_config_help);
+			continue;
+		}
+
+		/* ARM CPU report */
+		if (!strcmp(argv[argi], "--arm-report"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			arm_cpu_report_file_name = argv[++argi];
+			continue;
+		}
+
+		/* ARM simulation accuracy */
+		if (!strcmp(argv[argi], "--arm-sim"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			arm_sim_kind = str_map_string_err_msg(&arch_sim_kind_map,
+					argv[++argi], "invalid value for --arm-sim.");
+			if (arm_sim_kind == arch_sim_kind_detailed)
+				fatal("ARM detailed simulation is not supported.\n"
+					"\tPlease use option '--arm-sim interval' instead.\n");
+			continue;
+		}
+
 		/* Arm loader debug file */
 		if (!strcmp(argv[argi], "--arm-debug-loader"))
 		{
@@ -1268,6 +1471,41 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 			continue;
 		}
 
+		/* MIPS CPU configuration file */
+		if (!strcmp(argv[argi], "--mips-config"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			mips_cpu_config_file_name = argv[++argi];
+			continue;
+		}
+
+		/* Help for MIPS CPU configuration file */
+		if (!strcmp(argv[argi], "--mips-help"))
+		{
+			fprintf(stderr, "%s", interval_config_help);
+			continue;
+		}
+
+		/* MIPS CPU report */
+		if (!strcmp(argv[argi], "--mips-report"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			mips_cpu_report_file_name = argv[++argi];
+			continue;
+		}
+
+		/* MIPS simulation accuracy */
+		if (!strcmp(argv[argi], "--mips-sim"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			mips_sim_kind = str_map_string_err_msg(&arch_sim_kind_map,
+					argv[++argi], "invalid value for --mips-sim.");
+			if (mips_sim_kind == arch_sim_kind_detailed)
+				fatal("MIPS detailed simulation is not supported.\n"
+					"\tPlease use option '--mips-sim interval' instead.\n");
+			continue;
+		}
+
 		/* Arm loader debug file */
 		if (!strcmp(argv[argi], "--mips-debug-loader"))
 		{
@@ -1322,6 +1560,14 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 			continue;
 		}
 
+		/* Memory hierarchy debug and trace filter */
+		if (!strcmp(argv[argi], "--mem-debug-filter"))
+		{
+			m2s_need_argument(argc, argv, argi);
+			mem_debug_filter = argv[++argi];
+			continue;
+		}
+
 		/* Help for memory hierarchy configuration file */
 		if (!strcmp(argv[argi], "--mem-help"))
 		{
@@ -1512,6 +1758,17 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 		break;
 	}
 
+	/* Options only allowed for the trace tool */
+	if (!*trace_tool_file_name)
+	{
+		char *msg = "option '%s' not valid without option '--trace-tool'.\n";
+
+		if (*trace_tool_output_file_name)
+			fatal(msg, "--trace-tool-output");
+		if (*trace_tool_cycles)
+			fatal(msg, "--trace-tool-cycles");
+	}
+
 	/* Options only allowed for x86 detailed simulation */
 	if (x86_sim_kind == arch_sim_kind_functional)
 	{
@@ -1524,8 +1781,40 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 			fatal(msg, "--x86-max-cycles");
 		if (*x86_cpu_report_file_name)
 			fatal(msg, "--x86-report");
+		if (roi_fast_forward)
+			fatal(msg, "--roi-fast-forward");
 	}
 
+	/* Options only allowed for ARM and MIPS timing simulation */
+	if (arm_sim_kind == arch_sim_kind_functional)
+	{
+		char *msg = "option '%s' not valid for functional ARM simulation.\n"
+				"\tPlease use option '--arm-sim interval' as well.\n";
+
+		if (*arm_cpu_config_file_name)
+			fatal(msg, "--arm-config");
+		if (*arm_cpu_report_file_name)
+			fatal(msg, "--arm-report");
+	}
+	if (mips_sim_kind == arch_sim_kind_functional)
+	{
+		char *msg = "option '%s' not valid for functional MIPS simulation.\n"
+				"\tPlease use option '--mips-sim interval' as well.\n";
+
+		if (*mips_cpu_config_file_name)
+			fatal(msg, "--mips-config");
+		if (*mips_cpu_report_file_name)
+			fatal(msg, "--mips-report");
+	}
+
+	/* The interval core model is only available for CPUs */
+	if (evg_sim_kind == arch_sim_kind_interval ||
+			si_sim_kind == arch_sim_kind_interval ||
+			frm_sim_kind == arch_sim_kind_interval)
+		fatal("interval simulation is only available for CPU architectures.\n"
+			"\tPlease use '--evg-sim', '--si-sim', or '--frm-sim' with values\n"
+			"\t'functional' or 'detailed'.\n");
+
 	/* Options that only make sense for GPU detailed simulation */
 	if (evg_sim_kind == arch_sim_kind_functional)
 	{
@@ -1593,6 +1882,10 @@ static void m2s_read_command_line(int *argc_ptr, char **argv)
 		fatal("option '--net-sim' requires '--net-config'");
 	if(!*dram_sim_system_name && dram_sim_last_option)
 		fatal("option '%s' requires '--dram-sim'", dram_sim_last_option);
+	if (roi_fast_forward && roi_start_cycle)
+		fatal("options '--roi-fast-forward' and '--roi-start' are incompatible");
+	if (roi_end_cycle && roi_end_cycle <= roi_start_cycle)
+		fatal("option '--roi-end' must be greater than '--roi-start'");
 
 	/* Discard arguments used as options */
 	arg_discard = argi - 1;
@@ -1721,6 +2014,8 @@ static void m2s_dump_summary(FILE *f)
 		fprintf(f, "SimTime = %.2f [ns]\n", esim_time / 1000.0);
 		fprintf(f, "Frequency = %d [MHz]\n", esim_frequency);
 		fprintf(f, "Cycles = %lld\n", cycles);
+		if (roi_state != roi_state_before)
+			fprintf(f, "RoiCycles = %lld\n", cycles - roi_begin_cycle);
 	}
 
 	/* End */
@@ -1749,6 +2044,8 @@ static void m2s_dump_summary(FILE *f)
 		printf("SimTime = %.2f [ns]\n", esim_time / 1000.0);
 		printf("Frequency = %d [MHz]\n", esim_frequency);
 		printf("Cycles = %lld\n", cycles);
+		if (roi_state != roi_state_before)
+			printf("RoiCycles = %lld\n", cycles - roi_begin_cycle);
 	}
 
 	/* End */
@@ -1892,6 +2189,9 @@ static void m2s_loop(void)
 		 * The argument 'num_timing_active' is interpreted as a flag TRUE/FALSE. */
 		esim_process_events(num_timing_active);
 
+		/* Region of interest limits given in the command line */
+		roi_check();
+
 		/* If neither functional nor timing simulation was performed for any architecture,
 		 * it means that all guest contexts finished execution - simulation can end. */
 		if (!num_emu_active && !num_timing_active)
@@ -1965,6 +2265,11 @@ int main(int argc, char **argv)
 	if (*visual_file_name)
 		visual_run(visual_file_name);
 
+	/* Trace conversion and query tool */
+	if (*trace_tool_file_name)
+		trace_tool(trace_tool_file_name, trace_tool_output_file_name,
+			trace_tool_cycles);
+
 	/* Network simulation tool */
 	if (*net_sim_network_name)
 		net_sim(net_debug_file_name);
@@ -2028,7 +2333,7 @@ int main(int argc, char **argv)
 
 	/* Initialization of libraries */
 	esim_init();
-	trace_init(trace_file_name);
+	trace_init(trace_file_name, trace_format);
 
 	/* Initialization of architectures */
 	arch_arm = arch_register("ARM", "arm", arm_sim_kind,
@@ -2083,7 +2388,7 @@ int main(int argc, char **argv)
 	 * better once the process finish. But now we need to release 4.2...
 	 */
 	X86CpuInit();
-	if (x86_sim_kind == arch_sim_kind_detailed)
+	if (x86_sim_kind != arch_sim_kind_functional)
 	{
 		x86_cpu = new(X86Cpu, x86_emu);
 		arch_set_timing(arch_x86, asTiming(x86_cpu));
@@ -2118,6 +2423,7 @@ int main(int argc, char **argv)
 
 	/* Dump statistics summary */
 	m2s_dump_summary(stderr);
+	roi_done();
 
 	/* x86 */
 	if (x86_cpu)
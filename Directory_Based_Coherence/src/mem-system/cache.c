@@ -251,6 +251,16 @@ void cache_set_block(struct cache_t *cache, int set, int way, int tag, int state
 		cache_update_waylist(&cache->sets[set],
 			&cache->sets[set].blocks[way],
 			cache_waylist_head);
+
+	/* A prefetched block replaced before any demand access was useless. The
+	 * flag does not apply to the new block. */
+	if (cache->sets[set].blocks[way].tag != tag && cache->sets[set].blocks[way].prefetched)
+	{
+		if (cache->sets[set].blocks[way].prefetched == PREFETCHER_BLOCK_PREFETCHED)
+			cache->prefetcher->unused++;
+		cache->sets[set].blocks[way].prefetched = 0;
+	}
+
 	cache->sets[set].blocks[way].tag = tag;
 	cache->sets[set].blocks[way].state = state;
 }
@@ -60,6 +60,7 @@ struct cache_block_t
 	int transient_tag;
 	int way;
 	int prefetched;
+	int dir_only;  /* Tracked by the directory without holding data */
 
 	enum cache_block_state_t state;
 };
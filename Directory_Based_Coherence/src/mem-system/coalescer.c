@@ -0,0 +1,100 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "coalescer.h"
+#include "module.h"
+
+
+static void coalescer_issue(struct coalescer_t *coalescer, unsigned int addr)
+{
+	mod_access(coalescer->mod, coalescer->access_kind, addr,
+		coalescer->witness_ptr, NULL, NULL, NULL);
+	(*coalescer->witness_ptr)--;
+	coalescer->request_count++;
+}
+
+
+void coalescer_init(struct coalescer_t *coalescer, int enabled)
+{
+	memset(coalescer, 0, sizeof(struct coalescer_t));
+	coalescer->enabled = enabled;
+}
+
+
+void coalescer_reset_stats(struct coalescer_t *coalescer)
+{
+	coalescer->instructions = 0;
+	coalescer->lane_accesses = 0;
+	coalescer->request_count = 0;
+}
+
+
+void coalescer_start(struct coalescer_t *coalescer, struct mod_t *mod,
+	enum mod_access_kind_t access_kind, int *witness_ptr)
+{
+	coalescer->mod = mod;
+	coalescer->access_kind = access_kind;
+	coalescer->witness_ptr = witness_ptr;
+	coalescer->num_requests = 0;
+	coalescer->instructions++;
+}
+
+
+void coalescer_add(struct coalescer_t *coalescer, unsigned int addr)
+{
+	struct coalescer_request_t *request;
+	unsigned int block;
+	int i;
+
+	/* No coalescing */
+	coalescer->lane_accesses++;
+	if (!coalescer->enabled)
+	{
+		coalescer_issue(coalescer, addr);
+		return;
+	}
+
+	/* Lanes usually access consecutive addresses, so the block is looked
+	 * up starting with the most recent request. */
+	block = addr >> coalescer->mod->log_block_size;
+	for (i = coalescer->num_requests - 1; i >= 0; i--)
+	{
+		request = &coalescer->requests[i];
+		if (request->addr >> coalescer->mod->log_block_size == block)
+			return;
+	}
+
+	/* New request */
+	assert(coalescer->num_requests < COALESCER_MAX_LANES);
+	request = &coalescer->requests[coalescer->num_requests++];
+	request->addr = addr;
+}
+
+
+void coalescer_end(struct coalescer_t *coalescer)
+{
+	int i;
+
+	for (i = 0; i < coalescer->num_requests; i++)
+		coalescer_issue(coalescer, coalescer->requests[i].addr);
+	coalescer->num_requests = 0;
+}
@@ -0,0 +1,76 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEM_SYSTEM_COALESCER_H
+#define MEM_SYSTEM_COALESCER_H
+
+#include "module.h"
+
+
+/*
+ * This file implements the address coalescer of a GPU memory unit. A vector
+ * memory instruction provides one address per active lane, and the
+ * coalescer merges the addresses that fall in the same block of the
+ * accessed module into a single request.
+ * Like the prefetch history, this is not part of the memory hierarchy
+ * itself, but it is kept here so that all GPU architectures can use it.
+ *
+ * An instruction is coalesced with one call to 'coalescer_start', one call
+ * to 'coalescer_add' per active lane, and one call to 'coalescer_end', which
+ * issues one module access per resulting request.
+ */
+
+/* Maximum number of lanes of a memory instruction */
+#define COALESCER_MAX_LANES  64
+
+/* Request resulting from coalescing lane accesses to the same block */
+struct coalescer_request_t
+{
+	unsigned int addr;  /* Address of the first lane accessing the block */
+};
+
+struct coalescer_t
+{
+	/* If not set, lane addresses are never merged, and each of them is
+	 * issued to the module as soon as it is added. */
+	int enabled;
+
+	/* Current instruction. The witness pointer is decremented for every
+	 * module access, and incremented back when the access completes. */
+	struct mod_t *mod;
+	enum mod_access_kind_t access_kind;
+	int *witness_ptr;
+	int num_requests;
+	struct coalescer_request_t requests[COALESCER_MAX_LANES];
+
+	/* Statistics */
+	long long instructions;  /* Coalesced instructions */
+	long long lane_accesses;  /* Lane addresses presented */
+	long long request_count;  /* Requests issued to the module */
+};
+
+void coalescer_init(struct coalescer_t *coalescer, int enabled);
+void coalescer_reset_stats(struct coalescer_t *coalescer);
+
+void coalescer_start(struct coalescer_t *coalescer, struct mod_t *mod,
+	enum mod_access_kind_t access_kind, int *witness_ptr);
+void coalescer_add(struct coalescer_t *coalescer, unsigned int addr);
+void coalescer_end(struct coalescer_t *coalescer);
+
+#endif
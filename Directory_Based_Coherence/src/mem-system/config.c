@@ -39,6 +39,7 @@
 #include "mmu.h"
 #include "module.h"
 #include "prefetcher.h"
+#include "tlb.h"
 
 
 /*
@@ -78,6 +79,11 @@ char *mem_config_help =
 	"      addresses in ascending order at the granularity of the page size.\n"
 	"  PeerTransfers = <bool> (Default = transfers)\n"
 	"      Whether or not transfers between peer caches are used.\n"
+	"  LockQueue = <bool> (Default = False)\n"
+	"      Whether or not an access that fails because it found a directory entry\n"
+	"      locked in a lower-level cache waits in the lock queue of that entry.\n"
+	"      When enabled, the access is retried as soon as the entry is unlocked.\n"
+	"      Otherwise, it is retried after a random number of cycles.\n"
 	"\n"
 	"Section [Module <name>] defines a generic memory module. This section is\n"
 	"used to declare both caches and main memory modules accessible from CPU\n"
@@ -108,12 +114,35 @@ char *mem_config_help =
 	"  HighNetworkNode = <node>\n"
 	"      If 'HighNetwork' points to an external network, node that the module\n"
 	"      is mapped to.\n"
+	"      For a cache whose geometry has several slices, 'LowNetworkNode' and\n"
+	"      'HighNetworkNode' give a space-separated list of nodes, one per\n"
+	"      slice, in slice order.\n"
 	"  LowModules = <mod1> [<mod2> ...]\n"
 	"      List of lower-level modules. For a cache module, this variable is\n"
 	"      required. If there is only one lower-level module, it serves the\n"
 	"      entire address space for the current module. If there are several\n"
 	"      lower-level modules, each served a disjoint subset of the address\n"
 	"      space. This variable should be omitted for main memory modules.\n"
+	"  Inclusion = {Inclusive|NINE|Exclusive} (Default = Inclusive)\n"
+	"      Inclusion policy of a cache with respect to its higher-level modules.\n"
+	"      The directory of a cache is kept in its tags, and the copies held\n"
+	"      above are invalidated when a block leaves the directory. An inclusive\n"
+	"      cache holds the data of every block in its directory. A cache that is\n"
+	"      not inclusive has more tags than data frames (see 'DirectoryAssoc'),\n"
+	"      so blocks held above can stay in its directory without their data.\n"
+	"      A non-inclusive, non-exclusive (NINE) cache allocates the blocks it\n"
+	"      brings from lower levels and the dirty blocks evicted by higher-level\n"
+	"      modules. An exclusive cache allocates all blocks evicted by\n"
+	"      higher-level modules, but not the blocks brought from lower levels,\n"
+	"      and moves a clean block up when a higher-level module hits on it.\n"
+	"      A cache that is not inclusive cannot be accessed by a CPU or GPU, and\n"
+	"      its higher-level modules must be inclusive.\n"
+	"  ForwardState = <bool> (Default = False)\n"
+	"      Forward (F) state of the MESIF protocol for the blocks this module\n"
+	"      serves to its higher-level modules. The directory designates the\n"
+	"      last higher-level module that read a shared block as its forwarder.\n"
+	"      A read miss on a block with no owner above is then supplied by the\n"
+	"      forwarder through a peer transfer, instead of by this module.\n"
 	"  BlockSize = <size>\n"
 	"      Block size in bytes. This variable is required for a main memory\n"
 	"      module. It should be omitted for a cache module (in this case, the\n"
@@ -137,7 +166,8 @@ char *mem_config_help =
 	"  DirectoryAssoc = <assoc>\n"
 	"      Directory associativity in number of ways. This variable is only\n"
 	"      allowed for a main memory module.\n"
-	"  AddressRange = { BOUNDS <low> <high> | ADDR DIV <div> MOD <mod> EQ <eq> }\n"
+	"  AddressRange = { BOUNDS <low> <high> |\n"
+	"          ADDR DIV <div> MOD <mod> EQ <eq> [HASH {MODULO|XOR}] }\n"
 	"      Physical address range served by the module. If not specified, the\n"
 	"      entire address space is served by the module. There are two possible\n"
 	"      formats for the value of 'Range':\n"
@@ -152,6 +182,10 @@ char *mem_config_help =
 	"      When a module serves only a subset of the address space, the user must\n"
 	"      make sure that the rest of the modules at the same level serve the\n"
 	"      remaining address space.\n"
+	"      The second format can end with 'HASH XOR' to select the module\n"
+	"      with the XOR of all log2(<mod>)-bit chunks of the address divided by\n"
+	"      <div>, instead of the modulo. In this case, <mod> must be a power of\n"
+	"      two. This variable is not allowed for caches with several slices.\n"
 	"\n"
 	"Section [CacheGeometry <geo>] defines a geometry for a cache. Caches using\n"
 	"this geometry are instantiated [Module <name>] sections.\n"
@@ -170,32 +204,103 @@ char *mem_config_help =
 	"      Block replacement policy.\n"
 	"  MSHR = <size> (Default = 16)\n"
 	"      Miss status holding register (MSHR) size in number of entries. This\n"
-	"      value determines the maximum number of accesses that can be in flight\n"
-	"      for the cache, including the time since the access request is\n"
-	"      received, until a potential miss is resolved.\n"
+	"      value determines the maximum number of misses to different blocks\n"
+	"      that can be in flight for the cache. Loads, and stores following a\n"
+	"      store miss, to a block already being missed on are attached to its\n"
+	"      entry. A miss finding all entries busy waits for one to be released.\n"
 	"  Ports = <num> (Default = 2)\n"
 	"      Number of ports. The number of ports in a cache limits the number of\n"
 	"      concurrent hits. If an access is a miss, it remains in the MSHR while\n"
 	"      it is resolved, but releases the cache port.\n"
+	"  Slices = <num> (Default = 1)\n"
+	"      Number of slices (banks) of the cache, a power of two. A module\n"
+	"      [Module <name>] using this geometry creates modules '<name>.s0',\n"
+	"      '<name>.s1', and so on, each with the sets, ports, and MSHR given in\n"
+	"      this section, and serving the blocks assigned to it by 'SliceHash'.\n"
+	"      Other modules refer to all slices with <name> in 'LowModules'. A\n"
+	"      sliced cache cannot be accessed directly from an [Entry <name>].\n"
+	"  SliceHash = {Modulo|XOR} (Default = Modulo)\n"
+	"      Slice serving a block. With 'Modulo', consecutive blocks go to\n"
+	"      consecutive slices. With 'XOR', all log2(Slices)-bit chunks of the\n"
+	"      block address are folded with XOR, which spreads strides that are a\n"
+	"      multiple of the number of slices.\n"
+	"  HopLatency = <cycles> (Default = 0)\n"
+	"      Additional access latency for each network hop between the cache\n"
+	"      and the higher-level module accessing it, to model a non-uniform\n"
+	"      cache access (NUCA) latency. The number of hops is taken from the\n"
+	"      routes of the high network. Internal networks have a single switch,\n"
+	"      so the distance is only non-uniform with an external network.\n"
 	"  DirectoryLatency = <cycles> (Default = 1)\n"
 	"      Latency for a directory access in number of cycles.\n"
+	"  DirectoryAssoc = <assoc> (Default = Assoc, or 2 * Assoc if the cache\n"
+	"          is not inclusive)\n"
+	"      Number of ways of the directory kept in the tags of the cache. Only\n"
+	"      'Assoc' ways per set hold data, so a larger value is only allowed\n"
+	"      for a cache that is not inclusive.\n"
 	"  EnablePrefetcher = {t|f} (Default = False)\n"
 	"      Whether the hardware should automatically perform prefetching.\n"
 	"      The prefetcher related options below will be ignored if this is\n"
 	"      not true.\n"
-	"  PrefetcherType = {GHB_PC_CS|GHB_PC_DC} (Default GHB_PC_CS)\n"
-	"      Specify the type of global history buffer based prefetcher to use.\n"
-	"      GHB_PC_CS - Program Counter indexed, Constant Stride.\n"
-	"      GHB_PC_DC - Program Counter indexed, Delta Correlation.\n"
+	"      Prefetching is allowed in caches at any level of the hierarchy.\n"
+	"  PrefetcherType = {GHB_PC_CS|GHB_PC_DC|IP_STRIDE|STREAM|NEXT_LINE|AMPM}\n"
+	"          (Default GHB_PC_CS)\n"
+	"      Specify the type of prefetcher to use.\n"
+	"      GHB_PC_CS - Global history buffer, Program Counter indexed,\n"
+	"          Constant Stride.\n"
+	"      GHB_PC_DC - Global history buffer, Program Counter indexed,\n"
+	"          Delta Correlation.\n"
+	"      IP_STRIDE - Table of strides indexed by Program Counter.\n"
+	"      STREAM - Ascending and descending sequences of misses.\n"
+	"      NEXT_LINE - Blocks following the accessed block.\n"
+	"      AMPM - Access map pattern matching over memory zones.\n"
 	"  PrefetcherGHBSize = <size> (Default = 256)\n"
 	"      The hardware prefetcher does global history buffer based prefetching.\n"
 	"      This option specifies the size of the global history buffer.\n"
 	"  PrefetcherITSize = <size> (Default = 64)\n"
 	"      The hardware prefetcher does global history buffer based prefetching.\n"
-	"      This option specifies the size of the index table used.\n"
+	"      This option specifies the size of the index table used. It is\n"
+	"      also the number of entries of the IP_STRIDE table.\n"
 	"  PrefetcherLookupDepth = <num> (Default = 2)\n"
 	"      This option specifies the history (pattern) depth upto which the\n"
 	"      prefetcher looks at the history to decide when to prefetch.\n"
+	"  PrefetcherStreams = <num> (Default = 16)\n"
+	"      Number of streams tracked by the STREAM prefetcher.\n"
+	"  PrefetcherZones = <num> (Default = 64)\n"
+	"      Number of memory zones tracked by the AMPM prefetcher.\n"
+	"  PrefetcherZoneSize = <bytes> (Default = 2048)\n"
+	"      Size of an AMPM zone. It must be a power of two holding between 2\n"
+	"      and 64 blocks.\n"
+	"  PrefetcherDegree = <num> (Default = 1)\n"
+	"      Number of blocks prefetched every time the prefetcher triggers.\n"
+	"  PrefetcherThrottle = {t|f} (Default = False)\n"
+	"      Adjust the prefetch degree dynamically based on the accuracy and\n"
+	"      lateness of the prefetches. The degree is decreased when less than\n"
+	"      40% of the prefetched blocks are used, and increased when 75% are\n"
+	"      used or when 10% of the used prefetches were late.\n"
+	"  PrefetcherMaxDegree = <num> (Default = 4)\n"
+	"      Maximum prefetch degree reached when throttling.\n"
+	"  PrefetcherInterval = <num> (Default = 256)\n"
+	"      Number of prefetched blocks between adjustments of the degree.\n"
+	"\n"
+	"Section [TLB <name>] defines a translation lookaside buffer. TLBs add the\n"
+	"timing of address translation to the accesses of a CPU entry to the memory\n"
+	"hierarchy (see variables 'DataTLB' and 'InstTLB' in [Entry <name>]\n"
+	"sections). A miss in the last-level TLB walks a two-level page table with\n"
+	"regular loads issued to the memory module accessed by the entry.\n"
+	"\n"
+	"  Sets = <num_sets> (Default = 16)\n"
+	"      Number of sets in the TLB.\n"
+	"  Assoc = <num_ways> (Default = 4)\n"
+	"      TLB associativity. Each entry holds the translation of one page.\n"
+	"  Latency = <cycles> (Default = 1)\n"
+	"      Lookup latency in number of cycles. A value of 0 can be used for a\n"
+	"      TLB accessed in parallel with the cache.\n"
+	"  MSHR = <size> (Default = 4)\n"
+	"      Maximum number of misses resolved simultaneously. Misses to a page\n"
+	"      already being resolved do not use an additional entry.\n"
+	"  LowTLB = <tlb>\n"
+	"      Next-level TLB looked up on a miss. If omitted, misses walk the page\n"
+	"      table.\n"
 	"\n"
 	"Section [Network <net>] defines an internal default interconnect, formed of\n"
 	"a single switch connecting all modules pointing to the network. For every\n"
@@ -237,6 +342,11 @@ char *mem_config_help =
 	"      supporting separate data/instruction caches, this variable can be used\n"
 	"      instead of 'DataModule', 'InstModule', and 'ConstantDataModule' to\n"
 	"      indicate that data and instruction caches are unified.\n"
+	"  DataTLB = <tlb>\n"
+	"  InstTLB = <tlb>\n"
+	"      TLBs used to translate data and instruction accesses, defined in\n"
+	"      [TLB <name>] sections. If omitted, address translation takes no\n"
+	"      time. Only allowed for x86 entries.\n"
 	"\n";
 
 
@@ -285,7 +395,7 @@ static void mem_config_default(struct arch_t *arch, void *user_data)
 	Timing *timing;
 
 	/* Only for architectures in detailed simulation */
-	if (arch->sim_kind != arch_sim_kind_detailed)
+	if (arch->sim_kind == arch_sim_kind_functional)
 		return;
 
 	/* Create default configuration */
@@ -303,7 +413,7 @@ static void mem_config_check(struct arch_t *arch, void *user_data)
 	Timing *timing;
 
 	/* Only for architectures in detailed simulation */
-	if (arch->sim_kind != arch_sim_kind_detailed)
+	if (arch->sim_kind == arch_sim_kind_functional)
 		return;
 
 	/* Check configuration */
@@ -337,6 +447,10 @@ static void mem_config_read_general(struct config_t *config)
 	/* Peer transfers */
 	mem_peer_transfers = config_read_bool(config, section, 
 		"PeerTransfers", 1);
+
+	/* Conflict handling */
+	mem_lock_queue = config_read_bool(config, section,
+		"LockQueue", 0);
 }
 
 
@@ -505,13 +619,15 @@ try_external_network:
 
 
 static struct mod_t *mem_config_read_cache(struct config_t *config, 
-	char *section)
+	char *section, int slice)
 {
 	char buf[MAX_STRING_SIZE];
 	char mod_name[MAX_STRING_SIZE];
+	char node_name[MAX_STRING_SIZE];
 
 	int num_sets;
 	int assoc;
+	int dir_assoc;
 	int block_size;
 	int latency;
 	int dir_latency;
@@ -522,12 +638,28 @@ static struct mod_t *mem_config_read_cache(struct config_t *config,
 	int mshr_size;
 	int num_ports;
 
+	int num_slices;
+	char *slice_name;
+	char *slice_hash_str;
+	enum mod_range_hash_t slice_hash;
+	int hop_latency;
+	char *inclusion_str;
+	enum mod_inclusion_t inclusion;
+	int err;
+
 	int enable_prefetcher;
 	char *prefetcher_type_str;
 	enum prefetcher_type_t prefetcher_type;
 	int prefetcher_ghb_size;
 	int prefetcher_it_size;
 	int prefetcher_lookup_depth;
+	int prefetcher_streams;
+	int prefetcher_zones;
+	int prefetcher_zone_size;
+	int prefetcher_degree;
+	int prefetcher_throttle;
+	int prefetcher_max_degree;
+	int prefetcher_interval;
 
 	char *net_name;
 	char *net_node_name;
@@ -556,6 +688,11 @@ static struct mod_t *mem_config_read_cache(struct config_t *config,
 	policy_str = config_read_string(config, buf, "Policy", "LRU");
 	mshr_size = config_read_int(config, buf, "MSHR", 16);
 	num_ports = config_read_int(config, buf, "Ports", 2);
+	num_slices = config_read_int(config, buf, "Slices", 1);
+	slice_hash_str = config_read_string(config, buf, "SliceHash", "Modulo");
+	hop_latency = config_read_int(config, buf, "HopLatency", 0);
+	inclusion_str = config_read_string(config, section, "Inclusion",
+		"Inclusive");
 	enable_prefetcher = config_read_bool(config, buf, 
 		"EnablePrefetcher", 0);
 	prefetcher_type_str = config_read_string(config, buf, 
@@ -566,6 +703,20 @@ static struct mod_t *mem_config_read_cache(struct config_t *config,
 		"PrefetcherITSize", 64);
 	prefetcher_lookup_depth = config_read_int(config, buf, 
 		"PrefetcherLookupDepth", 2);
+	prefetcher_streams = config_read_int(config, buf,
+		"PrefetcherStreams", 16);
+	prefetcher_zones = config_read_int(config, buf,
+		"PrefetcherZones", 64);
+	prefetcher_zone_size = config_read_int(config, buf,
+		"PrefetcherZoneSize", 2048);
+	prefetcher_degree = config_read_int(config, buf,
+		"PrefetcherDegree", 1);
+	prefetcher_throttle = config_read_bool(config, buf,
+		"PrefetcherThrottle", 0);
+	prefetcher_max_degree = config_read_int(config, buf,
+		"PrefetcherMaxDegree", 4);
+	prefetcher_interval = config_read_int(config, buf,
+		"PrefetcherInterval", 256);
 
 	/* Checks */
 	policy = str_map_string_case(&cache_policy_map, policy_str);
@@ -598,6 +749,35 @@ static struct mod_t *mem_config_read_cache(struct config_t *config,
 	if (num_ports < 1)
 		fatal("%s: cache %s: invalid value for variable 'Ports'.\n%s",
 			mem_config_file_name, mod_name, mem_err_config_note);
+	if (num_slices < 1 || (num_slices & (num_slices - 1)))
+		fatal("%s: cache %s: number of slices must be a power of two.\n%s",
+			mem_config_file_name, mod_name, mem_err_config_note);
+	slice_hash = str_map_string_case_err(&mod_range_hash_map,
+		slice_hash_str, &err);
+	if (err)
+		fatal("%s: cache %s: %s: invalid value for variable "
+			"'SliceHash'.\n%s", mem_config_file_name, mod_name,
+			slice_hash_str, mem_err_config_note);
+	if (hop_latency < 0)
+		fatal("%s: cache %s: invalid value for variable 'HopLatency'.\n%s",
+			mem_config_file_name, mod_name, mem_err_config_note);
+	inclusion = str_map_string_case_err(&mod_inclusion_map,
+		inclusion_str, &err);
+	if (err)
+		fatal("%s: cache %s: %s: invalid value for variable "
+			"'Inclusion'.\n%s", mem_config_file_name, mod_name,
+			inclusion_str, mem_err_config_note);
+	dir_assoc = config_read_int(config, buf, "DirectoryAssoc",
+		inclusion == mod_inclusion_inclusive ? assoc : assoc * 2);
+	if (dir_assoc < assoc || (dir_assoc & (dir_assoc - 1)))
+		fatal("%s: cache %s: directory associativity must be a power of "
+			"two and at least 'Assoc'.\n%s", mem_config_file_name,
+			mod_name, mem_err_config_note);
+	if (inclusion == mod_inclusion_inclusive && dir_assoc != assoc)
+		fatal("%s: cache %s: an inclusive cache holds the data of all the\n"
+			"\tblocks in its directory, so 'DirectoryAssoc' must be equal to\n"
+			"\t'Assoc'.\n%s", mem_config_file_name, mod_name,
+			mem_err_config_note);
 	if (enable_prefetcher)
 	{
 		prefetcher_type = str_map_string_case(&prefetcher_type_map, 
@@ -612,23 +792,78 @@ static struct mod_t *mem_config_read_cache(struct config_t *config,
 				mem_config_file_name, mod_name, 
 				mem_err_config_note);
 		}
+		if (prefetcher_streams < 1 || prefetcher_zones < 1 ||
+		    prefetcher_degree < 1 || prefetcher_interval < 1 ||
+		    (prefetcher_throttle && prefetcher_max_degree < prefetcher_degree))
+		{
+			fatal("%s: cache %s: invalid prefetcher "
+				"configuration.\n%s",
+				mem_config_file_name, mod_name, 
+				mem_err_config_note);
+		}
+		if (prefetcher_type == prefetcher_type_ampm &&
+		    ((prefetcher_zone_size & (prefetcher_zone_size - 1)) ||
+		    prefetcher_zone_size < block_size * 2 ||
+		    prefetcher_zone_size > block_size * PREFETCHER_ZONE_BLOCKS_MAX))
+		{
+			fatal("%s: cache %s: AMPM zone size must be a power of two "
+				"holding between 2 and %d blocks.\n%s",
+				mem_config_file_name, mod_name,
+				PREFETCHER_ZONE_BLOCKS_MAX, mem_err_config_note);
+		}
+	}
+
+	/* Slice name. The module of each slice serves the blocks for which
+	 * the slice hash gives its index. */
+	assert(slice < num_slices);
+	slice_name = NULL;
+	if (num_slices > 1)
+	{
+		slice_name = xstrdup(mod_name);
+		snprintf(mod_name, sizeof mod_name, "%s.s%d", slice_name, slice);
 	}
 
 	/* Create module */
 	mod = mod_create(mod_name, mod_kind_cache, num_ports,
 		block_size, latency);
+	mod->hop_latency = hop_latency;
+	mod->inclusion = inclusion;
+	if (num_slices > 1)
+	{
+		mod->slice_name = slice_name;
+		mod->num_slices = num_slices;
+		mod->slice_index = slice;
+		mod->range_kind = mod_range_interleaved;
+		mod->range.interleaved.div = block_size;
+		mod->range.interleaved.mod = num_slices;
+		mod->range.interleaved.eq = slice;
+		mod->range.interleaved.hash = slice_hash;
+	}
 	
 	/* Initialize */
 	mod->mshr_size = mshr_size;
-	mod->dir_assoc = assoc;
+	mod->mshr = xcalloc(mshr_size, sizeof(struct mshr_entry_t));
+	mod->mshr_occupancy = xcalloc(mshr_size + 1, sizeof(long long));
+	mod->data_assoc = assoc;
+	mod->dir_assoc = dir_assoc;
 	mod->dir_num_sets = num_sets;
-	mod->dir_size = num_sets * assoc;
+	mod->dir_size = num_sets * dir_assoc;
 	mod->dir_latency = dir_latency;
 
-	/* High network */
+	/* High network. Slices of a cache in an external network take their
+	 * node from the list of nodes. */
 	net_name = config_read_string(config, section, "HighNetwork", "");
 	net_node_name = config_read_string(config, section, 
 		"HighNetworkNode", "");
+	if (num_slices > 1 && *net_node_name)
+	{
+		str_token(node_name, sizeof node_name, net_node_name, slice, " ");
+		if (!*node_name)
+			fatal("%s: %s: one node per slice required in "
+				"'HighNetworkNode'.\n%s", mem_config_file_name,
+				mod->slice_name, mem_err_config_note);
+		net_node_name = node_name;
+	}
 	mem_config_insert_module_in_network(config, mod, net_name, net_node_name,
 		&net, &net_node);
 	mod->high_net = net;
@@ -638,21 +873,36 @@ static struct mod_t *mem_config_read_cache(struct config_t *config,
 	net_name = config_read_string(config, section, "LowNetwork", "");
 	net_node_name = config_read_string(config, section, 
 		"LowNetworkNode", "");
+	if (num_slices > 1 && *net_node_name)
+	{
+		str_token(node_name, sizeof node_name, net_node_name, slice, " ");
+		if (!*node_name)
+			fatal("%s: %s: one node per slice required in "
+				"'LowNetworkNode'.\n%s", mem_config_file_name,
+				mod->slice_name, mem_err_config_note);
+		net_node_name = node_name;
+	}
 	mem_config_insert_module_in_network(config, mod, net_name, 
 		net_node_name, &net, &net_node);
 	mod->low_net = net;
 	mod->low_net_node = net_node;
 
 	/* Create cache */
-	mod->cache = cache_create(mod->name, num_sets, block_size, assoc, 
+	mod->cache = cache_create(mod->name, num_sets, block_size, dir_assoc,
 		policy);
 
 	/* Fill in prefetcher parameters */
 	if (enable_prefetcher)
 	{
-		mod->cache->prefetcher = prefetcher_create(prefetcher_ghb_size, 
-			prefetcher_it_size, prefetcher_lookup_depth, 
-			prefetcher_type);
+		mod->cache->prefetcher = prefetcher_create(prefetcher_type,
+			block_size, prefetcher_ghb_size, prefetcher_it_size,
+			prefetcher_lookup_depth, prefetcher_streams,
+			prefetcher_zones, prefetcher_zone_size);
+		mod->cache->prefetcher->degree = prefetcher_degree;
+		mod->cache->prefetcher->max_degree = prefetcher_throttle ?
+			prefetcher_max_degree : prefetcher_degree;
+		mod->cache->prefetcher->throttle_interval = prefetcher_throttle ?
+			prefetcher_interval : 0;
 	}
 
 	/* Return */
@@ -716,6 +966,7 @@ static struct mod_t *mem_config_read_main_memory(struct config_t *config,
 	/* Store directory size */
 	mod->dir_size = dir_size;
 	mod->dir_assoc = dir_assoc;
+	mod->data_assoc = dir_assoc;
 	mod->dir_num_sets = dir_size / dir_assoc;
 
 	/* High network */
@@ -746,6 +997,16 @@ static void mem_config_read_module_address_range(struct config_t *config,
 
 	/* Read address range */
 	range_str = config_read_string(config, section, "AddressRange", "");
+	if (mod->slice_name)
+	{
+		/* Range given by the slice index */
+		if (*range_str)
+			fatal("%s: %s: variable 'AddressRange' not allowed for "
+				"a cache with several slices.\n%s",
+				mem_config_file_name, mod->slice_name,
+				mem_err_config_note);
+		return;
+	}
 	if (!*range_str)
 	{
 		mod->range_kind = mod_range_bounds;
@@ -846,6 +1107,26 @@ static void mem_config_read_module_address_range(struct config_t *config,
 		if (mod->range.interleaved.eq >= mod->range.interleaved.mod)
 			goto invalid_format;
 
+		/* Optional tokens 'HASH <hash>' */
+		mod->range.interleaved.hash = mod_range_hash_modulo;
+		if ((token = strtok(NULL, delim)))
+		{
+			if (strcasecmp(token, "HASH"))
+				goto invalid_format;
+			if (!(token = strtok(NULL, delim)))
+				goto invalid_format;
+			if (!strcasecmp(token, "XOR"))
+				mod->range.interleaved.hash = mod_range_hash_xor;
+			else if (strcasecmp(token, "MODULO"))
+				goto invalid_format;
+			if (mod->range.interleaved.hash == mod_range_hash_xor &&
+				(mod->range.interleaved.mod &
+				(mod->range.interleaved.mod - 1)))
+				fatal("%s: %s: value for <mod> must be a power of two "
+					"with 'HASH XOR'.\n%s", mem_config_file_name,
+					mod->name, mem_err_config_note);
+		}
+
 		/* No more tokens */
 		if ((token = strtok(NULL, delim)))
 			goto invalid_format;
@@ -875,6 +1156,7 @@ static void mem_config_read_modules(struct config_t *config)
 
 	char buf[MAX_STRING_SIZE];
 	char mod_name[MAX_STRING_SIZE];
+	int slice;
 	int i;
 
 	/* Create modules */
@@ -886,24 +1168,34 @@ static void mem_config_read_modules(struct config_t *config)
 		if (strncasecmp(section, "Module ", 7))
 			continue;
 
-		/* Create module, depending on the type. */
+		/* Create module, depending on the type. A cache with several
+		 * slices creates one module per slice. */
 		str_token(mod_name, sizeof mod_name, section, 1, " ");
 		mod_type = config_read_string(config, section, "Type", "");
-		if (!strcasecmp(mod_type, "Cache"))
-			mod = mem_config_read_cache(config, section);
-		else if (!strcasecmp(mod_type, "MainMemory"))
-			mod = mem_config_read_main_memory(config, section);
-		else
+		if (strcasecmp(mod_type, "Cache") &&
+				strcasecmp(mod_type, "MainMemory"))
 			fatal("%s: %s: invalid or missing value for 'Type'.\n%s",
 				mem_config_file_name, mod_name,
 				mem_err_config_note);
-
-		/* Read module address range */
-		mem_config_read_module_address_range(config, mod, section);
-
-		/* Add module */
-		list_add(mem_system->mod_list, mod);
-		mem_debug("\t%s\n", mod_name);
+		slice = 0;
+		do
+		{
+			if (!strcasecmp(mod_type, "Cache"))
+				mod = mem_config_read_cache(config, section, slice);
+			else
+				mod = mem_config_read_main_memory(config, section);
+
+			/* Read module address range */
+			mem_config_read_module_address_range(config, mod, section);
+
+			/* Forwarding of shared blocks */
+			mod->forward_state = config_read_bool(config, section,
+				"ForwardState", 0);
+
+			/* Add module */
+			list_add(mem_system->mod_list, mod);
+			mem_debug("\t%s\n", mod->name);
+		} while (++slice < mod->num_slices);
 	}
 
 	/* Debug */
@@ -914,9 +1206,13 @@ static void mem_config_read_modules(struct config_t *config)
 	 * sections.  Also check integrity of sections. */
 	for (i = 0; i < list_count(mem_system->mod_list); i++)
 	{
-		/* Get module and section */
+		/* Get module and section. The section of a sliced cache points
+		 * to its first slice. */
 		mod = list_get(mem_system->mod_list, i);
-		snprintf(buf, sizeof buf, "Module %s", mod->name);
+		if (mod->slice_index)
+			continue;
+		snprintf(buf, sizeof buf, "Module %s", mod->slice_name ?
+			mod->slice_name : mod->name);
 		assert(config_section_exists(config, buf));
 		config_write_ptr(config, buf, "ptr", mod);
 	}
@@ -974,6 +1270,7 @@ static void mem_config_read_low_modules(struct config_t *config)
 	struct mod_t *mod;
 	struct mod_t *low_mod;
 
+	int slice;
 	int i;
 
 	/* Lower level modules */
@@ -985,7 +1282,8 @@ static void mem_config_read_low_modules(struct config_t *config)
 			continue;
 
 		/* Section name */
-		snprintf(buf, sizeof buf, "Module %s", mod->name);
+		snprintf(buf, sizeof buf, "Module %s", mod->slice_name ?
+			mod->slice_name : mod->name);
 		assert(config_section_exists(config, buf));
 
 		/* Low module name list */
@@ -1007,11 +1305,17 @@ static void mem_config_read_low_modules(struct config_t *config)
 					mem_config_file_name, mod->name,
 					mem_err_config_note);
 
-			/* Get low cache and assign */
+			/* Get low cache and assign. The slices of a sliced cache
+			 * follow its first slice in the module list. */
 			low_mod = config_read_ptr(config, buf, "ptr", NULL);
-			assert(low_mod);
-			linked_list_add(mod->low_mod_list, low_mod);
-			linked_list_add(low_mod->high_mod_list, mod);
+			assert(low_mod && !low_mod->slice_index);
+			slice = list_index_of(mem_system->mod_list, low_mod);
+			do
+			{
+				low_mod = list_get(mem_system->mod_list, slice++);
+				linked_list_add(mod->low_mod_list, low_mod);
+				linked_list_add(low_mod->high_mod_list, mod);
+			} while (low_mod->slice_index + 1 < low_mod->num_slices);
 		}
 
 		/* Free copy of low module name list */
@@ -1029,6 +1333,101 @@ static void mem_config_read_low_modules(struct config_t *config)
 }
 
 
+static void mem_config_read_tlbs(struct config_t *config)
+{
+	struct tlb_t *tlb;
+	struct tlb_t *low_tlb;
+
+	char *section;
+	char *low_tlb_name;
+
+	char buf[MAX_STRING_SIZE];
+	char tlb_name[MAX_STRING_SIZE];
+
+	int num_sets;
+	int assoc;
+	int latency;
+	int mshr_size;
+
+	int level;
+	int i;
+
+	/* Create TLBs */
+	mem_debug("Creating TLBs:\n");
+	for (section = config_section_first(config); section;
+		section = config_section_next(config))
+	{
+		/* Section for a TLB */
+		if (strncasecmp(section, "TLB ", 4))
+			continue;
+
+		/* Read values */
+		str_token(tlb_name, sizeof tlb_name, section, 1, " ");
+		num_sets = config_read_int(config, section, "Sets", 16);
+		assoc = config_read_int(config, section, "Assoc", 4);
+		latency = config_read_int(config, section, "Latency", 1);
+		mshr_size = config_read_int(config, section, "MSHR", 4);
+		config_var_allow(config, section, "LowTLB");
+
+		/* Checks */
+		if (mem_system_get_tlb(tlb_name))
+			fatal("%s: TLB %s: duplicate TLB name.\n%s",
+				mem_config_file_name, tlb_name, mem_err_config_note);
+		if (num_sets < 1 || (num_sets & (num_sets - 1)))
+			fatal("%s: TLB %s: number of sets must be a power of two "
+				"greater than 1.\n%s", mem_config_file_name, tlb_name,
+				mem_err_config_note);
+		if (assoc < 1 || (assoc & (assoc - 1)))
+			fatal("%s: TLB %s: associativity must be power of two "
+				"and > 1.\n%s", mem_config_file_name, tlb_name,
+				mem_err_config_note);
+		if (latency < 0)
+			fatal("%s: TLB %s: invalid value for variable 'Latency'.\n%s",
+				mem_config_file_name, tlb_name, mem_err_config_note);
+		if (mshr_size < 1)
+			fatal("%s: TLB %s: invalid value for variable 'MSHR'.\n%s",
+				mem_config_file_name, tlb_name, mem_err_config_note);
+
+		/* Create TLB */
+		tlb = tlb_create(tlb_name, num_sets, assoc, latency, mshr_size);
+		list_add(mem_system->tlb_list, tlb);
+		mem_debug("\t%s\n", tlb_name);
+	}
+
+	/* Debug */
+	mem_debug("\n");
+
+	/* Lower level TLBs. This needs to be done once all TLBs have been
+	 * created, since they can be declared in any order. */
+	for (i = 0; i < list_count(mem_system->tlb_list); i++)
+	{
+		tlb = list_get(mem_system->tlb_list, i);
+		snprintf(buf, sizeof buf, "TLB %s", tlb->name);
+		assert(config_section_exists(config, buf));
+		low_tlb_name = config_read_string(config, buf, "LowTLB", "");
+		if (!*low_tlb_name)
+			continue;
+
+		/* Get low TLB */
+		tlb->low_tlb = mem_system_get_tlb(low_tlb_name);
+		if (!tlb->low_tlb)
+			fatal("%s: TLB %s: invalid TLB name in variable 'LowTLB'.\n%s",
+				mem_config_file_name, tlb->name, mem_err_config_note);
+	}
+
+	/* Check that TLB levels form no cycles */
+	for (i = 0; i < list_count(mem_system->tlb_list); i++)
+	{
+		tlb = list_get(mem_system->tlb_list, i);
+		for (low_tlb = tlb->low_tlb, level = 1; low_tlb;
+			low_tlb = low_tlb->low_tlb, level++)
+			if (low_tlb == tlb || level > list_count(mem_system->tlb_list))
+				fatal("%s: TLB %s: cycle in 'LowTLB' chain.\n%s",
+					mem_config_file_name, tlb->name, mem_err_config_note);
+	}
+}
+
+
 static void mem_config_read_entries(struct config_t *config)
 {
 	char *section;
@@ -1295,6 +1694,49 @@ static void mem_config_check_disjoint(struct arch_t *arch, void *user_data)
 }
 
 
+static void mem_config_check_inclusion_arch(struct arch_t *arch,
+		void *user_data)
+{
+	struct mod_t *mod;
+
+	/* Entries to memory are accessed without a directory above them */
+	LINKED_LIST_FOR_EACH(arch->mem_entry_mod_list)
+	{
+		mod = linked_list_get(arch->mem_entry_mod_list);
+		if (mod->inclusion != mod_inclusion_inclusive)
+			fatal("%s: %s: a cache accessed by %s must be inclusive.\n%s",
+				mem_config_file_name, mod->name, arch->name,
+				mem_err_config_note);
+	}
+}
+
+
+static void mem_config_check_inclusion(void)
+{
+	struct mod_t *mod;
+	struct mod_t *high_mod;
+	int i;
+
+	/* A cache that is not inclusive relies on its higher-level modules to
+	 * hold the data of the blocks it only keeps in its directory. */
+	arch_for_each(mem_config_check_inclusion_arch, NULL);
+	for (i = 0; i < list_count(mem_system->mod_list); i++)
+	{
+		mod = list_get(mem_system->mod_list, i);
+		if (mod->inclusion == mod_inclusion_inclusive)
+			continue;
+		LINKED_LIST_FOR_EACH(mod->high_mod_list)
+		{
+			high_mod = linked_list_get(mod->high_mod_list);
+			if (high_mod->inclusion != mod_inclusion_inclusive)
+				fatal("%s: %s: higher-level module %s must be inclusive.\n%s",
+					mem_config_file_name, mod->name, high_mod->name,
+					mem_err_config_note);
+		}
+	}
+}
+
+
 static void mem_config_calculate_sub_block_sizes(void)
 {
 	struct mod_t *mod;
@@ -1541,6 +1983,9 @@ void mem_config_read(void)
 	/* Read low level caches */
 	mem_config_read_low_modules(config);
 
+	/* Read TLBs */
+	mem_config_read_tlbs(config);
+
 	/* Read entries from requesting devices (CPUs/GPUs) to memory system entries.
 	 * This is presented in [Entry <name>] sections in the configuration file. */
 	mem_config_read_entries(config);
@@ -1563,6 +2008,9 @@ void mem_config_read(void)
 	if (!si_gpu_fused_device)
 		arch_for_each(mem_config_check_disjoint, NULL);
 
+	/* Check the inclusion policy of caches and their higher-level modules */
+	mem_config_check_inclusion();
+
 	/* Compute sub-block sizes, based on high modules. This function also
 	 * initializes the directories in modules other than L1. */
 	mem_config_calculate_sub_block_sizes();
@@ -71,6 +71,7 @@ struct dir_t *dir_create(char *name, int xsize, int ysize, int zsize, int num_no
 			{
 				dir_entry = dir_entry_get(dir, x, y, z);
 				dir_entry->owner = DIR_ENTRY_OWNER_NONE;
+				dir_entry->forwarder = DIR_ENTRY_OWNER_NONE;
 			}
 		}
 	}
@@ -126,6 +127,25 @@ void dir_entry_set_owner(struct dir_t *dir, int x, int y, int z, int node)
 }
 
 
+/* Designate a sharer of the block as its forwarder, the only one answering
+ * read misses with a copy of the block (F state of MESIF). The forwarder is
+ * dropped when it stops being a sharer. */
+void dir_entry_set_forwarder(struct dir_t *dir, int x, int y, int z, int node)
+{
+	struct dir_entry_t *dir_entry;
+
+	/* Set forwarder */
+	assert(node == DIR_ENTRY_OWNER_NONE || IN_RANGE(node, 0, dir->num_nodes - 1));
+	dir_entry = dir_entry_get(dir, x, y, z);
+	assert(node == DIR_ENTRY_OWNER_NONE || dir_entry_is_sharer(dir, x, y, z, node));
+	dir_entry->forwarder = node;
+
+	/* Trace */
+	mem_trace("mem.set_forwarder dir=\"%s\" x=%d y=%d z=%d forwarder=%d\n",
+		dir->name, x, y, z, node);
+}
+
+
 void dir_entry_set_sharer(struct dir_t *dir, int x, int y, int z, int node)
 {
 	struct dir_entry_t *dir_entry;
@@ -161,6 +181,8 @@ void dir_entry_clear_sharer(struct dir_t *dir, int x, int y, int z, int node)
 	dir_entry->sharer[node / 8] &= ~(1 << (node % 8));
 	assert(dir_entry->num_sharers > 0);
 	dir_entry->num_sharers--;
+	if (dir_entry->forwarder == node)
+		dir_entry->forwarder = DIR_ENTRY_OWNER_NONE;
 
 	/* Debug */
 	mem_trace("mem.clear_sharer dir=\"%s\" x=%d y=%d z=%d sharer=%d\n",
@@ -176,6 +198,7 @@ void dir_entry_clear_all_sharers(struct dir_t *dir, int x, int y, int z)
 	/* Clear sharers */
 	dir_entry = dir_entry_get(dir, x, y, z);
 	dir_entry->num_sharers = 0;
+	dir_entry->forwarder = DIR_ENTRY_OWNER_NONE;
 	for (i = 0; i < DIR_ENTRY_SHARERS_SIZE; i++)
 		dir_entry->sharer[i] = 0;
 
@@ -294,6 +317,42 @@ int dir_entry_lock(struct dir_t *dir, int x, int y, int event, struct mod_stack_
 }
 
 
+/* Enqueue an access at the end of the lock queue of a directory entry
+ * without trying to lock it. The access is resumed with 'event' when the
+ * current owner releases the lock. If the entry is not locked, nothing is
+ * done and the function returns 0. */
+int dir_entry_wait(struct dir_t *dir, int x, int y, int event, struct mod_stack_t *stack)
+{
+	struct dir_lock_t *dir_lock;
+	struct mod_stack_t *lock_queue_iter;
+
+	/* Get lock */
+	assert(x < dir->xsize && y < dir->ysize);
+	dir_lock = &dir->dir_lock[x * dir->ysize + y];
+	if (!dir_lock->lock)
+		return 0;
+
+	/* Enqueue the stack to the end of the lock queue */
+	stack->dir_lock_next = NULL;
+	stack->dir_lock_event = event;
+	stack->lock_retry = 1;
+	if (!dir_lock->lock_queue)
+	{
+		dir_lock->lock_queue = stack;
+	}
+	else
+	{
+		lock_queue_iter = dir_lock->lock_queue;
+		while (lock_queue_iter->dir_lock_next)
+			lock_queue_iter = lock_queue_iter->dir_lock_next;
+		lock_queue_iter->dir_lock_next = stack;
+	}
+	mem_debug("    A-%lld waiting for %s x=%d, y=%d to be unlocked\n",
+		stack->id, dir->name, x, y);
+	return 1;
+}
+
+
 void dir_entry_unlock(struct dir_t *dir, int x, int y)
 {
 	struct dir_lock_t *dir_lock;
@@ -323,9 +382,18 @@ void dir_entry_unlock(struct dir_t *dir, int x, int y)
 			mem_debug("\n");
 		}
 
-		/* Wake up access */
-		esim_schedule_event(dir_lock->lock_queue->dir_lock_event, dir_lock->lock_queue, 1);
-		dir_lock->lock_queue = dir_lock->lock_queue->dir_lock_next;
+		/* Wake up access. Accesses queued with 'dir_entry_wait' do not
+		 * take the lock when resumed, so the waiters behind them are woken
+		 * up as well, up to the first one that does. */
+		do
+		{
+			stack = dir_lock->lock_queue;
+			esim_schedule_event(stack->dir_lock_event, stack, 1);
+			dir_lock->lock_queue = stack->dir_lock_next;
+			if (!stack->lock_retry)
+				break;
+			stack->lock_retry = 0;
+		} while (dir_lock->lock_queue);
 	}
 
 	/* Trace */
@@ -30,10 +30,12 @@ struct dir_lock_t
 
 #define DIR_ENTRY_OWNER_NONE  (-1)
 #define DIR_ENTRY_VALID_OWNER(dir_entry)  ((dir_entry)->owner >= 0)
+#define DIR_ENTRY_VALID_FORWARDER(dir_entry)  ((dir_entry)->forwarder >= 0)
 
 struct dir_entry_t
 {
 	int owner;  /* Node owning the block (-1 = No owner)*/
+	int forwarder;  /* Sharer supplying the block on read misses (-1 = None) */
 	int num_sharers;  /* Number of 1s in next field */
 	unsigned char sharer[0];  /* Bitmap of sharers (must be last field) */
 };
@@ -68,6 +70,7 @@ void dir_free(struct dir_t *dir);
 struct dir_entry_t *dir_entry_get(struct dir_t *dir, int x, int y, int z);
 
 void dir_entry_set_owner(struct dir_t *dir, int x, int y, int z, int node);
+void dir_entry_set_forwarder(struct dir_t *dir, int x, int y, int z, int node);
 void dir_entry_set_sharer(struct dir_t *dir, int x, int y, int z, int node);
 void dir_entry_clear_sharer(struct dir_t *dir, int x, int y, int z, int node);
 void dir_entry_clear_all_sharers(struct dir_t *dir, int x, int y, int z);
@@ -78,6 +81,7 @@ void dir_entry_dump_sharers(struct dir_t *dir, int x, int y, int z);
 
 struct dir_lock_t *dir_lock_get(struct dir_t *dir, int x, int y);
 int dir_entry_lock(struct dir_t *dir, int x, int y, int event, struct mod_stack_t *stack);
+int dir_entry_wait(struct dir_t *dir, int x, int y, int event, struct mod_stack_t *stack);
 void dir_entry_unlock(struct dir_t *dir, int x, int y);
 
 
@@ -55,6 +55,9 @@ void mod_handler_local_mem_load(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_LOCAL_MEM_LOAD)
 	{
 		struct mod_stack_t *master_stack;
@@ -72,7 +75,7 @@ void mod_handler_local_mem_load(int event, void *data)
 		master_stack = mod_can_coalesce(mod, mod_access_load, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->reads++;
+			mod->stats.reads++;
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_LOCAL_MEM_LOAD_FINISH);
 			return;
@@ -157,6 +160,9 @@ void mod_handler_local_mem_store(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_LOCAL_MEM_STORE)
 	{
 		struct mod_stack_t *master_stack;
@@ -174,7 +180,7 @@ void mod_handler_local_mem_store(int event, void *data)
 		master_stack = mod_can_coalesce(mod, mod_access_store, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->writes++;
+			mod->stats.writes++;
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_LOCAL_MEM_STORE_FINISH);
 
@@ -256,6 +262,9 @@ void mod_handler_local_mem_find_and_lock(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_LOCAL_MEM_FIND_AND_LOCK)
 	{
 		mem_debug("  %lld %lld 0x%x %s find and lock\n",
@@ -281,16 +290,16 @@ void mod_handler_local_mem_find_and_lock(int event, void *data)
 		ret->port_locked = 1;
 
 		/* Statistics */
-		mod->accesses++;
+		mod->stats.accesses++;
 		if (stack->read)
 		{
-			mod->reads++;
-			mod->effective_reads++;
+			mod->stats.reads++;
+			mod->stats.effective_reads++;
 		}
 		else
 		{
-			mod->writes++;
-			mod->effective_writes++;
+			mod->stats.writes++;
+			mod->stats.effective_writes++;
 
 			/* Increment witness variable when port is locked */
 			if (stack->witness_ptr)
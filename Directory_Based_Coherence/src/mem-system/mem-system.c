@@ -16,13 +16,17 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <assert.h>
+
 #include <arch/common/arch.h>
 #include <lib/esim/esim.h>
 #include <lib/esim/trace.h>
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/debug.h>
 #include <lib/util/file.h>
+#include <lib/util/linked-list.h>
 #include <lib/util/list.h>
+#include <lib/util/misc.h>
 #include <lib/util/string.h>
 #include <network/network.h>
 #include <network/node.h>
@@ -31,8 +35,11 @@
 #include "config.h"
 #include "local-mem-protocol.h"
 #include "mem-system.h"
+#include "mod-stack.h"
 #include "module.h"
 #include "nmoesi-protocol.h"
+#include "prefetcher.h"
+#include "tlb.h"
 
 
 /*
@@ -42,6 +49,7 @@
 int mem_debug_category;
 int mem_trace_category;
 int mem_peer_transfers;
+int mem_lock_queue;
 
 /* Frequency domain, as returned by function 'esim_new_domain'. */
 int mem_frequency = 1000;
@@ -49,6 +57,11 @@ int mem_domain_index;
 
 struct mem_system_t *mem_system;
 
+/* Debug and trace filter, given as a list of '<module>[:<addr>[-<addr>]]' */
+char *mem_debug_filter = "";
+struct list_t *mem_filter_list;
+int mem_filter_pass = 1;
+
 char *mem_report_file_name = "";
 // This file contains all the information related to latency counters.
 char *mem_report_file_name_latency_counter;
@@ -82,6 +95,7 @@ struct mem_system_t *mem_system_create(void)
 	mem_system = xcalloc(1, sizeof(struct mem_system_t));
 	mem_system->net_list = list_create();
 	mem_system->mod_list = list_create();
+	mem_system->tlb_list = list_create();
 
 	/* Return */
 	return mem_system;
@@ -95,6 +109,11 @@ void mem_system_free(struct mem_system_t *mem_system)
 		mod_free(list_pop(mem_system->mod_list));
 	list_free(mem_system->mod_list);
 
+	/* Free TLBs */
+	while (list_count(mem_system->tlb_list))
+		tlb_free(list_pop(mem_system->tlb_list));
+	list_free(mem_system->tlb_list);
+
 	/* Free networks */
 	while (list_count(mem_system->net_list))
 		net_free(list_pop(mem_system->net_list));
@@ -107,6 +126,130 @@ void mem_system_free(struct mem_system_t *mem_system)
 
 
 
+/*
+ * Debug and Trace Filter
+ */
+
+static char *mem_err_filter =
+	"\tThe debug filter is a comma-separated list of entries with format\n"
+	"\t'<module>[:<addr>[-<addr>]]'. The module can be '*' to match any module.\n"
+	"\tA single address selects the block containing it, and two addresses an\n"
+	"\tinclusive range, e.g. 'mod-l2:0x1f40' or '*:0x1000-0x1fff'.\n";
+
+static void mem_filter_create(void)
+{
+	struct list_t *token_list;
+	struct mem_filter_t *filter;
+	char *token;
+	char *range;
+	char *high;
+	char *end;
+	int i;
+
+	/* No filter */
+	if (!*mem_debug_filter)
+		return;
+
+	/* Read entries */
+	mem_filter_list = list_create();
+	token_list = str_token_list_create(mem_debug_filter, ",");
+	LIST_FOR_EACH(token_list, i)
+	{
+		/* Module */
+		token = list_get(token_list, i);
+		filter = xcalloc(1, sizeof(struct mem_filter_t));
+		range = strchr(token, ':');
+		if (range)
+			*range++ = '\0';
+		if (strcmp(token, "*"))
+		{
+			filter->mod = mem_system_get_mod(token);
+			if (!filter->mod)
+				fatal("%s: invalid module in debug filter.\n%s",
+					token, mem_err_filter);
+		}
+
+		/* Address or address range */
+		if (range)
+		{
+			filter->has_range = 1;
+			high = strchr(range, '-');
+			if (high)
+				*high++ = '\0';
+			filter->low = strtoul(range, &end, 0);
+			if (!*range || *end)
+				fatal("%s: invalid address in debug filter.\n%s",
+					range, mem_err_filter);
+			filter->high = filter->low;
+			filter->block = !high;
+			if (high)
+			{
+				filter->high = strtoul(high, &end, 0);
+				if (!*high || *end || filter->high < filter->low)
+					fatal("%s: invalid address range in debug filter.\n%s",
+						high, mem_err_filter);
+			}
+		}
+
+		/* Add */
+		list_add(mem_filter_list, filter);
+	}
+	str_token_list_free(token_list);
+}
+
+
+static void mem_filter_free(void)
+{
+	int i;
+
+	if (!mem_filter_list)
+		return;
+	LIST_FOR_EACH(mem_filter_list, i)
+		free(list_get(mem_filter_list, i));
+	list_free(mem_filter_list);
+	mem_filter_list = NULL;
+}
+
+
+static int mem_filter_entry_match(struct mem_filter_t *filter, struct mod_t *mod,
+	unsigned int addr)
+{
+	unsigned int mask;
+
+	if (!mod || (filter->mod && filter->mod != mod))
+		return 0;
+	if (!filter->has_range)
+		return 1;
+	if (filter->block)
+	{
+		mask = ~(mod->block_size - 1);
+		return (addr & mask) == (filter->low & mask);
+	}
+	return addr >= filter->low && addr <= filter->high;
+}
+
+
+/* Return true if the debug and trace output of the handler processing
+ * 'stack' passes the filter, i.e., if an entry matches the address of the
+ * access and the module processing it or the target module of a request. */
+int mem_filter_match(struct mod_stack_t *stack)
+{
+	struct mem_filter_t *filter;
+	int i;
+
+	LIST_FOR_EACH(mem_filter_list, i)
+	{
+		filter = list_get(mem_filter_list, i);
+		if (mem_filter_entry_match(filter, stack->mod, stack->addr) ||
+			mem_filter_entry_match(filter, stack->target_mod, stack->addr))
+			return 1;
+	}
+	return 0;
+}
+
+
+
+
 /*
  * Public Functions
  */
@@ -141,6 +284,12 @@ void mem_system_init(void)
 	 * function generates the trace headers. */
 	mem_trace_category = trace_new_category();
 
+	/* Debug and trace output was compiled out */
+#ifdef NTRACE
+	if (mem_debug_category || mem_trace_category)
+		warning("memory system debug and trace output disabled at build time");
+#endif
+
 	/* Create global memory system. This needs to be done before reading the
 	 * memory configuration file with 'mem_config_read', since the latter
 	 * function inserts caches and networks in 'mem_system', and relies on
@@ -150,6 +299,9 @@ void mem_system_init(void)
 	/* Read memory configuration file */
 	mem_config_read();
 
+	/* Debug and trace filter, referring to modules by name */
+	mem_filter_create();
+
 	mem_append_file_name(mem_report_file_name_latency_counter, mem_report_file_name, "_latency_counter");
 	mem_append_file_name(mem_report_file_name_state_transition, mem_report_file_name, "_state_transition");
 	mem_append_file_name(mem_report_file_name_access_statistics, mem_report_file_name, "_access_statistics");
@@ -251,6 +403,8 @@ void mem_system_init(void)
 			mem_domain_index, "mod_nmoesi_evict_process");
 	EV_MOD_NMOESI_EVICT_PROCESS_NONCOHERENT = esim_register_event_with_name(mod_handler_nmoesi_evict,
 			mem_domain_index, "mod_nmoesi_evict_process_noncoherent");
+	EV_MOD_NMOESI_EVICT_WRITE_THROUGH = esim_register_event_with_name(mod_handler_nmoesi_evict,
+			mem_domain_index, "mod_nmoesi_evict_write_through");
 	EV_MOD_NMOESI_EVICT_REPLY = esim_register_event_with_name(mod_handler_nmoesi_evict,
 			mem_domain_index, "mod_nmoesi_evict_reply");
 	EV_MOD_NMOESI_EVICT_REPLY = esim_register_event_with_name(mod_handler_nmoesi_evict,
@@ -329,6 +483,23 @@ void mem_system_init(void)
 	EV_MOD_NMOESI_MESSAGE_FINISH = esim_register_event_with_name(mod_handler_nmoesi_message,
 			mem_domain_index, "mod_nmoesi_message_finish");
 
+	/* TLB event-driven simulation */
+
+	EV_TLB_ACCESS = esim_register_event_with_name(tlb_handler,
+			mem_domain_index, "tlb_access");
+	EV_TLB_LOOKUP = esim_register_event_with_name(tlb_handler,
+			mem_domain_index, "tlb_lookup");
+	EV_TLB_MISS = esim_register_event_with_name(tlb_handler,
+			mem_domain_index, "tlb_miss");
+	EV_TLB_WALK = esim_register_event_with_name(tlb_handler,
+			mem_domain_index, "tlb_walk");
+	EV_TLB_WALK_REPLY = esim_register_event_with_name(tlb_handler,
+			mem_domain_index, "tlb_walk_reply");
+	EV_TLB_FILL = esim_register_event_with_name(tlb_handler,
+			mem_domain_index, "tlb_fill");
+	EV_TLB_FINISH = esim_register_event_with_name(tlb_handler,
+			mem_domain_index, "tlb_finish");
+
 	/* Local memory event driven simulation */
 
 	EV_MOD_LOCAL_MEM_LOAD = esim_register_event_with_name(mod_handler_local_mem_load,
@@ -361,6 +532,9 @@ void mem_system_done(void)
 	/* Dump report */
 	mem_system_dump_report();
 
+	/* Free debug and trace filter */
+	mem_filter_free();
+
 	/* Free memory system */
 	mem_system_free(mem_system);
 }
@@ -400,6 +574,8 @@ void mem_system_dump_report(void)
 	fprintf(f, ";    Evictions - Invalidated or replaced cache blocks\n");
 	fprintf(f, ";    Retries - For L1 caches, accesses that were retried\n");
 	fprintf(f, ";    ReadRetries, WriteRetries, NCWriteRetries - Read/Write retried accesses\n");
+	fprintf(f, ";    QueuedRetries - With lock queues, retries resumed by the unlock of the\n");
+	fprintf(f, ";        contended block instead of after a random latency\n");
 	fprintf(f, ";    NoRetryAccesses - Number of accesses that were not retried\n");
 	fprintf(f, ";    NoRetryHits, NoRetryMisses - Hits and misses for not retried accesses\n");
 	fprintf(f, ";    NoRetryHitRatio - NoRetryHits divided by NoRetryAccesses\n");
@@ -407,6 +583,25 @@ void mem_system_dump_report(void)
 	fprintf(f, ";    Reads, Writes, NCWrites - Total read/write accesses\n");
 	fprintf(f, ";    BlockingReads, BlockingWrites, BlockingNCWrites - Reads/writes coming from lower-level cache\n");
 	fprintf(f, ";    NonBlockingReads, NonBlockingWrites, NonBlockingNCWrites - Coming from upper-level cache\n");
+	fprintf(f, ";    MSHRAllocations - Primary misses allocating an MSHR entry\n");
+	fprintf(f, ";    MSHRLoadMerges, MSHRStoreMerges - Secondary misses attached to an MSHR entry\n");
+	fprintf(f, ";    MSHRFullStalls, MSHRFullStallCycles - Misses waiting for a free MSHR entry, and cycles waited\n");
+	fprintf(f, ";    MSHROccupancy - Cycles spent with each number of occupied MSHR entries\n");
+	fprintf(f, ";    PrefetcherIssued, PrefetcherFills - Prefetches issued by the prefetcher, and blocks they brought\n");
+	fprintf(f, ";    PrefetcherUseful, PrefetcherLate, PrefetcherUnused - Prefetched blocks used by demand accesses,\n");
+	fprintf(f, ";        demanded while in flight, and replaced before use\n");
+	fprintf(f, ";    PrefetcherAccuracy, PrefetcherCoverage - Used fraction of prefetched blocks, and of demand misses\n");
+	fprintf(f, ";        removed by prefetching\n");
+	fprintf(f, ";    PrefetcherDegreeIncreases, PrefetcherDegreeDecreases - Adjustments of the degree by throttling\n");
+	fprintf(f, ";    InclusionVictims - Blocks invalidated in higher-level modules by evictions\n");
+	fprintf(f, ";    VictimFills - For a cache that is not inclusive, blocks allocated for\n");
+	fprintf(f, ";        blocks evicted from higher-level modules\n");
+	fprintf(f, ";    DataRefetches - For a cache that is not inclusive, hits on blocks held in its directory\n");
+	fprintf(f, ";        without their data, read again from the lower-level module\n");
+	fprintf(f, ";    ValidBlocks, DuplicateBlocks - Valid blocks at the end of the simulation,\n");
+	fprintf(f, ";        and those also present in a higher-level module\n");
+	fprintf(f, ";    SliceAccesses - For a sliced cache, accesses to each slice\n");
+	fprintf(f, ";    SliceImbalance - Accesses to the most loaded slice divided by the average per slice\n");
 	fprintf(f, "\n\n");
 	
 	/* Report for each cache */
@@ -428,65 +623,101 @@ void mem_system_dump_report(void)
 		/* Configuration */
 		if (cache) {
 			fprintf(f, "Sets = %d\n", cache->num_sets);
-			fprintf(f, "Assoc = %d\n", cache->assoc);
+			if (mod->inclusion != mod_inclusion_inclusive)
+			{
+				fprintf(f, "Assoc = %d\n", mod->data_assoc);
+				fprintf(f, "DirectoryAssoc = %d\n", cache->assoc);
+			}
+			else
+				fprintf(f, "Assoc = %d\n", cache->assoc);
 			fprintf(f, "Policy = %s\n", str_map_value(&cache_policy_map, cache->policy));
 		}
 		fprintf(f, "BlockSize = %d\n", mod->block_size);
 		fprintf(f, "Latency = %d\n", mod->latency);
+		if (mod->hop_latency)
+			fprintf(f, "HopLatency = %d\n", mod->hop_latency);
+		if (mod->inclusion != mod_inclusion_inclusive)
+			fprintf(f, "Inclusion = %s\n", str_map_value(&mod_inclusion_map,
+				mod->inclusion));
+		if (mod->forward_state)
+			fprintf(f, "ForwardState = True\n");
 		fprintf(f, "Ports = %d\n", mod->num_ports);
+		if (mod->slice_name)
+			fprintf(f, "Slice = %d of %s\n", mod->slice_index, mod->slice_name);
 		fprintf(f, "\n");
 
 		/* Statistics */
-		fprintf(f, "Accesses = %lld\n", mod->accesses);
-		fprintf(f, "Hits = %lld\n", mod->hits);
-		fprintf(f, "Misses = %lld\n", mod->accesses - mod->hits);
-		fprintf(f, "HitRatio = %.4g\n", mod->accesses ?
-			(double) mod->hits / mod->accesses : 0.0);
-		fprintf(f, "Evictions = %lld\n", mod->evictions);
-		fprintf(f, "Retries = %lld\n", mod->read_retries + mod->write_retries + 
-			mod->nc_write_retries);
+		fprintf(f, "Accesses = %lld\n", mod->stats.accesses);
+		fprintf(f, "Hits = %lld\n", mod->stats.hits);
+		fprintf(f, "Misses = %lld\n", mod->stats.accesses - mod->stats.hits);
+		fprintf(f, "HitRatio = %.4g\n", mod->stats.accesses ?
+			(double) mod->stats.hits / mod->stats.accesses : 0.0);
+		fprintf(f, "Evictions = %lld\n", MOD_STAT(mod, evictions));
+		fprintf(f, "Retries = %lld\n", mod->stats.read_retries + mod->stats.write_retries + 
+			mod->stats.nc_write_retries);
+		if (mem_lock_queue)
+			fprintf(f, "QueuedRetries = %lld\n", mod->stats.queued_retries);
 		fprintf(f, "\n");
-		fprintf(f, "Reads = %lld\n", mod->reads);
-		fprintf(f, "ReadRetries = %lld\n", mod->read_retries);
-		fprintf(f, "BlockingReads = %lld\n", mod->blocking_reads);
-		fprintf(f, "NonBlockingReads = %lld\n", mod->non_blocking_reads);
-		fprintf(f, "ReadHits = %lld\n", mod->read_hits);
-		fprintf(f, "ReadMisses = %lld\n", mod->reads - mod->read_hits);
+		fprintf(f, "Reads = %lld\n", mod->stats.reads);
+		fprintf(f, "ReadRetries = %lld\n", mod->stats.read_retries);
+		fprintf(f, "BlockingReads = %lld\n", mod->stats.blocking_reads);
+		fprintf(f, "NonBlockingReads = %lld\n", mod->stats.non_blocking_reads);
+		fprintf(f, "ReadHits = %lld\n", mod->stats.read_hits);
+		fprintf(f, "ReadMisses = %lld\n", mod->stats.reads - mod->stats.read_hits);
 		fprintf(f, "\n");
-		fprintf(f, "Writes = %lld\n", mod->writes);
-		fprintf(f, "WriteRetries = %lld\n", mod->write_retries);
-		fprintf(f, "BlockingWrites = %lld\n", mod->blocking_writes);
-		fprintf(f, "NonBlockingWrites = %lld\n", mod->non_blocking_writes);
-		fprintf(f, "WriteHits = %lld\n", mod->write_hits);
-		fprintf(f, "WriteMisses = %lld\n", mod->writes - mod->write_hits);
+		fprintf(f, "Writes = %lld\n", mod->stats.writes);
+		fprintf(f, "WriteRetries = %lld\n", mod->stats.write_retries);
+		fprintf(f, "BlockingWrites = %lld\n", mod->stats.blocking_writes);
+		fprintf(f, "NonBlockingWrites = %lld\n", mod->stats.non_blocking_writes);
+		fprintf(f, "WriteHits = %lld\n", mod->stats.write_hits);
+		fprintf(f, "WriteMisses = %lld\n", mod->stats.writes - mod->stats.write_hits);
 		fprintf(f, "\n");
-		fprintf(f, "NCWrites = %lld\n", mod->nc_writes);
-		fprintf(f, "NCWriteRetries = %lld\n", mod->nc_write_retries);
-		fprintf(f, "NCBlockingWrites = %lld\n", mod->blocking_nc_writes);
-		fprintf(f, "NCNonBlockingWrites = %lld\n", mod->non_blocking_nc_writes);
-		fprintf(f, "NCWriteHits = %lld\n", mod->nc_write_hits);
-		fprintf(f, "NCWriteMisses = %lld\n", mod->nc_writes - mod->nc_write_hits);
-		fprintf(f, "Prefetches = %lld\n", mod->prefetches);
-		fprintf(f, "PrefetchAborts = %lld\n", mod->prefetch_aborts);
-		fprintf(f, "UselessPrefetches = %lld\n", mod->useless_prefetches);
+		fprintf(f, "NCWrites = %lld\n", mod->stats.nc_writes);
+		fprintf(f, "NCWriteRetries = %lld\n", mod->stats.nc_write_retries);
+		fprintf(f, "NCBlockingWrites = %lld\n", mod->stats.blocking_nc_writes);
+		fprintf(f, "NCNonBlockingWrites = %lld\n", mod->stats.non_blocking_nc_writes);
+		fprintf(f, "NCWriteHits = %lld\n", mod->stats.nc_write_hits);
+		fprintf(f, "NCWriteMisses = %lld\n", mod->stats.nc_writes - mod->stats.nc_write_hits);
+		fprintf(f, "Prefetches = %lld\n", mod->stats.prefetches);
+		fprintf(f, "PrefetchAborts = %lld\n", mod->stats.prefetch_aborts);
+		fprintf(f, "UselessPrefetches = %lld\n", mod->stats.useless_prefetches);
 		fprintf(f, "\n");
-		fprintf(f, "NoRetryAccesses = %lld\n", mod->no_retry_accesses);
-		fprintf(f, "NoRetryHits = %lld\n", mod->no_retry_hits);
-		fprintf(f, "NoRetryMisses = %lld\n", mod->no_retry_accesses - mod->no_retry_hits);
-		fprintf(f, "NoRetryHitRatio = %.4g\n", mod->no_retry_accesses ?
-			(double) mod->no_retry_hits / mod->no_retry_accesses : 0.0);
-		fprintf(f, "NoRetryReads = %lld\n", mod->no_retry_reads);
-		fprintf(f, "NoRetryReadHits = %lld\n", mod->no_retry_read_hits);
-		fprintf(f, "NoRetryReadMisses = %lld\n", (mod->no_retry_reads -
-			mod->no_retry_read_hits));
-		fprintf(f, "NoRetryWrites = %lld\n", mod->no_retry_writes);
-		fprintf(f, "NoRetryWriteHits = %lld\n", mod->no_retry_write_hits);
-		fprintf(f, "NoRetryWriteMisses = %lld\n", mod->no_retry_writes
-			- mod->no_retry_write_hits);
-		fprintf(f, "NoRetryNCWrites = %lld\n", mod->no_retry_nc_writes);
-		fprintf(f, "NoRetryNCWriteHits = %lld\n", mod->no_retry_nc_write_hits);
-		fprintf(f, "NoRetryNCWriteMisses = %lld\n", mod->no_retry_nc_writes
-			- mod->no_retry_nc_write_hits);
+		mod_mshr_dump(mod, f);
+		if (mod->cache && mod->cache->prefetcher)
+			prefetcher_dump(mod->cache->prefetcher, f);
+		if (mod->kind == mod_kind_cache && linked_list_count(mod->high_mod_list))
+		{
+			int valid_blocks;
+			int duplicate_blocks;
+
+			duplicate_blocks = mod_count_duplicate_blocks(mod, &valid_blocks);
+			fprintf(f, "InclusionVictims = %lld\n", mod->stats.inclusion_victims);
+			if (mod->inclusion != mod_inclusion_inclusive)
+			{
+				fprintf(f, "VictimFills = %lld\n", mod->stats.victim_fills);
+				fprintf(f, "DataRefetches = %lld\n", mod->stats.data_refetches);
+			}
+			fprintf(f, "ValidBlocks = %d\n", valid_blocks);
+			fprintf(f, "DuplicateBlocks = %d\n", duplicate_blocks);
+			fprintf(f, "\n");
+		}
+		fprintf(f, "NoRetryAccesses = %lld\n", mod->stats.no_retry_accesses);
+		fprintf(f, "NoRetryHits = %lld\n", mod->stats.no_retry_hits);
+		fprintf(f, "NoRetryMisses = %lld\n", mod->stats.no_retry_accesses - mod->stats.no_retry_hits);
+		fprintf(f, "NoRetryHitRatio = %.4g\n", mod->stats.no_retry_accesses ?
+			(double) mod->stats.no_retry_hits / mod->stats.no_retry_accesses : 0.0);
+		fprintf(f, "NoRetryReads = %lld\n", mod->stats.no_retry_reads);
+		fprintf(f, "NoRetryReadHits = %lld\n", mod->stats.no_retry_read_hits);
+		fprintf(f, "NoRetryReadMisses = %lld\n", (mod->stats.no_retry_reads -
+			mod->stats.no_retry_read_hits));
+		fprintf(f, "NoRetryWrites = %lld\n", mod->stats.no_retry_writes);
+		fprintf(f, "NoRetryWriteHits = %lld\n", mod->stats.no_retry_write_hits);
+		fprintf(f, "NoRetryWriteMisses = %lld\n", mod->stats.no_retry_writes
+			- mod->stats.no_retry_write_hits);
+		fprintf(f, "NoRetryNCWrites = %lld\n", mod->stats.no_retry_nc_writes);
+		fprintf(f, "NoRetryNCWriteHits = %lld\n", mod->stats.no_retry_nc_write_hits);
+		fprintf(f, "NoRetryNCWriteMisses = %lld\n", mod->stats.no_retry_nc_writes
+			- mod->stats.no_retry_nc_write_hits);
 
 		if(mod->num_load_requests)             fprintf(f_as, "num_load_requests = %lld\n",             mod->num_load_requests);
 		if(mod->num_store_requests)            fprintf(f_as, "num_store_requests = %lld\n",            mod->num_store_requests);
@@ -502,443 +733,155 @@ void mem_system_dump_report(void)
 		// Required Statistics printing
 		//-------------------------------------------------------
 
-		// Statistics for request counters
-		fprintf(f_as, "===============REQUEST COUNT==============================\n");
-		fprintf(f_as, "load_requests = %lld\n",                       mod->load_requests);
-		fprintf(f_as, "store_requests = %lld\n",                      mod->store_requests);
-		fprintf(f_as, "downup_read_requests = %lld\n",                mod->downup_read_requests);
-		fprintf(f_as, "downup_writeback_requests = %lld\n",           mod->downup_writeback_requests);
-		fprintf(f_as, "writeback_due_to_eviction = %lld\n",           mod->writeback_due_to_eviction);
-		fprintf(f_as, "\n===============REQUEST HITS==============================\n");
-		fprintf(f_as, "load_requests_hits = %lld\n",                  mod->load_requests_hits);
-		fprintf(f_as, "store_requests_hits = %lld\n",                 mod->store_requests_hits);
-		fprintf(f_as, "downup_read_requests_hits = %lld\n",           mod->downup_read_requests_hits);
-		fprintf(f_as, "downup_writeback_requests_hits = %lld\n",      mod->downup_writeback_requests_hits);
-		fprintf(f_as, "writeback_due_to_eviction_hits = %lld\n",      mod->writeback_due_to_eviction_hits);
-		fprintf(f_as, "\n===============REQUEST MISSES==============================\n");
-		fprintf(f_as, "load_requests_misses = %lld\n",                mod->load_requests_misses);
-		fprintf(f_as, "store_requests_misses = %lld\n",               mod->store_requests_misses);
-		fprintf(f_as, "downup_read_requests_misses = %lld\n",         mod->downup_read_requests_misses);
-		fprintf(f_as, "downup_writeback_requests_misses = %lld\n",    mod->downup_writeback_requests_misses);
-		fprintf(f_as, "writeback_due_to_eviction_misses = %lld\n",    mod->writeback_due_to_eviction_misses);
-		fprintf(f_as, "\n===============GENERATED REQUESTS==============================\n");
-		fprintf(f_as, "updown_read_requests_generated = %lld\n",      mod->updown_read_requests_generated);
-		fprintf(f_as, "updown_writeback_requests_generated = %lld\n", mod->updown_writeback_requests_generated);
-		fprintf(f_as, "\n===============EVICTION STATISTICS==============================\n");
-		fprintf(f_as, "Evictions = %lld\n", mod->evictions);
-		fprintf(f_as, "eviction_due_to_load = %lld\n",		            mod->eviction_due_to_load);
-		fprintf(f_as, "eviction_due_to_store = %lld\n", 	            mod->eviction_due_to_store);
-		fprintf(f_as, "\n===============COALESCED AND OTHER WAITING ACCESSES==============================\n");
-		fprintf(f_as, "coalesced_loads = %lld\n",                         mod->coalesced_loads);
-		fprintf(f_as, "coalesced_stores = %lld\n",                        mod->coalesced_stores);
-		fprintf(f_as, "loads_waiting_for_non_coalesced_accesses = %lld\n",mod->loads_waiting_for_non_coalesced_accesses);
-		fprintf(f_as, "loads_waiting_for_stores = %lld\n",                mod->loads_waiting_for_stores);
-		fprintf(f_as, "read_waiting_for_other_accesses = %lld\n",         mod->read_waiting_for_other_accesses);
-		fprintf(f_as, "write_waiting_for_other_accesses = %lld\n",        mod->write_waiting_for_other_accesses);
-		
-		// Statistics for waiting accesses
-
-		fprintf(f_as, "\n===============WAITING COUNTERS==============================\n");
-		fprintf(f_as, "read_waiting_for_mod_port = %lld\n"                          , mod->read_waiting_for_mod_port);
-		fprintf(f_as, "read_waiting_for_directory_lock = %lld\n"                    , mod->read_waiting_for_directory_lock);
-		// fprintf(f, "max_sim_read_waiting_for_mod_port = %lld\n"                  , mod->max_sim_read_waiting_for_mod_port);
-		// fprintf(f, "max_sim_read_waiting_for_directory_lock = %lld\n"            , mod->max_sim_read_waiting_for_directory_lock);
-		fprintf(f_as, "write_waiting_for_mod_port = %lld\n"                         , mod->write_waiting_for_mod_port);
-		fprintf(f_as, "write_waiting_for_directory_lock = %lld\n"                   , mod->write_waiting_for_directory_lock);
-		// fprintf(f, "max_sim_write_waiting_for_mod_port = %lld\n"                 , mod->max_sim_write_waiting_for_mod_port);
-		// fprintf(f, "max_sim_write_waiting_for_directory_lock = %lld\n"           , mod->max_sim_write_waiting_for_directory_lock);
-		fprintf(f_as, "eviction_waiting_for_mod_port = %lld\n"                      , mod->eviction_waiting_for_mod_port);
-		fprintf(f_as, "eviction_waiting_for_directory_lock = %lld\n"                , mod->eviction_waiting_for_directory_lock);
-		// fprintf(f, "max_sim_eviction_waiting_for_mod_port = %lld\n"              , mod->max_sim_eviction_waiting_for_mod_port);
-		// fprintf(f, "max_sim_eviction_waiting_for_directory_lock = %lld\n"        , mod->max_sim_eviction_waiting_for_directory_lock);
-		// fprintf(f, "eviction_waiting_for_other_accesses = %lld\n"                , mod->eviction_waiting_for_other_accesses);
-		fprintf(f_as, "downup_read_waiting_for_mod_port = %lld\n"                   , mod->downup_read_waiting_for_mod_port);
-		fprintf(f_as, "downup_read_waiting_for_directory_lock = %lld\n"             , mod->downup_read_waiting_for_directory_lock);
-		// fprintf(f, "max_sim_downup_read_waiting_for_mod_port = %lld\n"           , mod->max_sim_downup_read_waiting_for_mod_port);
-		// fprintf(f, "max_sim_downup_read_waiting_for_directory_lock = %lld\n"     , mod->max_sim_downup_read_waiting_for_directory_lock);
-		// fprintf(f, "downup_read_waiting_for_other_accesses = %lld\n"             , mod->downup_read_waiting_for_other_accesses);
-		fprintf(f_as, "downup_writeback_waiting_for_mod_port = %lld\n"              , mod->downup_writeback_waiting_for_mod_port);
-		fprintf(f_as, "downup_writeback_waiting_for_directory_lock = %lld\n"        , mod->downup_writeback_waiting_for_directory_lock);
-		// fprintf(f, "max_sim_downup_writeback_waiting_for_mod_port = %lld\n"      , mod->max_sim_downup_writeback_waiting_for_mod_port);
-		// fprintf(f, "max_sim_downup_writeback_waiting_for_directory_lock = %lld\n", mod->max_sim_downup_writeback_waiting_for_directory_lock);
-		// fprintf(f, "downup_writeback_waiting_for_other_accesses = %lld\n"        , mod->downup_writeback_waiting_for_other_accesses);
-		
-		fprintf(f_as, "\n===============NETWORK REQUESTS WAITING==============================\n");
-		fprintf(f_as, "read_send_requests_retried_nw = %lld\n",            	mod->read_send_requests_retried_nw);
-		fprintf(f_as, "writeback_send_requests_retried_nw = %lld\n",       	mod->writeback_send_requests_retried_nw);
-		fprintf(f_as, "eviction_send_requests_retried_nw = %lld\n",        	mod->eviction_send_requests_retried_nw);
-		fprintf(f_as, "downup_read_send_requests_retried_nw = %lld\n",     	mod->downup_read_send_requests_retried_nw);
-		fprintf(f_as, "downup_writeback_send_requests_retried_nw = %lld\n",	mod->downup_writeback_send_requests_retried_nw);
-		fprintf(f_as, "downup_eviction_send_requests_retried_nw = %lld\n", 	mod->downup_eviction_send_requests_retried_nw);
-		fprintf(f_as, "peer_send_requests_retried_nw = %lld\n",            	mod->peer_send_requests_retried_nw);
-
-		fprintf(f_as, "\n===============NETWORK REPLIES WAITING==============================\n");
-		fprintf(f_as, "read_send_replies_retried_nw = %lld\n",             	mod->read_send_replies_retried_nw);
-		fprintf(f_as, "writeback_send_replies_retried_nw = %lld\n",        	mod->writeback_send_replies_retried_nw);
-		fprintf(f_as, "eviction_send_replies_retried_nw = %lld\n",         	mod->eviction_send_replies_retried_nw);
-		fprintf(f_as, "downup_read_send_replies_retried_nw = %lld\n",      	mod->downup_read_send_replies_retried_nw);
-		fprintf(f_as, "downup_writeback_send_replies_retried_nw = %lld\n", 	mod->downup_writeback_send_replies_retried_nw);
-		fprintf(f_as, "downup_eviction_send_replies_retried_nw = %lld\n",  	mod->downup_eviction_send_replies_retried_nw);
-		fprintf(f_as, "peer_send_replies_retried_nw = %lld\n",             	mod->peer_send_replies_retried_nw);
+		/* Counters declared in 'mod-stat.dat' */
+		mod_stat_dump(mod, mod_stat_file_access, f_as);
 
 		fprintf(f_lc, "\n===============WAITING COUNTERS FOR MOD PORTS==============================\n");
 		for(int i=0; i<6; i++)	
-			if(mod->read_time_waiting_mod_port[i]) fprintf(f_lc, "read_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->read_time_waiting_mod_port[i]);
+			if(mod->stats.read_time_waiting_mod_port[i]) fprintf(f_lc, "read_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.read_time_waiting_mod_port[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->write_time_waiting_mod_port[i]) fprintf(f_lc, "write_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->write_time_waiting_mod_port[i]);
+			if(mod->stats.write_time_waiting_mod_port[i]) fprintf(f_lc, "write_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.write_time_waiting_mod_port[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->eviction_time_waiting_mod_port[i]) fprintf(f_lc, "eviction_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->eviction_time_waiting_mod_port[i]);
+			if(mod->stats.eviction_time_waiting_mod_port[i]) fprintf(f_lc, "eviction_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.eviction_time_waiting_mod_port[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->downup_read_time_waiting_mod_port[i]) fprintf(f_lc, "downup_read_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->downup_read_time_waiting_mod_port[i]);
+			if(mod->stats.downup_read_time_waiting_mod_port[i]) fprintf(f_lc, "downup_read_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.downup_read_time_waiting_mod_port[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->downup_writeback_time_waiting_mod_port[i]) fprintf(f_lc, "downup_writeback_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->downup_writeback_time_waiting_mod_port[i]);
+			if(mod->stats.downup_writeback_time_waiting_mod_port[i]) fprintf(f_lc, "downup_writeback_time_waiting_mod_port_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.downup_writeback_time_waiting_mod_port[i]);
 		
 		fprintf(f_lc, "\n===============WAITING COUNTERS FOR DIRECTORY LOCKS==============================\n");
 		for(int i=0; i<6; i++)	
-			if(mod->read_time_waiting_directory_lock[i]) fprintf(f_lc, "read_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->read_time_waiting_directory_lock[i]);
+			if(mod->stats.read_time_waiting_directory_lock[i]) fprintf(f_lc, "read_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.read_time_waiting_directory_lock[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->write_time_waiting_directory_lock[i]) fprintf(f_lc, "write_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->write_time_waiting_directory_lock[i]);
+			if(mod->stats.write_time_waiting_directory_lock[i]) fprintf(f_lc, "write_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.write_time_waiting_directory_lock[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->eviction_time_waiting_directory_lock[i]) fprintf(f_lc, "eviction_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->eviction_time_waiting_directory_lock[i]);
+			if(mod->stats.eviction_time_waiting_directory_lock[i]) fprintf(f_lc, "eviction_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.eviction_time_waiting_directory_lock[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->downup_read_time_waiting_directory_lock[i]) fprintf(f_lc, "downup_read_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->downup_read_time_waiting_directory_lock[i]);
+			if(mod->stats.downup_read_time_waiting_directory_lock[i]) fprintf(f_lc, "downup_read_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.downup_read_time_waiting_directory_lock[i]);
 		for(int i=0; i<6; i++)	
-			if(mod->downup_writeback_time_waiting_directory_lock[i]) fprintf(f_lc, "downup_writeback_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->downup_writeback_time_waiting_directory_lock[i]);
+			if(mod->stats.downup_writeback_time_waiting_directory_lock[i]) fprintf(f_lc, "downup_writeback_time_waiting_directory_lock_range_%d_to_%d = %lld\n", pow_2(i), pow_2(i+1) -1, mod->stats.downup_writeback_time_waiting_directory_lock[i]);
 
 		fprintf(f_lc, "\n===============WAITING COUNTERS FOR OTHER ACCESSES==============================\n");
 		for(int i=0; i<5; i++)
-			if(mod->loads_time_waiting_for_non_coalesced_accesses[i]) fprintf(f_lc, "loads_time_waiting_for_non_coalesced_accesses_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->loads_time_waiting_for_non_coalesced_accesses[i]);
+			if(mod->stats.loads_time_waiting_for_non_coalesced_accesses[i]) fprintf(f_lc, "loads_time_waiting_for_non_coalesced_accesses_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.loads_time_waiting_for_non_coalesced_accesses[i]);
 		for(int i=0; i<5; i++)
-			if(mod->loads_time_waiting_for_stores[i]) fprintf(f_lc, "loads_time_waiting_for_stores_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->loads_time_waiting_for_stores[i]);
+			if(mod->stats.loads_time_waiting_for_stores[i]) fprintf(f_lc, "loads_time_waiting_for_stores_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.loads_time_waiting_for_stores[i]);
 		for(int i=0; i<5; i++)
-			if(mod->stores_time_waiting[i]) fprintf(f_lc, "stores_time_waiting_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stores_time_waiting[i]);
+			if(mod->stats.stores_time_waiting[i]) fprintf(f_lc, "stores_time_waiting_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.stores_time_waiting[i]);
 		
 		fprintf(f_lc, "\n===============WAITING COUNTERS FOR NETWORK REQUESTS SEND==============================\n");
 		for(int i=0; i<6; i++)
-			if(mod->read_send_requests_nw_cycles[i]) fprintf(f_lc, "read_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->read_send_requests_nw_cycles[i]);
+			if(mod->stats.read_send_requests_nw_cycles[i]) fprintf(f_lc, "read_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.read_send_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->writeback_send_requests_nw_cycles[i]) fprintf(f_lc, "writeback_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->writeback_send_requests_nw_cycles[i]);
+			if(mod->stats.writeback_send_requests_nw_cycles[i]) fprintf(f_lc, "writeback_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.writeback_send_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->eviction_send_requests_nw_cycles[i]) fprintf(f_lc, "eviction_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->eviction_send_requests_nw_cycles[i]);
+			if(mod->stats.eviction_send_requests_nw_cycles[i]) fprintf(f_lc, "eviction_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.eviction_send_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_read_send_requests_nw_cycles[i]) fprintf(f_lc, "downup_read_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_read_send_requests_nw_cycles[i]);
+			if(mod->stats.downup_read_send_requests_nw_cycles[i]) fprintf(f_lc, "downup_read_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_read_send_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_writeback_send_requests_nw_cycles[i]) fprintf(f_lc, "downup_writeback_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_writeback_send_requests_nw_cycles[i]);
+			if(mod->stats.downup_writeback_send_requests_nw_cycles[i]) fprintf(f_lc, "downup_writeback_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_writeback_send_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_eviction_send_requests_nw_cycles[i]) fprintf(f_lc, "downup_eviction_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_eviction_send_requests_nw_cycles[i]);
+			if(mod->stats.downup_eviction_send_requests_nw_cycles[i]) fprintf(f_lc, "downup_eviction_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_eviction_send_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->peer_send_requests_nw_cycles[i]) fprintf(f_lc, "peer_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->peer_send_requests_nw_cycles[i]);
+			if(mod->stats.peer_send_requests_nw_cycles[i]) fprintf(f_lc, "peer_send_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.peer_send_requests_nw_cycles[i]);
 			
 		fprintf(f_lc, "\n===============WAITING COUNTERS FOR NETWORK REPLIES SEND==============================\n");
 		for(int i=0; i<6; i++)
-			if(mod->read_send_replies_nw_cycles[i]) fprintf(f_lc, "read_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->read_send_replies_nw_cycles[i]);
+			if(mod->stats.read_send_replies_nw_cycles[i]) fprintf(f_lc, "read_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.read_send_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->writeback_send_replies_nw_cycles[i]) fprintf(f_lc, "writeback_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->writeback_send_replies_nw_cycles[i]);
+			if(mod->stats.writeback_send_replies_nw_cycles[i]) fprintf(f_lc, "writeback_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.writeback_send_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->eviction_send_replies_nw_cycles[i]) fprintf(f_lc, "eviction_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->eviction_send_replies_nw_cycles[i]);
+			if(mod->stats.eviction_send_replies_nw_cycles[i]) fprintf(f_lc, "eviction_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.eviction_send_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_read_send_replies_nw_cycles[i]) fprintf(f_lc, "downup_read_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_read_send_replies_nw_cycles[i]);
+			if(mod->stats.downup_read_send_replies_nw_cycles[i]) fprintf(f_lc, "downup_read_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_read_send_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_writeback_send_replies_nw_cycles[i]) fprintf(f_lc, "downup_writeback_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_writeback_send_replies_nw_cycles[i]);
+			if(mod->stats.downup_writeback_send_replies_nw_cycles[i]) fprintf(f_lc, "downup_writeback_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_writeback_send_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_eviction_send_replies_nw_cycles[i]) fprintf(f_lc, "downup_eviction_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_eviction_send_replies_nw_cycles[i]);
+			if(mod->stats.downup_eviction_send_replies_nw_cycles[i]) fprintf(f_lc, "downup_eviction_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_eviction_send_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->peer_send_replies_nw_cycles[i]) fprintf(f_lc, "peer_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->peer_send_replies_nw_cycles[i]);
+			if(mod->stats.peer_send_replies_nw_cycles[i]) fprintf(f_lc, "peer_send_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.peer_send_replies_nw_cycles[i]);
 			
 		fprintf(f_lc, "\n===============WAITING COUNTERS FOR NETWORK REQUESTS RECEIVE==============================\n");
 		for(int i=0; i<6; i++)
-			if(mod->read_receive_requests_nw_cycles[i]) fprintf(f_lc, "read_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->read_receive_requests_nw_cycles[i]);
+			if(mod->stats.read_receive_requests_nw_cycles[i]) fprintf(f_lc, "read_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.read_receive_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->writeback_receive_requests_nw_cycles[i]) fprintf(f_lc, "writeback_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->writeback_receive_requests_nw_cycles[i]);
+			if(mod->stats.writeback_receive_requests_nw_cycles[i]) fprintf(f_lc, "writeback_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.writeback_receive_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->eviction_receive_requests_nw_cycles[i]) fprintf(f_lc, "eviction_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->eviction_receive_requests_nw_cycles[i]);
+			if(mod->stats.eviction_receive_requests_nw_cycles[i]) fprintf(f_lc, "eviction_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.eviction_receive_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_read_receive_requests_nw_cycles[i]) fprintf(f_lc, "downup_read_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_read_receive_requests_nw_cycles[i]);
+			if(mod->stats.downup_read_receive_requests_nw_cycles[i]) fprintf(f_lc, "downup_read_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_read_receive_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_writeback_receive_requests_nw_cycles[i]) fprintf(f_lc, "downup_writeback_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_writeback_receive_requests_nw_cycles[i]);
+			if(mod->stats.downup_writeback_receive_requests_nw_cycles[i]) fprintf(f_lc, "downup_writeback_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_writeback_receive_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_eviction_receive_requests_nw_cycles[i]) fprintf(f_lc, "downup_eviction_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_eviction_receive_requests_nw_cycles[i]);
+			if(mod->stats.downup_eviction_receive_requests_nw_cycles[i]) fprintf(f_lc, "downup_eviction_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_eviction_receive_requests_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->peer_receive_requests_nw_cycles[i]) fprintf(f_lc, "peer_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) -1, mod->peer_receive_requests_nw_cycles[i]);
+			if(mod->stats.peer_receive_requests_nw_cycles[i]) fprintf(f_lc, "peer_receive_requests_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) -1, mod->stats.peer_receive_requests_nw_cycles[i]);
 			
 		fprintf(f_lc, "\n===============WAITING COUNTERS FOR NETWORK REPLIES RECEIVE==============================\n");
 		for(int i=0; i<6; i++)
-			if(mod->read_receive_replies_nw_cycles[i]) fprintf(f_lc, "read_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->read_receive_replies_nw_cycles[i]);
+			if(mod->stats.read_receive_replies_nw_cycles[i]) fprintf(f_lc, "read_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.read_receive_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->writeback_receive_replies_nw_cycles[i]) fprintf(f_lc, "writeback_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->writeback_receive_replies_nw_cycles[i]);
+			if(mod->stats.writeback_receive_replies_nw_cycles[i]) fprintf(f_lc, "writeback_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.writeback_receive_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->eviction_receive_replies_nw_cycles[i]) fprintf(f_lc, "eviction_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->eviction_receive_replies_nw_cycles[i]);
+			if(mod->stats.eviction_receive_replies_nw_cycles[i]) fprintf(f_lc, "eviction_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.eviction_receive_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_read_receive_replies_nw_cycles[i]) fprintf(f_lc, "downup_read_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_read_receive_replies_nw_cycles[i]);
+			if(mod->stats.downup_read_receive_replies_nw_cycles[i]) fprintf(f_lc, "downup_read_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_read_receive_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_writeback_receive_replies_nw_cycles[i]) fprintf(f_lc, "downup_writeback_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_writeback_receive_replies_nw_cycles[i]);
+			if(mod->stats.downup_writeback_receive_replies_nw_cycles[i]) fprintf(f_lc, "downup_writeback_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_writeback_receive_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->downup_eviction_receive_replies_nw_cycles[i]) fprintf(f_lc, "downup_eviction_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->downup_eviction_receive_replies_nw_cycles[i]);
+			if(mod->stats.downup_eviction_receive_replies_nw_cycles[i]) fprintf(f_lc, "downup_eviction_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.downup_eviction_receive_replies_nw_cycles[i]);
 		for(int i=0; i<6; i++)
-			if(mod->peer_receive_replies_nw_cycles[i]) fprintf(f_lc, "peer_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->peer_receive_replies_nw_cycles[i]);
+			if(mod->stats.peer_receive_replies_nw_cycles[i]) fprintf(f_lc, "peer_receive_replies_nw_cycles_range_%d_to_%d = %lld\n", pow_2(i+1), pow_2(i+2) - 1, mod->stats.peer_receive_replies_nw_cycles[i]);
 		
-		 fprintf(f_as, "\n===============STATES ACCESSED IN REQUESTS==============================\n");
-		 fprintf(f_as, "read_state_invalid = %lld\n"                           , mod->read_state_invalid);
-		 fprintf(f_as, "read_state_noncoherent = %lld\n"                       , mod->read_state_noncoherent);
-		 fprintf(f_as, "read_state_modified = %lld\n"                          , mod->read_state_modified);
-		 fprintf(f_as, "read_state_shared = %lld\n"                            , mod->read_state_shared);
-		 fprintf(f_as, "read_state_owned = %lld\n"                             , mod->read_state_owned);
-		 fprintf(f_as, "read_state_exclusive = %lld\n"                         , mod->read_state_exclusive);
-		 fprintf(f_as, "write_state_invalid = %lld\n"                          , mod->write_state_invalid);
-		 fprintf(f_as, "write_state_noncoherent = %lld\n"                      , mod->write_state_noncoherent);
-		 fprintf(f_as, "write_state_modified = %lld\n"                         , mod->write_state_modified);
-		 fprintf(f_as, "write_state_shared = %lld\n"                           , mod->write_state_shared);
-		 fprintf(f_as, "write_state_owned = %lld\n"                            , mod->write_state_owned);
-		 fprintf(f_as, "write_state_exclusive = %lld\n"                        , mod->write_state_exclusive);
-		 fprintf(f_as, "sharer_req_state_invalid = %lld\n"                     , mod->sharer_req_state_invalid);
-		 fprintf(f_as, "sharer_req_state_noncoherent = %lld\n"                 , mod->sharer_req_state_noncoherent);
-		 fprintf(f_as, "sharer_req_state_modified = %lld\n"                    , mod->sharer_req_state_modified);
-		 fprintf(f_as, "sharer_req_state_shared = %lld\n"                      , mod->sharer_req_state_shared);
-		 fprintf(f_as, "sharer_req_state_owned = %lld\n"                       , mod->sharer_req_state_owned);
-		 fprintf(f_as, "sharer_req_state_exclusive = %lld\n"                   , mod->sharer_req_state_exclusive);
-
-		 fprintf(f_as, "\n===============PEER TRANSFERS==============================\n");
-		 fprintf(f_as, "peer_transfers = %lld\n"                               , mod->peer_transfers);
-		 fprintf(f_as, "\n===============SHARER REQUESTS FOR INVALIDATION==============================\n");
-		 fprintf(f_as, "sharer_req_for_invalidation = %lld\n"                  , mod->sharer_req_for_invalidation);
-
-		 fprintf(f_st, "\n===============STATES TRANSITIONS IN REQUESTS==============================\n");
-		 fprintf(f_st, "\n===================LOAD REQUESTS===========================================\n");
-		 if(mod->load_state_invalid_to_invalid)        	 fprintf(f_st, "load_state_invalid_to_invalid = %lld\n"                , mod->load_state_invalid_to_invalid);
-		 if(mod->load_state_invalid_to_noncoherent)    	 fprintf(f_st, "load_state_invalid_to_noncoherent = %lld\n"            , mod->load_state_invalid_to_noncoherent);
-		 if(mod->load_state_invalid_to_modified)       	 fprintf(f_st, "load_state_invalid_to_modified = %lld\n"               , mod->load_state_invalid_to_modified);
-		 if(mod->load_state_invalid_to_shared)         	 fprintf(f_st, "load_state_invalid_to_shared = %lld\n"                 , mod->load_state_invalid_to_shared);
-		 if(mod->load_state_invalid_to_owned)          	 fprintf(f_st, "load_state_invalid_to_owned = %lld\n"                  , mod->load_state_invalid_to_owned);
-		 if(mod->load_state_invalid_to_exclusive)      	 fprintf(f_st, "load_state_invalid_to_exclusive = %lld\n"              , mod->load_state_invalid_to_exclusive);
-		 if(mod->load_state_noncoherent_to_invalid)    	 fprintf(f_st, "load_state_noncoherent_to_invalid = %lld\n"            , mod->load_state_noncoherent_to_invalid);
-		 if(mod->load_state_noncoherent_to_noncoherent)	 fprintf(f_st, "load_state_noncoherent_to_noncoherent = %lld\n"        , mod->load_state_noncoherent_to_noncoherent);
-		 if(mod->load_state_noncoherent_to_modified)   	 fprintf(f_st, "load_state_noncoherent_to_modified = %lld\n"           , mod->load_state_noncoherent_to_modified);
-		 if(mod->load_state_noncoherent_to_shared)     	 fprintf(f_st, "load_state_noncoherent_to_shared = %lld\n"             , mod->load_state_noncoherent_to_shared);
-		 if(mod->load_state_noncoherent_to_owned)      	 fprintf(f_st, "load_state_noncoherent_to_owned = %lld\n"              , mod->load_state_noncoherent_to_owned);
-		 if(mod->load_state_noncoherent_to_exclusive)  	 fprintf(f_st, "load_state_noncoherent_to_exclusive = %lld\n"          , mod->load_state_noncoherent_to_exclusive);
-		 if(mod->load_state_modified_to_invalid)       	 fprintf(f_st, "load_state_modified_to_invalid = %lld\n"               , mod->load_state_modified_to_invalid);
-		 if(mod->load_state_modified_to_noncoherent)   	 fprintf(f_st, "load_state_modified_to_noncoherent = %lld\n"           , mod->load_state_modified_to_noncoherent);
-		 if(mod->load_state_modified_to_modified)      	 fprintf(f_st, "load_state_modified_to_modified = %lld\n"              , mod->load_state_modified_to_modified);
-		 if(mod->load_state_modified_to_shared)        	 fprintf(f_st, "load_state_modified_to_shared = %lld\n"                , mod->load_state_modified_to_shared);
-		 if(mod->load_state_modified_to_owned)         	 fprintf(f_st, "load_state_modified_to_owned = %lld\n"                 , mod->load_state_modified_to_owned);
-		 if(mod->load_state_modified_to_exclusive)     	 fprintf(f_st, "load_state_modified_to_exclusive = %lld\n"             , mod->load_state_modified_to_exclusive);
-		 if(mod->load_state_shared_to_invalid)         	 fprintf(f_st, "load_state_shared_to_invalid = %lld\n"                 , mod->load_state_shared_to_invalid);
-		 if(mod->load_state_shared_to_noncoherent)     	 fprintf(f_st, "load_state_shared_to_noncoherent = %lld\n"             , mod->load_state_shared_to_noncoherent);
-		 if(mod->load_state_shared_to_modified)        	 fprintf(f_st, "load_state_shared_to_modified = %lld\n"                , mod->load_state_shared_to_modified);
-		 if(mod->load_state_shared_to_shared)          	 fprintf(f_st, "load_state_shared_to_shared = %lld\n"                  , mod->load_state_shared_to_shared);
-		 if(mod->load_state_shared_to_owned)           	 fprintf(f_st, "load_state_shared_to_owned = %lld\n"                   , mod->load_state_shared_to_owned);
-		 if(mod->load_state_shared_to_exclusive)       	 fprintf(f_st, "load_state_shared_to_exclusive = %lld\n"               , mod->load_state_shared_to_exclusive);
-		 if(mod->load_state_owned_to_invalid)          	 fprintf(f_st, "load_state_owned_to_invalid = %lld\n"                  , mod->load_state_owned_to_invalid);
-		 if(mod->load_state_owned_to_noncoherent)      	 fprintf(f_st, "load_state_owned_to_noncoherent = %lld\n"              , mod->load_state_owned_to_noncoherent);
-		 if(mod->load_state_owned_to_modified)         	 fprintf(f_st, "load_state_owned_to_modified = %lld\n"                 , mod->load_state_owned_to_modified);
-		 if(mod->load_state_owned_to_shared)           	 fprintf(f_st, "load_state_owned_to_shared = %lld\n"                   , mod->load_state_owned_to_shared);
-		 if(mod->load_state_owned_to_owned)            	 fprintf(f_st, "load_state_owned_to_owned = %lld\n"                    , mod->load_state_owned_to_owned);
-		 if(mod->load_state_owned_to_exclusive)        	 fprintf(f_st, "load_state_owned_to_exclusive = %lld\n"                , mod->load_state_owned_to_exclusive);
-		 if(mod->load_state_exclusive_to_invalid)      	 fprintf(f_st, "load_state_exclusive_to_invalid = %lld\n"              , mod->load_state_exclusive_to_invalid);
-		 if(mod->load_state_exclusive_to_noncoherent)  	 fprintf(f_st, "load_state_exclusive_to_noncoherent = %lld\n"          , mod->load_state_exclusive_to_noncoherent);
-		 if(mod->load_state_exclusive_to_modified)     	 fprintf(f_st, "load_state_exclusive_to_modified = %lld\n"             , mod->load_state_exclusive_to_modified);
-		 if(mod->load_state_exclusive_to_shared)       	 fprintf(f_st, "load_state_exclusive_to_shared = %lld\n"               , mod->load_state_exclusive_to_shared);
-		 if(mod->load_state_exclusive_to_owned)        	 fprintf(f_st, "load_state_exclusive_to_owned = %lld\n"                , mod->load_state_exclusive_to_owned);
-		 if(mod->load_state_exclusive_to_exclusive)    	 fprintf(f_st, "load_state_exclusive_to_exclusive = %lld\n"            , mod->load_state_exclusive_to_exclusive);
-		 fprintf(f_st, "\n===================STORE REQUESTS===========================================\n");
-		 if(mod->store_state_invalid_to_invalid)        	 fprintf(f_st, "store_state_invalid_to_invalid = %lld\n"               , mod->store_state_invalid_to_invalid);
-		 if(mod->store_state_invalid_to_noncoherent)    	 fprintf(f_st, "store_state_invalid_to_noncoherent = %lld\n"           , mod->store_state_invalid_to_noncoherent);
-		 if(mod->store_state_invalid_to_modified)       	 fprintf(f_st, "store_state_invalid_to_modified = %lld\n"              , mod->store_state_invalid_to_modified);
-		 if(mod->store_state_invalid_to_shared)         	 fprintf(f_st, "store_state_invalid_to_shared = %lld\n"                , mod->store_state_invalid_to_shared);
-		 if(mod->store_state_invalid_to_owned)          	 fprintf(f_st, "store_state_invalid_to_owned = %lld\n"                 , mod->store_state_invalid_to_owned);
-		 if(mod->store_state_invalid_to_exclusive)      	 fprintf(f_st, "store_state_invalid_to_exclusive = %lld\n"             , mod->store_state_invalid_to_exclusive);
-		 if(mod->store_state_noncoherent_to_invalid)    	 fprintf(f_st, "store_state_noncoherent_to_invalid = %lld\n"           , mod->store_state_noncoherent_to_invalid);
-		 if(mod->store_state_noncoherent_to_noncoherent)	 fprintf(f_st, "store_state_noncoherent_to_noncoherent = %lld\n"       , mod->store_state_noncoherent_to_noncoherent);
-		 if(mod->store_state_noncoherent_to_modified)   	 fprintf(f_st, "store_state_noncoherent_to_modified = %lld\n"          , mod->store_state_noncoherent_to_modified);
-		 if(mod->store_state_noncoherent_to_shared)     	 fprintf(f_st, "store_state_noncoherent_to_shared = %lld\n"            , mod->store_state_noncoherent_to_shared);
-		 if(mod->store_state_noncoherent_to_owned)      	 fprintf(f_st, "store_state_noncoherent_to_owned = %lld\n"             , mod->store_state_noncoherent_to_owned);
-		 if(mod->store_state_noncoherent_to_exclusive)  	 fprintf(f_st, "store_state_noncoherent_to_exclusive = %lld\n"         , mod->store_state_noncoherent_to_exclusive);
-		 if(mod->store_state_modified_to_invalid)       	 fprintf(f_st, "store_state_modified_to_invalid = %lld\n"              , mod->store_state_modified_to_invalid);
-		 if(mod->store_state_modified_to_noncoherent)   	 fprintf(f_st, "store_state_modified_to_noncoherent = %lld\n"          , mod->store_state_modified_to_noncoherent);
-		 if(mod->store_state_modified_to_modified)      	 fprintf(f_st, "store_state_modified_to_modified = %lld\n"             , mod->store_state_modified_to_modified);
-		 if(mod->store_state_modified_to_shared)        	 fprintf(f_st, "store_state_modified_to_shared = %lld\n"               , mod->store_state_modified_to_shared);
-		 if(mod->store_state_modified_to_owned)         	 fprintf(f_st, "store_state_modified_to_owned = %lld\n"                , mod->store_state_modified_to_owned);
-		 if(mod->store_state_modified_to_exclusive)     	 fprintf(f_st, "store_state_modified_to_exclusive = %lld\n"            , mod->store_state_modified_to_exclusive);
-		 if(mod->store_state_shared_to_invalid)         	 fprintf(f_st, "store_state_shared_to_invalid = %lld\n"                , mod->store_state_shared_to_invalid);
-		 if(mod->store_state_shared_to_noncoherent)     	 fprintf(f_st, "store_state_shared_to_noncoherent = %lld\n"            , mod->store_state_shared_to_noncoherent);
-		 if(mod->store_state_shared_to_modified)        	 fprintf(f_st, "store_state_shared_to_modified = %lld\n"               , mod->store_state_shared_to_modified);
-		 if(mod->store_state_shared_to_shared)          	 fprintf(f_st, "store_state_shared_to_shared = %lld\n"                 , mod->store_state_shared_to_shared);
-		 if(mod->store_state_shared_to_owned)           	 fprintf(f_st, "store_state_shared_to_owned = %lld\n"                  , mod->store_state_shared_to_owned);
-		 if(mod->store_state_shared_to_exclusive)       	 fprintf(f_st, "store_state_shared_to_exclusive = %lld\n"              , mod->store_state_shared_to_exclusive);
-		 if(mod->store_state_owned_to_invalid)          	 fprintf(f_st, "store_state_owned_to_invalid = %lld\n"                 , mod->store_state_owned_to_invalid);
-		 if(mod->store_state_owned_to_noncoherent)      	 fprintf(f_st, "store_state_owned_to_noncoherent = %lld\n"             , mod->store_state_owned_to_noncoherent);
-		 if(mod->store_state_owned_to_modified)         	 fprintf(f_st, "store_state_owned_to_modified = %lld\n"                , mod->store_state_owned_to_modified);
-		 if(mod->store_state_owned_to_shared)           	 fprintf(f_st, "store_state_owned_to_shared = %lld\n"                  , mod->store_state_owned_to_shared);
-		 if(mod->store_state_owned_to_owned)            	 fprintf(f_st, "store_state_owned_to_owned = %lld\n"                   , mod->store_state_owned_to_owned);
-		 if(mod->store_state_owned_to_exclusive)        	 fprintf(f_st, "store_state_owned_to_exclusive = %lld\n"               , mod->store_state_owned_to_exclusive);
-		 if(mod->store_state_exclusive_to_invalid)      	 fprintf(f_st, "store_state_exclusive_to_invalid = %lld\n"             , mod->store_state_exclusive_to_invalid);
-		 if(mod->store_state_exclusive_to_noncoherent)  	 fprintf(f_st, "store_state_exclusive_to_noncoherent = %lld\n"         , mod->store_state_exclusive_to_noncoherent);
-		 if(mod->store_state_exclusive_to_modified)     	 fprintf(f_st, "store_state_exclusive_to_modified = %lld\n"            , mod->store_state_exclusive_to_modified);
-		 if(mod->store_state_exclusive_to_shared)       	 fprintf(f_st, "store_state_exclusive_to_shared = %lld\n"              , mod->store_state_exclusive_to_shared);
-		 if(mod->store_state_exclusive_to_owned)        	 fprintf(f_st, "store_state_exclusive_to_owned = %lld\n"               , mod->store_state_exclusive_to_owned);
-		 if(mod->store_state_exclusive_to_exclusive)    	 fprintf(f_st, "store_state_exclusive_to_exclusive = %lld\n"           , mod->store_state_exclusive_to_exclusive);
-		 fprintf(f_st, "\n===================DOWNUP READ REQUESTS===========================================\n");
-		 if(mod->downup_read_req_state_invalid_to_invalid)        	 fprintf(f_st, "downup_read_req_state_invalid_to_invalid = %lld\n"          , mod->downup_read_req_state_invalid_to_invalid);
-		 if(mod->downup_read_req_state_invalid_to_noncoherent)    	 fprintf(f_st, "downup_read_req_state_invalid_to_noncoherent = %lld\n"      , mod->downup_read_req_state_invalid_to_noncoherent);
-		 if(mod->downup_read_req_state_invalid_to_modified)       	 fprintf(f_st, "downup_read_req_state_invalid_to_modified = %lld\n"         , mod->downup_read_req_state_invalid_to_modified);
-		 if(mod->downup_read_req_state_invalid_to_shared)         	 fprintf(f_st, "downup_read_req_state_invalid_to_shared = %lld\n"           , mod->downup_read_req_state_invalid_to_shared);
-		 if(mod->downup_read_req_state_invalid_to_owned)          	 fprintf(f_st, "downup_read_req_state_invalid_to_owned = %lld\n"            , mod->downup_read_req_state_invalid_to_owned);
-		 if(mod->downup_read_req_state_invalid_to_exclusive)      	 fprintf(f_st, "downup_read_req_state_invalid_to_exclusive = %lld\n"        , mod->downup_read_req_state_invalid_to_exclusive);
-		 if(mod->downup_read_req_state_noncoherent_to_invalid)    	 fprintf(f_st, "downup_read_req_state_noncoherent_to_invalid = %lld\n"      , mod->downup_read_req_state_noncoherent_to_invalid);
-		 if(mod->downup_read_req_state_noncoherent_to_noncoherent)	 fprintf(f_st, "downup_read_req_state_noncoherent_to_noncoherent = %lld\n"  , mod->downup_read_req_state_noncoherent_to_noncoherent);
-		 if(mod->downup_read_req_state_noncoherent_to_modified)   	 fprintf(f_st, "downup_read_req_state_noncoherent_to_modified = %lld\n"     , mod->downup_read_req_state_noncoherent_to_modified);
-		 if(mod->downup_read_req_state_noncoherent_to_shared)     	 fprintf(f_st, "downup_read_req_state_noncoherent_to_shared = %lld\n"       , mod->downup_read_req_state_noncoherent_to_shared);
-		 if(mod->downup_read_req_state_noncoherent_to_owned)      	 fprintf(f_st, "downup_read_req_state_noncoherent_to_owned = %lld\n"        , mod->downup_read_req_state_noncoherent_to_owned);
-		 if(mod->downup_read_req_state_noncoherent_to_exclusive)  	 fprintf(f_st, "downup_read_req_state_noncoherent_to_exclusive = %lld\n"    , mod->downup_read_req_state_noncoherent_to_exclusive);
-		 if(mod->downup_read_req_state_modified_to_invalid)       	 fprintf(f_st, "downup_read_req_state_modified_to_invalid = %lld\n"         , mod->downup_read_req_state_modified_to_invalid);
-		 if(mod->downup_read_req_state_modified_to_noncoherent)   	 fprintf(f_st, "downup_read_req_state_modified_to_noncoherent = %lld\n"     , mod->downup_read_req_state_modified_to_noncoherent);
-		 if(mod->downup_read_req_state_modified_to_modified)      	 fprintf(f_st, "downup_read_req_state_modified_to_modified = %lld\n"        , mod->downup_read_req_state_modified_to_modified);
-		 if(mod->downup_read_req_state_modified_to_shared)        	 fprintf(f_st, "downup_read_req_state_modified_to_shared = %lld\n"          , mod->downup_read_req_state_modified_to_shared);
-		 if(mod->downup_read_req_state_modified_to_owned)         	 fprintf(f_st, "downup_read_req_state_modified_to_owned = %lld\n"           , mod->downup_read_req_state_modified_to_owned);
-		 if(mod->downup_read_req_state_modified_to_exclusive)     	 fprintf(f_st, "downup_read_req_state_modified_to_exclusive = %lld\n"       , mod->downup_read_req_state_modified_to_exclusive);
-		 if(mod->downup_read_req_state_shared_to_invalid)         	 fprintf(f_st, "downup_read_req_state_shared_to_invalid = %lld\n"           , mod->downup_read_req_state_shared_to_invalid);
-		 if(mod->downup_read_req_state_shared_to_noncoherent)     	 fprintf(f_st, "downup_read_req_state_shared_to_noncoherent = %lld\n"       , mod->downup_read_req_state_shared_to_noncoherent);
-		 if(mod->downup_read_req_state_shared_to_modified)        	 fprintf(f_st, "downup_read_req_state_shared_to_modified = %lld\n"          , mod->downup_read_req_state_shared_to_modified);
-		 if(mod->downup_read_req_state_shared_to_shared)          	 fprintf(f_st, "downup_read_req_state_shared_to_shared = %lld\n"            , mod->downup_read_req_state_shared_to_shared);
-		 if(mod->downup_read_req_state_shared_to_owned)           	 fprintf(f_st, "downup_read_req_state_shared_to_owned = %lld\n"             , mod->downup_read_req_state_shared_to_owned);
-		 if(mod->downup_read_req_state_shared_to_exclusive)       	 fprintf(f_st, "downup_read_req_state_shared_to_exclusive = %lld\n"         , mod->downup_read_req_state_shared_to_exclusive);
-		 if(mod->downup_read_req_state_owned_to_invalid)          	 fprintf(f_st, "downup_read_req_state_owned_to_invalid = %lld\n"            , mod->downup_read_req_state_owned_to_invalid);
-		 if(mod->downup_read_req_state_owned_to_noncoherent)      	 fprintf(f_st, "downup_read_req_state_owned_to_noncoherent = %lld\n"        , mod->downup_read_req_state_owned_to_noncoherent);
-		 if(mod->downup_read_req_state_owned_to_modified)         	 fprintf(f_st, "downup_read_req_state_owned_to_modified = %lld\n"           , mod->downup_read_req_state_owned_to_modified);
-		 if(mod->downup_read_req_state_owned_to_shared)           	 fprintf(f_st, "downup_read_req_state_owned_to_shared = %lld\n"             , mod->downup_read_req_state_owned_to_shared);
-		 if(mod->downup_read_req_state_owned_to_owned)            	 fprintf(f_st, "downup_read_req_state_owned_to_owned = %lld\n"              , mod->downup_read_req_state_owned_to_owned);
-		 if(mod->downup_read_req_state_owned_to_exclusive)        	 fprintf(f_st, "downup_read_req_state_owned_to_exclusive = %lld\n"          , mod->downup_read_req_state_owned_to_exclusive);
-		 if(mod->downup_read_req_state_exclusive_to_invalid)      	 fprintf(f_st, "downup_read_req_state_exclusive_to_invalid = %lld\n"        , mod->downup_read_req_state_exclusive_to_invalid);
-		 if(mod->downup_read_req_state_exclusive_to_noncoherent)  	 fprintf(f_st, "downup_read_req_state_exclusive_to_noncoherent = %lld\n"    , mod->downup_read_req_state_exclusive_to_noncoherent);
-		 if(mod->downup_read_req_state_exclusive_to_modified)     	 fprintf(f_st, "downup_read_req_state_exclusive_to_modified = %lld\n"       , mod->downup_read_req_state_exclusive_to_modified);
-		 if(mod->downup_read_req_state_exclusive_to_shared)       	 fprintf(f_st, "downup_read_req_state_exclusive_to_shared = %lld\n"         , mod->downup_read_req_state_exclusive_to_shared);
-		 if(mod->downup_read_req_state_exclusive_to_owned)        	 fprintf(f_st, "downup_read_req_state_exclusive_to_owned = %lld\n"          , mod->downup_read_req_state_exclusive_to_owned);
-		 if(mod->downup_read_req_state_exclusive_to_exclusive)    	 fprintf(f_st, "downup_read_req_state_exclusive_to_exclusive = %lld\n"      , mod->downup_read_req_state_exclusive_to_exclusive);
-		 fprintf(f_st, "\n===================DOWNUP WRITEBACK REQUESTS===========================================\n");
-		 if(mod->downup_wb_req_state_invalid_to_invalid)        	 fprintf(f_st, "downup_wb_req_state_invalid_to_invalid = %lld\n"          , mod->downup_wb_req_state_invalid_to_invalid);
-		 if(mod->downup_wb_req_state_invalid_to_noncoherent)    	 fprintf(f_st, "downup_wb_req_state_invalid_to_noncoherent = %lld\n"      , mod->downup_wb_req_state_invalid_to_noncoherent);
-		 if(mod->downup_wb_req_state_invalid_to_modified)       	 fprintf(f_st, "downup_wb_req_state_invalid_to_modified = %lld\n"         , mod->downup_wb_req_state_invalid_to_modified);
-		 if(mod->downup_wb_req_state_invalid_to_shared)         	 fprintf(f_st, "downup_wb_req_state_invalid_to_shared = %lld\n"           , mod->downup_wb_req_state_invalid_to_shared);
-		 if(mod->downup_wb_req_state_invalid_to_owned)          	 fprintf(f_st, "downup_wb_req_state_invalid_to_owned = %lld\n"            , mod->downup_wb_req_state_invalid_to_owned);
-		 if(mod->downup_wb_req_state_invalid_to_exclusive)      	 fprintf(f_st, "downup_wb_req_state_invalid_to_exclusive = %lld\n"        , mod->downup_wb_req_state_invalid_to_exclusive);
-		 if(mod->downup_wb_req_state_noncoherent_to_invalid)    	 fprintf(f_st, "downup_wb_req_state_noncoherent_to_invalid = %lld\n"      , mod->downup_wb_req_state_noncoherent_to_invalid);
-		 if(mod->downup_wb_req_state_noncoherent_to_noncoherent)	 fprintf(f_st, "downup_wb_req_state_noncoherent_to_noncoherent = %lld\n"  , mod->downup_wb_req_state_noncoherent_to_noncoherent);
-		 if(mod->downup_wb_req_state_noncoherent_to_modified)   	 fprintf(f_st, "downup_wb_req_state_noncoherent_to_modified = %lld\n"     , mod->downup_wb_req_state_noncoherent_to_modified);
-		 if(mod->downup_wb_req_state_noncoherent_to_shared)     	 fprintf(f_st, "downup_wb_req_state_noncoherent_to_shared = %lld\n"       , mod->downup_wb_req_state_noncoherent_to_shared);
-		 if(mod->downup_wb_req_state_noncoherent_to_owned)      	 fprintf(f_st, "downup_wb_req_state_noncoherent_to_owned = %lld\n"        , mod->downup_wb_req_state_noncoherent_to_owned);
-		 if(mod->downup_wb_req_state_noncoherent_to_exclusive)  	 fprintf(f_st, "downup_wb_req_state_noncoherent_to_exclusive = %lld\n"    , mod->downup_wb_req_state_noncoherent_to_exclusive);
-		 if(mod->downup_wb_req_state_modified_to_invalid)       	 fprintf(f_st, "downup_wb_req_state_modified_to_invalid = %lld\n"         , mod->downup_wb_req_state_modified_to_invalid);
-		 if(mod->downup_wb_req_state_modified_to_noncoherent)   	 fprintf(f_st, "downup_wb_req_state_modified_to_noncoherent = %lld\n"     , mod->downup_wb_req_state_modified_to_noncoherent);
-		 if(mod->downup_wb_req_state_modified_to_modified)      	 fprintf(f_st, "downup_wb_req_state_modified_to_modified = %lld\n"        , mod->downup_wb_req_state_modified_to_modified);
-		 if(mod->downup_wb_req_state_modified_to_shared)        	 fprintf(f_st, "downup_wb_req_state_modified_to_shared = %lld\n"          , mod->downup_wb_req_state_modified_to_shared);
-		 if(mod->downup_wb_req_state_modified_to_owned)         	 fprintf(f_st, "downup_wb_req_state_modified_to_owned = %lld\n"           , mod->downup_wb_req_state_modified_to_owned);
-		 if(mod->downup_wb_req_state_modified_to_exclusive)     	 fprintf(f_st, "downup_wb_req_state_modified_to_exclusive = %lld\n"       , mod->downup_wb_req_state_modified_to_exclusive);
-		 if(mod->downup_wb_req_state_shared_to_invalid)         	 fprintf(f_st, "downup_wb_req_state_shared_to_invalid = %lld\n"           , mod->downup_wb_req_state_shared_to_invalid);
-		 if(mod->downup_wb_req_state_shared_to_noncoherent)     	 fprintf(f_st, "downup_wb_req_state_shared_to_noncoherent = %lld\n"       , mod->downup_wb_req_state_shared_to_noncoherent);
-		 if(mod->downup_wb_req_state_shared_to_modified)        	 fprintf(f_st, "downup_wb_req_state_shared_to_modified = %lld\n"          , mod->downup_wb_req_state_shared_to_modified);
-		 if(mod->downup_wb_req_state_shared_to_shared)          	 fprintf(f_st, "downup_wb_req_state_shared_to_shared = %lld\n"            , mod->downup_wb_req_state_shared_to_shared);
-		 if(mod->downup_wb_req_state_shared_to_owned)           	 fprintf(f_st, "downup_wb_req_state_shared_to_owned = %lld\n"             , mod->downup_wb_req_state_shared_to_owned);
-		 if(mod->downup_wb_req_state_shared_to_exclusive)       	 fprintf(f_st, "downup_wb_req_state_shared_to_exclusive = %lld\n"         , mod->downup_wb_req_state_shared_to_exclusive);
-		 if(mod->downup_wb_req_state_owned_to_invalid)          	 fprintf(f_st, "downup_wb_req_state_owned_to_invalid = %lld\n"            , mod->downup_wb_req_state_owned_to_invalid);
-		 if(mod->downup_wb_req_state_owned_to_noncoherent)      	 fprintf(f_st, "downup_wb_req_state_owned_to_noncoherent = %lld\n"        , mod->downup_wb_req_state_owned_to_noncoherent);
-		 if(mod->downup_wb_req_state_owned_to_modified)         	 fprintf(f_st, "downup_wb_req_state_owned_to_modified = %lld\n"           , mod->downup_wb_req_state_owned_to_modified);
-		 if(mod->downup_wb_req_state_owned_to_shared)           	 fprintf(f_st, "downup_wb_req_state_owned_to_shared = %lld\n"             , mod->downup_wb_req_state_owned_to_shared);
-		 if(mod->downup_wb_req_state_owned_to_owned)            	 fprintf(f_st, "downup_wb_req_state_owned_to_owned = %lld\n"              , mod->downup_wb_req_state_owned_to_owned);
-		 if(mod->downup_wb_req_state_owned_to_exclusive)        	 fprintf(f_st, "downup_wb_req_state_owned_to_exclusive = %lld\n"          , mod->downup_wb_req_state_owned_to_exclusive);
-		 if(mod->downup_wb_req_state_exclusive_to_invalid)      	 fprintf(f_st, "downup_wb_req_state_exclusive_to_invalid = %lld\n"        , mod->downup_wb_req_state_exclusive_to_invalid);
-		 if(mod->downup_wb_req_state_exclusive_to_noncoherent)  	 fprintf(f_st, "downup_wb_req_state_exclusive_to_noncoherent = %lld\n"    , mod->downup_wb_req_state_exclusive_to_noncoherent);
-		 if(mod->downup_wb_req_state_exclusive_to_modified)     	 fprintf(f_st, "downup_wb_req_state_exclusive_to_modified = %lld\n"       , mod->downup_wb_req_state_exclusive_to_modified);
-		 if(mod->downup_wb_req_state_exclusive_to_shared)       	 fprintf(f_st, "downup_wb_req_state_exclusive_to_shared = %lld\n"         , mod->downup_wb_req_state_exclusive_to_shared);
-		 if(mod->downup_wb_req_state_exclusive_to_owned)        	 fprintf(f_st, "downup_wb_req_state_exclusive_to_owned = %lld\n"          , mod->downup_wb_req_state_exclusive_to_owned);
-		 if(mod->downup_wb_req_state_exclusive_to_exclusive)    	 fprintf(f_st, "downup_wb_req_state_exclusive_to_exclusive = %lld\n"      , mod->downup_wb_req_state_exclusive_to_exclusive);
-
-		 fprintf(f_st, "\n===============EVICTION REQUEST STATE SUMMARY==============================\n");
-		 fprintf(f_st, "eviction_request_state_invalid = %lld\n"            , mod->eviction_request_state_invalid);
-		 fprintf(f_st, "eviction_request_state_modified = %lld\n"           , mod->eviction_request_state_modified);
-		 fprintf(f_st, "eviction_request_state_owned = %lld\n"              , mod->eviction_request_state_owned);
-		 fprintf(f_st, "eviction_request_state_exclusive = %lld\n"          , mod->eviction_request_state_exclusive);
-		 fprintf(f_st, "eviction_request_state_shared = %lld\n"             , mod->eviction_request_state_shared);
-		 fprintf(f_st, "eviction_request_state_noncoherent = %lld\n"        , mod->eviction_request_state_noncoherent);
+		mod_stat_dump(mod, mod_stat_file_state, f_st);
 	 	 
 		 fprintf(f_as, "\n===============REQUEST ACCESS DISTRIBUTION==============================\n");
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_load[i]) fprintf(f_as, "request_load_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_load[i]);
+		 	if(mod->stats.request_load[i]) fprintf(f_as, "request_load_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_load[i]);
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_store[i]) fprintf(f_as, "request_store_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_store[i]);
+		 	if(mod->stats.request_store[i]) fprintf(f_as, "request_store_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_store[i]);
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_eviction[i]) fprintf(f_as, "request_eviction_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_eviction[i]);
+		 	if(mod->stats.request_eviction[i]) fprintf(f_as, "request_eviction_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_eviction[i]);
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_read[i]) fprintf(f_as, "request_read_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_read[i]);
+		 	if(mod->stats.request_read[i]) fprintf(f_as, "request_read_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_read[i]);
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_writeback[i]) fprintf(f_as, "request_writeback_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_writeback[i]);
+		 	if(mod->stats.request_writeback[i]) fprintf(f_as, "request_writeback_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_writeback[i]);
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_downup_read[i]) fprintf(f_as, "request_downup_read_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_downup_read[i]);
+		 	if(mod->stats.request_downup_read[i]) fprintf(f_as, "request_downup_read_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_downup_read[i]);
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_downup_writeback[i]) fprintf(f_as, "request_downup_writeback_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1,mod->request_downup_writeback[i]);
+		 	if(mod->stats.request_downup_writeback[i]) fprintf(f_as, "request_downup_writeback_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1,mod->stats.request_downup_writeback[i]);
 		 for(int i=0; i<10; i++)
-		 	if(mod->request_downup_eviction[i]) fprintf(f_as, "request_downup_eviction_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_downup_eviction[i]);
+		 	if(mod->stats.request_downup_eviction[i]) fprintf(f_as, "request_downup_eviction_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_downup_eviction[i]);
 		 for(int i=0; i<11; i++)
-		 	if(mod->request_processor[i]) fprintf(f_as, "request_processor_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_processor[i]);
+		 	if(mod->stats.request_processor[i]) fprintf(f_as, "request_processor_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_processor[i]);
 		 for(int i=0; i<11; i++)
-		 	if(mod->request_controller[i]) fprintf(f_as, "request_controller_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_controller[i]);
+		 	if(mod->stats.request_controller[i]) fprintf(f_as, "request_controller_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_controller[i]);
 		 for(int i=0; i<11; i++)
-		 	if(mod->request_updown[i]) fprintf(f_as, "request_updown_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_updown[i]);
+		 	if(mod->stats.request_updown[i]) fprintf(f_as, "request_updown_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_updown[i]);
 		 for(int i=0; i<11; i++)
-		 	if(mod->request_downup[i]) fprintf(f_as, "request_downup_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_downup[i]);
+		 	if(mod->stats.request_downup[i]) fprintf(f_as, "request_downup_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_downup[i]);
 		 for(int i=0; i<12; i++)
-		 	if(mod->request_total[i]) fprintf(f_as, "request_total_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->request_total[i]);
+		 	if(mod->stats.request_total[i]) fprintf(f_as, "request_total_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.request_total[i]);
 		
 		 fprintf(f_lc, "\n===============LATENCY COUNTER DISTRIBUTION==============================\n");
 			for(int i=0; i<10; i++)
-				if(mod->load_latency[i]) fprintf(f_lc, "load_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->load_latency[i]);
+				if(mod->stats.load_latency[i]) fprintf(f_lc, "load_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.load_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->store_latency[i]) fprintf(f_lc, "store_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->store_latency[i]);
+				if(mod->stats.store_latency[i]) fprintf(f_lc, "store_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.store_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->eviction_latency[i])	fprintf(f_lc, "eviction_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->eviction_latency[i]);
+				if(mod->stats.eviction_latency[i])	fprintf(f_lc, "eviction_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.eviction_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->downup_read_request_latency[i])	fprintf(f_lc, "downup_read_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->downup_read_request_latency[i]);
+				if(mod->stats.downup_read_request_latency[i])	fprintf(f_lc, "downup_read_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.downup_read_request_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->downup_writeback_request_latency[i]) fprintf(f_lc, "downup_writeback_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1,mod->downup_writeback_request_latency[i]);
+				if(mod->stats.downup_writeback_request_latency[i]) fprintf(f_lc, "downup_writeback_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1,mod->stats.downup_writeback_request_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->writeback_request_latency[i])	fprintf(f_lc, "writeback_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->writeback_request_latency[i]);
+				if(mod->stats.writeback_request_latency[i])	fprintf(f_lc, "writeback_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.writeback_request_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->read_request_latency[i]) fprintf(f_lc, "read_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->read_request_latency[i]);
+				if(mod->stats.read_request_latency[i]) fprintf(f_lc, "read_request_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.read_request_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->peer_latency[i]) fprintf(f_lc, "peer_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->peer_latency[i]);
+				if(mod->stats.peer_latency[i]) fprintf(f_lc, "peer_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.peer_latency[i]);
 			for(int i=0; i<10; i++)
-				if(mod->invalidate_latency[i]) fprintf(f_lc, "invalidate_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->invalidate_latency[i]);
+				if(mod->stats.invalidate_latency[i]) fprintf(f_lc, "invalidate_latency_range_%d_to_%d = %lld\n", pow_2(i-1), pow_2(i) - 1, mod->stats.invalidate_latency[i]);
 		
-		  fprintf(f_as, "\n===============DOWN-UP ACCESS SPECIAL STATISTICS==============================\n");
-			fprintf(f_as, "load_during_load_to_same_addr = %lld\n",                       mod->load_during_load_to_same_addr);
-			fprintf(f_as, "load_during_store_to_same_addr = %lld\n",                      mod->load_during_store_to_same_addr);
-			fprintf(f_as, "load_during_eviction_to_same_addr = %lld\n",                   mod->load_during_eviction_to_same_addr);
-			fprintf(f_as, "load_during_downup_read_req_to_same_addr = %lld\n",            mod->load_during_downup_read_req_to_same_addr);
-			fprintf(f_as, "load_during_downup_wb_req_to_same_addr = %lld\n",              mod->load_during_downup_wb_req_to_same_addr);
-			fprintf(f_as, "store_during_load_to_same_addr = %lld\n",                      mod->store_during_load_to_same_addr);
-			fprintf(f_as, "store_during_store_to_same_addr = %lld\n",                     mod->store_during_store_to_same_addr);
-			fprintf(f_as, "store_during_eviction_to_same_addr = %lld\n",                  mod->store_during_eviction_to_same_addr);
-			fprintf(f_as, "store_during_downup_read_req_to_same_addr = %lld\n",           mod->store_during_downup_read_req_to_same_addr);
-			fprintf(f_as, "store_during_downup_wb_req_to_same_addr = %lld\n",             mod->store_during_downup_wb_req_to_same_addr);
-			fprintf(f_as, "downup_read_req_during_load_to_same_addr = %lld\n",            mod->downup_read_req_during_load_to_same_addr);
-			fprintf(f_as, "downup_read_req_during_store_to_same_addr = %lld\n",           mod->downup_read_req_during_store_to_same_addr);
-			fprintf(f_as, "downup_read_req_during_eviction_to_same_addr = %lld\n",        mod->downup_read_req_during_eviction_to_same_addr);
-			fprintf(f_as, "downup_read_req_during_downup_read_req_to_same_addr = %lld\n", mod->downup_read_req_during_downup_read_req_to_same_addr);
-			fprintf(f_as, "downup_read_req_during_downup_wb_req_to_same_addr = %lld\n",   mod->downup_read_req_during_downup_wb_req_to_same_addr);
-			fprintf(f_as, "downup_wb_req_during_load_to_same_addr = %lld\n",              mod->downup_wb_req_during_load_to_same_addr);
-			fprintf(f_as, "downup_wb_req_during_store_to_same_addr = %lld\n",             mod->downup_wb_req_during_store_to_same_addr);
-			fprintf(f_as, "downup_wb_req_during_eviction_to_same_addr = %lld\n",          mod->downup_wb_req_during_eviction_to_same_addr);
-			fprintf(f_as, "downup_wb_req_during_downup_read_req_to_same_addr = %lld\n",   mod->downup_wb_req_during_downup_read_req_to_same_addr);
-			fprintf(f_as, "downup_wb_req_during_downup_wb_req_to_same_addr = %lld\n",     mod->downup_wb_req_during_downup_wb_req_to_same_addr);
-			
-		  fprintf(f_as, "\n===============DATA STATISTICS==============================\n");
-		  fprintf(f_as, "data_transfer_downup_load_request = %lld\n"            , mod->data_transfer_downup_load_request);
-		  fprintf(f_as, "data_transfer_downup_store_request = %lld\n"           , mod->data_transfer_downup_store_request);
-		  fprintf(f_as, "data_transfer_downup_eviction_request = %lld\n"        , mod->data_transfer_downup_eviction_request);
-		  fprintf(f_as, "peer_data_transfer_downup_load_request = %lld\n"       , mod->peer_data_transfer_downup_load_request);
-		  fprintf(f_as, "peer_data_transfer_downup_store_request = %lld\n"      , mod->peer_data_transfer_downup_store_request);
-		  fprintf(f_as, "data_transfer_updown_load_request = %lld\n"            , mod->data_transfer_updown_load_request);
-		  fprintf(f_as, "data_transfer_updown_store_request = %lld\n"           , mod->data_transfer_updown_store_request);
-		  fprintf(f_as, "data_transfer_eviction = %lld\n"                       , mod->data_transfer_eviction);
 		
 		//Network Debugging
 			if(mod->high_net)
@@ -998,6 +941,47 @@ void mem_system_dump_report(void)
 		fprintf(f_nt, "\n\n");
 	}
 
+	/* Report for each sliced cache. Its slices are consecutive in the
+	 * module list. */
+	for (i = 0; i < list_count(mem_system->mod_list); i++)
+	{
+		long long accesses;
+		long long max_accesses;
+		int slice;
+
+		mod = list_get(mem_system->mod_list, i);
+		if (!mod->slice_name || mod->slice_index)
+			continue;
+
+		fprintf(f, "[ %s ]\n", mod->slice_name);
+		fprintf(f, "\n");
+		fprintf(f, "Slices = %d\n", mod->num_slices);
+		fprintf(f, "SliceHash = %s\n", str_map_value(&mod_range_hash_map,
+			mod->range.interleaved.hash));
+		fprintf(f, "SliceAccesses =");
+		accesses = 0;
+		max_accesses = 0;
+		for (slice = 0; slice < mod->num_slices; slice++)
+		{
+			struct mod_t *slice_mod;
+
+			slice_mod = list_get(mem_system->mod_list, i + slice);
+			assert(slice_mod->slice_index == slice);
+			fprintf(f, " %lld", slice_mod->stats.accesses);
+			accesses += slice_mod->stats.accesses;
+			max_accesses = MAX(max_accesses, slice_mod->stats.accesses);
+		}
+		fprintf(f, "\n");
+		fprintf(f, "Accesses = %lld\n", accesses);
+		fprintf(f, "SliceImbalance = %.4g\n", accesses ?
+			(double) max_accesses * mod->num_slices / accesses : 0.0);
+		fprintf(f, "\n\n");
+	}
+
+	/* Report for each TLB */
+	for (i = 0; i < list_count(mem_system->tlb_list); i++)
+		tlb_dump(list_get(mem_system->tlb_list, i), f);
+
 	/* Dump report for networks */
 	for (i = 0; i < list_count(mem_system->net_list); i++)
 	{
@@ -1014,6 +998,21 @@ void mem_system_dump_report(void)
 }
 
 
+/* Reset the statistics of all modules, TLBs and networks, e.g. at the start
+ * of the region of interest. */
+void mem_system_reset_stats(void)
+{
+	int i;
+
+	for (i = 0; i < list_count(mem_system->mod_list); i++)
+		mod_reset_stats(list_get(mem_system->mod_list, i));
+	for (i = 0; i < list_count(mem_system->tlb_list); i++)
+		tlb_reset_stats(list_get(mem_system->tlb_list, i));
+	for (i = 0; i < list_count(mem_system->net_list); i++)
+		net_reset_stats(list_get(mem_system->net_list, i));
+}
+
+
 struct mod_t *mem_system_get_mod(char *mod_name)
 {
 	struct mod_t *mod;
@@ -1033,6 +1032,25 @@ struct mod_t *mem_system_get_mod(char *mod_name)
 }
 
 
+struct tlb_t *mem_system_get_tlb(char *tlb_name)
+{
+	struct tlb_t *tlb;
+
+	int tlb_id;
+
+	/* Look for TLB */
+	LIST_FOR_EACH(mem_system->tlb_list, tlb_id)
+	{
+		tlb = list_get(mem_system->tlb_list, tlb_id);
+		if (!strcasecmp(tlb->name, tlb_name))
+			return tlb;
+	}
+
+	/* Not found */
+	return NULL;
+}
+
+
 struct net_t *mem_system_get_net(char *net_name)
 {
 	struct net_t *net;
@@ -25,7 +25,21 @@
 #define MEM_PAGE_SHIFT  MEM_LOG_PAGE_SIZE
 #define MEM_PAGE_SIZE  (1 << MEM_LOG_PAGE_SIZE)
 #define MEM_PAGE_MASK  (~(MEM_PAGE_SIZE - 1))
-#define MEM_PAGE_COUNT  1024
+
+/* Two-level page table. The 20-bit page number is split into a directory
+ * index (high bits) and a page table index (low bits). */
+#define MEM_PAGE_DIR_BITS  10
+#define MEM_PAGE_DIR_SIZE  (1 << MEM_PAGE_DIR_BITS)
+#define MEM_PAGE_TABLE_BITS  (32 - MEM_LOG_PAGE_SIZE - MEM_PAGE_DIR_BITS)
+#define MEM_PAGE_TABLE_SIZE  (1 << MEM_PAGE_TABLE_BITS)
+#define MEM_PAGE_DIR_INDEX(addr)  ((addr) >> (MEM_LOG_PAGE_SIZE + MEM_PAGE_TABLE_BITS))
+#define MEM_PAGE_TABLE_INDEX(addr)  (((addr) >> MEM_LOG_PAGE_SIZE) & (MEM_PAGE_TABLE_SIZE - 1))
+
+/* Number of entries in the direct-mapped cache of recently accessed pages */
+#define MEM_PAGE_CACHE_SIZE  16
+
+/* Maximum number of accesses recorded for one instruction */
+#define MEM_RECORD_SIZE  16
 
 enum mem_access_t
 {
@@ -45,8 +59,21 @@ struct mem_page_t
 {
 	unsigned int tag;
 	enum mem_access_t perm;  /* Access permissions; combination of flags */
-	struct mem_page_t *next;
 	unsigned char *data;
+
+	/* Caches of decoded instructions set 'code' when they decode an
+	 * instruction from the page, and validate their entries against
+	 * 'version'. The version takes a value unique across all pages when the
+	 * page is created, and again when its data or permissions change while
+	 * 'code' is set. */
+	int code;
+	unsigned long long version;
+};
+
+struct mem_record_t
+{
+	unsigned int addr;
+	enum mem_access_t access;
 };
 
 struct mem_t
@@ -54,8 +81,12 @@ struct mem_t
 	/* Number of extra contexts sharing memory image */
 	int num_links;
 
-	/* Memory pages */
-	struct mem_page_t *pages[MEM_PAGE_COUNT];
+	/* Memory pages. Each directory entry points to a page table of
+	 * MEM_PAGE_TABLE_SIZE entries, allocated on demand. */
+	struct mem_page_t **page_dir[MEM_PAGE_DIR_SIZE];
+
+	/* Last accessed pages, indexed by the low bits of the page number */
+	struct mem_page_t *page_cache[MEM_PAGE_CACHE_SIZE];
 
 	/* Safe mode */
 	int safe;
@@ -65,6 +96,15 @@ struct mem_t
 
 	/* Last accessed address */
 	unsigned int last_address;
+
+	/* While 'record' is set, 'mem_read' and 'mem_write' append the accessed
+	 * addresses to 'record_list', up to MEM_RECORD_SIZE of them. Timing
+	 * models of emulators that do not report their memory accesses use this
+	 * to find the accesses of an instruction. The user clears 'record_count'
+	 * before emulating it. */
+	int record;
+	int record_count;
+	struct mem_record_t record_list[MEM_RECORD_SIZE];
 };
 
 extern unsigned long mem_mapped_space;
@@ -49,6 +49,14 @@ unsigned int mmu_page_mask;
 #define MMU_PAGE_HASH_SIZE  (1 << 10)
 #define MMU_PAGE_LIST_SIZE  (1 << 10)
 
+/* Physical region holding the page tables walked by the TLBs. Physical pages
+ * for data are assigned in ascending order from address 0, so page tables are
+ * placed high in the physical address space. The region stays below 2GB, since
+ * the memory hierarchy handles block tags as signed integers. */
+#define MMU_PAGE_TABLE_BASE  0x60000000u
+#define MMU_PAGE_TABLE_REGION_SIZE  0x20000000u
+#define MMU_PAGE_TABLE_ENTRY_SIZE  4
+
 /* Physical memory page */
 struct mmu_page_t
 {
@@ -264,6 +272,30 @@ unsigned int mmu_translate(int address_space_index, unsigned int vtl_addr)
 }
 
 
+/* Return the physical address of the page table entry read at level 'level'
+ * of a page table walk for virtual address 'vtl_addr'. Level 0 is the page
+ * directory, indexed by the upper bits of the virtual page number, and level 1
+ * is the page table, indexed by the full virtual page number. */
+unsigned int mmu_page_table_entry_addr(int address_space_index,
+	unsigned int vtl_addr, int level)
+{
+	unsigned int slot_size;
+	unsigned int base;
+	unsigned int index;
+
+	/* Each address space gets a slot large enough for its page directory
+	 * and a flat page table covering the whole virtual address space. */
+	slot_size = (MMU_PAGE_TABLE_ENTRY_SIZE << (32 - mmu_log_page_size)) * 2;
+	base = MMU_PAGE_TABLE_BASE + (address_space_index %
+		(MMU_PAGE_TABLE_REGION_SIZE / slot_size)) * slot_size;
+	index = vtl_addr >> mmu_log_page_size;
+	if (!level)
+		return base + (index >> (mmu_log_page_size - 2)) *
+			MMU_PAGE_TABLE_ENTRY_SIZE;
+	return base + mmu_page_size + index * MMU_PAGE_TABLE_ENTRY_SIZE;
+}
+
+
 int mmu_valid_phy_addr(unsigned int phy_addr)
 {
 	int index;
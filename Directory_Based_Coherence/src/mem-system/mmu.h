@@ -41,6 +41,8 @@ void mmu_dump_report(void);
 
 int mmu_address_space_new(void);
 unsigned int mmu_translate(int address_space_index, unsigned int vtl_addr);
+unsigned int mmu_page_table_entry_addr(int address_space_index,
+	unsigned int vtl_addr, int level);
 int mmu_valid_phy_addr(unsigned int phy_addr);
 
 void mmu_access_page(unsigned int phy_addr, enum mmu_access_t access);
@@ -67,6 +67,17 @@ struct mod_stack_t
 	struct mod_t *except_mod;
 	struct mod_t *peer;
 
+	/* TLB the access is being translated in, if any. For a TLB access,
+	 * 'mod' and 'addr' are the module and physical address that the access
+	 * is forwarded to once the translation completes, and 'tlb_forward_id'
+	 * is the ID of the module access. */
+	struct tlb_t *tlb;
+	int address_space_index;
+	unsigned int vtl_addr;
+	int tlb_walk_level;
+	long long tlb_walk_start_cycle;
+	long long tlb_forward_id;
+
 	struct mod_port_t *port;
 
 	unsigned int addr;
@@ -91,6 +102,10 @@ struct mod_stack_t
 	struct mod_stack_t *access_list_prev;
 	struct mod_stack_t *access_list_next;
 
+	/* Linked list of translated accesses forwarded by 'tlb' */
+	struct mod_stack_t *forward_list_prev;
+	struct mod_stack_t *forward_list_next;
+
 	/* Linked list of write accesses in 'mod' */
 	struct mod_stack_t *write_access_list_prev;
 	struct mod_stack_t *write_access_list_next;
@@ -107,12 +122,19 @@ struct mod_stack_t
 	int write : 1;
 	int nc_write : 1;
 	int prefetch : 1;
+	int prefetch_late : 1;  /* Prefetch demanded while in flight */
 	int blocking : 1;
 	int writeback : 1;
 	int eviction : 1;
 	int retry : 1;
+	int lock_retry : 1;  /* Waiting in a lock queue to be retried */
+	int forward : 1;  /* Read whose target sends the block to the peer */
+	int refetch : 1;  /* Read of a block tracked by the requester without data */
+	int write_through : 1;  /* Eviction of dirty data that keeps the block */
 	int coalesced : 1;
 	int port_locked : 1;
+	int tlb_miss : 1;
+	int tlb_walk : 1;
 	//------------------------------------------------
 	// Flag to indicate that WriteBack to upper level (up-down WB request) is a result of invalidation due to Load/Store/Eviction process.
 	//------------------------------------------------
@@ -147,10 +169,22 @@ struct mod_stack_t
 	 * This field has a value other than NULL only if 'coalesced' is TRUE. */
 	struct mod_stack_t *master_stack;
 
+	/* MSHR entry allocated by this access as a primary miss, and cycle
+	 * when it started waiting for a free entry, if the MSHR file was full. */
+	struct mshr_entry_t *mshr_entry;
+	long long mshr_stall_start_cycle;
+
 	/* Events waiting in directory lock */
 	int dir_lock_event;
 	struct mod_stack_t *dir_lock_next;
 
+	/* Directory lock found busy by a non-blocking access of this request.
+	 * If the memory system uses lock queues, the request waits for it to be
+	 * released before retrying. */
+	struct mod_t *conflict_mod;
+	int conflict_set;
+	int conflict_way;
+
 	/* Return stack */
 	struct mod_stack_t *ret_stack;
 	int ret_event;
@@ -0,0 +1,95 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEM_SYSTEM_MOD_STAT_H
+#define MEM_SYSTEM_MOD_STAT_H
+
+#include <stdio.h>
+
+
+/* Registry of the counters of a memory module. Each counter is declared once
+ * in 'mod-stat.dat', and stored in array 'stats.counters' of 'struct mod_t',
+ * indexed by its identifier. Dump is generic, and the counters are reset with
+ * the rest of the module statistics. A counter flagged as disabled is removed
+ * at compile time from the code updating it. */
+
+struct mod_t;
+
+/* Flags of a counter */
+#define MOD_STAT_NONZERO  0x1
+#define MOD_STAT_DISABLED  0x2
+
+/* Report files */
+enum mod_stat_file_t
+{
+	mod_stat_file_access = 0,
+	mod_stat_file_state
+};
+
+/* Counter identifiers */
+enum mod_stat_t
+{
+#define DEFSECTION(file, title)
+#define DEFSTAT(name, flags) \
+	mod_stat_##name,
+#include "mod-stat.dat"
+#undef DEFSECTION
+#undef DEFSTAT
+
+	mod_stat_count
+};
+
+/* Constants 'mod_stat_enabled_<name>', used by the update macros */
+enum
+{
+#define DEFSECTION(file, title)
+#define DEFSTAT(name, flags) \
+	mod_stat_enabled_##name = !((flags) & MOD_STAT_DISABLED),
+#include "mod-stat.dat"
+#undef DEFSECTION
+#undef DEFSTAT
+
+	mod_stat_enabled_dummy
+};
+
+struct mod_stat_info_t
+{
+	char *name;
+	int flags;
+};
+
+extern struct mod_stat_info_t mod_stat_info[mod_stat_count];
+
+/* Access to a counter given its name */
+#define MOD_STAT(mod, name) \
+	((mod)->stats.counters[mod_stat_##name])
+#define MOD_STAT_ADD(mod, name, value) \
+	do { if (mod_stat_enabled_##name) MOD_STAT(mod, name) += (value); } while (0)
+#define MOD_STAT_INC(mod, name) \
+	MOD_STAT_ADD(mod, name, 1)
+
+/* Increment of a counter given its identifier, computed at run time */
+#define MOD_STAT_INC_ID(mod, stat) \
+	do { if (!(mod_stat_info[stat].flags & MOD_STAT_DISABLED)) \
+		(mod)->stats.counters[stat]++; } while (0)
+
+void mod_stat_dump(struct mod_t *mod, enum mod_stat_file_t file, FILE *f);
+
+#endif
+
@@ -75,6 +75,7 @@ int EV_MOD_NMOESI_EVICT_ACTION;
 int EV_MOD_NMOESI_EVICT_RECEIVE;
 int EV_MOD_NMOESI_EVICT_PROCESS;
 int EV_MOD_NMOESI_EVICT_PROCESS_NONCOHERENT;
+int EV_MOD_NMOESI_EVICT_WRITE_THROUGH;
 int EV_MOD_NMOESI_EVICT_REPLY;
 int EV_MOD_NMOESI_EVICT_REPLY_RECEIVE;
 int EV_MOD_NMOESI_EVICT_FINISH;
@@ -120,6 +121,78 @@ int EV_MOD_NMOESI_MESSAGE_FINISH;
 
 
 
+/* Retry an access that got an error because a non-blocking request found a
+ * directory entry locked. With lock queues, the access waits in the queue of
+ * that entry and is resumed with 'event' when it is unlocked. Otherwise, or
+ * if the entry was released in the meantime, it is retried after a random
+ * latency. */
+static void mod_nmoesi_retry(struct mod_t *mod, struct mod_stack_t *stack, int event)
+{
+	struct mod_t *conflict_mod = stack->conflict_mod;
+	int retry_lat;
+
+	stack->retry = 1;
+	stack->conflict_mod = NULL;
+	if (mem_lock_queue && conflict_mod && dir_entry_wait(conflict_mod->dir,
+			stack->conflict_set, stack->conflict_way, event, stack))
+	{
+		mem_debug("    lock error, waiting for %s to unlock set=%d, way=%d\n",
+			conflict_mod->name, stack->conflict_set, stack->conflict_way);
+		mod->stats.queued_retries++;
+		return;
+	}
+
+	retry_lat = mod_get_retry_latency(mod);
+	mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
+	esim_schedule_event(event, stack, retry_lat);
+}
+
+/* Return whether every sub-block of 'target_mod' requested by 'mod' has an
+ * owner or a forwarder among the other higher-level modules, which sends it
+ * to 'mod' on a read request. */
+static int mod_nmoesi_sent_by_high_mod(struct mod_t *target_mod,
+	struct mod_t *mod, struct mod_stack_t *stack)
+{
+	struct dir_t *dir = target_mod->dir;
+	struct dir_entry_t *dir_entry;
+	struct net_node_t *node;
+	struct mod_t *forwarder;
+	uint32_t dir_entry_tag, z;
+
+	for (z = 0; z < dir->zsize; z++)
+	{
+		dir_entry_tag = stack->tag + z * target_mod->sub_block_size;
+		if (dir_entry_tag < stack->addr || dir_entry_tag >= stack->addr + mod->block_size)
+			continue;
+		dir_entry = dir_entry_get(dir, stack->set, stack->way, z);
+		if (DIR_ENTRY_VALID_OWNER(dir_entry))
+			continue;
+		if (!target_mod->forward_state || !DIR_ENTRY_VALID_FORWARDER(dir_entry) ||
+			dir_entry->forwarder == mod->low_net_node->index)
+			return 0;
+		node = list_get(target_mod->high_net->node_list, dir_entry->forwarder);
+		forwarder = node->user_data;
+		if (forwarder->block_size != mod->block_size)
+			return 0;
+	}
+	return 1;
+}
+
+/* Return whether 'target_mod' can finish a write request in a block it has
+ * locked without reading it from the lower-level module. A block without data
+ * can only be supplied if one of the invalidated higher-level modules
+ * returned it or sent it to the requester. */
+static int mod_nmoesi_write_has_data(struct mod_t *target_mod,
+	struct mod_stack_t *stack)
+{
+	int state;
+
+	if (mod_block_has_data(target_mod, stack->set, stack->way))
+		return 1;
+	cache_get_block(target_mod->cache, stack->set, stack->way, NULL, &state);
+	return state == cache_block_modified || stack->reply_size == 8;
+}
+
 /* NMOESI Protocol */
 
 void mod_handler_nmoesi_load(int event, void *data)
@@ -130,9 +203,13 @@ void mod_handler_nmoesi_load(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_LOAD)
 	{
 		struct mod_stack_t *master_stack;
+		struct mshr_entry_t *mshr_entry;
 
 		mem_debug("%lld %lld 0x%x %s load\n", esim_time, stack->id,
 			stack->addr, mod->name);
@@ -153,12 +230,25 @@ void mod_handler_nmoesi_load(int event, void *data)
 		mod->num_load_requests++;
 		mod_update_request_counters(mod, mod_trans_load);
 
+		/* Account for late prefetches */
+		prefetcher_access_start(stack, mod);
+
+		/* Secondary miss, attach to the MSHR entry of the primary miss */
+		mshr_entry = mod_mshr_find(mod, stack->addr);
+		if (mshr_entry && mod_mshr_can_merge(mod, mshr_entry, stack))
+		{
+			mod->stats.reads++;
+			MOD_STAT_INC(mod, coalesced_loads);
+			mod_mshr_merge(mod, mshr_entry, stack, EV_MOD_NMOESI_LOAD_FINISH);
+			return;
+		}
+
 		/* Coalesce access */
 		master_stack = mod_can_coalesce(mod, mod_access_load, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->reads++;
-			mod->coalesced_loads++;
+			mod->stats.reads++;
+			MOD_STAT_INC(mod, coalesced_loads);
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_NMOESI_LOAD_FINISH);
 			return;
@@ -192,8 +282,8 @@ void mod_handler_nmoesi_load(int event, void *data)
 			if(stack->load_access_waiting_for_store_start_cycle == 0)
 			{
 				stack->load_access_waiting_for_store_start_cycle = esim_cycle();
-				mod->read_waiting_for_other_accesses++;
-				mod->loads_waiting_for_stores++;
+				MOD_STAT_INC(mod, read_waiting_for_other_accesses);
+				MOD_STAT_INC(mod, loads_waiting_for_stores);
 			}
 
 			return;
@@ -217,8 +307,8 @@ void mod_handler_nmoesi_load(int event, void *data)
 			if(stack->load_access_waiting_start_cycle == 0)
 			{
 				stack->load_access_waiting_start_cycle = esim_cycle();
-				mod->read_waiting_for_other_accesses++;
-				mod->loads_waiting_for_non_coalesced_accesses++;
+				MOD_STAT_INC(mod, read_waiting_for_other_accesses);
+				MOD_STAT_INC(mod, loads_waiting_for_non_coalesced_accesses);
 			}
 
 			return;
@@ -246,8 +336,6 @@ void mod_handler_nmoesi_load(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_LOAD_ACTION)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s load action\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:load_action\"\n",
@@ -256,11 +344,8 @@ void mod_handler_nmoesi_load(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->read_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_LOAD_LOCK, stack, retry_lat);
+			mod->stats.read_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_LOAD_LOCK);
 			return;
 		}
 
@@ -277,8 +362,17 @@ void mod_handler_nmoesi_load(int event, void *data)
 			return;
 		}
 
+		/* Primary miss. If there is no free MSHR entry, unlock the block
+		 * and wait for an entry to be released. */
+		if (!stack->mshr_entry && !mod_mshr_allocate(mod, stack))
+		{
+			dir_entry_unlock(mod->dir, stack->set, stack->way);
+			mod_stack_wait_in_mod(stack, mod, EV_MOD_NMOESI_LOAD_LOCK);
+			return;
+		}
+
 		// Update counter for generation of a Up-down read request
-		mod->updown_read_requests_generated++;
+		MOD_STAT_INC(mod, updown_read_requests_generated);
 
 		/* Miss */
 		new_stack = mod_stack_create(stack->id, mod, stack->tag,
@@ -296,7 +390,6 @@ void mod_handler_nmoesi_load(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_LOAD_MISS)
 	{
-		int retry_lat;
 		int next_state;
 
 		mem_debug("  %lld %lld 0x%x %s load miss\n", esim_time, stack->id,
@@ -307,12 +400,9 @@ void mod_handler_nmoesi_load(int event, void *data)
 		/* Error on read request. Unlock block and retry load. */
 		if (stack->err)
 		{
-			mod->read_retries++;
-			retry_lat = mod_get_retry_latency(mod);
+			mod->stats.read_retries++;
 			dir_entry_unlock(mod->dir, stack->set, stack->way);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_LOAD_LOCK, stack, retry_lat);
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_LOAD_LOCK);
 			return;
 		}
 
@@ -343,6 +433,9 @@ void mod_handler_nmoesi_load(int event, void *data)
 		/* Unlock directory entry */
 		dir_entry_unlock(mod->dir, stack->set, stack->way);
 		
+		/* Release MSHR entry */
+		mod_mshr_release(mod, stack);
+
 		/* Impose the access latency before continuing */
 		esim_schedule_event(EV_MOD_NMOESI_LOAD_FINISH, stack, 
 			mod->latency);
@@ -401,9 +494,13 @@ void mod_handler_nmoesi_store(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_STORE)
 	{
 		struct mod_stack_t *master_stack;
+		struct mshr_entry_t *mshr_entry;
 
 		mem_debug("%lld %lld 0x%x %s store\n", esim_time, stack->id,
 			stack->addr, mod->name);
@@ -422,12 +519,30 @@ void mod_handler_nmoesi_store(int event, void *data)
 		mod->num_store_requests++;
 		mod_update_request_counters(mod, mod_trans_store);
 
+		/* Account for late prefetches */
+		prefetcher_access_start(stack, mod);
+
+		/* Secondary miss, merge into the pending fill of the primary miss */
+		mshr_entry = mod_mshr_find(mod, stack->addr);
+		if (mshr_entry && mod_mshr_can_merge(mod, mshr_entry, stack))
+		{
+			mod->stats.writes++;
+			MOD_STAT_INC(mod, coalesced_stores);
+			mod_mshr_merge(mod, mshr_entry, stack, EV_MOD_NMOESI_STORE_FINISH);
+
+			/* Increment witness variable */
+			if (stack->witness_ptr)
+				(*stack->witness_ptr)++;
+
+			return;
+		}
+
 		/* Coalesce access */
 		master_stack = mod_can_coalesce(mod, mod_access_store, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->writes++;
-			mod->coalesced_stores++;
+			mod->stats.writes++;
+			MOD_STAT_INC(mod, coalesced_stores);
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_NMOESI_STORE_FINISH);
 
@@ -468,7 +583,7 @@ void mod_handler_nmoesi_store(int event, void *data)
 			if(stack->store_access_waiting_start_cycle == 0)
 			{
 				stack->store_access_waiting_start_cycle = esim_cycle();
-		  	mod->write_waiting_for_other_accesses++;
+		  	MOD_STAT_INC(mod, write_waiting_for_other_accesses);
 			}
 			return;
 		}
@@ -497,8 +612,6 @@ void mod_handler_nmoesi_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_STORE_ACTION)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s store action\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:store_action\"\n",
@@ -507,11 +620,8 @@ void mod_handler_nmoesi_store(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_STORE_LOCK, stack, retry_lat);
+			mod->stats.write_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_STORE_LOCK);
 			return;
 		}
 
@@ -530,8 +640,17 @@ void mod_handler_nmoesi_store(int event, void *data)
 			return;
 		}
 
+		/* Primary miss. If there is no free MSHR entry, unlock the block
+		 * and wait for an entry to be released. */
+		if (!stack->mshr_entry && !mod_mshr_allocate(mod, stack))
+		{
+			dir_entry_unlock(mod->dir, stack->set, stack->way);
+			mod_stack_wait_in_mod(stack, mod, EV_MOD_NMOESI_STORE_LOCK);
+			return;
+		}
+
 		// Update counter for generation of a Up-down WB request
-		mod->updown_writeback_requests_generated++;
+		MOD_STAT_INC(mod, updown_writeback_requests_generated);
 		/* Miss - state=O/S/I/N */
 		new_stack = mod_stack_create(stack->id, mod, stack->tag,
 			EV_MOD_NMOESI_STORE_UNLOCK, stack);
@@ -548,7 +667,6 @@ void mod_handler_nmoesi_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_STORE_UNLOCK)
 	{
-		int retry_lat;
 		int next_state;
 
 		mem_debug("  %lld %lld 0x%x %s store unlock\n", esim_time, stack->id,
@@ -559,12 +677,9 @@ void mod_handler_nmoesi_store(int event, void *data)
 		/* Error in write request, unlock block and retry store. */
 		if (stack->err)
 		{
-			mod->write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
+			mod->stats.write_retries++;
 			dir_entry_unlock(mod->dir, stack->set, stack->way);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_STORE_LOCK, stack, retry_lat);
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_STORE_LOCK);
 			return;
 		}
 
@@ -576,6 +691,9 @@ void mod_handler_nmoesi_store(int event, void *data)
 
 		mod_update_state_modification_counters(mod, stack->prev_state, next_state, mod_trans_store);
 
+		/* Release MSHR entry */
+		mod_mshr_release(mod, stack);
+
 		/* Impose the access latency before continuing */
 		esim_schedule_event(EV_MOD_NMOESI_STORE_FINISH, stack, 
 			mod->latency);
@@ -627,6 +745,9 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_NC_STORE)
 	{
 		struct mod_stack_t *master_stack;
@@ -643,7 +764,7 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		master_stack = mod_can_coalesce(mod, mod_access_nc_store, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->nc_writes++;
+			mod->stats.nc_writes++;
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_NMOESI_NC_STORE_FINISH);
 			return;
@@ -694,8 +815,6 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_NC_STORE_WRITEBACK)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s nc store writeback\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:nc_store_writeback\"\n",
@@ -704,11 +823,8 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->nc_write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_NC_STORE_LOCK, stack, retry_lat);
+			mod->stats.nc_write_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_NC_STORE_LOCK);
 			return;
 		}
 
@@ -732,8 +848,6 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_NC_STORE_ACTION)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s nc store action\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:nc_store_action\"\n",
@@ -742,11 +856,8 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->nc_write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_NC_STORE_LOCK, stack, retry_lat);
+			mod->stats.nc_write_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_NC_STORE_LOCK);
 			return;
 		}
 
@@ -795,8 +906,6 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_NC_STORE_MISS)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s nc store miss\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:nc_store_miss\"\n",
@@ -805,12 +914,9 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		/* Error on read request. Unlock block and retry nc store. */
 		if (stack->err)
 		{
-			mod->nc_write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
+			mod->stats.nc_write_retries++;
 			dir_entry_unlock(mod->dir, stack->set, stack->way);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_NC_STORE_LOCK, stack, retry_lat);
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_NC_STORE_LOCK);
 			return;
 		}
 
@@ -880,6 +986,9 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_PREFETCH)
 	{
 		struct mod_stack_t *master_stack;
@@ -901,7 +1010,7 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			mem_debug("  %lld %lld 0x%x %s useless prefetch - already being fetched\n",
 				  esim_time, stack->id, stack->addr, mod->name);
 
-			mod->useless_prefetches++;
+			mod->stats.useless_prefetches++;
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 
 			/* Increment witness variable */
@@ -966,7 +1075,7 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			Effectively this means that prefetches are of low priority.
 			This can be improved to not retry only when the current lock
 			holder is writing to the block. */
-			mod->prefetch_aborts++;
+			mod->stats.prefetch_aborts++;
 			mem_debug("    lock error, aborting prefetch\n");
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 			return;
@@ -979,12 +1088,22 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			mem_debug("  %lld %lld 0x%x %s useless prefetch - cache hit\n",
 				  esim_time, stack->id, stack->addr, mod->name);
 
-			mod->useless_prefetches++;
+			mod->stats.useless_prefetches++;
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_UNLOCK, stack, 0);
 			return;
 		}
 
-		/* Miss */
+		/* Miss. Prefetches do not wait for a free MSHR entry. */
+		if (!mod_mshr_can_allocate(mod))
+		{
+			mod->stats.prefetch_aborts++;
+			dir_entry_unlock(mod->dir, stack->set, stack->way);
+			mem_debug("    MSHR full, aborting prefetch\n");
+			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
+			return;
+		}
+		mod_mshr_allocate(mod, stack);
+
 		new_stack = mod_stack_create(stack->id, mod, stack->tag,
 			EV_MOD_NMOESI_PREFETCH_MISS, stack);
 		new_stack->peer = mod_stack_set_peer(mod, stack->state);
@@ -1007,8 +1126,9 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			/* Don't want to ever retry prefetches if read request failed. 
 			 * Effectively this means that prefetches are of low priority.
 			 * This can be improved depending on the reason for read request fail */
-			mod->prefetch_aborts++;
+			mod->stats.prefetch_aborts++;
 			dir_entry_unlock(mod->dir, stack->set, stack->way);
+			mod_mshr_release(mod, stack);
 			mem_debug("    lock error, aborting prefetch\n");
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 			return;
@@ -1021,13 +1141,17 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 		cache_set_block(mod->cache, stack->set, stack->way, stack->tag,
 			stack->shared ? cache_block_shared : cache_block_exclusive);
 
+		/* A prefetched block is held for its data */
+		if (mod->inclusion != mod_inclusion_inclusive)
+			mod_block_alloc_data(mod, stack->set, stack->way);
+
 		/* Mark the prefetched block as prefetched. This is needed to let the 
 		 * prefetcher know about an actual access to this block so that it
 		 * is aware of all misses as they would be without the prefetcher. 
 		 * TODO: The lower caches that will be filled because of this prefetch
 		 * do not know if it was a prefetch or not. Need to have a way to mark
 		 * them as prefetched too. */
-		mod_block_set_prefetched(mod, stack->addr, 1);
+		prefetcher_access_fill(stack, mod);
 
 		/* Continue */
 		esim_schedule_event(EV_MOD_NMOESI_PREFETCH_UNLOCK, stack, 0);
@@ -1044,6 +1168,9 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 		/* Unlock directory entry */
 		dir_entry_unlock(mod->dir, stack->set, stack->way);
 
+		/* Release MSHR entry */
+		mod_mshr_release(mod, stack);
+
 		/* Continue */
 		esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 		return;
@@ -1090,6 +1217,9 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_FIND_AND_LOCK)
 	{
 		mem_debug("  %lld %lld 0x%x %s find and lock (blocking=%d)\n",
@@ -1111,6 +1241,7 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 	if (event == EV_MOD_NMOESI_FIND_AND_LOCK_PORT)
 	{
 		struct mod_port_t *port = stack->port;
+		struct mod_stack_t *iter;
 		struct dir_lock_t *dir_lock;
 
 		assert(stack->port);
@@ -1141,84 +1272,84 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 				str_map_value(&cache_block_state_map, stack->state));
 
 		/* Statistics */
-		mod->accesses++;
+		mod->stats.accesses++;
 		if (stack->hit)
-			mod->hits++;
+			mod->stats.hits++;
 
 		if (stack->read)
 		{
-			mod->reads++;
+			mod->stats.reads++;
 
-			if(stack->downup_read_request) mod->downup_read_requests++;
-			else                    			 mod->load_requests++;
+			if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_requests);
+			else                    			 MOD_STAT_INC(mod, load_requests);
 
-			mod->effective_reads++;
-			stack->blocking ? mod->blocking_reads++ : mod->non_blocking_reads++;
+			mod->stats.effective_reads++;
+			stack->blocking ? mod->stats.blocking_reads++ : mod->stats.non_blocking_reads++;
 			if (stack->hit)
 			{
-				mod->read_hits++;
+				mod->stats.read_hits++;
 
-				if(stack->downup_read_request) mod->downup_read_requests_hits++;
-				else 													 mod->load_requests_hits++;
+				if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_requests_hits);
+				else 													 MOD_STAT_INC(mod, load_requests_hits);
 
 				if(ret->request_dir == mod_request_down_up)
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->sharer_req_state_modified++; break;
-						case cache_block_owned	     : mod->sharer_req_state_owned++; break;
-						case cache_block_exclusive   : mod->sharer_req_state_exclusive++; break;
-						case cache_block_shared      : mod->sharer_req_state_shared++; break;
-						case cache_block_noncoherent : mod->sharer_req_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, sharer_req_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, sharer_req_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, sharer_req_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, sharer_req_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, sharer_req_state_noncoherent); break;
 					}
 				}
 				else
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->read_state_modified++; break;
-						case cache_block_owned	     : mod->read_state_owned++; break;
-						case cache_block_exclusive   : mod->read_state_exclusive++; break;
-						case cache_block_shared      : mod->read_state_shared++; break;
-						case cache_block_noncoherent : mod->read_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, read_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, read_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, read_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, read_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, read_state_noncoherent); break;
 					}
 				}
 			}
 			else
 			{
 				if(ret->request_dir == mod_request_down_up)
-					mod->sharer_req_state_invalid++;
+					MOD_STAT_INC(mod, sharer_req_state_invalid);
 				else
-					mod->read_state_invalid++;
+					MOD_STAT_INC(mod, read_state_invalid);
 
-		  	if(stack->downup_read_request) mod->downup_read_requests_misses++;
-				else 													 mod->load_requests_misses++;
+		  	if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_requests_misses);
+				else 													 MOD_STAT_INC(mod, load_requests_misses);
 			}
 
 		}
 		else if (stack->prefetch)
 		{
-			mod->prefetches++;
+			mod->stats.prefetches++;
 		}
 		else if (stack->nc_write)  /* Must go after read */
 		{
-			mod->nc_writes++;
-			mod->effective_nc_writes++;
-			stack->blocking ? mod->blocking_nc_writes++ : mod->non_blocking_nc_writes++;
+			mod->stats.nc_writes++;
+			mod->stats.effective_nc_writes++;
+			stack->blocking ? mod->stats.blocking_nc_writes++ : mod->stats.non_blocking_nc_writes++;
 			if (stack->hit)
-				mod->nc_write_hits++;
+				mod->stats.nc_write_hits++;
 		}
 		else if (stack->write)
 		{
-			mod->writes++;
-			mod->effective_writes++;
-			stack->blocking ? mod->blocking_writes++ : mod->non_blocking_writes++;
+			mod->stats.writes++;
+			mod->stats.effective_writes++;
+			stack->blocking ? mod->stats.blocking_writes++ : mod->stats.non_blocking_writes++;
 			
-			if(stack->evict_trans) mod->writeback_due_to_eviction++;
+			if(stack->evict_trans) MOD_STAT_INC(mod, writeback_due_to_eviction);
 
 			// Here we donot consider the effects of evict transactions while considering a Store/Up-down writeback as for a lower level module it is the writeback requests.	
-			if(stack->downup_writeback_request) mod->downup_writeback_requests++;
-			else                                mod->store_requests++;
+			if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_requests);
+			else                                MOD_STAT_INC(mod, store_requests);
 
 			/* Increment witness variable when port is locked */
 			if (stack->witness_ptr)
@@ -1229,47 +1360,47 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 
 			if (stack->hit)
 			{
-				mod->write_hits++;
+				mod->stats.write_hits++;
 
-				if(stack->evict_trans) mod->writeback_due_to_eviction_hits++;
+				if(stack->evict_trans) MOD_STAT_INC(mod, writeback_due_to_eviction_hits);
 
-				if(stack->downup_writeback_request) mod->downup_writeback_requests_hits++;
-				else                                mod->store_requests_hits++;
+				if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_requests_hits);
+				else                                MOD_STAT_INC(mod, store_requests_hits);
 
 				if(ret->request_dir == mod_request_down_up)
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->sharer_req_state_modified++; break;
-						case cache_block_owned	     : mod->sharer_req_state_owned++; break;
-						case cache_block_exclusive   : mod->sharer_req_state_exclusive++; break;
-						case cache_block_shared      : mod->sharer_req_state_shared++; break;
-						case cache_block_noncoherent : mod->sharer_req_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, sharer_req_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, sharer_req_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, sharer_req_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, sharer_req_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, sharer_req_state_noncoherent); break;
 					}
 				}
 				else
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->write_state_modified++; break;
-						case cache_block_owned	     : mod->write_state_owned++; break;
-						case cache_block_exclusive   : mod->write_state_exclusive++; break;
-						case cache_block_shared      : mod->write_state_shared++; break;
-						case cache_block_noncoherent : mod->write_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, write_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, write_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, write_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, write_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, write_state_noncoherent); break;
 					}
 				}
 			}
 			else
 			{
 				if(ret->request_dir == mod_request_down_up)
-					mod->sharer_req_state_invalid++;
+					MOD_STAT_INC(mod, sharer_req_state_invalid);
 				else
-					mod->write_state_invalid++;
+					MOD_STAT_INC(mod, write_state_invalid);
 				
-				if(stack->evict_trans) mod->writeback_due_to_eviction_misses++;
+				if(stack->evict_trans) MOD_STAT_INC(mod, writeback_due_to_eviction_misses);
 
-				if(stack->downup_writeback_request) mod->downup_writeback_requests_misses++;
-				else                                mod->store_requests_misses++;
+				if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_requests_misses);
+				else                                MOD_STAT_INC(mod, store_requests_misses);
 			}
 		}
 		else if (stack->message)
@@ -1283,27 +1414,27 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 
 		if (!stack->retry)
 		{
-			mod->no_retry_accesses++;
+			mod->stats.no_retry_accesses++;
 			if (stack->hit)
-				mod->no_retry_hits++;
+				mod->stats.no_retry_hits++;
 			
 			if (stack->read)
 			{
-				mod->no_retry_reads++;
+				mod->stats.no_retry_reads++;
 				if (stack->hit)
-					mod->no_retry_read_hits++;
+					mod->stats.no_retry_read_hits++;
 			}
 			else if (stack->nc_write)  /* Must go after read */
 			{
-				mod->no_retry_nc_writes++;
+				mod->stats.no_retry_nc_writes++;
 				if (stack->hit)
-					mod->no_retry_nc_write_hits++;
+					mod->stats.no_retry_nc_write_hits++;
 			}
 			else if (stack->write)
 			{
-				mod->no_retry_writes++;
+				mod->stats.no_retry_writes++;
 				if (stack->hit)
-					mod->no_retry_write_hits++;
+					mod->stats.no_retry_write_hits++;
 			}
 			else if (stack->prefetch)
 			{
@@ -1337,6 +1468,14 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 			mem_debug("    %lld 0x%x %s block locked at set=%d, way=%d by A-%lld - aborting\n",
 				stack->id, stack->tag, mod->name, stack->set, stack->way, dir_lock->stack_id);
 			ret->err = 1;
+			/* Record the busy lock so that the requests waiting for this
+			 * one can wait for it to be released before retrying */
+			for (iter = ret; iter; iter = iter->ret_stack)
+			{
+				iter->conflict_mod = mod;
+				iter->conflict_set = stack->set;
+				iter->conflict_way = stack->way;
+			}
 			mod_unlock_port(mod, port, stack);
 			ret->port_locked = 0;
 			mod_stack_return(stack);
@@ -1360,20 +1499,20 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 			if(stack->read)
 			{
 				if(stack->downup_read_request)
-					mod->downup_read_waiting_for_directory_lock++;
+					MOD_STAT_INC(mod, downup_read_waiting_for_directory_lock);
 				else
-					mod->read_waiting_for_directory_lock++;
+					MOD_STAT_INC(mod, read_waiting_for_directory_lock);
 			}
 
 			if(stack->write)
 			{
 				if(stack->evict_trans)
-					mod->eviction_waiting_for_directory_lock++;
+					MOD_STAT_INC(mod, eviction_waiting_for_directory_lock);
 
 				if(stack->downup_writeback_request)
-					mod->downup_writeback_waiting_for_directory_lock++;
+					MOD_STAT_INC(mod, downup_writeback_waiting_for_directory_lock);
 				else
-					mod->write_waiting_for_directory_lock++;
+					MOD_STAT_INC(mod, write_waiting_for_directory_lock);
 			}
 			
 			mod_unlock_port(mod, port, stack);
@@ -1430,9 +1569,9 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 			stack->eviction = 1;
 			
 			if(stack->read)
-				mod->eviction_due_to_load++;
+				MOD_STAT_INC(mod, eviction_due_to_load);
 			else
-				mod->eviction_due_to_store++;
+				MOD_STAT_INC(mod, eviction_due_to_store);
 
 			new_stack = mod_stack_create(stack->id, mod, 0,
 				EV_MOD_NMOESI_FIND_AND_LOCK_FINISH, stack);
@@ -1470,7 +1609,7 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 		/* Eviction */
 		if (stack->eviction)
 		{
-			mod->evictions++;
+			MOD_STAT_INC(mod, evictions);
 			cache_get_block(mod->cache, stack->set, stack->way, NULL, &stack->state);
 			assert(!stack->state);
 		}
@@ -1514,6 +1653,9 @@ void mod_handler_nmoesi_evict(int event, void *data)
 	uint32_t dir_entry_tag, z;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_EVICT)
 	{
 		/* Default return value */
@@ -1540,6 +1682,14 @@ void mod_handler_nmoesi_evict(int event, void *data)
 
 		stack->access_start_cycle = esim_cycle();
 
+		/* Dirty data written through by a cache that is not inclusive leaves
+		 * the block and its sharers in place */
+		if (stack->write_through)
+		{
+			esim_schedule_event(EV_MOD_NMOESI_EVICT_INVALID, stack, 0);
+			return;
+		}
+
 		/* Send write request to all sharers */
 		new_stack = mod_stack_create(stack->id, mod, 0, EV_MOD_NMOESI_EVICT_INVALID, stack);
 		new_stack->except_mod = NULL;
@@ -1601,12 +1751,12 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		// Check the previous state of this module, here you predict that this is the eviction request in this block that is going to happen, the data transfers may happen lesser than this, but must be an approximate to the value of modified/owned counters.
 		switch(stack->prev_state)
 		{
-			case cache_block_invalid     : { mod->eviction_request_state_invalid++;break; }
-			case cache_block_modified    : { mod->eviction_request_state_modified++;break; }
-			case cache_block_owned       : { mod->eviction_request_state_owned++;break; }
-			case cache_block_exclusive   : { mod->eviction_request_state_exclusive++;break; }
-			case cache_block_shared      : { mod->eviction_request_state_shared++;break; }
-			case cache_block_noncoherent : { mod->eviction_request_state_noncoherent++;break; }
+			case cache_block_invalid     : { MOD_STAT_INC(mod, eviction_request_state_invalid);break; }
+			case cache_block_modified    : { MOD_STAT_INC(mod, eviction_request_state_modified);break; }
+			case cache_block_owned       : { MOD_STAT_INC(mod, eviction_request_state_owned);break; }
+			case cache_block_exclusive   : { MOD_STAT_INC(mod, eviction_request_state_exclusive);break; }
+			case cache_block_shared      : { MOD_STAT_INC(mod, eviction_request_state_shared);break; }
+			case cache_block_noncoherent : { MOD_STAT_INC(mod, eviction_request_state_noncoherent);break; }
 		}
 		
 		/* State = I */
@@ -1624,10 +1774,12 @@ void mod_handler_nmoesi_evict(int event, void *data)
 			msg_size = 8 + mod->block_size;
 			stack->reply = reply_ack_data;
 		}
-		/* If state is E/S, just an ack needs to be sent */
+		/* If state is E/S, just an ack needs to be sent. An exclusive cache
+		 * also receives the data of clean blocks. */
 		else 
 		{
-			msg_size = 8;
+			msg_size = low_mod->inclusion == mod_inclusion_exclusive ?
+				8 + mod->block_size : 8;
 			stack->reply = reply_ack;
 		}
 		
@@ -1642,7 +1794,7 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		// In case message was NULL, then updated the evcition send request retried counter	
 		if(!stack->msg)
 		{
-			mod->eviction_send_requests_retried_nw++;
+			MOD_STAT_INC(mod, eviction_send_requests_retried_nw);
 		}
 		else
 		{
@@ -1737,7 +1889,7 @@ void mod_handler_nmoesi_evict(int event, void *data)
 			next_state = cache_block_modified; 
 
 			// Using stack->mod just to confirm that the higher level module was the module that performed the data transfer from its end.
-			stack->mod->data_transfer_eviction++;
+			MOD_STAT_INC(stack->mod, data_transfer_eviction);
 			// Also update the state modification change happening due to eviction at target module. This is registered as a store event.
 			mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_store);
 		}
@@ -1747,9 +1899,34 @@ void mod_handler_nmoesi_evict(int event, void *data)
 				stack->state);
 		}
 
-		/* Remove sharer and owner */
+		/* A cache that is not inclusive allocates a data frame for the
+		 * victims it keeps: all of them if exclusive, and only those carrying
+		 * data if NINE. Dirty data that finds no frame is written through to
+		 * the lower-level module. */
+		if (target_mod->inclusion != mod_inclusion_inclusive && !stack->write_through &&
+			!mod_block_has_data(target_mod, stack->set, stack->way) &&
+			(stack->reply == reply_ack_data ||
+			target_mod->inclusion == mod_inclusion_exclusive))
+		{
+			if (mod_block_alloc_data(target_mod, stack->set, stack->way))
+			{
+				target_mod->stats.victim_fills++;
+			}
+			else if (stack->reply == reply_ack_data)
+			{
+				new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
+					EV_MOD_NMOESI_EVICT_WRITE_THROUGH, stack);
+				new_stack->set = stack->set;
+				new_stack->way = stack->way;
+				new_stack->write_through = 1;
+				esim_schedule_event(EV_MOD_NMOESI_EVICT, new_stack, 0);
+				return;
+			}
+		}
+
+		/* Remove sharer and owner, unless the block stays in mod */
 		dir = target_mod->dir;
-		for (z = 0; z < dir->zsize; z++)
+		for (z = 0; z < dir->zsize && !stack->write_through; z++)
 		{
 			/* Skip other subblocks */
 			dir_entry_tag = stack->tag + z * target_mod->sub_block_size;
@@ -1774,7 +1951,8 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		dir = target_mod->dir;
 		dir_entry_unlock(dir, stack->set, stack->way);
 
-		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack, target_mod->latency);
+		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack,
+			mod_get_access_latency(target_mod, mod));
 		return;
 	}
 
@@ -1824,6 +2002,84 @@ void mod_handler_nmoesi_evict(int event, void *data)
 				stack->state);
 		}
 
+		/* A cache that is not inclusive allocates a data frame for the
+		 * victims it keeps: all of them if exclusive, and only those carrying
+		 * data if NINE. Dirty data that finds no frame is written through to
+		 * the lower-level module. */
+		if (target_mod->inclusion != mod_inclusion_inclusive && !stack->write_through &&
+			!mod_block_has_data(target_mod, stack->set, stack->way) &&
+			(stack->reply == reply_ack_data ||
+			target_mod->inclusion == mod_inclusion_exclusive))
+		{
+			if (mod_block_alloc_data(target_mod, stack->set, stack->way))
+			{
+				target_mod->stats.victim_fills++;
+			}
+			else if (stack->reply == reply_ack_data)
+			{
+				new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
+					EV_MOD_NMOESI_EVICT_WRITE_THROUGH, stack);
+				new_stack->set = stack->set;
+				new_stack->way = stack->way;
+				new_stack->write_through = 1;
+				esim_schedule_event(EV_MOD_NMOESI_EVICT, new_stack, 0);
+				return;
+			}
+		}
+
+		/* Remove sharer and owner, unless the block stays in mod */
+		dir = target_mod->dir;
+		for (z = 0; z < dir->zsize && !stack->write_through; z++)
+		{
+			/* Skip other subblocks */
+			dir_entry_tag = stack->tag + z * target_mod->sub_block_size;
+			assert(dir_entry_tag < stack->tag + target_mod->block_size);
+			if (dir_entry_tag < stack->src_tag || 
+				dir_entry_tag >= stack->src_tag + mod->block_size)
+			{
+				continue;
+			}
+
+			dir_entry = dir_entry_get(dir, stack->set, stack->way, z);
+			dir_entry_clear_sharer(dir, stack->set, stack->way, z, 
+				mod->low_net_node->index);
+			if (dir_entry->owner == mod->low_net_node->index)
+			{
+				dir_entry_set_owner(dir, stack->set, stack->way, z, 
+					DIR_ENTRY_OWNER_NONE);
+			}
+		}
+
+		/* Unlock the directory entry */
+		dir = target_mod->dir;
+		dir_entry_unlock(dir, stack->set, stack->way);
+
+		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack,
+			mod_get_access_latency(target_mod, mod));
+		return;
+	}
+
+	if (event == EV_MOD_NMOESI_EVICT_WRITE_THROUGH)
+	{
+		mem_debug("  %lld %lld 0x%x %s evict write through\n", esim_time, stack->id,
+			stack->tag, target_mod->name);
+		mem_trace("mem.access name=\"A-%lld\" state=\"%s:evict_write_through\"\n",
+			stack->id, target_mod->name);
+
+		/* The victim is now in the lower-level module, and the block goes
+		 * back to its state before the eviction. */
+		cache_set_block(target_mod->cache, stack->set, stack->way,
+			stack->tag, stack->state);
+
+		/* Error locking block in the lower-level module */
+		if (stack->err)
+		{
+			dir_entry_unlock(target_mod->dir, stack->set, stack->way);
+			ret->err = 1;
+			esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack, 0);
+			return;
+		}
+
 		/* Remove sharer and owner */
 		dir = target_mod->dir;
 		for (z = 0; z < dir->zsize; z++)
@@ -1848,10 +2104,10 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		}
 
 		/* Unlock the directory entry */
-		dir = target_mod->dir;
 		dir_entry_unlock(dir, stack->set, stack->way);
 
-		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack, target_mod->latency);
+		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack,
+			mod_get_access_latency(target_mod, mod));
 		return;
 	}
 
@@ -1874,7 +2130,7 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		// In case message was NULL, then updated the evcition send reply retried counter, else update the timings information.	
 		if(!stack->msg)
 		{
-			target_mod->eviction_send_replies_retried_nw++;
+			MOD_STAT_INC(target_mod, eviction_send_replies_retried_nw);
 		}
 		else
 		{
@@ -1905,12 +2161,18 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		stack->nw_receive_reply_latency_cycle			= stack->nw_receive_reply_latency_end_cycle - stack->nw_receive_reply_latency_start_cycle;
 		if(stack->nw_receive_reply_latency_cycle) mod_update_nw_receive_reply_delay_counters(mod, stack, mod_trans_eviction);
 
-		/* Invalidate block if there was no error. */
-		if (!stack->err)
+		/* Invalidate block if there was no error. A block written through
+		 * stays in mod. */
+		if (stack->write_through)
+		{
+			/* Nothing to do */
+		}
+		else if (!stack->err)
 			cache_set_block(mod->cache, stack->src_set, stack->src_way,
 				0, cache_block_invalid);
 		
-		assert(!dir_entry_group_shared_or_owned(mod->dir, stack->src_set, stack->src_way));
+		assert(stack->write_through ||
+			!dir_entry_group_shared_or_owned(mod->dir, stack->src_set, stack->src_way));
 		
 		esim_schedule_event(EV_MOD_NMOESI_EVICT_FINISH, stack, 0);
 		return;
@@ -1954,6 +2216,9 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 
 	uint32_t dir_entry_tag, z;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_READ_REQUEST)
 	{
 		struct net_t *net;
@@ -2003,8 +2268,8 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		// In case message was NULL, then updated the read request send retried counter, else update the timings information.	
 		if(!stack->msg)
 		{
-			if(stack->downup_read_request) mod->downup_read_send_requests_retried_nw++;
-			else 													 mod->read_send_requests_retried_nw++;
+			if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_send_requests_retried_nw);
+			else 													 MOD_STAT_INC(mod, read_send_requests_retried_nw);
 		}
 		else
 		{
@@ -2053,6 +2318,9 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 
 			target_mod->num_load_requests++;
 			mod_update_request_counters(target_mod, mod_trans_load);
+
+			/* Account for late prefetches */
+			prefetcher_access_start(stack, target_mod);
 		}
 		else
 		{
@@ -2093,6 +2361,25 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_REPLY, stack, 0);
 			return;
 		}
+
+		/* A cache that is not inclusive may keep a block in its directory
+		 * without its data. Unless a higher-level module sends it to mod, the
+		 * block is read again from the lower-level module. */
+		if (stack->request_dir == mod_request_up_down && stack->state &&
+			!mod_block_has_data(target_mod, stack->set, stack->way) &&
+			!mod_nmoesi_sent_by_high_mod(target_mod, mod, stack))
+		{
+			target_mod->stats.data_refetches++;
+			MOD_STAT_INC(target_mod, updown_read_requests_generated);
+			new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
+				EV_MOD_NMOESI_READ_REQUEST_UPDOWN_MISS, stack);
+			new_stack->target_mod = mod_get_low_mod(target_mod, stack->tag);
+			new_stack->request_dir = mod_request_up_down;
+			new_stack->refetch = 1;
+			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST, new_stack, 0);
+			return;
+		}
+
 		esim_schedule_event(stack->request_dir == mod_request_up_down ?
 			EV_MOD_NMOESI_READ_REQUEST_UPDOWN : EV_MOD_NMOESI_READ_REQUEST_DOWNUP, stack, 0);
 		return;
@@ -2128,13 +2415,12 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 				if (dir_entry_tag < stack->addr || dir_entry_tag >= stack->addr + mod->block_size)
 					continue;
 				dir_entry = dir_entry_get(dir, stack->set, stack->way, z);
-				assert(dir_entry->owner != mod->low_net_node->index);
+				assert(stack->refetch || dir_entry->owner != mod->low_net_node->index);
 			}
 
-			/* TODO If there is only sharers, should one of them
-			 *      send the data to mod instead of having target_mod do it? */
-
-			/* Send read request to owners other than mod for all sub-blocks. */
+			/* Send read request to owners other than mod for all sub-blocks.
+			 * With a forward state, a requested sub-block with no owner is
+			 * read from its forwarder instead, which sends it to mod. */
 			for (z = 0; z < dir->zsize; z++)
 			{
 				struct net_node_t *node;
@@ -2142,6 +2428,43 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 				dir_entry = dir_entry_get(dir, stack->set, stack->way, z);
 				dir_entry_tag = stack->tag + z * target_mod->sub_block_size;
 
+				/* Forwarder */
+				if (target_mod->forward_state &&
+					!DIR_ENTRY_VALID_OWNER(dir_entry) &&
+					DIR_ENTRY_VALID_FORWARDER(dir_entry) &&
+					dir_entry->forwarder != mod->low_net_node->index &&
+					dir_entry_tag >= stack->addr &&
+					dir_entry_tag < stack->addr + mod->block_size)
+				{
+					struct mod_t *forwarder;
+
+					node = list_get(target_mod->high_net->node_list,
+						dir_entry->forwarder);
+					assert(node->kind == net_node_end);
+					forwarder = node->user_data;
+					assert(forwarder);
+					assert(dir_entry_is_sharer(dir, stack->set, stack->way, z,
+						dir_entry->forwarder));
+
+					/* Only whole blocks of mod are forwarded */
+					if (forwarder->block_size != mod->block_size)
+						continue;
+					if (dir_entry_tag % forwarder->block_size)
+						continue;
+
+					stack->pending++;
+					new_stack = mod_stack_create(stack->id, target_mod, dir_entry_tag,
+						EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack);
+					new_stack->peer = mod;
+					new_stack->forward = 1;
+					new_stack->target_mod = forwarder;
+					new_stack->request_dir = mod_request_down_up;
+					new_stack->downup_read_request = 1;
+					MOD_STAT_INC(target_mod, forwarded_read_requests);
+					esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST, new_stack, 0);
+					continue;
+				}
+
 				/* No owner */
 				if (!DIR_ENTRY_VALID_OWNER(dir_entry))
 					continue;
@@ -2164,11 +2487,17 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 				stack->pending++;
 				new_stack = mod_stack_create(stack->id, target_mod, dir_entry_tag,
 					EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack);
-				/* Only set peer if its a subblock that was requested */
+				/* Only set peer if its a subblock that was requested. A block
+				 * without data is always sent by its owner. */
 				if (dir_entry_tag >= stack->addr && 
 					dir_entry_tag < stack->addr + mod->block_size)
 				{
 					new_stack->peer = mod_stack_set_peer(mod, stack->state);
+					if (!mod_block_has_data(target_mod, stack->set, stack->way))
+					{
+						new_stack->peer = mod;
+						new_stack->forward = 1;
+					}
 				}
 				new_stack->target_mod = owner;
 				new_stack->request_dir = mod_request_down_up;
@@ -2186,7 +2515,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		else
 		{
 			// Update counter for generation of a Up-down read request
-			target_mod->updown_read_requests_generated++;
+			MOD_STAT_INC(target_mod, updown_read_requests_generated);
 
 			/* State = I */
 			assert(!dir_entry_group_shared_or_owned(target_mod->dir,
@@ -2237,6 +2566,18 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 
 		mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_load);
 
+		/* A NINE cache keeps the blocks brought from lower levels */
+		if (target_mod->inclusion == mod_inclusion_nine)
+			mod_block_alloc_data(target_mod, stack->set, stack->way);
+
+		/* A block read again for its data continues as a hit */
+		if (stack->state)
+		{
+			stack->state = next_state;
+			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_UPDOWN, stack, 0);
+			return;
+		}
+
 		esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack, 0);
 		return;
 	}
@@ -2272,7 +2613,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 			mod_stack_set_reply(ret, reply_ack_data);
 
 			// Using stack->mod just to confirm that the lower level module was the module that performed the data transfer from its end.
-			stack->target_mod->data_transfer_updown_load_request++;
+			MOD_STAT_INC(stack->target_mod, data_transfer_updown_load_request);
 		}
 		else 
 		{
@@ -2330,10 +2671,36 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 				dir_entry_set_owner(dir, stack->set, stack->way, z, mod->low_net_node->index);
 			}
 		}
+		else if (target_mod->forward_state)
+		{
+			/* With a forward state, the last reader of a shared block
+			 * becomes its forwarder. */
+			for (z = 0; z < dir->zsize; z++)
+			{
+				dir_entry_tag = stack->tag + z * target_mod->sub_block_size;
+				if (dir_entry_tag < stack->addr || dir_entry_tag >= stack->addr + mod->block_size)
+					continue;
+				dir_entry = dir_entry_get(dir, stack->set, stack->way, z);
+				if (!DIR_ENTRY_VALID_OWNER(dir_entry))
+					dir_entry_set_forwarder(dir, stack->set, stack->way, z,
+						mod->low_net_node->index);
+			}
+		}
+
+		/* An exclusive cache moves a clean block up to mod */
+		if (target_mod->inclusion == mod_inclusion_exclusive)
+		{
+			int state;
+
+			cache_get_block(target_mod->cache, stack->set, stack->way, NULL, &state);
+			if (state == cache_block_exclusive || state == cache_block_shared)
+				mod_block_free_data(target_mod, stack->set, stack->way);
+		}
 
 		dir_entry_unlock(dir, stack->set, stack->way);
 
-		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 : target_mod->latency;
+		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 :
+			mod_get_access_latency(target_mod, mod);
 		esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_REPLY, stack, latency);
 		return;
 	}
@@ -2347,11 +2714,12 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:read_request_downup\"\n",
 			stack->id, target_mod->name);
 
-		/* Check: state must not be invalid or shared.
+		/* Check: state must not be invalid or shared, unless the block is
+		 * read from its forwarder.
 		 * By default, only one pending request.
 		 * Response depends on state */
 		assert(stack->state != cache_block_invalid);
-		assert(stack->state != cache_block_shared);
+		assert(stack->state != cache_block_shared || stack->forward);
 		assert(stack->state != cache_block_noncoherent);
 		stack->pending = 1;
 
@@ -2404,18 +2772,29 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:read_request_downup_wait_for_reqs\"\n",
 			stack->id, target_mod->name);
 
+		/* A block without data is only sent to the peer if a higher-level
+		 * module returned it and a data frame is available for it.
+		 * Otherwise, the lower-level module sends it. */
+		if (stack->peer && !mod_block_has_data(target_mod, stack->set, stack->way) &&
+			(stack->reply != reply_ack_data ||
+			!mod_block_alloc_data(target_mod, stack->set, stack->way)))
+		{
+			stack->peer = NULL;
+		}
+
 		if (stack->peer)
 		{
 			/* Send this block (or subblock) to the peer */
 			new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
 				EV_MOD_NMOESI_READ_REQUEST_DOWNUP_FINISH, stack);
-			new_stack->peer = mod_stack_set_peer(stack->peer, stack->state);
+			new_stack->peer = stack->forward ? stack->peer :
+				mod_stack_set_peer(stack->peer, stack->state);
 			new_stack->target_mod = stack->target_mod;
 			//------------------------------------------------------------
 			// Updating statistics, first indicate that the requesting module received the data via peer transfer and second statistics that a down-up request sent data through peer transfer
 			//------------------------------------------------------------
-			stack->peer->peer_transfers++;
-			stack->target_mod->peer_data_transfer_downup_load_request++;
+			MOD_STAT_INC(stack->peer, peer_transfers);
+			MOD_STAT_INC(stack->target_mod, peer_data_transfer_downup_load_request);
 			esim_schedule_event(EV_MOD_NMOESI_PEER_SEND, new_stack, 0);
 		}
 		else 
@@ -2499,7 +2878,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 				
 				// MOESI protocol this data will also be transferred to the lower level module to maintain coherency. In case of MOESI, this is case of owned state and hence this additional data transfer doesn't occur.
 				// stack->mod indicates that the higher level module sent the data back to lower level module
-				stack->target_mod->data_transfer_downup_load_request++;
+				MOD_STAT_INC(stack->target_mod, data_transfer_downup_load_request);
 
 				mod_stack_set_reply(ret, reply_ack_data);
 			}
@@ -2574,6 +2953,8 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 					/* Set block to shared */
 					cache_set_block(target_mod->cache, stack->set, stack->way, 
 						stack->tag, cache_block_shared);
+					if (stack->forward)
+						next_state = cache_block_shared;
 				}
 			}
 			else 
@@ -2594,7 +2975,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 					mod_stack_set_reply(ret, reply_ack_data);
 					
 					// stack->mod that this higher level module sent the data for a Load request.	
-					stack->target_mod->data_transfer_downup_load_request++;
+					MOD_STAT_INC(stack->target_mod, data_transfer_downup_load_request);
 				}
 				else 
 				{
@@ -2663,8 +3044,8 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		
 		if(!stack->msg)
 		{
-			if(stack->downup_read_request) target_mod->downup_read_send_replies_retried_nw++;
-			else 													 target_mod->read_send_replies_retried_nw++;
+			if(stack->downup_read_request) MOD_STAT_INC(target_mod, downup_read_send_replies_retried_nw);
+			else 													 MOD_STAT_INC(target_mod, read_send_replies_retried_nw);
 		}
 		else
 		{
@@ -2752,6 +3133,9 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 	uint32_t dir_entry_tag, z;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_WRITE_REQUEST)
 	{
 		struct net_t *net;
@@ -2806,10 +3190,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 		if(!stack->msg)
 		{
-			if(stack->evict_trans) mod->downup_eviction_send_requests_retried_nw++;
+			if(stack->evict_trans) MOD_STAT_INC(mod, downup_eviction_send_requests_retried_nw);
 			
-			if(stack->downup_writeback_request) mod->downup_writeback_send_requests_retried_nw++;
-			else mod->writeback_send_requests_retried_nw++;
+			if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_send_requests_retried_nw);
+			else MOD_STAT_INC(mod, writeback_send_requests_retried_nw);
 		}
 		else
 		{
@@ -2867,6 +3251,9 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 			target_mod->num_store_requests++;
 			mod_update_request_counters(target_mod, mod_trans_store);
+
+			/* Account for late prefetches */
+			prefetcher_access_start(stack, target_mod);
 		}
 		else
 		{
@@ -2946,7 +3333,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 			new_stack->wb_store = 1;
 
 		esim_schedule_event(EV_MOD_NMOESI_INVALIDATE, new_stack, 0);
-		target_mod->sharer_req_for_invalidation++;
+		MOD_STAT_INC(target_mod, sharer_req_for_invalidation);
 		return;
 	}
 
@@ -2971,18 +3358,21 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:write_request_updown\"\n",
 			stack->id, target_mod->name);
 
-		/* state = M/E */
-		if (stack->state == cache_block_modified ||
-			stack->state == cache_block_exclusive)
+		/* state = M/E, and the data is either held by target_mod or was
+		 * returned by the higher-level modules it invalidated */
+		if ((stack->state == cache_block_modified ||
+			stack->state == cache_block_exclusive) &&
+			mod_nmoesi_write_has_data(target_mod, stack))
 		{
 			esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST_UPDOWN_FINISH, stack, 0);
 		}
-		/* state = O/S/I/N */
+		/* state = O/S/I/N, or E without data */
 		else if (stack->state == cache_block_owned || stack->state == cache_block_shared ||
-			stack->state == cache_block_invalid || stack->state == cache_block_noncoherent)
+			stack->state == cache_block_invalid || stack->state == cache_block_noncoherent ||
+			stack->state == cache_block_exclusive)
 		{
 			// Update counter for generation of a Up-down WB request
-			target_mod->updown_writeback_requests_generated++;
+			MOD_STAT_INC(target_mod, updown_writeback_requests_generated);
 
 			new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
 				EV_MOD_NMOESI_WRITE_REQUEST_UPDOWN_FINISH, stack);
@@ -3060,6 +3450,15 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 		next_state = cache_block_exclusive;
 
+		/* The block is now modified in mod. An exclusive cache gives up its
+		 * copy, while a NINE cache keeps the data it forwarded. */
+		if (target_mod->inclusion == mod_inclusion_exclusive)
+			mod_block_free_data(target_mod, stack->set, stack->way);
+		else if (target_mod->inclusion == mod_inclusion_nine &&
+			(stack->state == cache_block_invalid ||
+			!mod_block_has_data(target_mod, stack->set, stack->way)))
+			mod_block_alloc_data(target_mod, stack->set, stack->way);
+
 		/* If blocks were sent directly to the peer, the reply size would
 		 * have been decreased.  Based on the final size, we can tell whether
 		 * to send more data up or simply ack */
@@ -3072,7 +3471,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 			mod_stack_set_reply(ret, reply_ack_data);
 
 			// Here the lower level module sends the data to the higher module in response to a store request form ahigher level module.
-			stack->target_mod->data_transfer_updown_store_request++;
+			MOD_STAT_INC(stack->target_mod, data_transfer_updown_store_request);
 		}
 		else 
 		{
@@ -3084,7 +3483,8 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 		mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_store);
 
-		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 : target_mod->latency;
+		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 :
+			mod_get_access_latency(target_mod, mod);
 		esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST_REPLY, stack, latency);
 		return;
 	}
@@ -3115,10 +3515,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 			// Update statistics for data transfer
 			if(stack->invalidate_eviction)
-				stack->target_mod->data_transfer_downup_eviction_request++;
+				MOD_STAT_INC(stack->target_mod, data_transfer_downup_eviction_request);
 
 			if(stack->wb_store)
-				stack->target_mod->data_transfer_downup_store_request++;
+				MOD_STAT_INC(stack->target_mod, data_transfer_downup_store_request);
 
 		}
 		else if (stack->state == cache_block_modified || 
@@ -3145,8 +3545,8 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 				//------------------------------------------------------------
 				// Updating statistics, first indicate that the requesting module received the data via peer transfer and second statistics that a down-up request sent data through peer transfer
 				//------------------------------------------------------------
-				stack->peer->peer_transfers++;
-				stack->target_mod->peer_data_transfer_downup_store_request++;
+				MOD_STAT_INC(stack->peer, peer_transfers);
+				MOD_STAT_INC(stack->target_mod, peer_data_transfer_downup_store_request);
 
 				esim_schedule_event(EV_MOD_NMOESI_PEER_SEND, new_stack, 0);
 				return;
@@ -3159,10 +3559,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 				// Update statistics for data transfer
 				if(stack->invalidate_eviction)
-					stack->target_mod->data_transfer_downup_eviction_request++;
+					MOD_STAT_INC(stack->target_mod, data_transfer_downup_eviction_request);
 
 				if(stack->wb_store)
-					stack->target_mod->data_transfer_downup_store_request++;
+					MOD_STAT_INC(stack->target_mod, data_transfer_downup_store_request);
 			}
 		}
 		else 
@@ -3183,6 +3583,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:write_request_downup_finish\"\n",
 			stack->id, target_mod->name);
 
+		// Copy lost by the eviction of the lower-level module
+		if(stack->invalidate_eviction)
+			mod->stats.inclusion_victims++;
+
 		/* Set state to I, unlock*/
 		cache_set_block(target_mod->cache, stack->set, stack->way, 0, cache_block_invalid);
 		next_state = cache_block_invalid;
@@ -3234,10 +3638,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 		if(!stack->msg)
 		{
-			if(stack->evict_trans) target_mod->downup_eviction_send_replies_retried_nw++; 
+			if(stack->evict_trans) MOD_STAT_INC(target_mod, downup_eviction_send_replies_retried_nw); 
 			
-			if(stack->downup_writeback_request) target_mod->downup_writeback_send_replies_retried_nw++;
-			else target_mod->writeback_send_replies_retried_nw++;
+			if(stack->downup_writeback_request) MOD_STAT_INC(target_mod, downup_writeback_send_replies_retried_nw);
+			else MOD_STAT_INC(target_mod, writeback_send_replies_retried_nw);
 		}
 		else
 		{
@@ -3339,6 +3743,9 @@ void mod_handler_nmoesi_peer(int event, void *data)
 	struct mod_t *src = stack->target_mod;
 	struct mod_t *peer = stack->peer;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_PEER_SEND) 
 	{
 		mem_debug("  %lld %lld 0x%x %s %s peer send\n", esim_time, stack->id,
@@ -3358,7 +3765,7 @@ void mod_handler_nmoesi_peer(int event, void *data)
 		
 		if(!stack->msg)
 		{
-			src->peer_send_requests_retried_nw++;
+			MOD_STAT_INC(src, peer_send_requests_retried_nw);
 		}
 		else
 		{
@@ -3410,7 +3817,7 @@ void mod_handler_nmoesi_peer(int event, void *data)
 		
 		if(!stack->msg)
 		{
-			peer->peer_send_replies_retried_nw++;
+			MOD_STAT_INC(peer, peer_send_replies_retried_nw);
 		}
 		else
 		{
@@ -3466,6 +3873,9 @@ void mod_handler_nmoesi_invalidate(int event, void *data)
 	uint32_t dir_entry_tag;
 	uint32_t z;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_INVALIDATE)
 	{
 		struct mod_t *sharer;
@@ -3584,6 +3994,9 @@ void mod_handler_nmoesi_message(int event, void *data)
 	struct dir_entry_t *dir_entry;
 	uint32_t z;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_MESSAGE)
 	{
 		struct net_t *net;
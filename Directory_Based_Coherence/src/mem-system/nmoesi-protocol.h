@@ -62,6 +62,7 @@ extern int EV_MOD_NMOESI_EVICT_ACTION;
 extern int EV_MOD_NMOESI_EVICT_RECEIVE;
 extern int EV_MOD_NMOESI_EVICT_PROCESS;
 extern int EV_MOD_NMOESI_EVICT_PROCESS_NONCOHERENT;
+extern int EV_MOD_NMOESI_EVICT_WRITE_THROUGH;
 extern int EV_MOD_NMOESI_EVICT_REPLY;
 extern int EV_MOD_NMOESI_EVICT_REPLY_RECEIVE;
 extern int EV_MOD_NMOESI_EVICT_FINISH;
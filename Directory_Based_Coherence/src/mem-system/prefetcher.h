@@ -20,11 +20,22 @@
 #ifndef MEM_SYSTEM_PREFETCHER_H
 #define MEM_SYSTEM_PREFETCHER_H
 
+#include <stdio.h>
 
-/* 
- * This file implements a global history buffer
- * based prefetcher. Refer to the 2005 paper by
- * Nesbit and Smith. 
+
+/*
+ * This file implements the hardware prefetchers of a cache. Every prefetcher
+ * observes the demand misses of its cache, as well as the first demand
+ * access to each prefetched block, and issues prefetches through one of
+ * the following engines:
+ *
+ *   - Global history buffer, PC/CS and PC/DC. Refer to the 2005 paper by
+ *     Nesbit and Smith.
+ *   - IP-stride, with a PC-indexed table of strides.
+ *   - Stream, following ascending or descending sequences of misses.
+ *   - Next-N-line.
+ *   - AMPM, with a spatial access map per memory zone. Refer to the 2009
+ *     paper by Ishii, Inaba and Hiraki.
  */
 
 extern struct str_map_t prefetcher_type_map;
@@ -34,11 +45,25 @@ enum prefetcher_type_t
 	prefetcher_type_invalid = 0,
 	prefetcher_type_ghb_pc_cs,
 	prefetcher_type_ghb_pc_dc,
+	prefetcher_type_ip_stride,
+	prefetcher_type_stream,
+	prefetcher_type_next_line,
+	prefetcher_type_ampm
 };
 
 /* Doesn't really make sense to have a big lookup depth */
 #define PREFETCHER_LOOKUP_DEPTH_MAX 4
 
+/* Maximum number of blocks in an AMPM zone, given by the size of the
+ * access maps. */
+#define PREFETCHER_ZONE_BLOCKS_MAX 64
+
+/* Values of the 'prefetched' field of a cache block. A block is marked as
+ * late when a demand access reached the cache while it was being prefetched,
+ * so that the prefetch is not accounted for twice. */
+#define PREFETCHER_BLOCK_PREFETCHED  1
+#define PREFETCHER_BLOCK_LATE  2
+
 /* Global history buffer. */
 struct prefetcher_ghb_t
 {
@@ -66,28 +91,104 @@ struct prefetcher_it_t
    	int ptr;
 };
 
+/* IP-stride table entry, indexed by the PC of the accessing instruction. */
+struct prefetcher_ip_stride_t
+{
+	unsigned int tag;  /* PC, 0 if the entry has never been used */
+	unsigned int addr;  /* Last address accessed */
+	int stride;
+	int confidence;
+};
+
+/* Stream table entry */
+struct prefetcher_stream_t
+{
+	int valid;
+	unsigned int block;  /* Last block missed on in the stream */
+	int direction;  /* 1 = ascending, -1 = descending, 0 = not known yet */
+	int confidence;
+	long long lru;  /* Last use, for replacement */
+};
+
+/* AMPM zone entry. Bit 'i' of the maps corresponds to block 'i' within
+ * the zone. */
+struct prefetcher_zone_t
+{
+	int valid;
+	unsigned int tag;  /* Zone number */
+	unsigned long long access_map;
+	unsigned long long prefetch_map;
+	long long lru;  /* Last use, for replacement */
+};
+
 /* The main prefetcher object */
 struct prefetcher_t
 {
+	enum prefetcher_type_t type;
+
+	/* Global history buffer based engines */
 	int ghb_size;
 	int it_size;
 	int lookup_depth;
-	enum prefetcher_type_t type;
-
 	struct prefetcher_ghb_t *ghb;
 	struct prefetcher_it_t *index_table;
-
 	int ghb_head;
+
+	/* IP-stride engine, with 'it_size' entries */
+	struct prefetcher_ip_stride_t *ip_stride_table;
+
+	/* Stream engine */
+	int num_streams;
+	struct prefetcher_stream_t *stream_table;
+
+	/* AMPM engine */
+	int num_zones;
+	int zone_size;
+	int log_zone_size;
+	struct prefetcher_zone_t *zone_table;
+
+	/* Block size of the cache */
+	int block_size;
+	int log_block_size;
+
+	/* Number of blocks prefetched on each trigger. If 'throttle_interval'
+	 * is not 0, the degree is adjusted between 1 and 'max_degree' every
+	 * 'throttle_interval' prefetch fills, based on the accuracy and
+	 * lateness observed during the interval. */
+	int degree;
+	int max_degree;
+	int throttle_interval;
+	long long interval_fills;
+	long long interval_useful;
+	long long interval_late;
+
+	/* Counter used for LRU replacement in tables */
+	long long time;
+
+	/* Statistics */
+	long long demand_misses;  /* Demand misses observed */
+	long long issued;  /* Prefetches issued to the cache */
+	long long fills;  /* Blocks brought by prefetches */
+	long long useful;  /* Prefetched blocks accessed by demand */
+	long long late;  /* Prefetches demanded while in flight */
+	long long unused;  /* Prefetched blocks replaced before use */
+	long long degree_increases;
+	long long degree_decreases;
 };
 
 struct mod_stack_t;
 struct mod_t;
 
-struct prefetcher_t *prefetcher_create(int prefetcher_ghb_size, int prefetcher_it_size,
-				       int prefetcher_lookup_depth, enum prefetcher_type_t type);
+struct prefetcher_t *prefetcher_create(enum prefetcher_type_t type, int block_size,
+	int ghb_size, int it_size, int lookup_depth, int num_streams,
+	int num_zones, int zone_size);
 void prefetcher_free(struct prefetcher_t *pref);
+void prefetcher_dump(struct prefetcher_t *pref, FILE *f);
+void prefetcher_reset_stats(struct prefetcher_t *pref);
 
+void prefetcher_access_start(struct mod_stack_t *stack, struct mod_t *mod);
 void prefetcher_access_miss(struct mod_stack_t *stack, struct mod_t *mod);
 void prefetcher_access_hit(struct mod_stack_t *stack, struct mod_t *mod);
+void prefetcher_access_fill(struct mod_stack_t *stack, struct mod_t *mod);
 
 #endif
@@ -0,0 +1,450 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <lib/esim/esim.h>
+#include <lib/mhandle/mhandle.h>
+#include <lib/util/debug.h>
+#include <lib/util/misc.h>
+
+#include "cache.h"
+#include "mem-system.h"
+#include "mmu.h"
+#include "mod-stack.h"
+#include "tlb.h"
+
+
+/* Events */
+
+int EV_TLB_ACCESS;
+int EV_TLB_LOOKUP;
+int EV_TLB_MISS;
+int EV_TLB_WALK;
+int EV_TLB_WALK_REPLY;
+int EV_TLB_FILL;
+int EV_TLB_FINISH;
+
+
+
+
+/*
+ * Private Functions
+ */
+
+/* Return an in-flight access that missed in the TLB and is still resolving
+ * the translation for the page containing 'addr', or NULL if there is none. */
+static struct mod_stack_t *tlb_in_flight_miss(struct tlb_t *tlb, unsigned int addr)
+{
+	struct mod_stack_t *stack;
+
+	for (stack = tlb->access_list_head; stack; stack = stack->access_list_next)
+		if (stack->tlb_miss && (stack->addr & ~mmu_page_mask) == (addr & ~mmu_page_mask))
+			return stack;
+
+	/* Not found */
+	return NULL;
+}
+
+
+/* Release forwarded accesses whose module access has completed */
+static void tlb_forward_list_cleanup(struct tlb_t *tlb)
+{
+	struct mod_stack_t *stack;
+	struct mod_stack_t *next;
+
+	for (stack = tlb->forward_list_head; stack; stack = next)
+	{
+		next = stack->forward_list_next;
+		if (mod_in_flight_access(stack->mod, stack->tlb_forward_id, stack->addr))
+			continue;
+		DOUBLE_LINKED_LIST_REMOVE(tlb, forward, stack);
+		free(stack);
+	}
+}
+
+
+
+
+/*
+ * Public Functions
+ */
+
+struct tlb_t *tlb_create(char *name, int num_sets, int assoc,
+	int latency, int mshr_size)
+{
+	struct tlb_t *tlb;
+
+	/* Initialize */
+	tlb = xcalloc(1, sizeof(struct tlb_t));
+	tlb->name = xstrdup(name);
+	tlb->num_sets = num_sets;
+	tlb->assoc = assoc;
+	tlb->latency = latency;
+	tlb->mshr_size = mshr_size;
+
+	/* Tag array with page-sized blocks */
+	tlb->cache = cache_create(name, num_sets, mmu_page_size, assoc,
+		cache_policy_lru);
+
+	/* Return */
+	return tlb;
+}
+
+
+void tlb_free(struct tlb_t *tlb)
+{
+	struct mod_stack_t *stack;
+
+	/* Forwarded accesses are owned by the TLB */
+	while (tlb->forward_list_head)
+	{
+		stack = tlb->forward_list_head;
+		DOUBLE_LINKED_LIST_REMOVE(tlb, forward, stack);
+		free(stack);
+	}
+
+	cache_free(tlb->cache);
+	free(tlb->name);
+	free(tlb);
+}
+
+
+void tlb_dump(struct tlb_t *tlb, FILE *f)
+{
+	int i;
+
+	fprintf(f, "[ %s ]\n", tlb->name);
+	fprintf(f, "\n");
+
+	/* Configuration */
+	fprintf(f, "Sets = %d\n", tlb->num_sets);
+	fprintf(f, "Assoc = %d\n", tlb->assoc);
+	fprintf(f, "Latency = %d\n", tlb->latency);
+	fprintf(f, "MSHR = %d\n", tlb->mshr_size);
+	fprintf(f, "LowTLB = %s\n", tlb->low_tlb ? tlb->low_tlb->name : "-");
+	fprintf(f, "\n");
+
+	/* Statistics */
+	fprintf(f, "Accesses = %lld\n", tlb->accesses);
+	fprintf(f, "Hits = %lld\n", tlb->hits);
+	fprintf(f, "Misses = %lld\n", tlb->misses);
+	fprintf(f, "HitRatio = %.4g\n", tlb->accesses ?
+		(double) tlb->hits / tlb->accesses : 0.0);
+	fprintf(f, "MSHRMerges = %lld\n", tlb->mshr_merges);
+	fprintf(f, "MSHRStallCycles = %lld\n", tlb->mshr_stall_cycles);
+	fprintf(f, "\n");
+
+	/* Page table walks */
+	fprintf(f, "Walks = %lld\n", tlb->walks);
+	fprintf(f, "WalkAccesses = %lld\n", tlb->walk_accesses);
+	fprintf(f, "WalkCycles = %lld\n", tlb->walk_cycles);
+	fprintf(f, "WalkAverageLatency = %.4g\n", tlb->walks ?
+		(double) tlb->walk_cycles / tlb->walks : 0.0);
+	fprintf(f, "WalkMaxLatency = %lld\n", tlb->walk_max_cycles);
+	fprintf(f, "WalkLatencyHistogram =");
+	for (i = 0; i < TLB_WALK_LATENCY_HISTOGRAM_SIZE; i++)
+		if (tlb->walk_latency_histogram[i])
+			fprintf(f, " %d%s:%lld", i, i == TLB_WALK_LATENCY_HISTOGRAM_SIZE - 1 ?
+				"+" : "", tlb->walk_latency_histogram[i]);
+	fprintf(f, "\n");
+	fprintf(f, "\n\n");
+}
+
+
+void tlb_reset_stats(struct tlb_t *tlb)
+{
+	tlb->accesses = 0;
+	tlb->hits = 0;
+	tlb->misses = 0;
+	tlb->mshr_merges = 0;
+	tlb->mshr_stall_cycles = 0;
+	tlb->walks = 0;
+	tlb->walk_accesses = 0;
+	tlb->walk_cycles = 0;
+	tlb->walk_max_cycles = 0;
+	memset(tlb->walk_latency_histogram, 0, sizeof tlb->walk_latency_histogram);
+}
+
+
+/* Translate an access through a TLB before accessing module 'mod'. The
+ * physical address 'phy_addr' is obtained functionally by the caller with
+ * 'mmu_translate'. Once the translation completes, the access is forwarded
+ * to 'mod'. The remaining arguments have the same meaning as in 'mod_access'.
+ * The function returns an access ID to be used with 'tlb_in_flight_access'. */
+long long tlb_access(struct tlb_t *tlb, struct mod_t *mod,
+	enum mod_access_kind_t access_kind, int address_space_index,
+	unsigned int vtl_addr, unsigned int phy_addr, int *witness_ptr,
+	struct linked_list_t *event_queue, void *event_queue_item,
+	struct mod_client_info_t *client_info)
+{
+	struct mod_stack_t *stack;
+
+	/* Create module stack with new ID */
+	mod_stack_id++;
+	stack = mod_stack_create(mod_stack_id, mod, phy_addr, ESIM_EV_NONE, NULL);
+
+	/* Initialize */
+	stack->tlb = tlb;
+	stack->access_kind = access_kind;
+	stack->address_space_index = address_space_index;
+	stack->vtl_addr = vtl_addr;
+	stack->witness_ptr = witness_ptr;
+	stack->event_queue = event_queue;
+	stack->event_queue_item = event_queue_item;
+	stack->client_info = client_info;
+
+	/* Start access */
+	esim_execute_event(EV_TLB_ACCESS, stack);
+
+	/* Return access ID */
+	return stack->id;
+}
+
+
+/* Return true if the access with identifier 'id', as returned by 'tlb_access',
+ * is still being translated in the TLB, or has been forwarded to the module
+ * and is still in flight there. */
+int tlb_in_flight_access(struct tlb_t *tlb, long long id)
+{
+	struct mod_stack_t *stack;
+
+	/* Access being translated */
+	for (stack = tlb->access_list_head; stack; stack = stack->access_list_next)
+		if (stack->id == id)
+			return 1;
+
+	/* Access forwarded to the module. Release it if the module access has
+	 * completed. */
+	for (stack = tlb->forward_list_head; stack; stack = stack->forward_list_next)
+	{
+		if (stack->id != id)
+			continue;
+		if (mod_in_flight_access(stack->mod, stack->tlb_forward_id, stack->addr))
+			return 1;
+		DOUBLE_LINKED_LIST_REMOVE(tlb, forward, stack);
+		free(stack);
+		return 0;
+	}
+
+	/* Not found, the access was already released */
+	return 0;
+}
+
+
+void tlb_handler(int event, void *data)
+{
+	struct mod_stack_t *stack = data;
+	struct mod_stack_t *new_stack;
+
+	struct tlb_t *tlb = stack->tlb;
+
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
+	if (event == EV_TLB_ACCESS)
+	{
+		mem_debug("%lld %lld 0x%x %s tlb access\n", esim_time, stack->id,
+			stack->vtl_addr, tlb->name);
+
+		/* Record access */
+		DOUBLE_LINKED_LIST_INSERT_TAIL(tlb, access, stack);
+		tlb->accesses++;
+
+		/* Next event */
+		esim_schedule_event(EV_TLB_LOOKUP, stack, tlb->latency);
+		return;
+	}
+
+	if (event == EV_TLB_LOOKUP)
+	{
+		struct mod_stack_t *master_stack;
+		int set;
+		int way;
+
+		mem_debug("  %lld %lld 0x%x %s tlb lookup\n", esim_time, stack->id,
+			stack->vtl_addr, tlb->name);
+
+		/* Hit */
+		if (cache_find_block(tlb->cache, stack->addr, &set, &way, NULL))
+		{
+			mem_debug("    %lld hit\n", stack->id);
+			tlb->hits++;
+			cache_access_block(tlb->cache, set, way);
+			esim_schedule_event(EV_TLB_FINISH, stack, 0);
+			return;
+		}
+
+		/* Miss to a page whose translation is already being resolved.
+		 * Wait for it instead of allocating a new MSHR entry. */
+		master_stack = tlb_in_flight_miss(tlb, stack->addr);
+		if (master_stack)
+		{
+			mem_debug("    %lld miss, wait for %lld\n", stack->id,
+				master_stack->id);
+			tlb->misses++;
+			tlb->mshr_merges++;
+			mod_stack_wait_in_stack(stack, master_stack, EV_TLB_FINISH);
+			return;
+		}
+
+		/* No MSHR entry available, try again in the next cycle */
+		if (tlb->mshr_count >= tlb->mshr_size)
+		{
+			mem_debug("    %lld miss, MSHR full\n", stack->id);
+			tlb->mshr_stall_cycles++;
+			esim_schedule_event(EV_TLB_LOOKUP, stack, 1);
+			return;
+		}
+
+		/* Allocate MSHR entry */
+		mem_debug("    %lld miss\n", stack->id);
+		tlb->misses++;
+		tlb->mshr_count++;
+		stack->tlb_miss = 1;
+		esim_schedule_event(EV_TLB_MISS, stack, 0);
+		return;
+	}
+
+	if (event == EV_TLB_MISS)
+	{
+		mem_debug("  %lld %lld 0x%x %s tlb miss\n", esim_time, stack->id,
+			stack->vtl_addr, tlb->name);
+
+		/* Look up the next TLB level. The new stack returns to this one
+		 * once the lower TLB has the translation. */
+		if (tlb->low_tlb)
+		{
+			new_stack = mod_stack_create(stack->id, stack->mod, stack->addr,
+				EV_TLB_FILL, stack);
+			new_stack->client_info = NULL;
+			new_stack->tlb = tlb->low_tlb;
+			new_stack->access_kind = stack->access_kind;
+			new_stack->address_space_index = stack->address_space_index;
+			new_stack->vtl_addr = stack->vtl_addr;
+			esim_schedule_event(EV_TLB_ACCESS, new_stack, 0);
+			return;
+		}
+
+		/* Last-level TLB, walk the page table */
+		tlb->walks++;
+		stack->tlb_walk = 1;
+		stack->tlb_walk_level = 0;
+		stack->tlb_walk_start_cycle = esim_cycle();
+		esim_schedule_event(EV_TLB_WALK, stack, 0);
+		return;
+	}
+
+	if (event == EV_TLB_WALK)
+	{
+		unsigned int pte_addr;
+
+		/* Read page table entry for the current level through the module
+		 * the translated access is addressed to. */
+		pte_addr = mmu_page_table_entry_addr(stack->address_space_index,
+			stack->vtl_addr, stack->tlb_walk_level);
+		mem_debug("  %lld %lld 0x%x %s tlb walk level %d, pte 0x%x\n",
+			esim_time, stack->id, stack->vtl_addr, tlb->name,
+			stack->tlb_walk_level, pte_addr);
+		tlb->walk_accesses++;
+		mod_access_with_return(stack->mod, mod_access_load, pte_addr,
+			EV_TLB_WALK_REPLY, stack);
+		return;
+	}
+
+	if (event == EV_TLB_WALK_REPLY)
+	{
+		/* Next level */
+		stack->tlb_walk_level++;
+		if (stack->tlb_walk_level < TLB_WALK_LEVELS)
+		{
+			esim_schedule_event(EV_TLB_WALK, stack, 0);
+			return;
+		}
+
+		/* Walk complete */
+		esim_schedule_event(EV_TLB_FILL, stack, 0);
+		return;
+	}
+
+	if (event == EV_TLB_FILL)
+	{
+		long long walk_cycles;
+		int set;
+		int way;
+
+		mem_debug("  %lld %lld 0x%x %s tlb fill\n", esim_time, stack->id,
+			stack->vtl_addr, tlb->name);
+
+		/* Walk statistics */
+		if (stack->tlb_walk)
+		{
+			walk_cycles = esim_cycle() - stack->tlb_walk_start_cycle;
+			tlb->walk_cycles += walk_cycles;
+			tlb->walk_max_cycles = MAX(tlb->walk_max_cycles, walk_cycles);
+			tlb->walk_latency_histogram[MIN(walk_cycles,
+				TLB_WALK_LATENCY_HISTOGRAM_SIZE - 1)]++;
+		}
+
+		/* Insert translation */
+		cache_find_block(tlb->cache, stack->addr, &set, NULL, NULL);
+		way = cache_replace_block(tlb->cache, set);
+		cache_set_block(tlb->cache, set, way, stack->addr & ~mmu_page_mask,
+			cache_block_noncoherent);
+		cache_access_block(tlb->cache, set, way);
+
+		/* Release MSHR entry and wake up merged misses */
+		assert(tlb->mshr_count > 0);
+		tlb->mshr_count--;
+		stack->tlb_miss = 0;
+		mod_stack_wakeup_stack(stack);
+
+		/* Next event */
+		esim_schedule_event(EV_TLB_FINISH, stack, 0);
+		return;
+	}
+
+	if (event == EV_TLB_FINISH)
+	{
+		mem_debug("%lld %lld 0x%x %s tlb finish\n", esim_time, stack->id,
+			stack->vtl_addr, tlb->name);
+
+		/* Remove from in-flight accesses */
+		DOUBLE_LINKED_LIST_REMOVE(tlb, access, stack);
+
+		/* Lookup on behalf of a higher TLB, return to it */
+		if (stack->ret_stack)
+		{
+			mod_stack_return(stack);
+			return;
+		}
+
+		/* Translation done, forward the access to the module. The stack is
+		 * kept until the module access completes. */
+		tlb_forward_list_cleanup(tlb);
+		stack->tlb_forward_id = mod_access(stack->mod, stack->access_kind,
+			stack->addr, stack->witness_ptr, stack->event_queue,
+			stack->event_queue_item, stack->client_info);
+		DOUBLE_LINKED_LIST_INSERT_TAIL(tlb, forward, stack);
+		return;
+	}
+
+	abort();
+}
@@ -63,6 +63,7 @@ struct net_buffer_t *net_link_arbitrator_vc(struct net_link_t *link,
 	struct net_node_t *node);
 
 void net_link_dump_report(struct net_link_t *link, FILE *f);
+void net_link_reset_stats(struct net_link_t *link);
 
 
 #endif
@@ -79,6 +79,7 @@ struct net_t
 	long long transfers;	/* Transfers */
 	long long lat_acc;	/* Accumulated latency */
 	long long msg_size_acc;	/* Accumulated message size */
+	long long reset_cycle;	/* Cycle when stats were last reset */
 };
 
 
@@ -90,6 +91,7 @@ void net_free(struct net_t *net);
 void net_dump(struct net_t *net, FILE *f);
 
 void net_dump_report(struct net_t *net, FILE *f);
+void net_reset_stats(struct net_t *net);
 
 struct net_node_t *net_add_end_node(struct net_t *net,
 	int input_buffer_size, int output_buffer_size,
@@ -141,8 +141,8 @@ void net_node_dump_report(struct net_node_t *node, FILE *f)
 	long long cycle;
 	int i;
 
-	/* Get current cycle */
-	cycle = esim_domain_cycle(net_domain_index);
+	/* Get cycles since stats were reset */
+	cycle = esim_domain_cycle(net_domain_index) - net->reset_cycle;
 
 	/* General */
 	fprintf(f, "[ Network.%s.Node.%s ]\n", net->name, node->name);
@@ -195,6 +195,25 @@ void net_node_dump_report(struct net_node_t *node, FILE *f)
 }
 
 
+void net_node_reset_stats(struct net_node_t *node)
+{
+	int i;
+
+	node->bytes_received = 0;
+	node->msgs_received = 0;
+	node->bytes_sent = 0;
+	node->msgs_sent = 0;
+
+	for (i = 0; i < list_count(node->input_buffer_list); i++)
+		net_buffer_reset_stats(list_get(node->input_buffer_list, i));
+	for (i = 0; i < list_count(node->output_buffer_list); i++)
+		net_buffer_reset_stats(list_get(node->output_buffer_list, i));
+	if (node->bus_lane_list)
+		for (i = 0; i < list_count(node->bus_lane_list); i++)
+			net_bus_reset_stats(list_get(node->bus_lane_list, i));
+}
+
+
 struct net_buffer_t *net_node_add_input_buffer(struct net_node_t *node,
 	int bandwidth)
 {
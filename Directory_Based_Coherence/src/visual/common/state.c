@@ -18,12 +18,15 @@
  */
 
 #include <gtk/gtk.h>
+#include <limits.h>
 
+#include <lib/esim/trace-binary.h>
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/debug.h>
 #include <lib/util/file.h>
 #include <lib/util/hash-table.h>
 #include <lib/util/list.h>
+#include <lib/util/misc.h>
 #include <lib/util/string.h>
 
 #include "state.h"
@@ -161,6 +164,14 @@ struct vi_state_t
 	char *unzipped_trace_file_name;
 	FILE *unzipped_trace_file;
 
+	/* Binary trace, read directly instead of the uncompressed trace file.
+	 * Trace file offsets are then positions given by the reader. Body trace
+	 * lines are enumerated with a second reader, since moving a reader
+	 * backwards within a block involves decoding the block again. */
+	struct trace_reader_t *trace_reader;
+	struct trace_reader_t *body_trace_reader;
+	struct trace_record_t *trace_record;
+
 	/* Checkpoint file */
 	char *checkpoint_file_name;
 	FILE *checkpoint_file;
@@ -192,6 +203,42 @@ struct vi_state_t
 static struct vi_state_t *vi_state;
 
 
+static long int vi_state_trace_tell(void)
+{
+	if (vi_state->trace_reader)
+		return trace_reader_tell(vi_state->trace_reader);
+	return ftell(vi_state->unzipped_trace_file);
+}
+
+
+static void vi_state_trace_seek(long int offset)
+{
+	if (vi_state->trace_reader)
+		trace_reader_seek(vi_state->trace_reader, offset);
+	else
+		fseek(vi_state->unzipped_trace_file, offset, SEEK_SET);
+}
+
+
+static struct vi_trace_line_t *vi_state_trace_read_record(struct trace_reader_t *reader)
+{
+	long int offset;
+
+	offset = trace_reader_tell(reader);
+	if (!trace_reader_read(reader, vi_state->trace_record))
+		return NULL;
+	return vi_trace_line_create_from_record(vi_state->trace_record, offset);
+}
+
+
+static struct vi_trace_line_t *vi_state_trace_read(void)
+{
+	if (vi_state->trace_reader)
+		return vi_state_trace_read_record(vi_state->trace_reader);
+	return vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
+}
+
+
 static void vi_state_read_checkpoint(int index)
 {
 	struct vi_state_checkpoint_t *checkpoint;
@@ -205,7 +252,7 @@ static void vi_state_read_checkpoint(int index)
 
 	/* Set file positions */
 	fseek(vi_state->checkpoint_file, checkpoint->checkpoint_file_offset, SEEK_SET);
-	fseek(vi_state->unzipped_trace_file, checkpoint->unzipped_trace_file_offset, SEEK_SET);
+	vi_state_trace_seek(checkpoint->unzipped_trace_file_offset);
 	vi_state->cycle = checkpoint->cycle;
 
 	/* Read checkpoint for every category */
@@ -244,10 +291,6 @@ void vi_state_init(char *trace_file_name)
 
 	/* Create */
 	vi_state = xcalloc(1, sizeof(struct vi_state_t));
-	
-	/* Create uncompressed trace file */
-	vi_state->unzipped_trace_file = file_create_temp(buf, sizeof buf);
-	vi_state->unzipped_trace_file_name = xstrdup(buf);
 
 	/* Create checkpoint file */
 	vi_state->checkpoint_file = file_create_temp(buf, sizeof buf);
@@ -258,6 +301,25 @@ void vi_state_init(char *trace_file_name)
 	vi_state->category_list = list_create();
 	vi_state->command_table = hash_table_create(0, FALSE);
 
+	/* A binary trace is read in place, with the number of cycles given
+	 * in its footer. */
+	vi_state->trace_reader = trace_reader_create(trace_file_name);
+	if (vi_state->trace_reader)
+	{
+		vi_state->body_trace_reader = trace_reader_create(trace_file_name);
+		vi_state->trace_record = xmalloc(sizeof(struct trace_record_t));
+		vi_state->num_cycles = trace_reader_get_num_cycles(vi_state->trace_reader);
+		printf("Reading binary trace (%d blocks, %lld cycles)\n",
+			trace_reader_get_num_blocks(vi_state->trace_reader),
+			vi_state->num_cycles);
+		fflush(stdout);
+		return;
+	}
+
+	/* Create uncompressed trace file */
+	vi_state->unzipped_trace_file = file_create_temp(buf, sizeof buf);
+	vi_state->unzipped_trace_file_name = xstrdup(buf);
+
 	/* Unpack trace */
 	num_trace_lines = 0;
 	trace_file = vi_trace_create(trace_file_name);
@@ -274,7 +336,7 @@ void vi_state_init(char *trace_file_name)
 		if (num_trace_lines % VI_STATE_PROGRESS_INTERVAL == 1)
 		{
 			printf("Uncompressing trace (%.1fMB, %lld cycles)   \r",
-				ftell(vi_state->unzipped_trace_file) / 1.048e6, vi_state->num_cycles);
+				vi_state_trace_tell() / 1.048e6, vi_state->num_cycles);
 			fflush(stdout);
 		}
 	}
@@ -282,7 +344,7 @@ void vi_state_init(char *trace_file_name)
 
 	/* Final progress */
 	printf("Uncompressing trace (%.1fMB, %lld cycles)   \n",
-		ftell(vi_state->unzipped_trace_file) / 1.048e6, vi_state->num_cycles);
+		vi_state_trace_tell() / 1.048e6, vi_state->num_cycles);
 	fflush(stdout);
 }
 
@@ -297,9 +359,18 @@ void vi_state_done(void)
 
 	int i;
 
-	/* Close and delete uncompressed trace file */
-	fclose(vi_state->unzipped_trace_file);
-	unlink(vi_state->unzipped_trace_file_name);
+	/* Close binary trace, or close and delete uncompressed trace file */
+	if (vi_state->trace_reader)
+	{
+		trace_reader_free(vi_state->trace_reader);
+		trace_reader_free(vi_state->body_trace_reader);
+		free(vi_state->trace_record);
+	}
+	else
+	{
+		fclose(vi_state->unzipped_trace_file);
+		unlink(vi_state->unzipped_trace_file_name);
+	}
 
 	/* Close and detele checkpoint file */
 	fclose(vi_state->checkpoint_file);
@@ -353,29 +424,48 @@ long long vi_state_get_current_cycle(void)
 }
 
 
-void vi_state_create_checkpoints(void)
+/* Process the trace until checkpoint 'index' is created or the trace ends,
+ * starting from the last checkpoint created so far. */
+static void vi_state_create_checkpoints_until(int index)
 {
 	struct vi_trace_line_t *trace_line;
+	struct vi_state_checkpoint_t *checkpoint;
 
 	long long last_checkpoint_cycle;
 	long unzipped_trace_file_size;
 
 	int num_trace_lines;
+	int num_checkpoints;
 
 	/* Get unzipped trace file size */
-	fseek(vi_state->unzipped_trace_file, 0, SEEK_END);
-	unzipped_trace_file_size = ftell(vi_state->unzipped_trace_file);
-
-	/* Initialize */
-	last_checkpoint_cycle = -VI_STATE_CHECKPOINT_INTERVAL;
-	fseek(vi_state->unzipped_trace_file, 0, SEEK_SET);
+	if (vi_state->trace_reader)
+		trace_reader_seek(vi_state->trace_reader, LLONG_MAX);
+	else
+		fseek(vi_state->unzipped_trace_file, 0, SEEK_END);
+	unzipped_trace_file_size = vi_state_trace_tell();
+
+	/* Initialize, or resume from the last checkpoint. New checkpoints are
+	 * appended to the checkpoint file. */
+	num_checkpoints = list_count(vi_state->checkpoint_list);
+	if (num_checkpoints)
+	{
+		vi_state_read_checkpoint(num_checkpoints - 1);
+		checkpoint = list_get(vi_state->checkpoint_list, num_checkpoints - 1);
+		last_checkpoint_cycle = checkpoint->cycle;
+		fseek(vi_state->checkpoint_file, 0, SEEK_END);
+	}
+	else
+	{
+		last_checkpoint_cycle = -VI_STATE_CHECKPOINT_INTERVAL;
+		vi_state_trace_seek(0);
+		vi_state->cycle = 0;
+	}
 
 	/* Parse uncompressed trace file */
 	num_trace_lines = 0;
-	vi_state->cycle = 0;
-	while ((trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file)))
+	while (list_count(vi_state->checkpoint_list) <= index &&
+		(trace_line = vi_state_trace_read()))
 	{
-		struct vi_state_checkpoint_t *checkpoint;
 		struct vi_state_command_t *state_command;
 
 		char *command;
@@ -409,12 +499,12 @@ void vi_state_create_checkpoints(void)
 
 		/* Progress */
 		num_trace_lines++;
-		if (num_trace_lines % VI_STATE_PROGRESS_INTERVAL == 1)
+		if (num_trace_lines % VI_STATE_PROGRESS_INTERVAL == 0)
 		{
 			printf("Creating checkpoints (%.1fMB, %.1f%%)   \r",
 				ftell(vi_state->checkpoint_file) / 1.048e6,
 				unzipped_trace_file_size ?
-				(double) ftell(vi_state->unzipped_trace_file) * 100.0 /
+				(double) vi_state_trace_tell() * 100.0 /
 				unzipped_trace_file_size : 0.0);
 			fflush(stdout);
 		}
@@ -423,10 +513,26 @@ void vi_state_create_checkpoints(void)
 		vi_trace_line_free(trace_line);
 	}
 
-	/* Progress */
-	printf("Creating checkpoints (%.1fMB, 100%%)   \n",
-		ftell(vi_state->checkpoint_file) / 1.048e6);
-	fflush(stdout);
+	/* Progress, only shown for long passes */
+	if (num_trace_lines >= VI_STATE_PROGRESS_INTERVAL)
+	{
+		printf("Creating checkpoints (%.1fMB, %.1f%%)   \n",
+			ftell(vi_state->checkpoint_file) / 1.048e6,
+			unzipped_trace_file_size ?
+			(double) vi_state_trace_tell() * 100.0 /
+			unzipped_trace_file_size : 100.0);
+		fflush(stdout);
+	}
+}
+
+
+void vi_state_create_checkpoints(void)
+{
+	/* The whole uncompressed trace is processed now. A binary trace is
+	 * only processed up to its first checkpoint, and further checkpoints
+	 * are created when a later cycle is first visited, so that opening a
+	 * large trace does not take the time of a full pass. */
+	vi_state_create_checkpoints_until(vi_state->trace_reader ? 0 : INT_MAX);
 
 	/* No checkpoint created - assume trace file empty */
 	if (!list_count(vi_state->checkpoint_list))
@@ -485,8 +591,8 @@ struct vi_trace_line_t *vi_state_header_next(void)
 		return NULL;
 
 	/* Read trace line */
-	fseek(vi_state->unzipped_trace_file, vi_state->header_trace_line_offset, SEEK_SET);
-	trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
+	vi_state_trace_seek(vi_state->header_trace_line_offset);
+	trace_line = vi_state_trace_read();
 	if (!trace_line)
 	{
 		vi_state->header_trace_line_offset = -1;
@@ -503,7 +609,7 @@ struct vi_trace_line_t *vi_state_header_next(void)
 
 	/* Save trace line and return */
 	vi_state->header_trace_line = trace_line;
-	vi_state->header_trace_line_offset = ftell(vi_state->unzipped_trace_file);
+	vi_state->header_trace_line_offset = vi_state_trace_tell();
 	return trace_line;
 }
 
@@ -514,8 +620,6 @@ struct vi_trace_line_t *vi_state_trace_line_first(long long cycle)
 
 	int checkpoint_index;
 
-	long long checkpoint_cycle;
-
 	struct vi_state_checkpoint_t *checkpoint;
 
 	/* Release previous body trace line if any */
@@ -530,24 +634,39 @@ struct vi_trace_line_t *vi_state_trace_line_first(long long cycle)
 		return NULL;
 
 	/* Store current position in trace file */
-	trace_file_offset = ftell(vi_state->unzipped_trace_file);
+	trace_file_offset = vi_state_trace_tell();
 
-	/* Get closest checkpoint */
-	checkpoint_index = cycle / VI_STATE_CHECKPOINT_INTERVAL;
-	checkpoint_cycle = (long long) checkpoint_index * VI_STATE_CHECKPOINT_INTERVAL;
-	checkpoint = list_get(vi_state->checkpoint_list, checkpoint_index);
-	if (!checkpoint)
-		panic("%s: invalid checkpoint index", __FUNCTION__);
-
-	/* Set position in trace file */
-	fseek(vi_state->unzipped_trace_file, checkpoint->unzipped_trace_file_offset, SEEK_SET);
-	vi_state->body_trace_line_offset = checkpoint->unzipped_trace_file_offset;
+	/* Set position in trace file. In a binary trace, the body reader is
+	 * placed at the block given by the index for the cycle. Otherwise, the
+	 * trace file is placed at the closest checkpoint. */
+	if (vi_state->body_trace_reader)
+	{
+		trace_reader_seek_cycle(vi_state->body_trace_reader, cycle);
+	}
+	else
+	{
+		checkpoint_index = cycle / VI_STATE_CHECKPOINT_INTERVAL;
+		checkpoint = list_get(vi_state->checkpoint_list, checkpoint_index);
+		if (!checkpoint)
+			panic("%s: invalid checkpoint index", __FUNCTION__);
+		vi_state_trace_seek(checkpoint->unzipped_trace_file_offset);
+	}
 	for (;;)
 	{
 		/* Read trace line */
-		vi_state->body_trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
-		vi_state->body_trace_line_offset = checkpoint->unzipped_trace_file_offset;
-		if (!vi_state->body_trace_line || checkpoint_cycle == cycle)
+		if (vi_state->body_trace_reader)
+		{
+			vi_state->body_trace_line = vi_state_trace_read_record(
+				vi_state->body_trace_reader);
+			vi_state->body_trace_line_offset = trace_reader_tell(
+				vi_state->body_trace_reader);
+		}
+		else
+		{
+			vi_state->body_trace_line = vi_state_trace_read();
+			vi_state->body_trace_line_offset = vi_state_trace_tell();
+		}
+		if (!vi_state->body_trace_line)
 			break;
 
 		/* Check if target cycle is exceeded */
@@ -561,7 +680,7 @@ struct vi_trace_line_t *vi_state_trace_line_first(long long cycle)
 	}
 
 	/* Return to original position in trace file */
-	fseek(vi_state->unzipped_trace_file, trace_file_offset, SEEK_SET);
+	vi_state_trace_seek(trace_file_offset);
 	return vi_state->body_trace_line;
 }
 
@@ -571,7 +690,7 @@ struct vi_trace_line_t *vi_state_trace_line_next(void)
 	long long trace_file_offset;
 
 	/* Store current position in trace file */
-	trace_file_offset = ftell(vi_state->unzipped_trace_file);
+	trace_file_offset = vi_state_trace_tell();
 
 	/* Release previous body trace line if any */
 	if (vi_state->body_trace_line)
@@ -580,13 +699,20 @@ struct vi_trace_line_t *vi_state_trace_line_next(void)
 		vi_state->body_trace_line = NULL;
 	}
 
+	/* Binary trace */
+	if (vi_state->body_trace_reader)
+	{
+		vi_state->body_trace_line = vi_state_trace_read_record(vi_state->body_trace_reader);
+		return vi_state->body_trace_line;
+	}
+
 	/* Get next trace line */
-	fseek(vi_state->unzipped_trace_file, vi_state->body_trace_line_offset, SEEK_SET);
-	vi_state->body_trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
-	vi_state->body_trace_line_offset = ftell(vi_state->unzipped_trace_file);
+	vi_state_trace_seek(vi_state->body_trace_line_offset);
+	vi_state->body_trace_line = vi_state_trace_read();
+	vi_state->body_trace_line_offset = vi_state_trace_tell();
 
 	/* Return to original position in trace file */
-	fseek(vi_state->unzipped_trace_file, trace_file_offset, SEEK_SET);
+	vi_state_trace_seek(trace_file_offset);
 	return vi_state->body_trace_line;
 }
 
@@ -600,8 +726,16 @@ void vi_state_go_to_cycle(long long cycle)
 	if (vi_state->cycle == cycle)
 		return;
 
-	/* Load a checkpoint */
+	/* Load a checkpoint. In a binary trace, the checkpoint might not have
+	 * been created yet. */
 	checkpoint_index = cycle / VI_STATE_CHECKPOINT_INTERVAL;
+	if (checkpoint_index >= list_count(vi_state->checkpoint_list))
+	{
+		vi_state_create_checkpoints_until(checkpoint_index);
+		checkpoint_index = MIN(checkpoint_index,
+			list_count(vi_state->checkpoint_list) - 1);
+		vi_state_read_checkpoint(checkpoint_index);
+	}
 	checkpoint_cycle = (long long) checkpoint_index * VI_STATE_CHECKPOINT_INTERVAL;
 	if (cycle < vi_state->cycle || checkpoint_cycle > vi_state->cycle)
 		vi_state_read_checkpoint(checkpoint_index);
@@ -615,8 +749,8 @@ void vi_state_go_to_cycle(long long cycle)
 		char *command;
 
 		/* Read a trace line */
-		unzipped_trace_file_pos = ftell(vi_state->unzipped_trace_file);
-		trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
+		unzipped_trace_file_pos = vi_state_trace_tell();
+		trace_line = vi_state_trace_read();
 		if (!trace_line)
 			break;
 
@@ -632,7 +766,7 @@ void vi_state_go_to_cycle(long long cycle)
 			/* If we passed the target cycle, done */
 			if (new_cycle > cycle)
 			{
-				fseek(vi_state->unzipped_trace_file, unzipped_trace_file_pos, SEEK_SET);
+				vi_state_trace_seek(unzipped_trace_file_pos);
 				vi_trace_line_free(trace_line);
 				break;
 			}
@@ -139,7 +139,9 @@ void opencl_union_ndrange_run(struct opencl_union_ndrange_t *ndrange)
 		num_devices);
 
 	part = get_strategy()->create(num_devices, ndrange->work_dim, 
-		ndrange->group_count);
+		ndrange->group_count, ndrange->kernel->name,
+		ndrange->local_work_size[0] * ndrange->local_work_size[1] *
+		ndrange->local_work_size[2]);
 	threads = xcalloc(num_devices - 1, sizeof (pthread_t));
 	info = xcalloc(num_devices, sizeof (struct dispatch_info));
 	pthread_mutex_init(&lock, NULL);
@@ -199,6 +201,7 @@ struct opencl_union_kernel_t *opencl_union_kernel_create(
 	kernel->parent = parent;
 	//kernel->device = program->device;
 	kernel->program = program;
+	kernel->name = xstrdup(func_name);
 	kernel->arch_kernels = list_create();
 
 	LIST_FOR_EACH(devices, i)
@@ -244,6 +247,7 @@ void opencl_union_kernel_free(struct opencl_union_kernel_t *kernel)
 
 	/* Free the union kernel */
 	list_free(kernel->arch_kernels);
+	free(kernel->name);
 	free(kernel);
 }
 
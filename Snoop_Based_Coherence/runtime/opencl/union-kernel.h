@@ -14,6 +14,10 @@ struct opencl_union_kernel_t
 	struct opencl_kernel_t *parent;
 	struct opencl_union_program_t *program;
 
+	/* Kernel function name, used to keep partitioning statistics across
+	 * ND-Ranges of the same kernel */
+	char *name;
+
 	/* list of architecture-specific kernels */
 	struct list_t *arch_kernels;
 };
@@ -408,10 +408,21 @@ void opencl_x86_ndrange_init(struct opencl_x86_ndrange_t *ndrange)
 	opencl_debug("[%s] initing x86 ndrange", __FUNCTION__);
 
 	struct opencl_x86_device_exec_t *exec;
+	struct opencl_x86_device_t *device = ndrange->arch_kernel->device;
 	exec = xcalloc(1, sizeof(struct opencl_x86_device_exec_t));
 
+	/* One work-group queue per core */
+	exec->num_queues = device->num_cores;
+	if (posix_memalign((void **) &exec->queues,
+			sizeof(struct opencl_x86_device_queue_t),
+			exec->num_queues * sizeof(struct opencl_x86_device_queue_t)))
+		fatal("%s: out of memory", __FUNCTION__);
+	mhandle_register_ptr(exec->queues,
+			exec->num_queues * sizeof(struct opencl_x86_device_queue_t));
+	memset(exec->queues, 0, exec->num_queues * sizeof(struct opencl_x86_device_queue_t));
 #ifndef HAVE_SYNC_BUILTINS
-	pthread_mutex_init(&exec->next_group_lock, NULL);
+	for (int i = 0; i < exec->num_queues; i++)
+		pthread_mutex_init(&exec->queues[i].lock, NULL);
 #endif
 	exec->ndrange = ndrange;
 	exec->kernel = ndrange->arch_kernel;
@@ -423,8 +434,10 @@ void opencl_x86_ndrange_free(struct opencl_x86_ndrange_t *ndrange)
 {
 	opencl_debug("[%s] freeing x86 ndrange", __FUNCTION__);
 #ifndef HAVE_SYNC_BUILTINS
-	pthread_mutex_destroy(&ndrange->exec->next_group_lock);
+	for (int i = 0; i < ndrange->exec->num_queues; i++)
+		pthread_mutex_destroy(&ndrange->exec->queues[i].lock);
 #endif
+	free(ndrange->exec->queues);
 	free(ndrange->exec);
 }
 
@@ -445,6 +458,7 @@ void opencl_x86_ndrange_run_partial(struct opencl_x86_ndrange_t *ndrange,
 	exec->num_groups = 1;
 	for (int i = 0; i < 3; i++)
 		exec->num_groups *= work_group_count[i];
+	opencl_x86_device_exec_seed(exec);
 
 	/* we can use the queue thread a a worker thread, but we should set it's affinity */
 	if (!device->set_queue_affinity)
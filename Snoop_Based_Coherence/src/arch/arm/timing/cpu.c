@@ -17,7 +17,19 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <assert.h>
+
+#include <arch/arm/emu/context.h>
+#include <arch/arm/emu/emu.h>
+#include <arch/arm/emu/regs.h>
+#include <lib/esim/esim.h>
+#include <lib/mhandle/mhandle.h>
+#include <lib/util/debug.h>
+#include <lib/util/file.h>
 #include <lib/util/misc.h>
+#include <lib/util/string.h>
+#include <mem-system/memory.h>
+#include <mem-system/mmu.h>
 
 #include "cpu.h"
 
@@ -30,36 +42,307 @@ CLASS_IMPLEMENTATION(ARMCpu);
 
 void ARMCpuCreate(ARMCpu *self)
 {
+	char name[MAX_STRING_SIZE];
+	int i;
+
 	/* Parent */
 	TimingCreate(asTiming(self));
 
+	/* Frequency */
+	asTiming(self)->frequency = arm_cpu_config.frequency;
+	asTiming(self)->frequency_domain = esim_new_domain(arm_cpu_config.frequency);
+
+	/* Cores */
+	self->cores = xcalloc(arm_cpu_config.num_cores, sizeof(void *));
+	self->core_ctx = xcalloc(arm_cpu_config.num_cores, sizeof(void *));
+	for (i = 0; i < arm_cpu_config.num_cores; i++)
+	{
+		snprintf(name, sizeof name, "c%d", i);
+		self->cores[i] = interval_core_create(name,
+			arm_cpu_config.dispatch_width,
+			arm_cpu_config.window_size,
+			arm_cpu_config.store_buffer_size,
+			arm_cpu_config.mispred_penalty,
+			arm_cpu_config.btb_size);
+	}
+
 	/* Virtual functions */
 	asObject(self)->Dump = ARMCpuDump;
 	asTiming(self)->DumpSummary = ARMCpuDumpSummary;
+	asTiming(self)->ResetStats = ARMCpuResetStats;
 	asTiming(self)->Run = ARMCpuRun;
+	asTiming(self)->MemConfigDefault = ARMCpuMemConfigDefault;
+	asTiming(self)->MemConfigCheck = ARMCpuMemConfigCheck;
+	asTiming(self)->MemConfigParseEntry = ARMCpuMemConfigParseEntry;
 }
 
 
 void ARMCpuDestroy(ARMCpu *self)
 {
+	FILE *f;
+	int i;
+
+	/* Dump report */
+	f = file_open_for_write(arm_cpu_report_file_name);
+	if (f)
+	{
+		ARMCpuDump(asObject(self), f);
+		fclose(f);
+	}
+
+	/* Free cores */
+	for (i = 0; i < arm_cpu_config.num_cores; i++)
+		interval_core_free(self->cores[i]);
+	free(self->cores);
+	free(self->core_ctx);
 }
 
 
 void ARMCpuDump(Object *self, FILE *f)
 {
+	ARMCpu *cpu = asARMCpu(self);
+	int i;
+
+	/* Configuration */
+	interval_config_dump(&arm_cpu_config, f);
+
+	/* Cores */
+	for (i = 0; i < arm_cpu_config.num_cores; i++)
+	{
+		fprintf(f, "[ c%d ]\n\n", i);
+		interval_core_dump_report(cpu->cores[i], f);
+	}
 }
 
 
 void ARMCpuDumpSummary(Timing *self, FILE *f)
 {
+	ARMCpu *cpu = asARMCpu(self);
+
+	long long cycles;
+	double inst_per_cycle;
+	double branch_acc;
+
+	/* Calculate statistics */
+	cycles = self->cycle - self->reset_cycle;
+	inst_per_cycle = cycles ? (double) cpu->num_committed_inst
+			/ cycles : 0.0;
+	branch_acc = cpu->num_branches ? (double) (cpu->num_branches -
+			cpu->num_mispred_branches) / cpu->num_branches : 0.0;
+
+	/* Print statistics */
+	fprintf(f, "CommittedInstructions = %lld\n", cpu->num_committed_inst);
+	fprintf(f, "CommittedInstructionsPerCycle = %.4g\n", inst_per_cycle);
+	fprintf(f, "BranchPredictionAccuracy = %.4g\n", branch_acc);
+
 	/* Call parent */
 	TimingDumpSummary(asTiming(self), f);
 }
 
 
+void ARMCpuResetStats(Timing *self)
+{
+	ARMCpu *cpu = asARMCpu(self);
+	int i;
+
+	cpu->num_committed_inst = 0;
+	cpu->num_branches = 0;
+	cpu->num_mispred_branches = 0;
+	for (i = 0; i < arm_cpu_config.num_cores; i++)
+		interval_core_reset_stats(cpu->cores[i]);
+
+	/* Call parent */
+	TimingResetStats(self);
+}
+
+
+/* Address of the next instruction to emulate. Register 'pc' runs ahead of it
+ * by the size of an instruction in the current mode. */
+static unsigned int ARMCpuGetPC(struct arm_ctx_t *ctx)
+{
+	return ctx->regs->pc - (ctx->regs->cpsr.thumb ? 2 : 4);
+}
+
+
+static void ARMCpuRunCore(ARMCpu *self, struct interval_core_t *core,
+	struct arm_ctx_t *ctx)
+{
+	struct mem_t *mem;
+	struct mem_record_t *record;
+
+	unsigned int pc;
+	unsigned int next_pc;
+	unsigned int phy_addr;
+
+	int size;
+	int mispred;
+	int i;
+
+	/* New cycle */
+	interval_core_cycle(core, asTiming(self)->cycle);
+
+	/* Context must be running */
+	if (!ctx || !arm_ctx_get_status(ctx, arm_ctx_running))
+	{
+		interval_core_stall(core, interval_stall_ctx);
+		return;
+	}
+
+	/* Dispatch instructions */
+	mem = ctx->mem;
+	core->address_space_index = ctx->address_space_index;
+	while (interval_core_can_dispatch(core))
+	{
+		/* Fetch */
+		pc = ARMCpuGetPC(ctx);
+		phy_addr = mmu_translate(ctx->address_space_index, pc);
+		if (!interval_core_fetch(core, pc, phy_addr))
+			break;
+
+		/* Functional simulation, recording data accesses */
+		mem->record = 1;
+		mem->record_count = 0;
+		arm_ctx_execute(ctx);
+		mem->record = 0;
+		interval_core_dispatch(core, 1);
+		self->num_committed_inst++;
+
+		/* Memory accesses */
+		for (i = 0; i < mem->record_count; i++)
+		{
+			record = &mem->record_list[i];
+			phy_addr = mmu_translate(ctx->address_space_index, record->addr);
+			if (record->access == mem_access_write)
+				interval_core_store(core, record->addr, phy_addr);
+			else
+				interval_core_load(core, record->addr, phy_addr);
+		}
+
+		/* Stop if the instruction caused the context to suspend or
+		 * finish. */
+		if (!arm_ctx_get_status(ctx, arm_ctx_running))
+			break;
+
+		/* Branches */
+		next_pc = ARMCpuGetPC(ctx);
+		size = ctx->inst_type == THUMB16 ? 2 : 4;
+		mispred = interval_core_predict(core, pc, next_pc, pc + size);
+		if (next_pc != pc + size || mispred)
+		{
+			self->num_branches++;
+			self->num_mispred_branches += mispred;
+		}
+
+		/* Stop after a misprediction */
+		if (mispred)
+			break;
+	}
+}
+
+
+/* Map running contexts to cores. A context keeps its core until it is freed,
+ * or until it stops running and a waiting context takes the core. The core
+ * is only taken once it has no data access in flight, so that a context never
+ * moves away from the core holding its accesses. */
+static void ARMCpuMapContexts(ARMCpu *self)
+{
+	struct arm_ctx_t *ctx;
+
+	int core;
+	int i;
+
+	for (ctx = arm_emu->running_list_head; ctx; ctx = ctx->running_list_next)
+	{
+		/* Context already mapped */
+		for (i = 0; i < arm_cpu_config.num_cores; i++)
+			if (self->core_ctx[i] == ctx)
+				break;
+		if (i < arm_cpu_config.num_cores)
+			continue;
+
+		/* Free core, or core of a context that stopped running */
+		core = -1;
+		for (i = 0; i < arm_cpu_config.num_cores && core < 0; i++)
+			if (!self->core_ctx[i])
+				core = i;
+		for (i = 0; i < arm_cpu_config.num_cores && core < 0; i++)
+			if (!arm_ctx_get_status(self->core_ctx[i], arm_ctx_running) &&
+					interval_core_is_empty(self->cores[i]))
+				core = i;
+
+		/* No core available for this or the next contexts */
+		if (core < 0)
+			break;
+		self->core_ctx[core] = ctx;
+	}
+}
+
+
 int ARMCpuRun(Timing *self)
 {
-	return FALSE;
+	ARMCpu *cpu = asARMCpu(self);
+	struct arm_ctx_t *ctx;
+
+	int i;
+
+	/* Stop if there is no context running */
+	if (arm_emu->finished_list_count >= arm_emu->context_list_count)
+		return FALSE;
+
+	/* Stop if maximum number of CPU instructions exceeded */
+	if (arm_emu_max_inst && cpu->num_committed_inst >= arm_emu_max_inst)
+		esim_finish = esim_finish_arm_max_inst;
+
+	/* Stop if maximum number of cycles exceeded */
+	if (arm_emu_max_cycles && self->cycle >= arm_emu_max_cycles)
+		esim_finish = esim_finish_arm_max_cycles;
+
+	/* Stop if any previous reason met */
+	if (esim_finish)
+		return TRUE;
+
+	/* One more cycle of ARM timing simulation */
+	self->cycle++;
+
+	/* Map contexts to cores */
+	ARMCpuMapContexts(cpu);
+
+	/* Cores */
+	for (i = 0; i < arm_cpu_config.num_cores; i++)
+		ARMCpuRunCore(cpu, cpu->cores[i], cpu->core_ctx[i]);
+
+	/* Free finished contexts, releasing their cores */
+	while ((ctx = arm_emu->finished_list_head))
+	{
+		for (i = 0; i < arm_cpu_config.num_cores; i++)
+			if (cpu->core_ctx[i] == ctx)
+				cpu->core_ctx[i] = NULL;
+		arm_ctx_free(ctx);
+	}
+
+	/* Still simulating */
+	return TRUE;
+}
+
+
+void ARMCpuMemConfigDefault(Timing *self, struct config_t *config)
+{
+	interval_mem_config_default(self->arch, config, arm_cpu_config.num_cores);
+}
+
+
+void ARMCpuMemConfigCheck(Timing *self, struct config_t *config)
+{
+	interval_mem_config_check(self->arch, config, asARMCpu(self)->cores,
+		arm_cpu_config.num_cores);
+}
+
+
+void ARMCpuMemConfigParseEntry(Timing *self, struct config_t *config,
+		char *section)
+{
+	interval_mem_config_parse_entry(self->arch, config, section,
+		asARMCpu(self)->cores, arm_cpu_config.num_cores);
 }
 
 
@@ -71,9 +354,15 @@ int ARMCpuRun(Timing *self)
 
 ARMCpu *arm_cpu;
 
+char *arm_cpu_config_file_name = "";
+char *arm_cpu_report_file_name = "";
+
+struct interval_config_t arm_cpu_config;
+
 
 void arm_cpu_read_config(void)
 {
+	interval_config_read(&arm_cpu_config, arm_cpu_config_file_name);
 }
 
 
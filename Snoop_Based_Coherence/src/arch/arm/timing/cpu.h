@@ -22,15 +22,31 @@
 
 #include <stdio.h>
 
+#include <arch/common/interval.h>
 #include <arch/common/timing.h>
 
 
+/* Forward declarations */
+struct arm_ctx_t;
+
+
 /*
  * Class 'ARMCpu'
  */
 
+/* The ARM timing simulator is made of interval cores (see
+ * 'arch/common/interval.h'). Each core runs one of the running contexts. */
 CLASS_BEGIN(ARMCpu, Timing)
 
+	/* Cores, and context mapped to each of them */
+	struct interval_core_t **cores;
+	struct arm_ctx_t **core_ctx;
+
+	/* Statistics */
+	long long num_committed_inst;
+	long long num_branches;
+	long long num_mispred_branches;
+
 CLASS_END(ARMCpu)
 
 void ARMCpuCreate(ARMCpu *self);
@@ -40,6 +56,12 @@ int ARMCpuRun(Timing *self);
 
 void ARMCpuDump(Object *self, FILE *f);
 void ARMCpuDumpSummary(Timing *self, FILE *f);
+void ARMCpuResetStats(Timing *self);
+
+void ARMCpuMemConfigDefault(Timing *self, struct config_t *config);
+void ARMCpuMemConfigCheck(Timing *self, struct config_t *config);
+void ARMCpuMemConfigParseEntry(Timing *self, struct config_t *config,
+		char *section);
 
 
 
@@ -49,6 +71,10 @@ void ARMCpuDumpSummary(Timing *self, FILE *f);
 
 extern ARMCpu *arm_cpu;
 
+extern char *arm_cpu_config_file_name;
+extern char *arm_cpu_report_file_name;
+extern struct interval_config_t arm_cpu_config;
+
 void arm_cpu_read_config(void);
 
 void arm_cpu_init(void);
@@ -0,0 +1,220 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_COMMON_INTERVAL_H
+#define ARCH_COMMON_INTERVAL_H
+
+#include <stdio.h>
+
+/* Forward declarations */
+struct arch_t;
+struct config_t;
+
+
+/* Interval core model. Instead of modeling every pipeline stage, a core
+ * dispatches up to 'dispatch_width' uops per cycle from the functional
+ * emulator and only stalls on the events that dominate performance in a
+ * memory-bound program:
+ *
+ *   - Window. Loads are issued to the memory hierarchy at dispatch. Dispatch
+ *     continues behind a load in flight until the window (reorder buffer)
+ *     fills up, which overlaps independent misses as the out-of-order
+ *     pipeline would.
+ *   - Store buffer. Stores are issued at dispatch and hold a store buffer
+ *     entry until the data cache accepts them.
+ *   - Memory ports. If a module cannot take an access (ports or MSHR busy),
+ *     the access waits and dispatch stops until it is issued.
+ *   - Instruction fetch. A new cache block is requested through the
+ *     instruction module. Dispatch stalls only while a fetch is in flight for
+ *     longer than the module hit latency, which the front-end hides.
+ *   - Branch mispredictions. Dispatch stops until the loads older than the
+ *     branch complete, and then for 'mispred_penalty' cycles to refill the
+ *     front-end.
+ *
+ * Architecture-specific code drives the model: it calls
+ * 'interval_core_cycle' once per cycle, then runs instructions while
+ * 'interval_core_can_dispatch' and 'interval_core_fetch' allow it, reporting
+ * each one with 'interval_core_dispatch' followed by its data accesses. */
+
+enum interval_stall_t
+{
+	interval_stall_none = 0,
+	interval_stall_ctx,  /* No context mapped to the core */
+	interval_stall_window,  /* Window full behind the oldest load */
+	interval_stall_store_buffer,  /* Store buffer full */
+	interval_stall_mem,  /* Data access waiting for a free port or MSHR */
+	interval_stall_fetch,  /* Instruction fetch in flight */
+	interval_stall_branch,  /* Branch misprediction */
+	interval_stall_count
+};
+
+extern char *interval_stall_name[interval_stall_count];
+
+/* Data access tracked by the core */
+struct interval_access_t
+{
+	long long seq;  /* Window position of the uop that performs it */
+	int kind;  /* Value of type 'enum mod_access_kind_t' */
+	int issued;  /* Sent to the memory hierarchy */
+	int witness;  /* Incremented to 0 by the memory hierarchy on completion */
+	unsigned int vtl_addr;
+	unsigned int phy_addr;
+};
+
+/* Entry of the branch target table */
+struct interval_btb_entry_t
+{
+	unsigned int pc;
+	unsigned int target;
+	int counter;  /* 2-bit saturating taken counter */
+};
+
+struct interval_core_t
+{
+	char *name;
+
+	/* Parameters */
+	int dispatch_width;
+	int window_size;
+	int store_buffer_size;
+	int mispred_penalty;
+
+	/* Entries to the memory hierarchy, assigned by the architecture. The
+	 * TLBs are optional. Field 'address_space_index' must be set to the
+	 * address space of the context running on the core before dispatching
+	 * its instructions. */
+	struct mod_t *data_mod;
+	struct mod_t *inst_mod;
+	struct tlb_t *data_tlb;
+	struct tlb_t *inst_tlb;
+	int address_space_index;
+
+	/* Current cycle, and uops dispatched in it. Field 'cycle_mispred' is set
+	 * once a mispredicted branch is dispatched in the cycle. */
+	long long cycle;
+	int cycle_uops;
+	int cycle_stalled;
+	int cycle_mispred;
+
+	/* Uops dispatched so far. An instruction at window position 'seq'
+	 * cannot be dispatched while the oldest load in flight has a position
+	 * of 'seq - window_size' or lower. */
+	long long seq;
+
+	/* Loads and stores in flight, circular lists in program order */
+	struct interval_access_t *load_list;
+	int load_list_size;
+	int load_head;
+	int load_count;
+	struct interval_access_t *store_list;
+	int store_list_size;
+	int store_head;
+	int store_count;
+
+	/* Accesses not issued yet for lack of a free port or MSHR */
+	int pending_count;
+
+	/* Instruction fetch */
+	unsigned int fetch_block;
+	int fetch_witness;
+	long long fetch_cycle;
+
+	/* Branch misprediction. While 'branch_pending' is set, dispatch waits
+	 * for the loads up to position 'branch_seq' to complete. Then it stays
+	 * stalled until cycle 'branch_ready'. */
+	int branch_pending;
+	long long branch_seq;
+	long long branch_ready;
+
+	/* Branch target table, used by architectures without a branch predictor
+	 * of their own through 'interval_core_predict'. */
+	struct interval_btb_entry_t *btb;
+	int btb_size;
+
+	/* Statistics */
+	long long cycles;
+	long long dispatched_inst;
+	long long dispatched_uops;
+	long long loads;
+	long long stores;
+	long long prefetches;
+	long long branches;
+	long long mispred_branches;
+	long long fetches;
+	long long stalls[interval_stall_count];
+};
+
+struct interval_core_t *interval_core_create(char *name, int dispatch_width,
+	int window_size, int store_buffer_size, int mispred_penalty,
+	int btb_size);
+void interval_core_free(struct interval_core_t *core);
+
+void interval_core_dump_report(struct interval_core_t *core, FILE *f);
+void interval_core_reset_stats(struct interval_core_t *core);
+
+void interval_core_cycle(struct interval_core_t *core, long long cycle);
+void interval_core_stall(struct interval_core_t *core, enum interval_stall_t stall);
+int interval_core_can_dispatch(struct interval_core_t *core);
+int interval_core_fetch(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr);
+int interval_core_is_empty(struct interval_core_t *core);
+
+void interval_core_dispatch(struct interval_core_t *core, int num_uops);
+void interval_core_load(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr);
+void interval_core_store(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr);
+void interval_core_prefetch(struct interval_core_t *core, unsigned int vtl_addr,
+	unsigned int phy_addr);
+void interval_core_branch(struct interval_core_t *core, int mispred);
+
+int interval_core_predict(struct interval_core_t *core, unsigned int pc,
+	unsigned int next_pc, unsigned int fall_through_pc);
+
+
+/* Parameters of the interval cores of a CPU architecture with no pipeline
+ * model of its own, read from its CPU configuration file. */
+struct interval_config_t
+{
+	int frequency;
+	int num_cores;
+	int dispatch_width;
+	int window_size;
+	int store_buffer_size;
+	int mispred_penalty;
+	int btb_size;
+};
+
+extern char *interval_config_help;
+
+void interval_config_read(struct interval_config_t *cfg, char *file_name);
+void interval_config_dump(struct interval_config_t *cfg, FILE *f);
+
+/* Entries to the memory hierarchy for the cores of such an architecture.
+ * Sections [Entry <name>] give a core with variable 'Core', and either a
+ * unified 'Module' or a 'DataModule' and an 'InstModule'. */
+void interval_mem_config_default(struct arch_t *arch, struct config_t *config,
+	int num_cores);
+void interval_mem_config_parse_entry(struct arch_t *arch,
+	struct config_t *config, char *section,
+	struct interval_core_t **cores, int num_cores);
+void interval_mem_config_check(struct arch_t *arch, struct config_t *config,
+	struct interval_core_t **cores, int num_cores);
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_COMMON_ROI_H
+#define ARCH_COMMON_ROI_H
+
+
+/* Region of interest (ROI). Statistics of the memory system and of the timing
+ * simulators are reset when the ROI starts, and simulation finishes when it
+ * ends, so that the final reports only cover the ROI. Its limits are given
+ * with command-line options as global simulation cycles, or marked by the
+ * guest program with system call 'ROI_SYSCALL_CODE', passing one of the
+ * values of 'enum roi_marker_t' in register 'ebx'. */
+
+#define ROI_SYSCALL_CODE  332
+
+enum roi_marker_t
+{
+	roi_marker_begin = 1,
+	roi_marker_end
+};
+
+enum roi_state_t
+{
+	roi_state_before = 0,
+	roi_state_inside,
+	roi_state_after
+};
+
+extern long long roi_start_cycle;  /* Given with '--roi-start', or 0 */
+extern long long roi_end_cycle;  /* Given with '--roi-end', or 0 */
+extern int roi_fast_forward;  /* Emulate functionally until the ROI starts */
+
+extern enum roi_state_t roi_state;
+extern long long roi_begin_cycle;  /* Global cycle when the ROI started */
+
+void roi_begin(void);
+void roi_end(void);
+
+/* Called once per iteration of the main simulation loop to check the limits
+ * given with command-line options. */
+void roi_check(void);
+
+/* Run the marker system call with argument 'marker', returning 0, or a
+ * negative value if the marker is invalid. */
+int roi_marker(int marker);
+
+void roi_done(void);
+
+#endif
+
@@ -233,15 +233,16 @@ static void evg_cf_engine_execute(struct evg_compute_unit_t *compute_unit)
 		/* Global memory write - execute asynchronously */
 		if (uop->global_mem_write)
 		{
+			coalescer_start(&compute_unit->global_mem_coalescer, compute_unit->global_memory,
+				mod_access_nc_store, &uop->global_mem_witness);
 			EVG_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
 			{
 				work_item = ndrange->work_items[work_item_id];
 				work_item_uop = &uop->work_item_uop[work_item->id_in_wavefront];
-				mod_access(compute_unit->global_memory, mod_access_nc_store, 
-					work_item_uop->global_mem_access_addr,
-					&uop->global_mem_witness, NULL, NULL, NULL);
-				uop->global_mem_witness--;
+				coalescer_add(&compute_unit->global_mem_coalescer,
+					work_item_uop->global_mem_access_addr);
 			}
+			coalescer_end(&compute_unit->global_mem_coalescer);
 		}
 	}
 
@@ -48,6 +48,7 @@ extern enum evg_gpu_register_alloc_granularity_t
 
 extern int evg_gpu_max_work_groups_per_compute_unit;
 extern int evg_gpu_max_wavefronts_per_compute_unit;
+extern int evg_gpu_global_mem_coalesce;
 
 extern char *evg_gpu_calc_file_name;
 
@@ -119,6 +120,7 @@ void EvgGpuDestroy(EvgGpu *self);
 
 void EvgGpuDump(Object *self, FILE *f);
 void EvgGpuDumpSummary(Timing *self, FILE *f);
+void EvgGpuResetStats(Timing *self);
 
 int EvgGpuRun(Timing *self);
 
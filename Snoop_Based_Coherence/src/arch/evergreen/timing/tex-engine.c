@@ -198,15 +198,16 @@ static void evg_tex_engine_read(struct evg_compute_unit_t *compute_unit)
 	if (uop->global_mem_read)
 	{
 		assert(!uop->global_mem_witness);
+		coalescer_start(&compute_unit->global_mem_coalescer, compute_unit->global_memory,
+			mod_access_load, &uop->global_mem_witness);
 		EVG_FOREACH_WORK_ITEM_IN_WAVEFRONT(uop->wavefront, work_item_id)
 		{
 			work_item = evg_gpu->ndrange->work_items[work_item_id];
 			work_item_uop = &uop->work_item_uop[work_item->id_in_wavefront];
-			mod_access(compute_unit->global_memory, mod_access_load, 
-				work_item_uop->global_mem_access_addr,
-				&uop->global_mem_witness, NULL, NULL, NULL);
-			uop->global_mem_witness--;
+			coalescer_add(&compute_unit->global_mem_coalescer,
+				work_item_uop->global_mem_access_addr);
 		}
+		coalescer_end(&compute_unit->global_mem_coalescer);
 		uop->num_global_mem_read = uop->global_mem_witness;
 		if(evg_spatial_report_active)
 			evg_tex_report_global_mem_inflight(compute_unit,uop->num_global_mem_read);
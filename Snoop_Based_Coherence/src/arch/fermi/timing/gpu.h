@@ -179,6 +179,7 @@ extern int frm_gpu_vector_mem_exec_latency;
 extern int frm_gpu_vector_mem_exec_buffer_size;
 extern int frm_gpu_vector_mem_write_latency;
 extern int frm_gpu_vector_mem_write_buffer_size;
+extern int frm_gpu_vector_mem_coalesce;
 extern int frm_gpu_vector_mem_max_inflight_mem_accesses;
 
 extern int frm_gpu_shared_mem_size;
@@ -238,6 +239,7 @@ void FrmGpuDestroy(FrmGpu *self);
 
 void FrmGpuDump(Object *self, FILE *f);
 void FrmGpuDumpSummary(Timing *self, FILE *f);
+void FrmGpuResetStats(Timing *self);
 
 int FrmGpuRun(Timing *self);
 
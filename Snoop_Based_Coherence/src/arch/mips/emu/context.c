@@ -30,6 +30,7 @@
 #include <lib/util/string.h>
 #include <lib/util/timer.h>
 #include <mem-system/memory.h>
+#include <mem-system/mmu.h>
 
 #include "context.h"
 #include "file.h"
@@ -505,6 +506,7 @@ struct mips_ctx_t *mips_ctx_create(void)
 	ctx = mips_ctx_do_create();
 
 	/* Memory */
+	ctx->address_space_index = mmu_address_space_new();
 	ctx->mem = mem_create();
 
 	/* Initialize Loader Sections*/
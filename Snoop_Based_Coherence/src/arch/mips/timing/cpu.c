@@ -17,10 +17,22 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <assert.h>
+
+#include <arch/mips/emu/context.h>
+#include <arch/mips/emu/emu.h>
+#include <lib/esim/esim.h>
+#include <lib/mhandle/mhandle.h>
+#include <lib/util/debug.h>
+#include <lib/util/file.h>
 #include <lib/util/misc.h>
+#include <lib/util/string.h>
+#include <mem-system/memory.h>
+#include <mem-system/mmu.h>
 
 #include "cpu.h"
 
+
 /*
  * Class 'MIPSCpu'
  */
@@ -29,36 +41,298 @@ CLASS_IMPLEMENTATION(MIPSCpu);
 
 void MIPSCpuCreate(MIPSCpu *self)
 {
+	char name[MAX_STRING_SIZE];
+	int i;
+
 	/* Parent */
 	TimingCreate(asTiming(self));
 
+	/* Frequency */
+	asTiming(self)->frequency = mips_cpu_config.frequency;
+	asTiming(self)->frequency_domain = esim_new_domain(mips_cpu_config.frequency);
+
+	/* Cores */
+	self->cores = xcalloc(mips_cpu_config.num_cores, sizeof(void *));
+	self->core_ctx = xcalloc(mips_cpu_config.num_cores, sizeof(void *));
+	for (i = 0; i < mips_cpu_config.num_cores; i++)
+	{
+		snprintf(name, sizeof name, "c%d", i);
+		self->cores[i] = interval_core_create(name,
+			mips_cpu_config.dispatch_width,
+			mips_cpu_config.window_size,
+			mips_cpu_config.store_buffer_size,
+			mips_cpu_config.mispred_penalty,
+			mips_cpu_config.btb_size);
+	}
+
 	/* Virtual functions */
 	asObject(self)->Dump = MIPSCpuDump;
 	asTiming(self)->DumpSummary = MIPSCpuDumpSummary;
+	asTiming(self)->ResetStats = MIPSCpuResetStats;
 	asTiming(self)->Run = MIPSCpuRun;
+	asTiming(self)->MemConfigDefault = MIPSCpuMemConfigDefault;
+	asTiming(self)->MemConfigCheck = MIPSCpuMemConfigCheck;
+	asTiming(self)->MemConfigParseEntry = MIPSCpuMemConfigParseEntry;
 }
 
 
 void MIPSCpuDestroy(MIPSCpu *self)
 {
+	FILE *f;
+	int i;
+
+	/* Dump report */
+	f = file_open_for_write(mips_cpu_report_file_name);
+	if (f)
+	{
+		MIPSCpuDump(asObject(self), f);
+		fclose(f);
+	}
+
+	/* Free cores */
+	for (i = 0; i < mips_cpu_config.num_cores; i++)
+		interval_core_free(self->cores[i]);
+	free(self->cores);
+	free(self->core_ctx);
 }
 
 
 void MIPSCpuDump(Object *self, FILE *f)
 {
+	MIPSCpu *cpu = asMIPSCpu(self);
+	int i;
+
+	/* Configuration */
+	interval_config_dump(&mips_cpu_config, f);
+
+	/* Cores */
+	for (i = 0; i < mips_cpu_config.num_cores; i++)
+	{
+		fprintf(f, "[ c%d ]\n\n", i);
+		interval_core_dump_report(cpu->cores[i], f);
+	}
 }
 
 
 void MIPSCpuDumpSummary(Timing *self, FILE *f)
 {
+	MIPSCpu *cpu = asMIPSCpu(self);
+
+	long long cycles;
+	double inst_per_cycle;
+	double branch_acc;
+
+	/* Calculate statistics */
+	cycles = self->cycle - self->reset_cycle;
+	inst_per_cycle = cycles ? (double) cpu->num_committed_inst
+			/ cycles : 0.0;
+	branch_acc = cpu->num_branches ? (double) (cpu->num_branches -
+			cpu->num_mispred_branches) / cpu->num_branches : 0.0;
+
+	/* Print statistics */
+	fprintf(f, "CommittedInstructions = %lld\n", cpu->num_committed_inst);
+	fprintf(f, "CommittedInstructionsPerCycle = %.4g\n", inst_per_cycle);
+	fprintf(f, "BranchPredictionAccuracy = %.4g\n", branch_acc);
+
+	/* Call parent */
+	TimingDumpSummary(asTiming(self), f);
+}
+
+
+void MIPSCpuResetStats(Timing *self)
+{
+	MIPSCpu *cpu = asMIPSCpu(self);
+	int i;
+
+	cpu->num_committed_inst = 0;
+	cpu->num_branches = 0;
+	cpu->num_mispred_branches = 0;
+	for (i = 0; i < mips_cpu_config.num_cores; i++)
+		interval_core_reset_stats(cpu->cores[i]);
+
 	/* Call parent */
-	TimingDumpSummary(self, f);
+	TimingResetStats(self);
+}
+
+
+static void MIPSCpuRunCore(MIPSCpu *self, struct interval_core_t *core,
+	struct mips_ctx_t *ctx)
+{
+	struct mem_t *mem;
+	struct mem_record_t *record;
+
+	unsigned int pc;
+	unsigned int next_pc;
+	unsigned int phy_addr;
+
+	int mispred;
+	int i;
+
+	/* New cycle */
+	interval_core_cycle(core, asTiming(self)->cycle);
+
+	/* Context must be running */
+	if (!ctx || !mips_ctx_get_status(ctx, mips_ctx_running))
+	{
+		interval_core_stall(core, interval_stall_ctx);
+		return;
+	}
+
+	/* Dispatch instructions */
+	mem = ctx->mem;
+	core->address_space_index = ctx->address_space_index;
+	while (interval_core_can_dispatch(core))
+	{
+		/* Fetch */
+		pc = ctx->next_ip;
+		phy_addr = mmu_translate(ctx->address_space_index, pc);
+		if (!interval_core_fetch(core, pc, phy_addr))
+			break;
+
+		/* Functional simulation, recording data accesses */
+		mem->record = 1;
+		mem->record_count = 0;
+		mips_ctx_execute(ctx);
+		mem->record = 0;
+		interval_core_dispatch(core, 1);
+		self->num_committed_inst++;
+
+		/* Memory accesses */
+		for (i = 0; i < mem->record_count; i++)
+		{
+			record = &mem->record_list[i];
+			phy_addr = mmu_translate(ctx->address_space_index, record->addr);
+			if (record->access == mem_access_write)
+				interval_core_store(core, record->addr, phy_addr);
+			else
+				interval_core_load(core, record->addr, phy_addr);
+		}
+
+		/* Stop if the instruction caused the context to suspend or
+		 * finish. */
+		if (!mips_ctx_get_status(ctx, mips_ctx_running))
+			break;
+
+		/* Branches. The address following a branch is that of its delay
+		 * slot, so the change of flow is observed on the delay slot. */
+		next_pc = ctx->next_ip;
+		mispred = interval_core_predict(core, pc, next_pc, pc + 4);
+		if (next_pc != pc + 4 || mispred)
+		{
+			self->num_branches++;
+			self->num_mispred_branches += mispred;
+		}
+
+		/* Stop after a misprediction */
+		if (mispred)
+			break;
+	}
+}
+
+
+/* Map running contexts to cores. A context keeps its core until it is freed,
+ * or until it stops running and a waiting context takes the core. The core
+ * is only taken once it has no data access in flight, so that a context never
+ * moves away from the core holding its accesses. */
+static void MIPSCpuMapContexts(MIPSCpu *self)
+{
+	struct mips_ctx_t *ctx;
+
+	int core;
+	int i;
+
+	for (ctx = mips_emu->running_list_head; ctx; ctx = ctx->running_list_next)
+	{
+		/* Context already mapped */
+		for (i = 0; i < mips_cpu_config.num_cores; i++)
+			if (self->core_ctx[i] == ctx)
+				break;
+		if (i < mips_cpu_config.num_cores)
+			continue;
+
+		/* Free core, or core of a context that stopped running */
+		core = -1;
+		for (i = 0; i < mips_cpu_config.num_cores && core < 0; i++)
+			if (!self->core_ctx[i])
+				core = i;
+		for (i = 0; i < mips_cpu_config.num_cores && core < 0; i++)
+			if (!mips_ctx_get_status(self->core_ctx[i], mips_ctx_running) &&
+					interval_core_is_empty(self->cores[i]))
+				core = i;
+
+		/* No core available for this or the next contexts */
+		if (core < 0)
+			break;
+		self->core_ctx[core] = ctx;
+	}
 }
 
 
 int MIPSCpuRun(Timing *self)
 {
-	return FALSE;
+	MIPSCpu *cpu = asMIPSCpu(self);
+	struct mips_ctx_t *ctx;
+
+	int i;
+
+	/* Stop if there is no context running */
+	if (mips_emu->finished_list_count >= mips_emu->context_list_count)
+		return FALSE;
+
+	/* Stop if maximum number of CPU instructions exceeded */
+	if (mips_emu_max_inst && cpu->num_committed_inst >= mips_emu_max_inst)
+		esim_finish = esim_finish_mips_max_inst;
+
+	/* Stop if maximum number of cycles exceeded */
+	if (mips_emu_max_cycles && self->cycle >= mips_emu_max_cycles)
+		esim_finish = esim_finish_mips_max_cycles;
+
+	/* Stop if any previous reason met */
+	if (esim_finish)
+		return TRUE;
+
+	/* One more cycle of MIPS timing simulation */
+	self->cycle++;
+
+	/* Map contexts to cores */
+	MIPSCpuMapContexts(cpu);
+
+	/* Cores */
+	for (i = 0; i < mips_cpu_config.num_cores; i++)
+		MIPSCpuRunCore(cpu, cpu->cores[i], cpu->core_ctx[i]);
+
+	/* Free finished contexts, releasing their cores */
+	while ((ctx = mips_emu->finished_list_head))
+	{
+		for (i = 0; i < mips_cpu_config.num_cores; i++)
+			if (cpu->core_ctx[i] == ctx)
+				cpu->core_ctx[i] = NULL;
+		mips_ctx_free(ctx);
+	}
+
+	/* Still simulating */
+	return TRUE;
+}
+
+
+void MIPSCpuMemConfigDefault(Timing *self, struct config_t *config)
+{
+	interval_mem_config_default(self->arch, config, mips_cpu_config.num_cores);
+}
+
+
+void MIPSCpuMemConfigCheck(Timing *self, struct config_t *config)
+{
+	interval_mem_config_check(self->arch, config, asMIPSCpu(self)->cores,
+		mips_cpu_config.num_cores);
+}
+
+
+void MIPSCpuMemConfigParseEntry(Timing *self, struct config_t *config,
+		char *section)
+{
+	interval_mem_config_parse_entry(self->arch, config, section,
+		asMIPSCpu(self)->cores, mips_cpu_config.num_cores);
 }
 
 
@@ -70,16 +344,30 @@ int MIPSCpuRun(Timing *self)
 
 MIPSCpu *mips_cpu;
 
+char *mips_cpu_config_file_name = "";
+char *mips_cpu_report_file_name = "";
+
+struct interval_config_t mips_cpu_config;
+
+
 void mips_cpu_read_config(void)
 {
+	interval_config_read(&mips_cpu_config, mips_cpu_config_file_name);
 }
 
 
 void mips_cpu_init(void)
 {
+	/* Classes */
+	CLASS_REGISTER(MIPSCpu);
+
+	/* Create CPU */
+	mips_cpu = new(MIPSCpu);
 }
 
 
 void mips_cpu_done(void)
 {
+	/* Free CPU */
+	delete(mips_cpu);
 }
@@ -131,6 +131,14 @@ void si_isa_bitmask_sreg(struct si_work_item_t *work_item, int sreg,
 	unsigned int value);
 int si_isa_read_bitmask_sreg(struct si_work_item_t *work_item, int sreg);
 
+/* Lane-parallel execution of vector ALU instructions for a whole wavefront,
+ * implemented in 'machine-simd.c' */
+struct si_wavefront_t;
+void si_isa_simd_init(void);
+void si_isa_simd_done(void);
+int si_isa_simd_execute(struct si_wavefront_t *wavefront,
+	struct si_inst_t *inst);
+
 struct si_buffer_desc_t;
 struct si_mem_ptr_t;
 void si_isa_read_buf_res(struct si_work_item_t *work_item, 
@@ -0,0 +1,1025 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <lib/mhandle/mhandle.h>
+#include <lib/util/debug.h>
+#include <lib/util/misc.h>
+
+#include "emu.h"
+#include "isa.h"
+#include "machine.h"
+#include "wavefront.h"
+#include "work-group.h"
+#include "work-item.h"
+
+
+/*
+ * Lane-parallel execution of vector ALU instructions.
+ *
+ * The functions in this file execute an instruction for all work-items of a
+ * wavefront at once, operating on the lane arrays in which the wavefront
+ * stores its vector registers. They produce the same results and register
+ * statistics as calling the per-work-item implementations in 'machine.c'
+ * for each active work-item, which are still used for all other
+ * instructions, and whenever ISA debug information is dumped.
+ */
+
+#define SI_ISA_SIMD_MAX_LANES  64
+
+struct si_isa_simd_t
+{
+	struct si_wavefront_t *wavefront;
+	struct si_work_group_t *work_group;
+
+	/* Lanes of the wavefront, and lanes active in the EXEC mask */
+	int num_lanes;
+	unsigned long long exec;
+	int active_count;
+	int full;
+
+	/* Lane arrays for operands that are not vector registers, and for
+	 * results when only some of the lanes are active. */
+	union si_reg_t src[3][SI_ISA_SIMD_MAX_LANES];
+	union si_reg_t dst[SI_ISA_SIMD_MAX_LANES];
+};
+
+/* Implementation of an instruction. Returns 0 before writing any register if
+ * the instruction must be executed per work-item instead. */
+typedef int (*si_isa_simd_func_t)(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst);
+
+static si_isa_simd_func_t *si_isa_simd_func;
+
+
+
+
+/*
+ * Host vector instructions
+ *
+ * Kernels process SI_ISA_SIMD_WIDTH lanes at a time with the widest vector
+ * instructions the simulator is built for, and the remaining lanes with a
+ * scalar loop. Each lane of the result depends only on the same lane of the
+ * operands, so results may be written over any of the operands.
+ */
+
+#if defined(__AVX2__)
+
+#define SI_ISA_SIMD_WIDTH  8
+
+#define SI_ISA_SIMD_LOADF(p)  _mm256_loadu_ps((float *) (p))
+#define SI_ISA_SIMD_STOREF(p, v)  _mm256_storeu_ps((float *) (p), (v))
+#define SI_ISA_SIMD_LOADI(p)  _mm256_loadu_si256((__m256i *) (p))
+#define SI_ISA_SIMD_STOREI(p, v)  _mm256_storeu_si256((__m256i *) (p), (v))
+#define SI_ISA_SIMD_SET1I(x)  _mm256_set1_epi32(x)
+#define SI_ISA_SIMD_LANE_BITS  _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128)
+
+#define SI_ISA_SIMD_ADDF(a, b)  _mm256_add_ps((a), (b))
+#define SI_ISA_SIMD_SUBF(a, b)  _mm256_sub_ps((a), (b))
+#define SI_ISA_SIMD_MULF(a, b)  _mm256_mul_ps((a), (b))
+#define SI_ISA_SIMD_ANDF(a, b)  _mm256_and_ps((a), (b))
+#define SI_ISA_SIMD_CMPUNORDF(a, b)  _mm256_cmp_ps((a), (b), _CMP_UNORD_Q)
+#define SI_ISA_SIMD_CMPLTF(a, b)  _mm256_cmp_ps((a), (b), _CMP_LT_OQ)
+#define SI_ISA_SIMD_CMPGTF(a, b)  _mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define SI_ISA_SIMD_CMPEQF(a, b)  _mm256_cmp_ps((a), (b), _CMP_EQ_OQ)
+#define SI_ISA_SIMD_MASKF(v)  _mm256_movemask_ps(v)
+#define SI_ISA_SIMD_MASKI(v)  _mm256_movemask_ps(_mm256_castsi256_ps(v))
+#define SI_ISA_SIMD_CVTIF(v)  _mm256_cvtepi32_ps(v)
+
+#define SI_ISA_SIMD_ADDI(a, b)  _mm256_add_epi32((a), (b))
+#define SI_ISA_SIMD_SUBI(a, b)  _mm256_sub_epi32((a), (b))
+#define SI_ISA_SIMD_ANDI(a, b)  _mm256_and_si256((a), (b))
+#define SI_ISA_SIMD_ANDNOTI(a, b)  _mm256_andnot_si256((a), (b))
+#define SI_ISA_SIMD_ORI(a, b)  _mm256_or_si256((a), (b))
+#define SI_ISA_SIMD_XORI(a, b)  _mm256_xor_si256((a), (b))
+#define SI_ISA_SIMD_CMPEQI(a, b)  _mm256_cmpeq_epi32((a), (b))
+#define SI_ISA_SIMD_CMPGTI(a, b)  _mm256_cmpgt_epi32((a), (b))
+#define SI_ISA_SIMD_SLLI(v, c)  _mm256_sll_epi32((v), _mm_cvtsi32_si128(c))
+#define SI_ISA_SIMD_SRLI(v, c)  _mm256_srl_epi32((v), _mm_cvtsi32_si128(c))
+#define SI_ISA_SIMD_SRAI(v, c)  _mm256_sra_epi32((v), _mm_cvtsi32_si128(c))
+#define SI_ISA_SIMD_SLLVI(v, c)  _mm256_sllv_epi32((v), (c))
+#define SI_ISA_SIMD_SRLVI(v, c)  _mm256_srlv_epi32((v), (c))
+#define SI_ISA_SIMD_SRAVI(v, c)  _mm256_srav_epi32((v), (c))
+#define SI_ISA_SIMD_MULLOI(a, b)  _mm256_mullo_epi32((a), (b))
+
+#elif defined(__SSE2__)
+
+#define SI_ISA_SIMD_WIDTH  4
+
+#define SI_ISA_SIMD_LOADF(p)  _mm_loadu_ps((float *) (p))
+#define SI_ISA_SIMD_STOREF(p, v)  _mm_storeu_ps((float *) (p), (v))
+#define SI_ISA_SIMD_LOADI(p)  _mm_loadu_si128((__m128i *) (p))
+#define SI_ISA_SIMD_STOREI(p, v)  _mm_storeu_si128((__m128i *) (p), (v))
+#define SI_ISA_SIMD_SET1I(x)  _mm_set1_epi32(x)
+#define SI_ISA_SIMD_LANE_BITS  _mm_setr_epi32(1, 2, 4, 8)
+
+#define SI_ISA_SIMD_ADDF(a, b)  _mm_add_ps((a), (b))
+#define SI_ISA_SIMD_SUBF(a, b)  _mm_sub_ps((a), (b))
+#define SI_ISA_SIMD_MULF(a, b)  _mm_mul_ps((a), (b))
+#define SI_ISA_SIMD_ANDF(a, b)  _mm_and_ps((a), (b))
+#define SI_ISA_SIMD_CMPUNORDF(a, b)  _mm_cmpunord_ps((a), (b))
+#define SI_ISA_SIMD_CMPLTF(a, b)  _mm_cmplt_ps((a), (b))
+#define SI_ISA_SIMD_CMPGTF(a, b)  _mm_cmpgt_ps((a), (b))
+#define SI_ISA_SIMD_CMPEQF(a, b)  _mm_cmpeq_ps((a), (b))
+#define SI_ISA_SIMD_MASKF(v)  _mm_movemask_ps(v)
+#define SI_ISA_SIMD_MASKI(v)  _mm_movemask_ps(_mm_castsi128_ps(v))
+#define SI_ISA_SIMD_CVTIF(v)  _mm_cvtepi32_ps(v)
+
+#define SI_ISA_SIMD_ADDI(a, b)  _mm_add_epi32((a), (b))
+#define SI_ISA_SIMD_SUBI(a, b)  _mm_sub_epi32((a), (b))
+#define SI_ISA_SIMD_ANDI(a, b)  _mm_and_si128((a), (b))
+#define SI_ISA_SIMD_ANDNOTI(a, b)  _mm_andnot_si128((a), (b))
+#define SI_ISA_SIMD_ORI(a, b)  _mm_or_si128((a), (b))
+#define SI_ISA_SIMD_XORI(a, b)  _mm_xor_si128((a), (b))
+#define SI_ISA_SIMD_CMPEQI(a, b)  _mm_cmpeq_epi32((a), (b))
+#define SI_ISA_SIMD_CMPGTI(a, b)  _mm_cmpgt_epi32((a), (b))
+#define SI_ISA_SIMD_SLLI(v, c)  _mm_sll_epi32((v), _mm_cvtsi32_si128(c))
+#define SI_ISA_SIMD_SRLI(v, c)  _mm_srl_epi32((v), _mm_cvtsi32_si128(c))
+#define SI_ISA_SIMD_SRAI(v, c)  _mm_sra_epi32((v), _mm_cvtsi32_si128(c))
+#ifdef __SSE4_1__
+#define SI_ISA_SIMD_MULLOI(a, b)  _mm_mullo_epi32((a), (b))
+#endif
+
+#endif
+
+/* Loop running 'body' on consecutive groups of SI_ISA_SIMD_WIDTH lanes,
+ * advancing 'i' while at least a whole group remains below 'n'. Variants
+ * exist for the operations not supported by all instruction sets. */
+#ifdef SI_ISA_SIMD_WIDTH
+#define SI_ISA_SIMD_LOOP(i, n, body) \
+	for (; (i) + SI_ISA_SIMD_WIDTH <= (n); (i) += SI_ISA_SIMD_WIDTH) \
+	{ \
+		body; \
+	}
+#else
+#define SI_ISA_SIMD_LOOP(i, n, body)
+#endif
+
+#ifdef SI_ISA_SIMD_SLLVI
+#define SI_ISA_SIMD_LOOP_SHIFTV(i, n, body)  SI_ISA_SIMD_LOOP(i, n, body)
+#else
+#define SI_ISA_SIMD_LOOP_SHIFTV(i, n, body)
+#endif
+
+#ifdef SI_ISA_SIMD_MULLOI
+#define SI_ISA_SIMD_LOOP_MULLO(i, n, body)  SI_ISA_SIMD_LOOP(i, n, body)
+#else
+#define SI_ISA_SIMD_LOOP_MULLO(i, n, body)
+#endif
+
+/* Unless fused multiply-add instructions may be emitted for the scalar
+ * 'a * b + c' of the per-work-item implementation, the multiplication and
+ * the addition are rounded separately. */
+#ifndef __FMA__
+#define SI_ISA_SIMD_LOOP_MAD(i, n, body)  SI_ISA_SIMD_LOOP(i, n, body)
+#else
+#define SI_ISA_SIMD_LOOP_MAD(i, n, body)
+#endif
+
+
+/* Kernel 'd = a op b' on 'n' lanes */
+#define SI_ISA_SIMD_KERNEL2(_name, _loop, _vec_expr, _expr) \
+	static void si_isa_simd_##_name(union si_reg_t *d, union si_reg_t *a, \
+		union si_reg_t *b, int n) \
+	{ \
+		int i = 0; \
+		_loop(i, n, _vec_expr) \
+		for (; i < n; i++) \
+			_expr; \
+	}
+
+/* Kernel returning a bit mask with the lanes of 'a' and 'b' for which a
+ * comparison is true */
+#define SI_ISA_SIMD_KERNEL_CMP(_name, _vec_expr, _expr) \
+	static unsigned long long si_isa_simd_##_name(union si_reg_t *a, \
+		union si_reg_t *b, int n) \
+	{ \
+		unsigned long long bits = 0; \
+		int i = 0; \
+		SI_ISA_SIMD_LOOP(i, n, bits |= (unsigned long long) \
+			(_vec_expr) << i) \
+		for (; i < n; i++) \
+			bits |= (unsigned long long) (_expr) << i; \
+		return bits; \
+	}
+
+/* Kernel 'd = a shift count', with a count common to all lanes (kernel
+ * '<name>') or given per lane in 'c' (kernel '<name>v'). */
+#define SI_ISA_SIMD_KERNEL_SHIFT(_name, _vec_op, _vecv_op, _field, _op) \
+	static void si_isa_simd_##_name(union si_reg_t *d, union si_reg_t *a, \
+		unsigned int count, int n) \
+	{ \
+		int i = 0; \
+		SI_ISA_SIMD_LOOP(i, n, SI_ISA_SIMD_STOREI(d + i, \
+			_vec_op(SI_ISA_SIMD_LOADI(a + i), count))) \
+		for (; i < n; i++) \
+			d[i]._field = a[i]._field _op count; \
+	} \
+	static void si_isa_simd_##_name##v(union si_reg_t *d, union si_reg_t *a, \
+		union si_reg_t *c, int n) \
+	{ \
+		int i = 0; \
+		SI_ISA_SIMD_LOOP_SHIFTV(i, n, SI_ISA_SIMD_STOREI(d + i, \
+			_vecv_op(SI_ISA_SIMD_LOADI(a + i), SI_ISA_SIMD_ANDI( \
+			SI_ISA_SIMD_LOADI(c + i), SI_ISA_SIMD_SET1I(0x1f))))) \
+		for (; i < n; i++) \
+			d[i]._field = a[i]._field _op (c[i].as_uint & 0x1f); \
+	}
+
+SI_ISA_SIMD_KERNEL2(add_f32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREF(d + i, SI_ISA_SIMD_ADDF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i))),
+	d[i].as_float = a[i].as_float + b[i].as_float)
+SI_ISA_SIMD_KERNEL2(sub_f32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREF(d + i, SI_ISA_SIMD_SUBF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i))),
+	d[i].as_float = a[i].as_float - b[i].as_float)
+SI_ISA_SIMD_KERNEL2(mul_f32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREF(d + i, SI_ISA_SIMD_MULF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i))),
+	d[i].as_float = a[i].as_float * b[i].as_float)
+
+SI_ISA_SIMD_KERNEL2(add_i32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_ADDI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	d[i].as_uint = a[i].as_uint + b[i].as_uint)
+SI_ISA_SIMD_KERNEL2(sub_i32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_SUBI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	d[i].as_uint = a[i].as_uint - b[i].as_uint)
+SI_ISA_SIMD_KERNEL2(and_b32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_ANDI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	d[i].as_uint = a[i].as_uint & b[i].as_uint)
+SI_ISA_SIMD_KERNEL2(or_b32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_ORI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	d[i].as_uint = a[i].as_uint | b[i].as_uint)
+SI_ISA_SIMD_KERNEL2(xor_b32, SI_ISA_SIMD_LOOP,
+	SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_XORI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	d[i].as_uint = a[i].as_uint ^ b[i].as_uint)
+SI_ISA_SIMD_KERNEL2(mul_lo_i32, SI_ISA_SIMD_LOOP_MULLO,
+	SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_MULLOI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	d[i].as_uint = a[i].as_uint * b[i].as_uint)
+SI_ISA_SIMD_KERNEL2(mul_i32_i24, SI_ISA_SIMD_LOOP_MULLO,
+	SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_MULLOI(
+		SI_ISA_SIMD_SRAI(SI_ISA_SIMD_SLLI(SI_ISA_SIMD_LOADI(a + i), 8), 8),
+		SI_ISA_SIMD_SRAI(SI_ISA_SIMD_SLLI(SI_ISA_SIMD_LOADI(b + i), 8), 8))),
+	d[i].as_int = (int) SEXT32(a[i].as_uint, 24) *
+		(int) SEXT32(b[i].as_uint, 24))
+
+SI_ISA_SIMD_KERNEL_CMP(cmp_lt_f32,
+	SI_ISA_SIMD_MASKF(SI_ISA_SIMD_CMPLTF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i))),
+	a[i].as_float < b[i].as_float)
+SI_ISA_SIMD_KERNEL_CMP(cmp_gt_f32,
+	SI_ISA_SIMD_MASKF(SI_ISA_SIMD_CMPGTF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i))),
+	a[i].as_float > b[i].as_float)
+SI_ISA_SIMD_KERNEL_CMP(cmp_eq_f32,
+	SI_ISA_SIMD_MASKF(SI_ISA_SIMD_CMPEQF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i))),
+	a[i].as_float == b[i].as_float)
+SI_ISA_SIMD_KERNEL_CMP(cmp_lt_i32,
+	SI_ISA_SIMD_MASKI(SI_ISA_SIMD_CMPGTI(SI_ISA_SIMD_LOADI(b + i),
+		SI_ISA_SIMD_LOADI(a + i))),
+	a[i].as_int < b[i].as_int)
+SI_ISA_SIMD_KERNEL_CMP(cmp_gt_i32,
+	SI_ISA_SIMD_MASKI(SI_ISA_SIMD_CMPGTI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	a[i].as_int > b[i].as_int)
+SI_ISA_SIMD_KERNEL_CMP(cmp_eq_i32,
+	SI_ISA_SIMD_MASKI(SI_ISA_SIMD_CMPEQI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_LOADI(b + i))),
+	a[i].as_uint == b[i].as_uint)
+
+/* Unsigned comparisons flip the sign bit of both operands to use signed
+ * comparison instructions. */
+SI_ISA_SIMD_KERNEL_CMP(cmp_lt_u32,
+	SI_ISA_SIMD_MASKI(SI_ISA_SIMD_CMPGTI(
+		SI_ISA_SIMD_XORI(SI_ISA_SIMD_LOADI(b + i), SI_ISA_SIMD_SET1I(INT_MIN)),
+		SI_ISA_SIMD_XORI(SI_ISA_SIMD_LOADI(a + i), SI_ISA_SIMD_SET1I(INT_MIN)))),
+	a[i].as_uint < b[i].as_uint)
+SI_ISA_SIMD_KERNEL_CMP(cmp_gt_u32,
+	SI_ISA_SIMD_MASKI(SI_ISA_SIMD_CMPGTI(
+		SI_ISA_SIMD_XORI(SI_ISA_SIMD_LOADI(a + i), SI_ISA_SIMD_SET1I(INT_MIN)),
+		SI_ISA_SIMD_XORI(SI_ISA_SIMD_LOADI(b + i), SI_ISA_SIMD_SET1I(INT_MIN)))),
+	a[i].as_uint > b[i].as_uint)
+
+/* Lanes where both operands are NaN. The NaN returned by an arithmetic
+ * instruction is then the one of its first operand, and compilers are free
+ * to swap the operands of commutative operations, so the result depends on
+ * the code generated for the per-work-item implementation. Instructions
+ * with such lanes are executed per work-item. */
+SI_ISA_SIMD_KERNEL_CMP(nan2_f32,
+	SI_ISA_SIMD_MASKF(SI_ISA_SIMD_ANDF(
+		SI_ISA_SIMD_CMPUNORDF(SI_ISA_SIMD_LOADF(a + i), SI_ISA_SIMD_LOADF(a + i)),
+		SI_ISA_SIMD_CMPUNORDF(SI_ISA_SIMD_LOADF(b + i), SI_ISA_SIMD_LOADF(b + i)))),
+	a[i].as_float != a[i].as_float && b[i].as_float != b[i].as_float)
+
+SI_ISA_SIMD_KERNEL_SHIFT(lshl_b32, SI_ISA_SIMD_SLLI, SI_ISA_SIMD_SLLVI,
+	as_uint, <<)
+SI_ISA_SIMD_KERNEL_SHIFT(lshr_b32, SI_ISA_SIMD_SRLI, SI_ISA_SIMD_SRLVI,
+	as_uint, >>)
+SI_ISA_SIMD_KERNEL_SHIFT(ashr_i32, SI_ISA_SIMD_SRAI, SI_ISA_SIMD_SRAVI,
+	as_int, >>)
+
+/* Lanes where 'a * b + c' has two NaN operands in any of its operations */
+static unsigned long long si_isa_simd_nan3_f32(union si_reg_t *a,
+	union si_reg_t *b, union si_reg_t *c, int n)
+{
+	unsigned long long bits = 0;
+	float product;
+	int i = 0;
+
+	SI_ISA_SIMD_LOOP(i, n, bits |= (unsigned long long) SI_ISA_SIMD_MASKF(
+		SI_ISA_SIMD_ANDF(SI_ISA_SIMD_CMPUNORDF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i)), SI_ISA_SIMD_CMPUNORDF(SI_ISA_SIMD_MULF(
+		SI_ISA_SIMD_LOADF(a + i), SI_ISA_SIMD_LOADF(b + i)),
+		SI_ISA_SIMD_LOADF(c + i)))) << i)
+	for (; i < n; i++)
+	{
+		product = a[i].as_float * b[i].as_float;
+		bits |= (unsigned long long) ((a[i].as_float != a[i].as_float &&
+			b[i].as_float != b[i].as_float) || (product != product &&
+			c[i].as_float != c[i].as_float)) << i;
+	}
+	return bits;
+}
+
+/* d = a * b + c */
+static void si_isa_simd_mad_f32(union si_reg_t *d, union si_reg_t *a,
+	union si_reg_t *b, union si_reg_t *c, int n)
+{
+	int i = 0;
+
+	SI_ISA_SIMD_LOOP_MAD(i, n, SI_ISA_SIMD_STOREF(d + i, SI_ISA_SIMD_ADDF(
+		SI_ISA_SIMD_MULF(SI_ISA_SIMD_LOADF(a + i),
+		SI_ISA_SIMD_LOADF(b + i)), SI_ISA_SIMD_LOADF(c + i))))
+	for (; i < n; i++)
+		d[i].as_float = a[i].as_float * b[i].as_float + c[i].as_float;
+}
+
+/* d = (float) a */
+static void si_isa_simd_cvt_f32_i32(union si_reg_t *d, union si_reg_t *a,
+	int n)
+{
+	int i = 0;
+
+	SI_ISA_SIMD_LOOP(i, n, SI_ISA_SIMD_STOREF(d + i,
+		SI_ISA_SIMD_CVTIF(SI_ISA_SIMD_LOADI(a + i))))
+	for (; i < n; i++)
+		d[i].as_float = (float) a[i].as_int;
+}
+
+/* d = (a & and_mask) ^ xor_mask, used for the absolute value and negation
+ * modifiers of floating-point operands. */
+static void si_isa_simd_and_xor(union si_reg_t *d, union si_reg_t *a,
+	unsigned int and_mask, unsigned int xor_mask, int n)
+{
+	int i = 0;
+
+	SI_ISA_SIMD_LOOP(i, n, SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_XORI(
+		SI_ISA_SIMD_ANDI(SI_ISA_SIMD_LOADI(a + i),
+		SI_ISA_SIMD_SET1I(and_mask)), SI_ISA_SIMD_SET1I(xor_mask))))
+	for (; i < n; i++)
+		d[i].as_uint = (a[i].as_uint & and_mask) ^ xor_mask;
+}
+
+/* d = bit 'i' of 'mask' ? b : a */
+static void si_isa_simd_select(union si_reg_t *d, union si_reg_t *a,
+	union si_reg_t *b, unsigned long long mask, int n)
+{
+	int i = 0;
+
+	SI_ISA_SIMD_LOOP(i, n, SI_ISA_SIMD_STOREI(d + i, SI_ISA_SIMD_ORI(
+		SI_ISA_SIMD_ANDI(SI_ISA_SIMD_CMPEQI(SI_ISA_SIMD_ANDI(
+		SI_ISA_SIMD_SET1I((int) (mask >> i)), SI_ISA_SIMD_LANE_BITS),
+		SI_ISA_SIMD_LANE_BITS), SI_ISA_SIMD_LOADI(b + i)),
+		SI_ISA_SIMD_ANDNOTI(SI_ISA_SIMD_CMPEQI(SI_ISA_SIMD_ANDI(
+		SI_ISA_SIMD_SET1I((int) (mask >> i)), SI_ISA_SIMD_LANE_BITS),
+		SI_ISA_SIMD_LANE_BITS), SI_ISA_SIMD_LOADI(a + i)))))
+	for (; i < n; i++)
+		d[i].as_uint = (mask >> i) & 1 ? b[i].as_uint : a[i].as_uint;
+}
+
+
+
+
+/*
+ * Operands
+ */
+
+/* Return the lane array of source operand 'src', given in the 9-bit
+ * encoding of vector ALU instructions. Vector registers are returned in
+ * place. Scalar registers, inline constants, and the literal constant
+ * (operand 0xff, if 'has_lit_cnst' is set) are broadcast to all lanes of
+ * operand buffer 'index'. Register read statistics are updated as if each
+ * active work-item had read the operand. */
+static union si_reg_t *si_isa_simd_read_src(struct si_isa_simd_t *simd,
+	int src, int has_lit_cnst, unsigned int lit_cnst, int index)
+{
+	union si_reg_t *buf;
+	unsigned int value;
+	int i;
+
+	/* Vector register */
+	if (src >= 256)
+	{
+		simd->work_group->vreg_read_count += simd->active_count;
+		return SI_WAVEFRONT_VREG(simd->wavefront, src - 256);
+	}
+
+	/* Literal constant or scalar register */
+	if (src == 0xff && has_lit_cnst)
+	{
+		value = lit_cnst;
+	}
+	else
+	{
+		value = si_isa_read_sreg(simd->wavefront->scalar_work_item, src);
+		simd->work_group->sreg_read_count += simd->active_count - 1;
+	}
+
+	/* Broadcast */
+	buf = simd->src[index];
+	for (i = 0; i < simd->num_lanes; i++)
+		buf[i].as_uint = value;
+	return buf;
+}
+
+/* Apply the absolute value and negation modifiers of floating-point operand
+ * 'index' of a VOP3 instruction to lane array 's'. */
+static union si_reg_t *si_isa_simd_modify_src(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst, union si_reg_t *s, int index)
+{
+	unsigned int and_mask;
+	unsigned int xor_mask;
+
+	and_mask = (inst->micro_inst.vop3a.abs >> index) & 1 ? 0x7fffffff : ~0U;
+	xor_mask = (inst->micro_inst.vop3a.neg >> index) & 1 ? 0x80000000 : 0;
+	if (and_mask == ~0U && !xor_mask)
+		return s;
+
+	si_isa_simd_and_xor(simd->src[index], s, and_mask, xor_mask,
+		simd->num_lanes);
+	return simd->src[index];
+}
+
+/* Return the mask stored in scalar registers 'sreg' and 'sreg + 1', with
+ * one bit per lane, such as VCC. */
+static unsigned long long si_isa_simd_read_mask(struct si_isa_simd_t *simd,
+	int sreg)
+{
+	union si_reg_t *sregs = simd->wavefront->sreg;
+
+	simd->work_group->sreg_read_count += simd->active_count;
+	return sregs[sreg].as_uint | (unsigned long long) sregs[sreg + 1].as_uint << 32;
+}
+
+/* Return the lane array where the result of an instruction writing vector
+ * register 'vdst' is computed. */
+static union si_reg_t *si_isa_simd_dst(struct si_isa_simd_t *simd, int vdst)
+{
+	return simd->full ? SI_WAVEFRONT_VREG(simd->wavefront, vdst) : simd->dst;
+}
+
+/* Complete the write of vector register 'vdst', copying the active lanes of
+ * the result if it was not computed in place. */
+static void si_isa_simd_write_dst(struct si_isa_simd_t *simd, int vdst)
+{
+	union si_reg_t *reg;
+	int i;
+
+	if (!simd->full)
+	{
+		reg = SI_WAVEFRONT_VREG(simd->wavefront, vdst);
+		for (i = 0; i < simd->num_lanes; i++)
+			if ((simd->exec >> i) & 1)
+				reg[i] = simd->dst[i];
+	}
+	simd->work_group->vreg_write_count += simd->active_count;
+}
+
+/* Write the bits of 'bits' for active lanes into VCC */
+static void si_isa_simd_write_vcc(struct si_isa_simd_t *simd,
+	unsigned long long bits)
+{
+	union si_reg_t *sreg = simd->wavefront->sreg;
+	unsigned long long vcc;
+
+	vcc = sreg[SI_VCC].as_uint | (unsigned long long) sreg[SI_VCC + 1].as_uint << 32;
+	vcc = (vcc & ~simd->exec) | (bits & simd->exec);
+	sreg[SI_VCC].as_uint = vcc;
+	sreg[SI_VCC + 1].as_uint = vcc >> 32;
+	sreg[SI_VCCZ].as_uint = !sreg[SI_VCC].as_uint & !sreg[SI_VCC + 1].as_uint;
+
+	/* Each work-item reads and writes back one half of VCC */
+	simd->work_group->sreg_read_count += simd->active_count;
+	simd->work_group->sreg_write_count += simd->active_count;
+}
+
+/* Instructions writing VCC one work-item at a time expose partial results
+ * to work-items reading it as an operand. */
+static int si_isa_simd_reads_vcc(int src)
+{
+	return src == SI_VCC || src == SI_VCC + 1 || src == SI_VCCZ;
+}
+
+
+
+
+/*
+ * VOP1
+ */
+
+#define INST SI_INST_VOP1
+static int si_isa_V_MOV_B32_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0);
+	memmove(si_isa_simd_dst(simd, INST.vdst), s0,
+		simd->num_lanes * sizeof(union si_reg_t));
+	si_isa_simd_write_dst(simd, INST.vdst);
+	return 1;
+}
+
+static int si_isa_V_CVT_F32_I32_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0);
+	si_isa_simd_cvt_f32_i32(si_isa_simd_dst(simd, INST.vdst), s0,
+		simd->num_lanes);
+	si_isa_simd_write_dst(simd, INST.vdst);
+	return 1;
+}
+#undef INST
+
+
+
+
+/*
+ * VOP2
+ */
+
+#define INST SI_INST_VOP2
+
+/* Instruction computing 'D = kernel(S0, S1)' */
+#define SI_ISA_SIMD_VOP2(_name, _kernel) \
+	static int si_isa_##_name##_simd_impl(struct si_isa_simd_t *simd, \
+		struct si_inst_t *inst) \
+	{ \
+		union si_reg_t *s0; \
+		union si_reg_t *s1; \
+	\
+		s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0); \
+		s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1); \
+		si_isa_simd_##_kernel(si_isa_simd_dst(simd, INST.vdst), s0, s1, \
+			simd->num_lanes); \
+		si_isa_simd_write_dst(simd, INST.vdst); \
+		return 1; \
+	}
+
+/* Instruction computing 'D = kernel(S1, S0)' */
+#define SI_ISA_SIMD_VOP2_REV(_name, _kernel) \
+	static int si_isa_##_name##_simd_impl(struct si_isa_simd_t *simd, \
+		struct si_inst_t *inst) \
+	{ \
+		union si_reg_t *s0; \
+		union si_reg_t *s1; \
+	\
+		s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0); \
+		s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1); \
+		if (si_isa_simd_nan2_f32(s0, s1, simd->num_lanes) & simd->exec) \
+			return 0; \
+		si_isa_simd_##_kernel(si_isa_simd_dst(simd, INST.vdst), s1, s0, \
+			simd->num_lanes); \
+		si_isa_simd_write_dst(simd, INST.vdst); \
+		return 1; \
+	}
+
+/* Instruction computing 'D = S1 shift S0[4:0]' */
+#define SI_ISA_SIMD_VOP2_SHIFT(_name, _kernel) \
+	static int si_isa_##_name##_simd_impl(struct si_isa_simd_t *simd, \
+		struct si_inst_t *inst) \
+	{ \
+		union si_reg_t *s0; \
+		union si_reg_t *s1; \
+		union si_reg_t *d; \
+	\
+		s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0); \
+		s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1); \
+		d = si_isa_simd_dst(simd, INST.vdst); \
+		if (INST.src0 < 256) \
+			si_isa_simd_##_kernel(d, s1, s0[0].as_uint & 0x1f, \
+				simd->num_lanes); \
+		else \
+			si_isa_simd_##_kernel##v(d, s1, s0, simd->num_lanes); \
+		si_isa_simd_write_dst(simd, INST.vdst); \
+		return 1; \
+	}
+
+/* Floating-point instruction computing 'D = kernel(S0, S1)' */
+#define SI_ISA_SIMD_VOP2_F32(_name, _kernel) \
+	static int si_isa_##_name##_simd_impl(struct si_isa_simd_t *simd, \
+		struct si_inst_t *inst) \
+	{ \
+		union si_reg_t *s0; \
+		union si_reg_t *s1; \
+	\
+		s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0); \
+		s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1); \
+		if (si_isa_simd_nan2_f32(s0, s1, simd->num_lanes) & simd->exec) \
+			return 0; \
+		si_isa_simd_##_kernel(si_isa_simd_dst(simd, INST.vdst), s0, s1, \
+			simd->num_lanes); \
+		si_isa_simd_write_dst(simd, INST.vdst); \
+		return 1; \
+	}
+
+SI_ISA_SIMD_VOP2_F32(V_ADD_F32, add_f32)
+SI_ISA_SIMD_VOP2_F32(V_SUB_F32, sub_f32)
+SI_ISA_SIMD_VOP2_REV(V_SUBREV_F32, sub_f32)
+SI_ISA_SIMD_VOP2_F32(V_MUL_F32, mul_f32)
+SI_ISA_SIMD_VOP2(V_MUL_I32_I24, mul_i32_i24)
+SI_ISA_SIMD_VOP2(V_AND_B32, and_b32)
+SI_ISA_SIMD_VOP2(V_OR_B32, or_b32)
+SI_ISA_SIMD_VOP2(V_XOR_B32, xor_b32)
+SI_ISA_SIMD_VOP2_SHIFT(V_LSHRREV_B32, lshr_b32)
+SI_ISA_SIMD_VOP2_SHIFT(V_ASHRREV_I32, ashr_i32)
+SI_ISA_SIMD_VOP2_SHIFT(V_LSHLREV_B32, lshl_b32)
+
+static int si_isa_V_CNDMASK_B32_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+	union si_reg_t *s1;
+	unsigned long long vcc;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0);
+	s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1);
+	vcc = si_isa_simd_read_mask(simd, SI_VCC);
+	si_isa_simd_select(si_isa_simd_dst(simd, INST.vdst), s0, s1, vcc,
+		simd->num_lanes);
+	si_isa_simd_write_dst(simd, INST.vdst);
+	return 1;
+}
+
+/* The carry of V_ADD_I32 is set when the 64-bit sum of the signed operands
+ * is negative, as in the per-work-item implementation. */
+static int si_isa_V_ADD_I32_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+	union si_reg_t *s1;
+	unsigned long long carry = 0;
+	int i;
+
+	if (si_isa_simd_reads_vcc(INST.src0))
+		return 0;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0);
+	s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1);
+	for (i = 0; i < simd->num_lanes; i++)
+		carry |= (unsigned long long) !!(((long long) s0[i].as_int +
+			(long long) s1[i].as_int) >> 32) << i;
+	si_isa_simd_add_i32(si_isa_simd_dst(simd, INST.vdst), s0, s1,
+		simd->num_lanes);
+	si_isa_simd_write_dst(simd, INST.vdst);
+	si_isa_simd_write_vcc(simd, carry);
+	return 1;
+}
+
+static int si_isa_V_SUB_I32_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+	union si_reg_t *s1;
+	unsigned long long carry;
+
+	if (si_isa_simd_reads_vcc(INST.src0))
+		return 0;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0);
+	s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1);
+	carry = si_isa_simd_cmp_gt_i32(s1, s0, simd->num_lanes);
+	si_isa_simd_sub_i32(si_isa_simd_dst(simd, INST.vdst), s0, s1,
+		simd->num_lanes);
+	si_isa_simd_write_dst(simd, INST.vdst);
+	si_isa_simd_write_vcc(simd, carry);
+	return 1;
+}
+
+static int si_isa_V_SUBREV_I32_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+	union si_reg_t *s1;
+	unsigned long long carry;
+
+	if (si_isa_simd_reads_vcc(INST.src0))
+		return 0;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0);
+	s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1);
+	carry = si_isa_simd_cmp_gt_i32(s0, s1, simd->num_lanes);
+	si_isa_simd_sub_i32(si_isa_simd_dst(simd, INST.vdst), s1, s0,
+		simd->num_lanes);
+	si_isa_simd_write_dst(simd, INST.vdst);
+	si_isa_simd_write_vcc(simd, carry);
+	return 1;
+}
+#undef INST
+
+
+
+
+/*
+ * VOPC
+ */
+
+#define INST SI_INST_VOPC
+
+/* Comparison 'VCC = kernel(S0, S1)', negated if '_neg' is set */
+#define SI_ISA_SIMD_VOPC(_name, _kernel, _neg) \
+	static int si_isa_##_name##_simd_impl(struct si_isa_simd_t *simd, \
+		struct si_inst_t *inst) \
+	{ \
+		union si_reg_t *s0; \
+		union si_reg_t *s1; \
+		unsigned long long bits; \
+	\
+		if (si_isa_simd_reads_vcc(INST.src0)) \
+			return 0; \
+	\
+		s0 = si_isa_simd_read_src(simd, INST.src0, 1, INST.lit_cnst, 0); \
+		s1 = si_isa_simd_read_src(simd, INST.vsrc1 + 256, 0, 0, 1); \
+		bits = si_isa_simd_##_kernel(s0, s1, simd->num_lanes); \
+		si_isa_simd_write_vcc(simd, (_neg) ? ~bits : bits); \
+		return 1; \
+	}
+
+SI_ISA_SIMD_VOPC(V_CMP_LT_F32, cmp_lt_f32, 0)
+SI_ISA_SIMD_VOPC(V_CMP_GT_F32, cmp_gt_f32, 0)
+SI_ISA_SIMD_VOPC(V_CMP_NGT_F32, cmp_gt_f32, 1)
+SI_ISA_SIMD_VOPC(V_CMP_NEQ_F32, cmp_eq_f32, 1)
+SI_ISA_SIMD_VOPC(V_CMP_LT_I32, cmp_lt_i32, 0)
+SI_ISA_SIMD_VOPC(V_CMP_EQ_I32, cmp_eq_i32, 0)
+SI_ISA_SIMD_VOPC(V_CMP_LE_I32, cmp_gt_i32, 1)
+SI_ISA_SIMD_VOPC(V_CMP_GT_I32, cmp_gt_i32, 0)
+SI_ISA_SIMD_VOPC(V_CMP_NE_I32, cmp_eq_i32, 1)
+SI_ISA_SIMD_VOPC(V_CMP_GE_I32, cmp_lt_i32, 1)
+SI_ISA_SIMD_VOPC(V_CMP_LT_U32, cmp_lt_u32, 0)
+SI_ISA_SIMD_VOPC(V_CMP_LE_U32, cmp_gt_u32, 1)
+SI_ISA_SIMD_VOPC(V_CMP_GT_U32, cmp_gt_u32, 0)
+#undef INST
+
+
+
+
+/*
+ * VOP3a
+ */
+
+#define INST SI_INST_VOP3a
+
+/* Floating-point instruction 'D = kernel(S0, S1)' with input modifiers */
+#define SI_ISA_SIMD_VOP3A_F32(_name, _kernel) \
+	static int si_isa_##_name##_simd_impl(struct si_isa_simd_t *simd, \
+		struct si_inst_t *inst) \
+	{ \
+		union si_reg_t *s0; \
+		union si_reg_t *s1; \
+	\
+		if (INST.clamp || INST.omod) \
+			return 0; \
+	\
+		s0 = si_isa_simd_read_src(simd, INST.src0, 0, 0, 0); \
+		s1 = si_isa_simd_read_src(simd, INST.src1, 0, 0, 1); \
+		s0 = si_isa_simd_modify_src(simd, inst, s0, 0); \
+		s1 = si_isa_simd_modify_src(simd, inst, s1, 1); \
+		if (si_isa_simd_nan2_f32(s0, s1, simd->num_lanes) & simd->exec) \
+			return 0; \
+		si_isa_simd_##_kernel(si_isa_simd_dst(simd, INST.vdst), s0, s1, \
+			simd->num_lanes); \
+		si_isa_simd_write_dst(simd, INST.vdst); \
+		return 1; \
+	}
+
+/* Integer instruction 'D = kernel(S0, S1)', without modifiers */
+#define SI_ISA_SIMD_VOP3A_I32(_name, _kernel) \
+	static int si_isa_##_name##_simd_impl(struct si_isa_simd_t *simd, \
+		struct si_inst_t *inst) \
+	{ \
+		union si_reg_t *s0; \
+		union si_reg_t *s1; \
+	\
+		if (INST.clamp || INST.omod || INST.neg || INST.abs) \
+			return 0; \
+	\
+		s0 = si_isa_simd_read_src(simd, INST.src0, 0, 0, 0); \
+		s1 = si_isa_simd_read_src(simd, INST.src1, 0, 0, 1); \
+		si_isa_simd_##_kernel(si_isa_simd_dst(simd, INST.vdst), s0, s1, \
+			simd->num_lanes); \
+		si_isa_simd_write_dst(simd, INST.vdst); \
+		return 1; \
+	}
+
+SI_ISA_SIMD_VOP3A_F32(V_ADD_F32_VOP3a, add_f32)
+SI_ISA_SIMD_VOP3A_F32(V_MUL_F32_VOP3a, mul_f32)
+SI_ISA_SIMD_VOP3A_I32(V_MUL_LO_U32, mul_lo_i32)
+SI_ISA_SIMD_VOP3A_I32(V_MUL_LO_I32, mul_lo_i32)
+
+static int si_isa_V_MAD_F32_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+	union si_reg_t *s1;
+	union si_reg_t *s2;
+
+	if (INST.clamp || INST.omod)
+		return 0;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 0, 0, 0);
+	s1 = si_isa_simd_read_src(simd, INST.src1, 0, 0, 1);
+	s2 = si_isa_simd_read_src(simd, INST.src2, 0, 0, 2);
+	s0 = si_isa_simd_modify_src(simd, inst, s0, 0);
+	s1 = si_isa_simd_modify_src(simd, inst, s1, 1);
+	s2 = si_isa_simd_modify_src(simd, inst, s2, 2);
+	if (si_isa_simd_nan3_f32(s0, s1, s2, simd->num_lanes) & simd->exec)
+		return 0;
+	si_isa_simd_mad_f32(si_isa_simd_dst(simd, INST.vdst), s0, s1, s2,
+		simd->num_lanes);
+	si_isa_simd_write_dst(simd, INST.vdst);
+	return 1;
+}
+
+/* The lane mask is read from the scalar register pair given in S2, and only
+ * the negation modifiers apply. */
+static int si_isa_V_CNDMASK_B32_VOP3a_simd_impl(struct si_isa_simd_t *simd,
+	struct si_inst_t *inst)
+{
+	union si_reg_t *s0;
+	union si_reg_t *s1;
+	unsigned long long mask;
+
+	if (INST.clamp || INST.omod || INST.abs || (INST.neg & 4) ||
+		INST.src2 + 1 >= SI_VCCZ)
+		return 0;
+
+	s0 = si_isa_simd_read_src(simd, INST.src0, 0, 0, 0);
+	s1 = si_isa_simd_read_src(simd, INST.src1, 0, 0, 1);
+	mask = si_isa_simd_read_mask(simd, INST.src2);
+	s0 = si_isa_simd_modify_src(simd, inst, s0, 0);
+	s1 = si_isa_simd_modify_src(simd, inst, s1, 1);
+	si_isa_simd_select(si_isa_simd_dst(simd, INST.vdst), s0, s1, mask,
+		simd->num_lanes);
+	si_isa_simd_write_dst(simd, INST.vdst);
+	return 1;
+}
+#undef INST
+
+
+
+
+/*
+ * Public Functions
+ */
+
+void si_isa_simd_init(void)
+{
+	si_isa_simd_func = xcalloc(SI_INST_COUNT, sizeof(si_isa_simd_func_t));
+#define SI_ISA_SIMD_REGISTER(_name) \
+	si_isa_simd_func[SI_INST_##_name] = si_isa_##_name##_simd_impl
+
+	/* VOP1 */
+	SI_ISA_SIMD_REGISTER(V_MOV_B32);
+	SI_ISA_SIMD_REGISTER(V_CVT_F32_I32);
+
+	/* VOP2 */
+	SI_ISA_SIMD_REGISTER(V_CNDMASK_B32);
+	SI_ISA_SIMD_REGISTER(V_ADD_F32);
+	SI_ISA_SIMD_REGISTER(V_SUB_F32);
+	SI_ISA_SIMD_REGISTER(V_SUBREV_F32);
+	SI_ISA_SIMD_REGISTER(V_MUL_F32);
+	SI_ISA_SIMD_REGISTER(V_MUL_I32_I24);
+	SI_ISA_SIMD_REGISTER(V_LSHRREV_B32);
+	SI_ISA_SIMD_REGISTER(V_ASHRREV_I32);
+	SI_ISA_SIMD_REGISTER(V_LSHLREV_B32);
+	SI_ISA_SIMD_REGISTER(V_AND_B32);
+	SI_ISA_SIMD_REGISTER(V_OR_B32);
+	SI_ISA_SIMD_REGISTER(V_XOR_B32);
+	SI_ISA_SIMD_REGISTER(V_ADD_I32);
+	SI_ISA_SIMD_REGISTER(V_SUB_I32);
+	SI_ISA_SIMD_REGISTER(V_SUBREV_I32);
+
+	/* VOPC */
+	SI_ISA_SIMD_REGISTER(V_CMP_LT_F32);
+	SI_ISA_SIMD_REGISTER(V_CMP_GT_F32);
+	SI_ISA_SIMD_REGISTER(V_CMP_NGT_F32);
+	SI_ISA_SIMD_REGISTER(V_CMP_NEQ_F32);
+	SI_ISA_SIMD_REGISTER(V_CMP_LT_I32);
+	SI_ISA_SIMD_REGISTER(V_CMP_EQ_I32);
+	SI_ISA_SIMD_REGISTER(V_CMP_LE_I32);
+	SI_ISA_SIMD_REGISTER(V_CMP_GT_I32);
+	SI_ISA_SIMD_REGISTER(V_CMP_NE_I32);
+	SI_ISA_SIMD_REGISTER(V_CMP_GE_I32);
+	SI_ISA_SIMD_REGISTER(V_CMP_LT_U32);
+	SI_ISA_SIMD_REGISTER(V_CMP_LE_U32);
+	SI_ISA_SIMD_REGISTER(V_CMP_GT_U32);
+
+	/* VOP3a */
+	SI_ISA_SIMD_REGISTER(V_CNDMASK_B32_VOP3a);
+	SI_ISA_SIMD_REGISTER(V_ADD_F32_VOP3a);
+	SI_ISA_SIMD_REGISTER(V_MUL_F32_VOP3a);
+	SI_ISA_SIMD_REGISTER(V_MAD_F32);
+	SI_ISA_SIMD_REGISTER(V_MUL_LO_U32);
+	SI_ISA_SIMD_REGISTER(V_MUL_LO_I32);
+#undef SI_ISA_SIMD_REGISTER
+}
+
+
+void si_isa_simd_done(void)
+{
+	free(si_isa_simd_func);
+}
+
+
+/* Execute the vector ALU instruction 'inst' for all active work-items of
+ * 'wavefront'. The function returns 0 if the instruction has no lane-parallel
+ * implementation, in which case it must be executed per work-item. */
+int si_isa_simd_execute(struct si_wavefront_t *wavefront,
+	struct si_inst_t *inst)
+{
+	struct si_isa_simd_t simd;
+	struct si_work_group_t *work_group;
+	si_isa_simd_func_t func;
+
+	unsigned long long lanes;
+	long long sreg_read_count;
+	long long vreg_read_count;
+
+	/* Instructions without a lane-parallel implementation, and all
+	 * instructions while dumping the per-work-item ISA trace, go through
+	 * the per-work-item implementations. */
+	func = si_isa_simd_func[inst->info->inst];
+	if (!func || !si_emu_simd || debug_status(si_isa_debug_category) ||
+		si_emu_wavefront_size > SI_ISA_SIMD_MAX_LANES)
+		return 0;
+
+	/* Active lanes */
+	simd.wavefront = wavefront;
+	simd.work_group = wavefront->work_group;
+	simd.num_lanes = si_emu_wavefront_size;
+	lanes = simd.num_lanes == 64 ? ~0ULL : (1ULL << simd.num_lanes) - 1;
+	simd.exec = (wavefront->sreg[SI_EXEC].as_uint |
+		(unsigned long long) wavefront->sreg[SI_EXEC + 1].as_uint << 32) &
+		lanes;
+	simd.active_count = __builtin_popcountll(simd.exec);
+	simd.full = simd.exec == lanes;
+
+	/* No active work-item */
+	if (!simd.exec)
+		return 1;
+
+	/* Execute. Register reads accounted for by an implementation that
+	 * falls back are accounted for again by the per-work-item one. */
+	work_group = simd.work_group;
+	sreg_read_count = work_group->sreg_read_count;
+	vreg_read_count = work_group->vreg_read_count;
+	if (func(&simd, inst))
+		return 1;
+	work_group->sreg_read_count = sreg_read_count;
+	work_group->vreg_read_count = vreg_read_count;
+	return 0;
+}
@@ -47,6 +47,12 @@ struct si_wavefront_t *si_wavefront_create(int wavefront_id,
 	wavefront->id = wavefront_id;
 	si_wavefront_sreg_init(wavefront);
 
+	/* Vector registers, with one extra lane for the scalar work item,
+	 * rounded up to a multiple of 8 lanes. */
+	wavefront->vreg_stride = (si_emu_wavefront_size + 8) & ~7;
+	wavefront->vreg = xcalloc(256 * wavefront->vreg_stride,
+		sizeof(union si_reg_t));
+
 	/* Create work items */
 	wavefront->work_items = xcalloc(si_emu_wavefront_size, sizeof(void *));
 	SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
@@ -54,6 +60,8 @@ struct si_wavefront_t *si_wavefront_create(int wavefront_id,
 		wavefront->work_items[work_item_id] = si_work_item_create();
 
 		wavefront->work_items[work_item_id]->wavefront = wavefront;
+		wavefront->work_items[work_item_id]->vreg =
+			&wavefront->vreg[work_item_id];
 		wavefront->work_items[work_item_id]->id_in_wavefront = 
 			work_item_id;
 		wavefront->work_items[work_item_id]->work_group = work_group;
@@ -62,6 +70,8 @@ struct si_wavefront_t *si_wavefront_create(int wavefront_id,
 	/* Create scalar work item */
 	wavefront->scalar_work_item = si_work_item_create();
 	wavefront->scalar_work_item->wavefront = wavefront;
+	wavefront->scalar_work_item->vreg =
+		&wavefront->vreg[si_emu_wavefront_size];
 	wavefront->scalar_work_item->work_group = work_group;
 
 	/* Assign the work group */
@@ -101,6 +111,7 @@ void si_wavefront_free(struct si_wavefront_t *wavefront)
 	/* Free wavefront */
 	
 	free(wavefront->work_items);
+	free(wavefront->vreg);
 
 	memset(wavefront, 0, sizeof(struct si_wavefront_t));
 	free(wavefront);
@@ -346,15 +357,19 @@ void si_wavefront_execute(struct si_wavefront_t *wavefront)
 		si_emu->vector_alu_inst_count++;
 		wavefront->vector_alu_inst_count++;
 	
-		/* Execute the instruction */
-		SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
+		/* Execute the instruction for all work items at once if
+		 * possible, or one work item at a time otherwise */
+		if (!si_isa_simd_execute(wavefront, inst))
 		{
-			work_item = wavefront->work_items[work_item_id];
-			if(si_wavefront_work_item_active(wavefront, 
-				work_item->id_in_wavefront))
+			SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
 			{
-				(*si_isa_inst_func[inst->info->inst])(work_item,
-					inst);
+				work_item = wavefront->work_items[work_item_id];
+				if(si_wavefront_work_item_active(wavefront, 
+					work_item->id_in_wavefront))
+				{
+					(*si_isa_inst_func[inst->info->inst])(
+						work_item, inst);
+				}
 			}
 		}
 
@@ -415,16 +430,23 @@ void si_wavefront_execute(struct si_wavefront_t *wavefront)
 		}
 		else
 		{
-			/* Execute the instruction */
-			SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, 
-				work_item_id)
+			/* Execute the instruction for all work items at
+			 * once if possible, or one at a time otherwise */
+			if (!si_isa_simd_execute(wavefront, inst))
 			{
-				work_item = wavefront->work_items[work_item_id];
-				if(si_wavefront_work_item_active(wavefront, 
-					work_item->id_in_wavefront))
+				SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, 
+					work_item_id)
 				{
-					(*si_isa_inst_func[inst->info->inst])(
-						work_item, inst);
+					work_item = wavefront->
+						work_items[work_item_id];
+					if(si_wavefront_work_item_active(
+						wavefront, 
+						work_item->id_in_wavefront))
+					{
+						(*si_isa_inst_func[
+							inst->info->inst])(
+							work_item, inst);
+					}
 				}
 			}
 		}
@@ -452,15 +474,19 @@ void si_wavefront_execute(struct si_wavefront_t *wavefront)
 		si_emu->vector_alu_inst_count++;
 		wavefront->vector_alu_inst_count++;
 	
-		/* Execute the instruction */
-		SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
+		/* Execute the instruction for all work items at once if
+		 * possible, or one work item at a time otherwise */
+		if (!si_isa_simd_execute(wavefront, inst))
 		{
-			work_item = wavefront->work_items[work_item_id];
-			if(si_wavefront_work_item_active(wavefront, 
-				work_item->id_in_wavefront))
+			SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
 			{
-				(*si_isa_inst_func[inst->info->inst])(work_item,
-					inst);
+				work_item = wavefront->work_items[work_item_id];
+				if(si_wavefront_work_item_active(wavefront, 
+					work_item->id_in_wavefront))
+				{
+					(*si_isa_inst_func[inst->info->inst])(
+						work_item, inst);
+				}
 			}
 		}
 
@@ -487,15 +513,19 @@ void si_wavefront_execute(struct si_wavefront_t *wavefront)
 		si_emu->vector_alu_inst_count++;
 		wavefront->vector_alu_inst_count++;
 	
-		/* Execute the instruction */
-		SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
+		/* Execute the instruction for all work items at once if
+		 * possible, or one work item at a time otherwise */
+		if (!si_isa_simd_execute(wavefront, inst))
 		{
-			work_item = wavefront->work_items[work_item_id];
-			if(si_wavefront_work_item_active(wavefront, 
-				work_item->id_in_wavefront))
+			SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(wavefront, work_item_id)
 			{
-				(*si_isa_inst_func[inst->info->inst])(work_item,
-					inst);
+				work_item = wavefront->work_items[work_item_id];
+				if(si_wavefront_work_item_active(wavefront, 
+					work_item->id_in_wavefront))
+				{
+					(*si_isa_inst_func[inst->info->inst])(
+						work_item, inst);
+				}
 			}
 		}
 
@@ -51,6 +51,13 @@ struct si_wavefront_t
 	/* Scalar registers */
 	union si_reg_t sreg[256];
 
+	/* Vector registers. Register 'i' of lane 'j' is found at position
+	 * 'i * vreg_stride + j', so that the lanes of a register can be
+	 * operated on with host SIMD instructions. The stride leaves room
+	 * for the lane of the scalar work-item. */
+	union si_reg_t *vreg;
+	int vreg_stride;
+
 	/* Flags updated during instruction execution */
 	unsigned int vector_mem_read : 1;
 	unsigned int vector_mem_write : 1;
@@ -85,6 +92,9 @@ struct si_wavefront_t
 	long long export_inst_count;
 };
 
+#define SI_WAVEFRONT_VREG(WAVEFRONT, VREG) \
+	(&(WAVEFRONT)->vreg[(VREG) * (WAVEFRONT)->vreg_stride])
+
 #define SI_FOREACH_WAVEFRONT_IN_WORK_GROUP(WORK_GROUP, WAVEFRONT_ID) \
 	for ((WAVEFRONT_ID) = 0; \
 		(WAVEFRONT_ID) < (WORK_GROUP)->wavefront_count; \
@@ -201,13 +201,13 @@ struct si_work_group_t *si_work_group_create(unsigned int work_group_id,
 			work_item = wavefront->work_items[work_item_id];
 
 			/* V0 */
-			work_item->vreg[0].as_int = 
+			SI_WORK_ITEM_VREG(work_item, 0).as_int = 
 				work_item->id_in_work_group_3d[0];  
 			/* V1 */
-			work_item->vreg[1].as_int = 
+			SI_WORK_ITEM_VREG(work_item, 1).as_int = 
 				work_item->id_in_work_group_3d[1]; 
 			/* V2 */
-			work_item->vreg[2].as_int = 
+			SI_WORK_ITEM_VREG(work_item, 2).as_int = 
 				work_item->id_in_work_group_3d[2];
 
 		}
@@ -17,6 +17,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <string.h>
 
 #include <arch/southern-islands/emu/ndrange.h>
 #include <arch/southern-islands/emu/work-group.h>
@@ -215,6 +216,10 @@ char *si_gpu_config_help =
 	"      Latency of register file writes in number of cycles.\n"
 	"  WriteBufferSize = <num> (Default = 1)\n"
 	"      Size of the buffer holding register write instructions.\n"
+	"  Coalesce = {t|f} (Default = f)\n"
+	"      Merge the addresses of all work-items of a wavefront that fall\n"
+	"      in the same block of the vector cache into a single access.\n"
+	"      Otherwise, each work-item accesses the vector cache separately.\n"
 	"\n"
 	"Section '[ LDS ]': defines the parameters of the Local Data Share\n"
 	"on each compute unit.\n"
@@ -399,6 +404,7 @@ int si_gpu_vector_mem_read_buffer_size = 1;
 int si_gpu_vector_mem_max_inflight_mem_accesses = 32;
 int si_gpu_vector_mem_write_latency = 1;
 int si_gpu_vector_mem_write_buffer_size = 1;
+int si_gpu_vector_mem_coalesce = 0;
 
 /* LDS memory parameters */
 int si_gpu_lds_size = 65536; /* 64KB */
@@ -451,6 +457,17 @@ void si_gpu_map_ndrange(struct si_ndrange_t *ndrange)
 	assert(si_gpu->work_groups_per_wavefront_pool <= 
 		si_gpu_max_work_groups_per_wavefront_pool);
 
+	/* Statistics for the ND-Range */
+	if (ndrange->id >= si_gpu->ndrange_stats_count)
+	{
+		si_gpu->ndrange_stats = xrealloc(si_gpu->ndrange_stats,
+			(ndrange->id + 1) * sizeof(struct si_gpu_ndrange_stats_t));
+		memset(si_gpu->ndrange_stats + si_gpu->ndrange_stats_count, 0,
+			(ndrange->id + 1 - si_gpu->ndrange_stats_count) *
+			sizeof(struct si_gpu_ndrange_stats_t));
+		si_gpu->ndrange_stats_count = ndrange->id + 1;
+	}
+
 	/* Optional plotting */
 	si_calc_plot();
 }
@@ -572,6 +589,8 @@ void si_config_dump(FILE *f)
 	fprintf(f, "WriteLatency = %d\n", si_gpu_vector_mem_write_latency);
 	fprintf(f, "WriteBufferSize = %d\n",
 		si_gpu_vector_mem_write_buffer_size);
+	fprintf(f, "Coalesce = %s\n", si_gpu_vector_mem_coalesce ?
+		"True" : "False");
 	fprintf(f, "\n");
 
 	/* LDS */
@@ -1025,6 +1044,9 @@ void si_gpu_read_config(void)
 		fatal("%s: invalid value for 'WriteBufferSize'.\n%s",
 			si_gpu_config_file_name, err_note);
 
+	si_gpu_vector_mem_coalesce = config_read_bool(
+		gpu_config, section, "Coalesce", si_gpu_vector_mem_coalesce);
+
 	/* Local Data Share Unit */
 	section = "LocalDataShare";
 
@@ -1133,11 +1155,26 @@ void si_gpu_dump_default_config(char *filename)
 }
 
 
+/* Dump the coalescing statistics of the vector memory unit, given the
+ * number of work-item accesses and the number of vector cache accesses they
+ * resulted in. */
+static void si_gpu_dump_coalescing(FILE *f, long long lane_accesses,
+	long long requests)
+{
+	fprintf(f, "VectorMem.WorkItemAccesses = %lld\n", lane_accesses);
+	fprintf(f, "VectorMem.CacheAccesses = %lld\n", requests);
+	fprintf(f, "VectorMem.CoalescingEfficiency = %.4g\n", requests ?
+		(double) lane_accesses / requests : 0.0);
+}
+
+
 void si_gpu_dump_report(void)
 {
 	struct si_compute_unit_t *compute_unit;
+	struct si_gpu_ndrange_stats_t *ndrange_stats;
 	struct mod_t *lds_mod;
 	int compute_unit_id;
+	int ndrange_id;
 
 	FILE *f;
 
@@ -1177,6 +1214,21 @@ void si_gpu_dump_report(void)
 	fprintf(f, "InstructionsPerCycle = %.4g\n", inst_per_cycle);
 	fprintf(f, "\n\n");
 
+	/* Report for ND-Ranges, only present with coalescing */
+	for (ndrange_id = 0; ndrange_id < si_gpu->ndrange_stats_count;
+		ndrange_id++)
+	{
+		if (!si_gpu_vector_mem_coalesce)
+			break;
+		ndrange_stats = &si_gpu->ndrange_stats[ndrange_id];
+		fprintf(f, "[ NDRange %d ]\n\n", ndrange_id);
+		fprintf(f, "VectorMemInstructions = %lld\n",
+			ndrange_stats->vector_mem_inst_count);
+		si_gpu_dump_coalescing(f, ndrange_stats->vector_mem_lane_accesses,
+			ndrange_stats->vector_mem_requests);
+		fprintf(f, "\n\n");
+	}
+
 	/* Report for compute units */
 	SI_GPU_FOREACH_COMPUTE_UNIT(compute_unit_id)
 	{
@@ -1186,8 +1238,8 @@ void si_gpu_dump_report(void)
 		inst_per_cycle = compute_unit->cycle ? 
 			(double)(compute_unit->inst_count/compute_unit->cycle) :
 		       	0.0;
-		coalesced_reads = lds_mod->reads - lds_mod->effective_reads;
-		coalesced_writes = lds_mod->writes - lds_mod->effective_writes;
+		coalesced_reads = lds_mod->stats.reads - lds_mod->stats.effective_reads;
+		coalesced_writes = lds_mod->stats.writes - lds_mod->stats.effective_writes;
 
 		fprintf(f, "[ ComputeUnit %d ]\n\n", compute_unit_id);
 
@@ -1219,17 +1271,24 @@ void si_gpu_dump_report(void)
 			compute_unit->vreg_write_count);
 		fprintf(f, "\n");
 		fprintf(f, "LDS.Accesses = %lld\n", 
-			lds_mod->reads + lds_mod->writes);
-		fprintf(f, "LDS.Reads = %lld\n", lds_mod->reads);
+			lds_mod->stats.reads + lds_mod->stats.writes);
+		fprintf(f, "LDS.Reads = %lld\n", lds_mod->stats.reads);
 		fprintf(f, "LDS.EffectiveReads = %lld\n", 
-			lds_mod->effective_reads);
+			lds_mod->stats.effective_reads);
 		fprintf(f, "LDS.CoalescedReads = %lld\n", 
 			coalesced_reads);
-		fprintf(f, "LDS.Writes = %lld\n", lds_mod->writes);
+		fprintf(f, "LDS.Writes = %lld\n", lds_mod->stats.writes);
 		fprintf(f, "LDS.EffectiveWrites = %lld\n", 
-			lds_mod->effective_writes);
+			lds_mod->stats.effective_writes);
 		fprintf(f, "LDS.CoalescedWrites = %lld\n", 
 			coalesced_writes);
+		if (si_gpu_vector_mem_coalesce)
+		{
+			fprintf(f, "\n");
+			si_gpu_dump_coalescing(f,
+				compute_unit->vector_mem_unit.coalescer.lane_accesses,
+				compute_unit->vector_mem_unit.coalescer.request_count);
+		}
 		fprintf(f, "\n\n");
 	}
 
@@ -1274,6 +1333,7 @@ void SIGpuCreate(SIGpu *self)
 	/* Virtual functions */
 	asObject(self)->Dump = SIGpuDump;
 	asTiming(self)->DumpSummary = SIGpuDumpSummary;
+	asTiming(self)->ResetStats = SIGpuResetStats;
 	asTiming(self)->Run = SIGpuRun;
 	asTiming(self)->MemConfigCheck = SIGpuMemConfigCheck;
 	asTiming(self)->MemConfigDefault = SIGpuMemConfigDefault;
@@ -1296,6 +1356,9 @@ void SIGpuDestroy(SIGpu *self)
 
 	/* Free available compute unit list */
 	list_free(self->available_compute_units);
+
+	/* Free statistics */
+	free(self->ndrange_stats);
 }
 
 
@@ -1311,6 +1374,24 @@ void SIGpuDumpSummary(Timing *self, FILE *f)
 }
 
 
+/* Reset the statistics of the compute units and ND-Ranges. Counters of the
+ * device section are kept by the emulator, and are not reset. */
+void SIGpuResetStats(Timing *self)
+{
+	SIGpu *gpu = asSIGpu(self);
+	int compute_unit_id;
+
+	SI_GPU_FOREACH_COMPUTE_UNIT(compute_unit_id)
+		si_compute_unit_reset_stats(gpu->compute_units[compute_unit_id]);
+	if (gpu->ndrange_stats)
+		memset(gpu->ndrange_stats, 0, gpu->ndrange_stats_count *
+			sizeof(struct si_gpu_ndrange_stats_t));
+
+	/* Call parent */
+	TimingResetStats(self);
+}
+
+
 int SIGpuRun(Timing *self)
 {
 	SIGpu *gpu = asSIGpu(self);
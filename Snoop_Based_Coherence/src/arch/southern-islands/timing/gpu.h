@@ -184,6 +184,7 @@ extern int si_gpu_vector_mem_exec_latency;
 extern int si_gpu_vector_mem_exec_buffer_size;
 extern int si_gpu_vector_mem_write_latency;
 extern int si_gpu_vector_mem_write_buffer_size;
+extern int si_gpu_vector_mem_coalesce;
 extern int si_gpu_vector_mem_max_inflight_mem_accesses;
 
 extern int si_gpu_lds_size;
@@ -240,6 +241,14 @@ void si_lds_run(struct si_lds_t *lds);
  * Class 'SIGpu'
  */
 
+/* Statistics of an ND-Range */
+struct si_gpu_ndrange_stats_t
+{
+	long long vector_mem_inst_count;
+	long long vector_mem_lane_accesses;
+	long long vector_mem_requests;
+};
+
 CLASS_BEGIN(SIGpu, Timing)
 
 	/* ND-Range running on it */
@@ -254,6 +263,10 @@ CLASS_BEGIN(SIGpu, Timing)
 
 	long long int last_complete_cycle;
 
+	/* Statistics per ND-Range, indexed by ND-Range ID */
+	struct si_gpu_ndrange_stats_t *ndrange_stats;
+	int ndrange_stats_count;
+
 CLASS_END(SIGpu)
 
 void SIGpuCreate(SIGpu *self);
@@ -261,6 +274,7 @@ void SIGpuDestroy(SIGpu *self);
 
 void SIGpuDump(Object *self, FILE *f);
 void SIGpuDumpSummary(Timing *self, FILE *f);
+void SIGpuResetStats(Timing *self);
 
 int SIGpuRun(Timing *self);
 
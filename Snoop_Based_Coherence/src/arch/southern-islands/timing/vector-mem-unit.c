@@ -19,10 +19,13 @@
 
 
 #include <arch/southern-islands/emu/emu.h>
+#include <arch/southern-islands/emu/ndrange.h>
 #include <arch/southern-islands/emu/wavefront.h>
+#include <arch/southern-islands/emu/work-group.h>
 #include <lib/esim/trace.h>
 #include <lib/util/debug.h>
 #include <lib/util/list.h>
+#include <mem-system/coalescer.h>
 
 #include "compute-unit.h"
 #include "gpu.h"
@@ -168,11 +171,15 @@ void si_vector_mem_mem(struct si_vector_mem_unit_t *vector_mem)
 	struct si_uop_t *uop;
 	struct si_work_item_uop_t *work_item_uop;
 	struct si_work_item_t *work_item;
+	struct si_gpu_ndrange_stats_t *ndrange_stats;
+	struct coalescer_t *coalescer = &vector_mem->coalescer;
+	long long lane_accesses;
+	long long requests;
 	int work_item_id;
 	int instructions_processed = 0;
 	int list_entries;
 	int i;
-	enum mod_access_kind_t access_kind;
+	enum mod_access_kind_t access_kind = mod_access_invalid;
 	int list_index = 0;
 
 	list_entries = list_count(vector_mem->read_buffer);
@@ -231,20 +238,32 @@ void si_vector_mem_mem(struct si_vector_mem_unit_t *vector_mem)
 		else 
 			fatal("%s: invalid access kind", __FUNCTION__);
 
-		/* Access global memory */
+		/* Access global memory. With coalescing, the work-items
+		 * accessing the same block share a single access. */
 		assert(!uop->global_mem_witness);
+		lane_accesses = coalescer->lane_accesses;
+		requests = coalescer->request_count;
+		coalescer_start(coalescer,
+			vector_mem->compute_unit->vector_cache, access_kind,
+			&uop->global_mem_witness);
 		SI_FOREACH_WORK_ITEM_IN_WAVEFRONT(uop->wavefront, work_item_id)
 		{
 			work_item = uop->wavefront->work_items[work_item_id];
 			work_item_uop = 
 				&uop->work_item_uop[work_item->id_in_wavefront];
-
-			mod_access(vector_mem->compute_unit->vector_cache, 
-				access_kind, 
-				work_item_uop->global_mem_access_addr,
-				&uop->global_mem_witness, NULL, NULL, NULL);
-			uop->global_mem_witness--;
+			coalescer_add(coalescer,
+				work_item_uop->global_mem_access_addr);
 		}
+		coalescer_end(coalescer);
+
+		/* Statistics for the ND-Range */
+		ndrange_stats = &si_gpu->ndrange_stats[
+			uop->wavefront->work_group->ndrange->id];
+		ndrange_stats->vector_mem_inst_count++;
+		ndrange_stats->vector_mem_lane_accesses +=
+			coalescer->lane_accesses - lane_accesses;
+		ndrange_stats->vector_mem_requests +=
+			coalescer->request_count - requests;
 
 		if(si_spatial_report_active)
 		{
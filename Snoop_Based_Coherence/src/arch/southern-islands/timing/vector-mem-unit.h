@@ -20,6 +20,9 @@
 #ifndef ARCH_SOUTHERN_ISLANDS_TIMING_VECTOR_MEM_H
 #define ARCH_SOUTHERN_ISLANDS_TIMING_VECTOR_MEM_H
 
+#include <mem-system/coalescer.h>
+
+
 struct si_vector_mem_unit_t
 {
 	struct list_t *issue_buffer;  /* Issued instructions */
@@ -30,6 +33,9 @@ struct si_vector_mem_unit_t
 
 	struct si_compute_unit_t *compute_unit;
 
+	/* Address coalescer, also keeping coalescing statistics */
+	struct coalescer_t coalescer;
+
 	/* Statistics */
 	long long inst_count;
 
@@ -33,6 +33,7 @@
 #include <mem-system/spec-mem.h>
 
 #include "context.h"
+#include "decode-cache.h"
 #include "emu.h"
 #include "file-desc.h"
 #include "isa.h"
@@ -236,15 +237,26 @@ void X86ContextExecute(X86Context *self)
 
 	struct x86_regs_t *regs = self->regs;
 	struct mem_t *mem = self->mem;
+	struct x86_inst_t *inst;
 
 	unsigned char buffer[20];
 	unsigned char *buffer_ptr;
 
 	int spec_mode;
 
+	/* Look up the decode cache. It is bypassed when the instruction bytes are
+	 * needed to detect the last instruction. */
+	spec_mode = X86ContextGetState(self, X86ContextSpecMode);
+	inst = x86_emu_last_inst_size ? NULL : x86_decode_cache_lookup(emu->decode_cache,
+		mem, regs->eip, &self->decode_block, &self->decode_index);
+	if (inst)
+	{
+		self->inst = *inst;
+		goto execute;
+	}
+
 	/* Memory permissions should not be checked if the context is executing in
 	 * speculative mode. This will prevent guest segmentation faults to occur. */
-	spec_mode = X86ContextGetState(self, X86ContextSpecMode);
 	mem->safe = spec_mode ? 0 : mem_safe_mode;
 
 	/* Read instruction from memory. Memory should be accessed here in unsafe mode
@@ -267,6 +279,11 @@ void X86ContextExecute(X86Context *self)
 		fatal("0x%x: not supported x86 instruction (%02x %02x %02x %02x...)",
 			regs->eip, buffer_ptr[0], buffer_ptr[1], buffer_ptr[2], buffer_ptr[3]);
 
+	/* Cache the decoded instruction. Instructions fetched speculatively are
+	 * not cached, since permissions were not checked. */
+	if (!spec_mode && !x86_emu_last_inst_size)
+		x86_decode_cache_insert(emu->decode_cache, mem, &self->inst,
+			&self->decode_block, &self->decode_index);
 
 	/* Stop if instruction matches last instruction bytes */
 	if (x86_emu_last_inst_size &&
@@ -274,6 +291,7 @@ void X86ContextExecute(X86Context *self)
 		!memcmp(x86_emu_last_inst_bytes, buffer_ptr, x86_emu_last_inst_size))
 		esim_finish = esim_finish_x86_last_inst;
 
+execute:
 	/* Execute instruction */
 	X86ContextExecuteInst(self);
 	
@@ -29,6 +29,7 @@
 
 /* Forward declarations */
 struct bit_map_t;
+struct x86_decode_block_t;
 
 
 
@@ -94,6 +95,11 @@ CLASS_BEGIN(X86Context, Object)
 	/* Currently emulated instruction */
 	struct x86_inst_t inst;
 
+	/* Block and position in the decode cache of the last instruction
+	 * fetched from it. */
+	struct x86_decode_block_t *decode_block;
+	int decode_index;
+
 	/* Recorded virtual memory address for last emulated instruction */
 	unsigned int effective_address;
 
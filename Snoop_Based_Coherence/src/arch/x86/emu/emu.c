@@ -36,6 +36,7 @@
 #include <mem-system/memory.h>
 
 #include "context.h"
+#include "decode-cache.h"
 #include "emu.h"
 #include "file-desc.h"
 #include "loader.h"
@@ -74,6 +75,7 @@ void X86EmuCreate(X86Emu *self)
 	/* Initialize */
 	self->current_pid = 100;
 	pthread_mutex_init(&self->process_events_mutex, NULL);
+	self->decode_cache = x86_decode_cache_create();
 
 	/* Virtual functions */
 	asObject(self)->Dump = X86EmuDump;
@@ -94,7 +96,9 @@ void X86EmuDestroy(X86Emu *self)
 	/* Free contexts */
 	while (self->context_list_head)
 		delete(self->context_list_head);
-	
+
+	/* Free decode cache */
+	x86_decode_cache_free(self->decode_cache);
 }
 
 
@@ -123,6 +127,8 @@ void X86EmuDumpSummary(Emu *self, FILE *f)
 	/* More statistics */
 	fprintf(f, "Contexts = %d\n", emu->running_list_max);
 	fprintf(f, "Memory = %lu\n", mem_max_mapped_space);
+	fprintf(f, "DecodeCacheHits = %lld\n", emu->decode_cache->hits);
+	fprintf(f, "DecodeCacheMisses = %lld\n", emu->decode_cache->misses);
 }
 
 
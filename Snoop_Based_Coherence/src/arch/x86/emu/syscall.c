@@ -32,6 +32,7 @@
 #include <sys/time.h>
 #include <sys/times.h>
 
+#include <arch/common/roi.h>
 #include <arch/common/runtime.h>
 #include <arch/x86/timing/cpu.h>
 #include <lib/esim/esim.h>
@@ -240,6 +241,15 @@ void X86ContextSyscall(X86Context *self)
 	 * defined in 'syscall.dat'. */
 	if (code < 1 || code >= x86_sys_code_count)
 	{
+		/* Region of interest marker */
+		if (code == ROI_SYSCALL_CODE)
+		{
+			x86_sys_debug("region of interest marker %d (inst %lld, pid %d)\n",
+				regs->ebx, asEmu(emu)->instructions, self->pid);
+			regs->eax = roi_marker(regs->ebx);
+			return;
+		}
+
 		/* Check if it is a special code registered by a runtime ABI */
 		runtime = runtime_get_from_syscall_code(code);
 		if (!runtime)
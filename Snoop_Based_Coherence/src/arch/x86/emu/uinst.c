@@ -530,7 +530,7 @@ static char *x86_uinst_dep_name_get(int dep)
 void x86_uinst_init(void)
 {
 	x86_uinst_list = list_create();
-	x86_uinst_active = arch_x86->sim_kind == arch_sim_kind_detailed;
+	x86_uinst_active = arch_x86->sim_kind != arch_sim_kind_functional;
 }
 
 
@@ -568,7 +568,7 @@ void __x86_uinst_new_mem(X86Context *ctx,
 	int i;
 
 	/* Create micro-instruction */
-	assert(arch_x86->sim_kind == arch_sim_kind_detailed);
+	assert(arch_x86->sim_kind != arch_sim_kind_functional);
 	uinst = x86_uinst_create();
 	uinst->opcode = opcode;
 	uinst->idep[0] = idep0;
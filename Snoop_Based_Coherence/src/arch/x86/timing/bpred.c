@@ -18,6 +18,10 @@
  */
 
 
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/config.h>
 #include <lib/util/debug.h>
@@ -29,6 +33,731 @@
 #include "uop.h"
 
 
+/*
+ * Private
+ */
+
+/* History lengths of the TAGE tagged tables, the perceptron tables (starting
+ * at table 1), and the ITTAGE tagged tables. They follow a geometric series
+ * between the configured minimum and maximum lengths. */
+static int x86_bpred_tage_hist[X86_BPRED_TAGE_TABLES_MAX];
+static int x86_bpred_perceptron_hist[X86_BPRED_TABLES_MAX];
+static int x86_bpred_ittage_hist[X86_BPRED_TABLES_MAX];
+
+/* History lengths of the statistical corrector tables. Table 0 is indexed
+ * with the TAGE prediction instead of the history. */
+static int x86_bpred_sc_hist[X86_BPRED_SC_TABLES] = { 0, 4, 8, 16, 32 };
+
+/* Number of updates between two resets of the TAGE and ITTAGE useful
+ * counters. */
+#define X86_BPRED_U_RESET_PERIOD  (1 << 18)
+
+/* Loop predictor entry fields */
+#define X86_BPRED_LOOP_TAG_BITS  14
+#define X86_BPRED_LOOP_ITER_MAX  0x3fff
+
+
+static int x86_bpred_is_indirect(struct x86_uop_t *uop)
+{
+	int opcode = uop->uinst->opcode;
+
+	return (opcode == x86_uinst_jump || opcode == x86_uinst_call) &&
+		uop->uinst->idep[0] != x86_dep_none;
+}
+
+
+static void x86_bpred_geometric_series(int *hist, int count, int min, int max)
+{
+	int i;
+
+	if (count == 1)
+	{
+		hist[0] = max;
+		return;
+	}
+	for (i = 0; i < count; i++)
+		hist[i] = (int) (min * pow((double) max / min,
+			(double) i / (count - 1)) + 0.5);
+}
+
+
+/* Storage of each predictor in bits, given the log2 of the number of entries
+ * of each table */
+
+static long long x86_bpred_tage_storage(int log_size)
+{
+	long long bits;
+
+	bits = (long long) x86_bpred_tage_tables * (1 << log_size) *
+		(x86_bpred_tage_tag_bits + 5);
+	bits += (1 << (log_size + 1)) * 2;
+	if (x86_bpred_tage_sc)
+		bits += X86_BPRED_SC_TABLES * (1 << (log_size - 1)) * 6;
+	bits += x86_bpred_tage_loop_size * (X86_BPRED_LOOP_TAG_BITS + 4 * 14 + 6);
+	return bits;
+}
+
+
+static long long x86_bpred_perceptron_storage(int log_size)
+{
+	return (long long) x86_bpred_perceptron_tables * (1 << log_size) * 8;
+}
+
+
+static long long x86_bpred_ittage_storage(int log_size)
+{
+	return (long long) x86_bpred_ittage_tables * (1 << log_size) *
+		(x86_bpred_ittage_tag_bits + 35);
+}
+
+
+/* Return the log2 of the largest table size that fits in 'budget' KB */
+static int x86_bpred_fit_budget(char *name, long long (*storage)(int),
+		int budget)
+{
+	int log_size;
+
+	if (storage(4) > budget * 8192LL)
+		fatal("%s: budget of %d KB too small for the predictor tables",
+			name, budget);
+	for (log_size = 4; log_size < 16; log_size++)
+		if (storage(log_size + 1) > budget * 8192LL)
+			break;
+	return log_size;
+}
+
+
+static int x86_bpred_add_fold(struct x86_bpred_t *bpred, int length, int width)
+{
+	struct x86_bpred_fold_t *fold;
+
+	assert(bpred->fold_count < X86_BPRED_FOLD_MAX);
+	fold = &bpred->fold[bpred->fold_count];
+	fold->length = length;
+	fold->width = width;
+	return bpred->fold_count++;
+}
+
+
+/* Push an outcome into a global history. Besides the actual history of the
+ * predictor, this is used on copies of it to make multiple predictions. Such
+ * copies write into the history buffer past the position of the actual
+ * history, which is overwritten as the actual history grows. */
+static void x86_bpred_history_push(struct x86_bpred_t *bpred,
+		struct x86_bpred_history_t *hist, int bit)
+{
+	struct x86_bpred_fold_t *fold;
+
+	unsigned int value;
+	int out;
+	int i;
+
+	bpred->ghist[hist->count & (X86_BPRED_HISTORY_SIZE - 1)] = bit;
+	for (i = 0; i < bpred->fold_count; i++)
+	{
+		fold = &bpred->fold[i];
+		out = bpred->ghist[(hist->count - fold->length) &
+			(X86_BPRED_HISTORY_SIZE - 1)];
+		value = (hist->fold[i] << 1) | bit;
+		value ^= out << (fold->length % fold->width);
+		value ^= value >> fold->width;
+		hist->fold[i] = value & ((1 << fold->width) - 1);
+	}
+	hist->recent = (hist->recent << 1) | bit;
+	hist->count++;
+}
+
+
+
+
+/*
+ * TAGE predictor
+ */
+
+static unsigned int x86_bpred_tage_index(struct x86_bpred_t *bpred,
+		struct x86_bpred_history_t *hist, unsigned int eip, int table)
+{
+	int log_size = x86_bpred_tage_log_size;
+	unsigned int path;
+	unsigned int index;
+
+	path = hist->path & ((1 << MIN(x86_bpred_tage_hist[table], 16)) - 1);
+	index = eip ^ (eip >> (log_size - table % log_size)) ^ path ^
+		(path >> log_size) ^ hist->fold[bpred->tage_fold + 3 * table];
+	return index & ((1 << log_size) - 1);
+}
+
+
+static unsigned int x86_bpred_tage_tag(struct x86_bpred_t *bpred,
+		struct x86_bpred_history_t *hist, unsigned int eip, int table)
+{
+	int fold = bpred->tage_fold + 3 * table;
+
+	return (eip ^ hist->fold[fold + 1] ^ (hist->fold[fold + 2] << 1)) &
+		((1 << x86_bpred_tage_tag_bits) - 1);
+}
+
+
+static unsigned int x86_bpred_sc_index(struct x86_bpred_history_t *hist,
+		unsigned int eip, int tage_pred, int table)
+{
+	int log_size = x86_bpred_tage_log_size - 1;
+	unsigned long long history;
+	unsigned int index;
+
+	if (!table)
+		return ((eip << 1) | tage_pred) & ((1 << log_size) - 1);
+	index = eip ^ (eip >> log_size);
+	history = hist->recent & ((1ULL << x86_bpred_sc_hist[table]) - 1);
+	for (; history; history >>= log_size)
+		index ^= history;
+	return index & ((1 << log_size) - 1);
+}
+
+
+static struct x86_bpred_loop_entry_t *x86_bpred_loop_entry(
+		struct x86_bpred_t *bpred, unsigned int eip)
+{
+	struct x86_bpred_loop_entry_t *entry;
+	unsigned int tag;
+
+	entry = &bpred->loop[eip & (x86_bpred_tage_loop_size - 1)];
+	tag = (eip >> log_base2(x86_bpred_tage_loop_size)) &
+		((1 << X86_BPRED_LOOP_TAG_BITS) - 1);
+	return entry->valid && entry->tag == tag ? entry : NULL;
+}
+
+
+/* Return the prediction for a branch at 'eip' using history 'hist'. If 'uop'
+ * is not NULL, the accessed entries and the prediction of each component are
+ * recorded in it to update the predictor at commit. */
+static int x86_bpred_tage_lookup(struct x86_bpred_t *bpred,
+		struct x86_bpred_history_t *hist, unsigned int eip,
+		struct x86_uop_t *uop)
+{
+	struct x86_bpred_tage_entry_t *entry = NULL;
+	struct x86_bpred_loop_entry_t *loop;
+
+	unsigned int index[X86_BPRED_TAGE_TABLES_MAX];
+	unsigned int tag[X86_BPRED_TAGE_TABLES_MAX];
+	unsigned int sc_index[X86_BPRED_SC_TABLES];
+
+	int provider = -1;
+	int alt = -1;
+	int provider_pred = 0;
+	int provider_weak = 0;
+	int alt_pred;
+	int tage_pred;
+	int pred;
+
+	int loop_valid = 0;
+	int loop_used = 0;
+	int loop_pred = 0;
+
+	int sc_used = 0;
+	int sc_pred = 0;
+	int sc_sum = 0;
+
+	int i;
+
+	/* Find the two longest matching tables */
+	for (i = x86_bpred_tage_tables - 1; i >= 0; i--)
+	{
+		index[i] = x86_bpred_tage_index(bpred, hist, eip, i);
+		tag[i] = x86_bpred_tage_tag(bpred, hist, eip, i);
+		if (bpred->tage_table[i][index[i]].tag != tag[i])
+			continue;
+		if (provider < 0)
+			provider = i;
+		else if (alt < 0)
+			alt = i;
+	}
+
+	/* The alternate prediction comes from the second longest match, or from
+	 * the base predictor. It is used instead of the provider if its entry
+	 * was newly allocated and this has proven more accurate. */
+	alt_pred = alt >= 0 ? bpred->tage_table[alt][index[alt]].ctr >= 0 :
+		bpred->tage_base[eip & ((2 << x86_bpred_tage_log_size) - 1)] > 1;
+	tage_pred = alt_pred;
+	if (provider >= 0)
+	{
+		entry = &bpred->tage_table[provider][index[provider]];
+		provider_pred = entry->ctr >= 0;
+		provider_weak = (entry->ctr == 0 || entry->ctr == -1) && !entry->u;
+		tage_pred = provider_weak && bpred->tage_use_alt >= 0 ?
+			alt_pred : provider_pred;
+	}
+	pred = tage_pred;
+
+	/* Loop predictor */
+	loop = bpred->loop ? x86_bpred_loop_entry(bpred, eip) : NULL;
+	if (loop && loop->conf == 3 && loop->past_iter)
+	{
+		loop_valid = 1;
+		loop_pred = loop->spec_iter == loop->past_iter ?
+			!loop->dir : loop->dir;
+		if (bpred->loop_use >= 0)
+		{
+			loop_used = 1;
+			pred = loop_pred;
+		}
+	}
+
+	/* Statistical corrector. It can revert the prediction of TAGE when the
+	 * provider counter is not saturated. */
+	if (bpred->sc_table[0] && !loop_used && (!entry ||
+		(entry->ctr != 3 && entry->ctr != -4)))
+	{
+		sc_used = 1;
+		for (i = 0; i < X86_BPRED_SC_TABLES; i++)
+		{
+			sc_index[i] = x86_bpred_sc_index(hist, eip, tage_pred, i);
+			sc_sum += 2 * bpred->sc_table[i][sc_index[i]] + 1;
+		}
+		sc_pred = sc_sum >= 0;
+		if (sc_pred != tage_pred && abs(sc_sum) >= bpred->sc_theta)
+			pred = sc_pred;
+	}
+
+	/* Record prediction */
+	if (uop)
+	{
+		for (i = 0; i < x86_bpred_tage_tables; i++)
+		{
+			uop->bpred_index[i] = index[i];
+			uop->bpred_tag[i] = tag[i];
+		}
+		for (i = 0; sc_used && i < X86_BPRED_SC_TABLES; i++)
+			uop->bpred_index[x86_bpred_tage_tables + i] = sc_index[i];
+		uop->bpred_provider = provider;
+		uop->bpred_alt = alt;
+		uop->bpred_provider_pred = provider_pred;
+		uop->bpred_provider_weak = provider_weak;
+		uop->bpred_alt_pred = alt_pred;
+		uop->bpred_tage_pred = tage_pred;
+		uop->bpred_loop_valid = loop_valid;
+		uop->bpred_loop_used = loop_used;
+		uop->bpred_loop_pred = loop_pred;
+		uop->bpred_sc_used = sc_used;
+		uop->bpred_sc_pred = sc_pred;
+		uop->bpred_sc_sum = sc_sum;
+	}
+
+	/* Return prediction */
+	return pred;
+}
+
+
+static void x86_bpred_loop_update(struct x86_bpred_t *bpred,
+		struct x86_uop_t *uop, int taken)
+{
+	struct x86_bpred_loop_entry_t *entry;
+
+	/* Allocate an entry for a mispredicted branch. Entries are only replaced
+	 * after they aged with as many misses as they had correct predictions. */
+	entry = x86_bpred_loop_entry(bpred, uop->eip);
+	if (!entry)
+	{
+		if (uop->pred == taken)
+			return;
+		entry = &bpred->loop[uop->eip & (x86_bpred_tage_loop_size - 1)];
+		if (entry->valid && entry->age)
+		{
+			entry->age--;
+			return;
+		}
+		memset(entry, 0, sizeof(struct x86_bpred_loop_entry_t));
+		entry->valid = 1;
+		entry->tag = (uop->eip >> log_base2(x86_bpred_tage_loop_size)) &
+			((1 << X86_BPRED_LOOP_TAG_BITS) - 1);
+		entry->dir = !taken;
+		entry->age = 7;
+		return;
+	}
+
+	/* Train the choice between the loop predictor and TAGE, and free the
+	 * entry if its prediction failed. */
+	if (uop->bpred_loop_valid)
+	{
+		if (uop->bpred_loop_pred != uop->bpred_tage_pred)
+		{
+			bpred->loop_use = uop->bpred_loop_pred == taken ?
+				MIN(bpred->loop_use + 1, 7) : MAX(bpred->loop_use - 1, -8);
+			if (uop->bpred_loop_pred == taken)
+				entry->age = MIN(entry->age + 1, 7);
+		}
+		if (uop->bpred_loop_pred != taken)
+		{
+			entry->valid = 0;
+			return;
+		}
+	}
+
+	/* Count iterations. The entry becomes confident after the loop ran
+	 * several times with the same number of iterations. */
+	if (taken == entry->dir)
+	{
+		if (++entry->current_iter > X86_BPRED_LOOP_ITER_MAX)
+			entry->valid = 0;
+		return;
+	}
+	if (entry->current_iter == entry->past_iter)
+	{
+		entry->conf = MIN(entry->conf + 1, 3);
+	}
+	else
+	{
+		entry->past_iter = entry->current_iter;
+		entry->conf = 0;
+	}
+	entry->current_iter = 0;
+}
+
+
+static void x86_bpred_tage_update(struct x86_bpred_t *bpred,
+		struct x86_uop_t *uop, int taken)
+{
+	struct x86_bpred_tage_entry_t *entry;
+
+	signed char *ctr;
+	char *base_ctr;
+
+	int provider = uop->bpred_provider;
+	int alt = uop->bpred_alt;
+	int allocated;
+	int i;
+	int j;
+
+	/* Statistics of the component providing the prediction */
+	if (uop->bpred_loop_used)
+	{
+		bpred->loop_predictions++;
+		bpred->loop_mispred += uop->pred != taken;
+	}
+	else if (uop->bpred_sc_used && uop->pred != uop->bpred_tage_pred)
+	{
+		bpred->sc_predictions++;
+		bpred->sc_mispred += uop->pred != taken;
+	}
+	else
+	{
+		bpred->tage_predictions++;
+		bpred->tage_mispred += uop->pred != taken;
+	}
+
+	/* Statistical corrector. Counters are trained on mispredictions and on
+	 * low-confidence predictions, and the threshold adapts to keep both
+	 * events balanced. */
+	if (uop->bpred_sc_used)
+	{
+		if (uop->bpred_sc_pred != taken || abs(uop->bpred_sc_sum) < bpred->sc_theta)
+		{
+			for (i = 0; i < X86_BPRED_SC_TABLES; i++)
+			{
+				ctr = &bpred->sc_table[i][uop->bpred_index[x86_bpred_tage_tables + i]];
+				*ctr = taken ? MIN(*ctr + 1, 31) : MAX(*ctr - 1, -32);
+			}
+		}
+		if (uop->bpred_sc_pred != taken)
+		{
+			if (++bpred->sc_tc >= 32)
+			{
+				bpred->sc_theta++;
+				bpred->sc_tc = 0;
+			}
+		}
+		else if (abs(uop->bpred_sc_sum) < bpred->sc_theta)
+		{
+			if (--bpred->sc_tc <= -32)
+			{
+				bpred->sc_theta = MAX(bpred->sc_theta - 1, 1);
+				bpred->sc_tc = 0;
+			}
+		}
+	}
+
+	/* Loop predictor */
+	if (bpred->loop)
+		x86_bpred_loop_update(bpred, uop, taken);
+
+	/* Choice of the alternate prediction for newly allocated entries */
+	if (provider >= 0 && uop->bpred_provider_weak &&
+			uop->bpred_provider_pred != uop->bpred_alt_pred)
+		bpred->tage_use_alt = uop->bpred_alt_pred == taken ?
+			MIN(bpred->tage_use_alt + 1, 7) : MAX(bpred->tage_use_alt - 1, -8);
+
+	/* On a misprediction, allocate an entry in a table with longer history
+	 * than the provider. If all candidates are useful, age them instead. */
+	if (uop->bpred_tage_pred != taken && provider < x86_bpred_tage_tables - 1)
+	{
+		allocated = 0;
+		for (i = provider + 1; i < x86_bpred_tage_tables && !allocated; i++)
+		{
+			entry = &bpred->tage_table[i][uop->bpred_index[i]];
+			if (entry->u)
+				continue;
+			entry->tag = uop->bpred_tag[i];
+			entry->ctr = taken ? 0 : -1;
+			allocated = 1;
+		}
+		for (i = provider + 1; i < x86_bpred_tage_tables && !allocated; i++)
+		{
+			entry = &bpred->tage_table[i][uop->bpred_index[i]];
+			entry->u--;
+		}
+	}
+
+	/* Update the provider counter, as well as the alternate prediction if the
+	 * provider entry is not useful yet. */
+	base_ctr = &bpred->tage_base[uop->eip & ((2 << x86_bpred_tage_log_size) - 1)];
+	if (provider >= 0)
+	{
+		entry = &bpred->tage_table[provider][uop->bpred_index[provider]];
+		if (!entry->u)
+		{
+			if (alt >= 0)
+			{
+				ctr = &bpred->tage_table[alt][uop->bpred_index[alt]].ctr;
+				*ctr = taken ? MIN(*ctr + 1, 3) : MAX(*ctr - 1, -4);
+			}
+			else
+			{
+				*base_ctr = taken ? MIN(*base_ctr + 1, 3) : MAX(*base_ctr - 1, 0);
+			}
+		}
+		entry->ctr = taken ? MIN(entry->ctr + 1, 3) : MAX(entry->ctr - 1, -4);
+		if (uop->bpred_provider_pred != uop->bpred_alt_pred)
+			entry->u = uop->bpred_provider_pred == taken ?
+				MIN(entry->u + 1, 3) : MAX(entry->u - 1, 0);
+	}
+	else
+	{
+		*base_ctr = taken ? MIN(*base_ctr + 1, 3) : MAX(*base_ctr - 1, 0);
+	}
+
+	/* Graceful reset of useful counters */
+	if (++bpred->tage_tick % X86_BPRED_U_RESET_PERIOD)
+		return;
+	for (i = 0; i < x86_bpred_tage_tables; i++)
+		for (j = 0; j < 1 << x86_bpred_tage_log_size; j++)
+			bpred->tage_table[i][j].u >>= 1;
+}
+
+
+
+
+/*
+ * Hashed perceptron predictor
+ */
+
+static int x86_bpred_perceptron_lookup(struct x86_bpred_t *bpred,
+		struct x86_bpred_history_t *hist, unsigned int eip,
+		struct x86_uop_t *uop)
+{
+	int log_size = x86_bpred_perceptron_log_size;
+	unsigned int index;
+	int sum;
+	int i;
+
+	/* Add up one weight per table, starting with the bias weight */
+	index = eip & ((1 << log_size) - 1);
+	sum = bpred->perceptron_table[0][index];
+	if (uop)
+		uop->bpred_index[0] = index;
+	for (i = 1; i < x86_bpred_perceptron_tables; i++)
+	{
+		index = (eip ^ (eip >> log_size) ^ hist->fold[bpred->perceptron_fold + i - 1]) &
+			((1 << log_size) - 1);
+		sum += bpred->perceptron_table[i][index];
+		if (uop)
+			uop->bpred_index[i] = index;
+	}
+
+	/* Return prediction */
+	if (uop)
+		uop->bpred_perceptron_sum = sum;
+	return sum >= 0;
+}
+
+
+static void x86_bpred_perceptron_update(struct x86_bpred_t *bpred,
+		struct x86_uop_t *uop, int taken)
+{
+	signed char *weight;
+
+	int sum = uop->bpred_perceptron_sum;
+	int pred = sum >= 0;
+	int i;
+
+	/* Statistics */
+	bpred->perceptron_predictions++;
+	bpred->perceptron_mispred += pred != taken;
+
+	/* Train weights on mispredictions or low-confidence predictions */
+	if (pred != taken || abs(sum) <= bpred->perceptron_theta)
+	{
+		for (i = 0; i < x86_bpred_perceptron_tables; i++)
+		{
+			weight = &bpred->perceptron_table[i][uop->bpred_index[i]];
+			*weight = taken ? MIN(*weight + 1, 127) : MAX(*weight - 1, -128);
+		}
+	}
+
+	/* Adaptive training threshold */
+	if (pred != taken)
+	{
+		if (++bpred->perceptron_tc >= 32)
+		{
+			bpred->perceptron_theta++;
+			bpred->perceptron_tc = 0;
+		}
+	}
+	else if (abs(sum) <= bpred->perceptron_theta)
+	{
+		if (--bpred->perceptron_tc <= -32)
+		{
+			bpred->perceptron_theta = MAX(bpred->perceptron_theta - 1, 1);
+			bpred->perceptron_tc = 0;
+		}
+	}
+}
+
+
+
+
+/*
+ * ITTAGE indirect branch predictor
+ */
+
+/* Return the target of an indirect jump or call. The BTB target is used when
+ * no tagged table matches. */
+static unsigned int x86_bpred_ittage_lookup(struct x86_bpred_t *bpred,
+		struct x86_uop_t *uop, unsigned int btb_target)
+{
+	struct x86_bpred_history_t *hist = &bpred->hist;
+	struct x86_bpred_ittage_entry_t *entry;
+	struct x86_bpred_ittage_entry_t *alt_entry = NULL;
+
+	unsigned int eip = uop->eip;
+	unsigned int index;
+	unsigned int tag;
+	unsigned int target;
+	unsigned int path;
+
+	int log_size = x86_bpred_ittage_log_size;
+	int fold;
+	int i;
+
+	/* Find the two longest matching tables */
+	uop->bpred_provider = -1;
+	uop->bpred_alt = -1;
+	for (i = x86_bpred_ittage_tables - 1; i >= 0; i--)
+	{
+		fold = bpred->ittage_fold + 3 * i;
+		path = hist->path & ((1 << MIN(x86_bpred_ittage_hist[i], 16)) - 1);
+		index = (eip ^ (eip >> (log_size - i % log_size)) ^ path ^
+			hist->fold[fold]) & ((1 << log_size) - 1);
+		tag = (eip ^ hist->fold[fold + 1] ^ (hist->fold[fold + 2] << 1)) &
+			((1 << x86_bpred_ittage_tag_bits) - 1);
+		uop->bpred_index[i] = index;
+		uop->bpred_tag[i] = tag;
+		if (bpred->ittage_table[i][index].tag != tag)
+			continue;
+		if (uop->bpred_provider < 0)
+			uop->bpred_provider = i;
+		else if (uop->bpred_alt < 0)
+			uop->bpred_alt = i;
+	}
+
+	/* Use the provider target, unless it has low confidence and there is an
+	 * alternate match. */
+	target = btb_target;
+	uop->bpred_provider_pred = 0;
+	if (uop->bpred_provider >= 0)
+	{
+		entry = &bpred->ittage_table[uop->bpred_provider][uop->bpred_index[uop->bpred_provider]];
+		if (uop->bpred_alt >= 0)
+			alt_entry = &bpred->ittage_table[uop->bpred_alt][uop->bpred_index[uop->bpred_alt]];
+		if (!entry->ctr && alt_entry)
+		{
+			target = alt_entry->target;
+		}
+		else
+		{
+			target = entry->target;
+			uop->bpred_provider_pred = 1;
+		}
+	}
+
+	/* Return */
+	uop->bpred_lookup = 1;
+	uop->bpred_target = target;
+	return target;
+}
+
+
+static void x86_bpred_ittage_update(struct x86_bpred_t *bpred,
+		struct x86_uop_t *uop)
+{
+	struct x86_bpred_ittage_entry_t *entry;
+
+	unsigned int target = uop->neip;
+
+	int provider = uop->bpred_provider;
+	int allocated;
+	int i;
+	int j;
+
+	/* Statistics */
+	if (provider >= 0)
+	{
+		bpred->ittage_predictions++;
+		bpred->ittage_mispred += uop->bpred_target != target;
+	}
+
+	/* Update provider target and confidence. The entry is useful if it
+	 * provided the correct target. */
+	if (provider >= 0)
+	{
+		entry = &bpred->ittage_table[provider][uop->bpred_index[provider]];
+		if (entry->target == target)
+			entry->ctr = MIN(entry->ctr + 1, 3);
+		else if (entry->ctr)
+			entry->ctr--;
+		else
+			entry->target = target;
+		if (uop->bpred_provider_pred)
+			entry->u = uop->bpred_target == target;
+	}
+
+	/* On a misprediction, allocate an entry in a table with longer history
+	 * than the provider, or clear the useful flag of all candidates. */
+	if (uop->bpred_target != target && provider < x86_bpred_ittage_tables - 1)
+	{
+		allocated = 0;
+		for (i = provider + 1; i < x86_bpred_ittage_tables && !allocated; i++)
+		{
+			entry = &bpred->ittage_table[i][uop->bpred_index[i]];
+			if (entry->u)
+				continue;
+			entry->tag = uop->bpred_tag[i];
+			entry->target = target;
+			entry->ctr = 0;
+			allocated = 1;
+		}
+		for (i = provider + 1; i < x86_bpred_ittage_tables && !allocated; i++)
+			bpred->ittage_table[i][uop->bpred_index[i]].u = 0;
+	}
+
+	/* Periodic reset of useful flags */
+	if (++bpred->ittage_tick % X86_BPRED_U_RESET_PERIOD)
+		return;
+	for (i = 0; i < x86_bpred_ittage_tables; i++)
+		for (j = 0; j < 1 << x86_bpred_ittage_log_size; j++)
+			bpred->ittage_table[i][j].u = 0;
+}
+
+
 
 
 /*
@@ -114,6 +843,20 @@ int X86ThreadLookupBranchPred(X86Thread *self, struct x86_uop_t *uop)
 		uop->pred = uop->choice_pred ? uop->twolevel_pred : uop->bimod_pred;
 	}
 
+	/* TAGE */
+	if (x86_bpred_kind == x86_bpred_kind_tage)
+	{
+		uop->bpred_lookup = 1;
+		uop->pred = x86_bpred_tage_lookup(bpred, &bpred->hist, uop->eip, uop);
+	}
+
+	/* Perceptron */
+	if (x86_bpred_kind == x86_bpred_kind_perceptron)
+	{
+		uop->bpred_lookup = 1;
+		uop->pred = x86_bpred_perceptron_lookup(bpred, &bpred->hist, uop->eip, uop);
+	}
+
 	/* Return prediction */
 	assert(!uop->pred || uop->pred == 1);
 	return uop->pred;
@@ -121,17 +864,36 @@ int X86ThreadLookupBranchPred(X86Thread *self, struct x86_uop_t *uop)
 
 
 /* Return multiple predictions for an address. This can only be done for two-level
- * adaptive predictors, since they use global history. The prediction of the
- * primary branch is stored in the least significant bit (bit 0), whereas the prediction
- * of the last branch is stored in bit 'count-1'. */
+ * adaptive, TAGE, and perceptron predictors, since they use global history. The
+ * prediction of the primary branch is stored in the least significant bit (bit 0),
+ * whereas the prediction of the last branch is stored in bit 'count-1'. */
 int X86ThreadLookupBranchPredMultiple(X86Thread *self, unsigned int eip, int count)
 {
 	struct x86_bpred_t *bpred = self->bpred;
+	struct x86_bpred_history_t hist;
 
 	int i, pred, temp_pred;
 	unsigned int bht_index, pht_col;
 	unsigned int bhr;  /* branch history register = pht_row */
 
+	/* TAGE and perceptron predictors make each prediction on a copy of the
+	 * global history extended with the previous predictions. */
+	if (x86_bpred_kind == x86_bpred_kind_tage ||
+			x86_bpred_kind == x86_bpred_kind_perceptron)
+	{
+		hist = bpred->hist;
+		pred = 0;
+		for (i = 0; i < count; i++)
+		{
+			temp_pred = x86_bpred_kind == x86_bpred_kind_tage ?
+				x86_bpred_tage_lookup(bpred, &hist, eip, NULL) :
+				x86_bpred_perceptron_lookup(bpred, &hist, eip, NULL);
+			pred |= temp_pred << i;
+			x86_bpred_history_push(bpred, &hist, temp_pred);
+		}
+		return pred;
+	}
+
 	/* First make a regular prediction. This updates the necessary fields in the
 	 * uop for a later call to X86ThreadUpdateBranchPred, and makes the first prediction
 	 * considering known characteristics of the primary branch. */
@@ -160,17 +922,34 @@ void X86ThreadUpdateBranchPred(X86Thread *self, struct x86_uop_t *uop)
 {
 	struct x86_bpred_t *bpred = self->bpred;
 	int taken;
+	int mispred;
 	char *pctr;  /* pointer to 2-bit counter */
 	unsigned int *pbhr;  /* pointer to branch history register */
 
 	assert(!uop->specmode);
 	assert(uop->flags & X86_UINST_CTRL);
 	taken = uop->neip != uop->eip + uop->mop_size;
+	mispred = uop->neip != uop->pred_neip;
 
 	/* Stats */
 	bpred->accesses++;
-	if (uop->neip == uop->pred_neip)
+	if (!mispred)
 		bpred->hits++;
+	if (uop->flags & X86_UINST_COND)
+	{
+		bpred->cond_branches++;
+		bpred->cond_mispred += mispred;
+	}
+	else if (uop->uinst->opcode == x86_uinst_ret)
+	{
+		bpred->return_branches++;
+		bpred->return_mispred += mispred;
+	}
+	else if (x86_bpred_is_indirect(uop))
+	{
+		bpred->indirect_branches++;
+		bpred->indirect_mispred += mispred;
+	}
 	
 	/* Update predictors. This is only done for conditional branches. Thus,
 	 * exit now if instruction is a call, ret, or jmp.
@@ -208,6 +987,55 @@ void X86ThreadUpdateBranchPred(X86Thread *self, struct x86_uop_t *uop)
 		pctr = &bpred->choice[uop->choice_index];
 		*pctr = uop->bimod_pred == taken ? MAX(*pctr - 1, 0) : MIN(*pctr + 1, 3);
 	}
+
+	/* TAGE and perceptron predictors. They are only updated if they were
+	 * accessed at fetch, which requires a BTB hit. */
+	if (x86_bpred_kind == x86_bpred_kind_tage && uop->bpred_lookup)
+		x86_bpred_tage_update(bpred, uop, taken);
+	if (x86_bpred_kind == x86_bpred_kind_perceptron && uop->bpred_lookup)
+		x86_bpred_perceptron_update(bpred, uop, taken);
+}
+
+
+/* Push the outcome of a branch into the global history used by the TAGE,
+ * perceptron, and ITTAGE predictors. The history is updated at fetch, but only
+ * with uops in the correct path, whose outcome is known from the functional
+ * simulation. This is equivalent to a speculative history that is repaired
+ * after each misprediction. Conditional branches push their direction,
+ * and indirect jumps and calls push one bit of their target. */
+void X86ThreadUpdateBranchHistory(X86Thread *self, struct x86_uop_t *uop)
+{
+	struct x86_bpred_t *bpred = self->bpred;
+	struct x86_bpred_loop_entry_t *loop;
+
+	int taken;
+
+	assert(uop->flags & X86_UINST_CTRL);
+	if (!bpred->ghist || uop->specmode)
+		return;
+	if (uop->uinst->opcode == x86_uinst_ibranch)
+		return;
+
+	/* Path history */
+	bpred->hist.path = (bpred->hist.path << 1) | ((uop->eip ^ (uop->eip >> 4)) & 1);
+
+	/* Indirect jump or call */
+	if (!(uop->flags & X86_UINST_COND))
+	{
+		if (x86_bpred_is_indirect(uop))
+			x86_bpred_history_push(bpred, &bpred->hist,
+				(uop->neip ^ (uop->neip >> 4)) & 1);
+		return;
+	}
+
+	/* Conditional branch. The loop predictor counts the iterations fetched
+	 * to predict the loop exit. */
+	taken = uop->neip != uop->eip + uop->mop_size;
+	x86_bpred_history_push(bpred, &bpred->hist, taken);
+	loop = bpred->loop ? x86_bpred_loop_entry(bpred, uop->eip) : NULL;
+	if (loop)
+		loop->spec_iter = taken == loop->dir ?
+			MIN(loop->spec_iter + 1, X86_BPRED_LOOP_ITER_MAX) : 0;
 }
 
 
@@ -260,6 +1088,11 @@ unsigned int X86ThreadLookupBTB(X86Thread *self, struct x86_uop_t *uop)
 		target = bpred->ras[bpred->ras_index];
 	}
 
+	/* Indirect jumps and calls take their target from ITTAGE, if present */
+	if (hit && x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage &&
+			x86_bpred_is_indirect(uop))
+		target = x86_bpred_ittage_lookup(bpred, uop, target);
+
 	/* Return */
 	return target;
 }
@@ -275,6 +1108,11 @@ void X86ThreadUpdateBTB(X86Thread *self, struct x86_uop_t *uop)
 	/* No update for perfect branch predictor */
 	if (x86_bpred_kind == x86_bpred_kind_perfect)
 		return;
+
+	/* ITTAGE */
+	if (x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage &&
+			uop->bpred_lookup && x86_bpred_is_indirect(uop))
+		x86_bpred_ittage_update(bpred, uop);
 	
 	/* Search address in BTB */
 	set = uop->eip & (x86_bpred_btb_sets - 1);
@@ -346,6 +1184,88 @@ unsigned int X86ThreadGetNextBranch(X86Thread *self, unsigned int eip, unsigned
 }
 
 
+static void x86_bpred_dump_mpki(FILE *f, char *name, long long count,
+		long long mispred, long long num_inst)
+{
+	fprintf(f, "BranchPred.%s = %lld\n", name, count);
+	fprintf(f, "BranchPred.%s.Mispred = %lld\n", name, mispred);
+	fprintf(f, "BranchPred.%s.MPKI = %.4g\n", name, num_inst ?
+		(double) mispred * 1000 / num_inst : 0.0);
+}
+
+
+void X86ThreadDumpBranchPredReport(X86Thread *self, FILE *f)
+{
+	struct x86_bpred_t *bpred = self->bpred;
+	long long num_inst = self->stats.num_committed_inst;
+
+	fprintf(f, "; Branch predictor\n");
+	fprintf(f, ";    Mispred - Mispredicted branches of each kind, or mispredictions of\n");
+	fprintf(f, ";        the branches whose final prediction came from each component\n");
+	fprintf(f, ";    MPKI - Mispredictions per thousand committed x86 instructions\n");
+	x86_bpred_dump_mpki(f, "Conditional", bpred->cond_branches,
+		bpred->cond_mispred, num_inst);
+	x86_bpred_dump_mpki(f, "Indirect", bpred->indirect_branches,
+		bpred->indirect_mispred, num_inst);
+	x86_bpred_dump_mpki(f, "Return", bpred->return_branches,
+		bpred->return_mispred, num_inst);
+	if (x86_bpred_kind == x86_bpred_kind_tage)
+	{
+		fprintf(f, "BranchPred.TAGE.StorageKB = %.2f\n",
+			x86_bpred_tage_storage(x86_bpred_tage_log_size) / 8192.0);
+		x86_bpred_dump_mpki(f, "TAGE", bpred->tage_predictions,
+			bpred->tage_mispred, num_inst);
+		if (bpred->loop)
+			x86_bpred_dump_mpki(f, "Loop", bpred->loop_predictions,
+				bpred->loop_mispred, num_inst);
+		if (x86_bpred_tage_sc)
+			x86_bpred_dump_mpki(f, "SC", bpred->sc_predictions,
+				bpred->sc_mispred, num_inst);
+	}
+	if (x86_bpred_kind == x86_bpred_kind_perceptron)
+	{
+		fprintf(f, "BranchPred.Perceptron.StorageKB = %.2f\n",
+			x86_bpred_perceptron_storage(x86_bpred_perceptron_log_size) / 8192.0);
+		x86_bpred_dump_mpki(f, "Perceptron", bpred->perceptron_predictions,
+			bpred->perceptron_mispred, num_inst);
+	}
+	if (x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage)
+	{
+		fprintf(f, "BranchPred.ITTAGE.StorageKB = %.2f\n",
+			x86_bpred_ittage_storage(x86_bpred_ittage_log_size) / 8192.0);
+		x86_bpred_dump_mpki(f, "ITTAGE", bpred->ittage_predictions,
+			bpred->ittage_mispred, num_inst);
+	}
+	fprintf(f, "\n");
+}
+
+
+/* Reset the statistics. Tables and histories keep their trained state. */
+void X86ThreadResetBranchPredStats(X86Thread *self)
+{
+	struct x86_bpred_t *bpred = self->bpred;
+
+	bpred->accesses = 0;
+	bpred->hits = 0;
+	bpred->cond_branches = 0;
+	bpred->cond_mispred = 0;
+	bpred->indirect_branches = 0;
+	bpred->indirect_mispred = 0;
+	bpred->return_branches = 0;
+	bpred->return_mispred = 0;
+	bpred->tage_predictions = 0;
+	bpred->tage_mispred = 0;
+	bpred->loop_predictions = 0;
+	bpred->loop_mispred = 0;
+	bpred->sc_predictions = 0;
+	bpred->sc_mispred = 0;
+	bpred->perceptron_predictions = 0;
+	bpred->perceptron_mispred = 0;
+	bpred->ittage_predictions = 0;
+	bpred->ittage_mispred = 0;
+}
+
+
 
 
 /*
@@ -389,6 +1309,70 @@ struct x86_bpred_t *x86_bpred_create(char *name)
 			bpred->choice[i] = 2;
 	}
 
+	/* Global history */
+	if (x86_bpred_kind == x86_bpred_kind_tage ||
+		x86_bpred_kind == x86_bpred_kind_perceptron ||
+		x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage)
+		bpred->ghist = xcalloc(X86_BPRED_HISTORY_SIZE, sizeof(char));
+
+	/* TAGE predictor, with three folded histories per tagged table */
+	if (x86_bpred_kind == x86_bpred_kind_tage)
+	{
+		bpred->tage_base = xcalloc(2 << x86_bpred_tage_log_size, sizeof(char));
+		for (i = 0; i < 2 << x86_bpred_tage_log_size; i++)
+			bpred->tage_base[i] = 2;
+		bpred->tage_fold = bpred->fold_count;
+		for (i = 0; i < x86_bpred_tage_tables; i++)
+		{
+			bpred->tage_table[i] = xcalloc(1 << x86_bpred_tage_log_size,
+				sizeof(struct x86_bpred_tage_entry_t));
+			x86_bpred_add_fold(bpred, x86_bpred_tage_hist[i], x86_bpred_tage_log_size);
+			x86_bpred_add_fold(bpred, x86_bpred_tage_hist[i], x86_bpred_tage_tag_bits);
+			x86_bpred_add_fold(bpred, x86_bpred_tage_hist[i], x86_bpred_tage_tag_bits - 1);
+		}
+		if (x86_bpred_tage_loop_size)
+			bpred->loop = xcalloc(x86_bpred_tage_loop_size,
+				sizeof(struct x86_bpred_loop_entry_t));
+		if (x86_bpred_tage_sc)
+		{
+			for (i = 0; i < X86_BPRED_SC_TABLES; i++)
+				bpred->sc_table[i] = xcalloc(1 << (x86_bpred_tage_log_size - 1),
+					sizeof(signed char));
+			bpred->sc_theta = 2 * X86_BPRED_SC_TABLES;
+		}
+	}
+
+	/* Perceptron predictor, with one folded history per table other than
+	 * the bias table. The initial threshold follows the 2002 paper by
+	 * Jimenez and Lin. */
+	if (x86_bpred_kind == x86_bpred_kind_perceptron)
+	{
+		bpred->perceptron_fold = bpred->fold_count;
+		for (i = 0; i < x86_bpred_perceptron_tables; i++)
+		{
+			bpred->perceptron_table[i] = xcalloc(1 << x86_bpred_perceptron_log_size,
+				sizeof(signed char));
+			if (i)
+				x86_bpred_add_fold(bpred, x86_bpred_perceptron_hist[i],
+					x86_bpred_perceptron_log_size);
+		}
+		bpred->perceptron_theta = (int) (1.93 * x86_bpred_perceptron_tables + 14);
+	}
+
+	/* ITTAGE predictor */
+	if (x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage)
+	{
+		bpred->ittage_fold = bpred->fold_count;
+		for (i = 0; i < x86_bpred_ittage_tables; i++)
+		{
+			bpred->ittage_table[i] = xcalloc(1 << x86_bpred_ittage_log_size,
+				sizeof(struct x86_bpred_ittage_entry_t));
+			x86_bpred_add_fold(bpred, x86_bpred_ittage_hist[i], x86_bpred_ittage_log_size);
+			x86_bpred_add_fold(bpred, x86_bpred_ittage_hist[i], x86_bpred_ittage_tag_bits);
+			x86_bpred_add_fold(bpred, x86_bpred_ittage_hist[i], x86_bpred_ittage_tag_bits - 1);
+		}
+	}
+
 	/* Allocate BTB and assign LRU counters */
 	bpred->btb = xcalloc(x86_bpred_btb_sets * x86_bpred_btb_assoc, sizeof(struct x86_bpred_btb_entry_t));
 	for (i = 0; i < x86_bpred_btb_sets; i++)
@@ -402,6 +1386,8 @@ struct x86_bpred_t *x86_bpred_create(char *name)
 
 void x86_bpred_free(struct x86_bpred_t *bpred)
 {
+	int i;
+
 	/* Bimodal table */
 	if (x86_bpred_kind == x86_bpred_kind_bimod || x86_bpred_kind == x86_bpred_kind_comb)
 		free(bpred->bimod);
@@ -416,6 +1402,20 @@ void x86_bpred_free(struct x86_bpred_t *bpred)
 	if (x86_bpred_kind == x86_bpred_kind_comb)
 		free(bpred->choice);
 
+	/* TAGE, perceptron, and ITTAGE tables */
+	for (i = 0; i < X86_BPRED_TAGE_TABLES_MAX; i++)
+		free(bpred->tage_table[i]);
+	for (i = 0; i < X86_BPRED_SC_TABLES; i++)
+		free(bpred->sc_table[i]);
+	for (i = 0; i < X86_BPRED_TABLES_MAX; i++)
+	{
+		free(bpred->perceptron_table[i]);
+		free(bpred->ittage_table[i]);
+	}
+	free(bpred->tage_base);
+	free(bpred->loop);
+	free(bpred->ghist);
+
 	/* Free */
 	free(bpred->name);
 	free(bpred->btb);
@@ -429,8 +1429,11 @@ void x86_bpred_free(struct x86_bpred_t *bpred)
  * Public
  */
 
-char *x86_bpred_kind_map[] = { "Perfect", "Taken", "NotTaken", "Bimodal", "TwoLevel", "Combined" };
+char *x86_bpred_kind_map[] = { "Perfect", "Taken", "NotTaken", "Bimodal", "TwoLevel",
+	"Combined", "TAGE", "Perceptron" };
 enum x86_bpred_kind_t x86_bpred_kind;
+char *x86_bpred_indirect_kind_map[] = { "BTB", "ITTAGE" };
+enum x86_bpred_indirect_kind_t x86_bpred_indirect_kind;
 int x86_bpred_btb_sets;  /* Number of BTB sets */
 int x86_bpred_btb_assoc;  /* Number of BTB ways */
 int x86_bpred_ras_size;  /* Return address stack size */
@@ -442,6 +1445,27 @@ int x86_bpred_twolevel_l2size;  /* Two-level adaptive predictor: level-2 size */
 int x86_bpred_twolevel_hist_size;  /* Two-level adaptive predictor: level-2 history size */
 int x86_bpred_twolevel_l2height;
 
+int x86_bpred_tage_budget;  /* TAGE: storage budget in KB */
+int x86_bpred_tage_tables;  /* TAGE: number of tagged tables */
+int x86_bpred_tage_min_hist;  /* TAGE: history length of first tagged table */
+int x86_bpred_tage_max_hist;  /* TAGE: history length of last tagged table */
+int x86_bpred_tage_tag_bits;  /* TAGE: tag size */
+int x86_bpred_tage_loop_size;  /* TAGE: loop predictor entries, or 0 */
+int x86_bpred_tage_sc;  /* TAGE: statistical corrector present */
+int x86_bpred_tage_log_size;  /* TAGE: log2 of entries per tagged table */
+
+int x86_bpred_perceptron_budget;  /* Perceptron: storage budget in KB */
+int x86_bpred_perceptron_tables;  /* Perceptron: number of weight tables */
+int x86_bpred_perceptron_max_hist;  /* Perceptron: longest history length */
+int x86_bpred_perceptron_log_size;  /* Perceptron: log2 of weights per table */
+
+int x86_bpred_ittage_budget;  /* ITTAGE: storage budget in KB */
+int x86_bpred_ittage_tables;  /* ITTAGE: number of tagged tables */
+int x86_bpred_ittage_min_hist;  /* ITTAGE: history length of first tagged table */
+int x86_bpred_ittage_max_hist;  /* ITTAGE: history length of last tagged table */
+int x86_bpred_ittage_tag_bits;  /* ITTAGE: tag size */
+int x86_bpred_ittage_log_size;  /* ITTAGE: log2 of entries per tagged table */
+
 
 void X86ReadBranchPredConfig(struct config_t *config)
 {
@@ -450,7 +1474,9 @@ void X86ReadBranchPredConfig(struct config_t *config)
 	section = "BranchPredictor";
 
 	x86_bpred_kind = config_read_enum(config, section, "Kind",
-			x86_bpred_kind_twolevel, x86_bpred_kind_map, 6);
+			x86_bpred_kind_twolevel, x86_bpred_kind_map, 8);
+	x86_bpred_indirect_kind = config_read_enum(config, section, "IndirectKind",
+			x86_bpred_indirect_kind_btb, x86_bpred_indirect_kind_map, 2);
 	x86_bpred_btb_sets = config_read_int(config, section, "BTB.Sets", 256);
 	x86_bpred_btb_assoc = config_read_int(config, section, "BTB.Assoc", 4);
 	x86_bpred_bimod_size = config_read_int(config, section, "Bimod.Size", 1024);
@@ -460,6 +1486,24 @@ void X86ReadBranchPredConfig(struct config_t *config)
 	x86_bpred_twolevel_l2size = config_read_int(config, section, "TwoLevel.L2Size", 1024);
 	x86_bpred_twolevel_hist_size = config_read_int(config, section, "TwoLevel.HistorySize", 8);
 
+	x86_bpred_tage_budget = config_read_int(config, section, "TAGE.Budget", 32);
+	x86_bpred_tage_tables = config_read_int(config, section, "TAGE.Tables", 7);
+	x86_bpred_tage_min_hist = config_read_int(config, section, "TAGE.MinHistory", 5);
+	x86_bpred_tage_max_hist = config_read_int(config, section, "TAGE.MaxHistory", 130);
+	x86_bpred_tage_tag_bits = config_read_int(config, section, "TAGE.TagBits", 10);
+	x86_bpred_tage_loop_size = config_read_int(config, section, "TAGE.LoopSize", 64);
+	x86_bpred_tage_sc = config_read_bool(config, section, "TAGE.StatisticalCorrector", 1);
+
+	x86_bpred_perceptron_budget = config_read_int(config, section, "Perceptron.Budget", 32);
+	x86_bpred_perceptron_tables = config_read_int(config, section, "Perceptron.Tables", 8);
+	x86_bpred_perceptron_max_hist = config_read_int(config, section, "Perceptron.MaxHistory", 128);
+
+	x86_bpred_ittage_budget = config_read_int(config, section, "ITTAGE.Budget", 32);
+	x86_bpred_ittage_tables = config_read_int(config, section, "ITTAGE.Tables", 6);
+	x86_bpred_ittage_min_hist = config_read_int(config, section, "ITTAGE.MinHistory", 4);
+	x86_bpred_ittage_max_hist = config_read_int(config, section, "ITTAGE.MaxHistory", 64);
+	x86_bpred_ittage_tag_bits = config_read_int(config, section, "ITTAGE.TagBits", 11);
+
 	/* Two-level branch predictor parameter */
 	x86_bpred_twolevel_l2height = 1 << x86_bpred_twolevel_hist_size;
 
@@ -479,4 +1523,58 @@ void X86ReadBranchPredConfig(struct config_t *config)
 		fatal("two-level predictor sizes must be power of 2");
 	if (x86_bpred_twolevel_l2size & (x86_bpred_twolevel_l2size - 1))
 		fatal("two-level predictor sizes must be power of 2");
+
+	/* TAGE predictor. Table sizes are the largest that fit in the budget. */
+	if (x86_bpred_kind == x86_bpred_kind_tage)
+	{
+		if (x86_bpred_tage_tables < 1 || x86_bpred_tage_tables > X86_BPRED_TAGE_TABLES_MAX)
+			fatal("number of TAGE tables must be between 1 and %d",
+				X86_BPRED_TAGE_TABLES_MAX);
+		if (x86_bpred_tage_min_hist < 1 || x86_bpred_tage_min_hist > x86_bpred_tage_max_hist ||
+				x86_bpred_tage_max_hist > X86_BPRED_HISTORY_MAX)
+			fatal("TAGE history lengths must be >=1 and <=%d, and minimum must not exceed maximum",
+				X86_BPRED_HISTORY_MAX);
+		if (x86_bpred_tage_tag_bits < 2 || x86_bpred_tage_tag_bits > 16)
+			fatal("TAGE tag size must be >=2 and <=16");
+		if (x86_bpred_tage_loop_size < 0 ||
+				(x86_bpred_tage_loop_size & (x86_bpred_tage_loop_size - 1)))
+			fatal("number of entries in loop predictor must be 0 or a power of 2");
+		x86_bpred_geometric_series(x86_bpred_tage_hist, x86_bpred_tage_tables,
+			x86_bpred_tage_min_hist, x86_bpred_tage_max_hist);
+		x86_bpred_tage_log_size = x86_bpred_fit_budget("TAGE",
+			x86_bpred_tage_storage, x86_bpred_tage_budget);
+	}
+
+	/* Perceptron predictor */
+	if (x86_bpred_kind == x86_bpred_kind_perceptron)
+	{
+		if (x86_bpred_perceptron_tables < 2 || x86_bpred_perceptron_tables > X86_BPRED_TABLES_MAX)
+			fatal("number of perceptron tables must be between 2 and %d",
+				X86_BPRED_TABLES_MAX);
+		if (x86_bpred_perceptron_max_hist < 2 || x86_bpred_perceptron_max_hist > X86_BPRED_HISTORY_MAX)
+			fatal("perceptron history length must be >=2 and <=%d",
+				X86_BPRED_HISTORY_MAX);
+		x86_bpred_geometric_series(x86_bpred_perceptron_hist + 1,
+			x86_bpred_perceptron_tables - 1, 2, x86_bpred_perceptron_max_hist);
+		x86_bpred_perceptron_log_size = x86_bpred_fit_budget("Perceptron",
+			x86_bpred_perceptron_storage, x86_bpred_perceptron_budget);
+	}
+
+	/* ITTAGE predictor */
+	if (x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage)
+	{
+		if (x86_bpred_ittage_tables < 1 || x86_bpred_ittage_tables > X86_BPRED_TABLES_MAX)
+			fatal("number of ITTAGE tables must be between 1 and %d",
+				X86_BPRED_TABLES_MAX);
+		if (x86_bpred_ittage_min_hist < 1 || x86_bpred_ittage_min_hist > x86_bpred_ittage_max_hist ||
+				x86_bpred_ittage_max_hist > X86_BPRED_HISTORY_MAX)
+			fatal("ITTAGE history lengths must be >=1 and <=%d, and minimum must not exceed maximum",
+				X86_BPRED_HISTORY_MAX);
+		if (x86_bpred_ittage_tag_bits < 2 || x86_bpred_ittage_tag_bits > 16)
+			fatal("ITTAGE tag size must be >=2 and <=16");
+		x86_bpred_geometric_series(x86_bpred_ittage_hist, x86_bpred_ittage_tables,
+			x86_bpred_ittage_min_hist, x86_bpred_ittage_max_hist);
+		x86_bpred_ittage_log_size = x86_bpred_fit_budget("ITTAGE",
+			x86_bpred_ittage_storage, x86_bpred_ittage_budget);
+	}
 }
@@ -37,6 +37,9 @@ void X86ThreadFreeBranchPred(X86Thread *self);
 int X86ThreadLookupBranchPred(X86Thread *self, struct x86_uop_t *uop);
 int X86ThreadLookupBranchPredMultiple(X86Thread *self, unsigned int eip, int count);
 void X86ThreadUpdateBranchPred(X86Thread *self, struct x86_uop_t *uop);
+void X86ThreadUpdateBranchHistory(X86Thread *self, struct x86_uop_t *uop);
+void X86ThreadDumpBranchPredReport(X86Thread *self, FILE *f);
+void X86ThreadResetBranchPredStats(X86Thread *self);
 
 unsigned int X86ThreadLookupBTB(X86Thread *self, struct x86_uop_t *uop);
 void X86ThreadUpdateBTB(X86Thread *self, struct x86_uop_t *uop);
@@ -53,6 +56,73 @@ unsigned int X86ThreadGetNextBranch(X86Thread *self, unsigned int eip,
 #define X86_BPRED_BTB_ENTRY(SET, WAY) \
 		(&bpred->btb[(SET) * x86_bpred_btb_assoc + (WAY)])
 
+/* Maximum number of tables in the TAGE, perceptron, and ITTAGE predictors.
+ * Every uop keeps the index of each table accessed to predict it, so that
+ * the same entries are updated at commit. TAGE tagged tables share these
+ * indices with the statistical corrector tables. */
+#define X86_BPRED_TABLES_MAX  16
+#define X86_BPRED_TAGE_TABLES_MAX  10
+#define X86_BPRED_SC_TABLES  5
+
+/* Global history buffer. It must fit the longest history plus the
+ * outcomes speculatively pushed for multiple predictions. */
+#define X86_BPRED_HISTORY_SIZE  2048
+#define X86_BPRED_HISTORY_MAX  1024
+
+/* Maximum number of folded histories, given by three folds (index and two
+ * tags) per TAGE and ITTAGE table, and one per perceptron table. */
+#define X86_BPRED_FOLD_MAX  (3 * X86_BPRED_TAGE_TABLES_MAX + \
+		4 * X86_BPRED_TABLES_MAX)
+
+/* Folded history. The last 'length' outcomes of the global history are
+ * compressed into 'width' bits, as described in the 2006 TAGE paper by
+ * Seznec and Michaud. */
+struct x86_bpred_fold_t
+{
+	int length;
+	int width;
+};
+
+/* Global history state. It is copied to make multiple predictions on
+ * speculative outcomes without altering the actual history. */
+struct x86_bpred_history_t
+{
+	long long count;  /* Number of outcomes pushed into the history */
+	unsigned int path;  /* One address bit per branch */
+	unsigned long long recent;  /* Last 64 outcomes */
+	unsigned int fold[X86_BPRED_FOLD_MAX];
+};
+
+/* TAGE tagged table entry */
+struct x86_bpred_tage_entry_t
+{
+	signed char ctr;  /* 3-bit signed counter, taken if >= 0 */
+	unsigned char u;  /* 2-bit useful counter */
+	unsigned short tag;
+};
+
+/* Loop predictor entry */
+struct x86_bpred_loop_entry_t
+{
+	int valid;
+	unsigned short tag;
+	unsigned short past_iter;  /* Iterations of last complete run of the loop */
+	unsigned short current_iter;  /* Iterations committed in current run */
+	unsigned short spec_iter;  /* Iterations fetched in current run */
+	unsigned char conf;  /* Number of runs with 'past_iter' iterations */
+	unsigned char age;
+	unsigned char dir;  /* Direction of the loop body */
+};
+
+/* ITTAGE tagged table entry */
+struct x86_bpred_ittage_entry_t
+{
+	unsigned int target;
+	unsigned short tag;
+	unsigned char ctr;  /* 2-bit confidence counter */
+	unsigned char u;  /* 1-bit useful flag */
+};
+
 /* BTB Entry */
 struct x86_bpred_btb_entry_t
 {
@@ -90,9 +160,59 @@ struct x86_bpred_t
 	 *   2,3 - Use two-level adaptive predictor */
 	char *choice;
 
+	/* Global history, used by the TAGE, perceptron, and ITTAGE predictors.
+	 * It is only allocated if one of them is present. */
+	char *ghist;
+	struct x86_bpred_history_t hist;
+	struct x86_bpred_fold_t fold[X86_BPRED_FOLD_MAX];
+	int fold_count;
+
+	/* TAGE - bimodal base table, tagged tables, and the first fold of each
+	 * tagged table, followed by its two tag folds. */
+	char *tage_base;
+	struct x86_bpred_tage_entry_t *tage_table[X86_BPRED_TAGE_TABLES_MAX];
+	int tage_fold;
+	int tage_use_alt;  /* Use alternate prediction on newly allocated entries */
+	long long tage_tick;  /* Updates since last graceful reset of useful counters */
+
+	/* Loop predictor and statistical corrector of the TAGE predictor */
+	struct x86_bpred_loop_entry_t *loop;
+	int loop_use;
+	signed char *sc_table[X86_BPRED_SC_TABLES];
+	int sc_theta;
+	int sc_tc;
+
+	/* Hashed perceptron. Table 0 holds the bias weights, while table 'i'
+	 * is indexed with fold 'perceptron_fold + i - 1'. */
+	signed char *perceptron_table[X86_BPRED_TABLES_MAX];
+	int perceptron_fold;
+	int perceptron_theta;
+	int perceptron_tc;
+
+	/* ITTAGE */
+	struct x86_bpred_ittage_entry_t *ittage_table[X86_BPRED_TABLES_MAX];
+	int ittage_fold;
+	long long ittage_tick;
+
 	/* Stats */
 	long long accesses;
 	long long hits;
+	long long cond_branches;
+	long long cond_mispred;
+	long long indirect_branches;
+	long long indirect_mispred;
+	long long return_branches;
+	long long return_mispred;
+	long long tage_predictions;  /* Final predictions provided by each component */
+	long long tage_mispred;
+	long long loop_predictions;
+	long long loop_mispred;
+	long long sc_predictions;
+	long long sc_mispred;
+	long long perceptron_predictions;
+	long long perceptron_mispred;
+	long long ittage_predictions;
+	long long ittage_mispred;
 };
 
 struct x86_bpred_t *x86_bpred_create(char *name);
@@ -114,9 +234,18 @@ extern enum x86_bpred_kind_t
 	x86_bpred_kind_nottaken,
 	x86_bpred_kind_bimod,
 	x86_bpred_kind_twolevel,
-	x86_bpred_kind_comb
+	x86_bpred_kind_comb,
+	x86_bpred_kind_tage,
+	x86_bpred_kind_perceptron
 } x86_bpred_kind;
 
+extern char *x86_bpred_indirect_kind_map[];
+extern enum x86_bpred_indirect_kind_t
+{
+	x86_bpred_indirect_kind_btb = 0,
+	x86_bpred_indirect_kind_ittage
+} x86_bpred_indirect_kind;
+
 extern int x86_bpred_btb_sets;
 extern int x86_bpred_btb_assoc;
 extern int x86_bpred_ras_size;
@@ -128,6 +257,27 @@ extern int x86_bpred_twolevel_l2size;
 extern int x86_bpred_twolevel_hist_size;
 extern int x86_bpred_twolevel_l2height;
 
+extern int x86_bpred_tage_budget;
+extern int x86_bpred_tage_tables;
+extern int x86_bpred_tage_min_hist;
+extern int x86_bpred_tage_max_hist;
+extern int x86_bpred_tage_tag_bits;
+extern int x86_bpred_tage_loop_size;
+extern int x86_bpred_tage_sc;
+extern int x86_bpred_tage_log_size;
+
+extern int x86_bpred_perceptron_budget;
+extern int x86_bpred_perceptron_tables;
+extern int x86_bpred_perceptron_max_hist;
+extern int x86_bpred_perceptron_log_size;
+
+extern int x86_bpred_ittage_budget;
+extern int x86_bpred_ittage_tables;
+extern int x86_bpred_ittage_min_hist;
+extern int x86_bpred_ittage_max_hist;
+extern int x86_bpred_ittage_tag_bits;
+extern int x86_bpred_ittage_log_size;
+
 
 void X86ReadBranchPredConfig(struct config_t *config);
 
@@ -75,14 +75,9 @@ int X86ThreadCanCommit(X86Thread *self)
 	assert(x86_uop_exists(uop));
 	assert(uop->thread == self);
 
-	/* Stores must be ready. Update here 'uop->ready' flag for efficiency,
-	 * if the call to 'X86ThreadIsUopReady' shows input registers to be ready. */
+	/* Stores must be ready */
 	if (uop->uinst->opcode == x86_uinst_store)
-	{
-		if (!uop->ready && X86ThreadIsUopReady(self, uop))
-			uop->ready = 1;
 		return uop->ready;
-	}
 	
 	/* Instructions other than stores must be completed. */
 	return uop->completed;
@@ -122,7 +117,7 @@ void X86ThreadCommit(X86Thread *self, int quant)
 		{
 			X86ThreadUpdateBranchPred(self, uop);
 			X86ThreadUpdateBTB(self, uop);
-			self->btb_writes++;
+			self->stats.btb_writes++;
 		}
 
 		/* Trace cache */
@@ -131,24 +126,27 @@ void X86ThreadCommit(X86Thread *self, int quant)
 			
 		/* Statistics */
 		self->last_commit_cycle = asTiming(cpu)->cycle;
-		self->num_committed_uinst_array[uop->uinst->opcode]++;
-		core->num_committed_uinst_array[uop->uinst->opcode]++;
+		self->stats.num_committed_uinst_array[uop->uinst->opcode]++;
+		core->stats.num_committed_uinst_array[uop->uinst->opcode]++;
 		cpu->num_committed_uinst_array[uop->uinst->opcode]++;
 		cpu->num_committed_uinst++;
 		ctx->inst_count++;
 		if (uop->trace_cache)
 			self->trace_cache->num_committed_uinst++;
 		if (!uop->mop_index)
+		{
+			self->stats.num_committed_inst++;
 			cpu->num_committed_inst++;
+		}
 		if (uop->flags & X86_UINST_CTRL)
 		{
-			self->num_branch_uinst++;
-			core->num_branch_uinst++;
+			self->stats.num_branch_uinst++;
+			core->stats.num_branch_uinst++;
 			cpu->num_branch_uinst++;
 			if (uop->neip != uop->pred_neip)
 			{
-				self->num_mispred_branch_uinst++;
-				core->num_mispred_branch_uinst++;
+				self->stats.num_mispred_branch_uinst++;
+				core->stats.num_mispred_branch_uinst++;
 				cpu->num_mispred_branch_uinst++;
 			}
 		}
@@ -163,8 +161,8 @@ void X86ThreadCommit(X86Thread *self, int quant)
 
 		/* Retire instruction */
 		X86ThreadRemoveROBHead(self);
-		core->rob_reads++;
-		self->rob_reads++;
+		core->stats.rob_reads++;
+		self->stats.rob_reads++;
 		quant--;
 
 		/* Recover. Functional units are cleared when processor
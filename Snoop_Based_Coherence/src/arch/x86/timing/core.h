@@ -59,7 +59,7 @@ CLASS_BEGIN(X86Core, Object)
 	int id;
 
 	/* Shared structures */
-	struct linked_list_t *event_queue;
+	struct x86_event_queue_t *event_queue;
 	struct x86_fu_t *fu;
 	struct prefetch_history_t *prefetch_history;
 
@@ -72,8 +72,9 @@ CLASS_BEGIN(X86Core, Object)
 	int reg_file_fp_count;
 	int reg_file_xmm_count;
 
-	/* Reorder Buffer */
-	struct list_t *rob;
+	/* Reorder Buffer. Circular buffer of 'x86_rob_size' entries per thread,
+	 * with NULL entries for uops removed out of order. */
+	struct x86_uop_t **rob;
 	int rob_count;
 	int rob_head;
 	int rob_tail;
@@ -86,47 +87,57 @@ CLASS_BEGIN(X86Core, Object)
 	int issue_current;
 	int commit_current;
 
-	/* Stats */
-	long long dispatch_stall[x86_dispatch_stall_max];
-	long long num_dispatched_uinst_array[x86_uinst_opcode_count];
-	long long num_issued_uinst_array[x86_uinst_opcode_count];
-	long long num_committed_uinst_array[x86_uinst_opcode_count];
-	long long num_squashed_uinst;
-	long long num_branch_uinst;
-	long long num_mispred_branch_uinst;
-	
-	/* Statistics for shared structures */
-	long long rob_occupancy;
-	long long rob_full;
-	long long rob_reads;
-	long long rob_writes;
-
-	long long iq_occupancy;
-	long long iq_full;
-	long long iq_reads;
-	long long iq_writes;
-	long long iq_wakeup_accesses;
-
-	long long lsq_occupancy;
-	long long lsq_full;
-	long long lsq_reads;
-	long long lsq_writes;
-	long long lsq_wakeup_accesses;
-
-	long long reg_file_int_occupancy;
-	long long reg_file_int_full;
-	long long reg_file_int_reads;
-	long long reg_file_int_writes;
-
-	long long reg_file_fp_occupancy;
-	long long reg_file_fp_full;
-	long long reg_file_fp_reads;
-	long long reg_file_fp_writes;
-	
-	long long reg_file_xmm_occupancy;
-	long long reg_file_xmm_full;
-	long long reg_file_xmm_reads;
-	long long reg_file_xmm_writes;
+	/* Statistics, reset by 'X86CpuResetStats' */
+	struct
+	{
+		long long dispatch_stall[x86_dispatch_stall_max];
+		long long num_dispatched_uinst_array[x86_uinst_opcode_count];
+		long long num_issued_uinst_array[x86_uinst_opcode_count];
+		long long num_committed_uinst_array[x86_uinst_opcode_count];
+		long long num_squashed_uinst;
+		long long num_branch_uinst;
+		long long num_mispred_branch_uinst;
+
+		/* Statistics for shared structures */
+		long long rob_occupancy;
+		long long rob_full;
+		long long rob_reads;
+		long long rob_writes;
+
+		long long iq_occupancy;
+		long long iq_full;
+		long long iq_reads;
+		long long iq_writes;
+		long long iq_wakeup_accesses;
+
+		long long lsq_occupancy;
+		long long lsq_full;
+		long long lsq_reads;
+		long long lsq_writes;
+		long long lsq_wakeup_accesses;
+
+		/* Statistics for memory dependences in the load-store queue */
+		long long lsq_forwarded_loads;  /* Loads served by an older store */
+		long long lsq_forward_stalls;  /* Loads waiting for a store that can't forward */
+		long long lsq_predicted_waits;  /* Loads held by the store set predictor */
+		long long lsq_violations;  /* Loads issued before an older store to the same address */
+		long long lsq_store_set_updates;  /* Store set table updates on violations */
+
+		long long reg_file_int_occupancy;
+		long long reg_file_int_full;
+		long long reg_file_int_reads;
+		long long reg_file_int_writes;
+
+		long long reg_file_fp_occupancy;
+		long long reg_file_fp_full;
+		long long reg_file_fp_reads;
+		long long reg_file_fp_writes;
+
+		long long reg_file_xmm_occupancy;
+		long long reg_file_xmm_full;
+		long long reg_file_xmm_reads;
+		long long reg_file_xmm_writes;
+	} stats;
 
 CLASS_END(X86Core)
 
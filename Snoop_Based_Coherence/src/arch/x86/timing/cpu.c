@@ -18,6 +18,11 @@
  */
 
 
+#include <string.h>
+
+#include <arch/common/arch.h>
+#include <arch/common/interval.h>
+#include <arch/common/roi.h>
 #include <arch/x86/emu/context.h>
 #include <arch/x86/emu/emu.h>
 #include <lib/esim/esim.h>
@@ -38,9 +43,11 @@
 #include "cpu.h"
 #include "decode.h"
 #include "dispatch.h"
+#include "event-queue.h"
 #include "fetch.h"
 #include "fetch-queue.h"
 #include "fu.h"
+#include "interval.h"
 #include "inst-queue.h"
 #include "issue.h"
 #include "load-store-queue.h"
@@ -65,7 +72,10 @@ char *x86_config_help =
 	"The x86 CPU configuration file is a plain text INI file, defining\n"
 	"the parameters of the CPU model used for a detailed (architectural) simulation.\n"
 	"This configuration file is passed to Multi2Sim with option '--x86-config <file>,\n"
-	"which must be accompanied by option '--x86-sim detailed'.\n"
+	"which must be accompanied by option '--x86-sim detailed' or '--x86-sim interval'.\n"
+	"The interval core model uses the dispatch width, the reorder buffer size as its\n"
+	"window, the load-store queue size as its store buffer, and the branch predictor\n"
+	"given below, together with section '[ Interval ]'.\n"
 	"\n"
 	"The following is a list of the sections allowed in the CPU configuration file,\n"
 	"along with the list of variables for each section.\n"
@@ -161,6 +171,25 @@ char *x86_config_help =
 	"      Load-store queue sharing among threads.\n"
 	"  LsqSize = <num_uops> (Default = 20)\n"
 	"      Load-store queue size in number of uops (if private, per-thread LSQ size).\n"
+	"  LsqForwarding = {t|f} (Default = False)\n"
+	"      If true, a load reading bytes written by an older store still in the store\n"
+	"      queue takes its data from the store in a single cycle, without accessing\n"
+	"      the data cache. Loads partially overlapping a store wait for it to write\n"
+	"      the cache.\n"
+	"  LsqSpeculation = {Perfect|Blind|StoreSets} (Default = Perfect)\n"
+	"      Issue policy for loads with older stores which address is not resolved yet.\n"
+	"      With Perfect, loads wait only for the stores they depend on. With Blind,\n"
+	"      loads never wait, and a load issued before an older store to the same\n"
+	"      address is replayed. With StoreSets, a store set predictor holds loads\n"
+	"      until the older stores in their set resolve. If LsqForwarding is false\n"
+	"      and this option is Perfect, loads ignore older stores.\n"
+	"  LsqStoreSetSize = <entries> (Default = 1024)\n"
+	"      Number of entries in the store set ID table, indexed by instruction address.\n"
+	"  LsqStoreSetClear = <cycles> (Default = 1000000)\n"
+	"      Interval between invalidations of the store set table, or 0 for never.\n"
+	"  LsqReplayPenalty = <cycles> (Default = 10)\n"
+	"      Number of cycles that the fetch stage gets stalled when a load that violated\n"
+	"      a memory dependence is replayed.\n"
 	"  RfKind = {Private|Shared} (Default = Private)\n"
 	"      Register file sharing among threads.\n"
 	"  RfIntSize = <entries> (Default = 80)\n"
@@ -230,8 +259,13 @@ char *x86_config_help =
 	"\n"
 	"Section '[ BranchPredictor ]':\n"
 	"\n"
-	"  Kind = {Perfect|Taken|NotTaken|Bimodal|TwoLevel|Combined} (Default = TwoLevel)\n"
-	"      Branch predictor type.\n"
+	"  Kind = {Perfect|Taken|NotTaken|Bimodal|TwoLevel|Combined|TAGE|Perceptron}\n"
+	"      (Default = TwoLevel)\n"
+	"      Branch predictor type. The trace cache needs a predictor with global\n"
+	"      history, i.e., TwoLevel, TAGE, or Perceptron.\n"
+	"  IndirectKind = {BTB|ITTAGE} (Default = BTB)\n"
+	"      Target predictor for indirect jumps and calls. With ITTAGE, the BTB\n"
+	"      target is used when no ITTAGE table matches.\n"
 	"  BTB.Sets = <num_sets> (Default = 256)\n"
 	"      Number of sets in the BTB.\n"
 	"  BTB.Assoc = <num_ways) (Default = 4)\n"
@@ -248,6 +282,42 @@ char *x86_config_help =
 	"      For the two-level adaptive predictor, level 2 size.\n"
 	"  TwoLevel.HistorySize = <size> (Default = 8)\n"
 	"      For the two-level adaptive predictor, level 2 history size.\n"
+	"  TAGE.Budget = <KB> (Default = 32)\n"
+	"      Storage budget of the TAGE predictor. Tagged tables get the largest\n"
+	"      power-of-2 number of entries that fits in the budget, together with\n"
+	"      a bimodal base table with twice as many entries, the loop predictor,\n"
+	"      and the statistical corrector.\n"
+	"  TAGE.Tables = <num> (Default = 7)\n"
+	"      Number of tagged tables, with history lengths in a geometric series.\n"
+	"  TAGE.MinHistory = <length> (Default = 5)\n"
+	"  TAGE.MaxHistory = <length> (Default = 130)\n"
+	"      History lengths of the first and last tagged tables.\n"
+	"  TAGE.TagBits = <bits> (Default = 10)\n"
+	"      Tag size of the tagged tables.\n"
+	"  TAGE.LoopSize = <entries> (Default = 64)\n"
+	"      Number of entries of the loop predictor, or 0 for none.\n"
+	"  TAGE.StatisticalCorrector = {t|f} (Default = True)\n"
+	"      Revert low-confidence TAGE predictions that disagree with the\n"
+	"      statistical bias of the branch.\n"
+	"  Perceptron.Budget = <KB> (Default = 32)\n"
+	"      Storage budget of the hashed perceptron predictor, with 8-bit weights.\n"
+	"  Perceptron.Tables = <num> (Default = 8)\n"
+	"      Number of weight tables, including the bias table.\n"
+	"  Perceptron.MaxHistory = <length> (Default = 128)\n"
+	"      History length hashed into the last table. Lengths of the other\n"
+	"      tables follow a geometric series.\n"
+	"  ITTAGE.Budget = <KB> (Default = 32)\n"
+	"  ITTAGE.Tables = <num> (Default = 6)\n"
+	"  ITTAGE.MinHistory = <length> (Default = 4)\n"
+	"  ITTAGE.MaxHistory = <length> (Default = 64)\n"
+	"  ITTAGE.TagBits = <bits> (Default = 11)\n"
+	"      Storage budget and table organization of the ITTAGE predictor.\n"
+	"\n"
+	"Section '[ Interval ]':\n"
+	"\n"
+	"  MispredictPenalty = <cycles> (Default = 10)\n"
+	"      For the interval core model, number of cycles that dispatch stalls to\n"
+	"      refill the front-end after a mispredicted branch resolves.\n"
 	"\n";
 
 
@@ -293,6 +363,8 @@ int x86_cpu_commit_width;
 
 int x86_cpu_occupancy_stats;
 
+int x86_cpu_interval_mispred_penalty;
+
 
 
 
@@ -394,6 +466,17 @@ void X86CpuReadConfig(void)
 	x86_lsq_kind = config_read_enum(config, section, "LsqKind",
 			x86_lsq_kind_private, x86_lsq_kind_map, 2);
 	x86_lsq_size = config_read_int(config, section, "LsqSize", 20);
+	x86_lsq_forwarding = config_read_bool(config, section, "LsqForwarding", 0);
+	x86_lsq_spec_kind = config_read_enum(config, section, "LsqSpeculation",
+			x86_lsq_spec_kind_perfect, x86_lsq_spec_kind_map, 3);
+	x86_lsq_store_set_size = config_read_int(config, section, "LsqStoreSetSize", 1024);
+	x86_lsq_store_set_clear = config_read_int(config, section, "LsqStoreSetClear", 1000000);
+	x86_lsq_replay_penalty = config_read_int(config, section, "LsqReplayPenalty", 10);
+	if (x86_lsq_store_set_size < 1 || (x86_lsq_store_set_size & (x86_lsq_store_set_size - 1)))
+		fatal("%s: LsqStoreSetSize must be a power of 2", x86_config_file_name);
+	if (x86_lsq_store_set_clear < 0 || x86_lsq_replay_penalty < 0)
+		fatal("%s: invalid value for LsqStoreSetClear or LsqReplayPenalty",
+			x86_config_file_name);
 
 	/* Register file */
 	X86ReadRegFileConfig(config);
@@ -407,6 +490,13 @@ void X86CpuReadConfig(void)
 	/* Trace Cache */
 	X86ReadTraceCacheConfig(config);
 
+	/* Section '[ Interval ]' */
+	section = "Interval";
+	x86_cpu_interval_mispred_penalty = config_read_int(config, section,
+		"MispredictPenalty", 10);
+	if (x86_cpu_interval_mispred_penalty < 0)
+		fatal("%s: invalid value for 'MispredictPenalty'", x86_config_file_name);
+
 	/* Close file */
 	config_check(config);
 	config_free(config);
@@ -428,6 +518,8 @@ void X86CpuInit(void)
 /* Finalization */
 void X86CpuDone(void)
 {
+	/* Uop pool */
+	x86_uop_pool_free();
 }
 
 
@@ -481,12 +573,19 @@ void X86CpuCreate(X86Cpu *self, X86Emu *emu)
 			X86ThreadSetName(thread, name);
 			thread->id_in_core = j;
 			thread->id_in_cpu = i * x86_cpu_num_threads + j;
+
+			/* Interval core model */
+			if (arch_x86->sim_kind == arch_sim_kind_interval)
+				thread->interval = interval_core_create(name,
+					x86_cpu_dispatch_width, x86_rob_size,
+					x86_lsq_size, x86_cpu_interval_mispred_penalty, 0);
 		}
 	}
 
 	/* Virtual functions */
 	asObject(self)->Dump = X86CpuDump;
 	asTiming(self)->DumpSummary = X86CpuDumpSummary;
+	asTiming(self)->ResetStats = X86CpuResetStats;
 	asTiming(self)->Run = X86CpuRun;
 	asTiming(self)->MemConfigCheck = X86CpuMemConfigCheck;
 	asTiming(self)->MemConfigDefault = X86CpuMemConfigDefault;
@@ -550,7 +649,7 @@ void X86CpuDump(Object *self, FILE *f)
 		fprintf(f, "-------\n\n");
 		
 		fprintf(f, "Event Queue:\n");
-		x86_uop_linked_list_dump(core->event_queue, f);
+		X86CoreDumpEventQueue(core, f);
 
 		fprintf(f, "Reorder Buffer:\n");
 		X86CoreDumpROB(core, f);
@@ -570,13 +669,13 @@ void X86CpuDump(Object *self, FILE *f)
 			x86_uop_list_dump(thread->uop_queue, f);
 
 			fprintf(f, "Instruction Queue:\n");
-			x86_uop_linked_list_dump(thread->iq, f);
+			X86ThreadDumpIQ(thread, f);
 
 			fprintf(f, "Load Queue:\n");
-			x86_uop_linked_list_dump(thread->lq, f);
+			X86ThreadDumpLQ(thread, f);
 
 			fprintf(f, "Store Queue:\n");
-			x86_uop_linked_list_dump(thread->sq, f);
+			X86ThreadDumpSQ(thread, f);
 
 			X86ThreadDumpRegFile(thread, f);
 			if (thread->ctx)
@@ -599,15 +698,17 @@ void X86CpuDumpSummary(Timing *self, FILE *f)
 {
 	X86Cpu *cpu = asX86Cpu(self);
 
+	long long cycles;
 	double inst_per_cycle;
 	double uinst_per_cycle;
 	double branch_acc;
 
 	/* Calculate statistics */
-	inst_per_cycle = asTiming(cpu)->cycle ? (double) cpu->num_committed_inst
-			/ asTiming(cpu)->cycle : 0.0;
-	uinst_per_cycle = asTiming(cpu)->cycle ? (double) cpu->num_committed_uinst
-			/ asTiming(cpu)->cycle : 0.0;
+	cycles = self->cycle - self->reset_cycle;
+	inst_per_cycle = cycles ? (double) cpu->num_committed_inst
+			/ cycles : 0.0;
+	uinst_per_cycle = cycles ? (double) cpu->num_committed_uinst
+			/ cycles : 0.0;
 	branch_acc = cpu->num_branch_uinst ? (double) (cpu->num_branch_uinst -
 			cpu->num_mispred_branch_uinst) / cpu->num_branch_uinst : 0.0;
 
@@ -631,29 +732,71 @@ void X86CpuDumpSummary(Timing *self, FILE *f)
 }
 
 
+void X86CpuResetStats(Timing *self)
+{
+	X86Cpu *cpu = asX86Cpu(self);
+	X86Core *core;
+	X86Thread *thread;
+
+	int i;
+	int j;
+
+	/* Processor. Fast-forwarded instructions are not reset. */
+	cpu->num_fetched_uinst = 0;
+	memset(cpu->num_dispatched_uinst_array, 0, sizeof cpu->num_dispatched_uinst_array);
+	memset(cpu->num_issued_uinst_array, 0, sizeof cpu->num_issued_uinst_array);
+	memset(cpu->num_committed_uinst_array, 0, sizeof cpu->num_committed_uinst_array);
+	cpu->num_committed_uinst = 0;
+	cpu->num_committed_inst = 0;
+	cpu->num_squashed_uinst = 0;
+	cpu->num_branch_uinst = 0;
+	cpu->num_mispred_branch_uinst = 0;
+
+	/* Cores and threads */
+	for (i = 0; i < x86_cpu_num_cores; i++)
+	{
+		core = cpu->cores[i];
+		memset(&core->stats, 0, sizeof core->stats);
+		for (j = 0; j < x86_cpu_num_threads; j++)
+		{
+			thread = core->threads[j];
+			memset(&thread->stats, 0, sizeof thread->stats);
+			X86ThreadResetBranchPredStats(thread);
+			if (thread->trace_cache)
+				X86ThreadResetTraceCacheStats(thread);
+			if (thread->interval)
+				interval_core_reset_stats(thread->interval);
+		}
+	}
+
+	/* Call parent */
+	TimingResetStats(self);
+}
+
+
 #define DUMP_DISPATCH_STAT(NAME) { \
 	fprintf(f, "Dispatch.Stall." #NAME " = %lld\n", \
-			core->dispatch_stall[x86_dispatch_stall_##NAME]); \
+			core->stats.dispatch_stall[x86_dispatch_stall_##NAME]); \
 }
 
 #define DUMP_CORE_STRUCT_STATS(NAME, ITEM) { \
 	fprintf(f, #NAME ".Size = %d\n", (int) x86_##ITEM##_size * x86_cpu_num_threads); \
 	if (x86_cpu_occupancy_stats) \
-		fprintf(f, #NAME ".Occupancy = %.2f\n", asTiming(self)->cycle ? \
-				(double) core->ITEM##_occupancy / asTiming(self)->cycle : 0.0); \
-	fprintf(f, #NAME ".Full = %lld\n", core->ITEM##_full); \
-	fprintf(f, #NAME ".Reads = %lld\n", core->ITEM##_reads); \
-	fprintf(f, #NAME ".Writes = %lld\n", core->ITEM##_writes); \
+		fprintf(f, #NAME ".Occupancy = %.2f\n", cycles ? \
+				(double) core->stats.ITEM##_occupancy / cycles : 0.0); \
+	fprintf(f, #NAME ".Full = %lld\n", core->stats.ITEM##_full); \
+	fprintf(f, #NAME ".Reads = %lld\n", core->stats.ITEM##_reads); \
+	fprintf(f, #NAME ".Writes = %lld\n", core->stats.ITEM##_writes); \
 }
 
 #define DUMP_THREAD_STRUCT_STATS(NAME, ITEM) { \
 	fprintf(f, #NAME ".Size = %d\n", (int) x86_##ITEM##_size); \
 	if (x86_cpu_occupancy_stats) \
-		fprintf(f, #NAME ".Occupancy = %.2f\n", asTiming(self)->cycle ? \
-				(double) thread->ITEM##_occupancy / asTiming(self)->cycle : 0.0); \
-	fprintf(f, #NAME ".Full = %lld\n", thread->ITEM##_full); \
-	fprintf(f, #NAME ".Reads = %lld\n", thread->ITEM##_reads); \
-	fprintf(f, #NAME ".Writes = %lld\n", thread->ITEM##_writes); \
+		fprintf(f, #NAME ".Occupancy = %.2f\n", cycles ? \
+				(double) thread->stats.ITEM##_occupancy / cycles : 0.0); \
+	fprintf(f, #NAME ".Full = %lld\n", thread->stats.ITEM##_full); \
+	fprintf(f, #NAME ".Reads = %lld\n", thread->stats.ITEM##_reads); \
+	fprintf(f, #NAME ".Writes = %lld\n", thread->stats.ITEM##_writes); \
 }
 
 
@@ -698,11 +841,24 @@ static void X86DumpCpuConfig(FILE *f)
 	fprintf(f, "IqSize = %d\n", x86_iq_size);
 	fprintf(f, "LsqKind = %s\n", x86_lsq_kind_map[x86_lsq_kind]);
 	fprintf(f, "LsqSize = %d\n", x86_lsq_size);
+	fprintf(f, "LsqForwarding = %s\n", x86_lsq_forwarding ? "True" : "False");
+	fprintf(f, "LsqSpeculation = %s\n", x86_lsq_spec_kind_map[x86_lsq_spec_kind]);
+	fprintf(f, "LsqStoreSetSize = %d\n", x86_lsq_store_set_size);
+	fprintf(f, "LsqStoreSetClear = %d\n", x86_lsq_store_set_clear);
+	fprintf(f, "LsqReplayPenalty = %d\n", x86_lsq_replay_penalty);
 	fprintf(f, "RfKind = %s\n", x86_reg_file_kind_map[x86_reg_file_kind]);
 	fprintf(f, "RfIntSize = %d\n", x86_reg_file_int_size);
 	fprintf(f, "RfFpSize = %d\n", x86_reg_file_fp_size);
 	fprintf(f, "\n");
 
+	/* Interval core model */
+	if (arch_x86->sim_kind == arch_sim_kind_interval)
+	{
+		fprintf(f, "[ Config.Interval ]\n");
+		fprintf(f, "MispredictPenalty = %d\n", x86_cpu_interval_mispred_penalty);
+		fprintf(f, "\n");
+	}
+
 	/* Trace Cache */
 	fprintf(f, "[ Config.TraceCache ]\n");
 	fprintf(f, "Present = %s\n", x86_trace_cache_present ? "True" : "False");
@@ -719,6 +875,7 @@ static void X86DumpCpuConfig(FILE *f)
 	/* Branch Predictor */
 	fprintf(f, "[ Config.BranchPredictor ]\n");
 	fprintf(f, "Kind = %s\n", x86_bpred_kind_map[x86_bpred_kind]);
+	fprintf(f, "IndirectKind = %s\n", x86_bpred_indirect_kind_map[x86_bpred_indirect_kind]);
 	fprintf(f, "BTB.Sets = %d\n", x86_bpred_btb_sets);
 	fprintf(f, "BTB.Assoc = %d\n", x86_bpred_btb_assoc);
 	fprintf(f, "Bimod.Size = %d\n", x86_bpred_bimod_size);
@@ -727,6 +884,30 @@ static void X86DumpCpuConfig(FILE *f)
 	fprintf(f, "TwoLevel.L1Size = %d\n", x86_bpred_twolevel_l1size);
 	fprintf(f, "TwoLevel.L2Size = %d\n", x86_bpred_twolevel_l2size);
 	fprintf(f, "TwoLevel.HistorySize = %d\n", x86_bpred_twolevel_hist_size);
+	if (x86_bpred_kind == x86_bpred_kind_tage)
+	{
+		fprintf(f, "TAGE.Budget = %d\n", x86_bpred_tage_budget);
+		fprintf(f, "TAGE.Tables = %d\n", x86_bpred_tage_tables);
+		fprintf(f, "TAGE.MinHistory = %d\n", x86_bpred_tage_min_hist);
+		fprintf(f, "TAGE.MaxHistory = %d\n", x86_bpred_tage_max_hist);
+		fprintf(f, "TAGE.TagBits = %d\n", x86_bpred_tage_tag_bits);
+		fprintf(f, "TAGE.LoopSize = %d\n", x86_bpred_tage_loop_size);
+		fprintf(f, "TAGE.StatisticalCorrector = %s\n", x86_bpred_tage_sc ? "True" : "False");
+	}
+	if (x86_bpred_kind == x86_bpred_kind_perceptron)
+	{
+		fprintf(f, "Perceptron.Budget = %d\n", x86_bpred_perceptron_budget);
+		fprintf(f, "Perceptron.Tables = %d\n", x86_bpred_perceptron_tables);
+		fprintf(f, "Perceptron.MaxHistory = %d\n", x86_bpred_perceptron_max_hist);
+	}
+	if (x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage)
+	{
+		fprintf(f, "ITTAGE.Budget = %d\n", x86_bpred_ittage_budget);
+		fprintf(f, "ITTAGE.Tables = %d\n", x86_bpred_ittage_tables);
+		fprintf(f, "ITTAGE.MinHistory = %d\n", x86_bpred_ittage_min_hist);
+		fprintf(f, "ITTAGE.MaxHistory = %d\n", x86_bpred_ittage_max_hist);
+		fprintf(f, "ITTAGE.TagBits = %d\n", x86_bpred_ittage_tag_bits);
+	}
 	fprintf(f, "\n");
 
 	/* End of configuration */
@@ -742,12 +923,14 @@ void X86CpuDumpReport(X86Cpu *self, FILE *f)
 	X86Thread *thread;
 
 	long long now;
+	long long cycles;
 
 	int i;
 	int j;
 
-	/* Get CPU timer value */
+	/* Get CPU timer value, and cycles since statistics were reset */
 	now = m2s_timer_get_value(asEmu(emu)->timer);
+	cycles = asTiming(self)->cycle - asTiming(self)->reset_cycle;
 
 	/* Dump CPU configuration */
 	fprintf(f, ";\n; CPU Configuration\n;\n\n");
@@ -825,28 +1008,28 @@ void X86CpuDumpReport(X86Cpu *self, FILE *f)
 
 		/* Dispatch stage */
 		fprintf(f, "; Dispatch stage\n");
-		X86CpuDumpUopReport(self, f, core->num_dispatched_uinst_array,
+		X86CpuDumpUopReport(self, f, core->stats.num_dispatched_uinst_array,
 				"Dispatch", x86_cpu_dispatch_width);
 
 		/* Issue stage */
 		fprintf(f, "; Issue stage\n");
-		X86CpuDumpUopReport(self, f, core->num_issued_uinst_array,
+		X86CpuDumpUopReport(self, f, core->stats.num_issued_uinst_array,
 				"Issue", x86_cpu_issue_width);
 
 		/* Commit stage */
 		fprintf(f, "; Commit stage\n");
-		X86CpuDumpUopReport(self, f, core->num_committed_uinst_array,
+		X86CpuDumpUopReport(self, f, core->stats.num_committed_uinst_array,
 				"Commit", x86_cpu_commit_width);
 
 		/* Committed branches */
 		fprintf(f, "; Committed branches\n");
-		fprintf(f, "Commit.Branches = %lld\n", core->num_branch_uinst);
-		fprintf(f, "Commit.Squashed = %lld\n", core->num_squashed_uinst);
-		fprintf(f, "Commit.Mispred = %lld\n", core->num_mispred_branch_uinst);
-		fprintf(f, "Commit.PredAcc = %.4g\n", core->num_branch_uinst ?
-				(double) (core->num_branch_uinst -
-				core->num_mispred_branch_uinst)
-				/ core->num_branch_uinst : 0.0);
+		fprintf(f, "Commit.Branches = %lld\n", core->stats.num_branch_uinst);
+		fprintf(f, "Commit.Squashed = %lld\n", core->stats.num_squashed_uinst);
+		fprintf(f, "Commit.Mispred = %lld\n", core->stats.num_mispred_branch_uinst);
+		fprintf(f, "Commit.PredAcc = %.4g\n", core->stats.num_branch_uinst ?
+				(double) (core->stats.num_branch_uinst -
+				core->stats.num_mispred_branch_uinst)
+				/ core->stats.num_branch_uinst : 0.0);
 		fprintf(f, "\n");
 
 		/* Occupancy stats */
@@ -861,7 +1044,7 @@ void X86CpuDumpReport(X86Cpu *self, FILE *f)
 		if (x86_iq_kind == x86_iq_kind_shared)
 		{
 			DUMP_CORE_STRUCT_STATS(IQ, iq);
-			fprintf(f, "IQ.WakeupAccesses = %lld\n", core->iq_wakeup_accesses);
+			fprintf(f, "IQ.WakeupAccesses = %lld\n", core->stats.iq_wakeup_accesses);
 		}
 		if (x86_lsq_kind == x86_lsq_kind_shared)
 			DUMP_CORE_STRUCT_STATS(LSQ, lsq);
@@ -872,6 +1055,23 @@ void X86CpuDumpReport(X86Cpu *self, FILE *f)
 		}
 		fprintf(f, "\n");
 
+		/* Memory dependences */
+		if (x86_lsq_forwarding || x86_lsq_spec_kind != x86_lsq_spec_kind_perfect)
+		{
+			fprintf(f, "; Memory dependences\n");
+			fprintf(f, ";    ForwardedLoads - Loads taking their data from an older store\n");
+			fprintf(f, ";    ForwardStalls - Loads waiting for an older store to write the cache\n");
+			fprintf(f, ";    PredictedWaits - Loads held for an unresolved older store\n");
+			fprintf(f, ";    Violations - Loads issued before an older store to the same address\n");
+			fprintf(f, ";    StoreSetUpdates - Store set table updates on violations\n");
+			fprintf(f, "LSQ.ForwardedLoads = %lld\n", core->stats.lsq_forwarded_loads);
+			fprintf(f, "LSQ.ForwardStalls = %lld\n", core->stats.lsq_forward_stalls);
+			fprintf(f, "LSQ.PredictedWaits = %lld\n", core->stats.lsq_predicted_waits);
+			fprintf(f, "LSQ.Violations = %lld\n", core->stats.lsq_violations);
+			fprintf(f, "LSQ.StoreSetUpdates = %lld\n", core->stats.lsq_store_set_updates);
+			fprintf(f, "\n");
+		}
+
 		/* Report for each thread */
 		for (j = 0; j < x86_cpu_num_threads; j++)
 		{
@@ -882,26 +1082,26 @@ void X86CpuDumpReport(X86Cpu *self, FILE *f)
 
 			/* Dispatch stage */
 			fprintf(f, "; Dispatch stage\n");
-			X86CpuDumpUopReport(self, f, thread->num_dispatched_uinst_array,
+			X86CpuDumpUopReport(self, f, thread->stats.num_dispatched_uinst_array,
 					"Dispatch", x86_cpu_dispatch_width);
 
 			/* Issue stage */
 			fprintf(f, "; Issue stage\n");
-			X86CpuDumpUopReport(self, f, thread->num_issued_uinst_array,
+			X86CpuDumpUopReport(self, f, thread->stats.num_issued_uinst_array,
 					"Issue", x86_cpu_issue_width);
 
 			/* Commit stage */
 			fprintf(f, "; Commit stage\n");
-			X86CpuDumpUopReport(self, f, thread->num_committed_uinst_array,
+			X86CpuDumpUopReport(self, f, thread->stats.num_committed_uinst_array,
 					"Commit", x86_cpu_commit_width);
 
 			/* Committed branches */
 			fprintf(f, "; Committed branches\n");
-			fprintf(f, "Commit.Branches = %lld\n", thread->num_branch_uinst);
-			fprintf(f, "Commit.Squashed = %lld\n", thread->num_squashed_uinst);
-			fprintf(f, "Commit.Mispred = %lld\n", thread->num_mispred_branch_uinst);
-			fprintf(f, "Commit.PredAcc = %.4g\n", thread->num_branch_uinst ?
-				(double) (thread->num_branch_uinst - thread->num_mispred_branch_uinst) / thread->num_branch_uinst : 0.0);
+			fprintf(f, "Commit.Branches = %lld\n", thread->stats.num_branch_uinst);
+			fprintf(f, "Commit.Squashed = %lld\n", thread->stats.num_squashed_uinst);
+			fprintf(f, "Commit.Mispred = %lld\n", thread->stats.num_mispred_branch_uinst);
+			fprintf(f, "Commit.PredAcc = %.4g\n", thread->stats.num_branch_uinst ?
+				(double) (thread->stats.num_branch_uinst - thread->stats.num_mispred_branch_uinst) / thread->stats.num_branch_uinst : 0.0);
 			fprintf(f, "\n");
 
 			/* Occupancy stats */
@@ -912,7 +1112,7 @@ void X86CpuDumpReport(X86Cpu *self, FILE *f)
 			if (x86_iq_kind == x86_iq_kind_private)
 			{
 				DUMP_THREAD_STRUCT_STATS(IQ, iq);
-				fprintf(f, "IQ.WakeupAccesses = %lld\n", thread->iq_wakeup_accesses);
+				fprintf(f, "IQ.WakeupAccesses = %lld\n", thread->stats.iq_wakeup_accesses);
 			}
 			if (x86_lsq_kind == x86_lsq_kind_private)
 				DUMP_THREAD_STRUCT_STATS(LSQ, lsq);
@@ -921,17 +1121,27 @@ void X86CpuDumpReport(X86Cpu *self, FILE *f)
 				DUMP_THREAD_STRUCT_STATS(RF_Int, reg_file_int);
 				DUMP_THREAD_STRUCT_STATS(RF_Fp, reg_file_fp);
 			}
-			fprintf(f, "RAT.IntReads = %lld\n", thread->rat_int_reads);
-			fprintf(f, "RAT.IntWrites = %lld\n", thread->rat_int_writes);
-			fprintf(f, "RAT.FpReads = %lld\n", thread->rat_fp_reads);
-			fprintf(f, "RAT.FpWrites = %lld\n", thread->rat_fp_writes);
-			fprintf(f, "BTB.Reads = %lld\n", thread->btb_reads);
-			fprintf(f, "BTB.Writes = %lld\n", thread->btb_writes);
+			fprintf(f, "RAT.IntReads = %lld\n", thread->stats.rat_int_reads);
+			fprintf(f, "RAT.IntWrites = %lld\n", thread->stats.rat_int_writes);
+			fprintf(f, "RAT.FpReads = %lld\n", thread->stats.rat_fp_reads);
+			fprintf(f, "RAT.FpWrites = %lld\n", thread->stats.rat_fp_writes);
+			fprintf(f, "BTB.Reads = %lld\n", thread->stats.btb_reads);
+			fprintf(f, "BTB.Writes = %lld\n", thread->stats.btb_writes);
 			fprintf(f, "\n");
 
+			/* Branch predictor stats */
+			if (x86_bpred_kind == x86_bpred_kind_tage ||
+					x86_bpred_kind == x86_bpred_kind_perceptron ||
+					x86_bpred_indirect_kind == x86_bpred_indirect_kind_ittage)
+				X86ThreadDumpBranchPredReport(thread, f);
+
 			/* Trace cache stats */
 			if (thread->trace_cache)
 				X86ThreadDumpTraceCacheReport(thread, f);
+
+			/* Interval core model stats */
+			if (thread->interval)
+				interval_core_dump_report(thread->interval, f);
 		}
 	}
 }
@@ -946,6 +1156,7 @@ void X86CpuDumpUopReport(X86Cpu *self, FILE *f, long long *uop_stats,
 	long long uinst_mem_count = 0;
 	long long uinst_ctrl_count = 0;
 	long long uinst_total = 0;
+	long long cycles = asTiming(self)->cycle - asTiming(self)->reset_cycle;
 
 	char *name;
 	enum x86_uinst_flag_t flags;
@@ -977,11 +1188,11 @@ void X86CpuDumpUopReport(X86Cpu *self, FILE *f, long long *uop_stats,
 	fprintf(f, "%s.WndSwitch = %lld\n", prefix,
 			uop_stats[x86_uinst_call] + uop_stats[x86_uinst_ret]);
 	fprintf(f, "%s.Total = %lld\n", prefix, uinst_total);
-	fprintf(f, "%s.IPC = %.4g\n", prefix, asTiming(self)->cycle ?
-			(double) uinst_total / asTiming(self)->cycle : 0.0);
+	fprintf(f, "%s.IPC = %.4g\n", prefix, cycles ?
+			(double) uinst_total / cycles : 0.0);
 	fprintf(f, "%s.DutyCycle = %.4g\n", prefix,
-			asTiming(self)->cycle && peak_ipc ?
-			(double) uinst_total / asTiming(self)->cycle / peak_ipc : 0.0);
+			cycles && peak_ipc ?
+			(double) uinst_total / cycles / peak_ipc : 0.0);
 	fprintf(f, "\n");
 }
 
@@ -1000,6 +1211,10 @@ int X86CpuRun(Timing *self)
 			< x86_cpu_fast_forward_count)
 		X86CpuFastForward(cpu);
 
+	/* Functional emulation until the region of interest starts */
+	if (roi_fast_forward && roi_state == roi_state_before)
+		X86CpuFastForwardROI(cpu);
+
 	/* Stop if maximum number of CPU instructions exceeded */
 	if (x86_emu_max_inst && cpu->num_committed_inst >=
 			x86_emu_max_inst - x86_cpu_fast_forward_count)
@@ -1020,8 +1235,11 @@ int X86CpuRun(Timing *self)
 	 * that were freed in the previous simulation cycle. */
 	X86CpuEmptyTraceList(cpu);
 
-	/* Processor stages */
-	X86CpuRunStages(cpu);
+	/* Processor stages, or interval core model */
+	if (arch_x86->sim_kind == arch_sim_kind_interval)
+		X86CpuRunInterval(cpu);
+	else
+		X86CpuRunStages(cpu);
 
 	/* Process host threads generating events */
 	X86EmuProcessEvents(emu);
@@ -1070,6 +1288,20 @@ void X86CpuFastForward(X86Cpu *self)
 }
 
 
+/* Run functional emulation until the guest program marks the start of the
+ * region of interest, or simulation finishes. */
+void X86CpuFastForwardROI(X86Cpu *self)
+{
+	X86Emu *emu = self->emu;
+	long long count;
+
+	count = asEmu(emu)->instructions;
+	while (roi_state == roi_state_before && !esim_finish)
+		X86EmuRun(asEmu(emu));
+	self->num_fast_forward_inst += asEmu(emu)->instructions - count;
+}
+
+
 void X86CpuAddToTraceList(X86Cpu *self, struct x86_uop_t *uop)
 {
 	assert(x86_tracing());
@@ -1110,16 +1342,16 @@ void X86CpuEmptyTraceList(X86Cpu *self)
 
 
 #define UPDATE_THREAD_OCCUPANCY_STATS(ITEM) { \
-	thread->ITEM##_occupancy += thread->ITEM##_count; \
+	thread->stats.ITEM##_occupancy += thread->ITEM##_count; \
 	if (thread->ITEM##_count == x86_##ITEM##_size) \
-		thread->ITEM##_full++; \
+		thread->stats.ITEM##_full++; \
 }
 
 
 #define UPDATE_CORE_OCCUPANCY_STATS(ITEM) { \
-	core->ITEM##_occupancy += core->ITEM##_count; \
+	core->stats.ITEM##_occupancy += core->ITEM##_count; \
 	if (core->ITEM##_count == x86_##ITEM##_size * x86_cpu_num_threads) \
-		core->ITEM##_full++; \
+		core->stats.ITEM##_full++; \
 }
 
 
@@ -21,6 +21,7 @@
 #include <lib/esim/trace.h>
 #include <lib/util/list.h>
 #include <mem-system/module.h>
+#include <mem-system/tlb.h>
 
 #include "core.h"
 #include "cpu.h"
@@ -71,9 +72,11 @@ static void X86ThreadDecode(X86Thread *self)
 		}
 
 		/* Decode one macro-instruction coming from a block in the instruction
-		 * cache. If the cache access finished, extract it from the fetch queue. */
+		 * cache. If the cache access finished, extract it from the fetch queue.
+		 * With an instruction TLB, the access ID was returned by the TLB. */
 		assert(!uop->mop_index);
-		if (!mod_in_flight_access(self->inst_mod, uop->fetch_access, uop->fetch_address))
+		if (self->inst_tlb ? !tlb_in_flight_access(self->inst_tlb, uop->fetch_access) :
+			!mod_in_flight_access(self->inst_mod, uop->fetch_access, uop->fetch_address))
 		{
 			do
 			{
@@ -75,7 +75,7 @@ static int X86ThreadDispatch(X86Thread *self, int quantum)
 		stall = X86ThreadCanDispatch(self);
 		if (stall != x86_dispatch_stall_used)
 		{
-			core->dispatch_stall[stall] += quantum;
+			core->stats.dispatch_stall[stall] += quantum;
 			break;
 		}
 	
@@ -89,29 +89,29 @@ static int X86ThreadDispatch(X86Thread *self, int quantum)
 		
 		/* Insert in ROB */
 		X86CoreEnqueueInROB(core, uop);
-		core->rob_writes++;
-		self->rob_writes++;
+		core->stats.rob_writes++;
+		self->stats.rob_writes++;
 		
 		/* Non memory instruction into IQ */
 		if (!(uop->flags & X86_UINST_MEM))
 		{
 			X86ThreadInsertInIQ(self, uop);
-			core->iq_writes++;
-			self->iq_writes++;
+			core->stats.iq_writes++;
+			self->stats.iq_writes++;
 		}
 		
 		/* Memory instructions into the LSQ */
 		if (uop->flags & X86_UINST_MEM)
 		{
 			X86ThreadInsertInLSQ(self, uop);
-			core->lsq_writes++;
-			self->lsq_writes++;
+			core->stats.lsq_writes++;
+			self->stats.lsq_writes++;
 		}
 		
 		/* Statistics */
-		core->dispatch_stall[uop->specmode ? x86_dispatch_stall_spec : x86_dispatch_stall_used]++;
-		self->num_dispatched_uinst_array[uop->uinst->opcode]++;
-		core->num_dispatched_uinst_array[uop->uinst->opcode]++;
+		core->stats.dispatch_stall[uop->specmode ? x86_dispatch_stall_spec : x86_dispatch_stall_used]++;
+		self->stats.num_dispatched_uinst_array[uop->uinst->opcode]++;
+		core->stats.num_dispatched_uinst_array[uop->uinst->opcode]++;
 		cpu->num_dispatched_uinst_array[uop->uinst->opcode]++;
 		if (uop->trace_cache)
 			self->trace_cache->num_dispatched_uinst++;
@@ -20,6 +20,45 @@
 #ifndef X86_ARCH_TIMING_EVENT_QUEUE_H
 #define X86_ARCH_TIMING_EVENT_QUEUE_H
 
+#include <stdio.h>
+
+
+/* Initial number of buckets in the timing wheel of an event queue. The wheel
+ * grows when a uop is inserted with a longer latency. */
+#define X86_EVENT_QUEUE_WHEEL_SIZE  64
+
+
+/* The event queue of a core holds uops executing in functional units, and
+ * memory uops completed by the memory system, in the order in which they are
+ * written back. This order is that of a list where uops executing in functional
+ * units are inserted sorted by completion cycle and ID, and memory uops are
+ * appended at the tail when they complete. */
+struct x86_event_queue_t
+{
+	/* Memory uops completed by the memory system. They are moved to the
+	 * rest of the queue before any other operation on it. */
+	struct linked_list_t *mem_list;
+
+	/* Timing wheel for uops executing in functional units. Bucket 'i'
+	 * contains the uops completing in a cycle equal to 'i' modulo
+	 * 'wheel_size', sorted by ID and linked through 'event_queue_next'. */
+	int wheel_size;
+	int wheel_count;
+	struct x86_uop_t **wheel_head;
+	struct x86_uop_t **wheel_tail;
+
+	/* Uop in the wheel with the highest completion cycle and ID. Memory
+	 * uops are chained to this uop as they complete. */
+	struct x86_uop_t *last;
+
+	/* Memory uops ahead of all uops in the wheel */
+	struct x86_uop_t *chain_head;
+	struct x86_uop_t *chain_tail;
+
+	/* Temporary list with all uops in the queue, in order */
+	struct list_t *uop_list;
+};
+
 
 /*
  * Class 'X86Core'
@@ -28,7 +67,10 @@
 void X86CoreInitEventQueue(X86Core *self);
 void X86CoreFreeEventQueue(X86Core *self);
 
+void X86CoreDumpEventQueue(X86Core *self, FILE *f);
+
 void X86CoreInsertInEventQueue(X86Core *self, struct x86_uop_t *uop);
+void X86CoreCompleteInEventQueue(X86Core *self, struct x86_uop_t *uop);
 struct x86_uop_t *X86CoreExtractFromEventQueue(X86Core *self);
 
 
@@ -26,6 +26,7 @@
 #include <lib/util/string.h>
 #include <mem-system/mmu.h>
 #include <mem-system/module.h>
+#include <mem-system/tlb.h>
 
 #include "bpred.h"
 #include "core.h"
@@ -204,7 +205,7 @@ static struct x86_uop_t *X86ThreadFetchInst(X86Thread *self, int fetch_trace_cac
 
 		/* Statistics */
 		cpu->num_fetched_uinst++;
-		self->num_fetched_uinst++;
+		self->stats.num_fetched_uinst++;
 		if (fetch_trace_cache)
 			self->trace_cache->num_fetched_uinst++;
 
@@ -270,6 +271,7 @@ static int X86ThreadFetchTraceCache(X86Thread *self)
 		if (uop->flags & X86_UINST_CTRL)
 		{
 			X86ThreadLookupBranchPred(self, uop);
+			X86ThreadUpdateBranchHistory(self, uop);
 			uop->pred_neip = i == mop_count - 1 ? neip :
 				mop_array[i + 1];
 		}
@@ -304,9 +306,14 @@ static void X86ThreadFetch(X86Thread *self)
 		phy_addr = mmu_translate(self->ctx->address_space_index, self->fetch_neip);
 		self->fetch_block = block;
 		self->fetch_address = phy_addr;
-		self->fetch_access = mod_access(self->inst_mod,
-			mod_access_load, phy_addr, NULL, NULL, NULL, NULL);
-		self->btb_reads++;
+		if (self->inst_tlb)
+			self->fetch_access = tlb_access(self->inst_tlb, self->inst_mod,
+				mod_access_load, self->ctx->address_space_index,
+				self->fetch_neip, phy_addr, NULL, NULL, NULL, NULL);
+		else
+			self->fetch_access = mod_access(self->inst_mod,
+				mod_access_load, phy_addr, NULL, NULL, NULL, NULL);
+		self->stats.btb_reads++;
 
 		/* MMU statistics */
 		if (*mmu_report_file_name)
@@ -341,6 +348,7 @@ static void X86ThreadFetch(X86Thread *self)
 		{
 			target = X86ThreadLookupBTB(self, uop);
 			taken = target && X86ThreadLookupBranchPred(self, uop);
+			X86ThreadUpdateBranchHistory(self, uop);
 			if (taken)
 			{
 				self->fetch_neip = target;
@@ -432,8 +440,8 @@ static void X86CoreFetch(X86Core *self)
 					break;
 
 				/* Do not choose it if it is unfair */
-				if (new_thread->num_committed_uinst_array >
-						thread->num_committed_uinst_array + 100000)
+				if (new_thread->stats.num_committed_uinst_array >
+						thread->stats.num_committed_uinst_array + 100000)
 					continue;
 
 				/* Choose it if it is not stalled */
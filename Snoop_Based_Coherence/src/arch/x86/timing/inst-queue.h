@@ -20,6 +20,8 @@
 #ifndef X86_ARCH_TIMING_INST_QUEUE_H
 #define X86_ARCH_TIMING_INST_QUEUE_H
 
+#include <stdio.h>
+
 #include "uop.h"
 
 
@@ -40,12 +42,12 @@ extern int x86_iq_size;
  * Class 'X86Thread'
  */
 
-void X86ThreadInitIQ(X86Thread *self);
 void X86ThreadFreeIQ(X86Thread *self);
+void X86ThreadDumpIQ(X86Thread *self, FILE *f);
 
 int X86ThreadCanInsertInIQ(X86Thread *self, struct x86_uop_t *uop);
 void X86ThreadInsertInIQ(X86Thread *self, struct x86_uop_t *uop);
-void X86ThreadRemoveFromIQ(X86Thread *self);
+void X86ThreadRemoveFromIQ(X86Thread *self, struct x86_uop_t *uop);
 void X86ThreadRecoverIQ(X86Thread *self);
 
 
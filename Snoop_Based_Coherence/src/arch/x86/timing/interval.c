@@ -0,0 +1,273 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <arch/common/interval.h>
+#include <arch/x86/emu/context.h>
+#include <arch/x86/emu/regs.h>
+#include <lib/util/debug.h>
+#include <lib/util/list.h>
+#include <mem-system/mmu.h>
+
+#include "bpred.h"
+#include "core.h"
+#include "cpu.h"
+#include "interval.h"
+#include "sched.h"
+#include "thread.h"
+#include "uop.h"
+
+
+/*
+ * Class 'X86Thread'
+ */
+
+/* Look up and update the branch predictor for a control micro-instruction,
+ * in the same way as the fetch and commit stages do. The uop created for the
+ * branch predictor takes ownership of 'uinst'. The function returns non-zero
+ * if the branch was mispredicted. */
+static int X86ThreadPredictInterval(X86Thread *self, struct x86_uinst_t *uinst,
+	unsigned int eip)
+{
+	X86Context *ctx = self->ctx;
+	struct x86_uop_t *uop;
+
+	unsigned int target;
+	int taken;
+	int mispred;
+
+	/* Create uop */
+	uop = x86_uop_create();
+	uop->uinst = uinst;
+	uop->flags = x86_uinst_info[uinst->opcode].flags;
+	uop->ctx = ctx;
+	uop->thread = self;
+	uop->mop_size = ctx->inst.size;
+	uop->eip = eip;
+	uop->neip = ctx->regs->eip;
+	uop->target_neip = ctx->target_eip;
+
+	/* Predict */
+	target = X86ThreadLookupBTB(self, uop);
+	taken = target && X86ThreadLookupBranchPred(self, uop);
+	X86ThreadUpdateBranchHistory(self, uop);
+	uop->pred_neip = taken ? target : eip + ctx->inst.size;
+	mispred = uop->neip != uop->pred_neip;
+
+	/* Update */
+	X86ThreadUpdateBranchPred(self, uop);
+	X86ThreadUpdateBTB(self, uop);
+	self->stats.btb_reads++;
+	self->stats.btb_writes++;
+
+	/* Free uop */
+	x86_uop_free_if_not_queued(uop);
+	return mispred;
+}
+
+
+/* Start a new cycle in the interval core of a thread */
+static void X86ThreadCycleInterval(X86Thread *self)
+{
+	X86Context *ctx = self->ctx;
+
+	/* New cycle */
+	interval_core_cycle(self->interval, asTiming(self->cpu)->cycle);
+
+	/* A context signaled for eviction leaves the thread once its accesses
+	 * complete. */
+	if (ctx && ctx->evict_signal && X86ThreadIsPipelineEmpty(self))
+		X86ThreadEvictContext(self, ctx);
+}
+
+
+/* Dispatch instructions of the thread until 'quantum' uops are dispatched or
+ * the interval core stalls. The function returns the number of uops
+ * dispatched. */
+static int X86ThreadDispatchInterval(X86Thread *self, int quantum)
+{
+	X86Cpu *cpu = self->cpu;
+	X86Core *core = self->core;
+	X86Context *ctx = self->ctx;
+	struct interval_core_t *interval = self->interval;
+	struct x86_uinst_t *uinst;
+
+	unsigned int eip;
+	unsigned int phy_addr;
+
+	int num_uops;
+	int mispred;
+
+	/* Context must be running */
+	if (!ctx || !X86ContextGetState(ctx, X86ContextRunning) || ctx->evict_signal)
+	{
+		interval_core_stall(interval, interval_stall_ctx);
+		return 0;
+	}
+
+	/* Dispatch instructions */
+	num_uops = 0;
+	interval->address_space_index = ctx->address_space_index;
+	while (num_uops < quantum && interval_core_can_dispatch(interval))
+	{
+		/* Fetch */
+		eip = ctx->regs->eip;
+		phy_addr = mmu_translate(ctx->address_space_index, eip);
+		if (!interval_core_fetch(interval, eip, phy_addr))
+			break;
+
+		/* Functional simulation. As in the fetch stage, an instruction
+		 * with no micro-instruction is represented by a 'nop'. */
+		X86ContextExecute(ctx);
+		if (!x86_uinst_list->count)
+			x86_uinst_new(ctx, x86_uinst_nop, 0, 0, 0, 0, 0, 0, 0);
+		num_uops += list_count(x86_uinst_list);
+		interval_core_dispatch(interval, list_count(x86_uinst_list));
+
+		/* Micro-instructions */
+		mispred = 0;
+		while (list_count(x86_uinst_list))
+		{
+			uinst = list_remove_at(x86_uinst_list, 0);
+			assert(uinst->opcode >= 0 && uinst->opcode < x86_uinst_opcode_count);
+
+			/* Statistics */
+			self->stats.num_committed_uinst_array[uinst->opcode]++;
+			core->stats.num_committed_uinst_array[uinst->opcode]++;
+			cpu->num_committed_uinst_array[uinst->opcode]++;
+			cpu->num_committed_uinst++;
+			ctx->inst_count++;
+
+			/* Memory accesses */
+			if (uinst->opcode == x86_uinst_load)
+				interval_core_load(interval, uinst->address,
+					mmu_translate(ctx->address_space_index,
+					uinst->address));
+			else if (uinst->opcode == x86_uinst_store)
+				interval_core_store(interval, uinst->address,
+					mmu_translate(ctx->address_space_index,
+					uinst->address));
+			else if (uinst->opcode == x86_uinst_prefetch)
+				interval_core_prefetch(interval, uinst->address,
+					mmu_translate(ctx->address_space_index,
+					uinst->address));
+
+			/* Branches */
+			if (!(x86_uinst_info[uinst->opcode].flags & X86_UINST_CTRL))
+			{
+				x86_uinst_free(uinst);
+				continue;
+			}
+			mispred = X86ThreadPredictInterval(self, uinst, eip);
+			interval_core_branch(interval, mispred);
+			self->stats.num_branch_uinst++;
+			core->stats.num_branch_uinst++;
+			cpu->num_branch_uinst++;
+			if (mispred)
+			{
+				self->stats.num_mispred_branch_uinst++;
+				core->stats.num_mispred_branch_uinst++;
+				cpu->num_mispred_branch_uinst++;
+			}
+		}
+
+		/* Statistics */
+		self->last_commit_cycle = asTiming(cpu)->cycle;
+		self->stats.num_committed_inst++;
+		cpu->num_committed_inst++;
+
+		/* Stop after a misprediction, or if the instruction caused the
+		 * context to suspend or finish. */
+		if (mispred || !X86ContextGetState(ctx, X86ContextRunning))
+			break;
+	}
+
+	/* Return dispatched uops */
+	return num_uops;
+}
+
+
+
+
+/*
+ * Class 'X86Core'
+ */
+
+static void X86CoreRunInterval(X86Core *self)
+{
+	X86Thread *thread;
+
+	int skip = x86_cpu_num_threads;
+	int quantum = x86_cpu_dispatch_width;
+	int num_uops;
+	int i;
+
+	/* New cycle for all threads */
+	for (i = 0; i < x86_cpu_num_threads; i++)
+		X86ThreadCycleInterval(self->threads[i]);
+
+	/* The threads share the dispatch width of the core, as in the dispatch
+	 * stage. With a shared dispatch, threads take turns to dispatch one
+	 * instruction each. With a time-sliced dispatch, the first thread that
+	 * can dispatch takes the whole width. */
+	switch (x86_cpu_dispatch_kind)
+	{
+
+	case x86_cpu_dispatch_kind_shared:
+
+		do
+		{
+			self->dispatch_current = (self->dispatch_current + 1) % x86_cpu_num_threads;
+			thread = self->threads[self->dispatch_current];
+			num_uops = X86ThreadDispatchInterval(thread, 1);
+			skip = num_uops ? x86_cpu_num_threads : skip - 1;
+			quantum -= num_uops;
+		} while (quantum > 0 && skip);
+		break;
+
+	case x86_cpu_dispatch_kind_timeslice:
+
+		do
+		{
+			self->dispatch_current = (self->dispatch_current + 1) % x86_cpu_num_threads;
+			thread = self->threads[self->dispatch_current];
+			skip--;
+		} while (!X86ThreadDispatchInterval(thread, quantum) && skip);
+		break;
+	}
+}
+
+
+
+
+/*
+ * Class 'X86Cpu'
+ */
+
+/* Run one cycle of the interval core model, replacing the pipeline stages */
+void X86CpuRunInterval(X86Cpu *self)
+{
+	int i;
+
+	/* Context scheduler */
+	X86CpuSchedule(self);
+
+	/* Cores */
+	for (i = 0; i < x86_cpu_num_cores; i++)
+		X86CoreRunInterval(self->cores[i]);
+}
@@ -18,11 +18,14 @@
  */
 
 
+#include <arch/x86/emu/context.h>
 #include <lib/esim/trace.h>
 #include <lib/util/debug.h>
 #include <lib/util/linked-list.h>
+#include <lib/util/misc.h>
 #include <mem-system/mmu.h>
 #include <mem-system/module.h>
+#include <mem-system/tlb.h>
 
 #include "core.h"
 #include "cpu.h"
@@ -40,21 +43,36 @@
  * Class 'X86Thread'
  */
 
+/* Access the data module for memory uop 'uop'. If the thread has a data TLB,
+ * the access goes through it first. */
+static void X86ThreadAccessDataMod(X86Thread *self, struct x86_uop_t *uop,
+	enum mod_access_kind_t access_kind, struct mod_client_info_t *client_info)
+{
+	X86Core *core = self->core;
+
+	if (self->data_tlb)
+		tlb_access(self->data_tlb, self->data_mod, access_kind,
+			uop->ctx->address_space_index, uop->uinst->address,
+			uop->phy_addr, NULL, core->event_queue->mem_list, uop, client_info);
+	else
+		mod_access(self->data_mod, access_kind, uop->phy_addr, NULL,
+			core->event_queue->mem_list, uop, client_info);
+}
+
+
 static int X86ThreadIssueSQ(X86Thread *self, int quantum)
 {
 	X86Cpu *cpu = self->cpu;
 	X86Core *core = self->core;
 
 	struct x86_uop_t *store;
-	struct linked_list_t *sq = self->sq;
 	struct mod_client_info_t *client_info;
 
 	/* Process SQ */
-	linked_list_head(sq);
-	while (!linked_list_is_end(sq) && quantum)
+	while (self->sq_list_head && quantum)
 	{
 		/* Get store */
-		store = linked_list_get(sq);
+		store = self->sq_list_head;
 		assert(store->uinst->opcode == x86_uinst_store);
 
 		/* Only committed stores issue */
@@ -66,15 +84,14 @@ static int X86ThreadIssueSQ(X86Thread *self, int quantum)
 			break;
 
 		/* Remove store from store queue */
-		X86ThreadRemoveFromSQ(self);
+		X86ThreadRemoveFromSQ(self, store);
 
 		/* create and fill the mod_client_info_t object */
 		client_info = mod_client_info_create(self->data_mod);
 		client_info->prefetcher_eip = store->eip;
 
 		/* Issue store */
-		mod_access(self->data_mod, mod_access_store,
-		       store->phy_addr, NULL, core->event_queue, store, client_info);
+		X86ThreadAccessDataMod(self, store, mod_access_store, client_info);
 
 		/* The cache system will place the store at the head of the
 		 * event queue when it is ready. For now, mark "in_event_queue" to
@@ -84,14 +101,14 @@ static int X86ThreadIssueSQ(X86Thread *self, int quantum)
 		store->issue_when = asTiming(cpu)->cycle;
 	
 		/* Statistics */
-		core->num_issued_uinst_array[store->uinst->opcode]++;
-		core->lsq_reads++;
-		core->reg_file_int_reads += store->ph_int_idep_count;
-		core->reg_file_fp_reads += store->ph_fp_idep_count;
-		self->num_issued_uinst_array[store->uinst->opcode]++;
-		self->lsq_reads++;
-		self->reg_file_int_reads += store->ph_int_idep_count;
-		self->reg_file_fp_reads += store->ph_fp_idep_count;
+		core->stats.num_issued_uinst_array[store->uinst->opcode]++;
+		core->stats.lsq_reads++;
+		core->stats.reg_file_int_reads += store->ph_int_idep_count;
+		core->stats.reg_file_fp_reads += store->ph_fp_idep_count;
+		self->stats.num_issued_uinst_array[store->uinst->opcode]++;
+		self->stats.lsq_reads++;
+		self->stats.reg_file_int_reads += store->ph_int_idep_count;
+		self->stats.reg_file_fp_reads += store->ph_fp_idep_count;
 		cpu->num_issued_uinst_array[store->uinst->opcode]++;
 		if (store->trace_cache)
 			self->trace_cache->num_issued_uinst++;
@@ -112,58 +129,77 @@ static int X86ThreadIssueLQ(X86Thread *self, int quant)
 	X86Core *core = self->core;
 	X86Cpu *cpu = self->cpu;
 
-	struct linked_list_t *lq = self->lq;
 	struct x86_uop_t *load;
+	struct x86_uop_t *next;
 	struct mod_client_info_t *client_info;
 
-	/* Process lq */
-	linked_list_head(lq);
-	while (!linked_list_is_end(lq) && quant)
+	enum x86_lsq_load_action_t action;
+	int ready_count;
+
+	/* Process lq, up to its last ready load */
+	ready_count = self->lq_ready_count;
+	for (load = self->lq_list_head; load && quant && ready_count; load = next)
 	{
 		/* Get element from load queue. If it is not ready, go to the next one */
-		load = linked_list_get(lq);
-		if (!load->ready && !X86ThreadIsUopReady(self, load))
-		{
-			linked_list_next(lq);
+		next = load->lq_list_next;
+		if (!load->ready)
+			continue;
+		ready_count--;
+
+		/* Check dependences with older stores */
+		action = X86ThreadGetLoadAction(self, load);
+		if (action == x86_lsq_load_wait)
 			continue;
-		}
-		load->ready = 1;
 
 		/* Check that memory system is accessible */
-		if (!mod_can_access(self->data_mod, load->phy_addr))
-		{
-			linked_list_next(lq);
+		if (action == x86_lsq_load_access &&
+				!mod_can_access(self->data_mod, load->phy_addr))
 			continue;
-		}
 
 		/* Remove from load queue */
 		assert(load->uinst->opcode == x86_uinst_load);
-		X86ThreadRemoveFromLQ(self);
+		X86ThreadRemoveFromLQ(self, load);
 
-		/* create and fill the mod_client_info_t object */
-		client_info = mod_client_info_create(self->data_mod);
-		client_info->prefetcher_eip = load->eip;
+		if (action == x86_lsq_load_forward)
+		{
+			/* The data is taken from the store queue, and the load
+			 * completes in the next cycle. */
+			X86CoreCompleteInEventQueue(core, load);
+		}
+		else
+		{
+			/* create and fill the mod_client_info_t object */
+			client_info = mod_client_info_create(self->data_mod);
+			client_info->prefetcher_eip = load->eip;
 
-		/* Access memory system */
-		mod_access(self->data_mod, mod_access_load,
-			load->phy_addr, NULL, core->event_queue, load, client_info);
+			/* Access memory system */
+			X86ThreadAccessDataMod(self, load, mod_access_load, client_info);
+
+			/* The cache system will place the load at the head of the
+			 * event queue when it is ready. For now, mark "in_event_queue" to
+			 * prevent the uop from being freed. */
+			load->in_event_queue = 1;
+		}
+
+		/* A load that violated a memory dependence is replayed. Refilling
+		 * the pipeline with the instructions after it is modeled as a
+		 * fetch stall. */
+		if (load->lsq_violation)
+			self->fetch_stall_until = MAX(self->fetch_stall_until,
+				asTiming(cpu)->cycle + x86_lsq_replay_penalty);
 
-		/* The cache system will place the load at the head of the
-		 * event queue when it is ready. For now, mark "in_event_queue" to
-		 * prevent the uop from being freed. */
-		load->in_event_queue = 1;
 		load->issued = 1;
 		load->issue_when = asTiming(cpu)->cycle;
 		
 		/* Statistics */
-		core->num_issued_uinst_array[load->uinst->opcode]++;
-		core->lsq_reads++;
-		core->reg_file_int_reads += load->ph_int_idep_count;
-		core->reg_file_fp_reads += load->ph_fp_idep_count;
-		self->num_issued_uinst_array[load->uinst->opcode]++;
-		self->lsq_reads++;
-		self->reg_file_int_reads += load->ph_int_idep_count;
-		self->reg_file_fp_reads += load->ph_fp_idep_count;
+		core->stats.num_issued_uinst_array[load->uinst->opcode]++;
+		core->stats.lsq_reads++;
+		core->stats.reg_file_int_reads += load->ph_int_idep_count;
+		core->stats.reg_file_fp_reads += load->ph_fp_idep_count;
+		self->stats.num_issued_uinst_array[load->uinst->opcode]++;
+		self->stats.lsq_reads++;
+		self->stats.reg_file_int_reads += load->ph_int_idep_count;
+		self->stats.reg_file_fp_reads += load->ph_fp_idep_count;
 		cpu->num_issued_uinst_array[load->uinst->opcode]++;
 		if (load->trace_cache)
 			self->trace_cache->num_issued_uinst++;
@@ -172,7 +208,7 @@ static int X86ThreadIssueLQ(X86Thread *self, int quant)
 		quant--;
 		
 		/* MMU statistics */
-		if (*mmu_report_file_name)
+		if (*mmu_report_file_name && action == x86_lsq_load_access)
 			mmu_access_page(load->phy_addr, mmu_access_read);
 
 		/* Trace */
@@ -189,20 +225,21 @@ static int X86ThreadIssuePreQ(X86Thread *self, int quantum)
 	X86Core *core = self->core;
 	X86Cpu *cpu = self->cpu;
 
-	struct linked_list_t *preq = self->preq;
 	struct x86_uop_t *prefetch;
+	struct x86_uop_t *next;
 
-	/* Process preq */
-	linked_list_head(preq);
-	while (!linked_list_is_end(preq) && quantum)
+	int ready_count;
+
+	/* Process preq, up to its last ready prefetch */
+	ready_count = self->preq_ready_count;
+	for (prefetch = self->preq_list_head; prefetch && quantum && ready_count;
+		prefetch = next)
 	{
 		/* Get element from prefetch queue. If it is not ready, go to the next one */
-		prefetch = linked_list_get(preq);
-		if (!prefetch->ready && !X86ThreadIsUopReady(self, prefetch))
-		{
-			linked_list_next(preq);
+		next = prefetch->preq_list_next;
+		if (!prefetch->ready)
 			continue;
-		}
+		ready_count--;
 
 		/* 
 		 * Make sure its not been prefetched recently. This is just to avoid unnecessary
@@ -214,28 +251,22 @@ static int X86ThreadIssuePreQ(X86Thread *self, int quantum)
 		{
 			/* remove from queue. do not prefetch. */
 			assert(prefetch->uinst->opcode == x86_uinst_prefetch);
-			X86ThreadRemovePreQ(self);
+			X86ThreadRemovePreQ(self, prefetch);
 			prefetch->completed = 1;
 			x86_uop_free_if_not_queued(prefetch);
 			continue;
 		}
 
-		prefetch->ready = 1;
-
 		/* Check that memory system is accessible */
 		if (!mod_can_access(self->data_mod, prefetch->phy_addr))
-		{
-			linked_list_next(preq);
 			continue;
-		}
 
 		/* Remove from prefetch queue */
 		assert(prefetch->uinst->opcode == x86_uinst_prefetch);
-		X86ThreadRemovePreQ(self);
+		X86ThreadRemovePreQ(self, prefetch);
 
 		/* Access memory system */
-		mod_access(self->data_mod, mod_access_prefetch,
-			prefetch->phy_addr, NULL, core->event_queue, prefetch, NULL);
+		X86ThreadAccessDataMod(self, prefetch, mod_access_prefetch, NULL);
 
 		/* Record prefetched address */
 		prefetch_history_record(core->prefetch_history, prefetch->phy_addr);
@@ -248,14 +279,14 @@ static int X86ThreadIssuePreQ(X86Thread *self, int quantum)
 		prefetch->issue_when = asTiming(cpu)->cycle;
 		
 		/* Statistics */
-		core->num_issued_uinst_array[prefetch->uinst->opcode]++;
-		core->lsq_reads++;
-		core->reg_file_int_reads += prefetch->ph_int_idep_count;
-		core->reg_file_fp_reads += prefetch->ph_fp_idep_count;
-		self->num_issued_uinst_array[prefetch->uinst->opcode]++;
-		self->lsq_reads++;
-		self->reg_file_int_reads += prefetch->ph_int_idep_count;
-		self->reg_file_fp_reads += prefetch->ph_fp_idep_count;
+		core->stats.num_issued_uinst_array[prefetch->uinst->opcode]++;
+		core->stats.lsq_reads++;
+		core->stats.reg_file_int_reads += prefetch->ph_int_idep_count;
+		core->stats.reg_file_fp_reads += prefetch->ph_fp_idep_count;
+		self->stats.num_issued_uinst_array[prefetch->uinst->opcode]++;
+		self->stats.lsq_reads++;
+		self->stats.reg_file_int_reads += prefetch->ph_int_idep_count;
+		self->stats.reg_file_fp_reads += prefetch->ph_fp_idep_count;
 		cpu->num_issued_uinst_array[prefetch->uinst->opcode]++;
 		if (prefetch->trace_cache)
 			self->trace_cache->num_issued_uinst++;
@@ -281,24 +312,23 @@ static int X86ThreadIssueIQ(X86Thread *self, int quant)
 	X86Cpu *cpu = self->cpu;
 	X86Core *core = self->core;
 
-	struct linked_list_t *iq = self->iq;
 	struct x86_uop_t *uop;
+	struct x86_uop_t *next;
 	int lat;
 
-	/* Find instruction to issue */
-	linked_list_head(iq);
-	while (!linked_list_is_end(iq) && quant)
+	int ready_count;
+
+	/* Find instruction to issue, up to the last ready one */
+	ready_count = self->iq_ready_count;
+	for (uop = self->iq_list_head; uop && quant && ready_count; uop = next)
 	{
 		/* Get element from IQ */
-		uop = linked_list_get(iq);
+		next = uop->iq_list_next;
 		assert(x86_uop_exists(uop));
 		assert(!(uop->flags & X86_UINST_MEM));
-		if (!uop->ready && !X86ThreadIsUopReady(self, uop))
-		{
-			linked_list_next(iq);
+		if (!uop->ready)
 			continue;
-		}
-		uop->ready = 1;  /* avoid next call to 'X86ThreadIsUopReady' */
+		ready_count--;
 		
 		/* Run the instruction in its corresponding functional unit.
 		 * If the instruction does not require a functional unit, 'X86CoreReserveFunctionalUnit'
@@ -306,14 +336,11 @@ static int X86ThreadIssueIQ(X86Thread *self, int quant)
 		 * 'X86CoreReserveFunctionalUnit' returns 0. */
 		lat = X86CoreReserveFunctionalUnit(core, uop);
 		if (!lat)
-		{
-			linked_list_next(iq);
 			continue;
-		}
 		
 		/* Instruction was issued to the corresponding fu.
 		 * Remove it from IQ */
-		X86ThreadRemoveFromIQ(self);
+		X86ThreadRemoveFromIQ(self, uop);
 		
 		/* Schedule inst in Event Queue */
 		assert(!uop->in_event_queue);
@@ -324,14 +351,14 @@ static int X86ThreadIssueIQ(X86Thread *self, int quant)
 		X86CoreInsertInEventQueue(core, uop);
 		
 		/* Statistics */
-		core->num_issued_uinst_array[uop->uinst->opcode]++;
-		core->iq_reads++;
-		core->reg_file_int_reads += uop->ph_int_idep_count;
-		core->reg_file_fp_reads += uop->ph_fp_idep_count;
-		self->num_issued_uinst_array[uop->uinst->opcode]++;
-		self->iq_reads++;
-		self->reg_file_int_reads += uop->ph_int_idep_count;
-		self->reg_file_fp_reads += uop->ph_fp_idep_count;
+		core->stats.num_issued_uinst_array[uop->uinst->opcode]++;
+		core->stats.iq_reads++;
+		core->stats.reg_file_int_reads += uop->ph_int_idep_count;
+		core->stats.reg_file_fp_reads += uop->ph_fp_idep_count;
+		self->stats.num_issued_uinst_array[uop->uinst->opcode]++;
+		self->stats.iq_reads++;
+		self->stats.reg_file_int_reads += uop->ph_int_idep_count;
+		self->stats.reg_file_fp_reads += uop->ph_fp_idep_count;
 		cpu->num_issued_uinst_array[uop->uinst->opcode]++;
 		if (uop->trace_cache)
 			self->trace_cache->num_issued_uinst++;
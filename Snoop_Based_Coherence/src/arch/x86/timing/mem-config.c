@@ -19,12 +19,14 @@
 
 
 #include <arch/common/arch.h>
+#include <arch/common/interval.h>
 #include <lib/util/config.h>
 #include <lib/util/debug.h>
 #include <lib/util/linked-list.h>
 #include <lib/util/string.h>
 #include <mem-system/mem-system.h>
 #include <mem-system/module.h>
+#include <mem-system/tlb.h>
 
 #include "core.h"
 #include "cpu.h"
@@ -125,6 +127,9 @@ void X86CpuMemConfigParseEntry(Timing *self, struct config_t *config, char *sect
 	char *data_module_name;
 	char *inst_module_name;
 
+	char *data_tlb_name;
+	char *inst_tlb_name;
+
 	/* Get configuration file name */
 	file_name = config_get_file_name(config);
 
@@ -210,7 +215,38 @@ void X86CpuMemConfigParseEntry(Timing *self, struct config_t *config, char *sect
 			"\tThe given module name must match a module declared in a section\n"
 			"\t[Module <name>] in the memory configuration file.\n",
 			file_name, section, inst_module_name);
+
+	/* Assign TLBs, optional */
+	data_tlb_name = config_read_string(config, section, "DataTLB", "");
+	inst_tlb_name = config_read_string(config, section, "InstTLB", "");
+	if (*data_tlb_name)
+	{
+		thread->data_tlb = mem_system_get_tlb(data_tlb_name);
+		if (!thread->data_tlb)
+			fatal("%s: section [%s]: '%s' is not a valid TLB name.\n"
+				"\tThe given TLB name must match a TLB declared in a section\n"
+				"\t[TLB <name>] in the memory configuration file.\n",
+				file_name, section, data_tlb_name);
+	}
+	if (*inst_tlb_name)
+	{
+		thread->inst_tlb = mem_system_get_tlb(inst_tlb_name);
+		if (!thread->inst_tlb)
+			fatal("%s: section [%s]: '%s' is not a valid TLB name.\n"
+				"\tThe given TLB name must match a TLB declared in a section\n"
+				"\t[TLB <name>] in the memory configuration file.\n",
+				file_name, section, inst_tlb_name);
+	}
 	
+	/* Entries of the interval core model */
+	if (thread->interval)
+	{
+		thread->interval->data_mod = thread->data_mod;
+		thread->interval->inst_mod = thread->inst_mod;
+		thread->interval->data_tlb = thread->data_tlb;
+		thread->interval->inst_tlb = thread->inst_tlb;
+	}
+
 	/* Add modules to entry list */
 	linked_list_add(arch_x86->mem_entry_mod_list, thread->data_mod);
 	if (thread->data_mod != thread->inst_mod)
@@ -220,6 +256,10 @@ void X86CpuMemConfigParseEntry(Timing *self, struct config_t *config, char *sect
 	mem_debug("\tx86 Core %d, Thread %d\n", core_index, thread_index);
 	mem_debug("\t\tEntry for instructions -> %s\n", thread->inst_mod->name);
 	mem_debug("\t\tEntry for data -> %s\n", thread->data_mod->name);
+	if (thread->inst_tlb)
+		mem_debug("\t\tTLB for instructions -> %s\n", thread->inst_tlb->name);
+	if (thread->data_tlb)
+		mem_debug("\t\tTLB for data -> %s\n", thread->data_tlb->name);
 	mem_debug("\n");
 }
 
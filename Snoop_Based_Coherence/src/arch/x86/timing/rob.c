@@ -18,8 +18,8 @@
  */
 
 
+#include <lib/mhandle/mhandle.h>
 #include <lib/util/debug.h>
-#include <lib/util/list.h>
 
 #include "core.h"
 #include "cpu.h"
@@ -77,9 +77,7 @@ void X86CoreInitROB(X86Core *self)
 
 	/* Create ROBs */
 	x86_rob_total_size = x86_rob_size * x86_cpu_num_threads;
-	self->rob = list_create_with_size(x86_rob_total_size);
-	for (i = 0; i < x86_rob_total_size; i++)
-		list_add(self->rob, NULL);
+	self->rob = xcalloc(x86_rob_total_size, sizeof(struct x86_uop_t *));
 }
 
 
@@ -88,17 +86,16 @@ void X86CoreFreeROB(X86Core *self)
 	int i;
 	struct x86_uop_t *uop;
 
-	assert(list_count(self->rob) == x86_rob_total_size);
 	for (i = 0; i < x86_rob_total_size; i++)
 	{
-		uop = list_get(self->rob, i);
+		uop = self->rob[i];
 		if (uop)
 		{
 			uop->in_rob = 0;
 			x86_uop_free_if_not_queued(uop);
 		}
 	}
-	list_free(self->rob);
+	free(self->rob);
 }
 
 
@@ -110,7 +107,7 @@ static void X86CoreTrimROB(X86Core *self)
 	/* Trim head */
 	while (self->rob_count)
 	{
-		uop = list_get(self->rob, self->rob_head);
+		uop = self->rob[self->rob_head];
 		if (uop)
 			break;
 		self->rob_head = self->rob_head == x86_rob_total_size - 1 ?
@@ -122,7 +119,7 @@ static void X86CoreTrimROB(X86Core *self)
 	while (self->rob_count)
 	{
 		idx = self->rob_tail ? self->rob_tail - 1 : x86_rob_total_size - 1;
-		uop = list_get(self->rob, idx);
+		uop = self->rob[idx];
 		if (uop)
 			break;
 		self->rob_tail = idx;
@@ -150,7 +147,7 @@ void X86CoreDumpROB(X86Core *self, FILE *f)
 				thread->rob_count, x86_rob_size);
 			for (j = thread->rob_left_bound; j <= thread->rob_right_bound; j++)
 			{
-				uop = list_get(self->rob, j);
+				uop = self->rob[j];
 				fprintf(f, "   %c%c ",
 					j == thread->rob_head ? 'H' : ' ',
 					j == thread->rob_tail ? 'T' : ' ');
@@ -173,7 +170,7 @@ void X86CoreDumpROB(X86Core *self, FILE *f)
 		X86CoreTrimROB(self);
 		for (j = 0; j < x86_rob_total_size; j++)
 		{
-			uop = list_get(self->rob, j);
+			uop = self->rob[j];
 			fprintf(f, " %c%c ",
 				j == self->rob_head ? 'H' : ' ',
 				j == self->rob_tail ? 'T' : ' ');
@@ -222,7 +219,7 @@ int X86ThreadCanDequeueFromROB(X86Thread *self)
 		if (!core->rob_count)
 			return 0;
 
-		uop = list_get(core->rob, core->rob_head);
+		uop = core->rob[core->rob_head];
 		assert(x86_uop_exists(uop));
 		if (uop->thread == self)
 			return 1;
@@ -245,7 +242,7 @@ struct x86_uop_t *X86ThreadGetROBHead(X86Thread *self)
 
 		if (self->rob_count > 0)
 		{
-			uop = list_get(core->rob, self->rob_head);
+			uop = core->rob[self->rob_head];
 			return uop;
 		}
 		break;
@@ -259,7 +256,7 @@ struct x86_uop_t *X86ThreadGetROBHead(X86Thread *self)
 		for (i = 0; i < core->rob_count; i++)
 		{
 			idx = (core->rob_head + i) % x86_rob_total_size;
-			uop = list_get(core->rob, idx);
+			uop = core->rob[idx];
 			if (uop && uop->thread == self)
 				return uop;
 		}
@@ -281,10 +278,10 @@ void X86ThreadRemoveROBHead(X86Thread *self)
 	case x86_rob_kind_private:
 
 		assert(self->rob_count > 0);
-		uop = list_get(core->rob, self->rob_head);
+		uop = core->rob[self->rob_head];
 		assert(x86_uop_exists(uop));
 		assert(uop->thread == self);
-		list_set(core->rob, self->rob_head, NULL);
+		core->rob[self->rob_head] = NULL;
 		self->rob_head = self->rob_head == self->rob_right_bound ?
 			self->rob_left_bound : self->rob_head + 1;
 		self->rob_count--;
@@ -296,10 +293,10 @@ void X86ThreadRemoveROBHead(X86Thread *self)
 		for (i = 0; i < core->rob_count; i++)
 		{
 			idx = (core->rob_head + i) % x86_rob_total_size;
-			uop = list_get(core->rob, idx);
+			uop = core->rob[idx];
 			if (uop && uop->thread == self)
 			{
-				list_set(core->rob, idx, NULL);
+				core->rob[idx] = NULL;
 				self->rob_count--;
 				break;
 			}
@@ -327,7 +324,7 @@ struct x86_uop_t *X86ThreadGetROBTail(X86Thread *self)
 		{
 			idx = self->rob_tail == self->rob_left_bound ?
 				self->rob_right_bound : self->rob_tail - 1;
-			uop = list_get(core->rob, idx);
+			uop = core->rob[idx];
 			return uop;
 		}
 		break;
@@ -340,7 +337,7 @@ struct x86_uop_t *X86ThreadGetROBTail(X86Thread *self)
 		for (i = core->rob_count - 1; i >= 0; i--)
 		{
 			idx = (core->rob_head + i) % x86_rob_total_size;
-			uop = list_get(core->rob, idx);
+			uop = core->rob[idx];
 			if (uop && uop->thread == self)
 				return uop;
 		}
@@ -366,14 +363,14 @@ struct x86_uop_t *X86GetROBEntry(X86Thread *self, int index)
 		index += self->rob_head;
 		if (index > self->rob_right_bound)
 			index = index - self->rob_right_bound + self->rob_left_bound - 1;
-		uop = list_get(core->rob, index);
+		uop = core->rob[index];
 		assert(uop);
 		return uop;
 	
 	case x86_rob_kind_shared:
 		X86CoreTrimROB(core);
 		index = (core->rob_head + index) % x86_rob_total_size;
-		uop = list_get(core->rob, index);
+		uop = core->rob[index];
 		assert(uop);
 		return uop;
 	}
@@ -395,10 +392,10 @@ void X86ThreadRemoveROBTail(X86Thread *self)
 		assert(self->rob_count > 0);
 		idx = self->rob_tail == self->rob_left_bound ?
 			self->rob_right_bound : self->rob_tail - 1;
-		uop = list_get(core->rob, idx);
+		uop = core->rob[idx];
 		assert(x86_uop_exists(uop));
 		assert(uop->thread == self);
-		list_set(core->rob, idx, NULL);
+		core->rob[idx] = NULL;
 		self->rob_tail = idx;
 		self->rob_count--;
 		break;
@@ -410,10 +407,10 @@ void X86ThreadRemoveROBTail(X86Thread *self)
 		for (i = core->rob_count - 1; i >= 0; i--)
 		{
 			idx = (core->rob_head + i) % x86_rob_total_size;
-			uop = list_get(core->rob, idx);
+			uop = core->rob[idx];
 			if (uop && uop->thread == self)
 			{
-				list_set(core->rob, idx, NULL);
+				core->rob[idx] = NULL;
 				self->rob_count--;
 				break;
 			}
@@ -470,8 +467,8 @@ void X86CoreEnqueueInROB(X86Core *self, struct x86_uop_t *uop)
 	case x86_rob_kind_private:
 
 		assert(thread->rob_count < x86_rob_size);
-		assert(!list_get(self->rob, thread->rob_tail));
-		list_set(self->rob, thread->rob_tail, uop);
+		assert(!self->rob[thread->rob_tail]);
+		self->rob[thread->rob_tail] = uop;
 		thread->rob_tail = thread->rob_tail == thread->rob_right_bound ?
 				thread->rob_left_bound : thread->rob_tail + 1;
 		thread->rob_count++;
@@ -481,8 +478,8 @@ void X86CoreEnqueueInROB(X86Core *self, struct x86_uop_t *uop)
 
 		X86CoreTrimROB(self);
 		assert(self->rob_count < x86_rob_total_size);
-		assert(!list_get(self->rob, self->rob_tail));
-		list_set(self->rob, self->rob_tail, uop);
+		assert(!self->rob[self->rob_tail]);
+		self->rob[self->rob_tail] = uop;
 		self->rob_tail = self->rob_tail == x86_rob_total_size - 1 ?
 			0 : self->rob_tail + 1;
 		self->rob_count++;
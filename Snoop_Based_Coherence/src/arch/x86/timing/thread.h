@@ -62,6 +62,32 @@ CLASS_BEGIN(X86Thread, Object)
 	/* Number of uops in private structures */
 	int iq_count;
 	int lsq_count;
+
+	/* Double-linked lists of uops in the instruction queue, load queue,
+	 * store queue, and prefetch queue, in dispatch order. Uops are linked
+	 * through their own fields, so no memory is allocated on insertion. */
+	struct x86_uop_t *iq_list_head;
+	struct x86_uop_t *iq_list_tail;
+	int iq_list_count;
+	int iq_list_max;
+	struct x86_uop_t *lq_list_head;
+	struct x86_uop_t *lq_list_tail;
+	int lq_list_count;
+	int lq_list_max;
+	struct x86_uop_t *sq_list_head;
+	struct x86_uop_t *sq_list_tail;
+	int sq_list_count;
+	int sq_list_max;
+	struct x86_uop_t *preq_list_head;
+	struct x86_uop_t *preq_list_tail;
+	int preq_list_count;
+	int preq_list_max;
+
+	/* Number of ready uops in the IQ, load queue, and prefetch queue. The
+	 * issue stage stops scanning a queue once it visited all of them. */
+	int iq_ready_count;
+	int lq_ready_count;
+	int preq_ready_count;
 	int reg_file_int_count;
 	int reg_file_fp_count;
 	int reg_file_xmm_count;
@@ -69,10 +95,8 @@ CLASS_BEGIN(X86Thread, Object)
 	/* Private structures */
 	struct list_t *fetch_queue;
 	struct list_t *uop_queue;
-	struct linked_list_t *iq;
-	struct linked_list_t *lq;
-	struct linked_list_t *sq;
-	struct linked_list_t *preq;
+	int *store_set_table;  /* Store set ID table, indexed by eip */
+	long long store_set_clear_when;  /* Cycle of next store set table reset */
 	struct x86_bpred_t *bpred;  /* branch predictor */
 	struct x86_trace_cache_t *trace_cache;  /* trace cache */
 	struct x86_reg_file_t *reg_file;  /* physical register file */
@@ -89,61 +113,71 @@ CLASS_BEGIN(X86Thread, Object)
 	/* Entries to the memory system */
 	struct mod_t *data_mod;  /* Entry for data */
 	struct mod_t *inst_mod;  /* Entry for instructions */
+	struct tlb_t *data_tlb;  /* TLB for data, or NULL */
+	struct tlb_t *inst_tlb;  /* TLB for instructions, or NULL */
+
+	/* Interval core model replacing the pipeline with option
+	 * '--x86-sim interval', or NULL */
+	struct interval_core_t *interval;
 
 	/* Cycle in which last micro-instruction committed */
 	long long last_commit_cycle;
 
-	/* Statistics */
-	long long num_fetched_uinst;
-	long long num_dispatched_uinst_array[x86_uinst_opcode_count];
-	long long num_issued_uinst_array[x86_uinst_opcode_count];
-	long long num_committed_uinst_array[x86_uinst_opcode_count];
-	long long num_squashed_uinst;
-	long long num_branch_uinst;
-	long long num_mispred_branch_uinst;
-	
-	/* Statistics for structures */
-	long long rob_occupancy;
-	long long rob_full;
-	long long rob_reads;
-	long long rob_writes;
-
-	long long iq_occupancy;
-	long long iq_full;
-	long long iq_reads;
-	long long iq_writes;
-	long long iq_wakeup_accesses;
-
-	long long lsq_occupancy;
-	long long lsq_full;
-	long long lsq_reads;
-	long long lsq_writes;
-	long long lsq_wakeup_accesses;
-
-	long long reg_file_int_occupancy;
-	long long reg_file_int_full;
-	long long reg_file_int_reads;
-	long long reg_file_int_writes;
-
-	long long reg_file_fp_occupancy;
-	long long reg_file_fp_full;
-	long long reg_file_fp_reads;
-	long long reg_file_fp_writes;
-
-	long long reg_file_xmm_occupancy;
-	long long reg_file_xmm_full;
-	long long reg_file_xmm_reads;
-	long long reg_file_xmm_writes;
-
-	long long rat_int_reads;
-	long long rat_int_writes;
-	long long rat_fp_reads;
-	long long rat_fp_writes;
-	long long rat_xmm_reads;
-	long long rat_xmm_writes;
-
-	long long btb_reads;
-	long long btb_writes;
+	/* Statistics, reset by 'X86CpuResetStats' */
+	struct
+	{
+		long long num_fetched_uinst;
+		long long num_dispatched_uinst_array[x86_uinst_opcode_count];
+		long long num_issued_uinst_array[x86_uinst_opcode_count];
+		long long num_committed_uinst_array[x86_uinst_opcode_count];
+		long long num_committed_inst;
+		long long num_squashed_uinst;
+		long long num_branch_uinst;
+		long long num_mispred_branch_uinst;
+
+		/* Statistics for structures */
+		long long rob_occupancy;
+		long long rob_full;
+		long long rob_reads;
+		long long rob_writes;
+
+		long long iq_occupancy;
+		long long iq_full;
+		long long iq_reads;
+		long long iq_writes;
+		long long iq_wakeup_accesses;
+
+		long long lsq_occupancy;
+		long long lsq_full;
+		long long lsq_reads;
+		long long lsq_writes;
+		long long lsq_wakeup_accesses;
+
+		long long reg_file_int_occupancy;
+		long long reg_file_int_full;
+		long long reg_file_int_reads;
+		long long reg_file_int_writes;
+
+		long long reg_file_fp_occupancy;
+		long long reg_file_fp_full;
+		long long reg_file_fp_reads;
+		long long reg_file_fp_writes;
+
+		long long reg_file_xmm_occupancy;
+		long long reg_file_xmm_full;
+		long long reg_file_xmm_reads;
+		long long reg_file_xmm_writes;
+
+		long long rat_int_reads;
+		long long rat_int_writes;
+		long long rat_fp_reads;
+		long long rat_fp_writes;
+		long long rat_xmm_reads;
+		long long rat_xmm_writes;
+
+		long long btb_reads;
+		long long btb_writes;
+	} stats;
 
 CLASS_END(X86Thread)
 
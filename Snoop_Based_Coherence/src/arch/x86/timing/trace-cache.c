@@ -18,6 +18,8 @@
  */
 
 
+#include <string.h>
+
 #include <arch/x86/emu/context.h>
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/config.h>
@@ -94,6 +96,22 @@ void X86ThreadDumpTraceCacheReport(X86Thread *self, FILE *f)
 }
 
 
+void X86ThreadResetTraceCacheStats(X86Thread *self)
+{
+	struct x86_trace_cache_t *trace_cache = self->trace_cache;
+
+	trace_cache->accesses = 0;
+	trace_cache->hits = 0;
+	trace_cache->num_fetched_uinst = 0;
+	trace_cache->num_dispatched_uinst = 0;
+	trace_cache->num_issued_uinst = 0;
+	trace_cache->num_committed_uinst = 0;
+	trace_cache->num_squashed_uinst = 0;
+	trace_cache->trace_length_acc = 0;
+	trace_cache->trace_length_count = 0;
+}
+
+
 /* Dump branch prediction sequence */
 static void x86_trace_cache_pred_dump(int pred, int num, FILE *f)
 {
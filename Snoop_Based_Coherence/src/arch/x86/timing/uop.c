@@ -19,20 +19,68 @@
 
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/list.h>
-#include <lib/util/linked-list.h>
 
 #include "uop.h"
 
 
 #define UOP_MAGIC  0x10101010U
 
+/* Uops are allocated in blocks of this many, and freed uops are kept in a
+ * free list to be reused instead of being returned to the heap. */
+#define UOP_POOL_BLOCK_SIZE  1024
+
+static struct list_t *x86_uop_pool_block_list;
+static struct list_t *x86_uop_pool_free_list;
+
+
+static void x86_uop_pool_grow(void)
+{
+	struct x86_uop_t *block;
+	int i;
+
+	/* Create pool */
+	if (!x86_uop_pool_block_list)
+	{
+		x86_uop_pool_block_list = list_create();
+		x86_uop_pool_free_list = list_create_with_size(UOP_POOL_BLOCK_SIZE);
+	}
+
+	/* New block. Uops are pushed in reverse order so that they are popped
+	 * from the free list in increasing addresses. */
+	block = xmalloc(UOP_POOL_BLOCK_SIZE * sizeof(struct x86_uop_t));
+	list_add(x86_uop_pool_block_list, block);
+	for (i = UOP_POOL_BLOCK_SIZE - 1; i >= 0; i--)
+		list_push(x86_uop_pool_free_list, &block[i]);
+}
+
+
+void x86_uop_pool_free(void)
+{
+	int i;
+
+	if (!x86_uop_pool_block_list)
+		return;
+
+	LIST_FOR_EACH(x86_uop_pool_block_list, i)
+		free(list_get(x86_uop_pool_block_list, i));
+	list_free(x86_uop_pool_block_list);
+	list_free(x86_uop_pool_free_list);
+	x86_uop_pool_block_list = NULL;
+	x86_uop_pool_free_list = NULL;
+}
+
 
 struct x86_uop_t *x86_uop_create(void)
 {
 	struct x86_uop_t *uop;
 
+	/* Take from pool */
+	if (!x86_uop_pool_free_list || !list_count(x86_uop_pool_free_list))
+		x86_uop_pool_grow();
+	uop = list_pop(x86_uop_pool_free_list);
+
 	/* Initialize */
-	uop = xcalloc(1, sizeof(struct x86_uop_t));
+	memset(uop, 0, sizeof(struct x86_uop_t));
 	uop->magic = UOP_MAGIC;
 
 	/* Return */
@@ -43,6 +91,7 @@ struct x86_uop_t *x86_uop_create(void)
 void x86_uop_free_if_not_queued(struct x86_uop_t *uop)
 {
 	/* Do not free if 'uop' is still enqueued */
+	assert(x86_uop_exists(uop));
 	if (uop->in_fetch_queue || uop->in_uop_queue || uop->in_iq ||
 		uop->in_lq || uop->in_sq || uop->in_preq ||
 		uop->in_rob || uop->in_event_queue ||
@@ -51,10 +100,10 @@ void x86_uop_free_if_not_queued(struct x86_uop_t *uop)
 		return;
 	}
 
-	/* Free */
+	/* Return to pool */
 	uop->magic = 0;
 	x86_uinst_free(uop->uinst);
-	free(uop);
+	list_push(x86_uop_pool_free_list, uop);
 }
 
 
@@ -159,19 +208,3 @@ void x86_uop_list_dump(struct list_t *list, FILE *f)
 		fprintf(f, "\n");
 	}
 }
-
-
-void x86_uop_linked_list_dump(struct linked_list_t *uop_list, FILE *f)
-{
-	struct x86_uop_t *uop;
-	
-	linked_list_head(uop_list);
-	while (!linked_list_is_end(uop_list))
-	{
-		uop = linked_list_get(uop_list);
-		fprintf(f, "%3d. ", linked_list_current(uop_list));
-		x86_uinst_dump(uop->uinst, f);
-		fprintf(f, "\n");
-		linked_list_next(uop_list);
-	}
-}
@@ -23,6 +23,8 @@
 #include <arch/x86/emu/uinst.h>
 #include <lib/util/class.h>
 
+#include "bpred.h"
+
 
 
 /*
@@ -72,6 +74,13 @@ struct x86_uop_t
 	int ph_odep[X86_UINST_MAX_ODEPS];
 	int ph_oodep[X86_UINST_MAX_ODEPS];
 
+	/* Wakeup. Each input dependence reading a pending physical register
+	 * is linked in the wakeup list of that register. The uop becomes ready
+	 * when the last of them is written and 'wait_count' reaches 0. */
+	int wait_count;
+	struct x86_uop_t *wakeup_next[X86_UINST_MAX_IDEPS];
+	int wakeup_next_dep[X86_UINST_MAX_IDEPS];
+
 	/* Queues where instruction is */
 	int in_fetch_queue : 1;
 	int in_uop_queue : 1;
@@ -83,6 +92,31 @@ struct x86_uop_t
 	int in_rob : 1;
 	int in_uop_trace_list : 1;
 
+	/* Links in the IQ, load queue, store queue, and prefetch queue */
+	struct x86_uop_t *iq_list_prev;
+	struct x86_uop_t *iq_list_next;
+	struct x86_uop_t *lq_list_prev;
+	struct x86_uop_t *lq_list_next;
+	struct x86_uop_t *sq_list_prev;
+	struct x86_uop_t *sq_list_next;
+	struct x86_uop_t *preq_list_prev;
+	struct x86_uop_t *preq_list_next;
+
+	/* Event queue. Field 'event_queue_next' links the uop in a bucket of the
+	 * timing wheel, or in a chain of memory uops. The chain of an uop in
+	 * the wheel contains the memory uops that follow it in the queue. */
+	struct x86_uop_t *event_queue_next;
+	struct x86_uop_t *event_queue_chain_head;
+	struct x86_uop_t *event_queue_chain_tail;
+
+	/* Memory dependences. Field 'store_set' is the store set ID read from
+	 * the store set table on dispatch, or -1. The flags record why a load
+	 * was held in the load queue, so that each load is counted once. */
+	int store_set;
+	int lsq_predicted_wait : 1;
+	int lsq_forward_stall : 1;
+	int lsq_violation : 1;
+
 	/* Instruction status */
 	int ready;
 	int issued;
@@ -101,6 +135,22 @@ struct x86_uop_t
 	int bimod_index, bimod_pred;
 	int twolevel_bht_index, twolevel_pht_row, twolevel_pht_col, twolevel_pred;
 	int choice_index, choice_pred;
+
+	/* Branch prediction with TAGE, perceptron, or ITTAGE. Table indices and
+	 * tags are computed at fetch, and used at commit to update the same
+	 * entries. Field 'bpred_lookup' is set if the predictor was accessed. */
+	int bpred_lookup;
+	unsigned short bpred_index[X86_BPRED_TABLES_MAX];
+	unsigned short bpred_tag[X86_BPRED_TABLES_MAX];
+	int bpred_provider;  /* Longest matching table, or -1 */
+	int bpred_alt;  /* Second longest matching table, or -1 */
+	int bpred_provider_pred, bpred_alt_pred;
+	int bpred_provider_weak;  /* Provider entry weak and not useful */
+	int bpred_tage_pred;
+	int bpred_loop_valid, bpred_loop_used, bpred_loop_pred;
+	int bpred_sc_used, bpred_sc_pred, bpred_sc_sum;
+	int bpred_perceptron_sum;
+	unsigned int bpred_target;  /* Target predicted by ITTAGE */
 };
 
 struct x86_uop_t *x86_uop_create(void);
@@ -110,9 +160,9 @@ void x86_uop_dump(struct x86_uop_t *uop, FILE *f);
 int x86_uop_exists(struct x86_uop_t *uop);
 void x86_uop_count_deps(struct x86_uop_t *uop);
 
-struct linked_list_t;
 void x86_uop_list_dump(struct list_t *uop_list, FILE *f);
-void x86_uop_linked_list_dump(struct linked_list_t *uop_list, FILE *f);
+
+void x86_uop_pool_free(void);
 
 
 #endif
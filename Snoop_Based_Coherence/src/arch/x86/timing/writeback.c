@@ -23,6 +23,7 @@
 
 #include "core.h"
 #include "cpu.h"
+#include "event-queue.h"
 #include "recover.h"
 #include "reg-file.h"
 #include "thread.h"
@@ -45,18 +46,14 @@ void X86CoreWriteback(X86Core *self)
 
 	for (;;)
 	{
-		/* Pick element from the head of the event queue */
-		linked_list_head(self->event_queue);
-		uop = linked_list_get(self->event_queue);
+		/* Extract element from the head of the event queue. A memory uop
+		 * placed in the event queue is always complete. Other uops are
+		 * complete when uop->when is equals to current cycle. */
+		uop = X86CoreExtractFromEventQueue(self);
 		if (!uop)
 			break;
-
-		/* A memory uop placed in the event queue is always complete.
-		 * Other uops are complete when uop->when is equals to current cycle. */
 		if (uop->flags & X86_UINST_MEM)
 			uop->when = asTiming(cpu)->cycle;
-		if (uop->when > asTiming(cpu)->cycle)
-			break;
 		
 		/* Check element integrity */
 		assert(x86_uop_exists(uop));
@@ -64,10 +61,6 @@ void X86CoreWriteback(X86Core *self)
 		assert(uop->thread->core == self);
 		assert(uop->ready);
 		assert(!uop->completed);
-		
-		/* Extract element from event queue. */
-		linked_list_remove(self->event_queue);
-		uop->in_event_queue = 0;
 		thread = uop->thread;
 		
 		/* If a mispredicted branch is solved and recovery is configured to be
@@ -87,12 +80,12 @@ void X86CoreWriteback(X86Core *self)
 		/* Writeback */
 		uop->completed = 1;
 		X86ThreadWriteUop(thread, uop);
-		self->reg_file_int_writes += uop->ph_int_odep_count;
-		self->reg_file_fp_writes += uop->ph_fp_odep_count;
-		self->iq_wakeup_accesses++;
-		thread->reg_file_int_writes += uop->ph_int_odep_count;
-		thread->reg_file_fp_writes += uop->ph_fp_odep_count;
-		thread->iq_wakeup_accesses++;
+		self->stats.reg_file_int_writes += uop->ph_int_odep_count;
+		self->stats.reg_file_fp_writes += uop->ph_fp_odep_count;
+		self->stats.iq_wakeup_accesses++;
+		thread->stats.reg_file_int_writes += uop->ph_int_odep_count;
+		thread->stats.reg_file_fp_writes += uop->ph_fp_odep_count;
+		thread->stats.iq_wakeup_accesses++;
 		x86_uop_free_if_not_queued(uop);
 
 		/* Recovery. This must be performed at last, because lots of uops might be
@@ -0,0 +1,1308 @@
+/*
+ *  Libesim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <assert.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <lib/mhandle/mhandle.h>
+#include <lib/util/debug.h>
+#include <lib/util/hash-table.h>
+#include <lib/util/list.h>
+#include <lib/util/misc.h>
+#include <lib/util/string.h>
+
+#include "trace-binary.h"
+
+
+/* Distance between the positions of two consecutive blocks as returned by
+ * 'trace_reader_tell'. It must exceed the size of the largest block, which
+ * is below TRACE_BINARY_BLOCK_SIZE_MAX plus one record. */
+#define TRACE_BINARY_BLOCK_SPAN  (2LL * TRACE_BINARY_BLOCK_SIZE_MAX)
+
+/* Zigzag encoding of the difference between two numbers, mapping small
+ * positive and negative differences into small unsigned numbers. */
+#define trace_binary_zigzag(d) (((unsigned long long) (d) << 1) ^ (unsigned long long) ((long long) (d) >> 63))
+#define trace_binary_unzigzag(z) ((long long) ((z) >> 1) ^ -(long long) ((z) & 1))
+
+#define trace_binary_isidchar(c) (isalnum((c)) || (c) == '.' || (c) == '_' || (c) == '-')
+
+
+/* Split a trace line with format 'command name=value name="value" ...' into
+ * its command and symbols, writing null characters into 'line'. Return 0 if
+ * the line does not follow this syntax. */
+static int trace_binary_parse_line(char *line, char **command, int *num_symbols,
+	char **names, char **values, int *quoted)
+{
+	char *ptr = line;
+
+	/* Command */
+	while (isspace(*ptr))
+		ptr++;
+	*command = ptr;
+	while (trace_binary_isidchar(*ptr))
+		ptr++;
+	if (ptr == *command || (*ptr && !isspace(*ptr)))
+		return 0;
+	if (*ptr)
+		*ptr++ = '\0';
+
+	/* Symbols */
+	*num_symbols = 0;
+	for (;;)
+	{
+		while (isspace(*ptr))
+			ptr++;
+		if (!*ptr)
+			break;
+		if (*num_symbols == TRACE_RECORD_MAX_SYMBOLS)
+			return 0;
+
+		/* Name */
+		names[*num_symbols] = ptr;
+		while (trace_binary_isidchar(*ptr))
+			ptr++;
+		if (ptr == names[*num_symbols] || *ptr != '=')
+			return 0;
+		*ptr++ = '\0';
+
+		/* Value */
+		if (*ptr == '"')
+		{
+			values[*num_symbols] = ++ptr;
+			quoted[*num_symbols] = 1;
+			while (*ptr && *ptr != '"')
+				ptr++;
+			if (*ptr != '"')
+				return 0;
+			*ptr++ = '\0';
+		}
+		else
+		{
+			values[*num_symbols] = ptr;
+			quoted[*num_symbols] = 0;
+			while (trace_binary_isidchar(*ptr))
+				ptr++;
+		}
+		if (*ptr && !isspace(*ptr))
+			return 0;
+		if (*ptr)
+			*ptr++ = '\0';
+		(*num_symbols)++;
+	}
+
+	/* Valid line */
+	return 1;
+}
+
+
+/* Return the kind of encoding for a value. Numbers are returned in 'num', and
+ * the length of the string prefix of a suffix value in 'prefix_len'. */
+static enum trace_value_kind_t trace_binary_value_kind(char *value,
+	unsigned long long *num, int *prefix_len)
+{
+	int len;
+	int start;
+	int i;
+
+	/* Hexadecimal number without leading zeros */
+	len = strlen(value);
+	if (len > 2 && len <= 18 && value[0] == '0' && value[1] == 'x' &&
+		(value[2] != '0' || len == 3))
+	{
+		for (i = 2; i < len; i++)
+			if (!isdigit(value[i]) && (value[i] < 'a' || value[i] > 'f'))
+				break;
+		if (i == len)
+		{
+			*num = strtoull(value + 2, NULL, 16);
+			return TRACE_VALUE_HEX;
+		}
+	}
+
+	/* Decimal suffix without leading zeros */
+	start = len;
+	while (start > 0 && isdigit(value[start - 1]))
+		start--;
+	if (start == len)
+		return TRACE_VALUE_STRING;
+	while (value[start] == '0' && start < len - 1)
+		start++;
+	if (len - start > 18)
+		return TRACE_VALUE_STRING;
+	*num = strtoull(value + start, NULL, 10);
+	*prefix_len = start;
+	return start ? TRACE_VALUE_SUFFIX : TRACE_VALUE_DECIMAL;
+}
+
+
+
+
+/*
+ * Trace Record
+ */
+
+int trace_record_print(struct trace_record_t *record, char *buf, int size)
+{
+	int len;
+	int i;
+
+	/* Text line */
+	if (!record->command)
+	{
+		len = snprintf(buf, size, "%s\n", record->text);
+		if (len >= size)
+			fatal("%s: buffer too small", __FUNCTION__);
+		return len;
+	}
+
+	/* Command and symbols */
+	len = snprintf(buf, size, "%s", record->command);
+	for (i = 0; i < record->num_symbols && len < size; i++)
+		len += snprintf(buf + len, size - len,
+			record->symbol_quoted[i] ? " %s=\"%s\"" : " %s=%s",
+			record->symbol_name[i], record->symbol_value[i]);
+	if (len < size)
+		len += snprintf(buf + len, size - len, "\n");
+	if (len >= size)
+		fatal("%s: buffer too small", __FUNCTION__);
+	return len;
+}
+
+
+void trace_record_dump(struct trace_record_t *record, FILE *f)
+{
+	char buf[8192];
+
+	trace_record_print(record, buf, sizeof buf);
+	fputs(buf, f);
+}
+
+
+
+
+/*
+ * Trace Writer
+ */
+
+struct trace_writer_t
+{
+	char *name;
+	FILE *f;
+
+	/* Uncompressed records of the block being filled, and cycle reached
+	 * before its first record. */
+	unsigned char *buf;
+	int size;
+	int capacity;
+	long long block_cycle;
+
+	/* Compressed block */
+	unsigned char *zbuf;
+	unsigned long zcapacity;
+
+	/* Interned strings. The table maps each string to its ID plus one, and
+	 * the list contains the strings in order of ID. */
+	struct hash_table_t *string_table;
+	struct list_t *string_list;
+
+	/* Index with the cycle and file offset of each block */
+	long long *index_cycle;
+	long long *index_offset;
+	int num_blocks;
+	int index_capacity;
+
+	/* Last number written for each symbol name in the current block,
+	 * indexed by string ID of the name. */
+	unsigned long long *last_num;
+	int last_num_count;
+
+	/* Last cycle record, and last cycle record in the current block */
+	long long cycle;
+	long long block_last_cycle;
+};
+
+
+static void trace_writer_write(struct trace_writer_t *writer, void *ptr, int size)
+{
+	if (fwrite(ptr, 1, size, writer->f) != size)
+		fatal("%s: cannot write trace file", writer->name);
+}
+
+
+static void trace_writer_byte(struct trace_writer_t *writer, int value)
+{
+	if (writer->size == writer->capacity)
+	{
+		writer->capacity *= 2;
+		writer->buf = xrealloc(writer->buf, writer->capacity);
+	}
+	writer->buf[writer->size++] = value;
+}
+
+
+static void trace_writer_varint(struct trace_writer_t *writer, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		trace_writer_byte(writer, (value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	trace_writer_byte(writer, value);
+}
+
+
+static void trace_writer_chars(struct trace_writer_t *writer, char *s, int len)
+{
+	trace_writer_varint(writer, len);
+	while (writer->size + len > writer->capacity)
+	{
+		writer->capacity *= 2;
+		writer->buf = xrealloc(writer->buf, writer->capacity);
+	}
+	memcpy(writer->buf + writer->size, s, len);
+	writer->size += len;
+}
+
+
+/* Return the ID of a string, defining it in the current block if it is the
+ * first time it is used. */
+static int trace_writer_intern(struct trace_writer_t *writer, char *s)
+{
+	long id;
+
+	id = (long) hash_table_get(writer->string_table, s);
+	if (id)
+		return id - 1;
+
+	/* New string */
+	id = list_count(writer->string_list);
+	list_add(writer->string_list, xstrdup(s));
+	hash_table_insert(writer->string_table, s, (void *) (id + 1));
+	trace_writer_byte(writer, TRACE_RECORD_STRING);
+	trace_writer_chars(writer, s, strlen(s));
+	return id;
+}
+
+
+/* Write a number as a difference with the last number given to the same
+ * symbol name in the current block. */
+static void trace_writer_num(struct trace_writer_t *writer, int name_id,
+	unsigned long long num)
+{
+	int count;
+
+	if (name_id >= writer->last_num_count)
+	{
+		count = MAX(writer->last_num_count * 2, name_id + 1);
+		writer->last_num = xrealloc(writer->last_num, count * sizeof(unsigned long long));
+		memset(writer->last_num + writer->last_num_count, 0,
+			(count - writer->last_num_count) * sizeof(unsigned long long));
+		writer->last_num_count = count;
+	}
+	trace_writer_varint(writer, trace_binary_zigzag(num - writer->last_num[name_id]));
+	writer->last_num[name_id] = num;
+}
+
+
+/* Compress the current block and write it to the file */
+static void trace_writer_flush(struct trace_writer_t *writer)
+{
+	unsigned long zsize;
+	unsigned int size;
+	int err;
+
+	/* Nothing to write */
+	if (!writer->size)
+		return;
+
+	/* Compress */
+	zsize = compressBound(writer->size);
+	if (zsize > writer->zcapacity)
+	{
+		writer->zcapacity = zsize;
+		writer->zbuf = xrealloc(writer->zbuf, zsize);
+	}
+	err = compress2(writer->zbuf, &zsize, writer->buf, writer->size, Z_BEST_SPEED);
+	if (err != Z_OK)
+		fatal("%s: cannot compress trace block", writer->name);
+
+	/* Add to index */
+	if (writer->num_blocks == writer->index_capacity)
+	{
+		writer->index_capacity *= 2;
+		writer->index_cycle = xrealloc(writer->index_cycle,
+			writer->index_capacity * sizeof(long long));
+		writer->index_offset = xrealloc(writer->index_offset,
+			writer->index_capacity * sizeof(long long));
+	}
+	writer->index_cycle[writer->num_blocks] = writer->block_cycle;
+	writer->index_offset[writer->num_blocks] = ftello(writer->f);
+	writer->num_blocks++;
+
+	/* Write block */
+	size = zsize;
+	trace_writer_write(writer, &writer->block_cycle, 8);
+	trace_writer_write(writer, &size, 4);
+	size = writer->size;
+	trace_writer_write(writer, &size, 4);
+	trace_writer_write(writer, writer->zbuf, zsize);
+
+	/* Start new block */
+	writer->size = 0;
+	writer->block_cycle = writer->cycle;
+	writer->block_last_cycle = 0;
+	memset(writer->last_num, 0, writer->last_num_count * sizeof(unsigned long long));
+}
+
+
+struct trace_writer_t *trace_writer_create(char *file_name)
+{
+	struct trace_writer_t *writer;
+	unsigned int version = TRACE_BINARY_VERSION;
+
+	/* Initialize */
+	writer = xcalloc(1, sizeof(struct trace_writer_t));
+	writer->name = xstrdup(file_name);
+	writer->capacity = TRACE_BINARY_BLOCK_SIZE;
+	writer->buf = xmalloc(writer->capacity);
+	writer->string_table = hash_table_create(0, 1);
+	writer->string_list = list_create();
+	writer->index_capacity = 64;
+	writer->index_cycle = xcalloc(writer->index_capacity, sizeof(long long));
+	writer->index_offset = xcalloc(writer->index_capacity, sizeof(long long));
+	writer->cycle = -1;
+	writer->block_cycle = -1;
+
+	/* Open file and write header */
+	writer->f = fopen(file_name, "wb");
+	if (!writer->f)
+		fatal("%s: cannot open trace file", file_name);
+	trace_writer_write(writer, TRACE_BINARY_MAGIC, 8);
+	trace_writer_write(writer, &version, 4);
+
+	/* Return */
+	return writer;
+}
+
+
+void trace_writer_free(struct trace_writer_t *writer)
+{
+	long long footer_offset;
+	unsigned int count;
+	unsigned int len;
+	char *s;
+	int i;
+
+	/* Last block */
+	trace_writer_flush(writer);
+
+	/* Footer with strings */
+	footer_offset = ftello(writer->f);
+	count = list_count(writer->string_list);
+	trace_writer_write(writer, &count, 4);
+	LIST_FOR_EACH(writer->string_list, i)
+	{
+		s = list_get(writer->string_list, i);
+		len = strlen(s);
+		trace_writer_write(writer, &len, 4);
+		trace_writer_write(writer, s, len);
+		free(s);
+	}
+
+	/* Footer with index */
+	count = writer->num_blocks;
+	trace_writer_write(writer, &count, 4);
+	for (i = 0; i < writer->num_blocks; i++)
+	{
+		trace_writer_write(writer, &writer->index_cycle[i], 8);
+		trace_writer_write(writer, &writer->index_offset[i], 8);
+	}
+
+	/* Trailer */
+	trace_writer_write(writer, &footer_offset, 8);
+	trace_writer_write(writer, &writer->cycle, 8);
+	trace_writer_write(writer, TRACE_BINARY_INDEX_MAGIC, 8);
+	fclose(writer->f);
+
+	/* Free */
+	list_free(writer->string_list);
+	hash_table_free(writer->string_table);
+	free(writer->index_cycle);
+	free(writer->index_offset);
+	free(writer->last_num);
+	free(writer->zbuf);
+	free(writer->buf);
+	free(writer->name);
+	free(writer);
+}
+
+
+void trace_writer_cycle(struct trace_writer_t *writer, long long cycle)
+{
+	/* Close block at a cycle boundary */
+	if (writer->size >= TRACE_BINARY_BLOCK_SIZE)
+		trace_writer_flush(writer);
+
+	trace_writer_byte(writer, TRACE_RECORD_CYCLE);
+	trace_writer_varint(writer, trace_binary_zigzag(cycle - writer->block_last_cycle));
+	writer->block_last_cycle = cycle;
+	writer->cycle = cycle;
+}
+
+
+static void trace_writer_line(struct trace_writer_t *writer, char *line, int len)
+{
+	char buf[4096];
+	char *command;
+	char *names[TRACE_RECORD_MAX_SYMBOLS];
+	char *values[TRACE_RECORD_MAX_SYMBOLS];
+	int quoted[TRACE_RECORD_MAX_SYMBOLS];
+	int kinds[TRACE_RECORD_MAX_SYMBOLS];
+	int prefix_len[TRACE_RECORD_MAX_SYMBOLS];
+	unsigned long long nums[TRACE_RECORD_MAX_SYMBOLS];
+	int ids[TRACE_RECORD_MAX_SYMBOLS];
+	int name_ids[TRACE_RECORD_MAX_SYMBOLS];
+	int num_symbols;
+	int command_id;
+	char c;
+	int i;
+
+	/* Block too large */
+	if (writer->size >= TRACE_BINARY_BLOCK_SIZE_MAX)
+		trace_writer_flush(writer);
+
+	/* Lines not following the trace syntax are stored as they are */
+	if (len >= sizeof buf)
+		goto text;
+	memcpy(buf, line, len);
+	buf[len] = '\0';
+	if (!trace_binary_parse_line(buf, &command, &num_symbols, names, values, quoted))
+		goto text;
+
+	/* Intern strings first, since their definitions must precede the line */
+	command_id = trace_writer_intern(writer, command);
+	for (i = 0; i < num_symbols; i++)
+	{
+		name_ids[i] = trace_writer_intern(writer, names[i]);
+		kinds[i] = trace_binary_value_kind(values[i], &nums[i], &prefix_len[i]);
+		if (kinds[i] == TRACE_VALUE_STRING)
+			ids[i] = trace_writer_intern(writer, values[i]);
+		else if (kinds[i] == TRACE_VALUE_SUFFIX)
+		{
+			c = values[i][prefix_len[i]];
+			values[i][prefix_len[i]] = '\0';
+			ids[i] = trace_writer_intern(writer, values[i]);
+			values[i][prefix_len[i]] = c;
+		}
+	}
+
+	/* Line record */
+	trace_writer_byte(writer, TRACE_RECORD_LINE);
+	trace_writer_varint(writer, command_id);
+	trace_writer_varint(writer, num_symbols);
+	for (i = 0; i < num_symbols; i++)
+	{
+		trace_writer_varint(writer, name_ids[i]);
+		trace_writer_byte(writer, kinds[i] | (quoted[i] ? TRACE_VALUE_QUOTED : 0));
+		if (kinds[i] == TRACE_VALUE_STRING || kinds[i] == TRACE_VALUE_SUFFIX)
+			trace_writer_varint(writer, ids[i]);
+		if (kinds[i] != TRACE_VALUE_STRING)
+			trace_writer_num(writer, name_ids[i], nums[i]);
+	}
+	return;
+
+text:
+	trace_writer_byte(writer, TRACE_RECORD_TEXT);
+	trace_writer_chars(writer, line, len);
+}
+
+
+/* Write text with one or more trace lines, each ending with a newline
+ * character except possibly the last one. */
+void trace_writer_text(struct trace_writer_t *writer, char *text)
+{
+	char *end;
+
+	while (*text)
+	{
+		end = strchr(text, '\n');
+		if (!end)
+			end = text + strlen(text);
+		if (end > text)
+			trace_writer_line(writer, text, end - text);
+		text = *end ? end + 1 : end;
+	}
+}
+
+
+
+
+/*
+ * Trace Reader
+ */
+
+struct trace_reader_t
+{
+	char *name;
+	FILE *f;
+
+	/* Interned strings */
+	char **strings;
+	int num_strings;
+	int strings_capacity;
+
+	/* Index */
+	long long *index_cycle;
+	long long *index_offset;
+	int num_blocks;
+	int index_capacity;
+
+	long long num_cycles;
+
+	/* Block currently decompressed, or -1 if none, and position of the next
+	 * record in it. */
+	int block;
+	int pos;
+	unsigned char *buf;
+	int size;
+	int capacity;
+	unsigned char *zbuf;
+	unsigned long zcapacity;
+
+	/* Last number read for each symbol name and last cycle record in the
+	 * current block, used to decode differences. */
+	unsigned long long *last_num;
+	int last_num_count;
+	long long block_last_cycle;
+
+	/* Record used to skip records while seeking */
+	struct trace_record_t *skip_record;
+
+	/* Set while rebuilding the footer of a file that was not closed */
+	int scanning;
+};
+
+
+static void trace_reader_add_string(struct trace_reader_t *reader, char *s)
+{
+	if (reader->num_strings == reader->strings_capacity)
+	{
+		reader->strings_capacity = MAX(reader->strings_capacity * 2, 64);
+		reader->strings = xrealloc(reader->strings,
+			reader->strings_capacity * sizeof(char *));
+	}
+	reader->strings[reader->num_strings++] = s;
+}
+
+
+static void trace_reader_add_block(struct trace_reader_t *reader,
+	long long cycle, long long offset)
+{
+	if (reader->num_blocks == reader->index_capacity)
+	{
+		reader->index_capacity = MAX(reader->index_capacity * 2, 64);
+		reader->index_cycle = xrealloc(reader->index_cycle,
+			reader->index_capacity * sizeof(long long));
+		reader->index_offset = xrealloc(reader->index_offset,
+			reader->index_capacity * sizeof(long long));
+	}
+	reader->index_cycle[reader->num_blocks] = cycle;
+	reader->index_offset[reader->num_blocks] = offset;
+	reader->num_blocks++;
+}
+
+
+static unsigned long long trace_reader_varint(struct trace_reader_t *reader)
+{
+	unsigned long long value = 0;
+	int shift = 0;
+	int byte;
+
+	do
+	{
+		if (reader->pos >= reader->size || shift > 63)
+			fatal("%s: corrupt trace file", reader->name);
+		byte = reader->buf[reader->pos++];
+		value |= (unsigned long long) (byte & 0x7f) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+	return value;
+}
+
+
+static int trace_reader_string_id(struct trace_reader_t *reader)
+{
+	unsigned long long id;
+
+	id = trace_reader_varint(reader);
+	if (id >= reader->num_strings)
+		fatal("%s: corrupt trace file", reader->name);
+	return id;
+}
+
+
+static char *trace_reader_string(struct trace_reader_t *reader)
+{
+	return reader->strings[trace_reader_string_id(reader)];
+}
+
+
+/* Read a number stored as a difference with the last number given to the
+ * symbol name with string ID 'name_id'. */
+static unsigned long long trace_reader_num(struct trace_reader_t *reader, int name_id)
+{
+	unsigned long long num;
+	int count;
+
+	if (name_id >= reader->last_num_count)
+	{
+		count = MAX(reader->last_num_count * 2, name_id + 1);
+		reader->last_num = xrealloc(reader->last_num, count * sizeof(unsigned long long));
+		memset(reader->last_num + reader->last_num_count, 0,
+			(count - reader->last_num_count) * sizeof(unsigned long long));
+		reader->last_num_count = count;
+	}
+	num = trace_reader_varint(reader);
+	num = reader->last_num[name_id] + trace_binary_unzigzag(num);
+	reader->last_num[name_id] = num;
+	return num;
+}
+
+
+/* Read and decompress a block at a file offset. Return its cycle, or -2 if the
+ * block could not be read entirely. */
+static long long trace_reader_load(struct trace_reader_t *reader, long long offset)
+{
+	long long cycle;
+	unsigned int zsize;
+	unsigned int size;
+	unsigned long dest_size;
+
+	/* Header */
+	fseeko(reader->f, offset, SEEK_SET);
+	if (fread(&cycle, 1, 8, reader->f) != 8 ||
+		fread(&zsize, 1, 4, reader->f) != 4 ||
+		fread(&size, 1, 4, reader->f) != 4 ||
+		size >= TRACE_BINARY_BLOCK_SPAN)
+		return -2;
+
+	/* Compressed data */
+	if (zsize > reader->zcapacity)
+	{
+		reader->zcapacity = zsize;
+		reader->zbuf = xrealloc(reader->zbuf, zsize);
+	}
+	if (fread(reader->zbuf, 1, zsize, reader->f) != zsize)
+		return -2;
+
+	/* Uncompress */
+	if (size > reader->capacity)
+	{
+		reader->capacity = size;
+		reader->buf = xrealloc(reader->buf, size);
+	}
+	dest_size = size;
+	if (uncompress(reader->buf, &dest_size, reader->zbuf, zsize) != Z_OK ||
+		dest_size != size)
+		return -2;
+	reader->size = size;
+	reader->pos = 0;
+	reader->block_last_cycle = 0;
+	memset(reader->last_num, 0, reader->last_num_count * sizeof(unsigned long long));
+	return cycle;
+}
+
+
+/* Place the reader at the beginning of a block. Differences are decoded
+ * starting from the beginning of the block, so the block is loaded again
+ * unless no record was read from it yet. */
+static void trace_reader_load_block(struct trace_reader_t *reader, int block)
+{
+	assert(block >= 0 && block < reader->num_blocks);
+	if (reader->block == block && !reader->pos)
+		return;
+	if (trace_reader_load(reader, reader->index_offset[block]) == -2)
+		fatal("%s: corrupt trace file", reader->name);
+	reader->block = block;
+}
+
+
+/* Decode the record at the current position into 'record', and return its
+ * kind. */
+static enum trace_record_kind_t trace_reader_decode(struct trace_reader_t *reader,
+	struct trace_record_t *record)
+{
+	enum trace_record_kind_t kind;
+	unsigned long long num;
+	unsigned long long len;
+	char *prefix;
+	char *buf;
+	int size;
+	int count;
+	int value_kind;
+	int name_id;
+	int i;
+
+	kind = reader->buf[reader->pos++];
+	buf = record->buf;
+	size = sizeof record->buf;
+	switch (kind)
+	{
+
+	case TRACE_RECORD_CYCLE:
+
+		num = trace_reader_varint(reader);
+		num = reader->block_last_cycle + trace_binary_unzigzag(num);
+		reader->block_last_cycle = num;
+		if (reader->scanning)
+			reader->num_cycles = num;
+		snprintf(buf, size, "%llu", num);
+		record->command = "c";
+		record->text = NULL;
+		record->num_symbols = 1;
+		record->symbol_name[0] = "clk";
+		record->symbol_value[0] = buf;
+		record->symbol_quoted[0] = 0;
+		break;
+
+	case TRACE_RECORD_STRING:
+	case TRACE_RECORD_TEXT:
+
+		len = trace_reader_varint(reader);
+		if (len > reader->size - reader->pos || len >= size)
+			fatal("%s: corrupt trace file", reader->name);
+		memcpy(buf, reader->buf + reader->pos, len);
+		buf[len] = '\0';
+		reader->pos += len;
+		if (kind == TRACE_RECORD_STRING && reader->scanning)
+			trace_reader_add_string(reader, xstrdup(buf));
+		record->command = NULL;
+		record->text = buf;
+		record->num_symbols = 0;
+		break;
+
+	case TRACE_RECORD_LINE:
+
+		record->command = trace_reader_string(reader);
+		record->text = NULL;
+		record->num_symbols = trace_reader_varint(reader);
+		if (record->num_symbols > TRACE_RECORD_MAX_SYMBOLS)
+			fatal("%s: corrupt trace file", reader->name);
+		for (i = 0; i < record->num_symbols; i++)
+		{
+			name_id = trace_reader_string_id(reader);
+			record->symbol_name[i] = reader->strings[name_id];
+			if (reader->pos >= reader->size)
+				fatal("%s: corrupt trace file", reader->name);
+			value_kind = reader->buf[reader->pos++];
+			record->symbol_quoted[i] = value_kind & TRACE_VALUE_QUOTED ? 1 : 0;
+			record->symbol_value[i] = buf;
+			switch (value_kind & ~TRACE_VALUE_QUOTED)
+			{
+			case TRACE_VALUE_STRING:
+				count = snprintf(buf, size, "%s", trace_reader_string(reader));
+				break;
+			case TRACE_VALUE_DECIMAL:
+				count = snprintf(buf, size, "%llu", trace_reader_num(reader, name_id));
+				break;
+			case TRACE_VALUE_HEX:
+				count = snprintf(buf, size, "0x%llx", trace_reader_num(reader, name_id));
+				break;
+			case TRACE_VALUE_SUFFIX:
+				prefix = trace_reader_string(reader);
+				count = snprintf(buf, size, "%s%llu", prefix, trace_reader_num(reader, name_id));
+				break;
+			default:
+				fatal("%s: corrupt trace file", reader->name);
+				count = 0;
+			}
+			if (count >= size)
+				fatal("%s: trace line too long", reader->name);
+			buf += count + 1;
+			size -= count + 1;
+		}
+		break;
+
+	default:
+		fatal("%s: corrupt trace file", reader->name);
+	}
+
+	return kind;
+}
+
+
+/* Rebuild the strings and the index of a file whose footer was not written,
+ * e.g., because the simulation was interrupted. */
+static void trace_reader_scan(struct trace_reader_t *reader, long long offset)
+{
+	struct trace_record_t *record;
+	long long cycle;
+
+	warning("%s: trace file was not closed, rebuilding index", reader->name);
+	record = reader->skip_record;
+	reader->scanning = 1;
+	reader->num_cycles = -1;
+	for (;;)
+	{
+		cycle = trace_reader_load(reader, offset);
+		if (cycle == -2)
+			break;
+		trace_reader_add_block(reader, cycle, offset);
+		offset = ftello(reader->f);
+		while (reader->pos < reader->size)
+			trace_reader_decode(reader, record);
+	}
+	reader->scanning = 0;
+}
+
+
+struct trace_reader_t *trace_reader_create(char *file_name)
+{
+	struct trace_reader_t *reader;
+	char magic[8];
+	unsigned int version;
+	unsigned int count;
+	unsigned int len;
+	long long footer_offset;
+	long long header_end;
+	long long cycle;
+	long long offset;
+	char *s;
+	int i;
+
+	/* Initialize */
+	reader = xcalloc(1, sizeof(struct trace_reader_t));
+	reader->name = xstrdup(file_name);
+	reader->block = -1;
+	reader->skip_record = xmalloc(sizeof(struct trace_record_t));
+
+	/* Open file and check header. Return NULL if this is not a binary
+	 * trace, so that the caller can read it as a text trace instead. */
+	reader->f = fopen(file_name, "rb");
+	if (!reader->f)
+		fatal("%s: cannot open trace file", file_name);
+	if (fread(magic, 1, 8, reader->f) != 8 || memcmp(magic, TRACE_BINARY_MAGIC, 8))
+	{
+		fclose(reader->f);
+		free(reader->skip_record);
+		free(reader->name);
+		free(reader);
+		return NULL;
+	}
+	if (fread(&version, 1, 4, reader->f) != 4 || version != TRACE_BINARY_VERSION)
+		fatal("%s: unsupported trace file version", file_name);
+	header_end = ftello(reader->f);
+
+	/* Trailer */
+	if (fseeko(reader->f, -24, SEEK_END) ||
+		fread(&footer_offset, 1, 8, reader->f) != 8 ||
+		fread(&reader->num_cycles, 1, 8, reader->f) != 8 ||
+		fread(magic, 1, 8, reader->f) != 8 ||
+		memcmp(magic, TRACE_BINARY_INDEX_MAGIC, 8) ||
+		footer_offset < header_end)
+	{
+		trace_reader_scan(reader, header_end);
+		return reader;
+	}
+
+	/* Footer strings */
+	fseeko(reader->f, footer_offset, SEEK_SET);
+	if (fread(&count, 1, 4, reader->f) != 4)
+		fatal("%s: corrupt trace file", file_name);
+	for (i = 0; i < count; i++)
+	{
+		if (fread(&len, 1, 4, reader->f) != 4 || len > MAX_LONG_STRING_SIZE)
+			fatal("%s: corrupt trace file", file_name);
+		s = xmalloc(len + 1);
+		if (fread(s, 1, len, reader->f) != len)
+			fatal("%s: corrupt trace file", file_name);
+		s[len] = '\0';
+		trace_reader_add_string(reader, s);
+	}
+
+	/* Footer index */
+	if (fread(&count, 1, 4, reader->f) != 4)
+		fatal("%s: corrupt trace file", file_name);
+	for (i = 0; i < count; i++)
+	{
+		if (fread(&cycle, 1, 8, reader->f) != 8 ||
+			fread(&offset, 1, 8, reader->f) != 8)
+			fatal("%s: corrupt trace file", file_name);
+		trace_reader_add_block(reader, cycle, offset);
+	}
+
+	/* Return */
+	return reader;
+}
+
+
+void trace_reader_free(struct trace_reader_t *reader)
+{
+	int i;
+
+	for (i = 0; i < reader->num_strings; i++)
+		free(reader->strings[i]);
+	free(reader->strings);
+	free(reader->index_cycle);
+	free(reader->index_offset);
+	free(reader->skip_record);
+	free(reader->last_num);
+	free(reader->buf);
+	free(reader->zbuf);
+	fclose(reader->f);
+	free(reader->name);
+	free(reader);
+}
+
+
+long long trace_reader_get_num_cycles(struct trace_reader_t *reader)
+{
+	return reader->num_cycles;
+}
+
+
+int trace_reader_get_num_blocks(struct trace_reader_t *reader)
+{
+	return reader->num_blocks;
+}
+
+
+int trace_reader_get_num_strings(struct trace_reader_t *reader)
+{
+	return reader->num_strings;
+}
+
+
+/* Position of the next record, to be passed to 'trace_reader_seek' */
+long long trace_reader_tell(struct trace_reader_t *reader)
+{
+	if (reader->block < 0)
+		return 0;
+	return reader->block * TRACE_BINARY_BLOCK_SPAN + reader->pos;
+}
+
+
+void trace_reader_seek(struct trace_reader_t *reader, long long position)
+{
+	int block;
+	int pos;
+
+	/* Past the end */
+	if (position / TRACE_BINARY_BLOCK_SPAN >= reader->num_blocks)
+	{
+		if (!reader->num_blocks)
+			return;
+		trace_reader_load_block(reader, reader->num_blocks - 1);
+		while (reader->pos < reader->size)
+			trace_reader_decode(reader, reader->skip_record);
+		return;
+	}
+
+	/* Go to position, decoding the preceding records of the block */
+	block = position / TRACE_BINARY_BLOCK_SPAN;
+	pos = position % TRACE_BINARY_BLOCK_SPAN;
+	if (reader->block != block || reader->pos > pos)
+		trace_reader_load_block(reader, block);
+	while (reader->pos < pos && reader->pos < reader->size)
+		trace_reader_decode(reader, reader->skip_record);
+	if (reader->pos != pos)
+		fatal("%s: invalid trace position", reader->name);
+}
+
+
+/* Place the reader before the first cycle record for a cycle equal or higher
+ * than 'cycle'. Records preceding it in the same block need to be skipped
+ * by the caller. */
+void trace_reader_seek_cycle(struct trace_reader_t *reader, long long cycle)
+{
+	int low;
+	int high;
+	int mid;
+
+	/* Last block starting before 'cycle' */
+	low = 0;
+	high = reader->num_blocks - 1;
+	while (low < high)
+	{
+		mid = (low + high + 1) / 2;
+		if (reader->index_cycle[mid] < cycle)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+
+	/* Go to block */
+	if (!reader->num_blocks)
+		return;
+	trace_reader_load_block(reader, low);
+}
+
+
+/* Read next record. Return 0 if the end of the trace was reached. */
+int trace_reader_read(struct trace_reader_t *reader, struct trace_record_t *record)
+{
+	for (;;)
+	{
+		/* Next block */
+		if (reader->block < 0 || reader->pos >= reader->size)
+		{
+			if (reader->block + 1 >= reader->num_blocks)
+				return 0;
+			trace_reader_load_block(reader, reader->block + 1);
+			continue;
+		}
+
+		/* String definitions are already known from the footer */
+		if (trace_reader_decode(reader, record) != TRACE_RECORD_STRING)
+			return 1;
+	}
+}
+
+
+
+
+/*
+ * Trace Tool
+ */
+
+/* Number of lines of each command in a trace */
+struct trace_tool_summary_t
+{
+	struct hash_table_t *count_table;
+	struct list_t *command_list;
+	long long num_lines;
+	long long num_cycles;
+};
+
+
+static void trace_tool_summary_add(struct trace_tool_summary_t *summary, char *command)
+{
+	long count;
+
+	count = (long) hash_table_get(summary->count_table, command);
+	if (count)
+		hash_table_set(summary->count_table, command, (void *) (count + 1));
+	else
+	{
+		list_add(summary->command_list, xstrdup(command));
+		hash_table_insert(summary->count_table, command, (void *) 1);
+	}
+	summary->num_lines++;
+}
+
+
+static void trace_tool_summary_dump(struct trace_tool_summary_t *summary, FILE *f)
+{
+	char *command;
+	int i;
+
+	fprintf(f, "Lines = %lld\n", summary->num_lines);
+	fprintf(f, "Cycles = %lld\n", summary->num_cycles);
+	LIST_FOR_EACH(summary->command_list, i)
+	{
+		command = list_get(summary->command_list, i);
+		fprintf(f, "Lines.%s = %ld\n", command,
+			(long) hash_table_get(summary->count_table, command));
+		free(command);
+	}
+	list_free(summary->command_list);
+	hash_table_free(summary->count_table);
+}
+
+
+/* Dump a binary trace. If 'f' is NULL, only a summary is printed. */
+static void trace_tool_binary(struct trace_reader_t *reader, gzFile f,
+	long long first, long long last)
+{
+	struct trace_tool_summary_t summary;
+	struct trace_record_t *record;
+	long long cycle = -1;
+	char buf[8192];
+	int len;
+
+	/* Summary */
+	if (!f)
+	{
+		printf("Format = binary\n");
+		printf("Blocks = %d\n", trace_reader_get_num_blocks(reader));
+		printf("Strings = %d\n", trace_reader_get_num_strings(reader));
+		memset(&summary, 0, sizeof summary);
+		summary.count_table = hash_table_create(0, 1);
+		summary.command_list = list_create();
+	}
+
+	/* With a cycle range, dump the header lines preceding the first cycle
+	 * and start from the block containing the first cycle of the range.
+	 * The lines of earlier cycles in this block are skipped below. */
+	record = xmalloc(sizeof(struct trace_record_t));
+	if (first >= 0)
+	{
+		while (trace_reader_read(reader, record) &&
+			(!record->command || strcmp(record->command, "c")))
+		{
+			len = trace_record_print(record, buf, sizeof buf);
+			gzwrite(f, buf, len);
+		}
+		trace_reader_seek_cycle(reader, first);
+	}
+	while (trace_reader_read(reader, record))
+	{
+		/* Check cycle range */
+		if (record->command && !strcmp(record->command, "c"))
+			cycle = atoll(record->symbol_value[0]);
+		if (last >= 0 && cycle > last)
+			break;
+		if (cycle < first)
+			continue;
+
+		/* Dump */
+		if (f)
+		{
+			len = trace_record_print(record, buf, sizeof buf);
+			gzwrite(f, buf, len);
+		}
+		else if (record->command)
+			trace_tool_summary_add(&summary, record->command);
+	}
+	free(record);
+
+	/* Summary */
+	if (!f)
+	{
+		summary.num_cycles = trace_reader_get_num_cycles(reader);
+		trace_tool_summary_dump(&summary, stdout);
+	}
+}
+
+
+/* Dump or convert a text trace. If 'writer' and 'f' are NULL, only a summary
+ * is printed. */
+static void trace_tool_text(gzFile trace_file, struct trace_writer_t *writer,
+	gzFile f, long long first, long long last)
+{
+	struct trace_tool_summary_t summary;
+	long long cycle = -1;
+	char buf[8192];
+	char command[MAX_STRING_SIZE];
+
+	/* Summary */
+	if (!writer && !f)
+	{
+		printf("Format = text\n");
+		memset(&summary, 0, sizeof summary);
+		summary.count_table = hash_table_create(0, 1);
+		summary.command_list = list_create();
+	}
+
+	/* Read lines */
+	while (gzgets(trace_file, buf, sizeof buf))
+	{
+		/* Check cycle range */
+		if (sscanf(buf, "c clk=%lld", &cycle) == 1 && writer)
+		{
+			if (cycle >= first && (last < 0 || cycle <= last))
+				trace_writer_cycle(writer, cycle);
+			continue;
+		}
+		if (last >= 0 && cycle > last)
+			break;
+		if (cycle >= 0 && cycle < first)
+			continue;
+
+		/* Dump */
+		if (writer)
+			trace_writer_text(writer, buf);
+		else if (f)
+			gzputs(f, buf);
+		else if (sscanf(buf, "%s", command) == 1)
+			trace_tool_summary_add(&summary, command);
+	}
+
+	/* Summary */
+	if (!writer && !f)
+	{
+		summary.num_cycles = cycle;
+		trace_tool_summary_dump(&summary, stdout);
+	}
+}
+
+
+/* Headless trace tool. Without an output file, a summary of the trace is
+ * printed. With an output file, a binary trace is converted to text, and a
+ * text trace to binary. If 'cycles' is not empty, it gives a range
+ * 'first:last' that limits the converted or printed lines, dumped as text to
+ * the standard output when no output file is given. Header lines preceding
+ * the first cycle are always included. */
+void trace_tool(char *file_name, char *output_file_name, char *cycles)
+{
+	struct trace_reader_t *reader;
+	struct trace_writer_t *writer;
+	gzFile trace_file;
+	gzFile f;
+
+	long long first = -1;
+	long long last = -1;
+
+	/* Cycle range */
+	if (*cycles && (sscanf(cycles, "%lld:%lld", &first, &last) != 2 ||
+			first < 0 || last < first))
+		fatal("%s: invalid cycle range, expected <first>:<last>", cycles);
+
+	/* Binary trace */
+	reader = trace_reader_create(file_name);
+	if (reader)
+	{
+		f = NULL;
+		if (*output_file_name)
+			f = gzopen(output_file_name, "wt");
+		else if (*cycles)
+			f = gzdopen(dup(fileno(stdout)), "wT");
+		if ((*output_file_name || *cycles) && !f)
+			fatal("%s: cannot open output file", output_file_name);
+		trace_tool_binary(reader, f, first, last);
+		if (f)
+			gzclose(f);
+		trace_reader_free(reader);
+		exit(0);
+	}
+
+	/* Text trace */
+	trace_file = gzopen(file_name, "rt");
+	if (!trace_file)
+		fatal("%s: cannot open trace file", file_name);
+	writer = NULL;
+	f = NULL;
+	if (*output_file_name)
+		writer = trace_writer_create(output_file_name);
+	else if (*cycles)
+	{
+		f = gzdopen(dup(fileno(stdout)), "wT");
+		if (!f)
+			fatal("cannot write to standard output");
+	}
+	trace_tool_text(trace_file, writer, f, first, last);
+	if (writer)
+		trace_writer_free(writer);
+	if (f)
+		gzclose(f);
+	gzclose(trace_file);
+	exit(0);
+}
@@ -20,7 +20,15 @@
 #ifndef LIB_ESIM_TRACE_H
 #define LIB_ESIM_TRACE_H
 
-void trace_init(char *file_name);
+extern struct str_map_t trace_format_map;
+
+enum trace_format_t
+{
+	trace_format_text = 0,
+	trace_format_binary
+};
+
+void trace_init(char *file_name, enum trace_format_t format);
 void trace_done(void);
 
 int trace_new_category(void);
@@ -254,6 +254,18 @@ void cache_set_block(struct cache_t *cache, int set, int way, int tag, int state
 		cache_update_waylist(&cache->sets[set],
 			&cache->sets[set].blocks[way],
 			cache_waylist_head);
+
+	/* A prefetched block replaced before any demand access was useless. The
+	 * flag does not apply to the new block. */
+	if (cache->sets[set].blocks[way].tag != tag && cache->sets[set].blocks[way].prefetched)
+	{
+		if (cache->sets[set].blocks[way].prefetched == PREFETCHER_BLOCK_PREFETCHED)
+			cache->prefetcher->unused++;
+		cache->sets[set].blocks[way].prefetched = 0;
+	}
+	if (cache->sets[set].blocks[way].tag != tag)
+		cache->sets[set].blocks[way].update_count = 0;
+
 	cache->sets[set].blocks[way].tag = tag;
 	cache->sets[set].blocks[way].state = state;
 }
@@ -268,6 +280,24 @@ void cache_get_block(struct cache_t *cache, int set, int way, int *tag_ptr, int
 }
 
 
+/* Record an update of a block written by another module, and return the
+ * number of updates since the last access to the block. */
+int cache_count_update(struct cache_t *cache, int set, int way)
+{
+	assert(set >= 0 && set < cache->num_sets);
+	assert(way >= 0 && way < cache->assoc);
+	return ++cache->sets[set].blocks[way].update_count;
+}
+
+
+void cache_reset_updates(struct cache_t *cache, int set, int way)
+{
+	assert(set >= 0 && set < cache->num_sets);
+	assert(way >= 0 && way < cache->assoc);
+	cache->sets[set].blocks[way].update_count = 0;
+}
+
+
 /* Update LRU counters, i.e., rearrange linked list in case
  * replacement policy is LRU. */
 void cache_access_block(struct cache_t *cache, int set, int way)
@@ -551,6 +581,42 @@ int cache_entry_lock(struct cache_t *cache, int set, int way, int event, struct
 }
 
 
+/* Enqueue an access at the end of the lock queue of a block without trying
+ * to lock it. The access is resumed with 'event' when the current owner
+ * releases the lock. If the block is not locked, nothing is done and the
+ * function returns 0. */
+int cache_entry_wait(struct cache_t *cache, int set, int way, int event, struct mod_stack_t *stack)
+{
+	struct cache_lock_t *cache_lock;
+	struct mod_stack_t *lock_queue_iter;
+
+	/* Get lock */
+	assert(set < cache->num_sets && way < cache->assoc);
+	cache_lock = &cache->cache_lock[set * cache->assoc + way];
+	if (!cache_lock->lock)
+		return 0;
+
+	/* Enqueue the stack to the end of the lock queue */
+	stack->cache_lock_next = NULL;
+	stack->cache_lock_event = event;
+	stack->lock_retry = 1;
+	if (!cache_lock->lock_queue)
+	{
+		cache_lock->lock_queue = stack;
+	}
+	else
+	{
+		lock_queue_iter = cache_lock->lock_queue;
+		while (lock_queue_iter->cache_lock_next)
+			lock_queue_iter = lock_queue_iter->cache_lock_next;
+		lock_queue_iter->cache_lock_next = stack;
+	}
+	mem_debug("    A-%lld waiting for %s set=%d, way=%d to be unlocked\n",
+		stack->id, cache->name, set, way);
+	return 1;
+}
+
+
 void cache_entry_unlock(struct cache_t *cache, int set, int way)
 {
 	struct cache_lock_t *cache_lock;
@@ -580,9 +646,18 @@ void cache_entry_unlock(struct cache_t *cache, int set, int way)
 			mem_debug("\n");
 		}
 
-		/* Wake up access */
-		esim_schedule_event(cache_lock->lock_queue->cache_lock_event, cache_lock->lock_queue, 1);
-		cache_lock->lock_queue = cache_lock->lock_queue->cache_lock_next;
+		/* Wake up access. Accesses queued with 'cache_entry_wait' do not
+		 * take the lock when resumed, so the waiters behind them are woken
+		 * up as well, up to the first one that does. */
+		do
+		{
+			stack = cache_lock->lock_queue;
+			esim_schedule_event(stack->cache_lock_event, stack, 1);
+			cache_lock->lock_queue = stack->cache_lock_next;
+			if (!stack->lock_retry)
+				break;
+			stack->lock_retry = 0;
+		} while (cache_lock->lock_queue);
 	}
 
 	/* Trace */
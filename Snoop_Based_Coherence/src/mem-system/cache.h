@@ -67,6 +67,7 @@ struct cache_block_t
 	int transient_tag;
 	int way;
 	int prefetched;
+	int update_count;  /* Updates by other modules since the last own access */
 
 	enum cache_block_state_t state;
 };
@@ -107,6 +108,8 @@ int cache_find_block(struct cache_t *cache, unsigned int addr, int *set_ptr, int
 	int *state_ptr);
 void cache_set_block(struct cache_t *cache, int set, int way, int tag, int state);
 void cache_get_block(struct cache_t *cache, int set, int way, int *tag_ptr, int *state_ptr);
+int cache_count_update(struct cache_t *cache, int set, int way);
+void cache_reset_updates(struct cache_t *cache, int set, int way);
 
 void cache_access_block(struct cache_t *cache, int set, int way);
 int cache_replace_block(struct cache_t *cache, int set);
@@ -116,6 +119,7 @@ void cache_set_transient_tag(struct cache_t *cache, int set, int way, int tag);
 struct cache_lock_t *cache_lock_get(struct cache_t *cache, int set, int way);
 // Make a try to lock the directory entry given by x, y parameters. In case the directory entry is already locked we enqueue this access in the directory entry's lock queue. A value of '0' is returned if the lock attempt was unsuccessful else a value of '1' is returned.
 int cache_entry_lock(struct cache_t *cache, int set, int way, int event, struct mod_stack_t *stack);
+int cache_entry_wait(struct cache_t *cache, int set, int way, int event, struct mod_stack_t *stack);
 // Unlock the directory entry, To unlock check the lock queue in case there are pending instructions, get the head of the lock queue, schedule the event, update the lock queue and unlock the directory entry.
 void cache_entry_unlock(struct cache_t *cache, int x, int y);
 
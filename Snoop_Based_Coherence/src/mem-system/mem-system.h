@@ -30,6 +30,9 @@ struct mem_system_t
 	/* List of modules and networks */
 	struct list_t *mod_list;
 	struct list_t *net_list;
+
+	/* List of TLBs */
+	struct list_t *tlb_list;
 };
 
 
@@ -42,19 +45,69 @@ struct mem_system_t
 
 extern char *mem_report_file_name;
 
+/* Debug and trace hooks. When NTRACE is defined at build time (configure
+ * option '--enable-no-trace'), hooks are compiled out and their arguments
+ * are not evaluated. Otherwise, the output of the access handlers can be
+ * limited with a filter of modules and address ranges, evaluated once per
+ * handler call by 'mem_filter_stack'. */
+#ifdef NTRACE
+
+#define mem_debugging() 0
+#define mem_debug(...) (0 ? debug(mem_debug_category, __VA_ARGS__) : (void) 0)
+
+#define mem_tracing() 0
+#define mem_trace(...) (0 ? trace(mem_trace_category, __VA_ARGS__) : (void) 0)
+#define mem_trace_header(...) (0 ? trace_header(mem_trace_category, __VA_ARGS__) : (void) 0)
+
+#define mem_filter_stack(stack) ((void) 0)
+
+#else
+
 #define mem_debugging() debug_status(mem_debug_category)
-#define mem_debug(...) debug(mem_debug_category, __VA_ARGS__)
-extern int mem_debug_category;
+#define mem_debug(...) debug(mem_debug_category && mem_filter_pass ? \
+	mem_debug_category : 0, __VA_ARGS__)
 
 #define mem_tracing() trace_status(mem_trace_category)
-#define mem_trace(...) trace(mem_trace_category, __VA_ARGS__)
+#define mem_trace(...) trace(mem_trace_category && mem_filter_pass ? \
+	mem_trace_category : 0, __VA_ARGS__)
 #define mem_trace_header(...) trace_header(mem_trace_category, __VA_ARGS__)
+
+#define mem_filter_stack(stack) (mem_filter_list ? \
+	(void) (mem_filter_pass = mem_filter_match((stack))) : (void) 0)
+
+#endif
+
+extern int mem_debug_category;
 extern int mem_trace_category;
 
 
+/* Filter of the debug and trace output. Each entry selects the accesses to
+ * one module, or any module if 'mod' is NULL, optionally limited to the
+ * block containing address 'low', or to addresses between 'low' and
+ * 'high'. */
+struct mem_filter_t
+{
+	struct mod_t *mod;
+	int has_range;
+	int block;
+	unsigned int low;
+	unsigned int high;
+};
+
+struct mod_stack_t;
+
+extern char *mem_debug_filter;
+extern struct list_t *mem_filter_list;
+extern int mem_filter_pass;
+
+int mem_filter_match(struct mod_stack_t *stack);
+
+
 /* Configuration */
 extern int mem_frequency;
 extern int mem_peer_transfers;
+extern int mem_c2c_transfers;
+extern int mem_lock_queue;
 
 /* Frequency and frequency domain */
 extern int mem_domain_index;
@@ -74,9 +127,11 @@ void mem_system_init(void);
 void mem_system_done(void);
 
 void mem_system_dump_report(void);
+void mem_system_reset_stats(void);
 
 struct mod_t *mem_system_get_mod(char *mod_name);
 struct net_t *mem_system_get_net(char *net_name);
+struct tlb_t *mem_system_get_tlb(char *tlb_name);
 
 
 #endif
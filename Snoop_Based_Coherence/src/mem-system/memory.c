@@ -33,32 +33,45 @@ unsigned long mem_max_mapped_space = 0;
 /* Safe mode */
 int mem_safe_mode = 1;
 
+/* Last version assigned to a memory page */
+static unsigned long long mem_page_version;
+
+
+/* Invalidate instructions decoded from a page whose data or permissions are
+ * about to change. */
+static void mem_page_modify(struct mem_page_t *page)
+{
+	if (page->code)
+	{
+		page->code = 0;
+		page->version = ++mem_page_version;
+	}
+}
+
 
 /* Return mem page corresponding to an address. */
 struct mem_page_t *mem_page_get(struct mem_t *mem, unsigned int addr)
 {
-	unsigned int index, tag;
-	struct mem_page_t *prev, *page;
+	unsigned int tag, cache_index;
+	struct mem_page_t **table;
+	struct mem_page_t *page;
 
+	/* Look in cache of last accessed pages first */
 	tag = addr & ~(MEM_PAGE_SIZE - 1);
-	index = (addr >> MEM_LOG_PAGE_SIZE) % MEM_PAGE_COUNT;
-	page = mem->pages[index];
-	prev = NULL;
-	
-	/* Look for page */
-	while (page && page->tag != tag)
-	{
-		prev = page;
-		page = page->next;
-	}
-	
-	/* Place page into list head */
-	if (prev && page)
-	{
-		prev->next = page->next;
-		page->next = mem->pages[index];
-		mem->pages[index] = page;
-	}
+	cache_index = (addr >> MEM_LOG_PAGE_SIZE) % MEM_PAGE_CACHE_SIZE;
+	page = mem->page_cache[cache_index];
+	if (page && page->tag == tag)
+		return page;
+
+	/* Walk page table */
+	table = mem->page_dir[MEM_PAGE_DIR_INDEX(addr)];
+	if (!table)
+		return NULL;
+	page = table[MEM_PAGE_TABLE_INDEX(addr)];
+
+	/* Record page in cache */
+	if (page)
+		mem->page_cache[cache_index] = page;
 	
 	/* Return found page */
 	return page;
@@ -69,59 +82,54 @@ struct mem_page_t *mem_page_get(struct mem_t *mem, unsigned int addr)
  * is useful to reconstruct consecutive ranges of mapped pages. */
 struct mem_page_t *mem_page_get_next(struct mem_t *mem, unsigned int addr)
 {
-	unsigned int tag, index, mintag;
-	struct mem_page_t *page, *minpage;
+	unsigned int tag;
+	struct mem_page_t **table;
+	struct mem_page_t *page;
 
-	/* Get tag of the page just following addr */
+	/* Get tag of the page just following addr, and scan the page table
+	 * upwards from it, skipping unallocated directory entries. */
 	tag = (addr + MEM_PAGE_SIZE) & ~(MEM_PAGE_SIZE - 1);
-	if (!tag)
-		return NULL;
-	index = (tag >> MEM_LOG_PAGE_SIZE) % MEM_PAGE_COUNT;
-	page = mem->pages[index];
-
-	/* Look for a page exactly following addr. If it is found, return it. */
-	while (page && page->tag != tag)
-		page = page->next;
-	if (page)
-		return page;
-	
-	/* Page following addr is not found, so check all memory pages to find
-	 * the one with the lowest tag following addr. */
-	mintag = 0xffffffff;
-	minpage = NULL;
-	for (index = 0; index < MEM_PAGE_COUNT; index++)
+	while (tag)
 	{
-		for (page = mem->pages[index]; page; page = page->next)
+		table = mem->page_dir[MEM_PAGE_DIR_INDEX(tag)];
+		if (!table)
 		{
-			if (page->tag > tag && page->tag < mintag)
-			{
-				mintag = page->tag;
-				minpage = page;
-			}
+			tag = (tag | ((1 << (MEM_LOG_PAGE_SIZE +
+				MEM_PAGE_TABLE_BITS)) - 1)) + 1;
+			continue;
 		}
+
+		page = table[MEM_PAGE_TABLE_INDEX(tag)];
+		if (page)
+			return page;
+		tag += MEM_PAGE_SIZE;
 	}
 
-	/* Return the found page (or NULL) */
-	return minpage;
+	/* No page found up to the end of the address space */
+	return NULL;
 }
 
 
 /* Create new mem page */
 static struct mem_page_t *mem_page_create(struct mem_t *mem, unsigned int addr, int perm)
 {
-	unsigned int index, tag;
+	unsigned int dir_index, tag;
 	struct mem_page_t *page;
 
 	/* Initialize */
 	page = xcalloc(1, sizeof(struct mem_page_t));
 	tag = addr & ~(MEM_PAGE_SIZE - 1);
-	index = (addr >> MEM_LOG_PAGE_SIZE) % MEM_PAGE_COUNT;
 	page->tag = tag;
 	page->perm = perm;
+	page->version = ++mem_page_version;
 	
-	/* Insert in pages hash table */
-	page->next = mem->pages[index];
-	mem->pages[index] = page;
+	/* Insert in page table, allocating the second-level table if needed */
+	dir_index = MEM_PAGE_DIR_INDEX(addr);
+	if (!mem->page_dir[dir_index])
+		mem->page_dir[dir_index] = xcalloc(MEM_PAGE_TABLE_SIZE,
+			sizeof(struct mem_page_t *));
+	assert(!mem->page_dir[dir_index][MEM_PAGE_TABLE_INDEX(addr)]);
+	mem->page_dir[dir_index][MEM_PAGE_TABLE_INDEX(addr)] = page;
 	mem_mapped_space += MEM_PAGE_SIZE;
 	mem_max_mapped_space = MAX(mem_max_mapped_space, mem_mapped_space);
 
@@ -133,28 +141,25 @@ static struct mem_page_t *mem_page_create(struct mem_t *mem, unsigned int addr,
 /* Free mem pages */
 static void mem_page_free(struct mem_t *mem, unsigned int addr)
 {
-	unsigned int index, tag;
-	struct mem_page_t *prev, *page;
+	unsigned int cache_index;
+	struct mem_page_t **table;
+	struct mem_page_t *page;
 	
-	tag = addr & ~(MEM_PAGE_SIZE - 1);
-	index = (addr >> MEM_LOG_PAGE_SIZE) % MEM_PAGE_COUNT;
-	prev = NULL;
-
 	/* Find page */
-	page = mem->pages[index];
-	while (page && page->tag != tag)
-	{
-		prev = page;
-		page = page->next;
-	}
+	table = mem->page_dir[MEM_PAGE_DIR_INDEX(addr)];
+	if (!table)
+		return;
+	page = table[MEM_PAGE_TABLE_INDEX(addr)];
 	if (!page)
 		return;
 	
+	/* Remove from page table and cache of last accessed pages */
+	table[MEM_PAGE_TABLE_INDEX(addr)] = NULL;
+	cache_index = (addr >> MEM_LOG_PAGE_SIZE) % MEM_PAGE_CACHE_SIZE;
+	if (mem->page_cache[cache_index] == page)
+		mem->page_cache[cache_index] = NULL;
+
 	/* Free page */
-	if (prev)
-		prev->next = page->next;
-	else
-		mem->pages[index] = page->next;
 	mem_mapped_space -= MEM_PAGE_SIZE;
 	if (page->data)
 		free(page->data);
@@ -183,6 +188,7 @@ void mem_copy(struct mem_t *mem, unsigned int dest, unsigned int src, int size)
 		page_dest = mem_page_get(mem, dest);
 		page_src = mem_page_get(mem, src);
 		assert(page_src && page_dest);
+		mem_page_modify(page_dest);
 		
 		/* Different actions depending on whether source and
 		 * destination page data are allocated. */
@@ -232,7 +238,11 @@ void *mem_get_buffer(struct mem_t *mem, unsigned int addr, int size,
 	/* Allocate and initialize page data if it does not exist yet. */
 	if (!page->data)
 		page->data = xcalloc(1, MEM_PAGE_SIZE);
-	
+
+	/* The caller can modify the page through the returned pointer */
+	if (access & (mem_access_write | mem_access_init))
+		mem_page_modify(page);
+
 	/* Return pointer to page data */
 	return page->data + offset;
 }
@@ -294,6 +304,7 @@ static void mem_access_page_boundary(struct mem_t *mem, unsigned int addr,
 	{
 		if (!page->data)
 			page->data = xcalloc(1, MEM_PAGE_SIZE);
+		mem_page_modify(page);
 		memcpy(page->data + offset, buf, size);
 		return;
 	}
@@ -312,6 +323,16 @@ void mem_access(struct mem_t *mem, unsigned int addr, int size, void *buf,
 	int chunksize;
 
 	mem->last_address = addr;
+
+	/* Access within one page */
+	offset = addr & (MEM_PAGE_SIZE - 1);
+	if (offset + size <= MEM_PAGE_SIZE)
+	{
+		mem_access_page_boundary(mem, addr, size, buf, access);
+		return;
+	}
+
+	/* Access crossing page boundaries */
 	while (size)
 	{
 		offset = addr & (MEM_PAGE_SIZE - 1);
@@ -325,14 +346,62 @@ void mem_access(struct mem_t *mem, unsigned int addr, int size, void *buf,
 }
 
 
+/* Read and write accesses take a fast path when they fall within one page
+ * with allocated data and the right permissions. Otherwise, the access is
+ * resolved by 'mem_access', which also handles errors and unsafe mode. */
 void mem_read(struct mem_t *mem, unsigned int addr, int size, void *buf)
 {
+	struct mem_page_t *page;
+	unsigned int offset;
+
+	if (mem->record && mem->record_count < MEM_RECORD_SIZE)
+	{
+		mem->record_list[mem->record_count].addr = addr;
+		mem->record_list[mem->record_count].access = mem_access_read;
+		mem->record_count++;
+	}
+
+	offset = addr & (MEM_PAGE_SIZE - 1);
+	if (offset + size <= MEM_PAGE_SIZE)
+	{
+		page = mem_page_get(mem, addr);
+		if (page && page->data && (page->perm & mem_access_read))
+		{
+			mem->last_address = addr;
+			memcpy(buf, page->data + offset, size);
+			return;
+		}
+	}
 	mem_access(mem, addr, size, buf, mem_access_read);
 }
 
 
 void mem_write(struct mem_t *mem, unsigned int addr, int size, void *buf)
 {
+	struct mem_page_t *page;
+	unsigned int offset;
+
+	if (mem->record && mem->record_count < MEM_RECORD_SIZE)
+	{
+		mem->record_list[mem->record_count].addr = addr;
+		mem->record_list[mem->record_count].access = mem_access_write;
+		mem->record_count++;
+	}
+
+	offset = addr & (MEM_PAGE_SIZE - 1);
+	if (offset + size <= MEM_PAGE_SIZE)
+	{
+		page = mem_page_get(mem, addr);
+		if (page && page->data && (page->perm & mem_access_write))
+		{
+			mem->last_address = addr;
+			page->perm |= mem_access_modif;
+			if (page->code)
+				mem_page_modify(page);
+			memcpy(page->data + offset, buf, size);
+			return;
+		}
+	}
 	mem_access(mem, addr, size, buf, mem_access_write);
 }
 
@@ -379,12 +448,23 @@ void mem_unlink(struct mem_t *mem)
 /* Clear memory */
 void mem_clear(struct mem_t *mem)
 {
-	int i;
+	unsigned int addr;
+	unsigned int i, j;
 	
-	for (i = 0; i < MEM_PAGE_COUNT; i++)
-		while (mem->pages[i])
-			mem_page_free(mem, mem->pages[i]->tag);
-
+	for (i = 0; i < MEM_PAGE_DIR_SIZE; i++)
+	{
+		if (!mem->page_dir[i])
+			continue;
+		for (j = 0; j < MEM_PAGE_TABLE_SIZE; j++)
+		{
+			addr = (i << (MEM_LOG_PAGE_SIZE + MEM_PAGE_TABLE_BITS)) |
+				(j << MEM_LOG_PAGE_SIZE);
+			mem_page_free(mem, addr);
+		}
+		free(mem->page_dir[i]);
+		mem->page_dir[i] = NULL;
+	}
+	memset(mem->page_cache, 0, sizeof mem->page_cache);
 }
 
 
@@ -534,6 +614,7 @@ void mem_protect(struct mem_t *mem, unsigned int addr, int size, enum mem_access
 			continue;
 
 		/* Set page new protection flags */
+		mem_page_modify(page);
 		page->perm = perm;
 	}
 }
@@ -628,17 +709,22 @@ void mem_clone(struct mem_t *dst_mem, struct mem_t *src_mem)
 {
 	struct mem_page_t *page;
 
-	int i;
+	int i, j;
 
 	/* Clear destination memory */
 	mem_clear(dst_mem);
 
 	/* Copy pages */
 	dst_mem->safe = 0;
-	for (i = 0; i < MEM_PAGE_COUNT; i++)
+	for (i = 0; i < MEM_PAGE_DIR_SIZE; i++)
 	{
-		for (page = src_mem->pages[i]; page; page = page->next)
+		if (!src_mem->page_dir[i])
+			continue;
+		for (j = 0; j < MEM_PAGE_TABLE_SIZE; j++)
 		{
+			page = src_mem->page_dir[i][j];
+			if (!page)
+				continue;
 			mem_page_create(dst_mem, page->tag, page->perm);
 			if (page->data)
 				mem_access(dst_mem, page->tag, MEM_PAGE_SIZE,
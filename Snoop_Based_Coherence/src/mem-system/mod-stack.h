@@ -68,6 +68,17 @@ struct mod_stack_t
 	struct mod_t *except_mod;
 	struct mod_t *peer;
 
+	/* TLB the access is being translated in, if any. For a TLB access,
+	 * 'mod' and 'addr' are the module and physical address that the access
+	 * is forwarded to once the translation completes, and 'tlb_forward_id'
+	 * is the ID of the module access. */
+	struct tlb_t *tlb;
+	int address_space_index;
+	unsigned int vtl_addr;
+	int tlb_walk_level;
+	long long tlb_walk_start_cycle;
+	long long tlb_forward_id;
+
 	// Creating Module ID. This is used to indicate which module initiated the transaction, so that the snoop request sent doesn't propagate back to the originating module and other verification purposes.
 	int orig_mod_id;
  // This is to indicate which module started the transaction. "orig_mod_id" indicates which Module issued the transaction, say a L2 module sending invalidate to various upper level modules, issue_mod_id indicate which of the following started the original Load/Store/Prefetch instruction.	
@@ -85,6 +96,7 @@ struct mod_stack_t
 	int src_set;
 	int src_way;
 	int src_tag;
+	int src_state;
 
 	//DTS
 	int replace_tag;
@@ -100,6 +112,10 @@ struct mod_stack_t
 	struct mod_stack_t *access_list_prev;
 	struct mod_stack_t *access_list_next;
 
+	/* Linked list of translated accesses forwarded by 'tlb' */
+	struct mod_stack_t *forward_list_prev;
+	struct mod_stack_t *forward_list_next;
+
 	/* Linked list of write accesses in 'mod' */
 	struct mod_stack_t *write_access_list_prev;
 	struct mod_stack_t *write_access_list_next;
@@ -148,17 +164,23 @@ struct mod_stack_t
 	int write : 1;
 	int nc_write : 1;
 	int prefetch : 1;
+	int prefetch_late : 1;  /* Prefetch demanded while in flight */
 	int blocking : 1;
 	int writeback : 1;
 	int eviction : 1;
 	int retry : 1;
+	int lock_retry : 1;  /* Waiting in a lock queue to be retried */
 	int coalesced : 1;
 	int port_locked : 1;
+	int tlb_miss : 1;
+	int tlb_walk : 1;
 	int read_request_in_progress : 1;
 	int write_request_in_progress : 1;
 	//------------------------------------------------
 	// Flag to indicate that dirty line is being transferred to the requesting module.
 	int dirty : 1;
+	// Flag to indicate that a down-up read request found the block in a higher-level module. Unlike 'shared', it is not overwritten by the reply of the lower-level module that a cache which is not inclusive reads in parallel.
+	int snoop_hit : 1;
 	//------------------------------------------------
 	//------------------------------------------------
 	// Flag to indicate that WriteBack to upper level (up-down WB request) is a result of invalidation due to Load/Store/Eviction process.
@@ -168,6 +190,11 @@ struct mod_stack_t
 	int wb_store : 1;
 	int downup_read_request : 1;
 	int downup_writeback_request : 1;
+	// Flags for caches that are not inclusive. An eviction from a higher-level module missing in the cache allocates a block for it, and an up-down request missing in an exclusive cache does not.
+	int victim_fill : 1;
+	int bypass : 1;
+	// Flag for update coherence. A store to a shared block sends the written word to the other copies, and the writer becomes the owner of the block if any of them is kept ('shared').
+	int update : 1;
 
 
 	int downup_access_registered : 1;
@@ -204,10 +231,24 @@ struct mod_stack_t
 	 * This field has a value other than NULL only if 'coalesced' is TRUE. */
 	struct mod_stack_t *master_stack;
 
+	/* MSHR entry allocated by this access as a primary miss, and cycle
+	 * when it started waiting for a free entry, if the MSHR file was full. */
+	struct mshr_entry_t *mshr_entry;
+	long long mshr_stall_start_cycle;
+
 	/* Events waiting in cache lock */
 	int cache_lock_event;
 	struct mod_stack_t *cache_lock_next;
 
+	/* Block lock found busy by a non-blocking access of this request, or
+	 * older up-down request found in flight for the same block if
+	 * 'conflict_set' is -1. If the memory system uses lock queues, the
+	 * request waits for it to be released before retrying. */
+	struct mod_t *conflict_mod;
+	int conflict_set;
+	int conflict_way;
+	long long conflict_id;
+
 	/* Return stack */
 	struct mod_stack_t *ret_stack;
 	int ret_event;
@@ -0,0 +1,82 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mod-stat.h"
+#include "module.h"
+
+
+struct mod_stat_info_t mod_stat_info[mod_stat_count] =
+{
+#define DEFSECTION(file, title)
+#define DEFSTAT(name, flags) \
+	{ #name, flags },
+#include "mod-stat.dat"
+#undef DEFSECTION
+#undef DEFSTAT
+};
+
+/* Sections and counters in report order. Field 'title' is NULL for a
+ * counter. */
+static struct
+{
+	char *title;
+	enum mod_stat_file_t file;
+	enum mod_stat_t stat;
+} mod_stat_entry_list[] =
+{
+#define DEFSECTION(file, title) \
+	{ title, mod_stat_file_##file, 0 },
+#define DEFSTAT(name, flags) \
+	{ NULL, 0, mod_stat_##name },
+#include "mod-stat.dat"
+#undef DEFSECTION
+#undef DEFSTAT
+};
+
+
+void mod_stat_dump(struct mod_t *mod, enum mod_stat_file_t file, FILE *f)
+{
+	struct mod_stat_info_t *info;
+	enum mod_stat_t stat;
+
+	int in_file = 0;
+	int i;
+
+	for (i = 0; i < sizeof mod_stat_entry_list / sizeof mod_stat_entry_list[0]; i++)
+	{
+		/* Section */
+		if (mod_stat_entry_list[i].title)
+		{
+			in_file = mod_stat_entry_list[i].file == file;
+			if (in_file)
+				fprintf(f, "\n===============%s==============================\n",
+					mod_stat_entry_list[i].title);
+			continue;
+		}
+
+		/* Counter */
+		stat = mod_stat_entry_list[i].stat;
+		info = &mod_stat_info[stat];
+		if (!in_file || (info->flags & MOD_STAT_DISABLED))
+			continue;
+		if ((info->flags & MOD_STAT_NONZERO) && !mod->stats.counters[stat])
+			continue;
+		fprintf(f, "%s = %lld\n", info->name, mod->stats.counters[stat]);
+	}
+}
@@ -17,6 +17,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include <lib/esim/esim.h>
 #include <lib/mhandle/mhandle.h>
@@ -37,8 +38,10 @@
 #include "mem-system.h"
 #include "mod-stack.h"
 #include "nmoesi-protocol.h"
+#include "prefetcher.h"
 #include <network/network.h>
 #include <network/node.h>
+#include <network/routing-table.h>
 
 
 /* String map for access type */
@@ -52,6 +55,35 @@ struct str_map_t mod_access_kind_map =
 	}
 };
 
+/* String map for the hash of interleaved ranges */
+struct str_map_t mod_range_hash_map =
+{
+	2, {
+		{ "Modulo", mod_range_hash_modulo },
+		{ "XOR", mod_range_hash_xor }
+	}
+};
+
+/* String map for inclusion policies */
+struct str_map_t mod_inclusion_map =
+{
+	3, {
+		{ "Inclusive", mod_inclusion_inclusive },
+		{ "NINE", mod_inclusion_nine },
+		{ "Exclusive", mod_inclusion_exclusive }
+	}
+};
+
+/* String map for coherence protocols */
+struct str_map_t mod_coherence_map =
+{
+	3, {
+		{ "Invalidate", mod_coherence_invalidate },
+		{ "Update", mod_coherence_update },
+		{ "Competitive", mod_coherence_competitive }
+	}
+};
+
 
 
 
@@ -69,6 +101,7 @@ struct mod_t *mod_create(char *name, enum mod_kind_t kind, int num_ports,
 	mod->name = xstrdup(name);
 	mod->kind = kind;
 	mod->latency = latency;
+	mod->num_slices = 1;
 
 	/* Ports */
 	mod->num_ports = num_ports;
@@ -131,7 +164,10 @@ void mod_free(struct mod_t *mod)
 	if (mod->cache)
 		cache_free(mod->cache);
 	free(mod->ports);
+	free(mod->mshr);
+	free(mod->mshr_occupancy);
 	repos_free(mod->client_info_repos);
+	free(mod->slice_name);
 	free(mod->name);
 	free(mod);
 }
@@ -142,30 +178,33 @@ void mod_dump(struct mod_t *mod, FILE *f)
 }
 
 
-/* Access a memory module.
- * Variable 'witness', if specified, will be increased when the access completes.
- * The function returns a unique access ID.
- */
-long long mod_access(struct mod_t *mod, enum mod_access_kind_t access_kind, 
-	unsigned int addr, int *witness_ptr, struct linked_list_t *event_queue,
-	void *event_queue_item, struct mod_client_info_t *client_info)
+/* Reset the statistics of a module. The MSHR occupancy histogram restarts
+ * from the current cycle. */
+void mod_reset_stats(struct mod_t *mod)
 {
-	struct mod_stack_t *stack;
+	memset(&mod->stats, 0, sizeof mod->stats);
+	if (mod->mshr_occupancy)
+	{
+		memset(mod->mshr_occupancy, 0, (mod->mshr_size + 1) * sizeof(long long));
+		mod->mshr_occupancy_cycle = esim_cycle();
+	}
+
+	if (mod->cache && mod->cache->prefetcher)
+		prefetcher_reset_stats(mod->cache->prefetcher);
+}
+
+
+/* Select the initial event for an access of kind 'access_kind' to the module
+ * in 'stack', and start it. */
+static void mod_access_stack(struct mod_stack_t *stack,
+	enum mod_access_kind_t access_kind)
+{
+	struct mod_t *mod = stack->mod;
 	int event;
 
-	/* Create module stack with new ID */
-	mod_stack_id++;
-	stack = mod_stack_create(mod_stack_id,
-		mod, addr, ESIM_EV_NONE, NULL);
 	stack->orig_mod_id = mod->mod_id;
 	stack->issue_mod_id = mod->mod_id;
 
-	/* Initialize */
-	stack->witness_ptr = witness_ptr;
-	stack->event_queue = event_queue;
-	stack->event_queue_item = event_queue_item;
-	stack->client_info = client_info;
-
 	/* Select initial CPU/GPU event */
 	if (mod->kind == mod_kind_cache || mod->kind == mod_kind_main_memory)
 	{
@@ -212,6 +251,55 @@ long long mod_access(struct mod_t *mod, enum mod_access_kind_t access_kind,
 
 	/* Schedule */
 	esim_execute_event(event, stack);
+}
+
+
+/* Access a memory module.
+ * Variable 'witness', if specified, will be increased when the access completes.
+ * The function returns a unique access ID.
+ */
+long long mod_access(struct mod_t *mod, enum mod_access_kind_t access_kind, 
+	unsigned int addr, int *witness_ptr, struct linked_list_t *event_queue,
+	void *event_queue_item, struct mod_client_info_t *client_info)
+{
+	struct mod_stack_t *stack;
+
+	/* Create module stack with new ID */
+	mod_stack_id++;
+	stack = mod_stack_create(mod_stack_id,
+		mod, addr, ESIM_EV_NONE, NULL);
+
+	/* Initialize */
+	stack->witness_ptr = witness_ptr;
+	stack->event_queue = event_queue;
+	stack->event_queue_item = event_queue_item;
+	stack->client_info = client_info;
+
+	/* Start access */
+	mod_access_stack(stack, access_kind);
+
+	/* Return access ID */
+	return stack->id;
+}
+
+
+/* Access a memory module on behalf of another stack in the memory system,
+ * e.g., a page table walk. When the access completes, event 'ret_event' is
+ * scheduled for 'ret_stack'. The function returns the new access ID. */
+long long mod_access_with_return(struct mod_t *mod,
+	enum mod_access_kind_t access_kind, unsigned int addr,
+	int ret_event, struct mod_stack_t *ret_stack)
+{
+	struct mod_stack_t *stack;
+
+	/* Create module stack with new ID. The client information is owned by
+	 * the returning stack, so it must not be inherited. */
+	mod_stack_id++;
+	stack = mod_stack_create(mod_stack_id, mod, addr, ret_event, ret_stack);
+	stack->client_info = NULL;
+
+	/* Start access */
+	mod_access_stack(stack, access_kind);
 
 	/* Return access ID */
 	return stack->id;
@@ -221,8 +309,6 @@ long long mod_access(struct mod_t *mod, enum mod_access_kind_t access_kind,
 /* Return true if module can be accessed. */
 int mod_can_access(struct mod_t *mod, unsigned int addr)
 {
-	int non_coalesced_accesses;
-
 	/* There must be a free port */
 	assert(mod->num_locked_ports <= mod->num_ports);
 	if (mod->num_locked_ports == mod->num_ports)
@@ -232,11 +318,242 @@ int mod_can_access(struct mod_t *mod, unsigned int addr)
 	if (!mod->mshr_size)
 		return 1;
 
-	/* Module can be accessed if number of non-coalesced in-flight
-	 * accesses is smaller than the MSHR size. */
-	non_coalesced_accesses = mod->access_list_count -
-		mod->access_list_coalesced_count;
-	return non_coalesced_accesses < mod->mshr_size;
+	/* An access to a block with a miss in flight can be attached to the
+	 * MSHR entry of the miss. Otherwise, there must be a free MSHR entry
+	 * in case the access misses. */
+	return mod_mshr_find(mod, addr) || mod_mshr_can_allocate(mod);
+}
+
+
+/* Account for the cycles spent with the current number of occupied MSHR
+ * entries. Called before the occupancy changes. */
+static void mod_mshr_update_occupancy(struct mod_t *mod)
+{
+	long long cycle = esim_cycle();
+
+	assert(mod->num_occupied_mshr <= mod->mshr_size);
+	mod->mshr_occupancy[mod->num_occupied_mshr] += cycle - mod->mshr_occupancy_cycle;
+	mod->mshr_occupancy_cycle = cycle;
+}
+
+
+/* Return the MSHR entry tracking a miss to the block containing 'addr',
+ * or NULL if there is no miss in flight to that block. */
+struct mshr_entry_t *mod_mshr_find(struct mod_t *mod, unsigned int addr)
+{
+	struct mshr_entry_t *mshr_entry;
+	int i;
+
+	for (i = 0; i < mod->mshr_size; i++)
+	{
+		mshr_entry = &mod->mshr[i];
+		if (mshr_entry->valid && mshr_entry->addr >> mod->log_block_size ==
+				addr >> mod->log_block_size)
+			return mshr_entry;
+	}
+
+	/* Not found */
+	return NULL;
+}
+
+
+/* Return true if an MSHR entry can be allocated in the module. */
+int mod_mshr_can_allocate(struct mod_t *mod)
+{
+	return !mod->mshr_size || mod->num_occupied_mshr < mod->mshr_size;
+}
+
+
+/* Allocate an MSHR entry for the primary miss in 'stack'. If the MSHR file is
+ * full, the function returns FALSE and the caller must enqueue the access in
+ * the module waiting list, where it is woken up when an entry is released. */
+int mod_mshr_allocate(struct mod_t *mod, struct mod_stack_t *stack)
+{
+	struct mshr_entry_t *mshr_entry;
+	int i;
+
+	/* Module does not model an MSHR file */
+	assert(!stack->mshr_entry);
+	if (!mod->mshr_size)
+		return 1;
+
+	/* MSHR file full */
+	if (!mod_mshr_can_allocate(mod))
+	{
+		mem_debug("    %lld MSHR full, waiting for free entry\n", stack->id);
+		stack->mshr_stall_start_cycle = esim_cycle();
+		mod->stats.mshr_full_stalls++;
+		return 0;
+	}
+
+	/* Find free entry */
+	for (i = 0; i < mod->mshr_size; i++)
+		if (!mod->mshr[i].valid)
+			break;
+	assert(i < mod->mshr_size);
+	mshr_entry = &mod->mshr[i];
+	assert(!mshr_entry->waiting_list_count);
+
+	/* Allocate */
+	mod_mshr_update_occupancy(mod);
+	mod->num_occupied_mshr++;
+	mod->stats.mshr_allocations++;
+	mshr_entry->valid = 1;
+	mshr_entry->lock_when = esim_cycle();
+	mshr_entry->addr = stack->addr & ~(mod->block_size - 1);
+	mshr_entry->stack = stack;
+	stack->mshr_entry = mshr_entry;
+	return 1;
+}
+
+
+/* Return true if the access in 'stack' can be attached as a secondary miss
+ * to an MSHR entry. Loads can be attached to any pending fill, while stores
+ * only merge into fills granting ownership of the block, that is, into
+ * primary store misses. In both cases, the access must not bypass any other
+ * access it would otherwise have to wait for. */
+int mod_mshr_can_merge(struct mod_t *mod, struct mshr_entry_t *mshr_entry,
+	struct mod_stack_t *stack)
+{
+	struct mod_stack_t *primary_stack = mshr_entry->stack;
+	struct mod_stack_t *older_stack;
+
+	assert(mshr_entry->valid);
+	switch (stack->access_kind)
+	{
+
+	case mod_access_load:
+
+		/* Prefetches can be aborted without filling the block */
+		if (primary_stack->access_kind == mod_access_prefetch)
+			return 0;
+
+		/* Loads wait for older writes */
+		older_stack = mod_in_flight_write(mod, stack);
+		if (older_stack && older_stack->id > primary_stack->id &&
+				older_stack->master_stack != primary_stack)
+			return 0;
+
+		/* The youngest older access to the block must complete with the fill */
+		older_stack = mod_in_flight_address(mod, stack->addr, stack);
+		return older_stack == primary_stack || (older_stack &&
+			older_stack->master_stack == primary_stack);
+
+	case mod_access_store:
+
+		/* Stores wait for all older accesses */
+		if (primary_stack->access_kind != mod_access_store)
+			return 0;
+		older_stack = stack->access_list_prev;
+		return older_stack == primary_stack || (older_stack &&
+			older_stack->master_stack == primary_stack);
+
+	default:
+		return 0;
+	}
+}
+
+
+/* Attach the access in 'stack' to the target list of an MSHR entry. The
+ * access continues with 'event' when the primary miss completes. */
+void mod_mshr_merge(struct mod_t *mod, struct mshr_entry_t *mshr_entry,
+	struct mod_stack_t *stack, int event)
+{
+	assert(mshr_entry->valid);
+	assert(!DOUBLE_LINKED_LIST_MEMBER(mshr_entry, waiting, stack));
+
+	/* Record as coalesced with the primary miss */
+	mod_coalesce(mod, mshr_entry->stack, stack);
+	if (stack->access_kind == mod_access_store)
+		mod->stats.mshr_store_merges++;
+	else
+		mod->stats.mshr_load_merges++;
+
+	/* Enqueue in target list */
+	stack->waiting_list_event = event;
+	DOUBLE_LINKED_LIST_INSERT_TAIL(mshr_entry, waiting, stack);
+}
+
+
+/* Release the MSHR entry allocated by the primary miss in 'stack', if any,
+ * once the block has been filled. Targets are moved to the wait list of the
+ * primary miss so that they complete together with it, and accesses waiting
+ * for a free entry are woken up. */
+void mod_mshr_release(struct mod_t *mod, struct mod_stack_t *stack)
+{
+	struct mshr_entry_t *mshr_entry = stack->mshr_entry;
+	struct mod_stack_t *target_stack;
+	int event;
+
+	/* No entry allocated */
+	if (!mshr_entry)
+		return;
+	assert(mshr_entry->valid && mshr_entry->stack == stack);
+
+	/* Move targets */
+	while (mshr_entry->waiting_list_head)
+	{
+		target_stack = mshr_entry->waiting_list_head;
+		DOUBLE_LINKED_LIST_REMOVE(mshr_entry, waiting, target_stack);
+		DOUBLE_LINKED_LIST_INSERT_TAIL(stack, waiting, target_stack);
+	}
+
+	/* Free entry */
+	mod_mshr_update_occupancy(mod);
+	mod->num_occupied_mshr--;
+	mshr_entry->valid = 0;
+	mshr_entry->stack = NULL;
+	stack->mshr_entry = NULL;
+
+	/* Wake up accesses waiting for a free entry */
+	while (mod->waiting_list_head)
+	{
+		target_stack = mod->waiting_list_head;
+		event = target_stack->waiting_list_event;
+		mod->stats.mshr_full_stall_cycles += esim_cycle() -
+			target_stack->mshr_stall_start_cycle;
+		target_stack->mshr_stall_start_cycle = 0;
+		DOUBLE_LINKED_LIST_REMOVE(mod, waiting, target_stack);
+		esim_schedule_event(event, target_stack, 0);
+	}
+}
+
+
+void mod_mshr_dump(struct mod_t *mod, FILE *f)
+{
+	double occupancy = 0.0;
+	long long cycles = 0;
+	int i;
+
+	/* Module does not model an MSHR file */
+	if (!mod->mshr_size)
+		return;
+
+	/* Account for the cycles since the last change in occupancy. The
+	 * histogram covers the cycles since statistics were last reset. */
+	mod_mshr_update_occupancy(mod);
+	for (i = 0; i <= mod->mshr_size; i++)
+		cycles += mod->mshr_occupancy[i];
+	if (cycles)
+	{
+		for (i = 1; i <= mod->mshr_size; i++)
+			occupancy += (double) i * mod->mshr_occupancy[i];
+		occupancy /= cycles;
+	}
+
+	fprintf(f, "MSHR = %d\n", mod->mshr_size);
+	fprintf(f, "MSHRAllocations = %lld\n", mod->stats.mshr_allocations);
+	fprintf(f, "MSHRLoadMerges = %lld\n", mod->stats.mshr_load_merges);
+	fprintf(f, "MSHRStoreMerges = %lld\n", mod->stats.mshr_store_merges);
+	fprintf(f, "MSHRFullStalls = %lld\n", mod->stats.mshr_full_stalls);
+	fprintf(f, "MSHRFullStallCycles = %lld\n", mod->stats.mshr_full_stall_cycles);
+	fprintf(f, "MSHRAverageOccupancy = %.4g\n", occupancy);
+	fprintf(f, "MSHROccupancy =");
+	for (i = 0; i <= mod->mshr_size; i++)
+		if (mod->mshr_occupancy[i])
+			fprintf(f, " %d:%lld", i, mod->mshr_occupancy[i]);
+	fprintf(f, "\n");
+	fprintf(f, "\n");
 }
 
 
@@ -354,20 +671,20 @@ void mod_lock_port(struct mod_t *mod, struct mod_stack_t *stack, int event)
 		if(stack->read)
 		{
 			if(stack->downup_read_request)
-				mod->downup_read_waiting_for_mod_port++;
+				MOD_STAT_INC(mod, downup_read_waiting_for_mod_port);
 			else
-				mod->read_waiting_for_mod_port++;
+				MOD_STAT_INC(mod, read_waiting_for_mod_port);
 		}
 
 		if(stack->write)
 		{
 			if(stack->evict_trans)
-				mod->eviction_waiting_for_mod_port++;
+				MOD_STAT_INC(mod, eviction_waiting_for_mod_port);
 
 			if(stack->downup_writeback_request)
-				mod->downup_writeback_waiting_for_mod_port++;
+				MOD_STAT_INC(mod, downup_writeback_waiting_for_mod_port);
 			else
-				mod->write_waiting_for_mod_port++;
+				MOD_STAT_INC(mod, write_waiting_for_mod_port);
 		}
 
 		if(!stack->mod_port_waiting_start_cycle)
@@ -565,8 +882,7 @@ int mod_serves_address(struct mod_t *mod, unsigned int addr)
 
 	/* Interleaved addresses */
 	if (mod->range_kind == mod_range_interleaved)
-		return (addr / mod->range.interleaved.div) %
-			mod->range.interleaved.mod ==
+		return mod_range_interleaved_index(mod, addr) ==
 			mod->range.interleaved.eq;
 
 	/* Invalid */
@@ -575,6 +891,35 @@ int mod_serves_address(struct mod_t *mod, unsigned int addr)
 }
 
 
+/* Return the position of an address among the modules of an interleaved
+ * range, to be compared with 'range.interleaved.eq'. With the XOR hash, all
+ * log2(mod)-bit chunks of 'addr / div' are folded together, which spreads
+ * power-of-two strides over all modules. The hash only reorders the units of
+ * 'div' bytes within each group of 'mod' consecutive ones, so 'addr / div /
+ * mod' still identifies a unit within a module. */
+unsigned int mod_range_interleaved_index(struct mod_t *mod, unsigned int addr)
+{
+	unsigned int num_mods = mod->range.interleaved.mod;
+	unsigned int unit = addr / mod->range.interleaved.div;
+	unsigned int index;
+	int log_num_mods;
+
+	assert(mod->range_kind == mod_range_interleaved);
+	if (mod->range.interleaved.hash == mod_range_hash_modulo)
+		return unit % num_mods;
+
+	/* XOR hash */
+	assert(mod->range.interleaved.hash == mod_range_hash_xor);
+	assert(!(num_mods & (num_mods - 1)));
+	if (num_mods == 1)
+		return 0;
+	log_num_mods = log_base2(num_mods);
+	for (index = 0; unit; unit >>= log_num_mods)
+		index ^= unit & (num_mods - 1);
+	return index;
+}
+
+
 /* Return the low module serving a given address. */
 struct mod_t *mod_get_low_mod(struct mod_t *mod, unsigned int addr)
 {
@@ -623,6 +968,68 @@ int mod_get_retry_latency(struct mod_t *mod)
 }
 
 
+/* Return the latency of an access to 'mod' coming from its higher-level module
+ * 'high_mod'. Besides the module latency, 'hop_latency' cycles are added for
+ * each hop between both modules in the network topology. */
+int mod_get_access_latency(struct mod_t *mod, struct mod_t *high_mod)
+{
+	struct net_routing_table_entry_t *entry;
+
+	if (!mod->hop_latency || !high_mod || mod->high_net != high_mod->low_net)
+		return mod->latency;
+
+	entry = net_routing_table_lookup(mod->high_net->routing_table,
+		mod->high_net_node, high_mod->low_net_node);
+	return mod->latency + mod->hop_latency * entry->cost;
+}
+
+
+/* Return the number of valid blocks in cache 'mod' that are also present in
+ * one of its higher-level modules, and the number of valid blocks in
+ * 'valid_ptr'. For an inclusive cache, these duplicates are the capacity lost
+ * to inclusion. */
+int mod_count_duplicate_blocks(struct mod_t *mod, int *valid_ptr)
+{
+	struct cache_t *cache = mod->cache;
+	struct mod_t *high_mod;
+
+	unsigned int addr;
+	int set;
+	int way;
+	int tag;
+	int state;
+	int present;
+	int valid = 0;
+	int duplicate = 0;
+
+	for (set = 0; set < cache->num_sets; set++)
+	{
+		for (way = 0; way < cache->assoc; way++)
+		{
+			cache_get_block(cache, set, way, &tag, &state);
+			if (!state)
+				continue;
+			valid++;
+
+			/* Look for any sub-block in the higher-level modules */
+			present = 0;
+			LINKED_LIST_FOR_EACH(mod->high_mod_list)
+			{
+				high_mod = linked_list_get(mod->high_mod_list);
+				for (addr = tag; addr < tag + mod->block_size && !present;
+						addr += high_mod->block_size)
+					present = mod_find_block(high_mod, addr, NULL, NULL, NULL, NULL);
+			}
+			if (present)
+				duplicate++;
+		}
+	}
+
+	PTR_ASSIGN(valid_ptr, valid);
+	return duplicate;
+}
+
+
 /* Check if an access to a module can be coalesced with another access older
  * than 'older_than_stack'. If 'older_than_stack' is NULL, check if it can
  * be coalesced with any in-flight access.
@@ -819,14 +1226,14 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 			{
 				if(mod->num_load_requests >= pow_2(9))
 				{
-					mod->request_load[9]++;
+					mod->stats.request_load[9]++;
 					break;
 				}
 
 				for(int i=0; i<10; i++)
 					if(req_variable_in_range(mod->num_load_requests, pow_2(i-1), pow_2(i) - 1))
 					{
-						mod->request_load[i]++;
+						mod->stats.request_load[i]++;
 						break;
 					}
  			 	break;
@@ -835,14 +1242,14 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 			{
 				if(mod->num_store_requests >= pow_2(9))
 				{
-					mod->request_store[9]++;
+					mod->stats.request_store[9]++;
 					break;
 				}
 
 				for(int i=0; i<10; i++)
 					if(req_variable_in_range(mod->num_store_requests, pow_2(i-1), pow_2(i) - 1))
 					{
-						mod->request_store[i]++;
+						mod->stats.request_store[i]++;
 						break;
 					}
  			 	break;
@@ -851,14 +1258,14 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 			{
 				if(mod->num_writeback_requests >= pow_2(9))
 				{
-					mod->request_writeback[9]++;
+					mod->stats.request_writeback[9]++;
 					break;
 				}
 
 				for(int i=0; i<10; i++)
 					if(req_variable_in_range(mod->num_writeback_requests, pow_2(i-1), pow_2(i) - 1))
 					{
-						mod->request_writeback[i]++;
+						mod->stats.request_writeback[i]++;
 						break;
 					}
  			 	break;
@@ -867,14 +1274,14 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 			{
 				if(mod->num_eviction_requests >= pow_2(9))
 				{
-					mod->request_eviction[9]++;
+					mod->stats.request_eviction[9]++;
 					break;
 				}
 
 				for(int i=0; i<10; i++)
 					if(req_variable_in_range(mod->num_eviction_requests, pow_2(i-1), pow_2(i) - 1))
 					{
-						mod->request_eviction[i]++;
+						mod->stats.request_eviction[i]++;
 						break;
 					}
  			 	break;
@@ -883,14 +1290,14 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 			{
 				if(mod->num_downup_read_requests >= pow_2(9))
 				{
-					mod->request_downup_read[9]++;
+					mod->stats.request_downup_read[9]++;
 					break;
 				}
 
 				for(int i=0; i<10; i++)
 					if(req_variable_in_range(mod->num_downup_read_requests, pow_2(i-1), pow_2(i) - 1))
 					{
-						mod->request_downup_read[i]++;
+						mod->stats.request_downup_read[i]++;
 						break;
 					}
  			 	break;
@@ -899,14 +1306,14 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 			{
 				if(mod->num_downup_writeback_requests >= pow_2(9))
 				{
-					mod->request_downup_writeback[9]++;
+					mod->stats.request_downup_writeback[9]++;
 					break;
 				}
 
 				for(int i=0; i<10; i++)
 					if(req_variable_in_range(mod->num_downup_writeback_requests, pow_2(i-1), pow_2(i) - 1))
 					{
-						mod->request_downup_writeback[i]++;
+						mod->stats.request_downup_writeback[i]++;
 						break;
 					}
  			 	break;
@@ -915,14 +1322,14 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 			{
 				if(mod->num_downup_eviction_requests >= pow_2(9))
 				{
-					mod->request_downup_eviction[9]++;
+					mod->stats.request_downup_eviction[9]++;
 					break;
 				}
 
 				for(int i=0; i<10; i++)
 					if(req_variable_in_range(mod->num_downup_eviction_requests, pow_2(i-1), pow_2(i) - 1))
 					{
-						mod->request_downup_eviction[i]++;
+						mod->stats.request_downup_eviction[i]++;
 						break;
 					}
  			 	break;
@@ -936,52 +1343,52 @@ void mod_update_request_counters(struct mod_t *mod , enum mod_trans_type_t trans
 	total_requests = updown_request + downup_request;
 
 	if(processor_request >= pow_2(10))
-		mod->request_processor[10]++;
+		mod->stats.request_processor[10]++;
 	else
 		for(int i=0; i<11; i++)
 			if(req_variable_in_range(processor_request, pow_2(i-1), pow_2(i) - 1))
 			{
-				mod->request_processor[i]++;
+				mod->stats.request_processor[i]++;
 				break;
 			}
 
 	if(controller_request >= pow_2(10))
-		mod->request_controller[10]++;
+		mod->stats.request_controller[10]++;
 	else
 		for(int i=0; i<11; i++)
 			if(req_variable_in_range(controller_request, pow_2(i-1), pow_2(i) - 1))
 			{
-				mod->request_controller[i]++;
+				mod->stats.request_controller[i]++;
 				break;
 			}
 
 	if(downup_request >= pow_2(10))
-		mod->request_downup[10]++;
+		mod->stats.request_downup[10]++;
 	else
 		for(int i=0; i<11; i++)
 			if(req_variable_in_range(downup_request, pow_2(i-1), pow_2(i) - 1))
 			{
-				mod->request_downup[i]++;
+				mod->stats.request_downup[i]++;
 				break;
 			}
 
 	if(updown_request >= pow_2(10))
-		mod->request_updown[10]++;
+		mod->stats.request_updown[10]++;
 	else
 		for(int i=0; i<11; i++)
 			if(req_variable_in_range(updown_request, pow_2(i-1), pow_2(i) - 1))
 			{
-				mod->request_updown[i]++;
+				mod->stats.request_updown[i]++;
 				break;
 			}
 
 	if(total_requests >= pow_2(11))
-		mod->request_total[11]++;
+		mod->stats.request_total[11]++;
 	else
 		for(int i=0; i<12; i++)
 			if(req_variable_in_range(total_requests, pow_2(i-1), pow_2(i) - 1))
 			{
-				mod->request_total[i]++;
+				mod->stats.request_total[i]++;
 				break;
 			}
 }
@@ -1005,352 +1412,42 @@ void mod_update_state_modification_counters(struct mod_t *mod, enum cache_block_
 	assert((trans_type == mod_trans_downup_writeback_request) && (prev_state == cache_block_invalid));
 	assert((trans_type == mod_trans_downup_writeback_request) && (next_state != cache_block_invalid));
 	
-	switch(trans_type)
-	{
-		case mod_trans_load :
-		{
-			switch(prev_state)
-			{
-				case cache_block_invalid : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->load_state_invalid_to_invalid++;break; }
-							case cache_block_modified    : { mod->load_state_invalid_to_modified++;break; }
-							case cache_block_owned       : { mod->load_state_invalid_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->load_state_invalid_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->load_state_invalid_to_shared++;break; }
-							case cache_block_noncoherent : { mod->load_state_invalid_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_modified : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->load_state_modified_to_invalid++;break; }
-							case cache_block_modified    : { mod->load_state_modified_to_modified++;break; }
-							case cache_block_owned       : { mod->load_state_modified_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->load_state_modified_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->load_state_modified_to_shared++;break; }
-							case cache_block_noncoherent : { mod->load_state_modified_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_owned : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->load_state_owned_to_invalid++;break; }
-							case cache_block_modified    : { mod->load_state_owned_to_modified++;break; }
-							case cache_block_owned       : { mod->load_state_owned_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->load_state_owned_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->load_state_owned_to_shared++;break; }
-							case cache_block_noncoherent : { mod->load_state_owned_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_exclusive : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->load_state_exclusive_to_invalid++;break; }
-							case cache_block_modified    : { mod->load_state_exclusive_to_modified++;break; }
-							case cache_block_owned       : { mod->load_state_exclusive_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->load_state_exclusive_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->load_state_exclusive_to_shared++;break; }
-							case cache_block_noncoherent : { mod->load_state_exclusive_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_shared : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->load_state_shared_to_invalid++;break; }
-							case cache_block_modified    : { mod->load_state_shared_to_modified++;break; }
-							case cache_block_owned       : { mod->load_state_shared_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->load_state_shared_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->load_state_shared_to_shared++;break; }
-							case cache_block_noncoherent : { mod->load_state_shared_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_noncoherent : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->load_state_noncoherent_to_invalid++;break; }
-							case cache_block_modified    : { mod->load_state_noncoherent_to_modified++;break; }
-							case cache_block_owned       : { mod->load_state_noncoherent_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->load_state_noncoherent_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->load_state_noncoherent_to_shared++;break; }
-							case cache_block_noncoherent : { mod->load_state_noncoherent_to_noncoherent++;break; }
-						}
-						break;
-					}
-			}
-			break;
-		}
-
-		case mod_trans_store :
-		{
-			switch(prev_state)
-			{
-				case cache_block_invalid : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->store_state_invalid_to_invalid++;break; }
-							case cache_block_modified    : { mod->store_state_invalid_to_modified++;break; }
-							case cache_block_owned       : { mod->store_state_invalid_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->store_state_invalid_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->store_state_invalid_to_shared++;break; }
-							case cache_block_noncoherent : { mod->store_state_invalid_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_modified : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->store_state_modified_to_invalid++;break; }
-							case cache_block_modified    : { mod->store_state_modified_to_modified++;break; }
-							case cache_block_owned       : { mod->store_state_modified_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->store_state_modified_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->store_state_modified_to_shared++;break; }
-							case cache_block_noncoherent : { mod->store_state_modified_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_owned : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->store_state_owned_to_invalid++;break; }
-							case cache_block_modified    : { mod->store_state_owned_to_modified++;break; }
-							case cache_block_owned       : { mod->store_state_owned_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->store_state_owned_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->store_state_owned_to_shared++;break; }
-							case cache_block_noncoherent : { mod->store_state_owned_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_exclusive : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->store_state_exclusive_to_invalid++;break; }
-							case cache_block_modified    : { mod->store_state_exclusive_to_modified++;break; }
-							case cache_block_owned       : { mod->store_state_exclusive_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->store_state_exclusive_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->store_state_exclusive_to_shared++;break; }
-							case cache_block_noncoherent : { mod->store_state_exclusive_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_shared : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->store_state_shared_to_invalid++;break; }
-							case cache_block_modified    : { mod->store_state_shared_to_modified++;break; }
-							case cache_block_owned       : { mod->store_state_shared_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->store_state_shared_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->store_state_shared_to_shared++;break; }
-							case cache_block_noncoherent : { mod->store_state_shared_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_noncoherent : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->store_state_noncoherent_to_invalid++;break; }
-							case cache_block_modified    : { mod->store_state_noncoherent_to_modified++;break; }
-							case cache_block_owned       : { mod->store_state_noncoherent_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->store_state_noncoherent_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->store_state_noncoherent_to_shared++;break; }
-							case cache_block_noncoherent : { mod->store_state_noncoherent_to_noncoherent++;break; }
-						}
-						break;
-					}
-			}
-			break;
-		}
-
-		case mod_trans_downup_read_request :
-		{
-			switch(prev_state)
-			{
-				case cache_block_invalid : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_read_req_state_invalid_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_read_req_state_invalid_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_read_req_state_invalid_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_read_req_state_invalid_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_read_req_state_invalid_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_read_req_state_invalid_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_modified : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_read_req_state_modified_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_read_req_state_modified_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_read_req_state_modified_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_read_req_state_modified_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_read_req_state_modified_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_read_req_state_modified_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_owned : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_read_req_state_owned_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_read_req_state_owned_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_read_req_state_owned_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_read_req_state_owned_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_read_req_state_owned_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_read_req_state_owned_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_exclusive : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_read_req_state_exclusive_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_read_req_state_exclusive_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_read_req_state_exclusive_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_read_req_state_exclusive_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_read_req_state_exclusive_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_read_req_state_exclusive_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_shared : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_read_req_state_shared_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_read_req_state_shared_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_read_req_state_shared_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_read_req_state_shared_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_read_req_state_shared_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_read_req_state_shared_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_noncoherent : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_read_req_state_noncoherent_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_read_req_state_noncoherent_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_read_req_state_noncoherent_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_read_req_state_noncoherent_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_read_req_state_noncoherent_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_read_req_state_noncoherent_to_noncoherent++;break; }
-						}
-						break;
-					}
-			}
-			break;
-		}
-
-		case mod_trans_downup_writeback_request :
-		{
-			switch(prev_state)
-			{
-				case cache_block_invalid : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_wb_req_state_invalid_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_wb_req_state_invalid_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_wb_req_state_invalid_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_wb_req_state_invalid_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_wb_req_state_invalid_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_wb_req_state_invalid_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_modified : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_wb_req_state_modified_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_wb_req_state_modified_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_wb_req_state_modified_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_wb_req_state_modified_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_wb_req_state_modified_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_wb_req_state_modified_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_owned : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_wb_req_state_owned_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_wb_req_state_owned_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_wb_req_state_owned_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_wb_req_state_owned_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_wb_req_state_owned_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_wb_req_state_owned_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_exclusive : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_wb_req_state_exclusive_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_wb_req_state_exclusive_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_wb_req_state_exclusive_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_wb_req_state_exclusive_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_wb_req_state_exclusive_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_wb_req_state_exclusive_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_shared : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_wb_req_state_shared_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_wb_req_state_shared_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_wb_req_state_shared_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_wb_req_state_shared_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_wb_req_state_shared_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_wb_req_state_shared_to_noncoherent++;break; }
-						}
-						break;
-					}
-				case cache_block_noncoherent : 
-					{
-						switch(next_state)
-						{
-							case cache_block_invalid     : { mod->downup_wb_req_state_noncoherent_to_invalid++;break; }
-							case cache_block_modified    : { mod->downup_wb_req_state_noncoherent_to_modified++;break; }
-							case cache_block_owned       : { mod->downup_wb_req_state_noncoherent_to_owned++;break; }
-							case cache_block_exclusive 	 : { mod->downup_wb_req_state_noncoherent_to_exclusive++;break; }
-							case cache_block_shared 		 : { mod->downup_wb_req_state_noncoherent_to_shared++;break; }
-							case cache_block_noncoherent : { mod->downup_wb_req_state_noncoherent_to_noncoherent++;break; }
-						}
-						break;
-					}
-			}
-			break;
-		}
+	/* Counters of a transition type are laid out in 'mod-stat.dat' as a
+	 * 6x6 matrix, with states in report order */
+	static const int pos[] =
+	{
+		[cache_block_invalid] = 0,
+		[cache_block_noncoherent] = 1,
+		[cache_block_modified] = 2,
+		[cache_block_shared] = 3,
+		[cache_block_owned] = 4,
+		[cache_block_exclusive] = 5
+	};
+	enum mod_stat_t first;
+
+	switch (trans_type)
+	{
+	case mod_trans_load:
+		first = mod_stat_load_state_invalid_to_invalid;
+		break;
+	case mod_trans_store:
+		first = mod_stat_store_state_invalid_to_invalid;
+		break;
+	case mod_trans_downup_read_request:
+		first = mod_stat_downup_read_req_state_invalid_to_invalid;
+		break;
+	case mod_trans_downup_writeback_request:
+		first = mod_stat_downup_wb_req_state_invalid_to_invalid;
+		break;
+	default:
+		return;
 	}
+
+	/* Callers may pass a state they never assigned */
+	if ((unsigned) prev_state >= sizeof pos / sizeof pos[0] ||
+			(unsigned) next_state >= sizeof pos / sizeof pos[0])
+		return;
+	MOD_STAT_INC_ID(mod, first + pos[prev_state] * 6 + pos[next_state]);
 }
 
 void mod_update_latency_counters(struct mod_t *mod, long long latency, enum mod_trans_type_t trans_type)
@@ -1359,15 +1456,15 @@ void mod_update_latency_counters(struct mod_t *mod, long long latency, enum mod_
 	{
 		switch(trans_type)
 		{
-			case mod_trans_load :                     mod->load_latency[9]++; break;
-			case mod_trans_store :                    mod->store_latency[9]++; break;
-			case mod_trans_read_request :             mod->read_request_latency[9]++; break;
-			case mod_trans_writeback :                mod->writeback_request_latency[9]++; break;
-			case mod_trans_eviction :                 mod->eviction_latency[9]++; break;
-			case mod_trans_downup_read_request :      mod->downup_read_request_latency[9]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_request_latency[9]++; break;
-			case mod_trans_peer_request :             mod->peer_latency[9]++; break;
-			case mod_trans_invalidate :               mod->invalidate_latency[9]++; break;
+			case mod_trans_load :                     mod->stats.load_latency[9]++; break;
+			case mod_trans_store :                    mod->stats.store_latency[9]++; break;
+			case mod_trans_read_request :             mod->stats.read_request_latency[9]++; break;
+			case mod_trans_writeback :                mod->stats.writeback_request_latency[9]++; break;
+			case mod_trans_eviction :                 mod->stats.eviction_latency[9]++; break;
+			case mod_trans_downup_read_request :      mod->stats.downup_read_request_latency[9]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_request_latency[9]++; break;
+			case mod_trans_peer_request :             mod->stats.peer_latency[9]++; break;
+			case mod_trans_invalidate :               mod->stats.invalidate_latency[9]++; break;
 		}
 		return;
 	}
@@ -1378,15 +1475,15 @@ void mod_update_latency_counters(struct mod_t *mod, long long latency, enum mod_
 		{
 			switch(trans_type)
 			{
-				case mod_trans_load :                     mod->load_latency[i]++; break;
-				case mod_trans_store :                    mod->store_latency[i]++; break;
-				case mod_trans_read_request :             mod->read_request_latency[i]++; break;
-				case mod_trans_writeback :                mod->writeback_request_latency[i]++; break;
-				case mod_trans_eviction :                 mod->eviction_latency[i]++; break;
-				case mod_trans_downup_read_request :      mod->downup_read_request_latency[i]++; break;
-				case mod_trans_downup_writeback_request : mod->downup_writeback_request_latency[i]++; break;
-				case mod_trans_peer_request :             mod->peer_latency[i]++; break;
-				case mod_trans_invalidate :               mod->invalidate_latency[i]++; break;
+				case mod_trans_load :                     mod->stats.load_latency[i]++; break;
+				case mod_trans_store :                    mod->stats.store_latency[i]++; break;
+				case mod_trans_read_request :             mod->stats.read_request_latency[i]++; break;
+				case mod_trans_writeback :                mod->stats.writeback_request_latency[i]++; break;
+				case mod_trans_eviction :                 mod->stats.eviction_latency[i]++; break;
+				case mod_trans_downup_read_request :      mod->stats.downup_read_request_latency[i]++; break;
+				case mod_trans_downup_writeback_request : mod->stats.downup_writeback_request_latency[i]++; break;
+				case mod_trans_peer_request :             mod->stats.peer_latency[i]++; break;
+				case mod_trans_invalidate :               mod->stats.invalidate_latency[i]++; break;
 			}
 			return;
 		}
@@ -1402,20 +1499,20 @@ void mod_update_mod_port_waiting_counters(struct mod_t *mod, struct mod_stack_t
 			if(stack->read)
 			{
 				if(stack->downup_read_request)
-					mod->downup_read_time_waiting_mod_port[i]++;
+					mod->stats.downup_read_time_waiting_mod_port[i]++;
 				else
-					mod->read_time_waiting_mod_port[i]++;
+					mod->stats.read_time_waiting_mod_port[i]++;
 			}
 
 			if(stack->write)
 			{
 				if(stack->evict_trans)
-					mod->eviction_time_waiting_mod_port[i]++;
+					mod->stats.eviction_time_waiting_mod_port[i]++;
 
 				if(stack->downup_writeback_request)
-					mod->downup_writeback_time_waiting_mod_port[i]++;
+					mod->stats.downup_writeback_time_waiting_mod_port[i]++;
 				else
-					mod->write_time_waiting_mod_port[i]++;
+					mod->stats.write_time_waiting_mod_port[i]++;
 			}
 
 			return;
@@ -1425,20 +1522,20 @@ void mod_update_mod_port_waiting_counters(struct mod_t *mod, struct mod_stack_t
 	if(stack->read)
 	{
 		if(stack->downup_read_request)
-			mod->downup_read_time_waiting_mod_port[5]++;
+			mod->stats.downup_read_time_waiting_mod_port[5]++;
 		else
-			mod->read_time_waiting_mod_port[5]++;
+			mod->stats.read_time_waiting_mod_port[5]++;
 	}
 
 	if(stack->write)
 	{
 		if(stack->evict_trans)
-			mod->eviction_time_waiting_mod_port[5]++;
+			mod->stats.eviction_time_waiting_mod_port[5]++;
 		
 		if(stack->downup_writeback_request)
-			mod->downup_writeback_time_waiting_mod_port[5]++;
+			mod->stats.downup_writeback_time_waiting_mod_port[5]++;
 		else
-			mod->write_time_waiting_mod_port[5]++;
+			mod->stats.write_time_waiting_mod_port[5]++;
 	}
 	
 	return;
@@ -1453,20 +1550,20 @@ void mod_update_directory_lock_waiting_counters(struct mod_t *mod, struct mod_st
 			if(stack->read)
 			{
 				if(stack->downup_read_request)
-					mod->downup_read_time_waiting_directory_lock[i]++;
+					mod->stats.downup_read_time_waiting_directory_lock[i]++;
 				else
-					mod->read_time_waiting_directory_lock[i]++;
+					mod->stats.read_time_waiting_directory_lock[i]++;
 			}
 
 			if(stack->write)
 			{
 				if(stack->evict_trans)
-					mod->eviction_time_waiting_directory_lock[i]++;
+					mod->stats.eviction_time_waiting_directory_lock[i]++;
 
 				if(stack->downup_writeback_request)
-					mod->downup_writeback_time_waiting_directory_lock[i]++;
+					mod->stats.downup_writeback_time_waiting_directory_lock[i]++;
 				else
-					mod->write_time_waiting_directory_lock[i]++;
+					mod->stats.write_time_waiting_directory_lock[i]++;
 			}
 
 			return;
@@ -1476,20 +1573,20 @@ void mod_update_directory_lock_waiting_counters(struct mod_t *mod, struct mod_st
 	if(stack->read)
 	{
 		if(stack->downup_read_request)
-			mod->downup_read_time_waiting_directory_lock[5]++;
+			mod->stats.downup_read_time_waiting_directory_lock[5]++;
 		else
-			mod->read_time_waiting_directory_lock[5]++;
+			mod->stats.read_time_waiting_directory_lock[5]++;
 	}
 
 	if(stack->write)
 	{
 		if(stack->evict_trans)
-			mod->eviction_time_waiting_directory_lock[5]++;
+			mod->stats.eviction_time_waiting_directory_lock[5]++;
 
 		if(stack->downup_writeback_request)
-			mod->downup_writeback_time_waiting_directory_lock[5]++;
+			mod->stats.downup_writeback_time_waiting_directory_lock[5]++;
 		else
-			mod->write_time_waiting_directory_lock[5]++;
+			mod->stats.write_time_waiting_directory_lock[5]++;
 	}
 	
 	return;
@@ -1503,16 +1600,16 @@ void mod_update_waiting_counters(struct mod_t *mod, struct mod_stack_t *stack, e
 
 	if(trans_type == mod_trans_load)
 	{
-		if(stack->load_access_waiting_for_store_cycle == 1)  { mod->loads_time_waiting_for_stores[0]++; return; }
-		if(stack->load_access_waiting_for_store_cycle >= 32) { mod->loads_time_waiting_for_stores[4]++; return; }
-		if(stack->load_access_waiting_cycle == 1)  { mod->loads_time_waiting_for_non_coalesced_accesses[0]++; return; }
-		if(stack->load_access_waiting_cycle >= 32) { mod->loads_time_waiting_for_non_coalesced_accesses[4]++; return; }
+		if(stack->load_access_waiting_for_store_cycle == 1)  { mod->stats.loads_time_waiting_for_stores[0]++; return; }
+		if(stack->load_access_waiting_for_store_cycle >= 32) { mod->stats.loads_time_waiting_for_stores[4]++; return; }
+		if(stack->load_access_waiting_cycle == 1)  { mod->stats.loads_time_waiting_for_non_coalesced_accesses[0]++; return; }
+		if(stack->load_access_waiting_cycle >= 32) { mod->stats.loads_time_waiting_for_non_coalesced_accesses[4]++; return; }
 	}
 
 	if(trans_type == mod_trans_store)
 	{
-		if(stack->store_access_waiting_cycle == 1)  { mod->stores_time_waiting[0]++; return; }
-		if(stack->store_access_waiting_cycle >= 32) { mod->stores_time_waiting[4]++; return; }
+		if(stack->store_access_waiting_cycle == 1)  { mod->stats.stores_time_waiting[0]++; return; }
+		if(stack->store_access_waiting_cycle >= 32) { mod->stats.stores_time_waiting[4]++; return; }
 	}
 
 	for(int i=0; i<5; i++)
@@ -1520,14 +1617,14 @@ void mod_update_waiting_counters(struct mod_t *mod, struct mod_stack_t *stack, e
 		if(trans_type == mod_trans_load)
 		{
 			if(req_variable_in_range(stack->load_access_waiting_for_store_cycle, pow_2(i+1), pow_2(i+2) - 1))
-				mod->loads_time_waiting_for_stores[i]++;
+				mod->stats.loads_time_waiting_for_stores[i]++;
 			if(req_variable_in_range(stack->load_access_waiting_cycle, pow_2(i+1), pow_2(i+2) - 1))
-				mod->loads_time_waiting_for_non_coalesced_accesses[i]++;
+				mod->stats.loads_time_waiting_for_non_coalesced_accesses[i]++;
 		}
 		if(trans_type == mod_trans_store)
 		{
 			if(req_variable_in_range(stack->store_access_waiting_cycle, pow_2(i+1), pow_2(i+2) - 1))
-				mod->stores_time_waiting[i]++;
+				mod->stats.stores_time_waiting[i]++;
 		}
 	}
 
@@ -1581,41 +1678,41 @@ void mod_update_simultaneous_flight_access_counters(struct mod_t *mod, unsigned
 	{
 		case mod_trans_load : 
 			{
-			  if(set_flag_load_exist) mod->load_during_load_to_same_addr++;
-			  if(set_flag_store_exist) mod->load_during_store_to_same_addr++;
-			  if(set_flag_eviction_exist) mod->load_during_eviction_to_same_addr++;
-			  if(set_flag_downup_read_req_exist) mod->load_during_downup_read_req_to_same_addr++;
-			  if(set_flag_downup_wb_req_exist) mod->load_during_downup_wb_req_to_same_addr++;
+			  if(set_flag_load_exist) MOD_STAT_INC(mod, load_during_load_to_same_addr);
+			  if(set_flag_store_exist) MOD_STAT_INC(mod, load_during_store_to_same_addr);
+			  if(set_flag_eviction_exist) MOD_STAT_INC(mod, load_during_eviction_to_same_addr);
+			  if(set_flag_downup_read_req_exist) MOD_STAT_INC(mod, load_during_downup_read_req_to_same_addr);
+			  if(set_flag_downup_wb_req_exist) MOD_STAT_INC(mod, load_during_downup_wb_req_to_same_addr);
 			  break;
 			}
 
 		case mod_trans_store : 
 			{
-			  if(set_flag_load_exist) mod->store_during_load_to_same_addr++;
-			  if(set_flag_store_exist) mod->store_during_store_to_same_addr++;
-			  if(set_flag_eviction_exist) mod->store_during_eviction_to_same_addr++;
-			  if(set_flag_downup_read_req_exist) mod->store_during_downup_read_req_to_same_addr++;
-			  if(set_flag_downup_wb_req_exist) mod->store_during_downup_wb_req_to_same_addr++;
+			  if(set_flag_load_exist) MOD_STAT_INC(mod, store_during_load_to_same_addr);
+			  if(set_flag_store_exist) MOD_STAT_INC(mod, store_during_store_to_same_addr);
+			  if(set_flag_eviction_exist) MOD_STAT_INC(mod, store_during_eviction_to_same_addr);
+			  if(set_flag_downup_read_req_exist) MOD_STAT_INC(mod, store_during_downup_read_req_to_same_addr);
+			  if(set_flag_downup_wb_req_exist) MOD_STAT_INC(mod, store_during_downup_wb_req_to_same_addr);
 			  break;
 			}
 		
 		case mod_trans_downup_read_request : 
 			{									 		 
-			  if(set_flag_load_exist) mod->downup_read_req_during_load_to_same_addr++;
-			  if(set_flag_store_exist) mod->downup_read_req_during_store_to_same_addr++;
-			  if(set_flag_eviction_exist) mod->downup_read_req_during_eviction_to_same_addr++;
-			  if(set_flag_downup_read_req_exist) mod->downup_read_req_during_downup_read_req_to_same_addr++;
-			  if(set_flag_downup_wb_req_exist) mod->downup_read_req_during_downup_wb_req_to_same_addr++;
+			  if(set_flag_load_exist) MOD_STAT_INC(mod, downup_read_req_during_load_to_same_addr);
+			  if(set_flag_store_exist) MOD_STAT_INC(mod, downup_read_req_during_store_to_same_addr);
+			  if(set_flag_eviction_exist) MOD_STAT_INC(mod, downup_read_req_during_eviction_to_same_addr);
+			  if(set_flag_downup_read_req_exist) MOD_STAT_INC(mod, downup_read_req_during_downup_read_req_to_same_addr);
+			  if(set_flag_downup_wb_req_exist) MOD_STAT_INC(mod, downup_read_req_during_downup_wb_req_to_same_addr);
 			  break;
 			}
 	
 		case mod_trans_downup_writeback_request : 
 			{									 		 
-				if(set_flag_load_exist) mod->downup_wb_req_during_load_to_same_addr++;
-				if(set_flag_store_exist) mod->downup_wb_req_during_store_to_same_addr++;
-				if(set_flag_eviction_exist) mod->downup_wb_req_during_eviction_to_same_addr++;
-				if(set_flag_downup_read_req_exist) mod->downup_wb_req_during_downup_read_req_to_same_addr++;
-				if(set_flag_downup_wb_req_exist) mod->downup_wb_req_during_downup_wb_req_to_same_addr++;
+				if(set_flag_load_exist) MOD_STAT_INC(mod, downup_wb_req_during_load_to_same_addr);
+				if(set_flag_store_exist) MOD_STAT_INC(mod, downup_wb_req_during_store_to_same_addr);
+				if(set_flag_eviction_exist) MOD_STAT_INC(mod, downup_wb_req_during_eviction_to_same_addr);
+				if(set_flag_downup_read_req_exist) MOD_STAT_INC(mod, downup_wb_req_during_downup_read_req_to_same_addr);
+				if(set_flag_downup_wb_req_exist) MOD_STAT_INC(mod, downup_wb_req_during_downup_wb_req_to_same_addr);
 				break;
 			}
 	}
@@ -1630,14 +1727,14 @@ void mod_update_nw_send_request_delay_counters(struct mod_t *mod, struct mod_sta
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_send_requests_nw_cycles[0]++; break;
+			case mod_trans_read_request             : mod->stats.read_send_requests_nw_cycles[0]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_send_requests_nw_cycles[0]++; break;
-			case mod_trans_eviction                 : mod->eviction_send_requests_nw_cycles[0]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_send_requests_nw_cycles[0]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_send_requests_nw_cycles[0]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_send_requests_nw_cycles[0]++; break;
-			case mod_trans_peer_request  						: mod->peer_send_requests_nw_cycles[0]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_send_requests_nw_cycles[0]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_send_requests_nw_cycles[0]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_send_requests_nw_cycles[0]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_send_requests_nw_cycles[0]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_send_requests_nw_cycles[0]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_send_requests_nw_cycles[0]++; break;
 		}
 
 		return;
@@ -1648,14 +1745,14 @@ void mod_update_nw_send_request_delay_counters(struct mod_t *mod, struct mod_sta
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_send_requests_nw_cycles[5]++; break;
+			case mod_trans_read_request             : mod->stats.read_send_requests_nw_cycles[5]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_send_requests_nw_cycles[5]++; break;
-			case mod_trans_eviction                 : mod->eviction_send_requests_nw_cycles[5]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_send_requests_nw_cycles[5]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_send_requests_nw_cycles[5]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_send_requests_nw_cycles[5]++; break;
-			case mod_trans_peer_request  						: mod->peer_send_requests_nw_cycles[5]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_send_requests_nw_cycles[5]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_send_requests_nw_cycles[5]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_send_requests_nw_cycles[5]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_send_requests_nw_cycles[5]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_send_requests_nw_cycles[5]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_send_requests_nw_cycles[5]++; break;
 		}
 
 		return;
@@ -1668,14 +1765,14 @@ void mod_update_nw_send_request_delay_counters(struct mod_t *mod, struct mod_sta
 			switch(trans_type)
 			{
 				case mod_trans_load 										:
-				case mod_trans_read_request             : mod->read_send_requests_nw_cycles[i]++; break;
+				case mod_trans_read_request             : mod->stats.read_send_requests_nw_cycles[i]++; break;
 				case mod_trans_store 										:
-				case mod_trans_writeback                : mod->writeback_send_requests_nw_cycles[i]++; break;
-				case mod_trans_eviction                 : mod->eviction_send_requests_nw_cycles[i]++; break;
-				case mod_trans_downup_read_request      : mod->downup_read_send_requests_nw_cycles[i]++; break;
-				case mod_trans_downup_writeback_request : mod->downup_writeback_send_requests_nw_cycles[i]++; break;
-				case mod_trans_downup_eviction_request  : mod->downup_eviction_send_requests_nw_cycles[i]++; break;
-				case mod_trans_peer_request  						: mod->peer_send_requests_nw_cycles[i]++; break;
+				case mod_trans_writeback                : mod->stats.writeback_send_requests_nw_cycles[i]++; break;
+				case mod_trans_eviction                 : mod->stats.eviction_send_requests_nw_cycles[i]++; break;
+				case mod_trans_downup_read_request      : mod->stats.downup_read_send_requests_nw_cycles[i]++; break;
+				case mod_trans_downup_writeback_request : mod->stats.downup_writeback_send_requests_nw_cycles[i]++; break;
+				case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_send_requests_nw_cycles[i]++; break;
+				case mod_trans_peer_request  						: mod->stats.peer_send_requests_nw_cycles[i]++; break;
 			}
 			break;
 		}
@@ -1692,14 +1789,14 @@ void mod_update_nw_send_reply_delay_counters(struct mod_t *mod, struct mod_stack
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_send_replies_nw_cycles[0]++; break;
+			case mod_trans_read_request             : mod->stats.read_send_replies_nw_cycles[0]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_send_replies_nw_cycles[0]++; break;
-			case mod_trans_eviction                 : mod->eviction_send_replies_nw_cycles[0]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_send_replies_nw_cycles[0]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_send_replies_nw_cycles[0]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_send_replies_nw_cycles[0]++; break;
-			case mod_trans_peer_request  						: mod->peer_send_replies_nw_cycles[0]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_send_replies_nw_cycles[0]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_send_replies_nw_cycles[0]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_send_replies_nw_cycles[0]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_send_replies_nw_cycles[0]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_send_replies_nw_cycles[0]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_send_replies_nw_cycles[0]++; break;
 		}
 
 		return;
@@ -1710,14 +1807,14 @@ void mod_update_nw_send_reply_delay_counters(struct mod_t *mod, struct mod_stack
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_send_replies_nw_cycles[5]++; break;
+			case mod_trans_read_request             : mod->stats.read_send_replies_nw_cycles[5]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_send_replies_nw_cycles[5]++; break;
-			case mod_trans_eviction                 : mod->eviction_send_replies_nw_cycles[5]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_send_replies_nw_cycles[5]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_send_replies_nw_cycles[5]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_send_replies_nw_cycles[5]++; break;
-			case mod_trans_peer_request  						: mod->peer_send_replies_nw_cycles[5]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_send_replies_nw_cycles[5]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_send_replies_nw_cycles[5]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_send_replies_nw_cycles[5]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_send_replies_nw_cycles[5]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_send_replies_nw_cycles[5]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_send_replies_nw_cycles[5]++; break;
 		}
 
 		return;
@@ -1730,14 +1827,14 @@ void mod_update_nw_send_reply_delay_counters(struct mod_t *mod, struct mod_stack
 			switch(trans_type)
 			{
 				case mod_trans_load 										:
-				case mod_trans_read_request             : mod->read_send_replies_nw_cycles[i]++; break;
+				case mod_trans_read_request             : mod->stats.read_send_replies_nw_cycles[i]++; break;
 				case mod_trans_store 										:
-				case mod_trans_writeback                : mod->writeback_send_replies_nw_cycles[i]++; break;
-				case mod_trans_eviction                 : mod->eviction_send_replies_nw_cycles[i]++; break;
-				case mod_trans_downup_read_request      : mod->downup_read_send_replies_nw_cycles[i]++; break;
-				case mod_trans_downup_writeback_request : mod->downup_writeback_send_replies_nw_cycles[i]++; break;
-				case mod_trans_downup_eviction_request  : mod->downup_eviction_send_replies_nw_cycles[i]++; break;
-				case mod_trans_peer_request  						: mod->peer_send_replies_nw_cycles[i]++; break;
+				case mod_trans_writeback                : mod->stats.writeback_send_replies_nw_cycles[i]++; break;
+				case mod_trans_eviction                 : mod->stats.eviction_send_replies_nw_cycles[i]++; break;
+				case mod_trans_downup_read_request      : mod->stats.downup_read_send_replies_nw_cycles[i]++; break;
+				case mod_trans_downup_writeback_request : mod->stats.downup_writeback_send_replies_nw_cycles[i]++; break;
+				case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_send_replies_nw_cycles[i]++; break;
+				case mod_trans_peer_request  						: mod->stats.peer_send_replies_nw_cycles[i]++; break;
 			}
 			break;
 		}
@@ -1753,14 +1850,14 @@ void mod_update_nw_receive_request_delay_counters(struct mod_t *mod, struct mod_
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_receive_requests_nw_cycles[0]++; break;
+			case mod_trans_read_request             : mod->stats.read_receive_requests_nw_cycles[0]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_receive_requests_nw_cycles[0]++; break;
-			case mod_trans_eviction                 : mod->eviction_receive_requests_nw_cycles[0]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_receive_requests_nw_cycles[0]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_receive_requests_nw_cycles[0]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_receive_requests_nw_cycles[0]++; break;
-			case mod_trans_peer_request  						: mod->peer_receive_requests_nw_cycles[0]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_receive_requests_nw_cycles[0]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_receive_requests_nw_cycles[0]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_receive_requests_nw_cycles[0]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_receive_requests_nw_cycles[0]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_receive_requests_nw_cycles[0]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_receive_requests_nw_cycles[0]++; break;
 		}
 
 		return;
@@ -1771,14 +1868,14 @@ void mod_update_nw_receive_request_delay_counters(struct mod_t *mod, struct mod_
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_receive_requests_nw_cycles[5]++; break;
+			case mod_trans_read_request             : mod->stats.read_receive_requests_nw_cycles[5]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_receive_requests_nw_cycles[5]++; break;
-			case mod_trans_eviction                 : mod->eviction_receive_requests_nw_cycles[5]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_receive_requests_nw_cycles[5]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_receive_requests_nw_cycles[5]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_receive_requests_nw_cycles[5]++; break;
-			case mod_trans_peer_request  						: mod->peer_receive_requests_nw_cycles[5]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_receive_requests_nw_cycles[5]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_receive_requests_nw_cycles[5]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_receive_requests_nw_cycles[5]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_receive_requests_nw_cycles[5]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_receive_requests_nw_cycles[5]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_receive_requests_nw_cycles[5]++; break;
 		}
 
 		return;
@@ -1791,14 +1888,14 @@ void mod_update_nw_receive_request_delay_counters(struct mod_t *mod, struct mod_
 			switch(trans_type)
 			{
 				case mod_trans_load 										:
-				case mod_trans_read_request             : mod->read_receive_requests_nw_cycles[i]++; break;
+				case mod_trans_read_request             : mod->stats.read_receive_requests_nw_cycles[i]++; break;
 				case mod_trans_store 										:
-				case mod_trans_writeback                : mod->writeback_receive_requests_nw_cycles[i]++; break;
-				case mod_trans_eviction                 : mod->eviction_receive_requests_nw_cycles[i]++; break;
-				case mod_trans_downup_read_request      : mod->downup_read_receive_requests_nw_cycles[i]++; break;
-				case mod_trans_downup_writeback_request : mod->downup_writeback_receive_requests_nw_cycles[i]++; break;
-				case mod_trans_downup_eviction_request  : mod->downup_eviction_receive_requests_nw_cycles[i]++; break;
-				case mod_trans_peer_request  						: mod->peer_receive_requests_nw_cycles[i]++; break;
+				case mod_trans_writeback                : mod->stats.writeback_receive_requests_nw_cycles[i]++; break;
+				case mod_trans_eviction                 : mod->stats.eviction_receive_requests_nw_cycles[i]++; break;
+				case mod_trans_downup_read_request      : mod->stats.downup_read_receive_requests_nw_cycles[i]++; break;
+				case mod_trans_downup_writeback_request : mod->stats.downup_writeback_receive_requests_nw_cycles[i]++; break;
+				case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_receive_requests_nw_cycles[i]++; break;
+				case mod_trans_peer_request  						: mod->stats.peer_receive_requests_nw_cycles[i]++; break;
 			}
 			break;
 		}
@@ -1815,14 +1912,14 @@ void mod_update_nw_receive_reply_delay_counters(struct mod_t *mod, struct mod_st
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_receive_replies_nw_cycles[0]++; break;
+			case mod_trans_read_request             : mod->stats.read_receive_replies_nw_cycles[0]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_receive_replies_nw_cycles[0]++; break;
-			case mod_trans_eviction                 : mod->eviction_receive_replies_nw_cycles[0]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_receive_replies_nw_cycles[0]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_receive_replies_nw_cycles[0]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_receive_replies_nw_cycles[0]++; break;
-			case mod_trans_peer_request  						: mod->peer_receive_replies_nw_cycles[0]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_receive_replies_nw_cycles[0]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_receive_replies_nw_cycles[0]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_receive_replies_nw_cycles[0]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_receive_replies_nw_cycles[0]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_receive_replies_nw_cycles[0]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_receive_replies_nw_cycles[0]++; break;
 		}
 
 		return;
@@ -1833,14 +1930,14 @@ void mod_update_nw_receive_reply_delay_counters(struct mod_t *mod, struct mod_st
 		switch(trans_type)
 		{
 			case mod_trans_load 										:
-			case mod_trans_read_request             : mod->read_receive_replies_nw_cycles[5]++; break;
+			case mod_trans_read_request             : mod->stats.read_receive_replies_nw_cycles[5]++; break;
 			case mod_trans_store 										:
-			case mod_trans_writeback                : mod->writeback_receive_replies_nw_cycles[5]++; break;
-			case mod_trans_eviction                 : mod->eviction_receive_replies_nw_cycles[5]++; break;
-			case mod_trans_downup_read_request      : mod->downup_read_receive_replies_nw_cycles[5]++; break;
-			case mod_trans_downup_writeback_request : mod->downup_writeback_receive_replies_nw_cycles[5]++; break;
-			case mod_trans_downup_eviction_request  : mod->downup_eviction_receive_replies_nw_cycles[5]++; break;
-			case mod_trans_peer_request  						: mod->peer_receive_replies_nw_cycles[5]++; break;
+			case mod_trans_writeback                : mod->stats.writeback_receive_replies_nw_cycles[5]++; break;
+			case mod_trans_eviction                 : mod->stats.eviction_receive_replies_nw_cycles[5]++; break;
+			case mod_trans_downup_read_request      : mod->stats.downup_read_receive_replies_nw_cycles[5]++; break;
+			case mod_trans_downup_writeback_request : mod->stats.downup_writeback_receive_replies_nw_cycles[5]++; break;
+			case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_receive_replies_nw_cycles[5]++; break;
+			case mod_trans_peer_request  						: mod->stats.peer_receive_replies_nw_cycles[5]++; break;
 		}
 
 		return;
@@ -1853,14 +1950,14 @@ void mod_update_nw_receive_reply_delay_counters(struct mod_t *mod, struct mod_st
 			switch(trans_type)
 			{
 				case mod_trans_load 										:
-				case mod_trans_read_request             : mod->read_receive_replies_nw_cycles[i]++; break;
+				case mod_trans_read_request             : mod->stats.read_receive_replies_nw_cycles[i]++; break;
 				case mod_trans_store 										:
-				case mod_trans_writeback                : mod->writeback_receive_replies_nw_cycles[i]++; break;
-				case mod_trans_eviction                 : mod->eviction_receive_replies_nw_cycles[i]++; break;
-				case mod_trans_downup_read_request      : mod->downup_read_receive_replies_nw_cycles[i]++; break;
-				case mod_trans_downup_writeback_request : mod->downup_writeback_receive_replies_nw_cycles[i]++; break;
-				case mod_trans_downup_eviction_request  : mod->downup_eviction_receive_replies_nw_cycles[i]++; break;
-				case mod_trans_peer_request  						: mod->peer_receive_replies_nw_cycles[i]++; break;
+				case mod_trans_writeback                : mod->stats.writeback_receive_replies_nw_cycles[i]++; break;
+				case mod_trans_eviction                 : mod->stats.eviction_receive_replies_nw_cycles[i]++; break;
+				case mod_trans_downup_read_request      : mod->stats.downup_read_receive_replies_nw_cycles[i]++; break;
+				case mod_trans_downup_writeback_request : mod->stats.downup_writeback_receive_replies_nw_cycles[i]++; break;
+				case mod_trans_downup_eviction_request  : mod->stats.downup_eviction_receive_replies_nw_cycles[i]++; break;
+				case mod_trans_peer_request  						: mod->stats.peer_receive_replies_nw_cycles[i]++; break;
 			}
 			break;
 		}
@@ -1935,8 +2032,8 @@ void mod_downup_access_start(struct mod_t *mod, struct mod_stack_t *stack,
 	// Increase the length of Downup Queue count in the Module.	
 	mod->downup_req_queue_count++;
 
-	if(mod->max_downup_req_queue_count < mod->downup_req_queue_count)
-		mod->max_downup_req_queue_count = mod->downup_req_queue_count;
+	if(mod->stats.max_downup_req_queue_count < mod->downup_req_queue_count)
+		mod->stats.max_downup_req_queue_count = mod->downup_req_queue_count;
 
 	/* Insert in access list */
 	DOUBLE_LINKED_LIST_INSERT_TAIL(mod, downup_access, stack);
@@ -2017,8 +2114,8 @@ void mod_read_write_req_access_start(struct mod_t *mod, struct mod_stack_t *stac
 	// Increase the length of Read Write Queue count in the Module.	
 	mod->read_write_req_queue_count++;
 
-	if(mod->max_read_write_req_queue_count < mod->read_write_req_queue_count)
-		mod->max_read_write_req_queue_count = mod->read_write_req_queue_count;
+	if(mod->stats.max_read_write_req_queue_count < mod->read_write_req_queue_count)
+		mod->stats.max_read_write_req_queue_count = mod->read_write_req_queue_count;
 
 	/* Insert in access list */
 	DOUBLE_LINKED_LIST_INSERT_TAIL(mod, read_write_req, stack);
@@ -2089,6 +2186,27 @@ struct mod_stack_t *mod_in_flight_read_write_req_address(struct mod_t *mod, unsi
 	return NULL;
 }
 
+/* Return the up-down request with identifier 'id' that is in flight in 'mod'
+ * for the block containing 'addr', or NULL if it has already finished. */
+struct mod_stack_t *mod_in_flight_read_write_req_id(struct mod_t *mod, unsigned int addr,
+	long long id)
+{
+	struct mod_stack_t *stack;
+	int index;
+
+	index = (addr >> mod->log_block_size) % MOD_ACCESS_HASH_TABLE_SIZE;
+	for (stack = mod->read_write_req_hash_table[index].read_write_req_bucket_list_head;
+			stack; stack = stack->read_write_req_bucket_list_next)
+	{
+		if (stack->id == id && stack->addr >> mod->log_block_size ==
+				addr >> mod->log_block_size)
+			return stack;
+	}
+
+	/* Not found */
+	return NULL;
+}
+
 struct mod_stack_t *mod_in_flight_read_write_req_access(struct mod_t *mod,
 	struct mod_stack_t *older_than_stack)
 {
@@ -2114,8 +2232,8 @@ void mod_evict_start(struct mod_t *mod, struct mod_stack_t *stack,
 	// Increase the length of Evict Queue count in the Module.	
 	mod->evict_req_queue_count++;
 
-	if(mod->max_evict_req_queue_count < mod->evict_req_queue_count)
-		mod->max_evict_req_queue_count = mod->evict_req_queue_count;
+	if(mod->stats.max_evict_req_queue_count < mod->evict_req_queue_count)
+		mod->stats.max_evict_req_queue_count = mod->evict_req_queue_count;
 
 	/* Insert in access list */
 	DOUBLE_LINKED_LIST_INSERT_TAIL(mod, evict, stack);
@@ -2259,7 +2377,9 @@ void mod_check_coherency_status(struct mod_t *target_mod, struct mod_t *prev_mod
 		{
 			if(target_mod->kind != mod_kind_main_memory)
 			{
-				if((check_stack_state != cache_block_shared) && (check_stack_state != cache_block_owned))
+				// A cache that is not inclusive may miss on blocks held above.
+				if((check_stack_state != cache_block_shared) && (check_stack_state != cache_block_owned) &&
+					(check_stack_hit || target_mod->inclusion == mod_inclusion_inclusive))
 				{
 					fatal("%lld ERROR : Upper Level Shared/Owned and Lower Level Not Shared/Owned. For address : %x Module %s performed an access which transformed the access to %s and Module : %s which is a lower level Module has a state in %s where it was to be Shared or Owned.\n", esim_cycle(), addr, issue_mod->name, str_map_value(&cache_block_state_map, issue_mod_state),	target_mod->name, str_map_value(&cache_block_state_map, check_stack_state));
 				}
@@ -2370,23 +2490,23 @@ void mod_update_request_queue_statistics(struct mod_t *mod)
 
 		if(req_variable_in_range(mod->read_write_req_queue_count, pow_2(i-1), pow_2(i) - 1))
 		{
-			mod->read_write_req_queue_length[i]++;
+			mod->stats.read_write_req_queue_length[i]++;
 		}
 		if(req_variable_in_range(mod->evict_req_queue_count, pow_2(i-1), pow_2(i) - 1))
 		{
-			mod->evict_req_queue_length[i]++;
+			mod->stats.evict_req_queue_length[i]++;
 		}
 		if(req_variable_in_range(mod->downup_req_queue_count, pow_2(i-1), pow_2(i) - 1))
 		{
-			mod->downup_req_queue_length[i]++;
+			mod->stats.downup_req_queue_length[i]++;
 		}
 		if(req_variable_in_range(read_write_evict_req_count, pow_2(i-1), pow_2(i) - 1))
 		{
-			mod->pending_updown_queue_length[i]++;
+			mod->stats.pending_updown_queue_length[i]++;
 		}
 		if(req_variable_in_range(total_req_count, pow_2(i-1), pow_2(i) - 1))
 		{
-			mod->total_queue_length[i]++;
+			mod->stats.total_queue_length[i]++;
 		}
 	}
 }
@@ -2476,74 +2596,74 @@ void mod_check_dependency_depth(struct mod_t *mod, struct mod_stack_t *older_tha
 	if((trans_type == mod_trans_read_request) || (trans_type == mod_trans_writeback))
 	{
 		// Update the maximum dependency values
-		if(mod->max_read_write_req_dependency_read_write_req <= read_write_req_count)
-			mod->max_read_write_req_dependency_read_write_req = read_write_req_count;
-		if(mod->max_read_write_req_dependency_evict_req <= evict_req_count)
-			mod->max_read_write_req_dependency_evict_req = evict_req_count;
-		if(mod->max_read_write_req_dependency_downup_req <= downup_req_count)
-			mod->max_read_write_req_dependency_downup_req = downup_req_count;
+		if(mod->stats.max_read_write_req_dependency_read_write_req <= read_write_req_count)
+			mod->stats.max_read_write_req_dependency_read_write_req = read_write_req_count;
+		if(mod->stats.max_read_write_req_dependency_evict_req <= evict_req_count)
+			mod->stats.max_read_write_req_dependency_evict_req = evict_req_count;
+		if(mod->stats.max_read_write_req_dependency_downup_req <= downup_req_count)
+			mod->stats.max_read_write_req_dependency_downup_req = downup_req_count;
 
 		for(int i=0; i<6; i++)
 		{	
 			if(req_variable_in_range(read_write_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->read_write_req_dependency_read_write_req_queue[i]++; read_write_req_update = 1; }
+			{ mod->stats.read_write_req_dependency_read_write_req_queue[i]++; read_write_req_update = 1; }
 			if(req_variable_in_range(evict_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->read_write_req_dependency_evict_req_queue[i]++; evict_req_update = 1; }
+			{ mod->stats.read_write_req_dependency_evict_req_queue[i]++; evict_req_update = 1; }
 			if(req_variable_in_range(downup_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->read_write_req_dependency_downup_req_queue[i]++; downup_req_update = 1; }
+			{ mod->stats.read_write_req_dependency_downup_req_queue[i]++; downup_req_update = 1; }
 		}
 		
-		if(!read_write_req_update) mod->read_write_req_dependency_read_write_req_queue[6]++;
-		if(!evict_req_update) 		 mod->read_write_req_dependency_evict_req_queue[6]++;
-		if(!downup_req_update)     mod->read_write_req_dependency_downup_req_queue[6]++;
+		if(!read_write_req_update) mod->stats.read_write_req_dependency_read_write_req_queue[6]++;
+		if(!evict_req_update) 		 mod->stats.read_write_req_dependency_evict_req_queue[6]++;
+		if(!downup_req_update)     mod->stats.read_write_req_dependency_downup_req_queue[6]++;
 	}
 	else if((trans_type == mod_trans_downup_read_request) || (trans_type == mod_trans_downup_writeback_request) || (trans_type == mod_trans_downup_eviction_request))
 	{
 		// Update the maximum dependency values
-		if(mod->max_downup_req_dependency_read_write_req <= read_write_req_count)
-			mod->max_downup_req_dependency_read_write_req = read_write_req_count;
-		if(mod->max_downup_req_dependency_evict_req <= evict_req_count)
-			mod->max_downup_req_dependency_evict_req = evict_req_count;
-		if(mod->max_downup_req_dependency_downup_req <= downup_req_count)
-			mod->max_downup_req_dependency_downup_req = downup_req_count;
+		if(mod->stats.max_downup_req_dependency_read_write_req <= read_write_req_count)
+			mod->stats.max_downup_req_dependency_read_write_req = read_write_req_count;
+		if(mod->stats.max_downup_req_dependency_evict_req <= evict_req_count)
+			mod->stats.max_downup_req_dependency_evict_req = evict_req_count;
+		if(mod->stats.max_downup_req_dependency_downup_req <= downup_req_count)
+			mod->stats.max_downup_req_dependency_downup_req = downup_req_count;
 
 		for(int i=0; i<6; i++)
 		{	
 			if(req_variable_in_range(read_write_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->downup_req_dependency_read_write_req_queue[i]++; read_write_req_update = 1; }
+			{ mod->stats.downup_req_dependency_read_write_req_queue[i]++; read_write_req_update = 1; }
 			if(req_variable_in_range(evict_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->downup_req_dependency_evict_req_queue[i]++; evict_req_update = 1; }
+			{ mod->stats.downup_req_dependency_evict_req_queue[i]++; evict_req_update = 1; }
 			if(req_variable_in_range(downup_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->downup_req_dependency_downup_req_queue[i]++; downup_req_update = 1; }
+			{ mod->stats.downup_req_dependency_downup_req_queue[i]++; downup_req_update = 1; }
 		}
 		
-		if(!read_write_req_update) mod->downup_req_dependency_read_write_req_queue[6]++;
-		if(!evict_req_update) 		 mod->downup_req_dependency_evict_req_queue[6]++;
-		if(!downup_req_update)     mod->downup_req_dependency_downup_req_queue[6]++;
+		if(!read_write_req_update) mod->stats.downup_req_dependency_read_write_req_queue[6]++;
+		if(!evict_req_update) 		 mod->stats.downup_req_dependency_evict_req_queue[6]++;
+		if(!downup_req_update)     mod->stats.downup_req_dependency_downup_req_queue[6]++;
 	}
 	else
 	{
 		// Update the maximum dependency values
-		if(mod->max_evict_req_dependency_read_write_req <= read_write_req_count)
-			mod->max_evict_req_dependency_read_write_req = read_write_req_count;
-		if(mod->max_evict_req_dependency_evict_req <= evict_req_count)
-			mod->max_evict_req_dependency_evict_req = evict_req_count;
-		if(mod->max_evict_req_dependency_downup_req <= downup_req_count)
-			mod->max_evict_req_dependency_downup_req = downup_req_count;
+		if(mod->stats.max_evict_req_dependency_read_write_req <= read_write_req_count)
+			mod->stats.max_evict_req_dependency_read_write_req = read_write_req_count;
+		if(mod->stats.max_evict_req_dependency_evict_req <= evict_req_count)
+			mod->stats.max_evict_req_dependency_evict_req = evict_req_count;
+		if(mod->stats.max_evict_req_dependency_downup_req <= downup_req_count)
+			mod->stats.max_evict_req_dependency_downup_req = downup_req_count;
 
 		for(int i=0; i<6; i++)
 		{	
 			if(req_variable_in_range(read_write_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->evict_req_dependency_read_write_req_queue[i]++; read_write_req_update = 1; }
+			{ mod->stats.evict_req_dependency_read_write_req_queue[i]++; read_write_req_update = 1; }
 			if(req_variable_in_range(evict_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->evict_req_dependency_evict_req_queue[i]++; evict_req_update = 1; }
+			{ mod->stats.evict_req_dependency_evict_req_queue[i]++; evict_req_update = 1; }
 			if(req_variable_in_range(downup_req_count, pow_2(i-1), pow_2(i) - 1))
-			{ mod->evict_req_dependency_downup_req_queue[i]++; downup_req_update = 1; }
+			{ mod->stats.evict_req_dependency_downup_req_queue[i]++; downup_req_update = 1; }
 		}
 		
-		if(!read_write_req_update) mod->evict_req_dependency_read_write_req_queue[6]++;
-		if(!evict_req_update) 		 mod->evict_req_dependency_evict_req_queue[6]++;
-		if(!downup_req_update)     mod->evict_req_dependency_downup_req_queue[6]++;
+		if(!read_write_req_update) mod->stats.evict_req_dependency_read_write_req_queue[6]++;
+		if(!evict_req_update) 		 mod->stats.evict_req_dependency_evict_req_queue[6]++;
+		if(!downup_req_update)     mod->stats.evict_req_dependency_downup_req_queue[6]++;
 	}
 
 }
@@ -2563,10 +2683,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 			switch(trans_type)
 			{
 				case mod_trans_read_request :
- 				case mod_trans_writeback :	{ mod->read_write_req_waiting_delays[i]++; net_update = 1;}
-				case mod_trans_eviction : { mod->evict_req_waiting_delays[i]++; net_update = 1;}
+ 				case mod_trans_writeback :	{ mod->stats.read_write_req_waiting_delays[i]++; net_update = 1;}
+				case mod_trans_eviction : { mod->stats.evict_req_waiting_delays[i]++; net_update = 1;}
 				case mod_trans_downup_read_request :
- 				case mod_trans_downup_writeback_request: { mod->downup_req_waiting_delays[i]++;; net_update = 1;}
+ 				case mod_trans_downup_writeback_request: { mod->stats.downup_req_waiting_delays[i]++;; net_update = 1;}
 			}
 		}
 	}
@@ -2576,10 +2696,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 		switch(trans_type)
 		{
 			case mod_trans_read_request :
- 			case mod_trans_writeback :	{ mod->read_write_req_waiting_delays[8]++;}
-			case mod_trans_eviction : { mod->evict_req_waiting_delays[8]++;}
+ 			case mod_trans_writeback :	{ mod->stats.read_write_req_waiting_delays[8]++;}
+			case mod_trans_eviction : { mod->stats.evict_req_waiting_delays[8]++;}
 			case mod_trans_downup_read_request :
- 			case mod_trans_downup_writeback_request: { mod->downup_req_waiting_delays[8]++;}
+ 			case mod_trans_downup_writeback_request: { mod->stats.downup_req_waiting_delays[8]++;}
 		}
 	}
 
@@ -2591,10 +2711,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 			switch(trans_type)
 			{
 				case mod_trans_read_request :
- 				case mod_trans_writeback :	{ mod->read_write_req_delay_for_read_write_req[i]++; wait_for_read_write_update = 1;}
-				case mod_trans_eviction : { mod->evict_req_delay_for_read_write_req[i]++; wait_for_read_write_update = 1;}
+ 				case mod_trans_writeback :	{ mod->stats.read_write_req_delay_for_read_write_req[i]++; wait_for_read_write_update = 1;}
+				case mod_trans_eviction : { mod->stats.evict_req_delay_for_read_write_req[i]++; wait_for_read_write_update = 1;}
 				case mod_trans_downup_read_request :
- 				case mod_trans_downup_writeback_request: { mod->downup_req_delay_for_read_write_req[i]++; wait_for_read_write_update = 1;}
+ 				case mod_trans_downup_writeback_request: { mod->stats.downup_req_delay_for_read_write_req[i]++; wait_for_read_write_update = 1;}
 			}
 		}
 	}
@@ -2604,10 +2724,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 	switch(trans_type)
 	{
 		case mod_trans_read_request :
- 		case mod_trans_writeback :	{ mod->read_write_req_delay_for_read_write_req[8]++;}
-		case mod_trans_eviction : { mod->evict_req_delay_for_read_write_req[8]++;}
+ 		case mod_trans_writeback :	{ mod->stats.read_write_req_delay_for_read_write_req[8]++;}
+		case mod_trans_eviction : { mod->stats.evict_req_delay_for_read_write_req[8]++;}
 		case mod_trans_downup_read_request :
- 		case mod_trans_downup_writeback_request: { mod->downup_req_delay_for_read_write_req[8]++;}
+ 		case mod_trans_downup_writeback_request: { mod->stats.downup_req_delay_for_read_write_req[8]++;}
 	}
 	}
 
@@ -2619,10 +2739,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 			switch(trans_type)
 			{
 				case mod_trans_read_request :
- 				case mod_trans_writeback :	{ mod->read_write_req_delay_for_evict_req[i]++; wait_for_evict_update = 1;}
-				case mod_trans_eviction : { mod->evict_req_delay_for_evict_req[i]++; wait_for_evict_update = 1;}
+ 				case mod_trans_writeback :	{ mod->stats.read_write_req_delay_for_evict_req[i]++; wait_for_evict_update = 1;}
+				case mod_trans_eviction : { mod->stats.evict_req_delay_for_evict_req[i]++; wait_for_evict_update = 1;}
 				case mod_trans_downup_read_request :
- 				case mod_trans_downup_writeback_request: { mod->downup_req_delay_for_evict_req[i]++; wait_for_evict_update = 1;}
+ 				case mod_trans_downup_writeback_request: { mod->stats.downup_req_delay_for_evict_req[i]++; wait_for_evict_update = 1;}
 			}
 		}
 	}
@@ -2632,10 +2752,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 		switch(trans_type)
 		{
 			case mod_trans_read_request :
- 			case mod_trans_writeback :	{ mod->read_write_req_delay_for_evict_req[8]++;}
-			case mod_trans_eviction : { mod->evict_req_delay_for_evict_req[8]++;}
+ 			case mod_trans_writeback :	{ mod->stats.read_write_req_delay_for_evict_req[8]++;}
+			case mod_trans_eviction : { mod->stats.evict_req_delay_for_evict_req[8]++;}
 			case mod_trans_downup_read_request :
- 			case mod_trans_downup_writeback_request: { mod->downup_req_delay_for_evict_req[8]++;}
+ 			case mod_trans_downup_writeback_request: { mod->stats.downup_req_delay_for_evict_req[8]++;}
 		}
 	}
 
@@ -2647,10 +2767,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 			switch(trans_type)
 			{
 				case mod_trans_read_request :
- 				case mod_trans_writeback :	{ mod->read_write_req_delay_for_downup_req[i]++; wait_for_downup_update = 1;}
-				case mod_trans_eviction : { mod->evict_req_delay_for_downup_req[i]++; wait_for_downup_update = 1;}
+ 				case mod_trans_writeback :	{ mod->stats.read_write_req_delay_for_downup_req[i]++; wait_for_downup_update = 1;}
+				case mod_trans_eviction : { mod->stats.evict_req_delay_for_downup_req[i]++; wait_for_downup_update = 1;}
 				case mod_trans_downup_read_request :
- 				case mod_trans_downup_writeback_request: { mod->downup_req_delay_for_downup_req[i]++; wait_for_downup_update = 1;}
+ 				case mod_trans_downup_writeback_request: { mod->stats.downup_req_delay_for_downup_req[i]++; wait_for_downup_update = 1;}
 			}
 		}
 	}
@@ -2660,10 +2780,10 @@ void mod_update_snoop_waiting_cycle_counters(struct mod_t *mod, struct mod_stack
 		switch(trans_type)
 		{
 			case mod_trans_read_request :
- 			case mod_trans_writeback :	{ mod->read_write_req_delay_for_downup_req[8]++;}
-			case mod_trans_eviction : { mod->evict_req_delay_for_downup_req[8]++;}
+ 			case mod_trans_writeback :	{ mod->stats.read_write_req_delay_for_downup_req[8]++;}
+			case mod_trans_eviction : { mod->stats.evict_req_delay_for_downup_req[8]++;}
 			case mod_trans_downup_read_request :
- 			case mod_trans_downup_writeback_request: { mod->downup_req_delay_for_downup_req[8]++;}
+ 			case mod_trans_downup_writeback_request: { mod->stats.downup_req_delay_for_downup_req[8]++;}
 		}
 	}
 }
@@ -22,17 +22,20 @@
 
 #include <stdio.h>
 #include "cache.h"
+#include "mod-stat.h"
 
-// MSHR Entry : This is used to retain the cache entries during operations for snoop based protocols. In case of directory based protocols this is taken care as Directory Based protocols.
+/* MSHR entry. An entry is allocated by a primary miss in a module and
+ * released when the block has been filled. Secondary misses to the same block
+ * are attached to the entry's target list instead of accessing the module
+ * again, and complete together with the primary miss. */
 struct mshr_entry_t
 {
-	
-	int valid;										// Whether this entry is a valid entry
-	long long lock_when;					// Cycle when it was locked
-	long long addr;								// Block address
-	struct mod_stack_t *stack;		// Access that caused the Miss
+	int valid;
+	long long lock_when;  /* Cycle when it was allocated */
+	unsigned int addr;  /* Block address */
+	struct mod_stack_t *stack;  /* Primary miss */
 
-	// Waiting List for MSHR entry
+	/* Target list, using field 'waiting_list' of the secondary misses */
 	struct mod_stack_t *waiting_list_head;
 	struct mod_stack_t *waiting_list_tail;
 	int waiting_list_count;
@@ -111,6 +114,40 @@ enum mod_range_kind_t
 	mod_range_interleaved
 };
 
+/* Function selecting the interleaved module serving an address */
+enum mod_range_hash_t
+{
+	mod_range_hash_modulo = 0,  /* (addr / div) % mod */
+	mod_range_hash_xor  /* XOR of all log2(mod)-bit chunks of (addr / div) */
+};
+
+extern struct str_map_t mod_range_hash_map;
+
+/* Inclusion policy of a cache with respect to its higher-level modules */
+enum mod_inclusion_t
+{
+	mod_inclusion_inclusive = 0,  /* Evictions invalidate higher-level copies */
+	mod_inclusion_nine,  /* Non-inclusive, non-exclusive */
+	mod_inclusion_exclusive  /* Holds only victims of higher-level modules */
+};
+
+extern struct str_map_t mod_inclusion_map;
+
+/* Coherence protocol used by a cache among its higher-level modules. With
+ * the update protocols, a store to a shared block sends the written word to
+ * the other copies instead of invalidating them. */
+enum mod_coherence_t
+{
+	mod_coherence_invalidate = 0,  /* Write-invalidate */
+	mod_coherence_update,  /* Write-update (Dragon) */
+	mod_coherence_competitive  /* Write-update, invalidating unused copies */
+};
+
+extern struct str_map_t mod_coherence_map;
+
+/* Size of the data carried by a bus update, the word written by a store */
+#define MOD_UPDATE_WORD_SIZE  8
+
 #define MOD_ACCESS_HASH_TABLE_SIZE  17
 #define MOD_TRANS_HASH_TABLE_SIZE  17
 
@@ -150,17 +187,44 @@ struct mod_t
 			unsigned int mod;
 			unsigned int div;
 			unsigned int eq;
+			enum mod_range_hash_t hash;
 		} interleaved;
 	} range;
 
+	/* Slices of a banked cache. A cache geometry with 'Slices = N' creates
+	 * N modules named '<slice_name>.s<i>', each serving the blocks for which
+	 * the slice hash gives 'slice_index'. For other modules, 'slice_name' is
+	 * NULL and 'num_slices' is 1. */
+	char *slice_name;
+	int num_slices;
+	int slice_index;
+
+	/* Additional access latency per network hop between the module and the
+	 * higher-level module it serves (NUCA). */
+	int hop_latency;
+
+	/* Inclusion policy. An inclusive cache acts as the snoop filter of its
+	 * higher-level modules: a miss means they do not hold the block. For
+	 * other policies, misses and write requests also snoop them. */
+	enum mod_inclusion_t inclusion;
+
+	/* Coherence protocol among the higher-level modules. With competitive
+	 * update, a copy is invalidated after 'update_threshold' updates with no
+	 * access of its own module in between. */
+	enum mod_coherence_t coherence;
+	int update_threshold;
+
 	/* Ports */
 	struct mod_port_t *ports;
 	int num_ports;
 	int num_locked_ports;
 	
-	/* MSHR Cache */
+	/* MSHR file, with 'mshr_size' entries. Accesses waiting for a free
+	 * entry are enqueued in the module waiting list. */
 	struct mshr_entry_t *mshr;
 	int num_occupied_mshr;
+	long long mshr_occupancy_cycle;  /* Cycle of last change in occupancy */
+	long long *mshr_occupancy;  /* Cycles with N entries occupied (mshr_size + 1 elements) */
 
 	/* Accesses waiting to get a port */
 	struct mod_stack_t *port_waiting_list_head;
@@ -296,226 +360,8 @@ struct mod_t
 	 * memory hierarchy, the field is used to check this restriction. */
 	struct arch_t *arch;
 	
-	/* Statistics */
-	long long accesses;
-	long long hits;
-
-	long long reads;
-	long long effective_reads;
-	long long effective_read_hits;
-	long long writes;
-	long long effective_writes;
-	long long effective_write_hits;
-	long long nc_writes;
-	long long effective_nc_writes;
-	long long effective_nc_write_hits;
-	long long prefetches;
-	long long prefetch_aborts;
-	long long useless_prefetches;
-	long long evictions;
-
-	long long blocking_reads;
-	long long non_blocking_reads;
-	long long read_hits;
-	long long blocking_writes;
-	long long non_blocking_writes;
-	long long write_hits;
-	long long blocking_nc_writes;
-	long long non_blocking_nc_writes;
-	long long nc_write_hits;
-
-	long long read_retries;
-	long long write_retries;
-	long long nc_write_retries;
-
-	long long no_retry_accesses;
-	long long no_retry_hits;
-	long long no_retry_reads;
-	long long no_retry_read_hits;
-	long long no_retry_writes;
-	long long no_retry_write_hits;
-	long long no_retry_nc_writes;
-	long long no_retry_nc_write_hits;
-
-	//---------------------------------------------------
-	// STATISTICS FOR ACCESS COUNTS : number of loads (or up-down read requests for lower level modules), store (or up-down writeback requests for lower level modules), eviction requests generated, down-up read/writeback requests and up-down read and write-back requests.
-	// Up-down read requests generated should be equal to load misses and Up-down writeback requests grenerated must be equal to store hits in M/O state (depending on the state of protocol).
- 	// The statistics generated by the original code are the overall hits where there is no differentiation of Down-up or up-down requests.	
-	// Evictions can be measured by the evictions statistics stated above.
-	// In a directory based schemes, downup hits and misses donot make sense, but this has been kept to monitor the records in snoop based schemes.
-	// Up-down Writeback is further divided as caused due to eviction or a store request, and its hits/misses are monitored separately. 
-	//---------------------------------------------------
-	long long load_requests;
-	long long load_requests_hits;
-	long long load_requests_misses;
-
-	long long store_requests;
-	long long store_requests_hits;
-	long long store_requests_misses;
-
-	long long downup_read_requests;
-	long long downup_read_requests_hits;
-	long long downup_read_requests_misses;
-
-	long long downup_writeback_requests;
-	long long downup_writeback_requests_hits;
-	long long downup_writeback_requests_misses;
-	
-	long long updown_read_requests_generated;
-	long long updown_writeback_requests_generated;
-
-	long long writeback_due_to_eviction;
-	long long writeback_due_to_eviction_hits;
-	long long writeback_due_to_eviction_misses;
-
-	//-----------------------------------------------------------
-	// STATISTICS FOR Coalesced accesses and accesses that wait for other accesses, only for top module Load-Store accesses. Just to find out the scalability or locality and dependency in the controller. Anyways, stores wait for other accesses.
-	//-----------------------------------------------------------
-	long long coalesced_loads;
-	long long coalesced_stores;
-	long long loads_waiting_for_non_coalesced_accesses;
-	long long loads_waiting_for_stores;
-	
-	//----------------------------------------------------------
-	// STATISTICS for waiting times of accesses waiting in the process.
-	// The ranges are 1-3, 4-7, 8-15, 16-31, >32 cycles.
-	//----------------------------------------------------------
-	long long loads_time_waiting_for_non_coalesced_accesses[5];
-	long long loads_time_waiting_for_stores[5];
-	long long stores_time_waiting[5];
-
-	//---------------------------------------------------
-	// STATISTICS FOR WAITING ACCESSES : An access can be waiting due to the following reasons, in the FIND & LOCK operation, waiting for a module port or waiting for the directory lock.
-	// We categorise each access i.e. Read (load for top most level and up-down read request for the remaining lower levels), Write (store for top most level and up-down writeback request for remaining lower level), eviction, down-up writeback request and down-up read request. 
-	// We also try to find out the latency in case of the mod_ports, though the division is 1-8 cycles, 9-24, 25-50 and greater than 50 cycles.
-	//---------------------------------------------------
-	long long read_waiting_for_mod_port;
-	long long read_waiting_for_directory_lock; 
-	long long max_sim_read_waiting_for_mod_port; // TBD
-	long long max_sim_read_waiting_for_directory_lock; // TBD
-	long long read_waiting_for_other_accesses;
-	
-	long long write_waiting_for_mod_port;
-	long long write_waiting_for_directory_lock; 
-	long long max_sim_write_waiting_for_mod_port; // TBD
-	long long max_sim_write_waiting_for_directory_lock; // TBD
-	long long write_waiting_for_other_accesses;
-	
-	long long eviction_waiting_for_mod_port;
-	long long eviction_waiting_for_directory_lock; 
-	long long max_sim_eviction_waiting_for_mod_port; // TBD
-	long long max_sim_eviction_waiting_for_directory_lock; // TBD
-	long long eviction_waiting_for_other_accesses;
-
-	long long downup_read_waiting_for_mod_port;
-	long long downup_read_waiting_for_directory_lock; 
-	long long max_sim_downup_read_waiting_for_mod_port; // TBD
-	long long max_sim_downup_read_waiting_for_directory_lock; // TBD
-	long long downup_read_waiting_for_other_accesses;
-
-	long long downup_writeback_waiting_for_mod_port;
-	long long downup_writeback_waiting_for_directory_lock; 
-	long long max_sim_downup_writeback_waiting_for_mod_port; // TBD
-	long long max_sim_downup_writeback_waiting_for_directory_lock; // TBD
-	long long downup_writeback_waiting_for_other_accesses;
-
-	//-------------------------------------------------------
-	// Waiting statistics while the event is waiting for a module port or a directory lock.
-	//-------------------------------------------------------
-	long long read_time_waiting_mod_port[6];
-	long long write_time_waiting_mod_port[6];
-	long long eviction_time_waiting_mod_port[6];
-	long long downup_read_time_waiting_mod_port[6];
-	long long downup_writeback_time_waiting_mod_port[6];
-	
-	long long read_time_waiting_directory_lock[6];
-	long long write_time_waiting_directory_lock[6];
-	long long eviction_time_waiting_directory_lock[6];
-	long long downup_read_time_waiting_directory_lock[6];
-	long long downup_writeback_time_waiting_directory_lock[6];
-
-	//------------------------------------------------------
-	// STATISTICS of simultaneous access, i.e. a down-up request and a processor request to the same line
-	// This can be seen as following cases for same address accesses:
-  // 1.) load access when any of exisiting load, store, eviction, down-up read or down-up writeback
-  // 2.) store access when any of exisiting load, store, eviction, down-up read or down-up writeback
-  // 3.) down-up read request access when any of exisiting load, store, eviction, down-up read or down-up writeback
-  // 4.) down-up writeback request when any of exisitng load, store, eviction, down-up read or down-up writeback
-	//------------------------------------------------------
-	long long load_during_load_to_same_addr;
-	long long load_during_store_to_same_addr;
-	long long load_during_eviction_to_same_addr;
-	long long load_during_downup_read_req_to_same_addr;
-	long long load_during_downup_wb_req_to_same_addr;
-
-	long long store_during_load_to_same_addr;
-	long long store_during_store_to_same_addr;
-	long long store_during_eviction_to_same_addr;
-	long long store_during_downup_read_req_to_same_addr;
-	long long store_during_downup_wb_req_to_same_addr;
-
-	long long downup_read_req_during_load_to_same_addr;
-	long long downup_read_req_during_store_to_same_addr;
-	long long downup_read_req_during_eviction_to_same_addr;
-	long long downup_read_req_during_downup_read_req_to_same_addr;
-	long long downup_read_req_during_downup_wb_req_to_same_addr;
-
-	long long downup_wb_req_during_load_to_same_addr;
-	long long downup_wb_req_during_store_to_same_addr;
-	long long downup_wb_req_during_eviction_to_same_addr;
-	long long downup_wb_req_during_downup_read_req_to_same_addr;
-	long long downup_wb_req_during_downup_wb_req_to_same_addr;
-
-	//------------------------------------------------------
-	// STATISTICS of data transfers
-	//------------------------------------------------------
-	//----------Down-up data transfers----------------------
-	// Down-up data transfer implies that to fulfil/proceed the request the data had to be transferred from a higher level module
-	//------------------------------------------------------
-	// A higher level module, may be at same level, but not the peer or even above the requesting module sent the data for a load.
-	long long data_transfer_downup_load_request;
-	// A higher level module, may be at same level, but not the peer or even above the requesting module sent the data for store.
-	long long data_transfer_downup_store_request;
-	// A higher level module, at same level, or even above the requesting module sent the data for eviction.
-	long long data_transfer_downup_eviction_request;
-	// Peer module, at same level, sent the data for load.
-	long long peer_data_transfer_downup_load_request;
-	// Peer module, at same level, sent the data for store.
-	long long peer_data_transfer_downup_store_request;
-	// Lower level module, sent the data for load.
-	long long data_transfer_updown_load_request;
-	// Lower level module, sent the data for store.
-	long long data_transfer_updown_store_request;
-	// Data was transferred for eviction from the current module.
-	long long data_transfer_eviction;
-	
-	//------------------------------------------------------
-	// STATISTICS of evictions
-	//------------------------------------------------------
-	//-------------EVICTION SUMMARY-------------------------
-	long long eviction_due_to_load;
-	long long eviction_due_to_store;
-
-	//-------------EVICTION STATISTICS : Requests to state on a cache------------
-	//Assertions can be made that for MSI the counter for O/E should be 0, for MESI counter for O should be 0.
-	long long eviction_request_state_invalid;
-	long long eviction_request_state_modified;
-	long long eviction_request_state_owned;
-	long long eviction_request_state_exclusive;
-	long long eviction_request_state_shared;
-	long long eviction_request_state_noncoherent;
-
-	//---------------------------------------------------------
-	// STATISTICS for hit -> evict -> miss (TBD)
-	// This measures special statistics where it may happen that a Load Miss caused an eviction in the cache and the replacement entry was required again thus causing an unnecessary fetch from the lower level modules, thus adding to further delay. these can serve as basic blocks for some foundations in the replacement techniques. The minimum criteria is a Hit to an access that was evicted within 1000 cycles of its eviction.
-	//---------------------------------------------------------
-	long long load_miss_due_to_eviction;
-	long long store_miss_due_to_eviction;
-
-	//----------------------------------------------------------
-	// Variable to gather statistics for the number of simultaneous requests
-	// gather this number and use it for coverage type work
-	//----------------------------------------------------------
+	/* Requests in flight, sampled by the occupancy statistics. These
+	 * fields are not reset with the statistics. */
 	long long num_load_requests;
 	long long num_store_requests;
 	long long num_eviction_requests;
@@ -525,443 +371,316 @@ struct mod_t
 	long long num_downup_writeback_requests;
 	long long num_downup_eviction_requests;
 	long long waiting_for_lock;
-
-	//--------------------------------------------------------
-	// STATISTICS for controller occupancy : 
-	// These staistics show what was the request count on  a particular module at a given time.
-  // Load/Store requests indicate the Load/Store generated by processor on the higher most cache and Up-down read/write requests on the lower caches.
- 	// Eviction indicate the number of eviction transactions happening on the level
-  // read/writeback indicate the number of read/writeback requests issued to lower level of memory
-  // Down-up Read and write back requests indicate the remote read and writeback requests received,
- 	// Down-up eviction requests indicate the number of downup writeback requests received as a result of eviction from the other peer (same level)
- 	// Total processor requests indicate the number of Load and Store
-  // Controller requests indicate the total number of read, eviction and writeback requests
-  // total updown requests indicate the sum of processor and controller requests
-  // total downup requests indicate the sum of all down-up requests arising due to Load/Store/Eviction
-  // total requests indicate the total number of requests on the controller.
-	//--------------------------------------------------------
-	long long request_load[10];
-	long long request_store[10];
-	long long request_eviction[10];
-	long long request_read[10];
-	long long request_writeback[10];
-	long long request_downup_read[10];
-	long long request_downup_writeback[10];
-	long long request_downup_eviction[10];
-	long long request_processor[11];
-	long long request_controller[11];
-	long long request_updown[11];
-	long long request_downup[11];
-	long long request_total[12];
-
-	//---------------------------------------------------------
-	// STATISTICS FOR LATENCY
-	// Latency is measured in terms of cycle, here we measure latency as the the cycles that it takes to complete the request, rather than the arrival of first data stream for Load. The array indices represent the interval, say index i represents the interval [2^(i-1), 2^(i) - 1] and last indice represents all values >= 2^(i)
-	// Latency for eviction is further divided into the eviction for dirty lines and clean lines.
-	//---------------------------------------------------------
-	long long load_latency[10];
-	long long store_latency[10];
-	long long eviction_latency[10];
-	long long downup_read_request_latency[10];
-	long long downup_writeback_request_latency[10];
-	long long writeback_request_latency[10];
-	long long read_request_latency[10];
-	long long peer_latency[10];
-	long long invalidate_latency[10];
-	
-	//----------------------------------------------------
-	// STATISTICS FOR NETWORK CONGESTION
-	// These counters indicate the requests and replies that were retried on the network due to busy state. From the given module the request may be retried or corresponding replies may be retried based on the netowrk contention. Request contention is basically on Lower level network and reply contention on the higher level network, in case of no lower or higher network (e.g. main memory or top level cache) the request and reply counter accordingly is zero.
-  // There are statistics for the amount of cycles that are spent busy waiting for the network. Currently they are classified as 1-3, 4-7, 8-15, 16-31, 32-63 and >64 cycles for each classification.	
-	// This information is for send request and replies message only, there is no waiting at receive hence there are no  retried counters on reception.
-	// Make delay counters for reception as well.
-	//----------------------------------------------------
-	long long read_send_requests_retried_nw;
-	long long writeback_send_requests_retried_nw;
-	long long eviction_send_requests_retried_nw;
-	long long downup_read_send_requests_retried_nw;
-	long long downup_writeback_send_requests_retried_nw;
-	long long downup_eviction_send_requests_retried_nw;
-	long long peer_send_requests_retried_nw;
-
-	long long read_send_replies_retried_nw;
-	long long writeback_send_replies_retried_nw;
-	long long eviction_send_replies_retried_nw;
-	long long downup_read_send_replies_retried_nw;
-	long long downup_writeback_send_replies_retried_nw;
-	long long downup_eviction_send_replies_retried_nw;
-	long long peer_send_replies_retried_nw;
-
-	long long read_send_requests_nw_cycles[6];
-	long long writeback_send_requests_nw_cycles[6];
-	long long eviction_send_requests_nw_cycles[6];
-	long long downup_read_send_requests_nw_cycles[6];
-	long long downup_writeback_send_requests_nw_cycles[6];
-	long long downup_eviction_send_requests_nw_cycles[6];
-	long long peer_send_requests_nw_cycles[6];
-
-	long long read_send_replies_nw_cycles[6];
-	long long writeback_send_replies_nw_cycles[6];
-	long long eviction_send_replies_nw_cycles[6];
-	long long downup_read_send_replies_nw_cycles[6];
-	long long downup_writeback_send_replies_nw_cycles[6];
-	long long downup_eviction_send_replies_nw_cycles[6];
-	long long peer_send_replies_nw_cycles[6];
-
-	long long read_receive_requests_nw_cycles[6];
-	long long writeback_receive_requests_nw_cycles[6];
-	long long eviction_receive_requests_nw_cycles[6];
-	long long downup_read_receive_requests_nw_cycles[6];
-	long long downup_writeback_receive_requests_nw_cycles[6];
-	long long downup_eviction_receive_requests_nw_cycles[6];
-	long long peer_receive_requests_nw_cycles[6];
-
-	long long read_receive_replies_nw_cycles[6];
-	long long writeback_receive_replies_nw_cycles[6];
-	long long eviction_receive_replies_nw_cycles[6];
-	long long downup_read_receive_replies_nw_cycles[6];
-	long long downup_writeback_receive_replies_nw_cycles[6];
-	long long downup_eviction_receive_replies_nw_cycles[6];
-	long long peer_receive_replies_nw_cycles[6];
-
-	//-----------------------------------------------
-	// MISCELLANEOUS STATISTICS
-	//-----------------------------------------------
-	//-------------PEER TRANSFERS-----------------
-	long long peer_transfers;
-	//-------------DOWNUP INVALIDATION REQUESTS---
-	long long sharer_req_for_invalidation;
-
-	//----------------------------------------------------
-	// STATISTICS FOR CACHE STATES - Statistics capturing what all states were present, when a read/write or a down-up request was made.
-	//----------------------------------------------------
-	long long read_state_invalid;
-	long long read_state_noncoherent;
-	long long read_state_modified;
-	long long read_state_shared;
-	long long read_state_owned;
-	long long read_state_exclusive;
-
-	long long write_state_invalid;
-	long long write_state_noncoherent;
-	long long write_state_modified;
-	long long write_state_shared;
-	long long write_state_owned;
-	long long write_state_exclusive;
-
-	long long sharer_req_state_invalid;
-	long long sharer_req_state_noncoherent;
-	long long sharer_req_state_modified;
-	long long sharer_req_state_shared;
-	long long sharer_req_state_owned;
-	long long sharer_req_state_exclusive;
-	
-	//----------------------------------------------------
-	// STATISTICS FOR CACHE STATE TRANSITION - Statistics capturing what all state transition happened.
-	// The same counter can be used for a up-down request counter as well as lower level process doesn't issue any Load/Store hence the values observed can be used to increment the up-down values
-	// We use statistic counter for each type of transition, i.e. Load, Store, Down-up Read, Down-up WriteBack transaction.
-	// For a lower level module the eviction from a higher level transaction can cause a change/allocation in line, hence that is also noted here. (store_due_to_evict)
-	// The statistics of down-up eviction and store due to eviction are a subset of down-up writeback and store accesses respectively and hence not considered here.
- 	// There are some state transitions that can't happen but are kept just for model checking such as down-up writeback causing a valid to valid transition.
-	//----------------------------------------------------
-	// Statistics for Loads. A Load cannot have transitions like I -> O/M (for all), I -> E (for MSI) and S -> M/O/E/I (for all) and E -> M/O/S/I or E -> * (for MSI) and M -> O/S/E/I and O -> M/E/S/I or O->* (for MSI and MESI) as Load Hits are progressed without any advancement to system.
-	long long load_state_invalid_to_invalid;
-	long long load_state_invalid_to_noncoherent;
-	long long load_state_invalid_to_modified;
-	long long load_state_invalid_to_shared;
-	long long load_state_invalid_to_owned;
-	long long load_state_invalid_to_exclusive;
-
-	long long load_state_noncoherent_to_invalid;
-	long long load_state_noncoherent_to_noncoherent;
-	long long load_state_noncoherent_to_modified;
-	long long load_state_noncoherent_to_shared;
-	long long load_state_noncoherent_to_owned;
-	long long load_state_noncoherent_to_exclusive;
-
-	long long load_state_modified_to_invalid;
-	long long load_state_modified_to_noncoherent;
-	long long load_state_modified_to_modified;
-	long long load_state_modified_to_shared;
-	long long load_state_modified_to_owned;
-	long long load_state_modified_to_exclusive;
-
-	long long load_state_shared_to_invalid;
-	long long load_state_shared_to_noncoherent;
-	long long load_state_shared_to_modified;
-	long long load_state_shared_to_shared;
-	long long load_state_shared_to_owned;
-	long long load_state_shared_to_exclusive;
-
-	long long load_state_owned_to_invalid;
-	long long load_state_owned_to_noncoherent;
-	long long load_state_owned_to_modified;
-	long long load_state_owned_to_shared;
-	long long load_state_owned_to_owned;
-	long long load_state_owned_to_exclusive;
-
-	long long load_state_exclusive_to_invalid;
-	long long load_state_exclusive_to_noncoherent;
-	long long load_state_exclusive_to_modified;
-	long long load_state_exclusive_to_shared;
-	long long load_state_exclusive_to_owned;
-	long long load_state_exclusive_to_exclusive;
-
-	// Statistics for Stores. A store cannot have transitions like I -> I/O/E/S (for all) and E -> O/S/I or E -> * (for MSI) and M -> O/S/E/I and O -> O/E/S/I or O->* (for MSI and MESI) as Stores result in final state of Modified only..
-	long long store_state_invalid_to_invalid;
-	long long store_state_invalid_to_noncoherent;
-	long long store_state_invalid_to_modified;
-	long long store_state_invalid_to_shared;
-	long long store_state_invalid_to_owned;
-	long long store_state_invalid_to_exclusive;
-
-	long long store_state_noncoherent_to_invalid;
-	long long store_state_noncoherent_to_noncoherent;
-	long long store_state_noncoherent_to_modified;
-	long long store_state_noncoherent_to_shared;
-	long long store_state_noncoherent_to_owned;
-	long long store_state_noncoherent_to_exclusive;
-
-	long long store_state_modified_to_invalid;
-	long long store_state_modified_to_noncoherent;
-	long long store_state_modified_to_modified;
-	long long store_state_modified_to_shared;
-	long long store_state_modified_to_owned;
-	long long store_state_modified_to_exclusive;
-
-	long long store_state_shared_to_invalid;
-	long long store_state_shared_to_noncoherent;
-	long long store_state_shared_to_modified;
-	long long store_state_shared_to_shared;
-	long long store_state_shared_to_owned;
-	long long store_state_shared_to_exclusive;
-
-	long long store_state_owned_to_invalid;
-	long long store_state_owned_to_noncoherent;
-	long long store_state_owned_to_modified;
-	long long store_state_owned_to_shared;
-	long long store_state_owned_to_owned;
-	long long store_state_owned_to_exclusive;
-
-	long long store_state_exclusive_to_invalid;
-	long long store_state_exclusive_to_noncoherent;
-	long long store_state_exclusive_to_modified;
-	long long store_state_exclusive_to_shared;
-	long long store_state_exclusive_to_owned;
-	long long store_state_exclusive_to_exclusive;
-
-	//--------------------------------------------
-	// STATISTICS FOR DOWN-UP REQUESTS
-	//--------------------------------------------
-	
-	//-------------STATE TRANSITIONS BY A DOWNUP READ REQUEST--------------
-	// A Downup read request cannot have transitions like * -> E/O (for MSI), * -> O for (MOSI) and * -> M in general.
-	long long downup_read_req_state_invalid_to_invalid;
-	long long downup_read_req_state_invalid_to_noncoherent;
-	long long downup_read_req_state_invalid_to_modified;
-	long long downup_read_req_state_invalid_to_shared;
-	long long downup_read_req_state_invalid_to_owned;
-	long long downup_read_req_state_invalid_to_exclusive;
-
-	long long downup_read_req_state_noncoherent_to_invalid;
-	long long downup_read_req_state_noncoherent_to_noncoherent;
-	long long downup_read_req_state_noncoherent_to_modified;
-	long long downup_read_req_state_noncoherent_to_shared;
-	long long downup_read_req_state_noncoherent_to_owned;
-	long long downup_read_req_state_noncoherent_to_exclusive;
-
-	long long downup_read_req_state_modified_to_invalid;
-	long long downup_read_req_state_modified_to_noncoherent;
-	long long downup_read_req_state_modified_to_modified;
-	long long downup_read_req_state_modified_to_shared;
-	long long downup_read_req_state_modified_to_owned;
-	long long downup_read_req_state_modified_to_exclusive;
-
-	long long downup_read_req_state_shared_to_invalid;
-	long long downup_read_req_state_shared_to_noncoherent;
-	long long downup_read_req_state_shared_to_modified;
-	long long downup_read_req_state_shared_to_shared;
-	long long downup_read_req_state_shared_to_owned;
-	long long downup_read_req_state_shared_to_exclusive;
-
-	long long downup_read_req_state_owned_to_invalid;
-	long long downup_read_req_state_owned_to_noncoherent;
-	long long downup_read_req_state_owned_to_modified;
-	long long downup_read_req_state_owned_to_shared;
-	long long downup_read_req_state_owned_to_owned;
-	long long downup_read_req_state_owned_to_exclusive;
-
-	long long downup_read_req_state_exclusive_to_invalid;
-	long long downup_read_req_state_exclusive_to_noncoherent;
-	long long downup_read_req_state_exclusive_to_modified;
-	long long downup_read_req_state_exclusive_to_shared;
-	long long downup_read_req_state_exclusive_to_owned;
-	long long downup_read_req_state_exclusive_to_exclusive;
-	
-	//-------------STATE TRANSITIONS BY A DOWNUP WRITEBACK REQUEST--------------
-	// A Downup writeback request cannot have transitions like * -> E/O  and E/O -> *(for MSI), * -> O and O -> * for (MOSI) and * -> M or I -> * or M/O/E/S -> M/O/E/S in general.
-	long long downup_wb_req_state_invalid_to_invalid;
-	long long downup_wb_req_state_invalid_to_noncoherent;
-	long long downup_wb_req_state_invalid_to_modified;
-	long long downup_wb_req_state_invalid_to_shared;
-	long long downup_wb_req_state_invalid_to_owned;
-	long long downup_wb_req_state_invalid_to_exclusive;
-
-	long long downup_wb_req_state_noncoherent_to_invalid;
-	long long downup_wb_req_state_noncoherent_to_noncoherent;
-	long long downup_wb_req_state_noncoherent_to_modified;
-	long long downup_wb_req_state_noncoherent_to_shared;
-	long long downup_wb_req_state_noncoherent_to_owned;
-	long long downup_wb_req_state_noncoherent_to_exclusive;
-
-	long long downup_wb_req_state_modified_to_invalid;
-	long long downup_wb_req_state_modified_to_noncoherent;
-	long long downup_wb_req_state_modified_to_modified;
-	long long downup_wb_req_state_modified_to_shared;
-	long long downup_wb_req_state_modified_to_owned;
-	long long downup_wb_req_state_modified_to_exclusive;
-
-	long long downup_wb_req_state_shared_to_invalid;
-	long long downup_wb_req_state_shared_to_noncoherent;
-	long long downup_wb_req_state_shared_to_modified;
-	long long downup_wb_req_state_shared_to_shared;
-	long long downup_wb_req_state_shared_to_owned;
-	long long downup_wb_req_state_shared_to_exclusive;
-
-	long long downup_wb_req_state_owned_to_invalid;
-	long long downup_wb_req_state_owned_to_noncoherent;
-	long long downup_wb_req_state_owned_to_modified;
-	long long downup_wb_req_state_owned_to_shared;
-	long long downup_wb_req_state_owned_to_owned;
-	long long downup_wb_req_state_owned_to_exclusive;
-
-	long long downup_wb_req_state_exclusive_to_invalid;
-	long long downup_wb_req_state_exclusive_to_noncoherent;
-	long long downup_wb_req_state_exclusive_to_modified;
-	long long downup_wb_req_state_exclusive_to_shared;
-	long long downup_wb_req_state_exclusive_to_owned;
-	long long downup_wb_req_state_exclusive_to_exclusive;
-
-	//-----------------------------------------------------------
-	// STATISTICS FOR SNOOP BASED PROTOCOL
-	// This should include the following :
-	// 1.) Maximum length of queues at a time.
-	// 2.) Variation of length of queues at each time.
-	// 3.) Waiting address count  
-	// 4.) Waiting dependency count and maximum dependency for an address.
-	// 5.) Waiting time in terms of cycles.
-	// 6.) Read write and evict queues dependencies.
-	// 7.) Retires cauded due to dependencies.
-	// 8.) Maximum number of requests at a time at the level.
-	//-----------------------------------------------------------
-	
-	//-----------------------------------------------------------
-	// Parameter to measure the length of queue.
-	//-----------------------------------------------------------
 	long long read_write_req_queue_count;
 	long long evict_req_queue_count;
 	long long downup_req_queue_count;
 
-	//-----------------------------------------------------------
-	//Maximum length of queues at a time.
-	//-----------------------------------------------------------
-	long long max_read_write_req_queue_count;
-	long long max_evict_req_queue_count;
-	long long max_downup_req_queue_count;
-
-	//-----------------------------------------------------------
-	// Length of queues : The first parameter indicates the length of the individual queues, i.e. read-write request queues, evict queues and down-up request queues at a time.
-	// Again we divide the length into the following statistics 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64-127 and >127.
-	//-----------------------------------------------------------
-	long long read_write_req_queue_length[9];
-	long long evict_req_queue_length[9];
-	long long downup_req_queue_length[9];
-	long long pending_updown_queue_length[9];
-	long long total_queue_length[9];
-
-	//-----------------------------------------------------------
-	// Dependency count : Dependency is checked for same address.
-	// Following dependencies need to be observed 
-	// 1.) Depth of dependency in same level, say read-write depending on read-write.
-	// 2.) Depth of dependency between updown and downup level and vice-versa.
-	//-----------------------------------------------------------
-	//------------------------------------------------------------
-	// Maximum depth of dependency
-	//------------------------------------------------------------
-	long long max_read_write_req_dependency_read_write_req;
-	long long max_read_write_req_dependency_evict_req;
-	long long max_read_write_req_dependency_downup_req;
-	long long max_evict_req_dependency_read_write_req;
-	long long max_evict_req_dependency_evict_req;
-	long long max_evict_req_dependency_downup_req;
-	long long max_downup_req_dependency_read_write_req;
-	long long max_downup_req_dependency_evict_req;
-	long long max_downup_req_dependency_downup_req;
-
-	//---------------------------------------------------------------
-	// Distribution of dependency in queues. Intervals are 0, 1, 2-3, 4-7, 8-15, 16-31, >32
-	//---------------------------------------------------------------
-	long long read_write_req_dependency_read_write_req_queue[7];
-	long long read_write_req_dependency_evict_req_queue[7];
-	long long read_write_req_dependency_downup_req_queue[7];
-	long long evict_req_dependency_read_write_req_queue[7];
-	long long evict_req_dependency_evict_req_queue[7];
-	long long evict_req_dependency_downup_req_queue[7];
-	long long downup_req_dependency_read_write_req_queue[7];
-	long long downup_req_dependency_evict_req_queue[7];
-	long long downup_req_dependency_downup_req_queue[7];
-	
-	//---------------------------------------------------------------
-	// Actual dependency, i.e. which transactions has stopped for what transaction.
-	//---------------------------------------------------------------
-	long long read_write_req_waiting_for_read_write_req;
-	long long read_write_req_waiting_for_evict_req;
-	long long read_write_req_waiting_for_downup_req;
-	long long evict_req_waiting_for_read_write_req;
-	long long evict_req_waiting_for_evict_req;
-	long long evict_req_waiting_for_downup_req;
-	long long downup_req_waiting_to_be_sent_for_read_write_req;
-	long long downup_req_waiting_to_be_sent_for_evict_req;
-	long long downup_req_waiting_to_be_processed_for_downup_req;
-
-	//-------------------------------------------------------------
-	// Retries of Write Request due to a previously pending transaction.
-	//-------------------------------------------------------------
-	long long write_req_retry;
-
-	//-------------------------------------------------------------
-	// Delay caused due to waiting by transactions. These are dealys caused due to waiting only. Main transaction delays are recorded previously.
-	//-------------------------------------------------------------
-	long long read_write_req_waiting_delays[9];
-	long long evict_req_waiting_delays[9];
-	long long downup_req_waiting_delays[9];
-
-	//------------------------------------------------------------
-	//Delays due to individual wait in queues, i.e. say a downup wait for downup request wait, read write request wait, or an evict request wait. Similarly for evict and read write requests.
-	//------------------------------------------------------------
-	long long read_write_req_delay_for_read_write_req[9];
-	long long read_write_req_delay_for_evict_req[9];
-	long long read_write_req_delay_for_downup_req[9];
-	long long downup_req_delay_for_read_write_req[9];
-	long long downup_req_delay_for_evict_req[9];
-	long long downup_req_delay_for_downup_req[9];
-	long long evict_req_delay_for_read_write_req[9];
-	long long evict_req_delay_for_evict_req[9];
-	long long evict_req_delay_for_downup_req[9];
+	/* Statistics, reset by 'mod_reset_stats' */
+	struct
+	{
+		long long counters[mod_stat_count];  /* Declared in 'mod-stat.dat' */
+		long long accesses;
+		long long hits;
+
+		long long reads;
+		long long effective_reads;
+		long long effective_read_hits;
+		long long writes;
+		long long effective_writes;
+		long long effective_write_hits;
+		long long nc_writes;
+		long long effective_nc_writes;
+		long long effective_nc_write_hits;
+		long long prefetches;
+		long long prefetch_aborts;
+		long long useless_prefetches;
+		long long mshr_allocations;
+		long long mshr_load_merges;
+		long long mshr_store_merges;
+		long long mshr_full_stalls;
+		long long mshr_full_stall_cycles;
+		long long owner_reads;  /* Up-down reads to blocks modified or owned in a peer cache */
+		long long owner_read_cycles;
+		long long c2c_transfers;  /* Owner reads served by a cache-to-cache transfer */
+		long long c2c_latency_saved;  /* Access latency of this module skipped by them */
+		long long inclusion_victims;  /* Higher-level copies invalidated by evictions */
+		long long victim_fills;  /* Higher-level victims that allocated a block */
+
+		long long blocking_reads;
+		long long non_blocking_reads;
+		long long read_hits;
+		long long blocking_writes;
+		long long non_blocking_writes;
+		long long write_hits;
+		long long blocking_nc_writes;
+		long long non_blocking_nc_writes;
+		long long nc_write_hits;
+
+		long long read_retries;
+		long long write_retries;
+		long long nc_write_retries;
+		long long queued_retries;  /* Retries waiting in a lock queue */
+
+		long long no_retry_accesses;
+		long long no_retry_hits;
+		long long no_retry_reads;
+		long long no_retry_read_hits;
+		long long no_retry_writes;
+		long long no_retry_write_hits;
+		long long no_retry_nc_writes;
+		long long no_retry_nc_write_hits;
+
+		//----------------------------------------------------------
+		// STATISTICS for waiting times of accesses waiting in the process.
+		// The ranges are 1-3, 4-7, 8-15, 16-31, >32 cycles.
+		//----------------------------------------------------------
+		long long loads_time_waiting_for_non_coalesced_accesses[5];
+		long long loads_time_waiting_for_stores[5];
+		long long stores_time_waiting[5];
+
+		//---------------------------------------------------
+		// STATISTICS FOR WAITING ACCESSES : An access can be waiting due to the following reasons, in the FIND & LOCK operation, waiting for a module port or waiting for the directory lock.
+		// We categorise each access i.e. Read (load for top most level and up-down read request for the remaining lower levels), Write (store for top most level and up-down writeback request for remaining lower level), eviction, down-up writeback request and down-up read request. 
+		// We also try to find out the latency in case of the mod_ports, though the division is 1-8 cycles, 9-24, 25-50 and greater than 50 cycles.
+		//---------------------------------------------------
+		long long max_sim_read_waiting_for_mod_port; // TBD
+		long long max_sim_read_waiting_for_directory_lock; // TBD
+
+		long long max_sim_write_waiting_for_mod_port; // TBD
+		long long max_sim_write_waiting_for_directory_lock; // TBD
+
+		long long max_sim_eviction_waiting_for_mod_port; // TBD
+		long long max_sim_eviction_waiting_for_directory_lock; // TBD
+		long long eviction_waiting_for_other_accesses;
+
+		long long max_sim_downup_read_waiting_for_mod_port; // TBD
+		long long max_sim_downup_read_waiting_for_directory_lock; // TBD
+		long long downup_read_waiting_for_other_accesses;
+
+		long long max_sim_downup_writeback_waiting_for_mod_port; // TBD
+		long long max_sim_downup_writeback_waiting_for_directory_lock; // TBD
+		long long downup_writeback_waiting_for_other_accesses;
+
+		//-------------------------------------------------------
+		// Waiting statistics while the event is waiting for a module port or a directory lock.
+		//-------------------------------------------------------
+		long long read_time_waiting_mod_port[6];
+		long long write_time_waiting_mod_port[6];
+		long long eviction_time_waiting_mod_port[6];
+		long long downup_read_time_waiting_mod_port[6];
+		long long downup_writeback_time_waiting_mod_port[6];
+
+		long long read_time_waiting_directory_lock[6];
+		long long write_time_waiting_directory_lock[6];
+		long long eviction_time_waiting_directory_lock[6];
+		long long downup_read_time_waiting_directory_lock[6];
+		long long downup_writeback_time_waiting_directory_lock[6];
+
+		//---------------------------------------------------------
+		// STATISTICS for hit -> evict -> miss (TBD)
+		// This measures special statistics where it may happen that a Load Miss caused an eviction in the cache and the replacement entry was required again thus causing an unnecessary fetch from the lower level modules, thus adding to further delay. these can serve as basic blocks for some foundations in the replacement techniques. The minimum criteria is a Hit to an access that was evicted within 1000 cycles of its eviction.
+		//---------------------------------------------------------
+		long long load_miss_due_to_eviction;
+		long long store_miss_due_to_eviction;
+
+		//--------------------------------------------------------
+		// STATISTICS for controller occupancy : 
+		// These staistics show what was the request count on  a particular module at a given time.
+	  // Load/Store requests indicate the Load/Store generated by processor on the higher most cache and Up-down read/write requests on the lower caches.
+	 	// Eviction indicate the number of eviction transactions happening on the level
+	  // read/writeback indicate the number of read/writeback requests issued to lower level of memory
+	  // Down-up Read and write back requests indicate the remote read and writeback requests received,
+	 	// Down-up eviction requests indicate the number of downup writeback requests received as a result of eviction from the other peer (same level)
+	 	// Total processor requests indicate the number of Load and Store
+	  // Controller requests indicate the total number of read, eviction and writeback requests
+	  // total updown requests indicate the sum of processor and controller requests
+	  // total downup requests indicate the sum of all down-up requests arising due to Load/Store/Eviction
+	  // total requests indicate the total number of requests on the controller.
+		//--------------------------------------------------------
+		long long request_load[10];
+		long long request_store[10];
+		long long request_eviction[10];
+		long long request_read[10];
+		long long request_writeback[10];
+		long long request_downup_read[10];
+		long long request_downup_writeback[10];
+		long long request_downup_eviction[10];
+		long long request_processor[11];
+		long long request_controller[11];
+		long long request_updown[11];
+		long long request_downup[11];
+		long long request_total[12];
+
+		//---------------------------------------------------------
+		// STATISTICS FOR LATENCY
+		// Latency is measured in terms of cycle, here we measure latency as the the cycles that it takes to complete the request, rather than the arrival of first data stream for Load. The array indices represent the interval, say index i represents the interval [2^(i-1), 2^(i) - 1] and last indice represents all values >= 2^(i)
+		// Latency for eviction is further divided into the eviction for dirty lines and clean lines.
+		//---------------------------------------------------------
+		long long load_latency[10];
+		long long store_latency[10];
+		long long eviction_latency[10];
+		long long downup_read_request_latency[10];
+		long long downup_writeback_request_latency[10];
+		long long writeback_request_latency[10];
+		long long read_request_latency[10];
+		long long peer_latency[10];
+		long long invalidate_latency[10];
+
+		//----------------------------------------------------
+		// STATISTICS FOR NETWORK CONGESTION
+		// These counters indicate the requests and replies that were retried on the network due to busy state. From the given module the request may be retried or corresponding replies may be retried based on the netowrk contention. Request contention is basically on Lower level network and reply contention on the higher level network, in case of no lower or higher network (e.g. main memory or top level cache) the request and reply counter accordingly is zero.
+	  // There are statistics for the amount of cycles that are spent busy waiting for the network. Currently they are classified as 1-3, 4-7, 8-15, 16-31, 32-63 and >64 cycles for each classification.	
+		// This information is for send request and replies message only, there is no waiting at receive hence there are no  retried counters on reception.
+		// Make delay counters for reception as well.
+		//----------------------------------------------------
+
+		long long read_send_requests_nw_cycles[6];
+		long long writeback_send_requests_nw_cycles[6];
+		long long eviction_send_requests_nw_cycles[6];
+		long long downup_read_send_requests_nw_cycles[6];
+		long long downup_writeback_send_requests_nw_cycles[6];
+		long long downup_eviction_send_requests_nw_cycles[6];
+		long long peer_send_requests_nw_cycles[6];
+
+		long long read_send_replies_nw_cycles[6];
+		long long writeback_send_replies_nw_cycles[6];
+		long long eviction_send_replies_nw_cycles[6];
+		long long downup_read_send_replies_nw_cycles[6];
+		long long downup_writeback_send_replies_nw_cycles[6];
+		long long downup_eviction_send_replies_nw_cycles[6];
+		long long peer_send_replies_nw_cycles[6];
+
+		long long read_receive_requests_nw_cycles[6];
+		long long writeback_receive_requests_nw_cycles[6];
+		long long eviction_receive_requests_nw_cycles[6];
+		long long downup_read_receive_requests_nw_cycles[6];
+		long long downup_writeback_receive_requests_nw_cycles[6];
+		long long downup_eviction_receive_requests_nw_cycles[6];
+		long long peer_receive_requests_nw_cycles[6];
+
+		long long read_receive_replies_nw_cycles[6];
+		long long writeback_receive_replies_nw_cycles[6];
+		long long eviction_receive_replies_nw_cycles[6];
+		long long downup_read_receive_replies_nw_cycles[6];
+		long long downup_writeback_receive_replies_nw_cycles[6];
+		long long downup_eviction_receive_replies_nw_cycles[6];
+		long long peer_receive_replies_nw_cycles[6];
+
+		//-----------------------------------------------------------
+		//Maximum length of queues at a time.
+		//-----------------------------------------------------------
+		long long max_read_write_req_queue_count;
+		long long max_evict_req_queue_count;
+		long long max_downup_req_queue_count;
+
+		//-----------------------------------------------------------
+		// Length of queues : The first parameter indicates the length of the individual queues, i.e. read-write request queues, evict queues and down-up request queues at a time.
+		// Again we divide the length into the following statistics 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64-127 and >127.
+		//-----------------------------------------------------------
+		long long read_write_req_queue_length[9];
+		long long evict_req_queue_length[9];
+		long long downup_req_queue_length[9];
+		long long pending_updown_queue_length[9];
+		long long total_queue_length[9];
+
+		//-----------------------------------------------------------
+		// Dependency count : Dependency is checked for same address.
+		// Following dependencies need to be observed 
+		// 1.) Depth of dependency in same level, say read-write depending on read-write.
+		// 2.) Depth of dependency between updown and downup level and vice-versa.
+		//-----------------------------------------------------------
+		//------------------------------------------------------------
+		// Maximum depth of dependency
+		//------------------------------------------------------------
+		long long max_read_write_req_dependency_read_write_req;
+		long long max_read_write_req_dependency_evict_req;
+		long long max_read_write_req_dependency_downup_req;
+		long long max_evict_req_dependency_read_write_req;
+		long long max_evict_req_dependency_evict_req;
+		long long max_evict_req_dependency_downup_req;
+		long long max_downup_req_dependency_read_write_req;
+		long long max_downup_req_dependency_evict_req;
+		long long max_downup_req_dependency_downup_req;
+
+		//---------------------------------------------------------------
+		// Distribution of dependency in queues. Intervals are 0, 1, 2-3, 4-7, 8-15, 16-31, >32
+		//---------------------------------------------------------------
+		long long read_write_req_dependency_read_write_req_queue[7];
+		long long read_write_req_dependency_evict_req_queue[7];
+		long long read_write_req_dependency_downup_req_queue[7];
+		long long evict_req_dependency_read_write_req_queue[7];
+		long long evict_req_dependency_evict_req_queue[7];
+		long long evict_req_dependency_downup_req_queue[7];
+		long long downup_req_dependency_read_write_req_queue[7];
+		long long downup_req_dependency_evict_req_queue[7];
+		long long downup_req_dependency_downup_req_queue[7];
+
+		//---------------------------------------------------------------
+		// Actual dependency, i.e. which transactions has stopped for what transaction.
+		//---------------------------------------------------------------
+		long long read_write_req_waiting_for_read_write_req;
+		long long read_write_req_waiting_for_evict_req;
+		long long read_write_req_waiting_for_downup_req;
+		long long evict_req_waiting_for_read_write_req;
+		long long evict_req_waiting_for_evict_req;
+		long long evict_req_waiting_for_downup_req;
+		long long downup_req_waiting_to_be_sent_for_read_write_req;
+		long long downup_req_waiting_to_be_sent_for_evict_req;
+		long long downup_req_waiting_to_be_processed_for_downup_req;
+
+		//-------------------------------------------------------------
+		// Retries of Write Request due to a previously pending transaction.
+		//-------------------------------------------------------------
+		long long write_req_retry;
+
+		//-------------------------------------------------------------
+		// Delay caused due to waiting by transactions. These are dealys caused due to waiting only. Main transaction delays are recorded previously.
+		//-------------------------------------------------------------
+		long long read_write_req_waiting_delays[9];
+		long long evict_req_waiting_delays[9];
+		long long downup_req_waiting_delays[9];
+
+		//------------------------------------------------------------
+		//Delays due to individual wait in queues, i.e. say a downup wait for downup request wait, read write request wait, or an evict request wait. Similarly for evict and read write requests.
+		//------------------------------------------------------------
+		long long read_write_req_delay_for_read_write_req[9];
+		long long read_write_req_delay_for_evict_req[9];
+		long long read_write_req_delay_for_downup_req[9];
+		long long downup_req_delay_for_read_write_req[9];
+		long long downup_req_delay_for_evict_req[9];
+		long long downup_req_delay_for_downup_req[9];
+		long long evict_req_delay_for_read_write_req[9];
+		long long evict_req_delay_for_evict_req[9];
+		long long evict_req_delay_for_downup_req[9];
+	} stats;
 };
 
 struct mod_t *mod_create(char *name, enum mod_kind_t kind, int num_ports,
 	int block_size, int latency);
 void mod_free(struct mod_t *mod);
 void mod_dump(struct mod_t *mod, FILE *f);
+void mod_reset_stats(struct mod_t *mod);
 void mod_stack_set_reply(struct mod_stack_t *stack, int reply);
 struct mod_t *mod_stack_set_peer(struct mod_t *peer, int state);
 
 long long mod_access(struct mod_t *mod, enum mod_access_kind_t access_kind, 
 	unsigned int addr, int *witness_ptr, struct linked_list_t *event_queue,
 	void *event_queue_item, struct mod_client_info_t *client_info);
+long long mod_access_with_return(struct mod_t *mod,
+	enum mod_access_kind_t access_kind, unsigned int addr,
+	int ret_event, struct mod_stack_t *ret_stack);
 int mod_can_access(struct mod_t *mod, unsigned int addr);
 
+struct mshr_entry_t *mod_mshr_find(struct mod_t *mod, unsigned int addr);
+int mod_mshr_can_allocate(struct mod_t *mod);
+int mod_mshr_allocate(struct mod_t *mod, struct mod_stack_t *stack);
+int mod_mshr_can_merge(struct mod_t *mod, struct mshr_entry_t *mshr_entry,
+	struct mod_stack_t *stack);
+void mod_mshr_merge(struct mod_t *mod, struct mshr_entry_t *mshr_entry,
+	struct mod_stack_t *stack, int event);
+void mod_mshr_release(struct mod_t *mod, struct mod_stack_t *stack);
+void mod_mshr_dump(struct mod_t *mod, FILE *f);
+
 int mod_find_block(struct mod_t *mod, unsigned int addr, int *set_ptr, int *way_ptr, 
 	int *tag_ptr, int *state_ptr);
 
@@ -986,6 +705,9 @@ int mod_serves_address(struct mod_t *mod, unsigned int addr);
 struct mod_t *mod_get_low_mod(struct mod_t *mod, unsigned int addr);
 
 int mod_get_retry_latency(struct mod_t *mod);
+int mod_get_access_latency(struct mod_t *mod, struct mod_t *high_mod);
+unsigned int mod_range_interleaved_index(struct mod_t *mod, unsigned int addr);
+int mod_count_duplicate_blocks(struct mod_t *mod, int *valid_ptr);
 
 struct mod_stack_t *mod_can_coalesce(struct mod_t *mod,
 	enum mod_access_kind_t access_kind, unsigned int addr,
@@ -1037,6 +759,8 @@ void mod_read_write_req_access_finish(struct mod_t *mod, struct mod_stack_t *sta
 struct mod_stack_t *mod_in_flight_read_write_req_access(struct mod_t *mod, struct mod_stack_t *older_than_stack);
 struct mod_stack_t *mod_in_flight_read_write_req_address(struct mod_t *mod, unsigned int addr,
 	struct mod_stack_t *older_than_stack);
+struct mod_stack_t *mod_in_flight_read_write_req_id(struct mod_t *mod, unsigned int addr,
+	long long id);
 
 void mod_evict_start(struct mod_t *mod, struct mod_stack_t *stack,
 	enum mod_access_kind_t access_kind);
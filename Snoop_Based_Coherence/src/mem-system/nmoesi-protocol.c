@@ -84,6 +84,7 @@ int EV_MOD_NMOESI_WRITE_REQUEST_ACTION;
 int EV_MOD_NMOESI_WRITE_REQUEST_EXCLUSIVE;
 int EV_MOD_NMOESI_WRITE_REQUEST_UPDOWN;
 int EV_MOD_NMOESI_WRITE_REQUEST_UPDOWN_FINISH;
+int EV_MOD_NMOESI_WRITE_REQUEST_UPDATE;
 int EV_MOD_NMOESI_WRITE_REQUEST_DOWNUP;
 int EV_MOD_NMOESI_WRITE_REQUEST_DOWNUP_FINISH;
 int EV_MOD_NMOESI_WRITE_REQUEST_REPLY;
@@ -134,6 +135,116 @@ static int cache_block_next_state(int flag_shared, int flag_dirty)
 	}
 }
 
+/* Retry an access that got an error because a non-blocking request found a
+ * block locked, or a write request found an older request in flight. With
+ * lock queues, the access waits in the queue of that block or in the wait
+ * list of that request, and is resumed with 'event' when it is released.
+ * Otherwise, or if it was released in the meantime, the access is retried
+ * after a random latency. */
+static void mod_nmoesi_retry(struct mod_t *mod, struct mod_stack_t *stack, int event)
+{
+	struct mod_t *conflict_mod = stack->conflict_mod;
+	struct mod_stack_t *older_stack;
+	int retry_lat;
+
+	stack->retry = 1;
+	stack->conflict_mod = NULL;
+	if (mem_lock_queue && conflict_mod && stack->conflict_set < 0)
+	{
+		/* Write request found an older request in flight */
+		older_stack = mod_in_flight_read_write_req_id(conflict_mod,
+			stack->addr, stack->conflict_id);
+		if (older_stack)
+		{
+			mem_debug("    lock error, waiting for request %lld in %s\n",
+				older_stack->id, conflict_mod->name);
+			mod->stats.queued_retries++;
+			mod_stack_wait_in_stack(stack, older_stack, event);
+			return;
+		}
+	}
+	else if (mem_lock_queue && conflict_mod && cache_entry_wait(conflict_mod->cache,
+			stack->conflict_set, stack->conflict_way, event, stack))
+	{
+		mem_debug("    lock error, waiting for %s to unlock set=%d, way=%d\n",
+			conflict_mod->name, stack->conflict_set, stack->conflict_way);
+		mod->stats.queued_retries++;
+		return;
+	}
+
+	retry_lat = mod_get_retry_latency(mod);
+	mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
+	esim_schedule_event(event, stack, retry_lat);
+}
+
+/* Send a down-up read request for the block of up-down read request 'stack'
+ * to every higher-level module of its target other than the requester, each
+ * replying with event READ_REQUEST_UPDOWN_FINISH. An owner of a requested
+ * sub-block sends it directly to 'peer', if not NULL. */
+static void mod_nmoesi_snoop_higher_mods(struct mod_stack_t *stack, struct mod_t *peer)
+{
+	struct mod_t *mod = stack->mod;
+	struct mod_t *target_mod = stack->target_mod;
+	struct mod_stack_t *new_stack;
+	struct net_node_t *node;
+	struct mod_t *sharer;
+	uint32_t cache_entry_tag, z;
+	int i;
+
+	for(z=0; z<target_mod->num_sub_blocks; z++)
+	{
+		cache_entry_tag = stack->tag + z * target_mod->sub_block_size;
+		
+		for(i=0; i<target_mod->num_nodes; i++)
+		{
+			/* Get sharer mod */
+			node = list_get(target_mod->high_net->node_list, i);
+
+			// The request has not to be sent for the following cases.
+			// 1.) The down-up write back request needn't be sent to the issuing module (Module that started the transaction) itself.
+			// 2.) Node should be an end node.
+			// 3.) Node shouldn't be the target or issuing request module itself.
+			if(node->kind != net_node_end)
+				continue;
+
+			sharer = node->user_data;
+			assert(sharer);
+
+			if(sharer->mod_id == target_mod->mod_id)
+				continue;
+
+			if(sharer->mod_id == stack->orig_mod_id)
+				continue;
+
+			// if(sharer->mod_id == stack->issue_mod_id)
+			// 	continue;
+
+			/* Not the first sub-block */
+			if (cache_entry_tag % sharer->block_size)
+				continue;
+
+			/* Send read request */
+			stack->pending++;
+			new_stack = mod_stack_create(stack->id, target_mod, cache_entry_tag,
+				EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack);
+
+			/* Only set peer if its a subblock that was requested. An owner
+			 * of the block will send it to mod directly. */
+			if (peer && cache_entry_tag >= stack->addr && 
+				cache_entry_tag < stack->addr + mod->block_size)
+			{
+				new_stack->peer = peer;
+			}
+
+			new_stack->orig_mod_id = target_mod->mod_id;
+			new_stack->target_mod = sharer;
+			new_stack->request_dir = mod_request_down_up;
+			new_stack->downup_read_request = 1;
+			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST, new_stack, 0);
+		}
+	}
+}
+
 /* NMOESI Protocol */
 
 void mod_handler_nmoesi_load(int event, void *data)
@@ -144,9 +255,13 @@ void mod_handler_nmoesi_load(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_LOAD)
 	{
 		struct mod_stack_t *master_stack;
+		struct mshr_entry_t *mshr_entry;
 
 		mem_debug("%lld %lld 0x%x %s load\n", esim_time, stack->id,
 			stack->addr, mod->name);
@@ -167,12 +282,25 @@ void mod_handler_nmoesi_load(int event, void *data)
 		mod->num_load_requests++;
 		mod_update_request_counters(mod, mod_trans_load);
 
+		/* Account for late prefetches */
+		prefetcher_access_start(stack, mod);
+
+		/* Secondary miss, attach to the MSHR entry of the primary miss */
+		mshr_entry = mod_mshr_find(mod, stack->addr);
+		if (mshr_entry && mod_mshr_can_merge(mod, mshr_entry, stack))
+		{
+			mod->stats.reads++;
+			MOD_STAT_INC(mod, coalesced_loads);
+			mod_mshr_merge(mod, mshr_entry, stack, EV_MOD_NMOESI_LOAD_FINISH);
+			return;
+		}
+
 		/* Coalesce access */
 		master_stack = mod_can_coalesce(mod, mod_access_load, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->reads++;
-			mod->coalesced_loads++;
+			mod->stats.reads++;
+			MOD_STAT_INC(mod, coalesced_loads);
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_NMOESI_LOAD_FINISH);
 			return;
@@ -206,8 +334,8 @@ void mod_handler_nmoesi_load(int event, void *data)
 			if(stack->load_access_waiting_for_store_start_cycle == 0)
 			{
 				stack->load_access_waiting_for_store_start_cycle = esim_cycle();
-				mod->read_waiting_for_other_accesses++;
-				mod->loads_waiting_for_stores++;
+				MOD_STAT_INC(mod, read_waiting_for_other_accesses);
+				MOD_STAT_INC(mod, loads_waiting_for_stores);
 			}
 
 			return;
@@ -231,8 +359,8 @@ void mod_handler_nmoesi_load(int event, void *data)
 			if(stack->load_access_waiting_start_cycle == 0)
 			{
 				stack->load_access_waiting_start_cycle = esim_cycle();
-				mod->read_waiting_for_other_accesses++;
-				mod->loads_waiting_for_non_coalesced_accesses++;
+				MOD_STAT_INC(mod, read_waiting_for_other_accesses);
+				MOD_STAT_INC(mod, loads_waiting_for_non_coalesced_accesses);
 			}
 
 			return;
@@ -262,8 +390,6 @@ void mod_handler_nmoesi_load(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_LOAD_ACTION)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s load action\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:load_action\"\n",
@@ -272,17 +398,15 @@ void mod_handler_nmoesi_load(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->read_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_LOAD_LOCK, stack, retry_lat);
+			mod->stats.read_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_LOAD_LOCK);
 			return;
 		}
 
 		/* Hit */
 		if (stack->state)
 		{
+			cache_reset_updates(mod->cache, stack->set, stack->way);
 			esim_schedule_event(EV_MOD_NMOESI_LOAD_UNLOCK, stack, 0);
 
 			/* The prefetcher may have prefetched this earlier and hence
@@ -293,8 +417,17 @@ void mod_handler_nmoesi_load(int event, void *data)
 			return;
 		}
 
+		/* Primary miss. If there is no free MSHR entry, unlock the block
+		 * and wait for an entry to be released. */
+		if (!stack->mshr_entry && !mod_mshr_allocate(mod, stack))
+		{
+			cache_entry_unlock(mod->cache, stack->set, stack->way);
+			mod_stack_wait_in_mod(stack, mod, EV_MOD_NMOESI_LOAD_LOCK);
+			return;
+		}
+
 		// Update counter for generation of a Up-down read request
-		mod->updown_read_requests_generated++;
+		MOD_STAT_INC(mod, updown_read_requests_generated);
 
 		/* Miss */
 		new_stack = mod_stack_create(stack->id, mod, stack->tag,
@@ -315,7 +448,6 @@ void mod_handler_nmoesi_load(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_LOAD_MISS)
 	{
-		int retry_lat;
 		int next_state;
 		struct mod_t *check_mod;
 
@@ -327,12 +459,9 @@ void mod_handler_nmoesi_load(int event, void *data)
 		/* Error on read request. Unlock block and retry load. */
 		if (stack->err)
 		{
-			mod->read_retries++;
-			retry_lat = mod_get_retry_latency(mod);
+			mod->stats.read_retries++;
 			cache_entry_unlock(mod->cache, stack->set, stack->way);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_LOAD_LOCK, stack, retry_lat);
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_LOAD_LOCK);
 			return;
 		}
 
@@ -364,6 +493,9 @@ void mod_handler_nmoesi_load(int event, void *data)
 		/* Unlock cache entry */
 		cache_entry_unlock(mod->cache, stack->set, stack->way);
 		
+		/* Release MSHR entry */
+		mod_mshr_release(mod, stack);
+
 		/* Impose the access latency before continuing */
 		esim_schedule_event(EV_MOD_NMOESI_LOAD_FINISH, stack, 
 			mod->latency);
@@ -422,9 +554,13 @@ void mod_handler_nmoesi_store(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_STORE)
 	{
 		struct mod_stack_t *master_stack;
+		struct mshr_entry_t *mshr_entry;
 
 		mem_debug("%lld %lld 0x%x %s store\n", esim_time, stack->id,
 			stack->addr, mod->name);
@@ -443,12 +579,30 @@ void mod_handler_nmoesi_store(int event, void *data)
 		mod->num_store_requests++;
 		mod_update_request_counters(mod, mod_trans_store);
 
+		/* Account for late prefetches */
+		prefetcher_access_start(stack, mod);
+
+		/* Secondary miss, merge into the pending fill of the primary miss */
+		mshr_entry = mod_mshr_find(mod, stack->addr);
+		if (mshr_entry && mod_mshr_can_merge(mod, mshr_entry, stack))
+		{
+			mod->stats.writes++;
+			MOD_STAT_INC(mod, coalesced_stores);
+			mod_mshr_merge(mod, mshr_entry, stack, EV_MOD_NMOESI_STORE_FINISH);
+
+			/* Increment witness variable */
+			if (stack->witness_ptr)
+				(*stack->witness_ptr)++;
+
+			return;
+		}
+
 		/* Coalesce access */
 		master_stack = mod_can_coalesce(mod, mod_access_store, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->writes++;
-			mod->coalesced_stores++;
+			mod->stats.writes++;
+			MOD_STAT_INC(mod, coalesced_stores);
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_NMOESI_STORE_FINISH);
 
@@ -489,7 +643,7 @@ void mod_handler_nmoesi_store(int event, void *data)
 			if(stack->store_access_waiting_start_cycle == 0)
 			{
 				stack->store_access_waiting_start_cycle = esim_cycle();
-		  	mod->write_waiting_for_other_accesses++;
+		  	MOD_STAT_INC(mod, write_waiting_for_other_accesses);
 			}
 			return;
 		}
@@ -520,8 +674,6 @@ void mod_handler_nmoesi_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_STORE_ACTION)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s store action\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:store_action\"\n",
@@ -530,11 +682,8 @@ void mod_handler_nmoesi_store(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_STORE_LOCK, stack, retry_lat);
+			mod->stats.write_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_STORE_LOCK);
 			return;
 		}
 
@@ -553,8 +702,17 @@ void mod_handler_nmoesi_store(int event, void *data)
 			return;
 		}
 
+		/* Primary miss. If there is no free MSHR entry, unlock the block
+		 * and wait for an entry to be released. */
+		if (!stack->mshr_entry && !mod_mshr_allocate(mod, stack))
+		{
+			cache_entry_unlock(mod->cache, stack->set, stack->way);
+			mod_stack_wait_in_mod(stack, mod, EV_MOD_NMOESI_STORE_LOCK);
+			return;
+		}
+
 		// Update counter for generation of a Up-down WB request
-		mod->updown_writeback_requests_generated++;
+		MOD_STAT_INC(mod, updown_writeback_requests_generated);
 		/* Miss - state=O/S/I/N */
 		new_stack = mod_stack_create(stack->id, mod, stack->tag,
 			EV_MOD_NMOESI_STORE_UNLOCK, stack);
@@ -564,6 +722,13 @@ void mod_handler_nmoesi_store(int event, void *data)
 		new_stack->target_mod = mod_get_low_mod(mod, stack->tag);
 		new_stack->request_dir = mod_request_up_down;
 		new_stack->write = 1;
+
+		/* With update coherence, a store to a shared copy sends the written
+		 * word to the other copies instead of invalidating them. */
+		stack->update = (stack->state == cache_block_owned ||
+			stack->state == cache_block_shared) &&
+			new_stack->target_mod->coherence != mod_coherence_invalidate;
+		new_stack->update = stack->update;
 		esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST, new_stack, 0);
 
 		/* The prefetcher may be interested in this miss */
@@ -574,7 +739,6 @@ void mod_handler_nmoesi_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_STORE_UNLOCK)
 	{
-		int retry_lat;
 		int next_state;
 		struct mod_t *check_mod;
 
@@ -586,19 +750,19 @@ void mod_handler_nmoesi_store(int event, void *data)
 		/* Error in write request, unlock block and retry store. */
 		if (stack->err)
 		{
-			mod->write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
+			mod->stats.write_retries++;
 			cache_entry_unlock(mod->cache, stack->set, stack->way);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_STORE_LOCK, stack, retry_lat);
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_STORE_LOCK);
 			return;
 		}
 
-		/* Update tag/state and unlock */
+		/* Update tag/state and unlock. After an update that other copies
+		 * kept, the writer owns the block. */
+		next_state = stack->update && stack->shared ? cache_block_owned :
+			cache_block_modified;
 		cache_set_block(mod->cache, stack->set, stack->way,
-			stack->tag, cache_block_modified);
-		next_state = cache_block_modified;
+			stack->tag, next_state);
+		cache_reset_updates(mod->cache, stack->set, stack->way);
 		
 		check_mod = mod_get_low_mod(mod, stack->tag);	
 		mod_check_coherency_status(check_mod, mod, mod, stack->tag, next_state, 0, stack);
@@ -607,6 +771,9 @@ void mod_handler_nmoesi_store(int event, void *data)
 
 		mod_update_state_modification_counters(mod, stack->prev_state, next_state, mod_trans_store);
 
+		/* Release MSHR entry */
+		mod_mshr_release(mod, stack);
+
 		/* Impose the access latency before continuing */
 		esim_schedule_event(EV_MOD_NMOESI_STORE_FINISH, stack, 
 			mod->latency);
@@ -658,6 +825,9 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_NC_STORE)
 	{
 		struct mod_stack_t *master_stack;
@@ -674,7 +844,7 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		master_stack = mod_can_coalesce(mod, mod_access_nc_store, stack->addr, stack);
 		if (master_stack)
 		{
-			mod->nc_writes++;
+			mod->stats.nc_writes++;
 			mod_coalesce(mod, master_stack, stack);
 			mod_stack_wait_in_stack(stack, master_stack, EV_MOD_NMOESI_NC_STORE_FINISH);
 			return;
@@ -727,8 +897,6 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_NC_STORE_WRITEBACK)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s nc store writeback\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:nc_store_writeback\"\n",
@@ -737,11 +905,8 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->nc_write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_NC_STORE_LOCK, stack, retry_lat);
+			mod->stats.nc_write_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_NC_STORE_LOCK);
 			return;
 		}
 
@@ -767,8 +932,6 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_NC_STORE_ACTION)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s nc store action\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:nc_store_action\"\n",
@@ -777,11 +940,8 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		/* Error locking */
 		if (stack->err)
 		{
-			mod->nc_write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_NC_STORE_LOCK, stack, retry_lat);
+			mod->stats.nc_write_retries++;
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_NC_STORE_LOCK);
 			return;
 		}
 
@@ -835,8 +995,6 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 
 	if (event == EV_MOD_NMOESI_NC_STORE_MISS)
 	{
-		int retry_lat;
-
 		mem_debug("  %lld %lld 0x%x %s nc store miss\n", esim_time, stack->id,
 			stack->addr, mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:nc_store_miss\"\n",
@@ -845,12 +1003,9 @@ void mod_handler_nmoesi_nc_store(int event, void *data)
 		/* Error on read request. Unlock block and retry nc store. */
 		if (stack->err)
 		{
-			mod->nc_write_retries++;
-			retry_lat = mod_get_retry_latency(mod);
+			mod->stats.nc_write_retries++;
 			cache_entry_unlock(mod->cache, stack->set, stack->way);
-			mem_debug("    lock error, retrying in %d cycles\n", retry_lat);
-			stack->retry = 1;
-			esim_schedule_event(EV_MOD_NMOESI_NC_STORE_LOCK, stack, retry_lat);
+			mod_nmoesi_retry(mod, stack, EV_MOD_NMOESI_NC_STORE_LOCK);
 			return;
 		}
 
@@ -920,6 +1075,9 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_PREFETCH)
 	{
 		struct mod_stack_t *master_stack;
@@ -941,7 +1099,7 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			mem_debug("  %lld %lld 0x%x %s useless prefetch - already being fetched\n",
 				  esim_time, stack->id, stack->addr, mod->name);
 
-			mod->useless_prefetches++;
+			mod->stats.useless_prefetches++;
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 
 			/* Increment witness variable */
@@ -1008,7 +1166,7 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			Effectively this means that prefetches are of low priority.
 			This can be improved to not retry only when the current lock
 			holder is writing to the block. */
-			mod->prefetch_aborts++;
+			mod->stats.prefetch_aborts++;
 			mem_debug("    lock error, aborting prefetch\n");
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 			return;
@@ -1021,12 +1179,22 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			mem_debug("  %lld %lld 0x%x %s useless prefetch - cache hit\n",
 				  esim_time, stack->id, stack->addr, mod->name);
 
-			mod->useless_prefetches++;
+			mod->stats.useless_prefetches++;
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_UNLOCK, stack, 0);
 			return;
 		}
 
-		/* Miss */
+		/* Miss. Prefetches do not wait for a free MSHR entry. */
+		if (!mod_mshr_can_allocate(mod))
+		{
+			mod->stats.prefetch_aborts++;
+			cache_entry_unlock(mod->cache, stack->set, stack->way);
+			mem_debug("    MSHR full, aborting prefetch\n");
+			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
+			return;
+		}
+		mod_mshr_allocate(mod, stack);
+
 		new_stack = mod_stack_create(stack->id, mod, stack->tag,
 			EV_MOD_NMOESI_PREFETCH_MISS, stack);
 		new_stack->orig_mod_id = mod->mod_id;
@@ -1055,8 +1223,9 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 			/* Don't want to ever retry prefetches if read request failed. 
 			 * Effectively this means that prefetches are of low priority.
 			 * This can be improved depending on the reason for read request fail */
-			mod->prefetch_aborts++;
+			mod->stats.prefetch_aborts++;
 			cache_entry_unlock(mod->cache, stack->set, stack->way);
+			mod_mshr_release(mod, stack);
 			mem_debug("    lock error, aborting prefetch\n");
 			esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 			return;
@@ -1079,7 +1248,7 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 		 * TODO: The lower caches that will be filled because of this prefetch
 		 * do not know if it was a prefetch or not. Need to have a way to mark
 		 * them as prefetched too. */
-		mod_block_set_prefetched(mod, stack->addr, 1);
+		prefetcher_access_fill(stack, mod);
 
 		/* Continue */
 		esim_schedule_event(EV_MOD_NMOESI_PREFETCH_UNLOCK, stack, 0);
@@ -1096,6 +1265,9 @@ void mod_handler_nmoesi_prefetch(int event, void *data)
 		/* Unlock directory entry */
 		cache_entry_unlock(mod->cache, stack->set, stack->way);
 
+		/* Release MSHR entry */
+		mod_mshr_release(mod, stack);
+
 		/* Continue */
 		esim_schedule_event(EV_MOD_NMOESI_PREFETCH_FINISH, stack, 0);
 		return;
@@ -1142,6 +1314,9 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 	struct mod_t *mod = stack->mod;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_FIND_AND_LOCK)
 	{
 		mem_debug("  %lld %lld 0x%x %s find and lock (blocking=%d)\n",
@@ -1163,6 +1338,7 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 	if (event == EV_MOD_NMOESI_FIND_AND_LOCK_PORT)
 	{
 		struct mod_port_t *port = stack->port;
+		struct mod_stack_t *iter;
 		struct cache_lock_t *cache_lock; // This is a symbolic Lock not an actual lock
 
 		assert(stack->port);
@@ -1193,84 +1369,84 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 				str_map_value(&cache_block_state_map, stack->state));
 
 		/* Statistics */
-		mod->accesses++;
+		mod->stats.accesses++;
 		if (stack->hit)
-			mod->hits++;
+			mod->stats.hits++;
 
 		if (stack->read)
 		{
-			mod->reads++;
+			mod->stats.reads++;
 
-			if(stack->downup_read_request) mod->downup_read_requests++;
-			else                    			 mod->load_requests++;
+			if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_requests);
+			else                    			 MOD_STAT_INC(mod, load_requests);
 
-			mod->effective_reads++;
-			stack->blocking ? mod->blocking_reads++ : mod->non_blocking_reads++;
+			mod->stats.effective_reads++;
+			stack->blocking ? mod->stats.blocking_reads++ : mod->stats.non_blocking_reads++;
 			if (stack->hit)
 			{
-				mod->read_hits++;
+				mod->stats.read_hits++;
 
-				if(stack->downup_read_request) mod->downup_read_requests_hits++;
-				else 													 mod->load_requests_hits++;
+				if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_requests_hits);
+				else 													 MOD_STAT_INC(mod, load_requests_hits);
 
 				if(ret->request_dir == mod_request_down_up)
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->sharer_req_state_modified++; break;
-						case cache_block_owned	     : mod->sharer_req_state_owned++; break;
-						case cache_block_exclusive   : mod->sharer_req_state_exclusive++; break;
-						case cache_block_shared      : mod->sharer_req_state_shared++; break;
-						case cache_block_noncoherent : mod->sharer_req_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, sharer_req_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, sharer_req_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, sharer_req_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, sharer_req_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, sharer_req_state_noncoherent); break;
 					}
 				}
 				else
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->read_state_modified++; break;
-						case cache_block_owned	     : mod->read_state_owned++; break;
-						case cache_block_exclusive   : mod->read_state_exclusive++; break;
-						case cache_block_shared      : mod->read_state_shared++; break;
-						case cache_block_noncoherent : mod->read_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, read_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, read_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, read_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, read_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, read_state_noncoherent); break;
 					}
 				}
 			}
 			else
 			{
 				if(ret->request_dir == mod_request_down_up)
-					mod->sharer_req_state_invalid++;
+					MOD_STAT_INC(mod, sharer_req_state_invalid);
 				else
-					mod->read_state_invalid++;
+					MOD_STAT_INC(mod, read_state_invalid);
 
-		  	if(stack->downup_read_request) mod->downup_read_requests_misses++;
-				else 													 mod->load_requests_misses++;
+		  	if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_requests_misses);
+				else 													 MOD_STAT_INC(mod, load_requests_misses);
 			}
 
 		}
 		else if (stack->prefetch)
 		{
-			mod->prefetches++;
+			mod->stats.prefetches++;
 		}
 		else if (stack->nc_write)  /* Must go after read */
 		{
-			mod->nc_writes++;
-			mod->effective_nc_writes++;
-			stack->blocking ? mod->blocking_nc_writes++ : mod->non_blocking_nc_writes++;
+			mod->stats.nc_writes++;
+			mod->stats.effective_nc_writes++;
+			stack->blocking ? mod->stats.blocking_nc_writes++ : mod->stats.non_blocking_nc_writes++;
 			if (stack->hit)
-				mod->nc_write_hits++;
+				mod->stats.nc_write_hits++;
 		}
 		else if (stack->write)
 		{
-			mod->writes++;
-			mod->effective_writes++;
-			stack->blocking ? mod->blocking_writes++ : mod->non_blocking_writes++;
+			mod->stats.writes++;
+			mod->stats.effective_writes++;
+			stack->blocking ? mod->stats.blocking_writes++ : mod->stats.non_blocking_writes++;
 			
-			if(stack->evict_trans) mod->writeback_due_to_eviction++;
+			if(stack->evict_trans) MOD_STAT_INC(mod, writeback_due_to_eviction);
 
 			// Here we donot consider the effects of evict transactions while considering a Store/Up-down writeback as for a lower level module it is the writeback requests.	
-			if(stack->downup_writeback_request) mod->downup_writeback_requests++;
-			else                                mod->store_requests++;
+			if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_requests);
+			else                                MOD_STAT_INC(mod, store_requests);
 
 			/* Increment witness variable when port is locked */
 			if (stack->witness_ptr)
@@ -1281,47 +1457,47 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 
 			if (stack->hit)
 			{
-				mod->write_hits++;
+				mod->stats.write_hits++;
 
-				if(stack->evict_trans) mod->writeback_due_to_eviction_hits++;
+				if(stack->evict_trans) MOD_STAT_INC(mod, writeback_due_to_eviction_hits);
 
-				if(stack->downup_writeback_request) mod->downup_writeback_requests_hits++;
-				else                                mod->store_requests_hits++;
+				if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_requests_hits);
+				else                                MOD_STAT_INC(mod, store_requests_hits);
 
 				if(ret->request_dir == mod_request_down_up)
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->sharer_req_state_modified++; break;
-						case cache_block_owned	     : mod->sharer_req_state_owned++; break;
-						case cache_block_exclusive   : mod->sharer_req_state_exclusive++; break;
-						case cache_block_shared      : mod->sharer_req_state_shared++; break;
-						case cache_block_noncoherent : mod->sharer_req_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, sharer_req_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, sharer_req_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, sharer_req_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, sharer_req_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, sharer_req_state_noncoherent); break;
 					}
 				}
 				else
 				{
 					switch(stack->state)
 					{
-						case cache_block_modified    : mod->write_state_modified++; break;
-						case cache_block_owned	     : mod->write_state_owned++; break;
-						case cache_block_exclusive   : mod->write_state_exclusive++; break;
-						case cache_block_shared      : mod->write_state_shared++; break;
-						case cache_block_noncoherent : mod->write_state_noncoherent++; break;
+						case cache_block_modified    : MOD_STAT_INC(mod, write_state_modified); break;
+						case cache_block_owned	     : MOD_STAT_INC(mod, write_state_owned); break;
+						case cache_block_exclusive   : MOD_STAT_INC(mod, write_state_exclusive); break;
+						case cache_block_shared      : MOD_STAT_INC(mod, write_state_shared); break;
+						case cache_block_noncoherent : MOD_STAT_INC(mod, write_state_noncoherent); break;
 					}
 				}
 			}
 			else
 			{
 				if(ret->request_dir == mod_request_down_up)
-					mod->sharer_req_state_invalid++;
+					MOD_STAT_INC(mod, sharer_req_state_invalid);
 				else
-					mod->write_state_invalid++;
+					MOD_STAT_INC(mod, write_state_invalid);
 				
-				if(stack->evict_trans) mod->writeback_due_to_eviction_misses++;
+				if(stack->evict_trans) MOD_STAT_INC(mod, writeback_due_to_eviction_misses);
 
-				if(stack->downup_writeback_request) mod->downup_writeback_requests_misses++;
-				else                                mod->store_requests_misses++;
+				if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_requests_misses);
+				else                                MOD_STAT_INC(mod, store_requests_misses);
 			}
 		}
 		else if (stack->message)
@@ -1335,27 +1511,27 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 
 		if (!stack->retry)
 		{
-			mod->no_retry_accesses++;
+			mod->stats.no_retry_accesses++;
 			if (stack->hit)
-				mod->no_retry_hits++;
+				mod->stats.no_retry_hits++;
 			
 			if (stack->read)
 			{
-				mod->no_retry_reads++;
+				mod->stats.no_retry_reads++;
 				if (stack->hit)
-					mod->no_retry_read_hits++;
+					mod->stats.no_retry_read_hits++;
 			}
 			else if (stack->nc_write)  /* Must go after read */
 			{
-				mod->no_retry_nc_writes++;
+				mod->stats.no_retry_nc_writes++;
 				if (stack->hit)
-					mod->no_retry_nc_write_hits++;
+					mod->stats.no_retry_nc_write_hits++;
 			}
 			else if (stack->write)
 			{
-				mod->no_retry_writes++;
+				mod->stats.no_retry_writes++;
 				if (stack->hit)
-					mod->no_retry_write_hits++;
+					mod->stats.no_retry_write_hits++;
 			}
 			else if (stack->prefetch)
 			{
@@ -1373,7 +1549,8 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 
 		// For a Snoop based protocol the Load operation behaves similar to a Directory based protocol.
 		// For an Evict transaction, the only thing that needs to be done is to try for a cache lock.
-		if(!stack->downup_read_request && !stack->downup_writeback_request && !stack->evict_trans)
+		// Unless it fills a cache that is not inclusive, in which case it allocates a block as a load or store does.
+		if(!stack->downup_read_request && !stack->downup_writeback_request && (!stack->evict_trans || stack->victim_fill))
 		{
 			if (!stack->hit)
 			{
@@ -1390,7 +1567,7 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 		 * blocking, release port and return error. */
 		// Instead of a directory based check for a cache entry lock.
 		// In case of a Snoop based protocol if there is a downup read or writeback request and it is a miss then bypass throughout without waiting for the lock.
-		if(stack->hit || (!stack->downup_read_request && !stack->evict_trans && !stack->downup_writeback_request))
+		if(stack->hit || (!stack->downup_read_request && (!stack->evict_trans || stack->victim_fill) && !stack->downup_writeback_request))
 		{
 			cache_lock = cache_lock_get(mod->cache, stack->set, stack->way);
 			if (cache_lock->lock && !stack->blocking)
@@ -1398,6 +1575,14 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 				mem_debug("    %lld 0x%x %s block locked at set=%d, way=%d by A-%lld - aborting\n",
 					stack->id, stack->tag, mod->name, stack->set, stack->way, cache_lock->stack_id);
 				ret->err = 1;
+				/* Record the busy lock so that the requests waiting for this
+				 * one can wait for it to be released before retrying */
+				for (iter = ret; iter; iter = iter->ret_stack)
+				{
+					iter->conflict_mod = mod;
+					iter->conflict_set = stack->set;
+					iter->conflict_way = stack->way;
+				}
 				mod_unlock_port(mod, port, stack);
 				ret->port_locked = 0;
 				mod_stack_return(stack);
@@ -1429,7 +1614,7 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 		}
 
 		/* Miss */
-		if(!stack->downup_read_request && !stack->downup_writeback_request && !stack->evict_trans)
+		if(!stack->downup_read_request && !stack->downup_writeback_request && (!stack->evict_trans || stack->victim_fill))
 		{
 			if (!stack->hit)
 			{
@@ -1451,7 +1636,9 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 		/* Entry is locked. Record the transient tag so that a subsequent lookup
 		 * detects that the block is being brought.
 		 * Also, update LRU counters here. */
-		if(stack->hit || (!stack->downup_read_request && !stack->evict_trans && !stack->downup_writeback_request))
+		// A miss bypassing an exclusive cache only locks the victim, which stays in the cache untouched.
+		if(stack->hit || (!stack->downup_read_request && (!stack->evict_trans || stack->victim_fill) && !stack->downup_writeback_request
+			&& !stack->bypass))
 		{
 			cache_set_transient_tag(mod->cache, stack->set, stack->way, stack->tag);
 			cache_access_block(mod->cache, stack->set, stack->way);
@@ -1480,16 +1667,16 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 		ret->port_locked = 0;
 
 		/* On miss, evict if victim is a valid block. */
-		if(!stack->downup_read_request && !stack->downup_writeback_request && !stack->evict_trans)
+		if(!stack->downup_read_request && !stack->downup_writeback_request && (!stack->evict_trans || stack->victim_fill))
 		{
-			if (!stack->hit && stack->state)
+			if (!stack->hit && stack->state && !stack->bypass)
 			{
 				stack->eviction = 1;
 				
 				if(stack->read)
-					mod->eviction_due_to_load++;
+					MOD_STAT_INC(mod, eviction_due_to_load);
 				else
-					mod->eviction_due_to_store++;
+					MOD_STAT_INC(mod, eviction_due_to_store);
 
 				new_stack = mod_stack_create(stack->id, mod, 0,
 					EV_MOD_NMOESI_FIND_AND_LOCK_FINISH, stack);
@@ -1523,7 +1710,7 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 			assert(stack->eviction);
 			ret->err = 1;
 			// This is done so as to avoid any unlocking of entry that was never locked.
-			if(stack->hit || (!stack->downup_read_request && !stack->evict_trans && !stack->downup_writeback_request))
+			if(stack->hit || (!stack->downup_read_request && (!stack->evict_trans || stack->victim_fill) && !stack->downup_writeback_request))
 			{
 				cache_entry_unlock(mod->cache, stack->set, stack->way);
 			}
@@ -1534,7 +1721,7 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 		/* Eviction */
 		if (stack->eviction)
 		{
-			mod->evictions++;
+			MOD_STAT_INC(mod, evictions);
 			cache_get_block(mod->cache, stack->set, stack->way, NULL, &stack->state);
 			assert(!stack->state);
 		}
@@ -1549,6 +1736,10 @@ void mod_handler_nmoesi_find_and_lock(int event, void *data)
 				stack->tag, stack->state);
 		}
 
+		/* The locked victim of a bypassed miss is not the requested block */
+		if (stack->bypass && !stack->hit)
+			stack->state = cache_block_invalid;
+
 		/* Return */
 		ret->err = 0;
 		ret->set = stack->set;
@@ -1575,6 +1766,9 @@ void mod_handler_nmoesi_evict(int event, void *data)
 	uint32_t cache_entry_tag, z;
 
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_EVICT)
 	{
 		/* Default return value */
@@ -1600,6 +1794,14 @@ void mod_handler_nmoesi_evict(int event, void *data)
 
 		stack->access_start_cycle = esim_cycle();
 
+		/* A cache that is not inclusive leaves the copies of higher-level
+		 * modules in place. */
+		if (mod->inclusion != mod_inclusion_inclusive)
+		{
+			esim_schedule_event(EV_MOD_NMOESI_EVICT_INVALID, stack, 0);
+			return;
+		}
+
 		/* Send write request to all sharers */
 		new_stack = mod_stack_create(stack->id, mod, 0, EV_MOD_NMOESI_EVICT_INVALID, stack);
 		new_stack->orig_mod_id = mod->mod_id;
@@ -1659,16 +1861,17 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		cache_get_block(mod->cache, stack->set, stack->way, NULL, &stack->state);
 
 		stack->prev_state = stack->state;
+		stack->src_state = stack->state;
 		
 		// Check the previous state of this module, here you predict that this is the eviction request in this block that is going to happen, the data transfers may happen lesser than this, but must be an approximate to the value of modified/owned counters.
 		switch(stack->prev_state)
 		{
-			case cache_block_invalid     : { mod->eviction_request_state_invalid++;break; }
-			case cache_block_modified    : { mod->eviction_request_state_modified++;break; }
-			case cache_block_owned       : { mod->eviction_request_state_owned++;break; }
-			case cache_block_exclusive   : { mod->eviction_request_state_exclusive++;break; }
-			case cache_block_shared      : { mod->eviction_request_state_shared++;break; }
-			case cache_block_noncoherent : { mod->eviction_request_state_noncoherent++;break; }
+			case cache_block_invalid     : { MOD_STAT_INC(mod, eviction_request_state_invalid);break; }
+			case cache_block_modified    : { MOD_STAT_INC(mod, eviction_request_state_modified);break; }
+			case cache_block_owned       : { MOD_STAT_INC(mod, eviction_request_state_owned);break; }
+			case cache_block_exclusive   : { MOD_STAT_INC(mod, eviction_request_state_exclusive);break; }
+			case cache_block_shared      : { MOD_STAT_INC(mod, eviction_request_state_shared);break; }
+			case cache_block_noncoherent : { MOD_STAT_INC(mod, eviction_request_state_noncoherent);break; }
 		}
 		
 		/* State = I */
@@ -1704,7 +1907,7 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		// In case message was NULL, then updated the evcition send request retried counter	
 		if(!stack->msg)
 		{
-			mod->eviction_send_requests_retried_nw++;
+			MOD_STAT_INC(mod, eviction_send_requests_retried_nw);
 		}
 		else
 		{
@@ -1747,6 +1950,13 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		stack->nw_receive_request_latency_cycle     = stack->nw_receive_request_latency_end_cycle - stack->nw_receive_request_latency_start_cycle;
 		if(stack->nw_receive_request_latency_cycle) mod_update_nw_receive_request_delay_counters(target_mod, stack, mod_trans_eviction);
 
+		/* A cache that is not inclusive allocates a block for the victims it
+		 * keeps: all of them if exclusive, and only those carrying data if
+		 * NINE. Clean victims missing in a NINE cache are dropped. */
+		stack->victim_fill = target_mod->inclusion == mod_inclusion_exclusive ||
+			(target_mod->inclusion == mod_inclusion_nine &&
+			stack->reply == reply_ack_data);
+
 		/* Find and lock */
 		if (stack->state == cache_block_noncoherent)
 		{
@@ -1766,6 +1976,7 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		new_stack->write = 1;
 		new_stack->retry = 0;
 		new_stack->evict_trans = 1;
+		new_stack->victim_fill = stack->victim_fill;
 		new_stack->debug_flag = 1;
 		esim_schedule_event(EV_MOD_NMOESI_FIND_AND_LOCK, new_stack, 0);
 		return;
@@ -1788,6 +1999,27 @@ void mod_handler_nmoesi_evict(int event, void *data)
 			return;
 		}
 
+		/* A victim missing in a cache that is not inclusive fills the block
+		 * allocated for it with the state it had in the higher-level module.
+		 * If no block was allocated, the victim is dropped. */
+		if (stack->state == cache_block_invalid)
+		{
+			if (stack->victim_fill)
+			{
+				cache_set_block(target_mod->cache, stack->set, stack->way,
+					stack->tag, stack->src_state);
+				target_mod->stats.victim_fills++;
+				if (stack->reply == reply_ack_data)
+					MOD_STAT_INC(stack->mod, data_transfer_eviction);
+				mod_update_state_modification_counters(target_mod, stack->prev_state,
+					stack->src_state, mod_trans_store);
+				cache_entry_unlock(target_mod->cache, stack->set, stack->way);
+			}
+			esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack,
+				mod_get_access_latency(target_mod, mod));
+			return;
+		}
+
 		/* If data was received, set the block to modified */
 		if (stack->reply == reply_ack)
 		{
@@ -1821,7 +2053,7 @@ void mod_handler_nmoesi_evict(int event, void *data)
 			}
 
 			// Using stack->mod just to confirm that the higher level module was the module that performed the data transfer from its end.
-			stack->mod->data_transfer_eviction++;
+			MOD_STAT_INC(stack->mod, data_transfer_eviction);
 			// Also update the state modification change happening due to eviction at target module. This is registered as a store event.
 			mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_store);
 		}
@@ -1834,7 +2066,8 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		/* Unlock the cache entry */
 		cache_entry_unlock(target_mod->cache, stack->set, stack->way);
 
-		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack, target_mod->latency);
+		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack,
+			mod_get_access_latency(target_mod, mod));
 		return;
 	}
 
@@ -1872,6 +2105,14 @@ void mod_handler_nmoesi_evict(int event, void *data)
 				cache_set_block(target_mod->cache, stack->set, stack->way, 
 					stack->tag, cache_block_noncoherent);
 			}
+			else if (stack->state == cache_block_invalid && stack->victim_fill)
+			{
+				/* Block allocated for the victim in a cache that is not
+				 * inclusive */
+				cache_set_block(target_mod->cache, stack->set, stack->way, 
+					stack->tag, cache_block_noncoherent);
+				target_mod->stats.victim_fills++;
+			}
 			else
 			{
 				fatal("%s: Invalid cache block state: %d\n", __FUNCTION__, 
@@ -1887,7 +2128,8 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		/* Unlock the directory entry */
 		cache_entry_unlock(target_mod->cache, stack->set, stack->way);
 
-		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack, target_mod->latency);
+		esim_schedule_event(EV_MOD_NMOESI_EVICT_REPLY, stack,
+			mod_get_access_latency(target_mod, mod));
 		return;
 	}
 
@@ -1910,7 +2152,7 @@ void mod_handler_nmoesi_evict(int event, void *data)
 		// In case message was NULL, then updated the evcition send reply retried counter, else update the timings information.	
 		if(!stack->msg)
 		{
-			target_mod->eviction_send_replies_retried_nw++;
+			MOD_STAT_INC(target_mod, eviction_send_replies_retried_nw);
 		}
 		else
 		{
@@ -1994,6 +2236,9 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 
 	uint32_t cache_entry_tag, z;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_READ_REQUEST)
 	{
 		struct net_t *net;
@@ -2045,8 +2290,8 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		// In case message was NULL, then updated the read request send retried counter, else update the timings information.	
 		if(!stack->msg)
 		{
-			if(stack->downup_read_request) mod->downup_read_send_requests_retried_nw++;
-			else 													 mod->read_send_requests_retried_nw++;
+			if(stack->downup_read_request) MOD_STAT_INC(mod, downup_read_send_requests_retried_nw);
+			else 													 MOD_STAT_INC(mod, read_send_requests_retried_nw);
 		}
 		else
 		{
@@ -2107,6 +2352,9 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 
 			target_mod->num_load_requests++;
 			mod_update_request_counters(target_mod, mod_trans_load);
+
+			/* Account for late prefetches */
+			prefetcher_access_start(stack, target_mod);
 		}
 		else
 		{
@@ -2144,7 +2392,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 					stack->id, older_stack->id);
 				
 				// Update the waiting counter where a downup request waits for evict request.	
-				mod->downup_req_waiting_to_be_sent_for_evict_req++;
+				mod->stats.downup_req_waiting_to_be_sent_for_evict_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_READ_REQUEST_RECEIVE);
 				return;
@@ -2168,7 +2416,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 					stack->id, older_stack->id);
 				
 			 	// Update the waiting counter where a downup request waits for read write request.	
-			 	mod->downup_req_waiting_to_be_sent_for_read_write_req++;
+			 	mod->stats.downup_req_waiting_to_be_sent_for_read_write_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_READ_REQUEST_RECEIVE);
 				return;
@@ -2193,7 +2441,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 					stack->id, older_stack->id);
 				
 				// Update the waiting counter where a downup request waits for a previous downup request.	
-				target_mod->downup_req_waiting_to_be_processed_for_downup_req++;
+				target_mod->stats.downup_req_waiting_to_be_processed_for_downup_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_READ_REQUEST_RECEIVE);
 				return;
@@ -2230,7 +2478,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 					stack->id, older_stack->id);
 				
 				// Update the waiting counter where a read write request waits for a read write request.	
-				target_mod->read_write_req_waiting_for_read_write_req++;
+				target_mod->stats.read_write_req_waiting_for_read_write_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_READ_REQUEST_RECEIVE);
 				return;
@@ -2254,7 +2502,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 					stack->id, older_stack->id);
 				
 				// Update the waiting counter where a read write request waits for a evict request.	
-				target_mod->read_write_req_waiting_for_evict_req++;
+				target_mod->stats.read_write_req_waiting_for_evict_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_READ_REQUEST_RECEIVE);
 				return;
@@ -2286,6 +2534,10 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		new_stack->retry = 0;
 		if(stack->downup_read_request)
 			new_stack->downup_read_request = 1;
+		// An exclusive cache does not allocate the blocks read by higher-level modules.
+		stack->bypass = stack->request_dir == mod_request_up_down &&
+			target_mod->inclusion == mod_inclusion_exclusive;
+		new_stack->bypass = stack->bypass;
 		esim_schedule_event(EV_MOD_NMOESI_FIND_AND_LOCK, new_stack, 0);
 		return;
 	}
@@ -2341,63 +2593,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 			 *      send the data to mod instead of having target_mod do it? */
 
 			/* Send read request to owners other than mod for all sub-blocks. */
-			if(target_mod->num_nodes)
-			{
-				for(z=0; z<target_mod->num_sub_blocks; z++)
-				{
-					struct net_node_t *node;
-					struct mod_t		  *sharer;
-
-					cache_entry_tag = stack->tag + z * target_mod->sub_block_size;
-					
-					for(int i=0; i<target_mod->num_nodes; i++)
-					{
-						/* Get sharer mod */
-						node = list_get(target_mod->high_net->node_list, i);
-
-						// The request has not to be sent for the following cases.
-						// 1.) The down-up write back request needn't be sent to the issuing module (Module that started the transaction) itself.
-						// 2.) Node should be an end node.
-						// 3.) Node shouldn't be the target or issuing request module itself.
-						if(node->kind != net_node_end)
-							continue;
-
-						sharer = node->user_data;
-						assert(sharer);
-
-						if(sharer->mod_id == target_mod->mod_id)
-							continue;
-
-						if(sharer->mod_id == stack->orig_mod_id)
-							continue;
-
-						// if(sharer->mod_id == stack->issue_mod_id)
-						// 	continue;
-
-						/* Not the first sub-block */
-						if (cache_entry_tag % sharer->block_size)
-							continue;
-
-						/* Send read request */
-						stack->pending++;
-						new_stack = mod_stack_create(stack->id, target_mod, cache_entry_tag,
-							EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack);
-//----	-------------------------------------------
-						/* Only set peer if its a subblock that was requested */
-						// if (cache_entry_tag >= stack->addr && 
-						// 	  cache_entry_tag < stack->addr + mod->block_size)
-						// {
-						// 	new_stack->peer = mod_stack_set_peer(mod, stack->state);
-						// }
-//----	-------------------------------------------
-						new_stack->orig_mod_id = target_mod->mod_id;
-						new_stack->target_mod = sharer;
-						new_stack->request_dir = mod_request_down_up;
-						new_stack->downup_read_request = 1;
-						esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST, new_stack, 0);
-					}
-				}
-			}
+			mod_nmoesi_snoop_higher_mods(stack, mem_c2c_transfers ? mod : NULL);
 			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack, 0);
 
 			/* The prefetcher may have prefetched this earlier and hence
@@ -2409,7 +2605,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		else
 		{
 			// Update counter for generation of a Up-down read request
-			target_mod->updown_read_requests_generated++;
+			MOD_STAT_INC(target_mod, updown_read_requests_generated);
 
 			/* State = I */
 			new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
@@ -2423,6 +2619,13 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 
 			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST, new_stack, 0);
 
+			/* Without inclusion, higher-level modules may hold the block even
+			 * if this cache does not. Snoop them while the lower level is
+			 * read. Their data goes through this cache, which replies once
+			 * the lower level and all of them replied. */
+			if (target_mod->inclusion != mod_inclusion_inclusive)
+				mod_nmoesi_snoop_higher_mods(stack, NULL);
+
 			/* The prefetcher may be interested in this miss */
 			prefetcher_access_miss(stack, target_mod);
 
@@ -2439,13 +2642,19 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:read_request_updown_miss\"\n",
 			stack->id, target_mod->name);
 
-		/* Check error */
+		/* Check error. If higher-level modules are still being snooped,
+		 * reply once they are done. */
 		if (stack->err)
 		{
-			cache_entry_unlock(target_mod->cache, stack->set, stack->way);
 			ret->err = 1;
 			mod_stack_set_reply(ret, reply_ack_error);
 			stack->reply_size = 8;
+			if (stack->pending > 1)
+			{
+				esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack, 0);
+				return;
+			}
+			cache_entry_unlock(target_mod->cache, stack->set, stack->way);
 			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_REPLY, stack, 0);
 			return;
 		}
@@ -2454,12 +2663,17 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		 * that comes from a read request into the next cache level.
 		 * Also set the tag of the block. */
 		// MOESI Protocol
+		// The 'shared' flag set by a snoop of higher-level modules may have been overwritten by the reply of the next cache level.
+		// An exclusive cache does not keep the block, which goes up to the requester.
 
-		next_state = cache_block_next_state(stack->shared, stack->dirty);
+		next_state = cache_block_next_state(stack->shared || stack->snoop_hit, stack->dirty);
 
-		cache_set_block(target_mod->cache, stack->set, stack->way, stack->tag, next_state);
+		if (!stack->bypass)
+		{
+			cache_set_block(target_mod->cache, stack->set, stack->way, stack->tag, next_state);
 
-		mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_load);
+			mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_load);
+		}
 
 		esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_UPDOWN_FINISH, stack, 0);
 		return;
@@ -2484,9 +2698,27 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 			stack->tag, target_mod->name);
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:read_request_updown_finish\"\n",
 			stack->id, target_mod->name);
+
+		/* Error in the read request to the next cache level, received while
+		 * higher-level modules were being snooped */
+		if (stack->err)
+		{
+			cache_entry_unlock(target_mod->cache, stack->set, stack->way);
+			esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_REPLY, stack, 0);
+			return;
+		}
 		
-		// For a snoop based protocol we assume no peer to peer transfer and hence we always send data for an updown request.
-		if(stack->reply_size >= 8)
+		/* If the owner of the block sent it to mod directly, only an ack is sent.
+		 * Otherwise, data is always sent for an updown request. */
+		if (stack->reply == reply_ack_data_sent_to_peer)
+		{
+			mod_stack_set_reply(ret, reply_ack);
+			stack->reply_size = 8;
+
+			target_mod->stats.c2c_transfers++;
+			target_mod->stats.c2c_latency_saved += target_mod->latency;
+		}
+		else if(stack->reply_size >= 8)
 		{
 			mod_stack_set_reply(ret, reply_ack_data);
 // ?? mod or traget_mod
@@ -2506,7 +2738,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 			cache_entry_tag = stack->tag + z * target_mod->sub_block_size;
 			if (cache_entry_tag < stack->addr || cache_entry_tag >= stack->addr + mod->block_size)
 				continue;
-			if (stack->nc_write || stack->shared)
+			if (stack->nc_write || stack->shared || stack->snoop_hit)
 				shared = 1;
 
 			/* If the block is owned, non-coherent, or shared,  
@@ -2524,12 +2756,23 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 
 		// Fix it properly. This is a case where an DOWNUP Request set the shared flag and the next state has to be updated to shared or owned accordingly.
 		next_state = cache_block_next_state(shared, stack->dirty);
-		if(shared)
+		if (target_mod->inclusion == mod_inclusion_exclusive)
+		{
+			// An exclusive cache moves the block up to the requester, which becomes responsible for writing back a block it held dirty.
+			if (stack->state)
+			{
+				if (stack->state == cache_block_modified || stack->state == cache_block_owned)
+					ret->dirty = 1;
+				cache_set_block(target_mod->cache, stack->set, stack->way, 0, cache_block_invalid);
+			}
+		}
+		else if(shared)
 		  cache_set_block(target_mod->cache, stack->set, stack->way, stack->tag, next_state);
 		
 		cache_entry_unlock(target_mod->cache, stack->set, stack->way);
 
-		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 : target_mod->latency;
+		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 :
+			mod_get_access_latency(target_mod, mod);
 		esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_REPLY, stack, latency);
 		return;
 	}
@@ -2633,8 +2876,24 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 			stack->reply_size = 8;
 		}
 
-		
-		// For a snoop based protocol there is no peer-peer data transfer.
+
+		/* Cache-to-cache transfer. If the block is modified or owned, send it to
+		 * the peer after accessing it, and only ack the lower-level cache. */
+		if (stack->peer && (stack->state == cache_block_modified ||
+			stack->state == cache_block_owned))
+		{
+			new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
+				EV_MOD_NMOESI_READ_REQUEST_DOWNUP_FINISH, stack);
+			new_stack->peer = stack->peer;
+			new_stack->target_mod = stack->target_mod;
+			MOD_STAT_INC(stack->peer, peer_transfers);
+			MOD_STAT_INC(stack->target_mod, peer_data_transfer_downup_load_request);
+			esim_schedule_event(EV_MOD_NMOESI_PEER_SEND, new_stack,
+				target_mod->latency);
+			return;
+		}
+
+		// Without peer transfers, data is always sent to the lower-level cache.
 		esim_schedule_event(EV_MOD_NMOESI_READ_REQUEST_DOWNUP_FINISH, stack, 0);
 		return;
 	}
@@ -2650,7 +2909,16 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		
 		// For a Snoop based protocol, we adopt the following convention, in case of a valid state, data is always sent for a down-up request, no peer to peer transfer takes place and for an invalid state only ack is sent.
 		// State Modifications are M,O -> O, E,S -> S, NC -> NC, I -> I.
-		if(stack->state)
+		if (stack->peer && (stack->state == cache_block_modified ||
+			stack->state == cache_block_owned))
+		{
+			/* Data was sent to the peer, and the access latency was
+			 * already paid before sending it. */
+			mod_stack_set_reply(stack, reply_ack_data_sent_to_peer);
+			mod_stack_set_reply(ret, reply_ack_data_sent_to_peer);
+			stack->reply_size = 8;
+		}
+		else if(stack->state)
 		{
 			mod_stack_set_reply(stack, reply_ack_data);
 			stack->reply_size = target_mod->block_size + 8;
@@ -2680,6 +2948,7 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 			cache_entry_unlock(target_mod->cache, stack->set, stack->way);
 			// May be this is fix for coherency loss
 			ret->shared = 1;
+			ret->snoop_hit = 1;
 
 			if((stack->state == cache_block_modified) || (stack->state == cache_block_owned))
 				ret->dirty = 1;
@@ -2733,8 +3002,8 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		
 		if(!stack->msg)
 		{
-			if(stack->downup_read_request) target_mod->downup_read_send_replies_retried_nw++;
-			else 													 target_mod->read_send_replies_retried_nw++;
+			if(stack->downup_read_request) MOD_STAT_INC(target_mod, downup_read_send_replies_retried_nw);
+			else 													 MOD_STAT_INC(target_mod, read_send_replies_retried_nw);
 		}
 		else
 		{
@@ -2809,6 +3078,13 @@ void mod_handler_nmoesi_read_request(int event, void *data)
 		if(stack->request_dir == mod_request_down_up)
 			mod_update_latency_counters(mod, stack->access_latency, mod_trans_downup_read_request);
 
+		/* Reads to a block that was modified or owned by a peer cache */
+		if (stack->request_dir == mod_request_up_down && stack->dirty && !stack->err)
+		{
+			target_mod->stats.owner_reads++;
+			target_mod->stats.owner_read_cycles += stack->access_latency;
+		}
+
 		if(stack->request_dir == mod_request_down_up)
 		{
 			mod_downup_access_finish(target_mod, stack);
@@ -2841,6 +3117,9 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 	uint32_t cache_entry_tag, z;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_WRITE_REQUEST)
 	{
 		struct net_t *net;
@@ -2891,16 +3170,17 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 		if(!stack->nw_send_request_latency_start_cycle)
 			stack->nw_send_request_latency_start_cycle = esim_cycle();
 
-		/* Send message */
-		stack->msg = net_try_send_ev(net, src_node, dst_node, 8,
+		/* Send message. An update carries the written word. */
+		stack->msg = net_try_send_ev(net, src_node, dst_node,
+			stack->update ? 8 + MOD_UPDATE_WORD_SIZE : 8,
 			EV_MOD_NMOESI_WRITE_REQUEST_RECEIVE, stack, event, stack);
 
 		if(!stack->msg)
 		{
-			if(stack->evict_trans) mod->downup_eviction_send_requests_retried_nw++;
+			if(stack->evict_trans) MOD_STAT_INC(mod, downup_eviction_send_requests_retried_nw);
 			
-			if(stack->downup_writeback_request) mod->downup_writeback_send_requests_retried_nw++;
-			else mod->writeback_send_requests_retried_nw++;
+			if(stack->downup_writeback_request) MOD_STAT_INC(mod, downup_writeback_send_requests_retried_nw);
+			else MOD_STAT_INC(mod, writeback_send_requests_retried_nw);
 		}
 		else
 		{
@@ -2970,6 +3250,9 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 			target_mod->num_store_requests++;
 			mod_update_request_counters(target_mod, mod_trans_store);
+
+			/* Account for late prefetches */
+			prefetcher_access_start(stack, target_mod);
 		}
 		else
 		{
@@ -3027,7 +3310,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 					stack->id, older_stack->id);
 
 				// Update the waiting counter where a downup request waits for evict request.	
-				mod->downup_req_waiting_to_be_sent_for_evict_req++;
+				mod->stats.downup_req_waiting_to_be_sent_for_evict_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_WRITE_REQUEST_RECEIVE);
 				return;
@@ -3051,7 +3334,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 					stack->id, older_stack->id);
 
 				// Update the waiting counter where a downup request waits for read write request.	
-				mod->downup_req_waiting_to_be_sent_for_read_write_req++;
+				mod->stats.downup_req_waiting_to_be_sent_for_read_write_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_WRITE_REQUEST_RECEIVE);
 				return;
@@ -3074,7 +3357,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 				mem_debug("    %lld wait for downup read request %lld\n",
 					stack->id, older_stack->id);
 				// Update the waiting counter where a downup request waits for read write request.	
-				target_mod->downup_req_waiting_to_be_processed_for_downup_req++;
+				target_mod->stats.downup_req_waiting_to_be_processed_for_downup_req++;
 				
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_WRITE_REQUEST_RECEIVE);
 				return;
@@ -3090,6 +3373,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 		else
 		{
 			struct mod_stack_t *older_stack;
+			struct mod_stack_t *iter;
 
 			if(!stack->updown_access_registered)
 			{
@@ -3107,9 +3391,17 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 				mem_debug("    %lld wait for read write request %lld\n",
 					stack->id, older_stack->id);
 				
-				mod->write_req_retry++;
+				mod->stats.write_req_retry++;
 
 				ret->err = 1;
+				/* Record the older request so that the requests waiting
+				 * for this one can wait for it to finish before retrying */
+				for (iter = ret; iter; iter = iter->ret_stack)
+				{
+					iter->conflict_mod = target_mod;
+					iter->conflict_set = -1;
+					iter->conflict_id = older_stack->id;
+				}
 				stack->reply_size = 8;
 				esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST_REPLY, stack, 0);
 				return;
@@ -3127,7 +3419,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 					stack->id, older_stack->id);
 				
 				// Update the waiting counter where a read write request waits for a read write request.	
-				target_mod->read_write_req_waiting_for_read_write_req++;
+				target_mod->stats.read_write_req_waiting_for_read_write_req++;
 
 				mod_stack_wait_in_stack(stack, older_stack, EV_MOD_NMOESI_WRITE_REQUEST_RECEIVE);
 				return;
@@ -3163,6 +3455,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 			new_stack->downup_writeback_request = 1;
 		if(stack->evict_trans)
 			new_stack->evict_trans = 1;
+		// An exclusive cache does not allocate the blocks written by higher-level modules.
+		stack->bypass = stack->request_dir == mod_request_up_down &&
+			target_mod->inclusion == mod_inclusion_exclusive;
+		new_stack->bypass = stack->bypass;
 		esim_schedule_event(EV_MOD_NMOESI_FIND_AND_LOCK, new_stack, 0);
 		return;
 	}
@@ -3185,14 +3481,29 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 			return;
 		}
 
-		/* Invalidate the rest of upper level sharers */
-		new_stack = mod_stack_create(stack->id, target_mod, 0,
+		/* An update needs the block. If a cache that is not inclusive
+		 * misses on it, the other copies are invalidated instead. */
+		if (stack->request_dir == mod_request_up_down && stack->update &&
+			!stack->state)
+		{
+			stack->update = 0;
+			ret->update = 0;
+			MOD_STAT_INC(target_mod, update_fallbacks);
+		}
+
+		/* Invalidate the rest of upper level sharers, or send them the
+		 * update. If the block is missing, no entry of the cache is read,
+		 * and a cache that is not inclusive snoops its higher-level modules
+		 * for the address. */
+		new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
+			stack->request_dir == mod_request_up_down && stack->update ?
+			EV_MOD_NMOESI_WRITE_REQUEST_UPDATE :
 			EV_MOD_NMOESI_WRITE_REQUEST_EXCLUSIVE, stack);
 		new_stack->orig_mod_id = mod->mod_id;
 		new_stack->issue_mod_id = stack->issue_mod_id;
 		new_stack->except_mod = mod;
 		new_stack->set = stack->set;
-		new_stack->way = stack->way;
+		new_stack->way = stack->state ? stack->way : -1;
 		// new_stack->peer = mod_stack_set_peer(stack->peer, stack->state);
 
 		if(stack->invalidate_eviction)
@@ -3201,8 +3512,15 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 		else
 			new_stack->wb_store = 1;
 
+		if (stack->request_dir == mod_request_up_down && stack->update)
+		{
+			new_stack->update = 1;
+			MOD_STAT_INC(target_mod, sharer_req_for_update);
+		}
+		else
+			MOD_STAT_INC(target_mod, sharer_req_for_invalidation);
+
 		esim_schedule_event(EV_MOD_NMOESI_INVALIDATE, new_stack, 0);
-		target_mod->sharer_req_for_invalidation++;
 		return;
 	}
 
@@ -3238,7 +3556,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 			stack->state == cache_block_invalid || stack->state == cache_block_noncoherent)
 		{
 			// Update counter for generation of a Up-down WB request
-			target_mod->updown_writeback_requests_generated++;
+			MOD_STAT_INC(target_mod, updown_writeback_requests_generated);
 
 			new_stack = mod_stack_create(stack->id, target_mod, stack->tag,
 				EV_MOD_NMOESI_WRITE_REQUEST_UPDOWN_FINISH, stack);
@@ -3297,9 +3615,17 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 		/* Set state to exclusive */
 		// MOESI Protocol, for a store request to proceed this entry has to be set as exclusive.
+		// An exclusive cache moves the block up to the requester instead, and does not allocate it on a miss.
 		next_state = cache_block_next_state(stack->shared, stack->dirty);
 
-		cache_set_block(target_mod->cache, stack->set, stack->way, stack->tag, next_state);
+		if (target_mod->inclusion == mod_inclusion_exclusive)
+		{
+			next_state = cache_block_invalid;
+			if (stack->state)
+				cache_set_block(target_mod->cache, stack->set, stack->way, 0, next_state);
+		}
+		else
+			cache_set_block(target_mod->cache, stack->set, stack->way, stack->tag, next_state);
 
 		// No Peer-peer data transfer. Hence the data needs to be sent. However, UP-DOWN write request acts as CleanInvalid type of transaction thus we need to see when data needs to be sent and when not. Currenlty we send data for all transactions.
 		if(stack->reply_size >= 8)
@@ -3307,7 +3633,7 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 			mod_stack_set_reply(ret, reply_ack_data);
 
 			// Here the lower level module sends the data to the higher module in response to a store request form ahigher level module.
-			stack->target_mod->data_transfer_updown_store_request++;
+			MOD_STAT_INC(stack->target_mod, data_transfer_updown_store_request);
 		}
 		else
 		{
@@ -3319,11 +3645,46 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 		mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_store);
 
-		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 : target_mod->latency;
+		int latency = stack->reply == reply_ack_data_sent_to_peer ? 0 :
+			mod_get_access_latency(target_mod, mod);
 		esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST_REPLY, stack, latency);
 		return;
 	}
 
+	if (event == EV_MOD_NMOESI_WRITE_REQUEST_UPDATE)
+	{
+		int next_state;
+		int state;
+
+		mem_debug("  %lld %lld 0x%x %s write request update\n", esim_time, stack->id,
+			stack->tag, target_mod->name);
+		mem_trace("mem.access name=\"A-%lld\" state=\"%s:write_request_update\"\n",
+			stack->id, target_mod->name);
+
+		/* The other copies got the written word. The writer owns the block
+		 * if any of them kept it, and has it in M otherwise. The block is
+		 * dirty here if it was, or if an owner invalidated by competitive
+		 * update returned it. */
+		cache_get_block(target_mod->cache, stack->set, stack->way, NULL, &state);
+		next_state = cache_block_next_state(stack->shared,
+			state == cache_block_modified || state == cache_block_owned);
+		cache_set_block(target_mod->cache, stack->set, stack->way, stack->tag, next_state);
+		ret->shared = stack->shared;
+
+		/* The writer has the data, reply with an ack */
+		stack->reply_size = 8;
+		mod_stack_set_reply(ret, reply_ack);
+
+		prefetcher_access_hit(stack, target_mod);
+		cache_entry_unlock(target_mod->cache, stack->set, stack->way);
+
+		mod_update_state_modification_counters(target_mod, stack->prev_state, next_state, mod_trans_store);
+
+		esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST_REPLY, stack,
+			mod_get_access_latency(target_mod, mod));
+		return;
+	}
+
 	if (event == EV_MOD_NMOESI_WRITE_REQUEST_DOWNUP)
 	{
 		mem_debug("  %lld %lld 0x%x %s write request downup\n", esim_time, stack->id,
@@ -3331,6 +3692,26 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:write_request_downup\"\n",
 			stack->id, target_mod->name);
 
+		/* An update keeps a shared copy, unless competitive update finds
+		 * that it was not accessed during the last updates. */
+		if (stack->update && (stack->state == cache_block_shared ||
+			stack->state == cache_block_owned))
+		{
+			if (mod->coherence != mod_coherence_competitive ||
+				cache_count_update(target_mod->cache, stack->set, stack->way) <
+				mod->update_threshold)
+			{
+				stack->reply_size = 8;
+				mod_stack_set_reply(ret, reply_ack);
+				ret->shared = 1;
+				MOD_STAT_INC(target_mod, updated_copies);
+				esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST_DOWNUP_FINISH, stack, 0);
+				return;
+			}
+			MOD_STAT_INC(target_mod, update_invalidations);
+		}
+		stack->update = 0;
+
 		/* Compute reply size */	
 		if (stack->state == cache_block_exclusive || 
 			stack->state == cache_block_shared) 
@@ -3347,10 +3728,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 			// Update statistics for data transfer
 			if(stack->invalidate_eviction)
-				stack->target_mod->data_transfer_downup_eviction_request++;
+				MOD_STAT_INC(stack->target_mod, data_transfer_downup_eviction_request);
 
 			if(stack->wb_store)
-				stack->target_mod->data_transfer_downup_store_request++;
+				MOD_STAT_INC(stack->target_mod, data_transfer_downup_store_request);
 
 		}
 		else if (stack->state == cache_block_modified || 
@@ -3365,10 +3746,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 			// Update statistics for data transfer
 			if(stack->invalidate_eviction)
-				stack->target_mod->data_transfer_downup_eviction_request++;
+				MOD_STAT_INC(stack->target_mod, data_transfer_downup_eviction_request);
 
 			if(stack->wb_store)
-				stack->target_mod->data_transfer_downup_store_request++;
+				MOD_STAT_INC(stack->target_mod, data_transfer_downup_store_request);
 		}
 		else 
 		{	
@@ -3390,10 +3771,24 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:write_request_downup_finish\"\n",
 			stack->id, target_mod->name);
 
+		/* A copy kept by an update is shared, the writer becomes its owner */
+		if (stack->update)
+		{
+			cache_set_block(target_mod->cache, stack->set, stack->way, stack->tag,
+				cache_block_shared);
+			cache_entry_unlock(target_mod->cache, stack->set, stack->way);
+			mod_update_state_modification_counters(target_mod, stack->prev_state,
+				cache_block_shared, mod_trans_downup_writeback_request);
+		}
+
 		/* Set state to I, unlock*/
 		// For a snoop based protocol Invalidation has to be done for entries that are present.
-		if(stack->state)
+		else if(stack->state)
 		{
+			// Copy lost by the eviction of the lower-level module
+			if(stack->invalidate_eviction)
+				mod->stats.inclusion_victims++;
+
 			cache_set_block(target_mod->cache, stack->set, stack->way, 0, cache_block_invalid);
 			next_state = cache_block_invalid;
 			cache_entry_unlock(target_mod->cache, stack->set, stack->way);
@@ -3445,10 +3840,10 @@ void mod_handler_nmoesi_write_request(int event, void *data)
 
 		if(!stack->msg)
 		{
-			if(stack->evict_trans) target_mod->downup_eviction_send_replies_retried_nw++; 
+			if(stack->evict_trans) MOD_STAT_INC(target_mod, downup_eviction_send_replies_retried_nw); 
 			
-			if(stack->downup_writeback_request) target_mod->downup_writeback_send_replies_retried_nw++;
-			else target_mod->writeback_send_replies_retried_nw++;
+			if(stack->downup_writeback_request) MOD_STAT_INC(target_mod, downup_writeback_send_replies_retried_nw);
+			else MOD_STAT_INC(target_mod, writeback_send_replies_retried_nw);
 		}
 		else
 		{
@@ -3573,6 +3968,9 @@ void mod_handler_nmoesi_peer(int event, void *data)
 	struct mod_t *src = stack->target_mod;
 	struct mod_t *peer = stack->peer;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_PEER_SEND) 
 	{
 		mem_debug("  %lld %lld 0x%x %s %s peer send\n", esim_time, stack->id,
@@ -3592,7 +3990,7 @@ void mod_handler_nmoesi_peer(int event, void *data)
 		
 		if(!stack->msg)
 		{
-			src->peer_send_requests_retried_nw++;
+			MOD_STAT_INC(src, peer_send_requests_retried_nw);
 		}
 		else
 		{
@@ -3644,7 +4042,7 @@ void mod_handler_nmoesi_peer(int event, void *data)
 		
 		if(!stack->msg)
 		{
-			peer->peer_send_replies_retried_nw++;
+			MOD_STAT_INC(peer, peer_send_replies_retried_nw);
 		}
 		else
 		{
@@ -3697,13 +4095,20 @@ void mod_handler_nmoesi_invalidate(int event, void *data)
 	uint32_t cache_entry_tag;
 	uint32_t z;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_INVALIDATE)
 	{
 		struct mod_t *sharer;
 		int i;
 
-		/* Get block info */
-		cache_get_block(mod->cache, stack->set, stack->way, &stack->tag, &stack->state);
+		/* Get block info. A down-up write request may reach a cache that
+		 * does not hold the block, in which case there is nothing to read. */
+		if (stack->way < 0)
+			stack->state = cache_block_invalid;
+		else
+			cache_get_block(mod->cache, stack->set, stack->way, &stack->tag, &stack->state);
 		mem_debug("  %lld %lld 0x%x %s invalidate (set=%d, way=%d, state=%s)\n", esim_time, stack->id,
 			stack->tag, mod->name, stack->set, stack->way,
 			str_map_value(&cache_block_state_map, stack->state));
@@ -3718,9 +4123,15 @@ void mod_handler_nmoesi_invalidate(int event, void *data)
 
 		stack->access_start_cycle = esim_cycle();
 		
+		/* A cache that is not inclusive does not know whether higher-level
+		 * modules hold a block that it misses on, so it snoops them using
+		 * the address of the request. */
+		if (!stack->state && mod->inclusion != mod_inclusion_inclusive)
+			stack->tag = stack->addr & ~mod->cache->block_mask;
+
 		/* Send write request to all upper level sharers except 'except_mod' */
 		// dir = mod->dir;
-		if(mod->num_nodes && stack->state)
+		if(mod->num_nodes && (stack->state || mod->inclusion != mod_inclusion_inclusive))
 		{
 			for (z = 0; z < mod->num_sub_blocks; z++)
 			{
@@ -3764,6 +4175,7 @@ void mod_handler_nmoesi_invalidate(int event, void *data)
 						new_stack->wb_store = 1;
 					
 					new_stack->downup_writeback_request = 1;
+					new_stack->update = stack->update;
 					if(stack->invalidate_eviction) new_stack->evict_trans = 1;
 					esim_schedule_event(EV_MOD_NMOESI_WRITE_REQUEST, new_stack, 0);
 					stack->pending++;
@@ -3784,7 +4196,7 @@ void mod_handler_nmoesi_invalidate(int event, void *data)
 		mem_trace("mem.access name=\"A-%lld\" state=\"%s:invalidate_finish\"\n",
 			stack->id, mod->name);
 
-		if (stack->reply == reply_ack_data)
+		if (stack->reply == reply_ack_data && stack->way >= 0)
 		{
 			cache_set_block(mod->cache, stack->set, stack->way, stack->tag,
 				cache_block_modified);
@@ -3804,6 +4216,10 @@ void mod_handler_nmoesi_invalidate(int event, void *data)
 
 		mod_update_latency_counters(stack->mod, stack->access_latency, mod_trans_invalidate);
 
+		/* Tell the write request whether a copy kept the update */
+		if (stack->update)
+			stack->ret_stack->shared = stack->shared;
+
 		mod_stack_return(stack);
 		return;
 	}
@@ -3822,6 +4238,9 @@ void mod_handler_nmoesi_message(int event, void *data)
 
 	uint32_t z;
 
+	/* Debug and trace filter */
+	mem_filter_stack(stack);
+
 	if (event == EV_MOD_NMOESI_MESSAGE)
 	{
 		struct net_t *net;
@@ -72,6 +72,7 @@ extern int EV_MOD_NMOESI_WRITE_REQUEST_ACTION;
 extern int EV_MOD_NMOESI_WRITE_REQUEST_EXCLUSIVE;
 extern int EV_MOD_NMOESI_WRITE_REQUEST_UPDOWN;
 extern int EV_MOD_NMOESI_WRITE_REQUEST_UPDOWN_FINISH;
+extern int EV_MOD_NMOESI_WRITE_REQUEST_UPDATE;
 extern int EV_MOD_NMOESI_WRITE_REQUEST_DOWNUP;
 extern int EV_MOD_NMOESI_WRITE_REQUEST_DOWNUP_FINISH;
 extern int EV_MOD_NMOESI_WRITE_REQUEST_REPLY;
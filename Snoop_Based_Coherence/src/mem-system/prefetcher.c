@@ -21,6 +21,7 @@
 
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/debug.h>
+#include <lib/util/misc.h>
 #include <lib/util/string.h>
 
 #include "mem-system.h"
@@ -29,32 +30,99 @@
 #include "mod-stack.h"
 
 
+/* IP-stride engine. Number of times a stride must be repeated by an
+ * instruction before prefetching, and maximum confidence. */
+#define PREFETCHER_IP_STRIDE_CONFIDENCE  2
+#define PREFETCHER_IP_STRIDE_CONFIDENCE_MAX  3
+
+/* Stream engine. Maximum distance in blocks between consecutive misses of a
+ * stream, and number of misses in the same direction before prefetching. */
+#define PREFETCHER_STREAM_WINDOW  16
+#define PREFETCHER_STREAM_CONFIDENCE  2
+#define PREFETCHER_STREAM_CONFIDENCE_MAX  3
+
+/* Feedback-directed throttling. The degree is decreased when the accuracy in
+ * an interval is below the low threshold, and increased when it is over the
+ * high threshold, or when a significant fraction of useful prefetches was
+ * late. */
+#define PREFETCHER_ACCURACY_LOW  0.40
+#define PREFETCHER_ACCURACY_HIGH  0.75
+#define PREFETCHER_LATENESS_HIGH  0.10
+
+
 struct str_map_t prefetcher_type_map =
 {
-	2, {
+	6, {
 		{ "GHB_PC_CS", prefetcher_type_ghb_pc_cs },
 		{ "GHB_PC_DC", prefetcher_type_ghb_pc_dc },
+		{ "IP_STRIDE", prefetcher_type_ip_stride },
+		{ "STREAM", prefetcher_type_stream },
+		{ "NEXT_LINE", prefetcher_type_next_line },
+		{ "AMPM", prefetcher_type_ampm }
 	}
 };
 
-struct prefetcher_t *prefetcher_create(int prefetcher_ghb_size, int prefetcher_it_size,
-				       int prefetcher_lookup_depth, enum prefetcher_type_t type)
+struct prefetcher_t *prefetcher_create(enum prefetcher_type_t type, int block_size,
+	int ghb_size, int it_size, int lookup_depth, int num_streams,
+	int num_zones, int zone_size)
 {
 	struct prefetcher_t *pref;
 
 	/* Initialize */
 	/* The global history buffer and index table cannot be 0
 	 * if the prefetcher object is created. */
-	assert(prefetcher_ghb_size >= 1 && prefetcher_it_size >= 1);
+	assert(ghb_size >= 1 && it_size >= 1);
+	assert(num_streams >= 1 && num_zones >= 1);
 	pref = xcalloc(1, sizeof(struct prefetcher_t));
-	pref->ghb_size = prefetcher_ghb_size;
-	pref->it_size = prefetcher_it_size;
-	pref->lookup_depth = prefetcher_lookup_depth;
 	pref->type = type;
-	pref->ghb = xcalloc(prefetcher_ghb_size, sizeof(struct prefetcher_ghb_t));
-	pref->index_table = xcalloc(prefetcher_it_size, sizeof(struct prefetcher_it_t));
+	pref->ghb_size = ghb_size;
+	pref->it_size = it_size;
+	pref->lookup_depth = lookup_depth;
+	pref->num_streams = num_streams;
+	pref->num_zones = num_zones;
+	pref->zone_size = zone_size;
+	pref->block_size = block_size;
+	pref->log_block_size = log_base2(block_size);
 	pref->ghb_head = -1;
 
+	/* No throttling by default */
+	pref->degree = 1;
+	pref->max_degree = 1;
+
+	/* Tables of the engine */
+	switch (type)
+	{
+
+	case prefetcher_type_ghb_pc_cs:
+	case prefetcher_type_ghb_pc_dc:
+
+		pref->ghb = xcalloc(ghb_size, sizeof(struct prefetcher_ghb_t));
+		pref->index_table = xcalloc(it_size, sizeof(struct prefetcher_it_t));
+		break;
+
+	case prefetcher_type_ip_stride:
+
+		pref->ip_stride_table = xcalloc(it_size, sizeof(struct prefetcher_ip_stride_t));
+		break;
+
+	case prefetcher_type_stream:
+
+		pref->stream_table = xcalloc(num_streams, sizeof(struct prefetcher_stream_t));
+		break;
+
+	case prefetcher_type_ampm:
+
+		assert(!(zone_size & (zone_size - 1)));
+		assert(zone_size >= block_size * 2 &&
+			zone_size <= block_size * PREFETCHER_ZONE_BLOCKS_MAX);
+		pref->log_zone_size = log_base2(zone_size);
+		pref->zone_table = xcalloc(num_zones, sizeof(struct prefetcher_zone_t));
+		break;
+
+	default:
+		break;
+	}
+
 	/* Return */
 	return pref;
 }
@@ -63,9 +131,46 @@ void prefetcher_free(struct prefetcher_t *pref)
 {
 	free(pref->ghb);
 	free(pref->index_table);
+	free(pref->ip_stride_table);
+	free(pref->stream_table);
+	free(pref->zone_table);
 	free(pref);
 }
 
+void prefetcher_dump(struct prefetcher_t *pref, FILE *f)
+{
+	long long useful = pref->useful + pref->late;
+
+	fprintf(f, "PrefetcherType = %s\n", str_map_value(&prefetcher_type_map, pref->type));
+	fprintf(f, "PrefetcherDegree = %d\n", pref->degree);
+	fprintf(f, "PrefetcherIssued = %lld\n", pref->issued);
+	fprintf(f, "PrefetcherFills = %lld\n", pref->fills);
+	fprintf(f, "PrefetcherUseful = %lld\n", pref->useful);
+	fprintf(f, "PrefetcherLate = %lld\n", pref->late);
+	fprintf(f, "PrefetcherUnused = %lld\n", pref->unused);
+	fprintf(f, "PrefetcherAccuracy = %.4g\n", pref->fills ?
+		(double) useful / pref->fills : 0.0);
+	fprintf(f, "PrefetcherCoverage = %.4g\n", useful + pref->demand_misses ?
+		(double) useful / (useful + pref->demand_misses) : 0.0);
+	fprintf(f, "PrefetcherLateness = %.4g\n", useful ?
+		(double) pref->late / useful : 0.0);
+	fprintf(f, "PrefetcherDegreeIncreases = %lld\n", pref->degree_increases);
+	fprintf(f, "PrefetcherDegreeDecreases = %lld\n", pref->degree_decreases);
+	fprintf(f, "\n");
+}
+
+void prefetcher_reset_stats(struct prefetcher_t *pref)
+{
+	pref->demand_misses = 0;
+	pref->issued = 0;
+	pref->fills = 0;
+	pref->useful = 0;
+	pref->late = 0;
+	pref->unused = 0;
+	pref->degree_increases = 0;
+	pref->degree_decreases = 0;
+}
+
 static void get_it_index_tag(struct prefetcher_t *pref, struct mod_stack_t *stack, 
 			     int *it_index, unsigned *tag)
 {
@@ -220,9 +325,33 @@ static void prefetcher_do_prefetch(struct mod_t *mod, struct mod_stack_t *stack,
 	mem_debug("  miss_addr 0x%x, prefetch_addr 0x%x, %s : prefetcher\n", stack->addr,
 		  prefetch_addr, mod->name);
 
+	mod->cache->prefetcher->issued++;
 	mod_access(mod, mod_access_prefetch, prefetch_addr, NULL, NULL, NULL, NULL);
 }
 
+/* Prefetch the 'degree' addresses following the address accessed by 'stack'
+ * with a constant 'stride'. */
+static void prefetcher_issue(struct mod_t *mod, struct mod_stack_t *stack,
+	int stride)
+{
+	struct prefetcher_t *pref = mod->cache->prefetcher;
+	unsigned int prefetch_addr = stack->addr;
+	int i;
+
+	if (!stride)
+		return;
+
+	for (i = 0; i < pref->degree; i++)
+	{
+		/* Stop if the address wraps around */
+		prefetch_addr += stride;
+		if (!prefetch_addr || (stride > 0) != (prefetch_addr > stack->addr))
+			break;
+
+		prefetcher_do_prefetch(mod, stack, prefetch_addr);
+	}
+}
+
 /* This function implements the GHB based PC/CS prefetching as described in the
  * 2005 paper by Nesbit and Smith. The index table lookup is based on the PC
  * of the instruction causing the miss. The GHB entries are looked at for finding
@@ -279,7 +408,7 @@ static void prefetcher_ghb_pc_cs(struct mod_t *mod, struct mod_stack_t *stack, i
 	}
 
 	if (prefetch_addr > 0)
-		prefetcher_do_prefetch(mod, stack, prefetch_addr);
+		prefetcher_issue(mod, stack, stride);
 }
 
 /* This function implements the GHB based PC/DC prefetching as described in the
@@ -365,70 +494,387 @@ static void prefetcher_ghb_pc_dc(struct mod_t *mod, struct mod_stack_t *stack, i
 	}
 
 	if (prefetch_addr > 0)
-		prefetcher_do_prefetch(mod, stack, prefetch_addr);
+		prefetcher_issue(mod, stack, pref_stride);
 }
 
-void prefetcher_access_miss(struct mod_stack_t *stack, struct mod_t *target_mod)
+/* GHB based engines. The tables are updated with the access before the
+ * history is looked up. */
+static void prefetcher_ghb_access(struct mod_t *mod, struct mod_stack_t *stack)
 {
 	int it_index;
 
-	if (target_mod->kind != mod_kind_cache || !target_mod->cache->prefetcher)
-		return;
-
-	it_index = prefetcher_update_tables(stack, target_mod);
+	it_index = prefetcher_update_tables(stack, mod);
 
 	if (it_index < 0)
-		    return;
+		return;
 
-	if (target_mod->cache->prefetcher->type == prefetcher_type_ghb_pc_cs)
+	if (mod->cache->prefetcher->type == prefetcher_type_ghb_pc_cs)
 	{
 		/* Perform ghb based PC/CS prefetching
 		 * (Program Counter based index, Constant Stride) */
-		prefetcher_ghb_pc_cs(target_mod, stack, it_index);
+		prefetcher_ghb_pc_cs(mod, stack, it_index);
 	}
 	else
 	{
-		assert(target_mod->cache->prefetcher->type == prefetcher_type_ghb_pc_dc);
+		assert(mod->cache->prefetcher->type == prefetcher_type_ghb_pc_dc);
 		/* Perform ghb based PC/DC prefetching
 		 * (Program Counter based index, Delta Correlation) */
-		prefetcher_ghb_pc_dc(target_mod, stack, it_index);
+		prefetcher_ghb_pc_dc(mod, stack, it_index);
 	}
 }
 
+/* IP-stride prefetching. A table indexed by the PC of the instruction causing
+ * the miss records the last address and stride seen for that instruction.
+ * Once the same stride has been repeated, the following addresses in the
+ * stride are prefetched. */
+static void prefetcher_ip_stride(struct mod_t *mod, struct mod_stack_t *stack)
+{
+	struct prefetcher_t *pref = mod->cache->prefetcher;
+	struct prefetcher_ip_stride_t *entry;
+	unsigned int eip;
+	int stride;
+
+	/* The PC of the instruction is needed */
+	if (!stack->client_info)
+		return;
+	eip = stack->client_info->prefetcher_eip;
+	entry = &pref->ip_stride_table[eip % pref->it_size];
+
+	/* Replace entry */
+	if (entry->tag != eip)
+	{
+		entry->tag = eip;
+		entry->addr = stack->addr;
+		entry->stride = 0;
+		entry->confidence = 0;
+		return;
+	}
+
+	/* Train */
+	stride = stack->addr - entry->addr;
+	entry->addr = stack->addr;
+	if (!stride)
+		return;
+	if (stride != entry->stride)
+	{
+		if (entry->confidence)
+			entry->confidence--;
+		if (!entry->confidence)
+			entry->stride = stride;
+		return;
+	}
+	entry->confidence = MIN(entry->confidence + 1,
+		PREFETCHER_IP_STRIDE_CONFIDENCE_MAX);
+
+	/* Prefetch */
+	if (entry->confidence >= PREFETCHER_IP_STRIDE_CONFIDENCE)
+		prefetcher_issue(mod, stack, stride);
+}
+
+/* Stream prefetching. A miss close enough to the last miss of a stream is
+ * assigned to it, and sets the direction of the stream. After consecutive
+ * misses in the same direction, the blocks following the miss along the
+ * stream are prefetched. Misses not belonging to any stream allocate a new
+ * one, replacing the least recently used. */
+static void prefetcher_stream(struct mod_t *mod, struct mod_stack_t *stack)
+{
+	struct prefetcher_t *pref = mod->cache->prefetcher;
+	struct prefetcher_stream_t *stream;
+	unsigned int block;
+	int direction;
+	int distance;
+	int i;
+
+	/* Find stream */
+	block = stack->addr >> pref->log_block_size;
+	stream = NULL;
+	for (i = 0; i < pref->num_streams; i++)
+	{
+		distance = block - pref->stream_table[i].block;
+		if (pref->stream_table[i].valid && distance >= -PREFETCHER_STREAM_WINDOW
+				&& distance <= PREFETCHER_STREAM_WINDOW)
+		{
+			stream = &pref->stream_table[i];
+			break;
+		}
+	}
+
+	/* Allocate new stream. Invalid entries have the lowest LRU value. */
+	if (!stream)
+	{
+		stream = &pref->stream_table[0];
+		for (i = 1; i < pref->num_streams; i++)
+			if (pref->stream_table[i].lru < stream->lru)
+				stream = &pref->stream_table[i];
+		stream->valid = 1;
+		stream->block = block;
+		stream->direction = 0;
+		stream->confidence = 0;
+		stream->lru = ++pref->time;
+		return;
+	}
+
+	/* Train */
+	stream->lru = ++pref->time;
+	distance = block - stream->block;
+	if (!distance)
+		return;
+	direction = distance > 0 ? 1 : -1;
+	if (direction == stream->direction)
+	{
+		stream->confidence = MIN(stream->confidence + 1,
+			PREFETCHER_STREAM_CONFIDENCE_MAX);
+	}
+	else
+	{
+		stream->direction = direction;
+		stream->confidence = 1;
+	}
+	stream->block = block;
+
+	/* Prefetch */
+	if (stream->confidence >= PREFETCHER_STREAM_CONFIDENCE)
+		prefetcher_issue(mod, stack, direction * pref->block_size);
+}
+
+/* Next-N-line prefetching. The 'degree' blocks following the accessed block
+ * are prefetched. */
+static void prefetcher_next_line(struct mod_t *mod, struct mod_stack_t *stack)
+{
+	prefetcher_issue(mod, stack, mod->cache->prefetcher->block_size);
+}
+
+/* AMPM prefetching. Memory is divided in zones, and the access map of recently
+ * used zones records which of their blocks were accessed. On an access to block
+ * 'b', block 'b + k' is prefetched if blocks 'b - k' and 'b - 2k' were accessed,
+ * and likewise in the descending direction, for increasing values of 'k' until
+ * 'degree' prefetches are issued. Blocks already accessed or prefetched are
+ * skipped. */
+static void prefetcher_ampm(struct mod_t *mod, struct mod_stack_t *stack)
+{
+	struct prefetcher_t *pref = mod->cache->prefetcher;
+	struct prefetcher_zone_t *zone;
+	unsigned long long map;
+	unsigned int zone_tag;
+	unsigned int zone_addr;
+	unsigned int prefetch_addr;
+	int num_blocks;
+	int block;
+	int count;
+	int i;
+	int k;
+
+	/* Find zone */
+	zone_tag = stack->addr >> pref->log_zone_size;
+	zone = NULL;
+	for (i = 0; i < pref->num_zones; i++)
+	{
+		if (pref->zone_table[i].valid && pref->zone_table[i].tag == zone_tag)
+		{
+			zone = &pref->zone_table[i];
+			break;
+		}
+	}
+
+	/* Replace the least recently used zone. Invalid entries have the
+	 * lowest LRU value. */
+	if (!zone)
+	{
+		zone = &pref->zone_table[0];
+		for (i = 1; i < pref->num_zones; i++)
+			if (pref->zone_table[i].lru < zone->lru)
+				zone = &pref->zone_table[i];
+		zone->valid = 1;
+		zone->tag = zone_tag;
+		zone->access_map = 0;
+		zone->prefetch_map = 0;
+	}
+
+	/* Record access */
+	zone_addr = zone_tag << pref->log_zone_size;
+	num_blocks = pref->zone_size >> pref->log_block_size;
+	block = (stack->addr - zone_addr) >> pref->log_block_size;
+	zone->lru = ++pref->time;
+	zone->access_map |= 1ULL << block;
+	map = zone->access_map;
+
+	/* Look for strides */
+	count = 0;
+	for (k = 1; k <= num_blocks / 2 && count < pref->degree; k++)
+	{
+		/* Ascending */
+		i = block + k;
+		if (i < num_blocks && block - 2 * k >= 0 &&
+			(map >> (block - k) & 1) && (map >> (block - 2 * k) & 1) &&
+			!((map | zone->prefetch_map) >> i & 1))
+		{
+			zone->prefetch_map |= 1ULL << i;
+			prefetch_addr = zone_addr + (i << pref->log_block_size);
+			prefetcher_do_prefetch(mod, stack, prefetch_addr);
+			count++;
+		}
+
+		/* Descending */
+		i = block - k;
+		if (count < pref->degree && i >= 0 && block + 2 * k < num_blocks &&
+			(map >> (block + k) & 1) && (map >> (block + 2 * k) & 1) &&
+			!((map | zone->prefetch_map) >> i & 1))
+		{
+			zone->prefetch_map |= 1ULL << i;
+			prefetch_addr = zone_addr + (i << pref->log_block_size);
+			if (prefetch_addr)
+				prefetcher_do_prefetch(mod, stack, prefetch_addr);
+			count++;
+		}
+	}
+}
+
+
+/* Prefetching engines. Function 'access' is called with every demand miss of
+ * the cache, and with the first demand access to each prefetched block. */
+struct prefetcher_engine_t
+{
+	void (*access)(struct mod_t *mod, struct mod_stack_t *stack);
+};
+
+static struct prefetcher_engine_t prefetcher_engine_list[] =
+{
+	[prefetcher_type_ghb_pc_cs] = { prefetcher_ghb_access },
+	[prefetcher_type_ghb_pc_dc] = { prefetcher_ghb_access },
+	[prefetcher_type_ip_stride] = { prefetcher_ip_stride },
+	[prefetcher_type_stream] = { prefetcher_stream },
+	[prefetcher_type_next_line] = { prefetcher_next_line },
+	[prefetcher_type_ampm] = { prefetcher_ampm }
+};
+
+
+/* Feedback-directed throttling, called at the end of each interval. */
+static void prefetcher_throttle(struct prefetcher_t *pref)
+{
+	double accuracy;
+	double lateness;
+
+	accuracy = (double) pref->interval_useful / pref->interval_fills;
+	lateness = pref->interval_useful ? (double) pref->interval_late /
+		pref->interval_useful : 0.0;
+
+	if (accuracy < PREFETCHER_ACCURACY_LOW)
+	{
+		if (pref->degree > 1)
+		{
+			pref->degree--;
+			pref->degree_decreases++;
+		}
+	}
+	else if (accuracy >= PREFETCHER_ACCURACY_HIGH ||
+		lateness >= PREFETCHER_LATENESS_HIGH)
+	{
+		if (pref->degree < pref->max_degree)
+		{
+			pref->degree++;
+			pref->degree_increases++;
+		}
+	}
+
+	/* New interval */
+	pref->interval_fills = 0;
+	pref->interval_useful = 0;
+	pref->interval_late = 0;
+}
+
+
+/* Called when a demand access reaches the cache. If the block is still being
+ * prefetched, the prefetch is late. */
+void prefetcher_access_start(struct mod_stack_t *stack, struct mod_t *target_mod)
+{
+	struct prefetcher_t *pref;
+	struct mshr_entry_t *mshr_entry;
+	struct mod_stack_t *prefetch_stack;
+
+	if (target_mod->kind != mod_kind_cache || !target_mod->cache->prefetcher)
+		return;
+
+	/* Requests caused by prefetches in upper levels are not demand accesses */
+	if (stack->prefetch)
+		return;
+
+	/* Look for a prefetch in flight */
+	mshr_entry = mod_mshr_find(target_mod, stack->addr);
+	if (!mshr_entry)
+		return;
+	prefetch_stack = mshr_entry->stack;
+	if (prefetch_stack->access_kind != mod_access_prefetch || prefetch_stack->prefetch_late)
+		return;
+
+	/* Late prefetch */
+	mem_debug("  addr 0x%x %s : late prefetch %lld\n", stack->addr,
+		target_mod->name, prefetch_stack->id);
+	pref = target_mod->cache->prefetcher;
+	prefetch_stack->prefetch_late = 1;
+	pref->late++;
+	pref->interval_late++;
+	pref->interval_useful++;
+}
+
+void prefetcher_access_miss(struct mod_stack_t *stack, struct mod_t *target_mod)
+{
+	struct prefetcher_t *pref;
+
+	if (target_mod->kind != mod_kind_cache || !target_mod->cache->prefetcher)
+		return;
+
+	pref = target_mod->cache->prefetcher;
+	if (!stack->prefetch)
+		pref->demand_misses++;
+
+	prefetcher_engine_list[pref->type].access(target_mod, stack);
+}
+
 void prefetcher_access_hit(struct mod_stack_t *stack, struct mod_t *target_mod)
 {
-	int it_index;
+	struct prefetcher_t *pref;
+	int prefetched;
 
 	if (target_mod->kind != mod_kind_cache || !target_mod->cache->prefetcher)
 		return;
 
-	if (mod_block_get_prefetched(target_mod, stack->addr))
+	pref = target_mod->cache->prefetcher;
+	prefetched = mod_block_get_prefetched(target_mod, stack->addr);
+	if (prefetched)
 	{
-		/* This block was prefetched. Now it has a real access. For the purposes
-		 * of the prefetcher heuristic, this is still a miss. Hence, update
-		 * the prefetcher tables. */
-		it_index = prefetcher_update_tables(stack, target_mod);
+		/* Useful prefetch, unless it was already accounted for as late */
+		if (prefetched == PREFETCHER_BLOCK_PREFETCHED)
+		{
+			pref->useful++;
+			pref->interval_useful++;
+		}
 
 		/* Clear the prefetched flag since we have a real access now */
 		mem_debug ("  addr 0x%x %s : clearing \"prefetched\" flag\n", 
 			   stack->addr, target_mod->name);
 		mod_block_set_prefetched(target_mod, stack->addr, 0);
 
-		if (it_index < 0)
-			return;
-
-		if (target_mod->cache->prefetcher->type == prefetcher_type_ghb_pc_cs)
-		{
-			/* Perform ghb based PC/CS prefetching
-			 * (Program Counter based index, Constant Stride) */
-			prefetcher_ghb_pc_cs(target_mod, stack, it_index);
-		}
-		else
-		{
-			assert(target_mod->cache->prefetcher->type == prefetcher_type_ghb_pc_dc);
-			/* Perform ghb based PC/DC prefetching
-			 * (Program Counter based index, Delta Correlation) */
-			prefetcher_ghb_pc_dc(target_mod, stack, it_index);
-		}
+		/* This block was prefetched. Now it has a real access. For the purposes
+		 * of the prefetcher heuristic, this is still a miss. */
+		prefetcher_engine_list[pref->type].access(target_mod, stack);
 	}
 }
+
+/* Called when a prefetch brings a block into the cache. The block is marked as
+ * prefetched, so that the first demand access to it can be identified. */
+void prefetcher_access_fill(struct mod_stack_t *stack, struct mod_t *target_mod)
+{
+	struct prefetcher_t *pref;
+
+	mod_block_set_prefetched(target_mod, stack->addr, stack->prefetch_late ?
+		PREFETCHER_BLOCK_LATE : PREFETCHER_BLOCK_PREFETCHED);
+
+	pref = target_mod->cache->prefetcher;
+	if (!pref)
+		return;
+
+	/* Throttling */
+	pref->fills++;
+	if (pref->throttle_interval && ++pref->interval_fills == pref->throttle_interval)
+		prefetcher_throttle(pref);
+}
@@ -0,0 +1,122 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEM_SYSTEM_TLB_H
+#define MEM_SYSTEM_TLB_H
+
+#include "module.h"
+
+
+/* Number of levels of the page table walked on a miss in the last-level TLB.
+ * The layout follows a 32-bit two-level page table, with one page directory
+ * and one page table per address space. */
+#define TLB_WALK_LEVELS  2
+
+/* Maximum walk latency tracked individually in the walk latency histogram.
+ * Longer walks are accounted for in the last entry. */
+#define TLB_WALK_LATENCY_HISTOGRAM_SIZE  1024
+
+
+/* TLB event-driven simulation */
+
+extern int EV_TLB_ACCESS;
+extern int EV_TLB_LOOKUP;
+extern int EV_TLB_MISS;
+extern int EV_TLB_WALK;
+extern int EV_TLB_WALK_REPLY;
+extern int EV_TLB_FILL;
+extern int EV_TLB_FINISH;
+
+
+/* Translation lookaside buffer. A TLB is a timing-only structure placed in
+ * front of a memory module. Translation itself is still performed
+ * functionally by the MMU; the TLB only delays the access to the module
+ * by the lookup latency and, on a miss, by the time it takes to look up the
+ * next TLB level or to walk the page table through the cache hierarchy. */
+struct tlb_t
+{
+	char *name;
+
+	/* Parameters */
+	int num_sets;
+	int assoc;
+	int latency;
+	int mshr_size;
+
+	/* Next TLB level, or NULL if misses walk the page table */
+	struct tlb_t *low_tlb;
+
+	/* Tag array. Entries have page granularity and are tagged with the
+	 * physical page, which is unique per address space and virtual page
+	 * since the MMU maps pages one-to-one. */
+	struct cache_t *cache;
+
+	/* Accesses in flight, using fields 'access_list_prev' and
+	 * 'access_list_next' of the stack. A stack used for a TLB access is
+	 * never enqueued in a module access list, so there is no conflict. */
+	struct mod_stack_t *access_list_head;
+	struct mod_stack_t *access_list_tail;
+	int access_list_count;
+	int access_list_max;
+
+	/* Number of misses being resolved */
+	int mshr_count;
+
+	/* Translated accesses forwarded to the module, using fields
+	 * 'forward_list_prev' and 'forward_list_next' of the stack. They are
+	 * issued to the module with a new access ID, stored in field
+	 * 'tlb_forward_id', so that IDs keep increasing in the order accesses
+	 * reach the module. A stack is released once its module access is
+	 * found to be complete. */
+	struct mod_stack_t *forward_list_head;
+	struct mod_stack_t *forward_list_tail;
+	int forward_list_count;
+	int forward_list_max;
+
+	/* Statistics */
+	long long accesses;
+	long long hits;
+	long long misses;
+	long long mshr_merges;
+	long long mshr_stall_cycles;
+	long long walks;
+	long long walk_accesses;
+	long long walk_cycles;
+	long long walk_max_cycles;
+	long long walk_latency_histogram[TLB_WALK_LATENCY_HISTOGRAM_SIZE];
+};
+
+
+struct tlb_t *tlb_create(char *name, int num_sets, int assoc,
+	int latency, int mshr_size);
+void tlb_free(struct tlb_t *tlb);
+void tlb_dump(struct tlb_t *tlb, FILE *f);
+void tlb_reset_stats(struct tlb_t *tlb);
+
+long long tlb_access(struct tlb_t *tlb, struct mod_t *mod,
+	enum mod_access_kind_t access_kind, int address_space_index,
+	unsigned int vtl_addr, unsigned int phy_addr, int *witness_ptr,
+	struct linked_list_t *event_queue, void *event_queue_item,
+	struct mod_client_info_t *client_info);
+int tlb_in_flight_access(struct tlb_t *tlb, long long id);
+
+void tlb_handler(int event, void *data);
+
+
+#endif
@@ -89,8 +89,8 @@ void net_buffer_dump_report(struct net_buffer_t *buffer, FILE *f)
 {
 	long long cycle;
 
-	/* Get current cycle */
-	cycle = esim_domain_cycle(net_domain_index);
+	/* Get cycles since stats were reset */
+	cycle = esim_domain_cycle(net_domain_index) - buffer->net->reset_cycle;
 
 	/* Update stats */
 	net_buffer_update_occupancy(buffer);
@@ -107,6 +107,15 @@ void net_buffer_dump_report(struct net_buffer_t *buffer, FILE *f)
 }
 
 
+void net_buffer_reset_stats(struct net_buffer_t *buffer)
+{
+	/* Start a new occupancy sample */
+	net_buffer_update_occupancy(buffer);
+	buffer->occupancy_bytes_acc = 0;
+	buffer->occupancy_msgs_acc = 0;
+}
+
+
 void net_buffer_insert(struct net_buffer_t *buffer, struct net_msg_t *msg)
 {
 	struct net_t *net = buffer->net;
@@ -88,6 +88,7 @@ void net_buffer_free(struct net_buffer_t *buffer);
 
 void net_buffer_dump(struct net_buffer_t *buffer, FILE *f);
 void net_buffer_dump_report(struct net_buffer_t *buffer, FILE *f);
+void net_buffer_reset_stats(struct net_buffer_t *buffer);
 
 void net_buffer_insert(struct net_buffer_t *buffer, struct net_msg_t *msg);
 void net_buffer_extract(struct net_buffer_t *buffer, struct net_msg_t *msg);
@@ -27,6 +27,7 @@
 #include "buffer.h"
 #include "bus.h"
 #include "net-system.h"
+#include "network.h"
 #include "node.h"
 
 
@@ -149,8 +150,8 @@ void net_bus_dump_report(struct net_bus_t *bus, FILE *f)
 {
 	long long cycle;
 
-	/* Get current cycle */
-	cycle = esim_domain_cycle(net_domain_index);
+	/* Get cycles since stats were reset */
+	cycle = esim_domain_cycle(net_domain_index) - bus->net->reset_cycle;
 
 	fprintf(f, "%s.Bandwidth = %d\n", bus->name, bus->bandwidth);
 	fprintf(f, "%s.TransferredMessages = %lld\n", bus->name,
@@ -165,3 +166,10 @@ void net_bus_dump_report(struct net_bus_t *bus, FILE *f)
 			bus->bandwidth) : 0.0);
 	fprintf(f, "\n");
 }
+
+void net_bus_reset_stats(struct net_bus_t *bus)
+{
+	bus->busy_cycles = 0;
+	bus->transferred_bytes = 0;
+	bus->transferred_msgs = 0;
+}
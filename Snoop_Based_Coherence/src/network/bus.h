@@ -49,4 +49,5 @@ void net_bus_free(struct net_bus_t *bus);
 struct net_bus_t *net_bus_arbitration(struct net_node_t *bus_node,
 	struct net_buffer_t *buffer);
 void net_bus_dump_report(struct net_bus_t *bus, FILE *f);
+void net_bus_reset_stats(struct net_bus_t *bus);
 #endif
@@ -97,8 +97,8 @@ void net_link_dump_report(struct net_link_t *link, FILE *f)
 	struct net_t *net = link->net;
 	long long cycle;
 
-	/* Get current cycle */
-	cycle = esim_domain_cycle(net_domain_index);
+	/* Get cycles since stats were reset */
+	cycle = esim_domain_cycle(net_domain_index) - net->reset_cycle;
 
 	fprintf(f, "[ Network.%s.Link.%s ]\n", net->name, link->name);
 	fprintf(f, "Config.Bandwidth = %d\n", link->bandwidth);
@@ -114,6 +114,14 @@ void net_link_dump_report(struct net_link_t *link, FILE *f)
 }
 
 
+void net_link_reset_stats(struct net_link_t *link)
+{
+	link->busy_cycles = 0;
+	link->transferred_bytes = 0;
+	link->transferred_msgs = 0;
+}
+
+
 struct net_buffer_t *net_link_arbitrator_vc(struct net_link_t *link,
 	struct net_node_t *node)
 {
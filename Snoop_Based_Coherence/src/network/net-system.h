@@ -34,8 +34,12 @@ extern char *net_err_cycle;
 extern char *net_err_route_step;
 
 
-/* Debug */
+/* Debug, compiled out when NTRACE is defined at build time */
+#ifdef NTRACE
+#define net_debug(...) (0 ? debug(net_debug_category, __VA_ARGS__) : (void) 0)
+#else
 #define net_debug(...) debug(net_debug_category, __VA_ARGS__)
+#endif
 extern int net_debug_category;
 
 /* Configuration parameters */
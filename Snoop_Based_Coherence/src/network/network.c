@@ -663,6 +663,23 @@ void net_dump_report(struct net_t *net, FILE *f)
 	}
 }
 
+/* Reset statistics of the network and its links and nodes. Rates in the
+ * report are computed over the cycles elapsed since. */
+void net_reset_stats(struct net_t *net)
+{
+	int i;
+
+	net->transfers = 0;
+	net->lat_acc = 0;
+	net->msg_size_acc = 0;
+	net->reset_cycle = esim_domain_cycle(net_domain_index);
+
+	for (i = 0; i < list_count(net->link_list); i++)
+		net_link_reset_stats(list_get(net->link_list, i));
+	for (i = 0; i < list_count(net->node_list); i++)
+		net_node_reset_stats(list_get(net->node_list, i));
+}
+
 void net_dump_visual(struct net_graph_t *graph, FILE *f)
 {
 	int i;
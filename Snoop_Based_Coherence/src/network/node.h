@@ -76,6 +76,7 @@ void net_node_free(struct net_node_t *node);
 void net_node_dump(struct net_node_t *node, FILE *f);
 
 void net_node_dump_report(struct net_node_t *node, FILE *f);
+void net_node_reset_stats(struct net_node_t *node);
 
 /* Adding buffers to nodes. It supports asymmetric switches */
 struct net_buffer_t *net_node_add_output_buffer(struct net_node_t *node,
@@ -21,6 +21,7 @@
 #include <gtk/gtk.h>
 #include <zlib.h>
 
+#include <lib/esim/trace-binary.h>
 #include <lib/mhandle/mhandle.h>
 #include <lib/util/debug.h>
 #include <lib/util/hash-table.h>
@@ -229,6 +230,34 @@ struct vi_trace_line_t *vi_trace_line_create_from_trace(struct vi_trace_t *trace
 }
 
 
+/* Create a trace line from a record of a binary trace, located at position
+ * 'offset' as returned by 'trace_reader_tell'. */
+struct vi_trace_line_t *vi_trace_line_create_from_record(struct trace_record_t *record,
+	long int offset)
+{
+	struct vi_trace_line_t *line;
+	int i;
+
+	/* Lines not following the trace syntax */
+	if (!record->command)
+		fatal("%s: invalid format", record->text);
+
+	/* Initialize */
+	line = xcalloc(1, sizeof(struct vi_trace_line_t));
+	line->offset = offset;
+	line->command = xstrdup(record->command);
+	line->symbol_table = hash_table_create(13, FALSE);
+
+	/* Symbols */
+	for (i = 0; i < record->num_symbols; i++)
+		hash_table_insert(line->symbol_table, record->symbol_name[i],
+			xstrdup(record->symbol_value[i]));
+
+	/* Return */
+	return line;
+}
+
+
 void vi_trace_line_free(struct vi_trace_line_t *line)
 {
 	char *symbol_name;
@@ -33,6 +33,9 @@ struct vi_trace_line_t;
 
 struct vi_trace_line_t *vi_trace_line_create_from_file(FILE *f);
 struct vi_trace_line_t *vi_trace_line_create_from_trace(struct vi_trace_t *trace);
+struct trace_record_t;
+struct vi_trace_line_t *vi_trace_line_create_from_record(struct trace_record_t *record,
+	long int offset);
 void vi_trace_line_free(struct vi_trace_line_t *line);
 
 void vi_trace_line_dump(struct vi_trace_line_t *line, FILE *f);